@@ -97,6 +97,7 @@ char usage[] = "\n"
   "      -b bits  : bits/color component\n"
   "      -t       : output statistics\n"
   "      -e       : show input cloud during encoding\n"
+  "      -rans    : entropy code with the interleaved rANS coder\n"
   "\n"
   "      -minmax min-max  :: set the PassThrough min-max cutting values (default: 0-3.0)\n"
   "      -field  X        :: set the PassThrough field/dimension 'X' to filter data on (default: 'z')\n"
@@ -385,6 +386,9 @@ main (int argc, char **argv)
                                                                octreeResolution, doVoxelGridDownDownSampling, iFrameRate,
                                                                doColorEncoding, static_cast<unsigned char> (colorBitResolution));
 
+  if (pcl::console::find_argument (argc, argv, "-rans")>0)
+    octreeCoder->setEntropyCoder (pcl::io::RANS_CODER);
+
 
   if (!bServerFileMode) 
   {
@@ -46,6 +46,7 @@
 #include <pcl/compression/organized_pointcloud_compression.h>
 
 #include <iostream>
+#include <algorithm>
 #include <vector>
 #include <cstdio>
 #include <sstream>
@@ -85,6 +86,9 @@ char usage[] = "\n"
   "      -e       : show input cloud during encoding\n"
   "      -r       : raw encoding of disparity maps\n"
   "      -g       : gray scale conversion\n"
+  "      -p error : predictive coding of disparity maps with the given maximum error (0: lossless)\n"
+  "      -k frames: delta coding against the previous frame with a keyframe every given number of frames\n"
+  "      -n change: largest disparity change delta frames ignore (default: 0)\n"
 
   "\n"
   "  example:\n"
@@ -313,6 +317,9 @@ main (int argc, char **argv)
   bool bShowInputCloud;
   bool bRawImageEncoding;
   bool bGrayScaleConversion;
+  int predictiveMaxError;
+  int keyframeInterval;
+  int depthChangeThreshold;
 
   std::string fileName = "pc_compressed.pcc";
   std::string hostName = "localhost";
@@ -330,6 +337,9 @@ main (int argc, char **argv)
   bShowInputCloud = false;
   bRawImageEncoding = false;
   bGrayScaleConversion = false;
+  predictiveMaxError = -1;
+  keyframeInterval = 1;
+  depthChangeThreshold = 0;
 
   if (pcl::console::find_argument (argc, argv, "-e")>0) 
     bShowInputCloud = true;
@@ -340,6 +350,10 @@ main (int argc, char **argv)
   if (pcl::console::find_argument (argc, argv, "-g")>0)
     bGrayScaleConversion = true;
 
+  pcl::console::parse_argument (argc, argv, "-p", predictiveMaxError);
+  pcl::console::parse_argument (argc, argv, "-k", keyframeInterval);
+  pcl::console::parse_argument (argc, argv, "-n", depthChangeThreshold);
+
   if (pcl::console::find_argument (argc, argv, "-s")>0) 
   {
     bEnDecode = true;
@@ -392,6 +406,14 @@ main (int argc, char **argv)
   }
 
   organizedCoder = new OrganizedPointCloudCompression<PointXYZRGBA> ();
+  if (predictiveMaxError >= 0)
+  {
+    organizedCoder->setPredictiveDepthCoding (true);
+    organizedCoder->getDepthImageCoder ().setMaxError (predictiveMaxError);
+    organizedCoder->getDepthImageCoder ().setNumberOfThreads ();
+  }
+  organizedCoder->setKeyframeInterval (std::max (keyframeInterval, 1));
+  organizedCoder->setDepthChangeThreshold (std::max (depthChangeThreshold, 0));
 
 
   if (!bServerFileMode) 
@@ -53,6 +53,7 @@
 #endif
 
 #include <cmath>
+#include <pcl/pcl_macros.h>
 #include <pcl/ModelCoefficients.h>
 
 #include <Eigen/StdVector>
@@ -135,6 +136,29 @@ namespace pcl
   template <typename Matrix, typename Vector> void
   eigen33 (const Matrix &mat, Matrix &evecs, Vector &evals);
 
+  /** \brief determines the smallest eigenvalue and its eigenvector for a batch of symmetric positive semi definite
+    * 3x3 matrices, given as separate arrays of their upper triangle entries.
+    * Each matrix is solved exactly like eigen33 (mat, eigenvalue, eigenvector), but 4 (SSE) or 8 (AVX) matrices
+    * are processed at once; results may differ from the scalar version in the last bits.
+    * \param[in] nr_matrices number of matrices in the batch
+    * \param[in] c00 array of the (0,0) entries
+    * \param[in] c01 array of the (0,1) entries
+    * \param[in] c02 array of the (0,2) entries
+    * \param[in] c11 array of the (1,1) entries
+    * \param[in] c12 array of the (1,2) entries
+    * \param[in] c22 array of the (2,2) entries
+    * \param[out] eigenvalues the smallest eigenvalue of each matrix
+    * \param[out] eigenvector_x x component of the eigenvector corresponding to the smallest eigenvalue
+    * \param[out] eigenvector_y y component of the eigenvector corresponding to the smallest eigenvalue
+    * \param[out] eigenvector_z z component of the eigenvector corresponding to the smallest eigenvalue
+    * \ingroup common
+    */
+  PCL_EXPORTS void
+  eigen33Batch (std::size_t nr_matrices,
+                const float *c00, const float *c01, const float *c02,
+                const float *c11, const float *c12, const float *c22,
+                float *eigenvalues, float *eigenvector_x, float *eigenvector_y, float *eigenvector_z);
+
   /** \brief Calculate the inverse of a 2x2 matrix
     * \param[in] matrix matrix to be inverted
     * \param[out] inverse the resultant inverted matrix
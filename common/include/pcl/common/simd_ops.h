@@ -0,0 +1,160 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2019-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <pcl/pcl_macros.h>
+
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+
+#if defined (__SSE2__)
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#endif
+
+#if defined (__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace pcl
+{
+  namespace detail
+  {
+    /* Thin wrappers over SSE and AVX float vectors, so that a kernel written once as a template
+     * on Ops can be instantiated for either register width. Only meant for use inside
+     * translation units compiled with the corresponding instruction set enabled.
+     */
+#if defined (__SSE2__)
+    /** \brief 4-wide float operations. */
+    struct SSEOps
+    {
+      using Vec = __m128;
+      static const std::size_t width = 4;
+
+      static inline Vec load (const float *p) { return (_mm_loadu_ps (p)); }
+      static inline void store (float *p, Vec a) { _mm_storeu_ps (p, a); }
+      /** \brief store a, truncated to integers */
+      static inline void storeInt (int *p, Vec a) { _mm_storeu_si128 (reinterpret_cast<__m128i*> (p), _mm_cvttps_epi32 (a)); }
+      static inline Vec set1 (float a) { return (_mm_set1_ps (a)); }
+      static inline Vec add (Vec a, Vec b) { return (_mm_add_ps (a, b)); }
+      static inline Vec sub (Vec a, Vec b) { return (_mm_sub_ps (a, b)); }
+      static inline Vec mul (Vec a, Vec b) { return (_mm_mul_ps (a, b)); }
+      static inline Vec div (Vec a, Vec b) { return (_mm_div_ps (a, b)); }
+      static inline Vec sqrt (Vec a) { return (_mm_sqrt_ps (a)); }
+      static inline Vec min (Vec a, Vec b) { return (_mm_min_ps (a, b)); }
+      static inline Vec max (Vec a, Vec b) { return (_mm_max_ps (a, b)); }
+      static inline Vec abs (Vec a) { return (_mm_andnot_ps (_mm_set1_ps (-0.0f), a)); }
+      static inline Vec andMask (Vec a, Vec b) { return (_mm_and_ps (a, b)); }
+      static inline Vec andNotMask (Vec a, Vec b) { return (_mm_andnot_ps (a, b)); }
+      static inline Vec orMask (Vec a, Vec b) { return (_mm_or_ps (a, b)); }
+      static inline Vec xorMask (Vec a, Vec b) { return (_mm_xor_ps (a, b)); }
+      static inline Vec eq (Vec a, Vec b) { return (_mm_cmpeq_ps (a, b)); }
+      static inline Vec lt (Vec a, Vec b) { return (_mm_cmplt_ps (a, b)); }
+      static inline Vec le (Vec a, Vec b) { return (_mm_cmple_ps (a, b)); }
+      static inline Vec ge (Vec a, Vec b) { return (_mm_cmpge_ps (a, b)); }
+      static inline Vec gt (Vec a, Vec b) { return (_mm_cmpgt_ps (a, b)); }
+      /** \brief per lane mask ? a : b */
+      static inline Vec select (Vec mask, Vec a, Vec b) { return (_mm_or_ps (_mm_and_ps (mask, a), _mm_andnot_ps (mask, b))); }
+    };
+#endif
+
+#if defined (__AVX__)
+    /** \brief 8-wide float operations. */
+    struct AVXOps
+    {
+      using Vec = __m256;
+      static const std::size_t width = 8;
+
+      static inline Vec load (const float *p) { return (_mm256_loadu_ps (p)); }
+      static inline void store (float *p, Vec a) { _mm256_storeu_ps (p, a); }
+      /** \brief store a, truncated to integers */
+      static inline void storeInt (int *p, Vec a) { _mm256_storeu_si256 (reinterpret_cast<__m256i*> (p), _mm256_cvttps_epi32 (a)); }
+      static inline Vec set1 (float a) { return (_mm256_set1_ps (a)); }
+      static inline Vec add (Vec a, Vec b) { return (_mm256_add_ps (a, b)); }
+      static inline Vec sub (Vec a, Vec b) { return (_mm256_sub_ps (a, b)); }
+      static inline Vec mul (Vec a, Vec b) { return (_mm256_mul_ps (a, b)); }
+      static inline Vec div (Vec a, Vec b) { return (_mm256_div_ps (a, b)); }
+      static inline Vec sqrt (Vec a) { return (_mm256_sqrt_ps (a)); }
+      static inline Vec min (Vec a, Vec b) { return (_mm256_min_ps (a, b)); }
+      static inline Vec max (Vec a, Vec b) { return (_mm256_max_ps (a, b)); }
+      static inline Vec abs (Vec a) { return (_mm256_andnot_ps (_mm256_set1_ps (-0.0f), a)); }
+      static inline Vec andMask (Vec a, Vec b) { return (_mm256_and_ps (a, b)); }
+      static inline Vec andNotMask (Vec a, Vec b) { return (_mm256_andnot_ps (a, b)); }
+      static inline Vec orMask (Vec a, Vec b) { return (_mm256_or_ps (a, b)); }
+      static inline Vec xorMask (Vec a, Vec b) { return (_mm256_xor_ps (a, b)); }
+      static inline Vec eq (Vec a, Vec b) { return (_mm256_cmp_ps (a, b, _CMP_EQ_OQ)); }
+      static inline Vec lt (Vec a, Vec b) { return (_mm256_cmp_ps (a, b, _CMP_LT_OQ)); }
+      static inline Vec le (Vec a, Vec b) { return (_mm256_cmp_ps (a, b, _CMP_LE_OQ)); }
+      static inline Vec ge (Vec a, Vec b) { return (_mm256_cmp_ps (a, b, _CMP_GE_OQ)); }
+      static inline Vec gt (Vec a, Vec b) { return (_mm256_cmp_ps (a, b, _CMP_GT_OQ)); }
+      /** \brief per lane mask ? a : b */
+      static inline Vec select (Vec mask, Vec a, Vec b) { return (_mm256_blendv_ps (b, a, mask)); }
+    };
+#endif
+
+    /** \brief atan2 (y, x) for y >= 0, using the single precision polynomial of the Cephes atanf.
+      * The result is in [0, pi], the error is a few ulps.
+      */
+    template <typename Ops> inline typename Ops::Vec
+    atan2Positive (typename Ops::Vec y, typename Ops::Vec x)
+    {
+      using Vec = typename Ops::Vec;
+      const Vec ax = Ops::abs (x);
+      const Vec hi = Ops::max (Ops::max (y, ax), Ops::set1 (FLT_MIN));
+      Vec a = Ops::div (Ops::min (y, ax), hi);
+
+      // Reduce the argument to [0, tan (pi/8)]
+      const Vec reduce = Ops::gt (a, Ops::set1 (0.414213562373095f));
+      a = Ops::select (reduce, Ops::div (Ops::sub (a, Ops::set1 (1.0f)), Ops::add (a, Ops::set1 (1.0f))), a);
+      const Vec offset = Ops::andMask (reduce, Ops::set1 (static_cast<float> (M_PI / 4.0)));
+
+      const Vec z = Ops::mul (a, a);
+      Vec p = Ops::set1 (8.05374449538e-2f);
+      p = Ops::sub (Ops::mul (p, z), Ops::set1 (1.38776856032e-1f));
+      p = Ops::add (Ops::mul (p, z), Ops::set1 (1.99777106478e-1f));
+      p = Ops::sub (Ops::mul (p, z), Ops::set1 (3.33329491539e-1f));
+      p = Ops::add (Ops::mul (Ops::mul (p, z), a), a);
+      Vec r = Ops::add (offset, p);
+
+      // Undo the octant reduction: atan (y/x) = pi/2 - atan (x/y), atan2 (y, -x) = pi - atan2 (y, x)
+      r = Ops::select (Ops::gt (y, ax), Ops::sub (Ops::set1 (static_cast<float> (M_PI / 2.0)), r), r);
+      r = Ops::select (Ops::lt (x, Ops::set1 (0.0f)), Ops::sub (Ops::set1 (static_cast<float> (M_PI)), r), r);
+      return (r);
+    }
+  }
+}
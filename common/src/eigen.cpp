@@ -0,0 +1,186 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2019-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <pcl/common/eigen.h>
+#include <pcl/common/simd_ops.h>
+
+#include <cfloat>
+
+namespace
+{
+#if defined (__SSE2__)
+  using pcl::detail::SSEOps;
+#endif
+#if defined (__AVX__)
+  using pcl::detail::AVXOps;
+#endif
+  using pcl::detail::atan2Positive;
+
+  /** \brief cos and sin of an angle in [0, pi/3] by their Taylor series, truncated after the x^10 and x^11 terms. */
+  template <typename Ops> inline void
+  cosSinSmall (typename Ops::Vec x, typename Ops::Vec &c, typename Ops::Vec &s)
+  {
+    using Vec = typename Ops::Vec;
+    const Vec x2 = Ops::mul (x, x);
+    c = Ops::set1 (-1.0f / 3628800.0f);
+    c = Ops::add (Ops::mul (c, x2), Ops::set1 (1.0f / 40320.0f));
+    c = Ops::sub (Ops::mul (c, x2), Ops::set1 (1.0f / 720.0f));
+    c = Ops::add (Ops::mul (c, x2), Ops::set1 (1.0f / 24.0f));
+    c = Ops::sub (Ops::mul (c, x2), Ops::set1 (0.5f));
+    c = Ops::add (Ops::mul (c, x2), Ops::set1 (1.0f));
+
+    s = Ops::set1 (-1.0f / 39916800.0f);
+    s = Ops::add (Ops::mul (s, x2), Ops::set1 (1.0f / 362880.0f));
+    s = Ops::sub (Ops::mul (s, x2), Ops::set1 (1.0f / 5040.0f));
+    s = Ops::add (Ops::mul (s, x2), Ops::set1 (1.0f / 120.0f));
+    s = Ops::sub (Ops::mul (s, x2), Ops::set1 (1.0f / 6.0f));
+    s = Ops::mul (Ops::add (Ops::mul (s, x2), Ops::set1 (1.0f)), x);
+  }
+
+  /** \brief Solve Ops::width matrices starting at offset i, following pcl::eigen33 (mat, eigenvalue, eigenvector) step by step. */
+  template <typename Ops> inline void
+  eigen33Lanes (std::size_t i,
+                const float *c00, const float *c01, const float *c02,
+                const float *c11, const float *c12, const float *c22,
+                float *eigenvalues, float *eigenvector_x, float *eigenvector_y, float *eigenvector_z)
+  {
+    using Vec = typename Ops::Vec;
+    const Vec zero = Ops::set1 (0.0f);
+    const Vec one = Ops::set1 (1.0f);
+    const Vec two = Ops::set1 (2.0f);
+    const Vec inv3 = Ops::set1 (1.0f / 3.0f);
+    const Vec sqrt3 = Ops::set1 (std::sqrt (3.0f));
+
+    Vec m00 = Ops::load (c00 + i), m01 = Ops::load (c01 + i), m02 = Ops::load (c02 + i);
+    Vec m11 = Ops::load (c11 + i), m12 = Ops::load (c12 + i), m22 = Ops::load (c22 + i);
+
+    // Scale the matrix so its entries are in [-1,1]
+    Vec scale = Ops::max (Ops::max (Ops::max (Ops::abs (m00), Ops::abs (m01)), Ops::max (Ops::abs (m02), Ops::abs (m11))),
+                          Ops::max (Ops::abs (m12), Ops::abs (m22)));
+    scale = Ops::select (Ops::le (scale, Ops::set1 (FLT_MIN)), one, scale);
+    const Vec inv_scale = Ops::div (one, scale);
+    m00 = Ops::mul (m00, inv_scale); m01 = Ops::mul (m01, inv_scale); m02 = Ops::mul (m02, inv_scale);
+    m11 = Ops::mul (m11, inv_scale); m12 = Ops::mul (m12, inv_scale); m22 = Ops::mul (m22, inv_scale);
+
+    // Characteristic polynomial x^3 - c2*x^2 + c1*x - c0 = 0
+    const Vec m01_2 = Ops::mul (m01, m01), m02_2 = Ops::mul (m02, m02), m12_2 = Ops::mul (m12, m12);
+    Vec k0 = Ops::mul (Ops::mul (m00, m11), m22);
+    k0 = Ops::add (k0, Ops::mul (two, Ops::mul (Ops::mul (m01, m02), m12)));
+    k0 = Ops::sub (k0, Ops::mul (m00, m12_2));
+    k0 = Ops::sub (k0, Ops::mul (m11, m02_2));
+    k0 = Ops::sub (k0, Ops::mul (m22, m01_2));
+    Vec k1 = Ops::sub (Ops::mul (m00, m11), m01_2);
+    k1 = Ops::add (k1, Ops::sub (Ops::mul (m00, m22), m02_2));
+    k1 = Ops::add (k1, Ops::sub (Ops::mul (m11, m22), m12_2));
+    const Vec k2 = Ops::add (Ops::add (m00, m11), m22);
+
+    const Vec k2_over_3 = Ops::mul (k2, inv3);
+    const Vec a_over_3 = Ops::min (Ops::mul (Ops::sub (k1, Ops::mul (k2, k2_over_3)), inv3), zero);
+    const Vec half_b = Ops::mul (Ops::set1 (0.5f),
+                                 Ops::add (k0, Ops::mul (k2_over_3, Ops::sub (Ops::mul (Ops::mul (two, k2_over_3), k2_over_3), k1))));
+    const Vec q = Ops::min (Ops::add (Ops::mul (half_b, half_b), Ops::mul (Ops::mul (a_over_3, a_over_3), a_over_3)), zero);
+
+    const Vec rho = Ops::sqrt (Ops::sub (zero, a_over_3));
+    const Vec theta = Ops::mul (atan2Positive<Ops> (Ops::sqrt (Ops::sub (zero, q)), half_b), inv3);
+    Vec cos_theta, sin_theta;
+    cosSinSmall<Ops> (theta, cos_theta, sin_theta);
+    const Vec r0 = Ops::add (k2_over_3, Ops::mul (Ops::mul (two, rho), cos_theta));
+    const Vec r1 = Ops::sub (k2_over_3, Ops::mul (rho, Ops::add (cos_theta, Ops::mul (sqrt3, sin_theta))));
+    const Vec r2 = Ops::sub (k2_over_3, Ops::mul (rho, Ops::sub (cos_theta, Ops::mul (sqrt3, sin_theta))));
+    Vec lambda = Ops::min (Ops::min (r0, r1), r2);
+
+    // A vanishing determinant or a non-positive root falls back to the quadratic case, whose smallest root is 0
+    const Vec singular = Ops::lt (Ops::abs (k0), Ops::set1 (FLT_EPSILON));
+    lambda = Ops::andNotMask (Ops::orMask (singular, Ops::le (lambda, zero)), lambda);
+
+    // The eigenvector is the largest cross product of two rows of (mat - lambda * I)
+    const Vec d0 = Ops::sub (m00, lambda), d1 = Ops::sub (m11, lambda), d2 = Ops::sub (m22, lambda);
+    const Vec v1x = Ops::sub (Ops::mul (m01, m12), Ops::mul (m02, d1));
+    const Vec v1y = Ops::sub (Ops::mul (m02, m01), Ops::mul (d0, m12));
+    const Vec v1z = Ops::sub (Ops::mul (d0, d1), m01_2);
+    const Vec v2x = Ops::sub (Ops::mul (m01, d2), Ops::mul (m02, m12));
+    const Vec v2y = Ops::sub (m02_2, Ops::mul (d0, d2));
+    const Vec v2z = Ops::sub (Ops::mul (d0, m12), Ops::mul (m01, m02));
+    const Vec v3x = Ops::sub (Ops::mul (d1, d2), m12_2);
+    const Vec v3y = Ops::sub (Ops::mul (m12, m02), Ops::mul (m01, d2));
+    const Vec v3z = Ops::sub (Ops::mul (m01, m12), Ops::mul (d1, m02));
+
+    const Vec len1 = Ops::add (Ops::add (Ops::mul (v1x, v1x), Ops::mul (v1y, v1y)), Ops::mul (v1z, v1z));
+    const Vec len2 = Ops::add (Ops::add (Ops::mul (v2x, v2x), Ops::mul (v2y, v2y)), Ops::mul (v2z, v2z));
+    const Vec len3 = Ops::add (Ops::add (Ops::mul (v3x, v3x), Ops::mul (v3y, v3y)), Ops::mul (v3z, v3z));
+
+    const Vec use1 = Ops::andMask (Ops::ge (len1, len2), Ops::ge (len1, len3));
+    const Vec use2 = Ops::andNotMask (use1, Ops::andMask (Ops::ge (len2, len1), Ops::ge (len2, len3)));
+    const Vec len = Ops::select (use1, len1, Ops::select (use2, len2, len3));
+    const Vec inv_norm = Ops::div (one, Ops::sqrt (len));
+
+    Ops::store (eigenvalues + i, Ops::mul (lambda, scale));
+    Ops::store (eigenvector_x + i, Ops::mul (Ops::select (use1, v1x, Ops::select (use2, v2x, v3x)), inv_norm));
+    Ops::store (eigenvector_y + i, Ops::mul (Ops::select (use1, v1y, Ops::select (use2, v2y, v3y)), inv_norm));
+    Ops::store (eigenvector_z + i, Ops::mul (Ops::select (use1, v1z, Ops::select (use2, v2z, v3z)), inv_norm));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::eigen33Batch (std::size_t nr_matrices,
+                   const float *c00, const float *c01, const float *c02,
+                   const float *c11, const float *c12, const float *c22,
+                   float *eigenvalues, float *eigenvector_x, float *eigenvector_y, float *eigenvector_z)
+{
+  std::size_t i = 0;
+#if defined (__AVX__)
+  for (; i + AVXOps::width <= nr_matrices; i += AVXOps::width)
+    eigen33Lanes<AVXOps> (i, c00, c01, c02, c11, c12, c22, eigenvalues, eigenvector_x, eigenvector_y, eigenvector_z);
+#endif
+#if defined (__SSE2__)
+  for (; i + SSEOps::width <= nr_matrices; i += SSEOps::width)
+    eigen33Lanes<SSEOps> (i, c00, c01, c02, c11, c12, c22, eigenvalues, eigenvector_x, eigenvector_y, eigenvector_z);
+#endif
+  // Remaining matrices (or all of them, without SIMD support) go through the scalar solver
+  for (; i < nr_matrices; ++i)
+  {
+    Eigen::Matrix3f mat;
+    mat << c00[i], c01[i], c02[i],
+           c01[i], c11[i], c12[i],
+           c02[i], c12[i], c22[i];
+    Eigen::Vector3f eigenvector;
+    pcl::eigen33 (mat, eigenvalues[i], eigenvector);
+    eigenvector_x[i] = eigenvector[0];
+    eigenvector_y[i] = eigenvector[1];
+    eigenvector_z[i] = eigenvector[2];
+  }
+}
@@ -88,14 +88,20 @@ namespace pcl
       using Feature<PointInT, PointOutT>::search_parameter_;
       using Feature<PointInT, PointOutT>::input_;
       using Feature<PointInT, PointOutT>::surface_;
+      using Feature<PointInT, PointOutT>::tree_;
       using FeatureFromNormals<PointInT, PointNT, PointOutT>::normals_;
 
       using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
+      using PointCloudInConstPtr = typename Feature<PointInT, PointOutT>::PointCloudInConstPtr;
+      using PointCloudNConstPtr = typename FeatureFromNormals<PointInT, PointNT, PointOutT>::PointCloudNConstPtr;
 
       /** \brief Empty constructor. */
       FPFHEstimation () : 
         nr_bins_f1_ (11), nr_bins_f2_ (11), nr_bins_f3_ (11), 
-        d_pi_ (1.0f / (2.0f * static_cast<float> (M_PI)))
+        d_pi_ (1.0f / (2.0f * static_cast<float> (M_PI))),
+        use_spfh_cache_ (false),
+        spfh_cache_k_ (0),
+        spfh_cache_parameter_ (0)
       {
         feature_name_ = "FPFHEstimation";
       };
@@ -177,6 +183,49 @@ namespace pcl
         nr_bins_f3 = nr_bins_f3_;
       }
 
+      /** \brief Set whether the SPFH signatures computed by compute () should be kept for subsequent calls.
+        * With the cache enabled, repeated calls on overlapping sets of query points (e.g. keypoints or sliding
+        * windows over the same surface) only compute the SPFH signatures of surface points not seen before.
+        * The cache is dropped automatically when the search surface, the normals, the search method, the
+        * search parameter or the number of subdivisions change.
+        * \note Modifying the search surface or the normals in place is not detected, call clearSPFHCache () then.
+        * \param[in] use_cache true to keep the SPFH signatures between calls (default: false)
+        */
+      inline void
+      setUseSPFHCache (bool use_cache)
+      {
+        use_spfh_cache_ = use_cache;
+        if (!use_cache)
+          clearSPFHCache ();
+      }
+
+      /** \brief Get whether the SPFH signatures are kept between calls to compute (). */
+      inline bool
+      getUseSPFHCache () const
+      {
+        return (use_spfh_cache_);
+      }
+
+      /** \brief Drop all cached SPFH signatures. */
+      inline void
+      clearSPFHCache ()
+      {
+        spfh_hist_lookup_.clear ();
+        hist_f1_.resize (0, nr_bins_f1_);
+        hist_f2_.resize (0, nr_bins_f2_);
+        hist_f3_.resize (0, nr_bins_f3_);
+        spfh_cache_surface_.reset ();
+        spfh_cache_normals_.reset ();
+        spfh_cache_tree_.reset ();
+      }
+
+      /** \brief Get the number of SPFH signatures currently held in the cache. */
+      inline size_t
+      getSPFHCacheSize () const
+      {
+        return (static_cast<size_t> (hist_f1_.rows ()));
+      }
+
     protected:
 
       /** \brief Estimate the set of all SPFH (Simple Point Feature Histograms) signatures for the input cloud
@@ -197,6 +246,37 @@ namespace pcl
       void 
       computeFeature (PointCloudOut &output) override;
 
+      /** \brief Estimate the FPFH descriptors of all query points: every neighborhood is searched exactly once,
+        * the SPFH signatures missing from the cache are computed and then weighted into the output.
+        * Both stages run on \a nr_threads OpenMP threads.
+        * \param[in] nr_threads the number of threads to use
+        * \param[out] output the resultant point cloud model dataset that contains the FPFH feature estimates
+        */
+      void
+      computeFPFHSignatures (unsigned int nr_threads, PointCloudOut &output);
+
+      /** \brief Search the neighborhoods of all query points given by <setInputCloud (), setIndices ()> and store
+        * them in compressed sparse row form: the neighbors of the i-th query point are the entries
+        * [nn_offsets[i], nn_offsets[i + 1]) of \a nn_indices and \a nn_dists. Query points that are not finite
+        * or have no neighbors get an empty range.
+        * \param[in] nr_threads the number of threads to use
+        * \param[out] nn_offsets the start of each query point's neighborhood, of size indices_->size () + 1
+        * \param[out] nn_indices the concatenated neighbor indices into the search surface
+        * \param[out] nn_dists the concatenated squared distances to the neighbors
+        */
+      void
+      searchQueryNeighborhoods (unsigned int nr_threads, std::vector<int> &nn_offsets,
+                                std::vector<int> &nn_indices, std::vector<float> &nn_dists);
+
+      /** \brief Compute the SPFH signatures of all neighbors of the query points that are not in the cache yet,
+        * and append them to hist_f1_, hist_f2_ and hist_f3_.
+        * \param[in] nr_threads the number of threads to use
+        * \param[in] nn_offsets the query neighborhoods as returned by searchQueryNeighborhoods ()
+        * \param[in] nn_indices the query neighborhoods as returned by searchQueryNeighborhoods ()
+        */
+      void
+      updateSPFHCache (unsigned int nr_threads, const std::vector<int> &nn_offsets, const std::vector<int> &nn_indices);
+
       /** \brief The number of subdivisions for each angular feature interval. */
       int nr_bins_f1_, nr_bins_f2_, nr_bins_f3_;
 
@@ -214,6 +294,21 @@ namespace pcl
 
       /** \brief Float constant = 1.0 / (2.0 * M_PI) */
       float d_pi_; 
+
+      /** \brief Whether the SPFH signatures are kept between calls to compute (). */
+      bool use_spfh_cache_;
+
+      /** \brief Row of every search surface point's SPFH signature in hist_f1_, hist_f2_ and hist_f3_,
+        * or -1 if it has not been computed. */
+      std::vector<int> spfh_hist_lookup_;
+
+      /** \brief The search surface, normals, search method and search parameters the cached SPFH signatures
+        * were computed with. */
+      PointCloudInConstPtr spfh_cache_surface_;
+      PointCloudNConstPtr spfh_cache_normals_;
+      typename Feature<PointInT, PointOutT>::KdTreePtr spfh_cache_tree_;
+      int spfh_cache_k_;
+      double spfh_cache_parameter_;
   };
 }
 
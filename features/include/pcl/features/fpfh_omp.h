@@ -88,13 +88,16 @@ namespace pcl
       using FPFHEstimation<PointInT, PointNT, PointOutT>::hist_f2_;
       using FPFHEstimation<PointInT, PointNT, PointOutT>::hist_f3_;
       using FPFHEstimation<PointInT, PointNT, PointOutT>::weightPointSPFHSignature;
+      using FPFHEstimation<PointInT, PointNT, PointOutT>::nr_bins_f1_;
+      using FPFHEstimation<PointInT, PointNT, PointOutT>::nr_bins_f2_;
+      using FPFHEstimation<PointInT, PointNT, PointOutT>::nr_bins_f3_;
 
       using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
 
       /** \brief Initialize the scheduler and set the number of threads to use.
         * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
         */
-      FPFHEstimationOMP (unsigned int nr_threads = 0) : nr_bins_f1_ (11), nr_bins_f2_ (11), nr_bins_f3_ (11)
+      FPFHEstimationOMP (unsigned int nr_threads = 0)
       {
         feature_name_ = "FPFHEstimationOMP";
 
@@ -116,9 +119,6 @@ namespace pcl
       void
       computeFeature (PointCloudOut &output) override;
 
-    public:
-      /** \brief The number of subdivisions for each angular feature interval. */
-      int nr_bins_f1_, nr_bins_f2_, nr_bins_f3_;
     private:
       /** \brief The number of threads the scheduler should use. */
       unsigned int threads_;
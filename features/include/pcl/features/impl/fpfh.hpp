@@ -231,73 +231,186 @@ pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::computeSPFHSignatures (std::v
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointNT, typename PointOutT> void
-pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::searchQueryNeighborhoods (
+    unsigned int nr_threads, std::vector<int> &nn_offsets, std::vector<int> &nn_indices, std::vector<float> &nn_dists)
 {
-  // Allocate enough space to hold the NN search results
-  // \note This resize is irrelevant for a radiusSearch ().
-  std::vector<int> nn_indices (k_);
-  std::vector<float> nn_dists (k_);
-
-  std::vector<int> spfh_hist_lookup;
-  computeSPFHSignatures (spfh_hist_lookup, hist_f1_, hist_f2_, hist_f3_);
-
-  output.is_dense = true;
-  // Save a few cycles by not checking every point for NaN/Inf values if the cloud is set to dense
-  if (input_->is_dense)
+  const int nr_queries = static_cast<int> (indices_->size ());
+  const int nr_chunks = std::max (1, std::min (static_cast<int> (nr_threads), nr_queries));
+  nn_offsets.assign (nr_queries + 1, 0);
+
+  // Every chunk of consecutive query points collects its neighborhoods separately...
+  std::vector<std::vector<int> > chunk_indices (nr_chunks);
+  std::vector<std::vector<float> > chunk_dists (nr_chunks);
+#ifdef _OPENMP
+#pragma omp parallel for shared (nn_offsets, chunk_indices, chunk_dists) num_threads(nr_threads)
+#endif
+  for (int chunk = 0; chunk < nr_chunks; ++chunk)
   {
-    // Iterate over the entire index vector
-    for (size_t idx = 0; idx < indices_->size (); ++idx)
+    // \note These resizes are irrelevant for a radiusSearch ().
+    std::vector<int> indices (k_);
+    std::vector<float> dists (k_);
+    const int begin = static_cast<int> (static_cast<long long> (nr_queries) * chunk / nr_chunks);
+    const int end = static_cast<int> (static_cast<long long> (nr_queries) * (chunk + 1) / nr_chunks);
+    for (int idx = begin; idx < end; ++idx)
     {
-      if (this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
-      {
-        for (Eigen::Index d = 0; d < fpfh_histogram_.size (); ++d)
-          output.points[idx].histogram[d] = std::numeric_limits<float>::quiet_NaN ();
-    
-        output.is_dense = false;
+      if (!isFinite ((*input_)[(*indices_)[idx]]) ||
+          this->searchForNeighbors ((*indices_)[idx], search_parameter_, indices, dists) == 0)
         continue;
-      }
 
-      // ... and remap the nn_indices values so that they represent row indices in the spfh_hist_* matrices 
-      // instead of indices into surface_->points
-      for (int &nn_index : nn_indices)
-        nn_index = spfh_hist_lookup[nn_index];
+      chunk_indices[chunk].insert (chunk_indices[chunk].end (), indices.begin (), indices.end ());
+      chunk_dists[chunk].insert (chunk_dists[chunk].end (), dists.begin (), dists.end ());
+      nn_offsets[idx + 1] = static_cast<int> (indices.size ());
+    }
+  }
 
-      // Compute the FPFH signature (i.e. compute a weighted combination of local SPFH signatures) ...
-      weightPointSPFHSignature (hist_f1_, hist_f2_, hist_f3_, nn_indices, nn_dists, fpfh_histogram_);
+  // ... and they are concatenated in query order
+  for (int idx = 0; idx < nr_queries; ++idx)
+    nn_offsets[idx + 1] += nn_offsets[idx];
+  nn_indices.clear ();
+  nn_dists.clear ();
+  nn_indices.reserve (nn_offsets.back ());
+  nn_dists.reserve (nn_offsets.back ());
+  for (int chunk = 0; chunk < nr_chunks; ++chunk)
+  {
+    nn_indices.insert (nn_indices.end (), chunk_indices[chunk].begin (), chunk_indices[chunk].end ());
+    nn_dists.insert (nn_dists.end (), chunk_dists[chunk].begin (), chunk_dists[chunk].end ());
+  }
+}
 
-      // ...and copy it into the output cloud
-      for (Eigen::Index d = 0; d < fpfh_histogram_.size (); ++d)
-        output.points[idx].histogram[d] = fpfh_histogram_[d];
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::updateSPFHCache (
+    unsigned int nr_threads, const std::vector<int> &nn_offsets, const std::vector<int> &nn_indices)
+{
+  // Drop signatures computed for a different surface, normals or neighborhood definition
+  if (!use_spfh_cache_ ||
+      spfh_cache_surface_ != surface_ || spfh_cache_normals_ != normals_ || spfh_cache_tree_ != tree_ ||
+      spfh_cache_k_ != k_ || spfh_cache_parameter_ != search_parameter_ ||
+      hist_f1_.cols () != nr_bins_f1_ || hist_f2_.cols () != nr_bins_f2_ || hist_f3_.cols () != nr_bins_f3_ ||
+      spfh_hist_lookup_.size () != surface_->points.size ())
+  {
+    clearSPFHCache ();
+    spfh_hist_lookup_.assign (surface_->points.size (), -1);
+    if (use_spfh_cache_)
+    {
+      spfh_cache_surface_ = surface_;
+      spfh_cache_normals_ = normals_;
+      spfh_cache_tree_ = tree_;
+      spfh_cache_k_ = k_;
+      spfh_cache_parameter_ = search_parameter_;
     }
   }
-  else
+
+  // Every neighbor of a query point needs an SPFH signature; assign rows to the ones that are missing
+  std::vector<int> spfh_indices;
+  for (const int &nn_index : nn_indices)
   {
-    // Iterate over the entire index vector
-    for (size_t idx = 0; idx < indices_->size (); ++idx)
-    {
-      if (!isFinite ((*input_)[(*indices_)[idx]]) ||
-          this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
-      {
-        for (Eigen::Index d = 0; d < fpfh_histogram_.size (); ++d)
-          output.points[idx].histogram[d] = std::numeric_limits<float>::quiet_NaN ();
-    
-        output.is_dense = false;
-        continue;
-      }
+    if (spfh_hist_lookup_[nn_index] != -1)
+      continue;
+    spfh_hist_lookup_[nn_index] = static_cast<int> (hist_f1_.rows () + spfh_indices.size ());
+    spfh_indices.push_back (nn_index);
+  }
+  if (spfh_indices.empty ())
+    return;
+
+  const Eigen::Index first_row = hist_f1_.rows ();
+  const Eigen::Index nr_rows = first_row + static_cast<Eigen::Index> (spfh_indices.size ());
+  hist_f1_.conservativeResize (nr_rows, nr_bins_f1_);
+  hist_f2_.conservativeResize (nr_rows, nr_bins_f2_);
+  hist_f3_.conservativeResize (nr_rows, nr_bins_f3_);
+  hist_f1_.bottomRows (spfh_indices.size ()).setZero ();
+  hist_f2_.bottomRows (spfh_indices.size ()).setZero ();
+  hist_f3_.bottomRows (spfh_indices.size ()).setZero ();
+
+  // When the query points live in the search surface, their neighborhoods are the SPFH neighborhoods
+  std::vector<int> query_lookup;
+  if (surface_ == input_)
+  {
+    query_lookup.assign (surface_->points.size (), -1);
+    for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
+      if (nn_offsets[idx + 1] != nn_offsets[idx])
+        query_lookup[(*indices_)[idx]] = idx;
+  }
 
-      // ... and remap the nn_indices values so that they represent row indices in the spfh_hist_* matrices 
-      // instead of indices into surface_->points
-      for (int &nn_index : nn_indices)
-        nn_index = spfh_hist_lookup[nn_index];
+  // Compute SPFH signatures for every point that needs them
+#ifdef _OPENMP
+#pragma omp parallel for shared (spfh_indices, query_lookup) num_threads(nr_threads)
+#endif
+  for (int i = 0; i < static_cast<int> (spfh_indices.size ()); ++i)
+  {
+    // \note These resizes are irrelevant for a radiusSearch ().
+    std::vector<int> indices (k_);
+    std::vector<float> dists (k_);
+    const int p_idx = spfh_indices[i];
+    const int query = query_lookup.empty () ? -1 : query_lookup[p_idx];
+    if (query != -1)
+      indices.assign (nn_indices.begin () + nn_offsets[query], nn_indices.begin () + nn_offsets[query + 1]);
+    // Find the neighborhood around p_idx
+    else if (!isFinite ((*surface_)[p_idx]) ||
+             this->searchForNeighbors (*surface_, p_idx, search_parameter_, indices, dists) == 0)
+      continue;
+
+    // Estimate the SPFH signature around p_idx
+    computePointSPFHSignature (*surface_, *normals_, p_idx, static_cast<int> (first_row) + i, indices,
+                               hist_f1_, hist_f2_, hist_f3_);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::computeFPFHSignatures (unsigned int nr_threads, PointCloudOut &output)
+{
+  // Search the neighborhood of every query point exactly once
+  std::vector<int> nn_offsets, nn_indices;
+  std::vector<float> nn_dists;
+  searchQueryNeighborhoods (nr_threads, nn_offsets, nn_indices, nn_dists);
+
+  updateSPFHCache (nr_threads, nn_offsets, nn_indices);
 
-      // Compute the FPFH signature (i.e. compute a weighted combination of local SPFH signatures) ...
-      weightPointSPFHSignature (hist_f1_, hist_f2_, hist_f3_, nn_indices, nn_dists, fpfh_histogram_);
+  const int nr_bins = nr_bins_f1_ + nr_bins_f2_ + nr_bins_f3_;
+  bool is_dense = true;
 
-      // ...and copy it into the output cloud
-      for (Eigen::Index d = 0; d < fpfh_histogram_.size (); ++d)
-        output.points[idx].histogram[d] = fpfh_histogram_[d];
+  // Iterate over the entire index vector
+#ifdef _OPENMP
+#pragma omp parallel for shared (output, nn_offsets, nn_indices, nn_dists) reduction (&&: is_dense) num_threads(nr_threads)
+#endif
+  for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
+  {
+    if (nn_offsets[idx + 1] == nn_offsets[idx])
+    {
+      for (int d = 0; d < nr_bins; ++d)
+        output.points[idx].histogram[d] = std::numeric_limits<float>::quiet_NaN ();
+
+      is_dense = false;
+      continue;
     }
+
+    // Remap the neighbors of point idx so that they represent row indices in the spfh_hist_* matrices
+    // instead of indices into surface_->points
+    std::vector<int> indices (nn_indices.begin () + nn_offsets[idx], nn_indices.begin () + nn_offsets[idx + 1]);
+    std::vector<float> dists (nn_dists.begin () + nn_offsets[idx], nn_dists.begin () + nn_offsets[idx + 1]);
+    for (int &nn_index : indices)
+      nn_index = spfh_hist_lookup_[nn_index];
+
+    // Compute the FPFH signature (i.e. compute a weighted combination of local SPFH signatures) ...
+    Eigen::VectorXf fpfh_histogram;
+    weightPointSPFHSignature (hist_f1_, hist_f2_, hist_f3_, indices, dists, fpfh_histogram);
+
+    // ...and copy it into the output cloud
+    for (int d = 0; d < nr_bins; ++d)
+      output.points[idx].histogram[d] = fpfh_histogram[d];
   }
+  output.is_dense = is_dense;
+
+  if (!use_spfh_cache_)
+    clearSPFHCache ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  computeFPFHSignatures (1, output);
 }
 
 #define PCL_INSTANTIATE_FPFHEstimation(T,NT,OutT) template class PCL_EXPORTS pcl::FPFHEstimation<T,NT,OutT>;
@@ -40,8 +40,61 @@
 #ifndef PCL_INTEGRAL_IMAGE2D_IMPL_H_
 #define PCL_INTEGRAL_IMAGE2D_IMPL_H_
 
+#include <algorithm>
 #include <cstddef>
 
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Turn rows of running sums into an integral image, by adding each row to the next one.
+      * The columns are split in slices processed in parallel, each slice walking down all rows so that
+      * the previous row is still in cache; the inner loop is contiguous and gets vectorized.
+      * \param[in,out] image the rows of running sums, the first row being zero
+      * \param[in] row_size the number of scalars in a row
+      * \param[in] nr_rows the number of rows, including the first one
+      * \param[in] nr_threads the number of threads to use
+      */
+    template <typename Scalar> void
+    accumulateIntegralImageRows (Scalar *image, std::size_t row_size, std::size_t nr_rows, unsigned int nr_threads)
+    {
+      const std::size_t slice_size = 1024;
+      const int nr_slices = static_cast<int> ((row_size + slice_size - 1) / slice_size);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nr_threads)
+#else
+      (void) nr_threads;
+#endif
+      for (int slice = 0; slice < nr_slices; ++slice)
+      {
+        const std::size_t begin = static_cast<std::size_t> (slice) * slice_size;
+        const std::size_t end = std::min (begin + slice_size, row_size);
+        for (std::size_t row = 2; row < nr_rows; ++row)
+        {
+          Scalar *current = image + row * row_size;
+          const Scalar *previous = current - row_size;
+          for (std::size_t i = begin; i < end; ++i)
+            current[i] += previous[i];
+        }
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename DataType, unsigned Dimension> void
+pcl::IntegralImage2D<DataType, Dimension>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename DataType, unsigned Dimension> void
 pcl::IntegralImage2D<DataType, Dimension>::setSecondOrderComputation (bool compute_second_order_integral_images)
@@ -154,72 +207,74 @@ template <typename DataType, unsigned Dimension> void
 pcl::IntegralImage2D<DataType, Dimension>::computeIntegralImages (
     const DataType *data, unsigned row_stride, unsigned element_stride)
 {
-  ElementType* previous_row = &first_order_integral_image_[0];
-  ElementType* current_row  = previous_row + (width_ + 1);
-  memset (previous_row, 0, sizeof (ElementType) * (width_ + 1));
-
-  unsigned* count_previous_row = &finite_values_integral_image_[0];
-  unsigned* count_current_row  = count_previous_row + (width_ + 1);
-  memset (count_previous_row, 0, sizeof (unsigned) * (width_ + 1));
-
-  if (!compute_second_order_integral_images_)
-  {
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1))
-    {
-      current_row [0].setZero ();
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
-      {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
-        const InputType* element = reinterpret_cast <const InputType*> (&data [valIdx]);
-        if (std::isfinite (element->sum ()))
-        {
-          current_row [colIdx + 1] += element->template cast<typename IntegralImageTypeTraits<DataType>::IntegralType>();
-          ++(count_current_row [colIdx + 1]);
-        }
-      }
-    }
-  }
-  else
+  using IntegralType = typename IntegralImageTypeTraits<DataType>::IntegralType;
+  static_assert (sizeof (ElementType) == Dimension * sizeof (IntegralType), "integral image rows have to be contiguous");
+  static_assert (sizeof (SecondOrderType) == second_order_size * sizeof (IntegralType), "integral image rows have to be contiguous");
+
+  const std::size_t row_size = width_ + 1;
+  std::fill_n (first_order_integral_image_.begin (), row_size, ElementType::Zero ());
+  std::fill_n (finite_values_integral_image_.begin (), row_size, 0);
+  if (compute_second_order_integral_images_)
+    std::fill_n (second_order_integral_image_.begin (), row_size, SecondOrderType::Zero ());
+
+  // Running sums along each row; rows are independent
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_)
+#endif
+  for (int rowIdx = 0; rowIdx < static_cast<int> (height_); ++rowIdx)
   {
-    SecondOrderType* so_previous_row = &second_order_integral_image_[0];
-    SecondOrderType* so_current_row  = so_previous_row + (width_ + 1);
-    memset (so_previous_row, 0, sizeof (SecondOrderType) * (width_ + 1));
-
-    SecondOrderType so_element;
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1),
-                                                so_previous_row = so_current_row, so_current_row += (width_ + 1))
-    {
-      current_row [0].setZero ();
+    const DataType *row_data = data + static_cast<std::size_t> (rowIdx) * row_stride;
+    ElementType* current_row = &first_order_integral_image_[(rowIdx + 1) * row_size];
+    unsigned* count_current_row = &finite_values_integral_image_[(rowIdx + 1) * row_size];
+    SecondOrderType* so_current_row = compute_second_order_integral_images_ ? &second_order_integral_image_[(rowIdx + 1) * row_size] : nullptr;
+
+    current_row [0].setZero ();
+    count_current_row [0] = 0;
+    if (so_current_row)
       so_current_row [0].setZero ();
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
-      {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        so_current_row [colIdx + 1] = so_previous_row [colIdx + 1] + so_current_row [colIdx] - so_previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
+    for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
+    {
+      current_row [colIdx + 1] = current_row [colIdx];
+      count_current_row [colIdx + 1] = count_current_row [colIdx];
+      if (so_current_row)
+        so_current_row [colIdx + 1] = so_current_row [colIdx];
 
-        const InputType* element = reinterpret_cast <const InputType*> (&data [valIdx]);
-        if (std::isfinite (element->sum ()))
-        {
-          current_row [colIdx + 1] += element->template cast<typename IntegralImageTypeTraits<DataType>::IntegralType>();
-          ++(count_current_row [colIdx + 1]);
+      const InputType* element = reinterpret_cast <const InputType*> (&row_data [valIdx]);
+      if (std::isfinite (element->sum ()))
+      {
+        current_row [colIdx + 1] += element->template cast<IntegralType>();
+        ++(count_current_row [colIdx + 1]);
+        if (so_current_row)
           for (unsigned myIdx = 0, elIdx = 0; myIdx < Dimension; ++myIdx)
             for (unsigned mxIdx = myIdx; mxIdx < Dimension; ++mxIdx, ++elIdx)
               so_current_row [colIdx + 1][elIdx] += (*element)[myIdx] * (*element)[mxIdx];
-        }
       }
     }
   }
+
+  // Add up the rows
+  detail::accumulateIntegralImageRows (first_order_integral_image_[0].data (), row_size * Dimension, height_ + 1, threads_);
+  detail::accumulateIntegralImageRows (&finite_values_integral_image_[0], row_size, height_ + 1, threads_);
+  if (compute_second_order_integral_images_)
+    detail::accumulateIntegralImageRows (second_order_integral_image_[0].data (), row_size * second_order_size, height_ + 1, threads_);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+template <typename DataType> void
+pcl::IntegralImage2D<DataType, 1>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename DataType> void
 pcl::IntegralImage2D<DataType, 1>::setInput (const DataType * data, unsigned width,unsigned height, unsigned element_stride, unsigned row_stride)
 {
@@ -324,62 +379,49 @@ template <typename DataType> void
 pcl::IntegralImage2D<DataType, 1>::computeIntegralImages (
     const DataType *data, unsigned row_stride, unsigned element_stride)
 {
-  ElementType* previous_row = &first_order_integral_image_[0];
-  ElementType* current_row  = previous_row + (width_ + 1);
-  memset (previous_row, 0, sizeof (ElementType) * (width_ + 1));
-
-  unsigned* count_previous_row = &finite_values_integral_image_[0];
-  unsigned* count_current_row  = count_previous_row + (width_ + 1);
-  memset (count_previous_row, 0, sizeof (unsigned) * (width_ + 1));
-
-  if (!compute_second_order_integral_images_)
+  const std::size_t row_size = width_ + 1;
+  memset (&first_order_integral_image_[0], 0, sizeof (ElementType) * row_size);
+  memset (&finite_values_integral_image_[0], 0, sizeof (unsigned) * row_size);
+  if (compute_second_order_integral_images_)
+    memset (&second_order_integral_image_[0], 0, sizeof (SecondOrderType) * row_size);
+
+  // Running sums along each row; rows are independent
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_)
+#endif
+  for (int rowIdx = 0; rowIdx < static_cast<int> (height_); ++rowIdx)
   {
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1))
-    {
-      current_row [0] = 0.0;
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
-      {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
-        if (std::isfinite (data [valIdx]))
-        {
-          current_row [colIdx + 1] += data [valIdx];
-          ++(count_current_row [colIdx + 1]);
-        }
-      }
-    }
-  }
-  else
-  {
-    SecondOrderType* so_previous_row = &second_order_integral_image_[0];
-    SecondOrderType* so_current_row  = so_previous_row + (width_ + 1);
-    memset (so_previous_row, 0, sizeof (SecondOrderType) * (width_ + 1));
-
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1),
-                                                so_previous_row = so_current_row, so_current_row += (width_ + 1))
-    {
-      current_row [0] = 0.0;
+    const DataType *row_data = data + static_cast<std::size_t> (rowIdx) * row_stride;
+    ElementType* current_row = &first_order_integral_image_[(rowIdx + 1) * row_size];
+    unsigned* count_current_row = &finite_values_integral_image_[(rowIdx + 1) * row_size];
+    SecondOrderType* so_current_row = compute_second_order_integral_images_ ? &second_order_integral_image_[(rowIdx + 1) * row_size] : nullptr;
+
+    current_row [0] = 0.0;
+    count_current_row [0] = 0;
+    if (so_current_row)
       so_current_row [0] = 0.0;
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
+    for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
+    {
+      current_row [colIdx + 1] = current_row [colIdx];
+      count_current_row [colIdx + 1] = count_current_row [colIdx];
+      if (so_current_row)
+        so_current_row [colIdx + 1] = so_current_row [colIdx];
+
+      if (std::isfinite (row_data [valIdx]))
       {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        so_current_row [colIdx + 1] = so_previous_row [colIdx + 1] + so_current_row [colIdx] - so_previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
-        if (std::isfinite (data[valIdx]))
-        {
-          current_row [colIdx + 1] += data[valIdx];
-          so_current_row [colIdx + 1] += data[valIdx] * data[valIdx];
-          ++(count_current_row [colIdx + 1]);
-        }
+        current_row [colIdx + 1] += row_data [valIdx];
+        ++(count_current_row [colIdx + 1]);
+        if (so_current_row)
+          so_current_row [colIdx + 1] += row_data [valIdx] * row_data [valIdx];
       }
     }
   }
+
+  // Add up the rows
+  detail::accumulateIntegralImageRows (&first_order_integral_image_[0], row_size, height_ + 1, threads_);
+  detail::accumulateIntegralImageRows (&finite_values_integral_image_[0], row_size, height_ + 1, threads_);
+  if (compute_second_order_integral_images_)
+    detail::accumulateIntegralImageRows (&second_order_integral_image_[0], row_size, height_ + 1, threads_);
 }
 #endif    // PCL_INTEGRAL_IMAGE2D_IMPL_H_
 
@@ -40,6 +40,7 @@
 #define PCL_FEATURES_INTEGRALIMAGE_BASED_IMPL_NORMAL_ESTIMATOR_H_
 
 #include <pcl/features/integral_image_normal.h>
+#include <pcl/common/eigen.h>
 
 //////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT>
@@ -100,6 +101,39 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::setRectSize (const int
   rect_height_4_   = height/4;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+
+  integral_image_DX_.setNumberOfThreads (threads_);
+  integral_image_DY_.setNumberOfThreads (threads_);
+  integral_image_depth_.setNumberOfThreads (threads_);
+  integral_image_XYZ_.setNumberOfThreads (threads_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::initCurrentMethod ()
+{
+  if (normal_estimation_method_ == COVARIANCE_MATRIX && !init_covariance_matrix_)
+    initCovarianceMatrixMethod ();
+  else if (normal_estimation_method_ == AVERAGE_3D_GRADIENT && !init_average_3d_gradient_)
+    initAverage3DGradientMethod ();
+  else if (normal_estimation_method_ == AVERAGE_DEPTH_CHANGE && !init_depth_change_)
+    initAverageDepthChangeMethod ();
+  else if (normal_estimation_method_ == SIMPLE_3D_GRADIENT && !init_simple_3d_gradient_)
+    initSimple3DGradientMethod ();
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
 pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::initSimple3DGradientMethod ()
@@ -141,6 +175,8 @@ template <typename PointInT, typename PointOutT> void
 pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::initAverage3DGradientMethod ()
 {
   size_t data_size = (input_->points.size () << 2);
+  delete[] diff_x_;
+  delete[] diff_y_;
   diff_x_ = new float[data_size];
   diff_y_ = new float[data_size];
 
@@ -150,23 +186,20 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::initAverage3DGradientMe
   // x u x
   // l x r
   // x d x
-  const PointInT* point_up = &(input_->points [1]);
-  const PointInT* point_dn = point_up + (input_->width << 1);//&(input_->points [1 + (input_->width << 1)]);
-  const PointInT* point_lf = &(input_->points [input_->width]);
-  const PointInT* point_rg = point_lf + 2; //&(input_->points [input_->width + 2]);
-  float* diff_x_ptr = diff_x_ + ((input_->width + 1) << 2);
-  float* diff_y_ptr = diff_y_ + ((input_->width + 1) << 2);
-  unsigned diff_skip = 8; // skip last element in row and the first in the next row
-
-  for (size_t ri = 1; ri < input_->height - 1; ++ri
-                                             , point_up += input_->width
-                                             , point_dn += input_->width
-                                             , point_lf += input_->width
-                                             , point_rg += input_->width
-                                             , diff_x_ptr += diff_skip
-                                             , diff_y_ptr += diff_skip)
+  const int width = static_cast<int> (input_->width);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_)
+#endif
+  for (int ri = 1; ri < static_cast<int> (input_->height) - 1; ++ri)
   {
-    for (size_t ci = 0; ci < input_->width - 2; ++ci, diff_x_ptr += 4, diff_y_ptr += 4)
+    const PointInT* point_up = &(input_->points [(ri - 1) * width + 1]);
+    const PointInT* point_dn = point_up + (width << 1);
+    const PointInT* point_lf = &(input_->points [ri * width]);
+    const PointInT* point_rg = point_lf + 2;
+    float* diff_x_ptr = diff_x_ + ((ri * width + 1) << 2);
+    float* diff_y_ptr = diff_y_ + ((ri * width + 1) << 2);
+
+    for (int ci = 0; ci < width - 2; ++ci, diff_x_ptr += 4, diff_y_ptr += 4)
     {
       diff_x_ptr[0] = point_rg[ci].x - point_lf[ci].x;
       diff_x_ptr[1] = point_rg[ci].y - point_lf[ci].y;
@@ -207,35 +240,61 @@ template <typename PointInT, typename PointOutT> void
 pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormal (
     const int pos_x, const int pos_y, const unsigned point_index, PointOutT &normal)
 {
+  initCurrentMethod ();
+  computePointNormal (pos_x, pos_y, point_index, rect_width_, rect_height_, normal);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> bool
+pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointCovariance (
+    const int pos_x, const int pos_y, const int rect_width, const int rect_height, Eigen::Matrix3f &covariance_matrix) const
+{
+  const int rect_width_2 = rect_width / 2;
+  const int rect_height_2 = rect_height / 2;
+
+  unsigned count = integral_image_XYZ_.getFiniteElementsCount (pos_x - (rect_width_2), pos_y - (rect_height_2), rect_width, rect_height);
+
+  // no valid points within the rectangular region?
+  if (count == 0)
+    return (false);
+
+  Eigen::Vector3f center;
+  typename IntegralImage2D<float, 3>::SecondOrderType so_elements;
+  center = integral_image_XYZ_.getFirstOrderSum(pos_x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height).template cast<float> ();
+  so_elements = integral_image_XYZ_.getSecondOrderSum(pos_x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height);
+
+  covariance_matrix.coeffRef (0) = static_cast<float> (so_elements [0]);
+  covariance_matrix.coeffRef (1) = covariance_matrix.coeffRef (3) = static_cast<float> (so_elements [1]);
+  covariance_matrix.coeffRef (2) = covariance_matrix.coeffRef (6) = static_cast<float> (so_elements [2]);
+  covariance_matrix.coeffRef (4) = static_cast<float> (so_elements [3]);
+  covariance_matrix.coeffRef (5) = covariance_matrix.coeffRef (7) = static_cast<float> (so_elements [4]);
+  covariance_matrix.coeffRef (8) = static_cast<float> (so_elements [5]);
+  covariance_matrix -= (center * center.transpose ()) / static_cast<float> (count);
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormal (
+    const int pos_x, const int pos_y, const unsigned point_index,
+    const int rect_width, const int rect_height, PointOutT &normal) const
+{
+  const int rect_width_2 = rect_width / 2;
+  const int rect_width_4 = rect_width / 4;
+  const int rect_height_2 = rect_height / 2;
+  const int rect_height_4 = rect_height / 4;
+
   float bad_point = std::numeric_limits<float>::quiet_NaN ();
 
   if (normal_estimation_method_ == COVARIANCE_MATRIX)
   {
-    if (!init_covariance_matrix_)
-      initCovarianceMatrixMethod ();
-
-    unsigned count = integral_image_XYZ_.getFiniteElementsCount (pos_x - (rect_width_2_), pos_y - (rect_height_2_), rect_width_, rect_height_);
-
-    // no valid points within the rectangular region?
-    if (count == 0)
+    EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix;
+    if (!computePointCovariance (pos_x, pos_y, rect_width, rect_height, covariance_matrix))
     {
       normal.normal_x = normal.normal_y = normal.normal_z = normal.curvature = bad_point;
       return;
     }
 
-    EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix;
-    Eigen::Vector3f center;
-    typename IntegralImage2D<float, 3>::SecondOrderType so_elements;
-    center = integral_image_XYZ_.getFirstOrderSum(pos_x - rect_width_2_, pos_y - rect_height_2_, rect_width_, rect_height_).template cast<float> ();
-    so_elements = integral_image_XYZ_.getSecondOrderSum(pos_x - rect_width_2_, pos_y - rect_height_2_, rect_width_, rect_height_);
-
-    covariance_matrix.coeffRef (0) = static_cast<float> (so_elements [0]);
-    covariance_matrix.coeffRef (1) = covariance_matrix.coeffRef (3) = static_cast<float> (so_elements [1]);
-    covariance_matrix.coeffRef (2) = covariance_matrix.coeffRef (6) = static_cast<float> (so_elements [2]);
-    covariance_matrix.coeffRef (4) = static_cast<float> (so_elements [3]);
-    covariance_matrix.coeffRef (5) = covariance_matrix.coeffRef (7) = static_cast<float> (so_elements [4]);
-    covariance_matrix.coeffRef (8) = static_cast<float> (so_elements [5]);
-    covariance_matrix -= (center * center.transpose ()) / static_cast<float> (count);
     float eigen_value;
     Eigen::Vector3f eigen_vector;
     pcl::eigen33 (covariance_matrix, eigen_value, eigen_vector);
@@ -252,18 +311,15 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormal (
   }
   if (normal_estimation_method_ == AVERAGE_3D_GRADIENT)
   {
-    if (!init_average_3d_gradient_)
-      initAverage3DGradientMethod ();
-
-    unsigned count_x = integral_image_DX_.getFiniteElementsCount (pos_x - rect_width_2_, pos_y - rect_height_2_, rect_width_, rect_height_);
-    unsigned count_y = integral_image_DY_.getFiniteElementsCount (pos_x - rect_width_2_, pos_y - rect_height_2_, rect_width_, rect_height_);
+    unsigned count_x = integral_image_DX_.getFiniteElementsCount (pos_x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height);
+    unsigned count_y = integral_image_DY_.getFiniteElementsCount (pos_x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height);
     if (count_x == 0 || count_y == 0)
     {
       normal.normal_x = normal.normal_y = normal.normal_z = normal.curvature = bad_point;
       return;
     }
-    Eigen::Vector3d gradient_x = integral_image_DX_.getFirstOrderSum (pos_x - rect_width_2_, pos_y - rect_height_2_, rect_width_, rect_height_);
-    Eigen::Vector3d gradient_y = integral_image_DY_.getFirstOrderSum (pos_x - rect_width_2_, pos_y - rect_height_2_, rect_width_, rect_height_);
+    Eigen::Vector3d gradient_x = integral_image_DX_.getFirstOrderSum (pos_x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height);
+    Eigen::Vector3d gradient_y = integral_image_DY_.getFirstOrderSum (pos_x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height);
 
     Eigen::Vector3d normal_vector = gradient_y.cross (gradient_x);
     double normal_length = normal_vector.squaredNorm ();
@@ -290,14 +346,11 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormal (
   }
   if (normal_estimation_method_ == AVERAGE_DEPTH_CHANGE)
   {
-    if (!init_depth_change_)
-      initAverageDepthChangeMethod ();
-
     // width and height are at least 3 x 3
-    unsigned count_L_z = integral_image_depth_.getFiniteElementsCount (pos_x - rect_width_2_, pos_y - rect_height_4_, rect_width_2_, rect_height_2_);
-    unsigned count_R_z = integral_image_depth_.getFiniteElementsCount (pos_x + 1            , pos_y - rect_height_4_, rect_width_2_, rect_height_2_);
-    unsigned count_U_z = integral_image_depth_.getFiniteElementsCount (pos_x - rect_width_4_, pos_y - rect_height_2_, rect_width_2_, rect_height_2_);
-    unsigned count_D_z = integral_image_depth_.getFiniteElementsCount (pos_x - rect_width_4_, pos_y + 1             , rect_width_2_, rect_height_2_);
+    unsigned count_L_z = integral_image_depth_.getFiniteElementsCount (pos_x - rect_width_2, pos_y - rect_height_4, rect_width_2, rect_height_2);
+    unsigned count_R_z = integral_image_depth_.getFiniteElementsCount (pos_x + 1            , pos_y - rect_height_4, rect_width_2, rect_height_2);
+    unsigned count_U_z = integral_image_depth_.getFiniteElementsCount (pos_x - rect_width_4, pos_y - rect_height_2, rect_width_2, rect_height_2);
+    unsigned count_D_z = integral_image_depth_.getFiniteElementsCount (pos_x - rect_width_4, pos_y + 1             , rect_width_2, rect_height_2);
 
     if (count_L_z == 0 || count_R_z == 0 || count_U_z == 0 || count_D_z == 0)
     {
@@ -305,15 +358,15 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormal (
       return;
     }
 
-    float mean_L_z = static_cast<float> (integral_image_depth_.getFirstOrderSum (pos_x - rect_width_2_, pos_y - rect_height_4_, rect_width_2_, rect_height_2_) / count_L_z);
-    float mean_R_z = static_cast<float> (integral_image_depth_.getFirstOrderSum (pos_x + 1            , pos_y - rect_height_4_, rect_width_2_, rect_height_2_) / count_R_z);
-    float mean_U_z = static_cast<float> (integral_image_depth_.getFirstOrderSum (pos_x - rect_width_4_, pos_y - rect_height_2_, rect_width_2_, rect_height_2_) / count_U_z);
-    float mean_D_z = static_cast<float> (integral_image_depth_.getFirstOrderSum (pos_x - rect_width_4_, pos_y + 1             , rect_width_2_, rect_height_2_) / count_D_z);
+    float mean_L_z = static_cast<float> (integral_image_depth_.getFirstOrderSum (pos_x - rect_width_2, pos_y - rect_height_4, rect_width_2, rect_height_2) / count_L_z);
+    float mean_R_z = static_cast<float> (integral_image_depth_.getFirstOrderSum (pos_x + 1            , pos_y - rect_height_4, rect_width_2, rect_height_2) / count_R_z);
+    float mean_U_z = static_cast<float> (integral_image_depth_.getFirstOrderSum (pos_x - rect_width_4, pos_y - rect_height_2, rect_width_2, rect_height_2) / count_U_z);
+    float mean_D_z = static_cast<float> (integral_image_depth_.getFirstOrderSum (pos_x - rect_width_4, pos_y + 1             , rect_width_2, rect_height_2) / count_D_z);
 
-    PointInT pointL = input_->points[point_index - rect_width_4_ - 1];
-    PointInT pointR = input_->points[point_index + rect_width_4_ + 1];
-    PointInT pointU = input_->points[point_index - rect_height_4_ * input_->width - 1];
-    PointInT pointD = input_->points[point_index + rect_height_4_ * input_->width + 1];
+    PointInT pointL = input_->points[point_index - rect_width_4 - 1];
+    PointInT pointR = input_->points[point_index + rect_width_4 + 1];
+    PointInT pointU = input_->points[point_index - rect_height_4 * input_->width - 1];
+    PointInT pointD = input_->points[point_index + rect_height_4 * input_->width + 1];
 
     const float mean_x_z = mean_R_z - mean_L_z;
     const float mean_y_z = mean_D_z - mean_U_z;
@@ -349,15 +402,12 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormal (
   }
   if (normal_estimation_method_ == SIMPLE_3D_GRADIENT)
   {
-    if (!init_simple_3d_gradient_)
-      initSimple3DGradientMethod ();
-
     // this method does not work if lots of NaNs are in the neighborhood of the point
-    Eigen::Vector3d gradient_x = integral_image_XYZ_.getFirstOrderSum (pos_x + rect_width_2_, pos_y - rect_height_2_, 1, rect_height_) -
-                                 integral_image_XYZ_.getFirstOrderSum (pos_x - rect_width_2_, pos_y - rect_height_2_, 1, rect_height_);
+    Eigen::Vector3d gradient_x = integral_image_XYZ_.getFirstOrderSum (pos_x + rect_width_2, pos_y - rect_height_2, 1, rect_height) -
+                                 integral_image_XYZ_.getFirstOrderSum (pos_x - rect_width_2, pos_y - rect_height_2, 1, rect_height);
 
-    Eigen::Vector3d gradient_y = integral_image_XYZ_.getFirstOrderSum (pos_x - rect_width_2_, pos_y + rect_height_2_, rect_width_, 1) -
-                                 integral_image_XYZ_.getFirstOrderSum (pos_x - rect_width_2_, pos_y - rect_height_2_, rect_width_, 1);
+    Eigen::Vector3d gradient_y = integral_image_XYZ_.getFirstOrderSum (pos_x - rect_width_2, pos_y + rect_height_2, rect_width, 1) -
+                                 integral_image_XYZ_.getFirstOrderSum (pos_x - rect_width_2, pos_y - rect_height_2, rect_width, 1);
     Eigen::Vector3d normal_vector = gradient_y.cross (gradient_x);
     double normal_length = normal_vector.squaredNorm ();
     if (normal_length == 0.0f)
@@ -462,6 +512,67 @@ template <typename PointInT, typename PointOutT> void
 pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormalMirror (
     const int pos_x, const int pos_y, const unsigned point_index, PointOutT &normal)
 {
+  initCurrentMethod ();
+  computePointNormalMirror (pos_x, pos_y, point_index, rect_width_, rect_height_, normal);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> bool
+pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointCovarianceMirror (
+    const int pos_x, const int pos_y, const int rect_width, const int rect_height, Eigen::Matrix3f &covariance_matrix) const
+{
+  const int width = input_->width;
+  const int height = input_->height;
+
+  const int start_x = pos_x - rect_width / 2;
+  const int start_y = pos_y - rect_height / 2;
+  const int end_x = start_x + rect_width;
+  const int end_y = start_y + rect_height;
+
+  unsigned count = 0;
+  auto cb_xyz_fecse = [this] (unsigned p1, unsigned p2, unsigned p3, unsigned p4) { return integral_image_XYZ_.getFiniteElementsCountSE (p1, p2, p3, p4); };
+  sumArea<unsigned> (start_x, start_y, end_x, end_y, width, height, cb_xyz_fecse, count);
+
+  // no valid points within the rectangular region?
+  if (count == 0)
+    return (false);
+
+  Eigen::Vector3f center;
+  typename IntegralImage2D<float, 3>::ElementType tmp_center;
+  typename IntegralImage2D<float, 3>::SecondOrderType so_elements;
+  tmp_center.setZero ();
+  so_elements.setZero ();
+
+  auto cb_xyz_fosse = [this] (unsigned p1, unsigned p2, unsigned p3, unsigned p4) { return integral_image_XYZ_.getFirstOrderSumSE (p1, p2, p3, p4); };
+  sumArea<typename IntegralImage2D<float, 3>::ElementType>(start_x, start_y, end_x, end_y, width, height, cb_xyz_fosse, tmp_center);
+  auto cb_xyz_sosse = [this] (unsigned p1, unsigned p2, unsigned p3, unsigned p4) { return integral_image_XYZ_.getSecondOrderSumSE (p1, p2, p3, p4); };
+  sumArea<typename IntegralImage2D<float, 3>::SecondOrderType>(start_x, start_y, end_x, end_y, width, height, cb_xyz_sosse, so_elements);
+
+  center[0] = float (tmp_center[0]);
+  center[1] = float (tmp_center[1]);
+  center[2] = float (tmp_center[2]);
+
+  covariance_matrix.coeffRef (0) = static_cast<float> (so_elements [0]);
+  covariance_matrix.coeffRef (1) = covariance_matrix.coeffRef (3) = static_cast<float> (so_elements [1]);
+  covariance_matrix.coeffRef (2) = covariance_matrix.coeffRef (6) = static_cast<float> (so_elements [2]);
+  covariance_matrix.coeffRef (4) = static_cast<float> (so_elements [3]);
+  covariance_matrix.coeffRef (5) = covariance_matrix.coeffRef (7) = static_cast<float> (so_elements [4]);
+  covariance_matrix.coeffRef (8) = static_cast<float> (so_elements [5]);
+  covariance_matrix -= (center * center.transpose ()) / static_cast<float> (count);
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormalMirror (
+    const int pos_x, const int pos_y, const unsigned point_index,
+    const int rect_width, const int rect_height, PointOutT &normal) const
+{
+  const int rect_width_2 = rect_width / 2;
+  const int rect_width_4 = rect_width / 4;
+  const int rect_height_2 = rect_height / 2;
+  const int rect_height_4 = rect_height / 4;
+
   float bad_point = std::numeric_limits<float>::quiet_NaN ();
 
   const int width = input_->width;
@@ -470,60 +581,13 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormalMirro
   // ==============================================================
   if (normal_estimation_method_ == COVARIANCE_MATRIX) 
   {
-    if (!init_covariance_matrix_)
-      initCovarianceMatrixMethod ();
-
-    const int start_x = pos_x - rect_width_2_;
-    const int start_y = pos_y - rect_height_2_;
-    const int end_x = start_x + rect_width_;
-    const int end_y = start_y + rect_height_;
-
-    unsigned count = 0;
-    auto cb_xyz_fecse = [this] (unsigned p1, unsigned p2, unsigned p3, unsigned p4) { return integral_image_XYZ_.getFiniteElementsCountSE (p1, p2, p3, p4); };
-    sumArea<unsigned> (start_x, start_y, end_x, end_y, width, height, cb_xyz_fecse, count);
-
-    // no valid points within the rectangular region?
-    if (count == 0)
+    EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix;
+    if (!computePointCovarianceMirror (pos_x, pos_y, rect_width, rect_height, covariance_matrix))
     {
       normal.normal_x = normal.normal_y = normal.normal_z = normal.curvature = bad_point;
       return;
     }
 
-    EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix;
-    Eigen::Vector3f center;
-    typename IntegralImage2D<float, 3>::SecondOrderType so_elements;
-    typename IntegralImage2D<float, 3>::ElementType tmp_center;
-    typename IntegralImage2D<float, 3>::SecondOrderType tmp_so_elements;
-
-    center[0] = 0;
-    center[1] = 0;
-    center[2] = 0;
-    tmp_center[0] = 0;
-    tmp_center[1] = 0;
-    tmp_center[2] = 0;
-    so_elements[0] = 0;
-    so_elements[1] = 0;
-    so_elements[2] = 0;
-    so_elements[3] = 0;
-    so_elements[4] = 0;
-    so_elements[5] = 0;
-
-    auto cb_xyz_fosse = [this] (unsigned p1, unsigned p2, unsigned p3, unsigned p4) { return integral_image_XYZ_.getFirstOrderSumSE (p1, p2, p3, p4); };
-    sumArea<typename IntegralImage2D<float, 3>::ElementType>(start_x, start_y, end_x, end_y, width, height, cb_xyz_fosse, tmp_center);
-    auto cb_xyz_sosse = [this] (unsigned p1, unsigned p2, unsigned p3, unsigned p4) { return integral_image_XYZ_.getSecondOrderSumSE (p1, p2, p3, p4); };
-    sumArea<typename IntegralImage2D<float, 3>::SecondOrderType>(start_x, start_y, end_x, end_y, width, height, cb_xyz_sosse, so_elements);
-
-    center[0] = float (tmp_center[0]);
-    center[1] = float (tmp_center[1]);
-    center[2] = float (tmp_center[2]);
-
-    covariance_matrix.coeffRef (0) = static_cast<float> (so_elements [0]);
-    covariance_matrix.coeffRef (1) = covariance_matrix.coeffRef (3) = static_cast<float> (so_elements [1]);
-    covariance_matrix.coeffRef (2) = covariance_matrix.coeffRef (6) = static_cast<float> (so_elements [2]);
-    covariance_matrix.coeffRef (4) = static_cast<float> (so_elements [3]);
-    covariance_matrix.coeffRef (5) = covariance_matrix.coeffRef (7) = static_cast<float> (so_elements [4]);
-    covariance_matrix.coeffRef (8) = static_cast<float> (so_elements [5]);
-    covariance_matrix -= (center * center.transpose ()) / static_cast<float> (count);
     float eigen_value;
     Eigen::Vector3f eigen_vector;
     pcl::eigen33 (covariance_matrix, eigen_value, eigen_vector);
@@ -541,13 +605,10 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormalMirro
   // =======================================================
   if (normal_estimation_method_ == AVERAGE_3D_GRADIENT) 
   {
-    if (!init_average_3d_gradient_)
-      initAverage3DGradientMethod ();
-
-    const int start_x = pos_x - rect_width_2_;
-    const int start_y = pos_y - rect_height_2_;
-    const int end_x = start_x + rect_width_;
-    const int end_y = start_y + rect_height_;
+    const int start_x = pos_x - rect_width_2;
+    const int start_y = pos_y - rect_height_2;
+    const int end_x = start_x + rect_width;
+    const int end_y = start_y + rect_height;
 
     unsigned count_x = 0;
     unsigned count_y = 0;
@@ -598,17 +659,14 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormalMirro
   // ======================================================
   if (normal_estimation_method_ == AVERAGE_DEPTH_CHANGE) 
   {
-    if (!init_depth_change_)
-      initAverageDepthChangeMethod ();
-
-    int point_index_L_x = pos_x - rect_width_4_ - 1;
+    int point_index_L_x = pos_x - rect_width_4 - 1;
     int point_index_L_y = pos_y;
-    int point_index_R_x = pos_x + rect_width_4_ + 1;
+    int point_index_R_x = pos_x + rect_width_4 + 1;
     int point_index_R_y = pos_y;
     int point_index_U_x = pos_x - 1;
-    int point_index_U_y = pos_y - rect_height_4_;
+    int point_index_U_y = pos_y - rect_height_4;
     int point_index_D_x = pos_x + 1;
-    int point_index_D_y = pos_y + rect_height_4_;
+    int point_index_D_y = pos_y + rect_height_4;
 
     if (point_index_L_x < 0)
       point_index_L_x = -point_index_L_x;
@@ -624,25 +682,25 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormalMirro
     if (point_index_D_y >= height)
       point_index_D_y = height-(point_index_D_y-(height-1));
 
-    const int start_x_L = pos_x - rect_width_2_;
-    const int start_y_L = pos_y - rect_height_4_;
-    const int end_x_L = start_x_L + rect_width_2_;
-    const int end_y_L = start_y_L + rect_height_2_;
+    const int start_x_L = pos_x - rect_width_2;
+    const int start_y_L = pos_y - rect_height_4;
+    const int end_x_L = start_x_L + rect_width_2;
+    const int end_y_L = start_y_L + rect_height_2;
 
     const int start_x_R = pos_x + 1;
-    const int start_y_R = pos_y - rect_height_4_;
-    const int end_x_R = start_x_R + rect_width_2_;
-    const int end_y_R = start_y_R + rect_height_2_;
+    const int start_y_R = pos_y - rect_height_4;
+    const int end_x_R = start_x_R + rect_width_2;
+    const int end_y_R = start_y_R + rect_height_2;
 
-    const int start_x_U = pos_x - rect_width_4_;
-    const int start_y_U = pos_y - rect_height_2_;
-    const int end_x_U = start_x_U + rect_width_2_;
-    const int end_y_U = start_y_U + rect_height_2_;
+    const int start_x_U = pos_x - rect_width_4;
+    const int start_y_U = pos_y - rect_height_2;
+    const int end_x_U = start_x_U + rect_width_2;
+    const int end_y_U = start_y_U + rect_height_2;
 
-    const int start_x_D = pos_x - rect_width_4_;
+    const int start_x_D = pos_x - rect_width_4;
     const int start_y_D = pos_y + 1;
-    const int end_x_D = start_x_D + rect_width_2_;
-    const int end_y_D = start_y_D + rect_height_2_;
+    const int end_x_D = start_x_D + rect_width_2;
+    const int end_y_D = start_y_D + rect_height_2;
 
     unsigned count_L_z = 0;
     unsigned count_R_z = 0;
@@ -735,6 +793,11 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeature (PointCl
   
   float bad_point = std::numeric_limits<float>::quiet_NaN ();
 
+  // The normals are computed in parallel, so all lazy initialization happens here
+  if (border_policy_ == BORDER_POLICY_MIRROR && normal_estimation_method_ == SIMPLE_3D_GRADIENT)
+    PCL_THROW_EXCEPTION (PCLException, "BORDER_POLICY_MIRROR not supported for normal estimation method SIMPLE_3D_GRADIENT");
+  initCurrentMethod ();
+
   // compute depth-change map
   unsigned char * depthChangeMap = new unsigned char[input_->points.size ()];
   memset (depthChangeMap, 255, input_->points.size ());
@@ -835,187 +898,133 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeature (PointCl
 
 //////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
-pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeatureFull (const float *distanceMap,
+pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeNormalBlock (const int *indices, const int nr_points,
+                                                                             const float *distance_map,
                                                                              const float &bad_point,
-                                                                             PointCloudOut &output)
+                                                                             PointOutT *normals,
+                                                                             std::vector<float> &covariances,
+                                                                             std::vector<int> &batch_slots) const
 {
-  unsigned index = 0;
-
-  if (border_policy_ == BORDER_POLICY_IGNORE)
+  const int width = static_cast<int> (input_->width);
+  const int height = static_cast<int> (input_->height);
+  const bool mirror = (border_policy_ == BORDER_POLICY_MIRROR);
+  // With BORDER_POLICY_IGNORE, no normals are estimated closer than the smoothing size to the image border
+  const int border = mirror ? 0 : static_cast<int> (normal_smoothing_size_);
+
+  // The covariance matrices of the block are stored as arrays of their upper triangle entries, followed by the
+  // eigen solutions, and solved in a single batch
+  const bool batch_covariance = (normal_estimation_method_ == COVARIANCE_MATRIX);
+  if (batch_covariance)
   {
-    // Set all normals that we do not touch to NaN
-    // top and bottom borders
-    // That sets the output density to false!
-    output.is_dense = false;
-    unsigned border = int(normal_smoothing_size_);
-    PointOutT* vec1 = &output [0];
-    PointOutT* vec2 = vec1 + input_->width * (input_->height - border);
-
-    size_t count = border * input_->width;
-    for (size_t idx = 0; idx < count; ++idx)
+    covariances.resize (10 * static_cast<std::size_t> (nr_points));
+    batch_slots.resize (nr_points);
+  }
+  float *c00 = covariances.data ();
+  float *c01 = c00 + nr_points, *c02 = c01 + nr_points, *c11 = c02 + nr_points;
+  float *c12 = c11 + nr_points, *c22 = c12 + nr_points;
+  float *eigen_value = c22 + nr_points;
+  float *eigen_vector_x = eigen_value + nr_points, *eigen_vector_y = eigen_vector_x + nr_points, *eigen_vector_z = eigen_vector_y + nr_points;
+  int batch_size = 0;
+
+  for (int idx = 0; idx < nr_points; ++idx)
+  {
+    const int index = indices[idx];
+    const int u = index % width;
+    const int v = index / width;
+    PointOutT &normal = normals[idx];
+
+    const float depth = input_->points[index].z;
+    float smoothing = 0.0f;
+    if (v >= border && v < height - border && u >= border && u < width - border && std::isfinite (depth))
     {
-      vec1 [idx].getNormalVector3fMap ().setConstant (bad_point);
-      vec1 [idx].curvature = bad_point;
-      vec2 [idx].getNormalVector3fMap ().setConstant (bad_point);
-      vec2 [idx].curvature = bad_point;
+      if (use_depth_dependent_smoothing_)
+        smoothing = (std::min)(distance_map[index], normal_smoothing_size_ + static_cast<float>(depth)/10.0f);
+      else
+        smoothing = (std::min)(distance_map[index], normal_smoothing_size_);
     }
 
-    // left and right borders actually columns
-    vec1 = &output [border * input_->width];
-    vec2 = vec1 + input_->width - border;
-    for (size_t ri = border; ri < input_->height - border; ++ri, vec1 += input_->width, vec2 += input_->width)
+    if (smoothing <= 2.0f)
     {
-      for (size_t ci = 0; ci < border; ++ci)
-      {
-        vec1 [ci].getNormalVector3fMap ().setConstant (bad_point);
-        vec1 [ci].curvature = bad_point;
-        vec2 [ci].getNormalVector3fMap ().setConstant (bad_point);
-        vec2 [ci].curvature = bad_point;
-      }
+      normal.getNormalVector3fMap ().setConstant (bad_point);
+      normal.curvature = bad_point;
+      continue;
     }
 
-    if (use_depth_dependent_smoothing_)
+    const int rect_size = static_cast<int> (smoothing);
+    if (!batch_covariance)
     {
-      index = border + input_->width * border;
-      unsigned skip = (border << 1);
-      for (unsigned ri = border; ri < input_->height - border; ++ri, index += skip)
-      {
-        for (unsigned ci = border; ci < input_->width - border; ++ci, ++index)
-        {
-          index = ri * input_->width + ci;
-
-          const float depth = input_->points[index].z;
-          if (!std::isfinite (depth))
-          {
-            output[index].getNormalVector3fMap ().setConstant (bad_point);
-            output[index].curvature = bad_point;
-            continue;
-          }
-
-          float smoothing = (std::min)(distanceMap[index], normal_smoothing_size_ + static_cast<float>(depth)/10.0f);
-
-          if (smoothing > 2.0f)
-          {
-            setRectSize (static_cast<int> (smoothing), static_cast<int> (smoothing));
-            computePointNormal (ci, ri, index, output [index]);
-          }
-          else
-          {
-            output[index].getNormalVector3fMap ().setConstant (bad_point);
-            output[index].curvature = bad_point;
-          }
-        }
-      }
+      if (mirror)
+        computePointNormalMirror (u, v, index, rect_size, rect_size, normal);
+      else
+        computePointNormal (u, v, index, rect_size, rect_size, normal);
+      continue;
     }
-    else
-    {
-      float smoothing_constant = normal_smoothing_size_;
 
-      index = border + input_->width * border;
-      unsigned skip = (border << 1);
-      for (unsigned ri = border; ri < input_->height - border; ++ri, index += skip)
-      {
-        for (unsigned ci = border; ci < input_->width - border; ++ci, ++index)
-        {
-          index = ri * input_->width + ci;
-
-          if (!std::isfinite (input_->points[index].z))
-          {
-            output [index].getNormalVector3fMap ().setConstant (bad_point);
-            output [index].curvature = bad_point;
-            continue;
-          }
-
-          float smoothing = (std::min)(distanceMap[index], smoothing_constant);
-
-          if (smoothing > 2.0f)
-          {
-            setRectSize (static_cast<int> (smoothing), static_cast<int> (smoothing));
-            computePointNormal (ci, ri, index, output [index]);
-          }
-          else
-          {
-            output [index].getNormalVector3fMap ().setConstant (bad_point);
-            output [index].curvature = bad_point;
-          }
-        }
-      }
+    EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix;
+    if (mirror ? !computePointCovarianceMirror (u, v, rect_size, rect_size, covariance_matrix)
+               : !computePointCovariance (u, v, rect_size, rect_size, covariance_matrix))
+    {
+      normal.normal_x = normal.normal_y = normal.normal_z = normal.curvature = bad_point;
+      continue;
     }
+    c00[batch_size] = covariance_matrix.coeff (0);
+    c01[batch_size] = covariance_matrix.coeff (1);
+    c02[batch_size] = covariance_matrix.coeff (2);
+    c11[batch_size] = covariance_matrix.coeff (4);
+    c12[batch_size] = covariance_matrix.coeff (5);
+    c22[batch_size] = covariance_matrix.coeff (8);
+    batch_slots[batch_size] = idx;
+    ++batch_size;
   }
-  else if (border_policy_ == BORDER_POLICY_MIRROR)
+
+  if (batch_size == 0)
+    return;
+
+  pcl::eigen33Batch (batch_size, c00, c01, c02, c11, c12, c22, eigen_value, eigen_vector_x, eigen_vector_y, eigen_vector_z);
+  for (int i = 0; i < batch_size; ++i)
   {
-    output.is_dense = false;
+    const int idx = batch_slots[i];
+    PointOutT &normal = normals[idx];
+    float nx = eigen_vector_x[i], ny = eigen_vector_y[i], nz = eigen_vector_z[i];
+    flipNormalTowardsViewpoint (input_->points[indices[idx]], vpx_, vpy_, vpz_, nx, ny, nz);
+    normal.normal_x = nx;
+    normal.normal_y = ny;
+    normal.normal_z = nz;
 
-    if (use_depth_dependent_smoothing_)
-    {
-      //index = 0;
-      //unsigned skip = 0;
-      //for (unsigned ri = 0; ri < input_->height; ++ri, index += skip)
-      for (unsigned ri = 0; ri < input_->height; ++ri)
-      {
-        //for (unsigned ci = 0; ci < input_->width; ++ci, ++index)
-        for (unsigned ci = 0; ci < input_->width; ++ci)
-        {
-          index = ri * input_->width + ci;
-
-          const float depth = input_->points[index].z;
-          if (!std::isfinite (depth))
-          {
-            output[index].getNormalVector3fMap ().setConstant (bad_point);
-            output[index].curvature = bad_point;
-            continue;
-          }
-
-          float smoothing = (std::min)(distanceMap[index], normal_smoothing_size_ + static_cast<float>(depth)/10.0f);
-
-          if (smoothing > 2.0f)
-          {
-            setRectSize (static_cast<int> (smoothing), static_cast<int> (smoothing));
-            computePointNormalMirror (ci, ri, index, output [index]);
-          }
-          else
-          {
-            output[index].getNormalVector3fMap ().setConstant (bad_point);
-            output[index].curvature = bad_point;
-          }
-        }
-      }
-    }
+    // Compute the curvature surface change
+    if (eigen_value[i] > 0.0)
+      normal.curvature = std::abs (eigen_value[i] / (c00[i] + c11[i] + c22[i]));
     else
-    {
-      float smoothing_constant = normal_smoothing_size_;
+      normal.curvature = 0;
+  }
+}
 
-      //index = border + input_->width * border;
-      //unsigned skip = (border << 1);
-      //for (unsigned ri = border; ri < input_->height - border; ++ri, index += skip)
-      for (unsigned ri = 0; ri < input_->height; ++ri)
-      {
-        //for (unsigned ci = border; ci < input_->width - border; ++ci, ++index)
-        for (unsigned ci = 0; ci < input_->width; ++ci)
-        {
-          index = ri * input_->width + ci;
-
-          if (!std::isfinite (input_->points[index].z))
-          {
-            output [index].getNormalVector3fMap ().setConstant (bad_point);
-            output [index].curvature = bad_point;
-            continue;
-          }
-
-          float smoothing = (std::min)(distanceMap[index], smoothing_constant);
-
-          if (smoothing > 2.0f)
-          {
-            setRectSize (static_cast<int> (smoothing), static_cast<int> (smoothing));
-            computePointNormalMirror (ci, ri, index, output [index]);
-          }
-          else
-          {
-            output [index].getNormalVector3fMap ().setConstant (bad_point);
-            output [index].curvature = bad_point;
-          }
-        }
-      }
+//////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeatureFull (const float *distanceMap,
+                                                                             const float &bad_point,
+                                                                             PointCloudOut &output)
+{
+  output.is_dense = false;
+  const int width = static_cast<int> (input_->width);
+
+#ifdef _OPENMP
+#pragma omp parallel shared (output) num_threads(threads_)
+#endif
+  {
+    std::vector<int> row_indices (width);
+    std::vector<float> covariances;
+    std::vector<int> batch_slots;
+
+    // Rows are processed independently
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (int ri = 0; ri < static_cast<int> (input_->height); ++ri)
+    {
+      for (int ci = 0; ci < width; ++ci)
+        row_indices[ci] = ri * width + ci;
+      computeNormalBlock (row_indices.data (), width, distanceMap, bad_point, &output[ri * width], covariances, batch_slots);
     }
   }
 }
@@ -1026,165 +1035,27 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeaturePart (con
                                                                              const float &bad_point,
                                                                              PointCloudOut &output)
 {
-  if (border_policy_ == BORDER_POLICY_IGNORE)
-  {
-    output.is_dense = false;
-    unsigned border = int(normal_smoothing_size_);
-    unsigned bottom = input_->height > border ? input_->height - border : 0;
-    unsigned right = input_->width > border ? input_->width - border : 0;
-    if (use_depth_dependent_smoothing_)
-    {
-      // Iterating over the entire index vector
-      for (std::size_t idx = 0; idx < indices_->size (); ++idx)
-      {
-        unsigned pt_index = (*indices_)[idx];
-        unsigned u = pt_index % input_->width;
-        unsigned v = pt_index / input_->width;
-        if (v < border || v > bottom)
-        {
-          output.points[idx].getNormalVector3fMap ().setConstant (bad_point);
-          output.points[idx].curvature = bad_point;
-          continue;
-        }
-
-        if (u < border || v > right)
-        {
-          output.points[idx].getNormalVector3fMap ().setConstant (bad_point);
-          output.points[idx].curvature = bad_point;
-          continue;
-        }
-
-        const float depth = input_->points[pt_index].z;
-        if (!std::isfinite (depth))
-        {
-          output.points[idx].getNormalVector3fMap ().setConstant (bad_point);
-          output.points[idx].curvature = bad_point;
-          continue;
-        }
-
-        float smoothing = (std::min)(distanceMap[pt_index], normal_smoothing_size_ + static_cast<float>(depth)/10.0f);
-        if (smoothing > 2.0f)
-        {
-          setRectSize (static_cast<int> (smoothing), static_cast<int> (smoothing));
-          computePointNormal (u, v, pt_index, output [idx]);
-        }
-        else
-        {
-          output[idx].getNormalVector3fMap ().setConstant (bad_point);
-          output[idx].curvature = bad_point;
-        }
-      }
-    }
-    else
-    {
-      float smoothing_constant = normal_smoothing_size_;
-      // Iterating over the entire index vector
-      for (std::size_t idx = 0; idx < indices_->size (); ++idx)
-      {
-        unsigned pt_index = (*indices_)[idx];
-        unsigned u = pt_index % input_->width;
-        unsigned v = pt_index / input_->width;
-        if (v < border || v > bottom)
-        {
-          output.points[idx].getNormalVector3fMap ().setConstant (bad_point);
-          output.points[idx].curvature = bad_point;
-          continue;
-        }
-
-        if (u < border || v > right)
-        {
-          output.points[idx].getNormalVector3fMap ().setConstant (bad_point);
-          output.points[idx].curvature = bad_point;
-          continue;
-        }
-
-        if (!std::isfinite (input_->points[pt_index].z))
-        {
-          output [idx].getNormalVector3fMap ().setConstant (bad_point);
-          output [idx].curvature = bad_point;
-          continue;
-        }
-
-        float smoothing = (std::min)(distanceMap[pt_index], smoothing_constant);
-
-        if (smoothing > 2.0f)
-        {
-          setRectSize (static_cast<int> (smoothing), static_cast<int> (smoothing));
-          computePointNormal (u, v, pt_index, output [idx]);
-        }
-        else
-        {
-          output [pt_index].getNormalVector3fMap ().setConstant (bad_point);
-          output [pt_index].curvature = bad_point;
-        }
-      }
-    }
-  }// border_policy_ == BORDER_POLICY_IGNORE
-  else if (border_policy_ == BORDER_POLICY_MIRROR)
+  output.is_dense = false;
+  const int block_size = 256;
+  const int nr_blocks = (static_cast<int> (indices_->size ()) + block_size - 1) / block_size;
+
+#ifdef _OPENMP
+#pragma omp parallel shared (output) num_threads(threads_)
+#endif
   {
-    output.is_dense = false;
+    std::vector<float> covariances;
+    std::vector<int> batch_slots;
 
-    if (use_depth_dependent_smoothing_)
-    {
-      for (std::size_t idx = 0; idx < indices_->size (); ++idx)
-      {
-        unsigned pt_index = (*indices_)[idx];
-        unsigned u = pt_index % input_->width;
-        unsigned v = pt_index / input_->width;
-
-        const float depth = input_->points[pt_index].z;
-        if (!std::isfinite (depth))
-        {
-          output[idx].getNormalVector3fMap ().setConstant (bad_point);
-          output[idx].curvature = bad_point;
-          continue;
-        }
-
-        float smoothing = (std::min)(distanceMap[pt_index], normal_smoothing_size_ + static_cast<float>(depth)/10.0f);
-
-        if (smoothing > 2.0f)
-        {
-          setRectSize (static_cast<int> (smoothing), static_cast<int> (smoothing));
-          computePointNormalMirror (u, v, pt_index, output [idx]);
-        }
-        else
-        {
-          output[idx].getNormalVector3fMap ().setConstant (bad_point);
-          output[idx].curvature = bad_point;
-        }
-      }
-    }
-    else
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (int block = 0; block < nr_blocks; ++block)
     {
-      float smoothing_constant = normal_smoothing_size_;
-      for (size_t idx = 0; idx < indices_->size (); ++idx)
-      {
-        unsigned pt_index = (*indices_)[idx];
-        unsigned u = pt_index % input_->width;
-        unsigned v = pt_index / input_->width;
-
-        if (!std::isfinite (input_->points[pt_index].z))
-        {
-          output [idx].getNormalVector3fMap ().setConstant (bad_point);
-          output [idx].curvature = bad_point;
-          continue;
-        }
-
-        float smoothing = (std::min)(distanceMap[pt_index], smoothing_constant);
-
-        if (smoothing > 2.0f)
-        {
-          setRectSize (static_cast<int> (smoothing), static_cast<int> (smoothing));
-          computePointNormalMirror (u, v, pt_index, output [idx]);
-        }
-        else
-        {
-          output [idx].getNormalVector3fMap ().setConstant (bad_point);
-          output [idx].curvature = bad_point;
-        }
-      }
+      const int begin = block * block_size;
+      const int nr_points = std::min (block_size, static_cast<int> (indices_->size ()) - begin);
+      computeNormalBlock (&(*indices_)[begin], nr_points, distanceMap, bad_point, &output[begin], covariances, batch_slots);
     }
-  } // border_policy_ == BORDER_POLICY_MIRROR
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
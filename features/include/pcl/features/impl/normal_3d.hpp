@@ -44,54 +44,84 @@
 #include <pcl/features/normal_3d.h>
 
 ///////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointInT, typename PointOutT> void
-pcl::NormalEstimation<PointInT, PointOutT>::computeFeature (PointCloudOut &output)
+template <typename PointInT, typename PointOutT> bool
+pcl::NormalEstimation<PointInT, PointOutT>::computeFeatureBlock (std::size_t begin, std::size_t end,
+                                                                 bool check_finite, PointCloudOut &output)
 {
   // Allocate enough space to hold the results
   // \note This resize is irrelevant for a radiusSearch ().
   std::vector<int> nn_indices (k_);
   std::vector<float> nn_dists (k_);
 
-  output.is_dense = true;
-  // Save a few cycles by not checking every point for NaN/Inf values if the cloud is set to dense
-  if (input_->is_dense)
-  {
-    // Iterating over the entire index vector
-    for (size_t idx = 0; idx < indices_->size (); ++idx)
-    {
-      if (this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0 ||
-          !computePointNormal (*surface_, nn_indices, output.points[idx].normal[0], output.points[idx].normal[1], output.points[idx].normal[2], output.points[idx].curvature))
-      {
-        output.points[idx].normal[0] = output.points[idx].normal[1] = output.points[idx].normal[2] = output.points[idx].curvature = std::numeric_limits<float>::quiet_NaN ();
+  // The upper triangles of the covariance matrices of the block, one array per entry
+  float c00[batch_size_], c01[batch_size_], c02[batch_size_], c11[batch_size_], c12[batch_size_], c22[batch_size_];
+  float eigenvalues[batch_size_], nx[batch_size_], ny[batch_size_], nz[batch_size_];
+  bool valid[batch_size_];
 
-        output.is_dense = false;
-        continue;
-      }
+  EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix;
+  Eigen::Vector4f xyz_centroid;
+  const std::size_t nr_points = end - begin;
+  for (std::size_t i = 0; i < nr_points; ++i)
+  {
+    const int index = (*indices_)[begin + i];
+    valid[i] = (!check_finite || isFinite ((*input_)[index])) &&
+               this->searchForNeighbors (index, search_parameter_, nn_indices, nn_dists) != 0 &&
+               nn_indices.size () >= 3 &&
+               computeMeanAndCovarianceMatrix (*surface_, nn_indices, covariance_matrix, xyz_centroid) != 0;
+    if (!valid[i])
+      covariance_matrix.setIdentity ();
+    c00[i] = covariance_matrix.coeff (0, 0);
+    c01[i] = covariance_matrix.coeff (0, 1);
+    c02[i] = covariance_matrix.coeff (0, 2);
+    c11[i] = covariance_matrix.coeff (1, 1);
+    c12[i] = covariance_matrix.coeff (1, 2);
+    c22[i] = covariance_matrix.coeff (2, 2);
+  }
 
-      flipNormalTowardsViewpoint (input_->points[(*indices_)[idx]], vpx_, vpy_, vpz_,
-                                  output.points[idx].normal[0], output.points[idx].normal[1], output.points[idx].normal[2]);
+  pcl::eigen33Batch (nr_points, c00, c01, c02, c11, c12, c22, eigenvalues, nx, ny, nz);
 
-    }
-  }
-  else
+  bool all_valid = true;
+  for (std::size_t i = 0; i < nr_points; ++i)
   {
-    // Iterating over the entire index vector
-    for (size_t idx = 0; idx < indices_->size (); ++idx)
+    PointOutT &point = output.points[begin + i];
+    if (!valid[i])
     {
-      if (!isFinite ((*input_)[(*indices_)[idx]]) ||
-          this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0 ||
-          !computePointNormal (*surface_, nn_indices, output.points[idx].normal[0], output.points[idx].normal[1], output.points[idx].normal[2], output.points[idx].curvature))
-      {
-        output.points[idx].normal[0] = output.points[idx].normal[1] = output.points[idx].normal[2] = output.points[idx].curvature = std::numeric_limits<float>::quiet_NaN ();
+      point.normal[0] = point.normal[1] = point.normal[2] = point.curvature = std::numeric_limits<float>::quiet_NaN ();
+      all_valid = false;
+      continue;
+    }
 
-        output.is_dense = false;
-        continue;
-      }
+    point.normal[0] = nx[i];
+    point.normal[1] = ny[i];
+    point.normal[2] = nz[i];
 
-      flipNormalTowardsViewpoint (input_->points[(*indices_)[idx]], vpx_, vpy_, vpz_,
-                                  output.points[idx].normal[0], output.points[idx].normal[1], output.points[idx].normal[2]);
+    // Compute the curvature surface change, as in solvePlaneParameters
+    const float eig_sum = c00[i] + c11[i] + c22[i];
+    if (eig_sum != 0)
+      point.curvature = std::abs (eigenvalues[i] / eig_sum);
+    else
+      point.curvature = 0;
 
-    }
+    flipNormalTowardsViewpoint (input_->points[(*indices_)[begin + i]], vpx_, vpy_, vpz_,
+                                point.normal[0], point.normal[1], point.normal[2]);
+  }
+  return (all_valid);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::NormalEstimation<PointInT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  output.is_dense = true;
+  // Save a few cycles by not checking every point for NaN/Inf values if the cloud is set to dense
+  const bool check_finite = !input_->is_dense;
+
+  // Iterating over the entire index vector, one block of eigen problems at a time
+  for (std::size_t begin = 0; begin < indices_->size (); begin += batch_size_)
+  {
+    const std::size_t end = begin + batch_size_ < indices_->size () ? begin + batch_size_ : indices_->size ();
+    if (!computeFeatureBlock (begin, end, check_finite, output))
+      output.is_dense = false;
   }
 }
 
@@ -0,0 +1,107 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2019-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PCL_FEATURES_IMPL_PFH_OMP_H_
+#define PCL_FEATURES_IMPL_PFH_OMP_H_
+
+#include <pcl/features/pfh_omp.h>
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHEstimationOMP<PointInT, PointNT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  const int nr_bins = nr_subdiv_ * nr_subdiv_ * nr_subdiv_;
+  // Every thread memoizes into its own share of the cache budget
+  const size_t thread_cache_size = use_cache_ ? std::max<size_t> (max_cache_size_ / threads_, 1) : 0;
+  bool is_dense = true;
+
+#ifdef _OPENMP
+#pragma omp parallel shared (output) num_threads(threads_)
+#endif
+  {
+    PairFeatureCache cache (thread_cache_size);
+    Eigen::VectorXf pfh_histogram (nr_bins);
+
+    // Allocate enough space to hold the results
+    // \note This resize is irrelevant for a radiusSearch ().
+    std::vector<int> nn_indices (k_);
+    std::vector<float> nn_dists (k_);
+
+    // Contiguous chunks of query points, so that each thread sees overlapping neighborhoods
+#ifdef _OPENMP
+#pragma omp for schedule(static) reduction(&&: is_dense)
+#endif
+    for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
+    {
+      if (!isFinite ((*input_)[(*indices_)[idx]]) ||
+          this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
+      {
+        for (int d = 0; d < nr_bins; ++d)
+          output.points[idx].histogram[d] = std::numeric_limits<float>::quiet_NaN ();
+
+        is_dense = false;
+        continue;
+      }
+
+      // Estimate the PFH signature at each patch
+      this->computePointPFHSignature (*surface_, *normals_, nn_indices, nr_subdiv_,
+                                      use_cache_ ? &cache : nullptr, pfh_histogram);
+
+      // Copy into the resultant cloud
+      for (int d = 0; d < nr_bins; ++d)
+        output.points[idx].histogram[d] = pfh_histogram[d];
+    }
+  }
+  output.is_dense = is_dense;
+}
+
+#define PCL_INSTANTIATE_PFHEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::PFHEstimationOMP<T,NT,OutT>;
+
+#endif    // PCL_FEATURES_IMPL_PFH_OMP_H_
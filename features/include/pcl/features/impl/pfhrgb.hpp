@@ -64,8 +64,20 @@ template <typename PointInT, typename PointNT, typename PointOutT> void
 pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature (
     const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
     const std::vector<int> &indices, int nr_split, Eigen::VectorXf &pfhrgb_histogram)
+{
+  computePointPFHRGBSignature (cloud, normals, indices, nr_split, use_cache_ ? &feature_cache_ : nullptr, pfhrgb_histogram);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature (
+    const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
+    const std::vector<int> &indices, int nr_split, PairFeatureCache *cache, Eigen::VectorXf &pfhrgb_histogram)
 {
   int h_index, h_p;
+  Eigen::Vector4f pfh_tuple;
+  float color_tuple[3];
+  int f_index[7];
 
   // Clear the resultant point histogram
   pfhrgb_histogram.setZero ();
@@ -82,37 +94,51 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature
       if (i_idx == j_idx)
         continue;
 
-      // Compute the pair NNi to NNj
-      if (!computeRGBPairFeatures (cloud, normals, indices[i_idx], indices[j_idx],
-                                   pfhrgb_tuple_[0], pfhrgb_tuple_[1], pfhrgb_tuple_[2], pfhrgb_tuple_[3],
-                                   pfhrgb_tuple_[4], pfhrgb_tuple_[5], pfhrgb_tuple_[6]))
-        continue;
+      // Check to see if we already estimated the geometric features of this pair
+      if (cache && cache->find (indices[i_idx], indices[j_idx], pfh_tuple))
+      {
+        const Eigen::Vector4i colors1 (cloud.points[indices[i_idx]].r, cloud.points[indices[i_idx]].g, cloud.points[indices[i_idx]].b, 0),
+                              colors2 (cloud.points[indices[j_idx]].r, cloud.points[indices[j_idx]].g, cloud.points[indices[j_idx]].b, 0);
+        pcl::computeRGBPairRatios (colors1, colors2, color_tuple[0], color_tuple[1], color_tuple[2]);
+      }
+      else
+      {
+        // Compute the pair NNi to NNj
+        if (!computeRGBPairFeatures (cloud, normals, indices[i_idx], indices[j_idx],
+                                     pfh_tuple[0], pfh_tuple[1], pfh_tuple[2], pfh_tuple[3],
+                                     color_tuple[0], color_tuple[1], color_tuple[2]))
+          continue;
+
+        // Save the geometric features in the bounded cache
+        if (cache)
+          cache->insert (indices[i_idx], indices[j_idx], pfh_tuple);
+      }
 
       // Normalize the f1, f2, f3, f5, f6, f7 features and push them in the histogram
-      f_index_[0] = static_cast<int> (std::floor (nr_split * ((pfhrgb_tuple_[0] + M_PI) * d_pi_)));
-      if (f_index_[0] < 0)         f_index_[0] = 0;
-      if (f_index_[0] >= nr_split) f_index_[0] = nr_split - 1;
+      f_index[0] = static_cast<int> (std::floor (nr_split * ((pfh_tuple[0] + M_PI) * d_pi_)));
+      if (f_index[0] < 0)         f_index[0] = 0;
+      if (f_index[0] >= nr_split) f_index[0] = nr_split - 1;
 
-      f_index_[1] = static_cast<int> (std::floor (nr_split * ((pfhrgb_tuple_[1] + 1.0) * 0.5)));
-      if (f_index_[1] < 0)         f_index_[1] = 0;
-      if (f_index_[1] >= nr_split) f_index_[1] = nr_split - 1;
+      f_index[1] = static_cast<int> (std::floor (nr_split * ((pfh_tuple[1] + 1.0) * 0.5)));
+      if (f_index[1] < 0)         f_index[1] = 0;
+      if (f_index[1] >= nr_split) f_index[1] = nr_split - 1;
 
-      f_index_[2] = static_cast<int> (std::floor (nr_split * ((pfhrgb_tuple_[2] + 1.0) * 0.5)));
-      if (f_index_[2] < 0)         f_index_[2] = 0;
-      if (f_index_[2] >= nr_split) f_index_[2] = nr_split - 1;
+      f_index[2] = static_cast<int> (std::floor (nr_split * ((pfh_tuple[2] + 1.0) * 0.5)));
+      if (f_index[2] < 0)         f_index[2] = 0;
+      if (f_index[2] >= nr_split) f_index[2] = nr_split - 1;
 
       // color ratios are in [-1, 1]
-      f_index_[4] = static_cast<int> (std::floor (nr_split * ((pfhrgb_tuple_[4] + 1.0) * 0.5)));
-      if (f_index_[4] < 0)         f_index_[4] = 0;
-      if (f_index_[4] >= nr_split) f_index_[4] = nr_split - 1;
+      f_index[4] = static_cast<int> (std::floor (nr_split * ((color_tuple[0] + 1.0) * 0.5)));
+      if (f_index[4] < 0)         f_index[4] = 0;
+      if (f_index[4] >= nr_split) f_index[4] = nr_split - 1;
 
-      f_index_[5] = static_cast<int> (std::floor (nr_split * ((pfhrgb_tuple_[5] + 1.0) * 0.5)));
-      if (f_index_[5] < 0)         f_index_[5] = 0;
-      if (f_index_[5] >= nr_split) f_index_[5] = nr_split - 1;
+      f_index[5] = static_cast<int> (std::floor (nr_split * ((color_tuple[1] + 1.0) * 0.5)));
+      if (f_index[5] < 0)         f_index[5] = 0;
+      if (f_index[5] >= nr_split) f_index[5] = nr_split - 1;
 
-      f_index_[6] = static_cast<int> (std::floor (nr_split * ((pfhrgb_tuple_[6] + 1.0) * 0.5)));
-      if (f_index_[6] < 0)         f_index_[6] = 0;
-      if (f_index_[6] >= nr_split) f_index_[6] = nr_split - 1;
+      f_index[6] = static_cast<int> (std::floor (nr_split * ((color_tuple[2] + 1.0) * 0.5)));
+      if (f_index[6] < 0)         f_index[6] = 0;
+      if (f_index[6] >= nr_split) f_index[6] = nr_split - 1;
 
 
       // Copy into the histogram
@@ -120,7 +146,7 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature
       h_p     = 1;
       for (int d = 0; d < 3; ++d)
       {
-        h_index += h_p * f_index_[d];
+        h_index += h_p * f_index[d];
         h_p     *= nr_split;
       }
       pfhrgb_histogram[h_index] += hist_incr;
@@ -130,7 +156,7 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature
       h_p     = 1;
       for (int d = 4; d < 7; ++d)
       {
-        h_index += h_p * f_index_[d];
+        h_index += h_p * f_index[d];
         h_p     *= nr_split;
       }
       pfhrgb_histogram[h_index] += hist_incr;
@@ -142,9 +168,11 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature
 template <typename PointInT, typename PointNT, typename PointOutT> void
 pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
 {
+  // Clear the feature cache
+  feature_cache_.clear ();
+
   /// nr_subdiv^3 for RGB and nr_subdiv^3 for the angular features
   pfhrgb_histogram_.setZero (2 * nr_subdiv_ * nr_subdiv_ * nr_subdiv_);
-  pfhrgb_tuple_.setZero (7);
 
   // Allocate enough space to hold the results
   // \note This resize is irrelevant for a radiusSearch ().
@@ -251,14 +251,14 @@ pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::normalizeHistog
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> void
-pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::interpolateSingleChannel (
+template <typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> std::size_t
+pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::computeVolumeVotes (
     const std::vector<int> &indices,
     const std::vector<float> &sqr_dists,
     const int index,
-    std::vector<double> &binDistance,
-    const int nr_bins,
-    Eigen::VectorXf &shot)
+    const std::vector<double> &binDistance,
+    std::size_t begin,
+    detail::SHOTVolumeVotes &votes)
 {
   const Eigen::Vector4f& central_point = (*input_)[(*indices_)[index]].getVector4fMap ();
   const PointRFT& current_frame = (*frames_)[index];
@@ -267,23 +267,25 @@ pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::interpolateSing
   Eigen::Vector4f current_frame_y (current_frame.y_axis[0], current_frame.y_axis[1], current_frame.y_axis[2], 0);
   Eigen::Vector4f current_frame_z (current_frame.z_axis[0], current_frame.z_axis[1], current_frame.z_axis[2], 0);
 
-  for (size_t i_idx = 0; i_idx < indices.size (); ++i_idx)
+  votes.size = 0;
+  size_t i_idx = begin;
+  for (; i_idx < indices.size () && votes.size < detail::SHOTVolumeVotes::block_size; ++i_idx)
   {
     if (!std::isfinite(binDistance[i_idx]))
       continue;
 
-    Eigen::Vector4f delta = surface_->points[indices[i_idx]].getVector4fMap () - central_point;
-    delta[3] = 0;
-
     // Compute the Euclidean norm
-   double distance = sqrt (sqr_dists[i_idx]);
+    double distance = sqrt (sqr_dists[i_idx]);
 
     if (areEquals (distance, 0.0))
       continue;
 
-    double xInFeatRef = delta.dot (current_frame_x);
-    double yInFeatRef = delta.dot (current_frame_y);
-    double zInFeatRef = delta.dot (current_frame_z);
+    Eigen::Vector4f delta = surface_->points[indices[i_idx]].getVector4fMap () - central_point;
+    delta[3] = 0;
+
+    float xInFeatRef = delta.dot (current_frame_x);
+    float yInFeatRef = delta.dot (current_frame_y);
+    float zInFeatRef = delta.dot (current_frame_z);
 
     // To avoid numerical problems afterwards
     if (std::abs (yInFeatRef) < 1E-30)
@@ -293,135 +295,68 @@ pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::interpolateSing
     if (std::abs (zInFeatRef) < 1E-30)
       zInFeatRef  = 0;
 
+    const std::size_t i = votes.size++;
+    votes.position[i] = static_cast<int> (i_idx);
+    votes.x[i] = xInFeatRef;
+    votes.y[i] = yInFeatRef;
+    votes.z[i] = zInFeatRef;
+    votes.distance[i] = static_cast<float> (distance);
+  }
 
-    unsigned char bit4 = ((yInFeatRef > 0) || ((yInFeatRef == 0.0) && (xInFeatRef < 0))) ? 1 : 0;
-    unsigned char bit3 = static_cast<unsigned char> (((xInFeatRef > 0) || ((xInFeatRef == 0.0) && (yInFeatRef > 0))) ? !bit4 : bit4);
-
-    assert (bit3 == 0 || bit3 == 1);
-
-    int desc_index = (bit4<<3) + (bit3<<2);
-
-    desc_index = desc_index << 1;
-
-    if ((xInFeatRef * yInFeatRef > 0) || (xInFeatRef == 0.0))
-      desc_index += (std::abs (xInFeatRef) >= std::abs (yInFeatRef)) ? 0 : 4;
-    else
-      desc_index += (std::abs (xInFeatRef) > std::abs (yInFeatRef)) ? 4 : 0;
-
-    desc_index += zInFeatRef > 0 ? 1 : 0;
-
-    // 2 RADII
-    desc_index += (distance > radius1_2_) ? 2 : 0;
+  detail::computeSHOTVolumeVotes (static_cast<float> (radius1_4_), static_cast<float> (radius1_2_),
+                                  static_cast<float> (radius3_4_), votes);
+  return (i_idx);
+}
 
-    int step_index = static_cast<int>(std::floor (binDistance[i_idx] +0.5));
-    int volume_index = desc_index * (nr_bins+1);
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> void
+pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::addVolumeVotes (
+    const detail::SHOTVolumeVotes &votes,
+    const std::vector<double> &binDistance,
+    const int nr_bins,
+    const int offset,
+    Eigen::VectorXf &shot) const
+{
+  for (std::size_t i = 0; i < votes.size; ++i)
+  {
+    const double bin_distance = binDistance[votes.position[i]];
+    int step_index = static_cast<int>(std::floor (bin_distance +0.5));
+    int volume_index = offset + votes.volume[i] * (nr_bins+1);
 
     //Interpolation on the cosine (adjacent bins in the histogram)
-    binDistance[i_idx] -= step_index;
-    double intWeight = (1- std::abs (binDistance[i_idx]));
-
-    if (binDistance[i_idx] > 0)
-      shot[volume_index + ((step_index+1) % nr_bins)] += static_cast<float> (binDistance[i_idx]);
-    else
-      shot[volume_index + ((step_index - 1 + nr_bins) % nr_bins)] += - static_cast<float> (binDistance[i_idx]);
-
-    //Interpolation on the distance (adjacent husks)
-
-    if (distance > radius1_2_)   //external sphere
-    {
-      double radiusDistance = (distance - radius3_4_) / radius1_2_;
-
-      if (distance > radius3_4_) //most external sector, votes only for itself
-        intWeight += 1 - radiusDistance;  //peso=1-d
-      else  //3/4 of radius, votes also for the internal sphere
-      {
-        intWeight += 1 + radiusDistance;
-        shot[(desc_index - 2) * (nr_bins+1) + step_index] -= static_cast<float> (radiusDistance);
-      }
-    }
-    else    //internal sphere
-    {
-      double radiusDistance = (distance - radius1_4_) / radius1_2_;
-
-      if (distance < radius1_4_) //most internal sector, votes only for itself
-        intWeight += 1 + radiusDistance;  //weight=1-d
-      else  //3/4 of radius, votes also for the external sphere
-      {
-        intWeight += 1 - radiusDistance;
-        shot[(desc_index + 2) * (nr_bins+1) + step_index] += static_cast<float> (radiusDistance);
-      }
-    }
-
-    //Interpolation on the inclination (adjacent vertical volumes)
-    double inclinationCos = zInFeatRef / distance;
-    if (inclinationCos < - 1.0)
-      inclinationCos = - 1.0;
-    if (inclinationCos > 1.0)
-      inclinationCos = 1.0;
-
-    double inclination = std::acos (inclinationCos);
-
-    assert (inclination >= 0.0 && inclination <= PST_RAD_180);
-
-    if (inclination > PST_RAD_90 || (std::abs (inclination - PST_RAD_90) < 1e-30 && zInFeatRef <= 0))
-    {
-      double inclinationDistance = (inclination - PST_RAD_135) / PST_RAD_90;
-      if (inclination > PST_RAD_135)
-        intWeight += 1 - inclinationDistance;
-      else
-      {
-        intWeight += 1 + inclinationDistance;
-        assert ((desc_index + 1) * (nr_bins+1) + step_index >= 0 && (desc_index + 1) * (nr_bins+1) + step_index < descLength_);
-        shot[(desc_index + 1) * (nr_bins+1) + step_index] -= static_cast<float> (inclinationDistance);
-      }
-    }
+    const double cosine_distance = bin_distance - step_index;
+    if (cosine_distance > 0)
+      shot[volume_index + ((step_index+1) % nr_bins)] += static_cast<float> (cosine_distance);
     else
-    {
-      double inclinationDistance = (inclination - PST_RAD_45) / PST_RAD_90;
-      if (inclination < PST_RAD_45)
-        intWeight += 1 + inclinationDistance;
-      else
-      {
-        intWeight += 1 - inclinationDistance;
-        assert ((desc_index - 1) * (nr_bins+1) + step_index >= 0 && (desc_index - 1) * (nr_bins+1) + step_index < descLength_);
-        shot[(desc_index - 1) * (nr_bins+1) + step_index] += static_cast<float> (inclinationDistance);
-      }
-    }
+      shot[volume_index + ((step_index - 1 + nr_bins) % nr_bins)] -= static_cast<float> (cosine_distance);
 
-    if (yInFeatRef != 0.0 || xInFeatRef != 0.0)
+    //Interpolation on the distance, inclination and azimuth (adjacent volumes)
+    for (int d = 0; d < 3; ++d)
     {
-      //Interpolation on the azimuth (adjacent horizontal volumes)
-      double azimuth = std::atan2 (yInFeatRef, xInFeatRef);
-
-      int sel = desc_index >> 2;
-      double angularSectorSpan = PST_RAD_45;
-      double angularSectorStart = - PST_RAD_PI_7_8;
-
-      double azimuthDistance = (azimuth - (angularSectorStart + angularSectorSpan*sel)) / angularSectorSpan;
-
-      assert ((azimuthDistance < 0.5 || areEquals (azimuthDistance, 0.5)) && (azimuthDistance > - 0.5 || areEquals (azimuthDistance, - 0.5)));
-
-      azimuthDistance = (std::max)(- 0.5, std::min (azimuthDistance, 0.5));
-
-      if (azimuthDistance > 0)
-      {
-        intWeight += 1 - azimuthDistance;
-        int interp_index = (desc_index + 4) % maxAngularSectors_;
-        assert (interp_index * (nr_bins+1) + step_index >= 0 && interp_index * (nr_bins+1) + step_index < descLength_);
-        shot[interp_index * (nr_bins+1) + step_index] += static_cast<float> (azimuthDistance);
-      }
-      else
-      {
-        int interp_index = (desc_index - 4 + maxAngularSectors_) % maxAngularSectors_;
-        assert (interp_index * (nr_bins+1) + step_index >= 0 && interp_index * (nr_bins+1) + step_index < descLength_);
-        intWeight += 1 + azimuthDistance;
-        shot[interp_index * (nr_bins+1) + step_index] -= static_cast<float> (azimuthDistance);
-      }
-
+      assert (offset + votes.neighbor_volume[d][i] * (nr_bins+1) + step_index >= 0 && offset + votes.neighbor_volume[d][i] * (nr_bins+1) + step_index < descLength_);
+      shot[offset + votes.neighbor_volume[d][i] * (nr_bins+1) + step_index] += votes.neighbor_weight[d][i];
     }
 
     assert (volume_index + step_index >= 0 &&  volume_index + step_index < descLength_);
-    shot[volume_index + step_index] += static_cast<float> (intWeight);
+    shot[volume_index + step_index] += static_cast<float> (1 - std::abs (cosine_distance)) + votes.volume_weight[i];
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> void
+pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::interpolateSingleChannel (
+    const std::vector<int> &indices,
+    const std::vector<float> &sqr_dists,
+    const int index,
+    std::vector<double> &binDistance,
+    const int nr_bins,
+    Eigen::VectorXf &shot)
+{
+  detail::SHOTVolumeVotes votes;
+  for (size_t i_idx = 0; i_idx < indices.size (); )
+  {
+    i_idx = computeVolumeVotes (indices, sqr_dists, index, binDistance, i_idx, votes);
+    addVolumeVotes (votes, binDistance, nr_bins, 0, shot);
   }
 }
 
@@ -437,207 +372,15 @@ pcl::SHOTColorEstimation<PointInT, PointNT, PointOutT, PointRFT>::interpolateDou
   const int nr_bins_color,
   Eigen::VectorXf &shot)
 {
-  const Eigen::Vector4f &central_point = (*input_)[(*indices_)[index]].getVector4fMap ();
-  const PointRFT& current_frame = (*frames_)[index];
-
   int shapeToColorStride = nr_grid_sector_*(nr_bins_shape+1);
 
-  Eigen::Vector4f current_frame_x (current_frame.x_axis[0], current_frame.x_axis[1], current_frame.x_axis[2], 0);
-  Eigen::Vector4f current_frame_y (current_frame.y_axis[0], current_frame.y_axis[1], current_frame.y_axis[2], 0);
-  Eigen::Vector4f current_frame_z (current_frame.z_axis[0], current_frame.z_axis[1], current_frame.z_axis[2], 0);
-
-  for (size_t i_idx = 0; i_idx < indices.size (); ++i_idx)
+  // Both channels share the spatial votes, neighbors are selected on the shape channel
+  detail::SHOTVolumeVotes votes;
+  for (size_t i_idx = 0; i_idx < indices.size (); )
   {
-    if (!std::isfinite(binDistanceShape[i_idx]))
-      continue;
-
-    Eigen::Vector4f delta = surface_->points[indices[i_idx]].getVector4fMap () - central_point;
-    delta[3] = 0;
-
-    // Compute the Euclidean norm
-    double distance = sqrt (sqr_dists[i_idx]);
-
-    if (areEquals (distance, 0.0))
-      continue;
-
-    double xInFeatRef = delta.dot (current_frame_x);
-    double yInFeatRef = delta.dot (current_frame_y);
-    double zInFeatRef = delta.dot (current_frame_z);
-
-    // To avoid numerical problems afterwards
-    if (std::abs (yInFeatRef) < 1E-30)
-      yInFeatRef  = 0;
-    if (std::abs (xInFeatRef) < 1E-30)
-      xInFeatRef  = 0;
-    if (std::abs (zInFeatRef) < 1E-30)
-      zInFeatRef  = 0;
-
-    unsigned char bit4 = ((yInFeatRef > 0) || ((yInFeatRef == 0.0) && (xInFeatRef < 0))) ? 1 : 0;
-    unsigned char bit3 = static_cast<unsigned char> (((xInFeatRef > 0) || ((xInFeatRef == 0.0) && (yInFeatRef > 0))) ? !bit4 : bit4);
-
-    assert (bit3 == 0 || bit3 == 1);
-
-    int desc_index = (bit4<<3) + (bit3<<2);
-
-    desc_index = desc_index << 1;
-
-    if ((xInFeatRef * yInFeatRef > 0) || (xInFeatRef == 0.0))
-      desc_index += (std::abs (xInFeatRef) >= std::abs (yInFeatRef)) ? 0 : 4;
-    else
-      desc_index += (std::abs (xInFeatRef) > std::abs (yInFeatRef)) ? 4 : 0;
-
-    desc_index += zInFeatRef > 0 ? 1 : 0;
-
-    // 2 RADII
-    desc_index += (distance > radius1_2_) ? 2 : 0;
-
-    int step_index_shape = static_cast<int>(std::floor (binDistanceShape[i_idx] +0.5));
-    int step_index_color = static_cast<int>(std::floor (binDistanceColor[i_idx] +0.5));
-
-    int volume_index_shape = desc_index * (nr_bins_shape+1);
-    int volume_index_color = shapeToColorStride + desc_index * (nr_bins_color+1);
-
-    //Interpolation on the cosine (adjacent bins in the histrogram)
-    binDistanceShape[i_idx] -= step_index_shape;
-    binDistanceColor[i_idx] -= step_index_color;
-
-    double intWeightShape = (1- std::abs (binDistanceShape[i_idx]));
-    double intWeightColor = (1- std::abs (binDistanceColor[i_idx]));
-
-    if (binDistanceShape[i_idx] > 0)
-      shot[volume_index_shape + ((step_index_shape + 1) % nr_bins_shape)] += static_cast<float> (binDistanceShape[i_idx]);
-    else
-      shot[volume_index_shape + ((step_index_shape - 1 + nr_bins_shape) % nr_bins_shape)] -= static_cast<float> (binDistanceShape[i_idx]);
-
-    if (binDistanceColor[i_idx] > 0)
-      shot[volume_index_color + ((step_index_color+1) % nr_bins_color)] += static_cast<float> (binDistanceColor[i_idx]);
-    else
-      shot[volume_index_color + ((step_index_color - 1 + nr_bins_color) % nr_bins_color)] -= static_cast<float> (binDistanceColor[i_idx]);
-
-    //Interpolation on the distance (adjacent husks)
-
-    if (distance > radius1_2_)   //external sphere
-    {
-      double radiusDistance = (distance - radius3_4_) / radius1_2_;
-
-      if (distance > radius3_4_) //most external sector, votes only for itself
-      {
-        intWeightShape += 1 - radiusDistance; //weight=1-d
-        intWeightColor += 1 - radiusDistance; //weight=1-d
-      }
-      else  //3/4 of radius, votes also for the internal sphere
-      {
-        intWeightShape += 1 + radiusDistance;
-        intWeightColor += 1 + radiusDistance;
-        shot[(desc_index - 2) * (nr_bins_shape+1) + step_index_shape] -= static_cast<float> (radiusDistance);
-        shot[shapeToColorStride + (desc_index - 2) * (nr_bins_color+1) + step_index_color] -= static_cast<float> (radiusDistance);
-      }
-    }
-    else    //internal sphere
-    {
-      double radiusDistance = (distance - radius1_4_) / radius1_2_;
-
-      if (distance < radius1_4_) //most internal sector, votes only for itself
-      {
-        intWeightShape += 1 + radiusDistance;
-        intWeightColor += 1 + radiusDistance; //weight=1-d
-      }
-      else  //3/4 of radius, votes also for the external sphere
-      {
-        intWeightShape += 1 - radiusDistance; //weight=1-d
-        intWeightColor += 1 - radiusDistance; //weight=1-d
-        shot[(desc_index + 2) * (nr_bins_shape+1) + step_index_shape] += static_cast<float> (radiusDistance);
-        shot[shapeToColorStride + (desc_index + 2) * (nr_bins_color+1) + step_index_color] += static_cast<float> (radiusDistance);
-      }
-    }
-
-    //Interpolation on the inclination (adjacent vertical volumes)
-    double inclinationCos = zInFeatRef / distance;
-    if (inclinationCos < - 1.0)
-      inclinationCos = - 1.0;
-    if (inclinationCos > 1.0)
-      inclinationCos = 1.0;
-
-    double inclination = std::acos (inclinationCos);
-
-    assert (inclination >= 0.0 && inclination <= PST_RAD_180);
-
-    if (inclination > PST_RAD_90 || (std::abs (inclination - PST_RAD_90) < 1e-30 && zInFeatRef <= 0))
-    {
-      double inclinationDistance = (inclination - PST_RAD_135) / PST_RAD_90;
-      if (inclination > PST_RAD_135)
-      {
-        intWeightShape += 1 - inclinationDistance;
-        intWeightColor += 1 - inclinationDistance;
-      }
-      else
-      {
-        intWeightShape += 1 + inclinationDistance;
-        intWeightColor += 1 + inclinationDistance;
-        assert ((desc_index + 1) * (nr_bins_shape+1) + step_index_shape >= 0 && (desc_index + 1) * (nr_bins_shape+1) + step_index_shape < descLength_);
-        assert (shapeToColorStride + (desc_index + 1) * (nr_bins_color+ 1) + step_index_color >= 0 && shapeToColorStride + (desc_index + 1) * (nr_bins_color+1) + step_index_color < descLength_);
-        shot[(desc_index + 1) * (nr_bins_shape+1) + step_index_shape] -= static_cast<float> (inclinationDistance);
-        shot[shapeToColorStride + (desc_index + 1) * (nr_bins_color+1) + step_index_color] -= static_cast<float> (inclinationDistance);
-      }
-    }
-    else
-    {
-      double inclinationDistance = (inclination - PST_RAD_45) / PST_RAD_90;
-      if (inclination < PST_RAD_45)
-      {
-        intWeightShape += 1 + inclinationDistance;
-        intWeightColor += 1 + inclinationDistance;
-      }
-      else
-      {
-        intWeightShape += 1 - inclinationDistance;
-        intWeightColor += 1 - inclinationDistance;
-        assert ((desc_index - 1) * (nr_bins_shape+1) + step_index_shape >= 0 && (desc_index - 1) * (nr_bins_shape+1) + step_index_shape < descLength_);
-        assert (shapeToColorStride + (desc_index - 1) * (nr_bins_color+ 1) + step_index_color >= 0 && shapeToColorStride + (desc_index - 1) * (nr_bins_color+1) + step_index_color < descLength_);
-        shot[(desc_index - 1) * (nr_bins_shape+1) + step_index_shape] += static_cast<float> (inclinationDistance);
-        shot[shapeToColorStride + (desc_index - 1) * (nr_bins_color+1) + step_index_color] += static_cast<float> (inclinationDistance);
-      }
-    }
-
-    if (yInFeatRef != 0.0 || xInFeatRef != 0.0)
-    {
-      //Interpolation on the azimuth (adjacent horizontal volumes)
-      double azimuth = std::atan2 (yInFeatRef, xInFeatRef);
-
-      int sel = desc_index >> 2;
-      double angularSectorSpan = PST_RAD_45;
-      double angularSectorStart = - PST_RAD_PI_7_8;
-
-      double azimuthDistance = (azimuth - (angularSectorStart + angularSectorSpan*sel)) / angularSectorSpan;
-      assert ((azimuthDistance < 0.5 || areEquals (azimuthDistance, 0.5)) && (azimuthDistance > - 0.5 || areEquals (azimuthDistance, - 0.5)));
-      azimuthDistance = (std::max)(- 0.5, std::min (azimuthDistance, 0.5));
-
-      if (azimuthDistance > 0)
-      {
-        intWeightShape += 1 - azimuthDistance;
-        intWeightColor += 1 - azimuthDistance;
-        int interp_index = (desc_index + 4) % maxAngularSectors_;
-        assert (interp_index * (nr_bins_shape+1) + step_index_shape >= 0 && interp_index * (nr_bins_shape+1) + step_index_shape < descLength_);
-        assert (shapeToColorStride + interp_index * (nr_bins_color+1) + step_index_color >= 0 && shapeToColorStride + interp_index * (nr_bins_color+1) + step_index_color < descLength_);
-        shot[interp_index * (nr_bins_shape+1) + step_index_shape] += static_cast<float> (azimuthDistance);
-        shot[shapeToColorStride + interp_index * (nr_bins_color+1) + step_index_color] += static_cast<float> (azimuthDistance);
-      }
-      else
-      {
-        int interp_index = (desc_index - 4 + maxAngularSectors_) % maxAngularSectors_;
-        intWeightShape += 1 + azimuthDistance;
-        intWeightColor += 1 + azimuthDistance;
-        assert (interp_index * (nr_bins_shape+1) + step_index_shape >= 0 && interp_index * (nr_bins_shape+1) + step_index_shape < descLength_);
-        assert (shapeToColorStride + interp_index * (nr_bins_color+1) + step_index_color >= 0 && shapeToColorStride + interp_index * (nr_bins_color+1) + step_index_color < descLength_);
-        shot[interp_index * (nr_bins_shape+1) + step_index_shape] -= static_cast<float> (azimuthDistance);
-        shot[shapeToColorStride + interp_index * (nr_bins_color+1) + step_index_color] -= static_cast<float> (azimuthDistance);
-      }
-    }
-
-    assert (volume_index_shape + step_index_shape >= 0 &&  volume_index_shape + step_index_shape < descLength_);
-    assert (volume_index_color + step_index_color >= 0 &&  volume_index_color + step_index_color < descLength_);
-    shot[volume_index_shape + step_index_shape] += static_cast<float> (intWeightShape);
-    shot[volume_index_color + step_index_color] += static_cast<float> (intWeightColor);
+    i_idx = computeVolumeVotes (indices, sqr_dists, index, binDistanceShape, i_idx, votes);
+    addVolumeVotes (votes, binDistanceShape, nr_bins_shape, 0, shot);
+    addVolumeVotes (votes, binDistanceColor, nr_bins_color, shapeToColorStride, shot);
   }
 }
 
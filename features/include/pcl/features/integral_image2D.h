@@ -121,7 +121,8 @@ namespace pcl
         second_order_integral_image_ (),
         width_ (1), 
         height_ (1), 
-        compute_second_order_integral_images_ (compute_second_order_integral_images)
+        compute_second_order_integral_images_ (compute_second_order_integral_images),
+        threads_ (1)
       {
       }
 
@@ -135,6 +136,12 @@ namespace pcl
       void 
       setSecondOrderComputation (bool compute_second_order_integral_images);
 
+      /** \brief Set the number of threads used to compute the integral images.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Set the input data to compute the integral image for
         * \param[in] data the input data
         * \param[in] width the width of the data
@@ -222,6 +229,9 @@ namespace pcl
 
       /** \brief Indicates whether second order integral images are available **/
       bool compute_second_order_integral_images_;
+
+      /** \brief The number of threads used to compute the integral images. */
+      unsigned int threads_;
    };
 
    /**
@@ -245,7 +255,8 @@ namespace pcl
         second_order_integral_image_ (),
         
         width_ (1), height_ (1), 
-        compute_second_order_integral_images_ (compute_second_order_integral_images)
+        compute_second_order_integral_images_ (compute_second_order_integral_images),
+        threads_ (1)
       {
       }
 
@@ -253,6 +264,12 @@ namespace pcl
       virtual
       ~IntegralImage2D () { }
 
+      /** \brief Set the number of threads used to compute the integral images.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Set the input data to compute the integral image for
         * \param[in] data the input data
         * \param[in] width the width of the data
@@ -340,6 +357,9 @@ namespace pcl
 
       /** \brief Indicates whether second order integral images are available **/
       bool compute_second_order_integral_images_;
+
+      /** \brief The number of threads used to compute the integral images. */
+      unsigned int threads_;
    };
  }
 
@@ -129,6 +129,7 @@ namespace pcl
         , vpy_ (0.0f)
         , vpz_ (0.0f)
         , use_sensor_origin_ (true)
+        , threads_ (1)
       {
         feature_name_ = "IntegralImagesNormalEstimation";
         tree_.reset ();
@@ -145,6 +146,12 @@ namespace pcl
       void
       setRectSize (const int width, const int height);
 
+      /** \brief Set the number of threads used to compute the integral images and the normals.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Sets the policy for handling borders.
         * \param[in] border_policy the border policy.
         */
@@ -335,6 +342,70 @@ namespace pcl
       void
       computeFeaturePart (const float* distance_map, const float& bad_point, PointCloudOut& output);
 
+      /** \brief Computes the normals of a block of points. With COVARIANCE_MATRIX, the eigen problems of the
+        * block are solved together with pcl::eigen33Batch.
+        * \param[in] indices the indices of the points in the input cloud
+        * \param[in] nr_points the number of points in the block
+        * \param[in] distance_map distance map
+        * \param[in] bad_point constant given to invalid normal components
+        * \param[out] normals the resultant normals, one per index
+        * \param[in,out] covariances scratch space for the batched covariance matrices
+        * \param[in,out] batch_slots scratch space for the positions of the batched points in the block
+        */
+      void
+      computeNormalBlock (const int *indices, const int nr_points, const float *distance_map, const float &bad_point,
+                          PointOutT *normals, std::vector<float> &covariances, std::vector<int> &batch_slots) const;
+
+      /** \brief Computes the normal at the specified position, for a given region size.
+        * The data of the chosen normal estimation method has to be initialized already.
+        * \param[in] pos_x x position (pixel)
+        * \param[in] pos_y y position (pixel)
+        * \param[in] point_index the position index of the point
+        * \param[in] rect_width the width of the search rectangle
+        * \param[in] rect_height the height of the search rectangle
+        * \param[out] normal the output estimated normal
+        */
+      void
+      computePointNormal (const int pos_x, const int pos_y, const unsigned point_index,
+                          const int rect_width, const int rect_height, PointOutT &normal) const;
+
+      /** \brief Computes the normal at the specified position with mirroring for border handling, for a given
+        * region size. The data of the chosen normal estimation method has to be initialized already.
+        * \param[in] pos_x x position (pixel)
+        * \param[in] pos_y y position (pixel)
+        * \param[in] point_index the position index of the point
+        * \param[in] rect_width the width of the search rectangle
+        * \param[in] rect_height the height of the search rectangle
+        * \param[out] normal the output estimated normal
+        */
+      void
+      computePointNormalMirror (const int pos_x, const int pos_y, const unsigned point_index,
+                                const int rect_width, const int rect_height, PointOutT &normal) const;
+
+      /** \brief Computes the covariance matrix of the region around a position (COVARIANCE_MATRIX method).
+        * \param[in] pos_x x position (pixel)
+        * \param[in] pos_y y position (pixel)
+        * \param[in] rect_width the width of the search rectangle
+        * \param[in] rect_height the height of the search rectangle
+        * \param[out] covariance_matrix the resultant covariance matrix
+        * \return false if the region holds no valid points
+        */
+      bool
+      computePointCovariance (const int pos_x, const int pos_y, const int rect_width, const int rect_height,
+                              Eigen::Matrix3f &covariance_matrix) const;
+
+      /** \brief Computes the covariance matrix of the region around a position with mirroring for border handling.
+        * \param[in] pos_x x position (pixel)
+        * \param[in] pos_y y position (pixel)
+        * \param[in] rect_width the width of the search rectangle
+        * \param[in] rect_height the height of the search rectangle
+        * \param[out] covariance_matrix the resultant covariance matrix
+        * \return false if the region holds no valid points
+        */
+      bool
+      computePointCovarianceMirror (const int pos_x, const int pos_y, const int rect_width, const int rect_height,
+                                    Eigen::Matrix3f &covariance_matrix) const;
+
       /** \brief Initialize the data structures, based on the normal estimation method chosen. */
       void
       initData ();
@@ -354,7 +425,7 @@ namespace pcl
       inline void
       flipNormalTowardsViewpoint (const PointInT &point, 
                                   float vp_x, float vp_y, float vp_z,
-                                  float &nx, float &ny, float &nz)
+                                  float &nx, float &ny, float &nz) const
       {
         // See if we need to flip any plane normals
         vp_x -= point.x;
@@ -443,11 +514,18 @@ namespace pcl
 
       /** whether the sensor origin of the input cloud or a user given viewpoint should be used.*/
       bool use_sensor_origin_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
       
       /** \brief This method should get called before starting the actual computation. */
       bool
       initCompute () override;
 
+      /** \brief Initialize the data of the chosen normal estimation method, unless that was done already. */
+      void
+      initCurrentMethod ();
+
       /** \brief Internal initialization method for COVARIANCE_MATRIX estimation. */
       void
       initCovarianceMatrixMethod ();
@@ -400,6 +400,22 @@ namespace pcl
       void
       computeFeature (PointCloudOut &output) override;
 
+      /** \brief Estimate the normals of the output points in [begin, end), which must span at most
+        * batch_size_ points. The neighborhoods of the block are searched and their covariance matrices
+        * computed first, then all eigen problems of the block are solved at once with pcl::eigen33Batch.
+        * \note Only local storage is used, so blocks can be processed concurrently.
+        * \param[in] begin the first position in indices_ to process
+        * \param[in] end one past the last position in indices_ to process
+        * \param[in] check_finite whether the query points need to be checked for NaN/Inf values
+        * \param[out] output the resultant point cloud, whose points [begin, end) are written
+        * \return false if any normal of the block could not be estimated and was set to NaN
+        */
+      bool
+      computeFeatureBlock (std::size_t begin, std::size_t end, bool check_finite, PointCloudOut &output);
+
+      /** \brief Number of points whose eigen problems are solved together by computeFeatureBlock (). */
+      static const std::size_t batch_size_ = 64;
+
       /** \brief Values describing the viewpoint ("pinhole" camera model assumed). For per point viewpoints, inherit
         * from NormalEstimation and provide your own computeFeature (). By default, the viewpoint is set to 0,0,0. */
       float vpx_, vpy_, vpz_;
@@ -66,6 +66,8 @@ namespace pcl
       using NormalEstimation<PointInT, PointOutT>::search_parameter_;
       using NormalEstimation<PointInT, PointOutT>::surface_;
       using NormalEstimation<PointInT, PointOutT>::getViewPoint;
+      using NormalEstimation<PointInT, PointOutT>::computeFeatureBlock;
+      using NormalEstimation<PointInT, PointOutT>::batch_size_;
 
       using PointCloudOut = typename NormalEstimation<PointInT, PointOutT>::PointCloudOut;
 
@@ -43,7 +43,6 @@
 #include <pcl/point_types.h>
 #include <pcl/features/feature.h>
 #include <pcl/features/pfh_tools.h>
-#include <map>
 
 namespace pcl
 {
@@ -72,7 +71,7 @@ namespace pcl
     *     NaN data on x, y, or z, will have its PFH feature property set to NaN.
     *
     * \note The code is stateful as we do not expect this class to be multicore parallelized. Please look at
-    * \ref FPFHEstimationOMP for examples on parallel implementations of the FPFH (Fast Point Feature Histogram).
+    * \ref PFHEstimationOMP for a parallel implementation.
     *
     * \author Radu B. Rusu
     * \ingroup features
@@ -101,7 +100,6 @@ namespace pcl
       PFHEstimation () : 
         nr_subdiv_ (5), 
         d_pi_ (1.0f / (2.0f * static_cast<float> (M_PI))), 
-        key_list_ (),
         // Default 1GB memory size. Need to set it to something more conservative.
         max_cache_size_ ((1ul*1024ul*1024ul*1024ul) / sizeof (std::pair<std::pair<int, int>, Eigen::Vector4f>)),
         use_cache_ (false)
@@ -116,6 +114,7 @@ namespace pcl
       setMaximumCacheSize (unsigned int cache_size)
       {
         max_cache_size_ = cache_size;
+        feature_cache_.setMaximumSize (use_cache_ ? max_cache_size_ : 0);
       }
 
       /** \brief Get the maximum internal cache size. */
@@ -140,6 +139,7 @@ namespace pcl
       setUseInternalCache (bool use_cache)
       {
         use_cache_ = use_cache;
+        feature_cache_.setMaximumSize (use_cache_ ? max_cache_size_ : 0);
       }
 
       /** \brief Get whether the internal cache is used or not for computing the PFH features. */
@@ -180,6 +180,20 @@ namespace pcl
                                 const std::vector<int> &indices, int nr_split, Eigen::VectorXf &pfh_histogram);
 
     protected:
+      /** \brief Estimate the PFH signature of a neighborhood like computePointPFHSignature (), memoizing the pair
+        * features in the given cache. Only local state is used, so concurrent calls with distinct caches are safe.
+        * \param[in] cloud the dataset containing the XYZ Cartesian coordinates of the two points
+        * \param[in] normals the dataset containing the surface normals at each point in \a cloud
+        * \param[in] indices the k-neighborhood point indices in the dataset
+        * \param[in] nr_split the number of subdivisions for each angular feature interval
+        * \param[in,out] cache the pair feature cache to use, or nullptr to compute every pair
+        * \param[out] pfh_histogram the resultant (combinatorial) PFH histogram representing the feature at the query point
+        */
+      void
+      computePointPFHSignature (const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
+                                const std::vector<int> &indices, int nr_split, PairFeatureCache *cache,
+                                Eigen::VectorXf &pfh_histogram);
+
       /** \brief Estimate the Point Feature Histograms (PFH) descriptors at a set of points given by
         * <setInputCloud (), setIndices ()> using the surface in setSearchSurface () and the spatial locator in
         * setSearchMethod ()
@@ -194,20 +208,11 @@ namespace pcl
       /** \brief Placeholder for a point's PFH signature. */
       Eigen::VectorXf pfh_histogram_;
 
-      /** \brief Placeholder for a PFH 4-tuple. */
-      Eigen::Vector4f pfh_tuple_;
-
-      /** \brief Placeholder for a histogram index. */
-      int f_index_[3];
-
       /** \brief Float constant = 1.0 / (2.0 * M_PI) */
       float d_pi_; 
 
-      /** \brief Internal hashmap, used to optimize efficiency of redundant computations. */
-      std::map<std::pair<int, int>, Eigen::Vector4f, std::less<>, Eigen::aligned_allocator<std::pair<const std::pair<int, int>, Eigen::Vector4f> > > feature_map_;
-
-      /** \brief Queue of pairs saved, used to constrain memory usage. */
-      std::queue<std::pair<int, int> > key_list_;
+      /** \brief Internal bounded memo of pair features, used to optimize efficiency of redundant computations. */
+      PairFeatureCache feature_cache_;
 
       /** \brief Maximum size of internal cache memory. */
       unsigned int max_cache_size_;
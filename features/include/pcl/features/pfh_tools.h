@@ -43,6 +43,8 @@
 
 #include <pcl/pcl_exports.h>
 #include <Eigen/Core>
+#include <cstddef>
+#include <vector>
 
 namespace pcl
 {
@@ -72,4 +74,94 @@ namespace pcl
                           const Eigen::Vector4f &p2, const Eigen::Vector4f &n2, const Eigen::Vector4i &colors2,
                           float &f1, float &f2, float &f3, float &f4, float &f5, float &f6, float &f7);
 
+  /** \brief Compute the three color ratio features (f5, f6, f7) of computeRGBPairFeatures, which only depend
+    * on the colors of the two points.
+    * \param[in] colors1 the red, green and blue values of the first point
+    * \param[in] colors2 the red, green and blue values of the second point
+    * \param[out] f5 the red ratio, in the [-1, 1] interval
+    * \param[out] f6 the green ratio, in the [-1, 1] interval
+    * \param[out] f7 the blue ratio, in the [-1, 1] interval
+    * \ingroup features
+    */
+  PCL_EXPORTS void
+  computeRGBPairRatios (const Eigen::Vector4i &colors1, const Eigen::Vector4i &colors2,
+                        float &f5, float &f6, float &f7);
+
+  /** \brief Bounded memo of pair features, keyed by the ordered pair of point indices (p_idx, q_idx).
+    * The entries are kept in a flat open addressing table that grows on demand, and at most the maximum
+    * number of pairs is held; beyond that, new pairs overwrite the entries in their home slots. No locking
+    * is done, so parallel users keep one instance per thread.
+    * \ingroup features
+    */
+  class PCL_EXPORTS PairFeatureCache
+  {
+    public:
+      /** \brief Constructor.
+        * \param[in] max_entries the maximum number of pairs held (0 disables the cache)
+        */
+      PairFeatureCache (std::size_t max_entries = 0);
+
+      /** \brief Drop all entries and set the maximum number of pairs held.
+        * \param[in] max_entries the maximum number of pairs held (0 disables the cache)
+        */
+      void
+      setMaximumSize (std::size_t max_entries);
+
+      /** \brief Drop all entries, keeping the maximum number of pairs. */
+      void
+      clear ();
+
+      /** \brief Get the number of pairs currently held. */
+      inline std::size_t
+      size () const
+      {
+        return (size_);
+      }
+
+      /** \brief Look up the features of the pair (p_idx, q_idx).
+        * \param[in] p_idx the index of the first point (source)
+        * \param[in] q_idx the index of the second point (target)
+        * \param[out] features the cached features, if found
+        * \return true if the pair is in the cache
+        */
+      bool
+      find (int p_idx, int q_idx, Eigen::Vector4f &features) const;
+
+      /** \brief Store the features of the pair (p_idx, q_idx), possibly evicting another pair.
+        * \param[in] p_idx the index of the first point (source)
+        * \param[in] q_idx the index of the second point (target)
+        * \param[in] features the features of the pair
+        */
+      void
+      insert (int p_idx, int q_idx, const Eigen::Vector4f &features);
+
+    private:
+      /** \brief A cached pair; p_idx is -1 for an empty slot. */
+      struct Entry
+      {
+        int p_idx;
+        int q_idx;
+        float features[4];
+      };
+
+      /** \brief Home slot of the pair (p_idx, q_idx). */
+      std::size_t
+      slot (int p_idx, int q_idx) const;
+
+      /** \brief Double the table size and reinsert all entries. */
+      void
+      grow ();
+
+      /** \brief The open addressing table, its size is a power of two. */
+      std::vector<Entry> entries_;
+
+      /** \brief The number of occupied slots. */
+      std::size_t size_;
+
+      /** \brief The maximum number of pairs held. */
+      std::size_t max_entries_;
+
+      /** \brief The largest table size allowed by the maximum number of pairs. */
+      std::size_t max_slots_;
+  };
 }
@@ -61,10 +61,48 @@ namespace pcl
 
       PFHRGBEstimation ()
         : nr_subdiv_ (5), d_pi_ (1.0f / (2.0f * static_cast<float> (M_PI)))
+        // Default 1GB memory size, as in PFHEstimation
+        , max_cache_size_ ((1ul*1024ul*1024ul*1024ul) / sizeof (std::pair<std::pair<int, int>, Eigen::Vector4f>))
+        , use_cache_ (false)
       {
         feature_name_ = "PFHRGBEstimation";
       }
 
+      /** \brief Set the maximum number of pairs held by the internal cache.
+        * \param[in] cache_size maximum cache size
+        */
+      inline void
+      setMaximumCacheSize (unsigned int cache_size)
+      {
+        max_cache_size_ = cache_size;
+        feature_cache_.setMaximumSize (use_cache_ ? max_cache_size_ : 0);
+      }
+
+      /** \brief Get the maximum internal cache size. */
+      inline unsigned int
+      getMaximumCacheSize ()
+      {
+        return (max_cache_size_);
+      }
+
+      /** \brief Set whether to memoize the geometric features of point pairs in an internal cache. The color
+        * ratios are cheap and always recomputed. See PFHEstimation::setUseInternalCache.
+        * \param[in] use_cache set to true to use the internal cache, false otherwise
+        */
+      inline void
+      setUseInternalCache (bool use_cache)
+      {
+        use_cache_ = use_cache;
+        feature_cache_.setMaximumSize (use_cache_ ? max_cache_size_ : 0);
+      }
+
+      /** \brief Get whether the internal cache is used or not for computing the PFHRGB features. */
+      inline bool
+      getUseInternalCache ()
+      {
+        return (use_cache_);
+      }
+
       bool
       computeRGBPairFeatures (const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
                               int p_idx, int q_idx,
@@ -75,24 +113,41 @@ namespace pcl
                                    const std::vector<int> &indices, int nr_split, Eigen::VectorXf &pfhrgb_histogram);
 
     protected:
+      /** \brief Estimate the PFHRGB signature of a neighborhood like computePointPFHRGBSignature (), memoizing the
+        * geometric pair features in the given cache. Only local state is used, so concurrent calls with distinct
+        * caches are safe.
+        * \param[in] cloud the dataset containing the XYZ Cartesian coordinates and colors of the points
+        * \param[in] normals the dataset containing the surface normals at each point in \a cloud
+        * \param[in] indices the k-neighborhood point indices in the dataset
+        * \param[in] nr_split the number of subdivisions for each angular feature interval
+        * \param[in,out] cache the pair feature cache to use, or nullptr to compute every pair
+        * \param[out] pfhrgb_histogram the resultant PFHRGB histogram representing the feature at the query point
+        */
+      void
+      computePointPFHRGBSignature (const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
+                                   const std::vector<int> &indices, int nr_split, PairFeatureCache *cache,
+                                   Eigen::VectorXf &pfhrgb_histogram);
+
       void
       computeFeature (PointCloudOut &output) override;
 
-    private:
       /** \brief The number of subdivisions for each angular feature interval. */
       int nr_subdiv_;
 
       /** \brief Placeholder for a point's PFHRGB signature. */
       Eigen::VectorXf pfhrgb_histogram_;
 
-      /** \brief Placeholder for a PFHRGB 7-tuple. */
-      Eigen::VectorXf pfhrgb_tuple_;
-
-      /** \brief Placeholder for a histogram index. */
-      int f_index_[7];
-
       /** \brief Float constant = 1.0 / (2.0 * M_PI) */
       float d_pi_;
+
+      /** \brief Internal bounded memo of the geometric pair features. */
+      PairFeatureCache feature_cache_;
+
+      /** \brief Maximum number of pairs held by the internal cache. */
+      unsigned int max_cache_size_;
+
+      /** \brief Set to true to use the internal cache for removing redundant computations. */
+      bool use_cache_;
   };
 }
 
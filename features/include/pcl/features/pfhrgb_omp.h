@@ -0,0 +1,107 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2019-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <pcl/features/feature.h>
+#include <pcl/features/pfhrgb.h>
+
+namespace pcl
+{
+  /** \brief PFHRGBEstimationOMP estimates the PFHRGB descriptor (Point Feature Histograms extended with color
+    * ratios) for a given point cloud dataset containing points, colors and normals, in parallel, using the
+    * OpenMP standard. When the internal cache is enabled, every thread memoizes the geometric pair features in
+    * its own bounded \ref PairFeatureCache, holding at most getMaximumCacheSize () / number of threads pairs.
+    *
+    * \attention
+    * If a query point's nearest neighbors cannot be estimated, or the point doesn't have finite 3D
+    * coordinates, its PFHRGB feature is set to NaN (not a number).
+    *
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointNT, typename PointOutT = pcl::PFHRGBSignature250>
+  class PFHRGBEstimationOMP : public PFHRGBEstimation<PointInT, PointNT, PointOutT>
+  {
+    public:
+      using Ptr = boost::shared_ptr<PFHRGBEstimationOMP<PointInT, PointNT, PointOutT> >;
+      using ConstPtr = boost::shared_ptr<const PFHRGBEstimationOMP<PointInT, PointNT, PointOutT> >;
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::getClassName;
+      using Feature<PointInT, PointOutT>::indices_;
+      using Feature<PointInT, PointOutT>::k_;
+      using Feature<PointInT, PointOutT>::search_parameter_;
+      using Feature<PointInT, PointOutT>::input_;
+      using Feature<PointInT, PointOutT>::surface_;
+      using FeatureFromNormals<PointInT, PointNT, PointOutT>::normals_;
+      using PFHRGBEstimation<PointInT, PointNT, PointOutT>::nr_subdiv_;
+      using PFHRGBEstimation<PointInT, PointNT, PointOutT>::max_cache_size_;
+      using PFHRGBEstimation<PointInT, PointNT, PointOutT>::use_cache_;
+
+      using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      PFHRGBEstimationOMP (unsigned int nr_threads = 0)
+      {
+        feature_name_ = "PFHRGBEstimationOMP";
+
+        setNumberOfThreads (nr_threads);
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+    protected:
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+    private:
+      /** \brief Estimate the PFHRGB descriptors at a set of points given by <setInputCloud (), setIndices ()>
+        * using the surface in setSearchSurface () and the spatial locator in setSearchMethod ()
+        * \param[out] output the resultant point cloud model dataset that contains the PFHRGB feature estimates
+        */
+      void
+      computeFeature (PointCloudOut &output) override;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/pfhrgb_omp.hpp>
+#endif
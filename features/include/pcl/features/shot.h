@@ -42,8 +42,53 @@
 #include <pcl/point_types.h>
 #include <pcl/features/feature.h>
 
+#include <cstddef>
+
 namespace pcl
 {
+  namespace detail
+  {
+    /** \brief A block of SHOT neighbors expressed in the local reference frame, together with the
+      * spatial votes each of them casts in the quadrilinear interpolation: the volume (out of the
+      * 32 volumes of the SHOT grid) it falls into, with its weight, and the adjacent volume along
+      * the radial, inclination and azimuth directions, with the weight interpolated towards it.
+      * A neighbor without an adjacent vote along a direction gets its own volume and a zero weight.
+      */
+    struct SHOTVolumeVotes
+    {
+      static const std::size_t block_size = 64;
+
+      /** \brief Number of neighbors in the block. */
+      std::size_t size;
+      /** \brief Position of each neighbor in the neighborhood. */
+      int position[block_size];
+      /** \brief Coordinates in the local reference frame. */
+      float x[block_size], y[block_size], z[block_size];
+      /** \brief Distance to the center. */
+      float distance[block_size];
+
+      /** \brief Volume the neighbor falls into. */
+      int volume[block_size];
+      /** \brief Interpolation weight kept by that volume. */
+      float volume_weight[block_size];
+      /** \brief Adjacent radial, inclination and azimuth volumes. */
+      int neighbor_volume[3][block_size];
+      /** \brief Interpolation weights given to the adjacent volumes. */
+      float neighbor_weight[3][block_size];
+    };
+
+    /** \brief Compute the spatial votes of a block of SHOT neighbors, several neighbors at a time
+      * when SSE or AVX is available. The angles are evaluated in single precision with polynomial
+      * approximations, so the weights match the double precision reference to about 1e-6.
+      * \param[in] radius1_4 a quarter of the support radius
+      * \param[in] radius1_2 half of the support radius
+      * \param[in] radius3_4 three quarters of the support radius
+      * \param[in,out] votes the neighbors in the block, and their resultant votes
+      */
+    PCL_EXPORTS void
+    computeSHOTVolumeVotes (float radius1_4, float radius1_2, float radius3_4, SHOTVolumeVotes &votes);
+  }
+
   /** \brief SHOTEstimation estimates the Signature of Histograms of OrienTations (SHOT) descriptor for
     * a given point cloud dataset containing points and normals.
     *
@@ -148,6 +193,38 @@ namespace pcl
                                 const int nr_bins,
                                 Eigen::VectorXf &shot);
 
+      /** \brief Express the next block of neighbors with a finite bin distance in the local reference frame,
+        * and compute their spatial votes.
+        * \param[in] indices the neighborhood point indices
+        * \param[in] sqr_dists the neighborhood point distances
+        * \param[in] index the index of the point in indices_
+        * \param[in] binDistance the distance histogram, neighbors with a NaN entry are skipped
+        * \param[in] begin the position of the first neighbor to consider
+        * \param[out] votes the resultant block of votes
+        * \return the position following the last neighbor considered
+        */
+      std::size_t
+      computeVolumeVotes (const std::vector<int> &indices,
+                          const std::vector<float> &sqr_dists,
+                          const int index,
+                          const std::vector<double> &binDistance,
+                          std::size_t begin,
+                          detail::SHOTVolumeVotes &votes);
+
+      /** \brief Scatter a block of votes into one channel of the SHOT histogram.
+        * \param[in] votes the block of votes
+        * \param[in] binDistance the distance histogram of the channel
+        * \param[in] nr_bins the number of bins in the channel histogram
+        * \param[in] offset the position of the channel in the SHOT histogram
+        * \param[in,out] shot the SHOT histogram
+        */
+      void
+      addVolumeVotes (const detail::SHOTVolumeVotes &votes,
+                      const std::vector<double> &binDistance,
+                      const int nr_bins,
+                      const int offset,
+                      Eigen::VectorXf &shot) const;
+
       /** \brief Normalize the SHOT histogram.
         * \param[in,out] shot the SHOT histogram
         * \param[in] desc_length the length of the histogram
@@ -317,6 +394,8 @@ namespace pcl
       using SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::radius1_2_;
       using SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::maxAngularSectors_;
       using SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::interpolateSingleChannel;
+      using SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::computeVolumeVotes;
+      using SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::addVolumeVotes;
       using SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::shot_;
       using FeatureWithLocalReferenceFrames<PointInT, PointRFT>::frames_;
 
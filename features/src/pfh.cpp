@@ -38,7 +38,12 @@
 
 #include <pcl/features/pfh_tools.h>
 #include <pcl/features/impl/pfh.hpp>
+#include <pcl/features/impl/pfh_omp.hpp>
 #include <pcl/features/impl/pfhrgb.hpp>
+#include <pcl/features/impl/pfhrgb_omp.hpp>
+
+#include <algorithm>
+#include <cstdint>
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 bool
@@ -151,6 +156,16 @@ pcl::computeRGBPairFeatures (const Eigen::Vector4f &p1, const Eigen::Vector4f &n
 
   // everything before was standard 4D-Darboux frame feature pair
   // now, for the experimental color stuff
+  computeRGBPairRatios (colors1, colors2, f5, f6, f7);
+
+  return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::computeRGBPairRatios (const Eigen::Vector4i &colors1, const Eigen::Vector4i &colors2,
+                           float &f5, float &f6, float &f7)
+{
   f5 = (colors2[0] != 0) ? static_cast<float> (colors1[0]) / colors2[0] : 1.0f;
   f6 = (colors2[1] != 0) ? static_cast<float> (colors1[1]) / colors2[1] : 1.0f;
   f7 = (colors2[2] != 0) ? static_cast<float> (colors1[2]) / colors2[2] : 1.0f;
@@ -159,8 +174,138 @@ pcl::computeRGBPairFeatures (const Eigen::Vector4f &p1, const Eigen::Vector4f &n
   if (f5 > 1.0f) f5 = - 1.0f / f5;
   if (f6 > 1.0f) f6 = - 1.0f / f6;
   if (f7 > 1.0f) f7 = - 1.0f / f7;
+}
 
-  return (true);
+//////////////////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+  /** \brief Number of consecutive slots probed for a pair before it evicts its home slot. */
+  const std::size_t pair_cache_max_probes = 8;
+  /** \brief Initial table size, grown by doubling until the maximum number of pairs is reached. */
+  const std::size_t pair_cache_initial_slots = 1024;
+}
+
+pcl::PairFeatureCache::PairFeatureCache (std::size_t max_entries)
+  : size_ (0)
+  , max_entries_ (0)
+  , max_slots_ (0)
+{
+  setMaximumSize (max_entries);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PairFeatureCache::setMaximumSize (std::size_t max_entries)
+{
+  max_entries_ = max_entries;
+  max_slots_ = 0;
+  if (max_entries > 0)
+  {
+    max_slots_ = 1;
+    while (max_slots_ < max_entries)
+      max_slots_ <<= 1;
+  }
+  entries_.clear ();
+  size_ = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PairFeatureCache::clear ()
+{
+  entries_.clear ();
+  size_ = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::PairFeatureCache::slot (int p_idx, int q_idx) const
+{
+  // Fibonacci hashing of the packed index pair
+  const std::uint64_t key = (static_cast<std::uint64_t> (static_cast<std::uint32_t> (p_idx)) << 32) |
+                            static_cast<std::uint32_t> (q_idx);
+  return (static_cast<std::size_t> ((key * 0x9E3779B97F4A7C15ull) >> 32) & (entries_.size () - 1));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::PairFeatureCache::find (int p_idx, int q_idx, Eigen::Vector4f &features) const
+{
+  if (entries_.empty ())
+    return (false);
+
+  const std::size_t mask = entries_.size () - 1;
+  std::size_t s = slot (p_idx, q_idx);
+  for (std::size_t probe = 0; probe < pair_cache_max_probes; ++probe, s = (s + 1) & mask)
+  {
+    const Entry &entry = entries_[s];
+    if (entry.p_idx == -1)
+      return (false);
+    if (entry.p_idx == p_idx && entry.q_idx == q_idx)
+    {
+      features = Eigen::Vector4f (entry.features[0], entry.features[1], entry.features[2], entry.features[3]);
+      return (true);
+    }
+  }
+  return (false);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PairFeatureCache::grow ()
+{
+  std::vector<Entry> old_entries;
+  old_entries.swap (entries_);
+  const Entry empty = {-1, -1, {0.0f, 0.0f, 0.0f, 0.0f}};
+  entries_.assign (old_entries.empty () ? std::min (pair_cache_initial_slots, max_slots_) : 2 * old_entries.size (), empty);
+  size_ = 0;
+  for (const Entry &entry : old_entries)
+    if (entry.p_idx != -1)
+      insert (entry.p_idx, entry.q_idx, Eigen::Vector4f (entry.features[0], entry.features[1], entry.features[2], entry.features[3]));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PairFeatureCache::insert (int p_idx, int q_idx, const Eigen::Vector4f &features)
+{
+  if (max_slots_ == 0)
+    return;
+  // Keep the load factor below 1/2 while the table may still grow
+  if (entries_.empty () || (2 * (size_ + 1) > entries_.size () && entries_.size () < max_slots_))
+    grow ();
+
+  const std::size_t mask = entries_.size () - 1;
+  const std::size_t home = slot (p_idx, q_idx);
+  // If all probed slots are taken by other pairs, or the maximum number of pairs is reached, the pair in
+  // the home slot is evicted
+  std::size_t target = home;
+  std::size_t s = home;
+  for (std::size_t probe = 0; probe < pair_cache_max_probes; ++probe, s = (s + 1) & mask)
+  {
+    if (entries_[s].p_idx == -1)
+    {
+      if (size_ < max_entries_)
+      {
+        ++size_;
+        target = s;
+      }
+      // A full cache has nothing to evict if the home slot is empty, the pair is not stored
+      else if (s == home)
+        return;
+      break;
+    }
+    if (entries_[s].p_idx == p_idx && entries_[s].q_idx == q_idx)
+    {
+      target = s;
+      break;
+    }
+  }
+
+  Entry &entry = entries_[target];
+  entry.p_idx = p_idx;
+  entry.q_idx = q_idx;
+  for (int d = 0; d < 4; ++d)
+    entry.features[d] = features[d];
 }
 
 #ifndef PCL_NO_PRECOMPILE
@@ -169,14 +314,22 @@ pcl::computeRGBPairFeatures (const Eigen::Vector4f &p1, const Eigen::Vector4f &n
 // Instantiations of specific point types
 #ifdef PCL_ONLY_CORE_POINT_TYPES
   PCL_INSTANTIATE_PRODUCT(PFHEstimation, ((pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGB)(pcl::PointXYZRGBA))((pcl::Normal))((pcl::PFHSignature125)))
+  PCL_INSTANTIATE_PRODUCT(PFHEstimationOMP, ((pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGB)(pcl::PointXYZRGBA))((pcl::Normal))((pcl::PFHSignature125)))
   PCL_INSTANTIATE_PRODUCT(PFHRGBEstimation, ((pcl::PointXYZRGBA)(pcl::PointXYZRGB)(pcl::PointXYZRGBNormal))
                           ((pcl::Normal)(pcl::PointXYZRGBNormal))
                           ((pcl::PFHRGBSignature250)))
+  PCL_INSTANTIATE_PRODUCT(PFHRGBEstimationOMP, ((pcl::PointXYZRGBA)(pcl::PointXYZRGB)(pcl::PointXYZRGBNormal))
+                             ((pcl::Normal)(pcl::PointXYZRGBNormal))
+                             ((pcl::PFHRGBSignature250)))
 #else
   PCL_INSTANTIATE_PRODUCT(PFHEstimation, (PCL_XYZ_POINT_TYPES)(PCL_NORMAL_POINT_TYPES)((pcl::PFHSignature125)))
+  PCL_INSTANTIATE_PRODUCT(PFHEstimationOMP, (PCL_XYZ_POINT_TYPES)(PCL_NORMAL_POINT_TYPES)((pcl::PFHSignature125)))
   PCL_INSTANTIATE_PRODUCT(PFHRGBEstimation, ((pcl::PointXYZRGB)(pcl::PointXYZRGBA)(pcl::PointXYZRGBNormal))
                           (PCL_NORMAL_POINT_TYPES)
                           ((pcl::PFHRGBSignature250)))
+  PCL_INSTANTIATE_PRODUCT(PFHRGBEstimationOMP, ((pcl::PointXYZRGB)(pcl::PointXYZRGBA)(pcl::PointXYZRGBNormal))
+                             (PCL_NORMAL_POINT_TYPES)
+                             ((pcl::PFHRGBSignature250)))
 #endif
 #endif    // PCL_NO_PRECOMPILE
 
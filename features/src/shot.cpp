@@ -38,6 +38,165 @@
 
 #include <pcl/features/impl/shot.hpp>
 #include <pcl/features/impl/shot_omp.hpp>
+#include <pcl/common/simd_ops.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+#if defined (__SSE2__)
+  using pcl::detail::SSEOps;
+#endif
+#if defined (__AVX__)
+  using pcl::detail::AVXOps;
+#endif
+  using pcl::detail::atan2Positive;
+
+  const float quarter_pi = static_cast<float> (M_PI / 4.0);
+  const float half_pi = static_cast<float> (M_PI / 2.0);
+  const float three_quarter_pi = static_cast<float> (3.0 * M_PI / 4.0);
+  const float azimuth_start = static_cast<float> (-7.0 * M_PI / 8.0);
+
+  /** \brief Votes of Ops::width neighbors starting at i, following the scalar interpolation in computeVolumeVotes. */
+  template <typename Ops> inline void
+  volumeVotesLanes (std::size_t i, float radius1_4, float radius1_2, float radius3_4, pcl::detail::SHOTVolumeVotes &votes)
+  {
+    using Vec = typename Ops::Vec;
+    const Vec zero = Ops::set1 (0.0f);
+    const Vec one = Ops::set1 (1.0f);
+
+    const Vec x = Ops::load (votes.x + i), y = Ops::load (votes.y + i), z = Ops::load (votes.z + i);
+    const Vec distance = Ops::load (votes.distance + i);
+    const Vec ax = Ops::abs (x), ay = Ops::abs (y);
+
+    // Azimuth sector (8 of them, halved), elevation half and radial shell
+    const Vec x_pos = Ops::gt (x, zero), x_neg = Ops::lt (x, zero), x_zero = Ops::eq (x, zero);
+    const Vec y_pos = Ops::gt (y, zero), y_neg = Ops::lt (y, zero), y_zero = Ops::eq (y, zero);
+    const Vec bit4 = Ops::orMask (y_pos, Ops::andMask (y_zero, x_neg));
+    const Vec bit3 = Ops::xorMask (Ops::orMask (x_pos, Ops::andMask (x_zero, y_pos)), bit4);
+    const Vec same_sign = Ops::orMask (Ops::andMask (x_pos, y_pos), Ops::andMask (x_neg, y_neg));
+    const Vec second_half = Ops::select (Ops::orMask (same_sign, x_zero), Ops::lt (ax, ay), Ops::gt (ax, ay));
+    const Vec sector = Ops::add (Ops::add (Ops::andMask (bit4, Ops::set1 (4.0f)), Ops::andMask (bit3, Ops::set1 (2.0f))),
+                                 Ops::andMask (second_half, one));
+    const Vec upper = Ops::gt (z, zero);
+    const Vec outer = Ops::gt (distance, Ops::set1 (radius1_2));
+    const Vec volume = Ops::add (Ops::add (Ops::mul (sector, Ops::set1 (4.0f)), Ops::andMask (upper, one)),
+                                 Ops::andMask (outer, Ops::set1 (2.0f)));
+
+    // Distance: the outermost and innermost shells keep their whole vote, the two middle ones share it
+    const Vec radial_distance = Ops::div (Ops::sub (distance, Ops::select (outer, Ops::set1 (radius3_4), Ops::set1 (radius1_4))),
+                                          Ops::set1 (radius1_2));
+    const Vec radial_alone = Ops::select (outer, Ops::gt (distance, Ops::set1 (radius3_4)), Ops::lt (distance, Ops::set1 (radius1_4)));
+    const Vec radial_weight = Ops::select (Ops::xorMask (outer, radial_alone),
+                                           Ops::add (one, radial_distance), Ops::sub (one, radial_distance));
+    const Vec radial_vote = Ops::andNotMask (radial_alone, Ops::sub (one, radial_weight));
+    const Vec radial_volume = Ops::select (outer, Ops::sub (volume, Ops::set1 (2.0f)), Ops::add (volume, Ops::set1 (2.0f)));
+
+    // Inclination: acos (z / distance)
+    const Vec planar = Ops::sqrt (Ops::max (Ops::sub (Ops::mul (distance, distance), Ops::mul (z, z)), zero));
+    const Vec inclination = atan2Positive<Ops> (planar, z);
+    const Vec lower = Ops::le (z, zero);
+    const Vec inclination_distance = Ops::div (Ops::sub (inclination, Ops::select (lower, Ops::set1 (three_quarter_pi), Ops::set1 (quarter_pi))),
+                                               Ops::set1 (half_pi));
+    const Vec inclination_alone = Ops::select (lower, Ops::gt (inclination, Ops::set1 (three_quarter_pi)),
+                                               Ops::lt (inclination, Ops::set1 (quarter_pi)));
+    const Vec inclination_weight = Ops::select (Ops::xorMask (lower, inclination_alone),
+                                                Ops::add (one, inclination_distance), Ops::sub (one, inclination_distance));
+    const Vec inclination_vote = Ops::andNotMask (inclination_alone, Ops::sub (one, inclination_weight));
+    const Vec inclination_volume = Ops::select (lower, Ops::add (volume, one), Ops::sub (volume, one));
+
+    // Azimuth: atan2 (y, x), relative to the center of the sector
+    const Vec has_azimuth = Ops::andNotMask (Ops::andMask (x_zero, y_zero), Ops::eq (zero, zero));
+    Vec azimuth = atan2Positive<Ops> (ay, x);
+    azimuth = Ops::select (y_neg, Ops::sub (zero, azimuth), azimuth);
+    Vec azimuth_distance = Ops::div (Ops::sub (azimuth, Ops::add (Ops::set1 (azimuth_start), Ops::mul (sector, Ops::set1 (quarter_pi)))),
+                                     Ops::set1 (quarter_pi));
+    azimuth_distance = Ops::max (Ops::set1 (-0.5f), Ops::min (azimuth_distance, Ops::set1 (0.5f)));
+    const Vec azimuth_vote = Ops::andMask (has_azimuth, Ops::abs (azimuth_distance));
+    const Vec azimuth_weight = Ops::andMask (has_azimuth, Ops::sub (one, azimuth_vote));
+    Vec azimuth_volume = Ops::select (Ops::gt (azimuth_distance, zero), Ops::add (volume, Ops::set1 (4.0f)), Ops::sub (volume, Ops::set1 (4.0f)));
+    azimuth_volume = Ops::select (Ops::ge (azimuth_volume, Ops::set1 (32.0f)), Ops::sub (azimuth_volume, Ops::set1 (32.0f)), azimuth_volume);
+    azimuth_volume = Ops::select (Ops::lt (azimuth_volume, zero), Ops::add (azimuth_volume, Ops::set1 (32.0f)), azimuth_volume);
+    azimuth_volume = Ops::select (has_azimuth, azimuth_volume, volume);
+
+    Ops::storeInt (votes.volume + i, volume);
+    Ops::store (votes.volume_weight + i, Ops::add (Ops::add (radial_weight, inclination_weight), azimuth_weight));
+    Ops::storeInt (votes.neighbor_volume[0] + i, Ops::select (radial_alone, volume, radial_volume));
+    Ops::store (votes.neighbor_weight[0] + i, radial_vote);
+    Ops::storeInt (votes.neighbor_volume[1] + i, Ops::select (inclination_alone, volume, inclination_volume));
+    Ops::store (votes.neighbor_weight[1] + i, inclination_vote);
+    Ops::storeInt (votes.neighbor_volume[2] + i, azimuth_volume);
+    Ops::store (votes.neighbor_weight[2] + i, azimuth_vote);
+  }
+
+  /** \brief Votes of the neighbor at i, with the same formulas as volumeVotesLanes. */
+  inline void
+  volumeVotesScalar (std::size_t i, float radius1_4, float radius1_2, float radius3_4, pcl::detail::SHOTVolumeVotes &votes)
+  {
+    const float x = votes.x[i], y = votes.y[i], z = votes.z[i];
+    const float distance = votes.distance[i];
+
+    const bool bit4 = (y > 0) || ((y == 0) && (x < 0));
+    const bool bit3 = ((x > 0) || ((x == 0) && (y > 0))) != bit4;
+    bool second_half;
+    if ((x > 0 && y > 0) || (x < 0 && y < 0) || (x == 0))
+      second_half = std::abs (x) < std::abs (y);
+    else
+      second_half = std::abs (x) > std::abs (y);
+    const int sector = (bit4 ? 4 : 0) + (bit3 ? 2 : 0) + (second_half ? 1 : 0);
+    const bool outer = distance > radius1_2;
+    const int volume = sector * 4 + (z > 0 ? 1 : 0) + (outer ? 2 : 0);
+    votes.volume[i] = volume;
+
+    float weight = 0;
+    const float radial_distance = (distance - (outer ? radius3_4 : radius1_4)) / radius1_2;
+    const bool radial_alone = outer ? (distance > radius3_4) : (distance < radius1_4);
+    const float radial_weight = (outer != radial_alone) ? 1 + radial_distance : 1 - radial_distance;
+    weight += radial_weight;
+    votes.neighbor_volume[0][i] = radial_alone ? volume : (outer ? volume - 2 : volume + 2);
+    votes.neighbor_weight[0][i] = radial_alone ? 0.0f : 1 - radial_weight;
+
+    const float inclination = std::acos (std::min (std::max (z / distance, -1.0f), 1.0f));
+    const bool lower = z <= 0;
+    const float inclination_distance = (inclination - (lower ? three_quarter_pi : quarter_pi)) / half_pi;
+    const bool inclination_alone = lower ? (inclination > three_quarter_pi) : (inclination < quarter_pi);
+    const float inclination_weight = (lower != inclination_alone) ? 1 + inclination_distance : 1 - inclination_distance;
+    weight += inclination_weight;
+    votes.neighbor_volume[1][i] = inclination_alone ? volume : (lower ? volume + 1 : volume - 1);
+    votes.neighbor_weight[1][i] = inclination_alone ? 0.0f : 1 - inclination_weight;
+
+    votes.neighbor_volume[2][i] = volume;
+    votes.neighbor_weight[2][i] = 0.0f;
+    if (x != 0 || y != 0)
+    {
+      float azimuth_distance = (std::atan2 (y, x) - (azimuth_start + quarter_pi * static_cast<float> (sector))) / quarter_pi;
+      azimuth_distance = std::max (-0.5f, std::min (azimuth_distance, 0.5f));
+      weight += 1 - std::abs (azimuth_distance);
+      votes.neighbor_volume[2][i] = (volume + (azimuth_distance > 0 ? 4 : 28)) % 32;
+      votes.neighbor_weight[2][i] = std::abs (azimuth_distance);
+    }
+    votes.volume_weight[i] = weight;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::detail::computeSHOTVolumeVotes (float radius1_4, float radius1_2, float radius3_4, SHOTVolumeVotes &votes)
+{
+  std::size_t i = 0;
+#if defined (__AVX__)
+  for (; i + AVXOps::width <= votes.size; i += AVXOps::width)
+    volumeVotesLanes<AVXOps> (i, radius1_4, radius1_2, radius3_4, votes);
+#endif
+#if defined (__SSE2__)
+  for (; i + SSEOps::width <= votes.size; i += SSEOps::width)
+    volumeVotesLanes<SSEOps> (i, radius1_4, radius1_2, radius3_4, votes);
+#endif
+  for (; i < votes.size; ++i)
+    volumeVotesScalar (i, radius1_4, radius1_2, radius3_4, votes);
+}
+
 
 #ifndef PCL_NO_PRECOMPILE
 #include <pcl/point_types.h>
@@ -61,10 +61,28 @@ namespace pcl
       HIGH_RES_OFFLINE_COMPRESSION_WITHOUT_COLOR,
       HIGH_RES_OFFLINE_COMPRESSION_WITH_COLOR,
 
+      LOW_RES_ONLINE_COMPRESSION_WITHOUT_COLOR_RANS,
+      LOW_RES_ONLINE_COMPRESSION_WITH_COLOR_RANS,
+
+      MED_RES_ONLINE_COMPRESSION_WITHOUT_COLOR_RANS,
+      MED_RES_ONLINE_COMPRESSION_WITH_COLOR_RANS,
+
+      HIGH_RES_ONLINE_COMPRESSION_WITHOUT_COLOR_RANS,
+      HIGH_RES_ONLINE_COMPRESSION_WITH_COLOR_RANS,
+
       COMPRESSION_PROFILE_COUNT,
       MANUAL_CONFIGURATION
     };
 
+    // entropy coder applied to the encoded data vectors
+    enum entropy_Coders_e
+    {
+      // byte-at-a-time static range coder, the format of all frames written before rANS coding was added
+      RANGE_CODER,
+      // interleaved rANS coder with adaptive models, coding the octree structure in context of its neighbors
+      RANS_CODER
+    };
+
     // compression configuration profile
     struct configurationProfile_t
     {
@@ -74,6 +92,7 @@ namespace pcl
       unsigned int iFrameRate;
       const unsigned char colorBitResolution;
       bool doColorEncoding;
+      entropy_Coders_e entropyCoder;
     };
 
     // predefined configuration parameters
@@ -85,7 +104,8 @@ namespace pcl
        true, /* doVoxelGridDownDownSampling = */
        50, /* iFrameRate = */
        4, /* colorBitResolution = */
-       false /* doColorEncoding = */
+       false, /* doColorEncoding = */
+       RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: LOW_RES_ONLINE_COMPRESSION_WITH_COLOR
         0.01, /* pointResolution = */
@@ -93,7 +113,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         50, /* iFrameRate = */
         4, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: MED_RES_ONLINE_COMPRESSION_WITHOUT_COLOR
         0.005, /* pointResolution = */
@@ -101,7 +122,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         40, /* iFrameRate = */
         5, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+       RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: MED_RES_ONLINE_COMPRESSION_WITH_COLOR
         0.005, /* pointResolution = */
@@ -109,7 +131,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         40, /* iFrameRate = */
         5, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: HIGH_RES_ONLINE_COMPRESSION_WITHOUT_COLOR
         0.0001, /* pointResolution = */
@@ -117,7 +140,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         30, /* iFrameRate = */
         7, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+       RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: HIGH_RES_ONLINE_COMPRESSION_WITH_COLOR
         0.0001, /* pointResolution = */
@@ -125,7 +149,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         30, /* iFrameRate = */
         7, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: LOW_RES_OFFLINE_COMPRESSION_WITHOUT_COLOR
         0.01, /* pointResolution = */
@@ -133,7 +158,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         4, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+       RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: LOW_RES_OFFLINE_COMPRESSION_WITH_COLOR
         0.01, /* pointResolution = */
@@ -141,7 +167,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         4, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: MED_RES_OFFLINE_COMPRESSION_WITHOUT_COLOR
         0.005, /* pointResolution = */
@@ -149,7 +176,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         5, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+       RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: MED_RES_OFFLINE_COMPRESSION_WITH_COLOR
         0.005, /* pointResolution = */
@@ -157,7 +185,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         5, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: HIGH_RES_OFFLINE_COMPRESSION_WITHOUT_COLOR
         0.0001, /* pointResolution = */
@@ -165,7 +194,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         8, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+       RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: HIGH_RES_OFFLINE_COMPRESSION_WITH_COLOR
         0.0001, /* pointResolution = */
@@ -173,8 +203,67 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         8, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        RANGE_CODER /* entropyCoder = */
+    }, {
+    // PROFILE: LOW_RES_ONLINE_COMPRESSION_WITHOUT_COLOR_RANS
+       0.01, /* pointResolution = */
+       0.01, /* octreeResolution = */
+       true, /* doVoxelGridDownDownSampling = */
+       50, /* iFrameRate = */
+       4, /* colorBitResolution = */
+       false, /* doColorEncoding = */
+       RANS_CODER /* entropyCoder = */
+    }, {
+    // PROFILE: LOW_RES_ONLINE_COMPRESSION_WITH_COLOR_RANS
+        0.01, /* pointResolution = */
+        0.01, /* octreeResolution = */
+        true, /* doVoxelGridDownDownSampling = */
+        50, /* iFrameRate = */
+        4, /* colorBitResolution = */
+        true, /* doColorEncoding = */
+        RANS_CODER /* entropyCoder = */
+    }, {
+    // PROFILE: MED_RES_ONLINE_COMPRESSION_WITHOUT_COLOR_RANS
+        0.005, /* pointResolution = */
+        0.01, /* octreeResolution = */
+        false, /* doVoxelGridDownDownSampling = */
+        40, /* iFrameRate = */
+        5, /* colorBitResolution = */
+        false, /* doColorEncoding = */
+       RANS_CODER /* entropyCoder = */
+    }, {
+    // PROFILE: MED_RES_ONLINE_COMPRESSION_WITH_COLOR_RANS
+        0.005, /* pointResolution = */
+        0.01, /* octreeResolution = */
+        false, /* doVoxelGridDownDownSampling = */
+        40, /* iFrameRate = */
+        5, /* colorBitResolution = */
+        true, /* doColorEncoding = */
+        RANS_CODER /* entropyCoder = */
+    }, {
+    // PROFILE: HIGH_RES_ONLINE_COMPRESSION_WITHOUT_COLOR_RANS
+        0.0001, /* pointResolution = */
+        0.01, /* octreeResolution = */
+        false, /* doVoxelGridDownDownSampling = */
+        30, /* iFrameRate = */
+        7, /* colorBitResolution = */
+        false, /* doColorEncoding = */
+       RANS_CODER /* entropyCoder = */
+    }, {
+    // PROFILE: HIGH_RES_ONLINE_COMPRESSION_WITH_COLOR_RANS
+        0.0001, /* pointResolution = */
+        0.01, /* octreeResolution = */
+        false, /* doVoxelGridDownDownSampling = */
+        30, /* iFrameRate = */
+        7, /* colorBitResolution = */
+        true, /* doColorEncoding = */
+        RANS_CODER /* entropyCoder = */
     }};
 
+    // version of the block frame format written when a frame is split into spatial blocks that are
+    // coded in parallel; the single stream frame format used by the profiles above is unversioned
+    const unsigned char octreeBlockFrameVersion_ = 1;
+
   }
 }
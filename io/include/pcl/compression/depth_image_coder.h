@@ -0,0 +1,217 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <pcl/pcl_macros.h>
+#include <pcl/common/common.h>
+
+#include <thread>
+#include <vector>
+
+namespace pcl
+{
+  namespace io
+  {
+    /** \brief Predictive coder of 16-bit depth images, after LOCO-I (JPEG-LS).
+      *
+      * Every pixel is predicted from its left, upper and upper left neighbors by the
+      * median edge detector and the prediction residual is Golomb-Rice coded under one of
+      * 365 contexts, which quantize the local gradients and adapt the Golomb parameter and
+      * a bias correction to the image. Flat areas, such as the invalid (zero) pixels around
+      * objects, are coded in run mode at a fraction of a bit per pixel.
+      *
+      * The image is cut into horizontal strips of rows that are coded independently, so
+      * they can be encoded and decoded in parallel (see \ref setNumberOfThreads).
+      *
+      * With a maximum error of 0 (default) the coding is lossless. A larger maximum error
+      * N selects near-lossless coding, where every decoded depth differs from the encoded
+      * one by at most N. Zero depths mark invalid pixels and are always kept: invalid
+      * pixels decode to zero and valid pixels to nonzero depths, which may cost an error of
+      * up to 2N for depths below N.
+      *
+      * \ingroup io
+      */
+    class PCL_EXPORTS DepthImageCoder
+    {
+      public:
+        /** \brief Constructor.
+          * \param max_error_arg: maximum absolute error of decoded depths, 0 for lossless coding
+          * \param nr_strips_arg: number of independently coded strips of rows
+          */
+        DepthImageCoder (unsigned int max_error_arg = 0, unsigned int nr_strips_arg = 8)
+          : max_error_ (0)
+          , nr_strips_ (1)
+          , threads_ (1)
+        {
+          setMaxError (max_error_arg);
+          setNumberOfStrips (nr_strips_arg);
+        }
+
+        /** \brief Set the maximum absolute error of decoded depths
+          * \param max_error_arg: maximum error, 0 for lossless coding
+          */
+        inline void
+        setMaxError (unsigned int max_error_arg)
+        {
+          max_error_ = max_error_arg < max_error_limit_ ? max_error_arg : max_error_limit_;
+        }
+
+        /** \brief Get the maximum absolute error of decoded depths */
+        inline unsigned int
+        getMaxError () const
+        {
+          return (max_error_);
+        }
+
+        /** \brief Set the number of strips of rows an image is cut into
+          * \note More strips allow more threads to work on an image, but every strip has to
+          * learn its statistics from scratch. Images with fewer rows use one strip per row.
+          * \param nr_strips_arg: number of strips
+          */
+        inline void
+        setNumberOfStrips (unsigned int nr_strips_arg)
+        {
+          nr_strips_ = nr_strips_arg > 0 ? nr_strips_arg : 1;
+        }
+
+        /** \brief Get the number of strips of rows an image is cut into */
+        inline unsigned int
+        getNumberOfStrips () const
+        {
+          return (nr_strips_);
+        }
+
+        /** \brief Set the number of threads coding the strips of an image
+          * \param nr_threads_arg: number of threads, 0 uses the number of hardware threads
+          */
+        inline void
+        setNumberOfThreads (unsigned int nr_threads_arg = 0)
+        {
+          if (nr_threads_arg == 0)
+            nr_threads_arg = std::thread::hardware_concurrency ();
+          threads_ = nr_threads_arg > 0 ? nr_threads_arg : 1;
+        }
+
+        /** \brief Get the number of threads coding the strips of an image */
+        inline unsigned int
+        getNumberOfThreads () const
+        {
+          return (threads_);
+        }
+
+        /** \brief Encode a depth image
+          * \param[in] image_arg: row major depth image, 0 marks invalid pixels
+          * \param[in] width_arg: image width
+          * \param[in] height_arg: image height
+          * \param[out] compressed_arg: compressed image data
+          */
+        void
+        encode (const uint16_t* image_arg,
+                uint32_t width_arg,
+                uint32_t height_arg,
+                std::vector<uint8_t>& compressed_arg) const;
+
+        /** \brief Encode a depth image
+          * \param[in] image_arg: row major depth image of width_arg * height_arg pixels, 0 marks invalid pixels
+          * \param[in] width_arg: image width
+          * \param[in] height_arg: image height
+          * \param[out] compressed_arg: compressed image data
+          */
+        inline void
+        encode (const std::vector<uint16_t>& image_arg,
+                uint32_t width_arg,
+                uint32_t height_arg,
+                std::vector<uint8_t>& compressed_arg) const
+        {
+          encode (image_arg.empty () ? nullptr : &image_arg[0], width_arg, height_arg, compressed_arg);
+        }
+
+        /** \brief Decode a depth image
+          * \note The maximum error and the strips are read from the compressed data, only the
+          * number of threads of this coder applies.
+          * \param[in] data_arg: compressed image data
+          * \param[in] size_arg: number of bytes of compressed image data
+          * \param[out] image_arg: row major depth image
+          * \param[out] width_arg: image width
+          * \param[out] height_arg: image height
+          * \return false if the data is not a valid compressed depth image
+          */
+        bool
+        decode (const uint8_t* data_arg,
+                size_t size_arg,
+                std::vector<uint16_t>& image_arg,
+                uint32_t& width_arg,
+                uint32_t& height_arg) const;
+
+        /** \brief Decode a depth image
+          * \param[in] data_arg: compressed image data
+          * \param[out] image_arg: row major depth image
+          * \param[out] width_arg: image width
+          * \param[out] height_arg: image height
+          * \return false if the data is not a valid compressed depth image
+          */
+        inline bool
+        decode (const std::vector<uint8_t>& data_arg,
+                std::vector<uint16_t>& image_arg,
+                uint32_t& width_arg,
+                uint32_t& height_arg) const
+        {
+          return (decode (data_arg.empty () ? nullptr : &data_arg[0], data_arg.size (), image_arg, width_arg, height_arg));
+        }
+
+        /** \brief Check whether data starts with the signature of a compressed depth image
+          * \param[in] data_arg: data to check
+          * \param[in] size_arg: number of bytes of data
+          */
+        static bool
+        isDepthImageStream (const uint8_t* data_arg, size_t size_arg);
+
+        /** \brief Largest supported maximum error */
+        static const unsigned int max_error_limit_ = 255;
+
+      protected:
+        /** \brief Maximum absolute error of decoded depths */
+        unsigned int max_error_;
+
+        /** \brief Number of strips of rows an image is cut into */
+        unsigned int nr_strips_;
+
+        /** \brief Number of threads coding the strips of an image */
+        unsigned int threads_;
+    };
+  }
+}
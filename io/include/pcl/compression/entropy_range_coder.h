@@ -183,6 +183,221 @@ namespace pcl
       std::vector<char> outputCharVector_;
 
   };
+
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  /** \brief @b InterleavedRANSCoder compression class
+   *  \note This class provides range asymmetric numeral system (rANS) coding with adaptive, table based symbol models.
+   *  \note Four rANS states are interleaved, so consecutive symbols are decoded without depending on each other, and
+   *  \note symbols are decoded with a single table lookup. Octree occupancy bytes can additionally be coded with
+   *  \note contexts derived from the tree structure, which requires the depth of the serialized octree.
+   */
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  class InterleavedRANSCoder
+  {
+    public:
+      /** \brief Empty constructor. */
+      InterleavedRANSCoder ()
+      {
+      }
+
+      /** \brief Empty deconstructor. */
+      virtual
+      ~InterleavedRANSCoder ()
+      {
+      }
+
+      /** \brief Encode integer vector to output stream
+        * \param[in] inputIntVector_arg input vector
+        * \param[out] outputByteStream_arg output stream containing compressed data
+        * \return amount of bytes written to output stream
+        */
+      unsigned long
+      encodeIntVectorToStream (const std::vector<unsigned int>& inputIntVector_arg, std::ostream& outputByteStream_arg);
+
+      /** \brief Decode stream to output integer vector
+       * \param inputByteStream_arg input stream of compressed data
+       * \param outputIntVector_arg decompressed output vector, to be sized to the amount of encoded integers
+       * \return amount of bytes read from input stream
+       */
+      unsigned long
+      decodeStreamToIntVector (std::istream& inputByteStream_arg, std::vector<unsigned int>& outputIntVector_arg);
+
+      /** \brief Encode char vector to output stream
+       * \param inputByteVector_arg input vector
+       * \param outputByteStream_arg output stream containing compressed data
+       * \return amount of bytes written to output stream
+       */
+      unsigned long
+      encodeCharVectorToStream (const std::vector<char>& inputByteVector_arg, std::ostream& outputByteStream_arg);
+
+      /** \brief Decode char stream to output vector
+       * \param inputByteStream_arg input stream of compressed data
+       * \param outputByteVector_arg decompressed output vector, to be sized to the amount of encoded bytes
+       * \return amount of bytes read from input stream
+       */
+      unsigned long
+      decodeStreamToCharVector (std::istream& inputByteStream_arg, std::vector<char>& outputByteVector_arg);
+
+      /** \brief Encode the branch occupancy bytes of a serialized octree to output stream
+       * \note Every byte is coded in the context of whether its children are leaves and which of its three
+       * \note preceding face neighbors (-x, -y, -z) at the same depth are occupied.
+       * \param inputByteVector_arg occupancy bytes in depth first order, as written by serializeTree
+       * \param treeDepth_arg depth of the octree; 0 codes the bytes without structure, e.g. for XOR encoded trees
+       * \param outputByteStream_arg output stream containing compressed data
+       * \return amount of bytes written to output stream
+       */
+      unsigned long
+      encodeOccupancyVectorToStream (const std::vector<char>& inputByteVector_arg, unsigned int treeDepth_arg,
+                                     std::ostream& outputByteStream_arg);
+
+      /** \brief Decode stream to the branch occupancy bytes of a serialized octree
+       * \param inputByteStream_arg input stream of compressed data
+       * \param treeDepth_arg depth of the octree, as given to the encoder
+       * \param outputByteVector_arg decompressed output vector, to be sized to the amount of encoded bytes
+       * \return amount of bytes read from input stream
+       */
+      unsigned long
+      decodeStreamToOccupancyVector (std::istream& inputByteStream_arg, unsigned int treeDepth_arg,
+                                     std::vector<char>& outputByteVector_arg);
+
+    protected:
+      using DWord = boost::uint32_t; // 4 bytes
+
+      /** \brief Number of bits of the model probability scale */
+      static const unsigned int scale_bits_ = 14;
+
+      /** \brief Lower bound of the normalized rANS state interval */
+      static const DWord state_lower_bound_ = 1u << 23;
+
+      /** \brief Number of interleaved rANS states */
+      static const unsigned int interleave_ = 4;
+
+      /** \brief Adaptive model of byte symbol frequencies
+       * \note Symbol counts are updated with every coded symbol. The frequency and lookup tables used for coding
+       * \note are rebuilt from them in growing intervals, so they stay fixed between rebuilds.
+       */
+      struct AdaptiveModel
+      {
+        /** \brief Set the model back to uniform frequencies */
+        void
+        reset ();
+
+        /** \brief Count a coded symbol, rebuilding the tables when the interval ends */
+        inline void
+        update (uint8_t symbol_arg)
+        {
+          counts_[symbol_arg] += count_increment_;
+          total_ += count_increment_;
+          if (--until_rebuild_ == 0)
+            rebuild ();
+        }
+
+        /** \brief Rebuild frequency, cumulative frequency and lookup tables from the symbol counts */
+        void
+        rebuild ();
+
+        DWord counts_[256];
+        DWord total_;
+        DWord freq_[256];
+        DWord start_[256];
+        uint8_t lookup_[1u << scale_bits_];
+        DWord interval_;
+        DWord until_rebuild_;
+
+        static const DWord count_increment_ = 32;
+        static const DWord count_limit_ = 1u << 16;
+        static const DWord max_interval_ = 1024;
+      };
+
+      /** \brief Derives the context of every occupancy byte from the bytes preceding it in depth first order */
+      class OccupancyContext
+      {
+        public:
+          /** \brief Constructor
+           * \param treeDepth_arg depth of the octree
+           * \param children_arg buffer for the child entries of the branches, reused between streams
+           */
+          OccupancyContext (unsigned int treeDepth_arg, std::vector<int32_t>& children_arg);
+
+          /** \brief Context of the next byte, in [0, context_count_) */
+          unsigned int
+          next () const;
+
+          /** \brief Advance past the next byte, which has occupancy pattern pattern_arg */
+          void
+          push (uint8_t pattern_arg);
+
+          static const unsigned int context_count_ = 16;
+
+        private:
+          struct Branch
+          {
+            /** \brief Occupied children not visited yet */
+            uint8_t remaining;
+            unsigned int depth;
+            /** \brief Index of the branch in children_ */
+            int32_t node;
+            /** \brief Nodes of the -x, -y and -z face neighbors at the same depth, -1 if not occupied */
+            int32_t neighbors[3];
+          };
+
+          /** \brief Child entry of an occupied node without children bytes of its own */
+          static const int32_t leaf_parent_ = 0x7FFFFFFF;
+
+          unsigned int tree_depth_;
+          std::vector<Branch> branches_;
+          bool done_;
+
+          /** \brief Depth, child index and neighbors of the next byte */
+          unsigned int depth_;
+          unsigned int child_idx_;
+          int32_t neighbors_[3];
+
+          /** \brief Eight child entries per branch with branch children: node index, leaf_parent_ or -1 */
+          std::vector<int32_t>& children_;
+      };
+
+      /** \brief Context functor coding every symbol with the same model */
+      struct NoContext
+      {
+        inline unsigned int
+        next () const
+        {
+          return (0);
+        }
+
+        inline void
+        push (uint8_t)
+        {
+        }
+
+        static const unsigned int context_count_ = 1;
+      };
+
+      /** \brief Encode symbols with the models selected by context_arg and write them to the output stream */
+      template<typename ContextT> unsigned long
+      encodeSymbols (const uint8_t* symbols_arg, size_t symbolCount_arg, ContextT& context_arg,
+                     std::ostream& outputByteStream_arg);
+
+      /** \brief Decode symbols with the models selected by context_arg from the input stream */
+      template<typename ContextT> unsigned long
+      decodeSymbols (std::istream& inputByteStream_arg, uint8_t* symbols_arg, size_t symbolCount_arg,
+                     ContextT& context_arg);
+
+    private:
+      /** \brief Symbol models, one per context. */
+      std::vector<AdaptiveModel> models_;
+
+      /** \brief Vector containing compressed data. */
+      std::vector<uint8_t> outputByteVector_;
+
+      /** \brief Start and frequency of every encoded symbol. */
+      std::vector<DWord> symbolRanges_;
+
+      /** \brief Child entries of the octree branches tracked by OccupancyContext. */
+      std::vector<int32_t> occupancyChildren_;
+
+  };
 }
 
 
@@ -622,5 +622,372 @@ pcl::StaticRangeCoder::decodeStreamToCharVector (std::istream& inputByteStream_a
   return (streamByteCount);
 }
 
-#endif
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned long
+pcl::InterleavedRANSCoder::encodeIntVectorToStream (const std::vector<unsigned int>& inputIntVector_arg,
+                                                    std::ostream& outputByteStream_arg)
+{
+  // write integers as little endian base 128 varints, 7 bits per byte
+  std::vector<char> varintVector;
+  varintVector.reserve (inputIntVector_arg.size ());
+  for (unsigned int value : inputIntVector_arg)
+  {
+    while (value >= 0x80)
+    {
+      varintVector.push_back (static_cast<char> ((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    varintVector.push_back (static_cast<char> (value));
+  }
+
+  uint64_t varintVectorSize = varintVector.size ();
+  outputByteStream_arg.write (reinterpret_cast<const char*> (&varintVectorSize), sizeof(varintVectorSize));
+
+  return (sizeof(varintVectorSize) + encodeCharVectorToStream (varintVector, outputByteStream_arg));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned long
+pcl::InterleavedRANSCoder::decodeStreamToIntVector (std::istream& inputByteStream_arg,
+                                                    std::vector<unsigned int>& outputIntVector_arg)
+{
+  uint64_t varintVectorSize = 0;
+  inputByteStream_arg.read (reinterpret_cast<char*> (&varintVectorSize), sizeof(varintVectorSize));
+
+  std::vector<char> varintVector (static_cast<size_t> (varintVectorSize));
+  unsigned long streamByteCount = sizeof(varintVectorSize) + decodeStreamToCharVector (inputByteStream_arg, varintVector);
+
+  std::vector<char>::const_iterator varint_it = varintVector.begin ();
+  for (unsigned int &value : outputIntVector_arg)
+  {
+    value = 0;
+    for (unsigned int shift = 0; varint_it != varintVector.end () && shift < 32; shift += 7)
+    {
+      const uint8_t byte = static_cast<uint8_t> (*varint_it++);
+      value |= static_cast<unsigned int> (byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        break;
+    }
+  }
+
+  return (streamByteCount);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned long
+pcl::InterleavedRANSCoder::encodeCharVectorToStream (const std::vector<char>& inputByteVector_arg,
+                                                     std::ostream& outputByteStream_arg)
+{
+  NoContext context;
+  return (encodeSymbols (reinterpret_cast<const uint8_t*> (inputByteVector_arg.data ()), inputByteVector_arg.size (),
+                         context, outputByteStream_arg));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned long
+pcl::InterleavedRANSCoder::decodeStreamToCharVector (std::istream& inputByteStream_arg,
+                                                     std::vector<char>& outputByteVector_arg)
+{
+  NoContext context;
+  return (decodeSymbols (inputByteStream_arg, reinterpret_cast<uint8_t*> (outputByteVector_arg.data ()),
+                         outputByteVector_arg.size (), context));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned long
+pcl::InterleavedRANSCoder::encodeOccupancyVectorToStream (const std::vector<char>& inputByteVector_arg,
+                                                          unsigned int treeDepth_arg,
+                                                          std::ostream& outputByteStream_arg)
+{
+  if (treeDepth_arg == 0)
+    return (encodeCharVectorToStream (inputByteVector_arg, outputByteStream_arg));
+
+  OccupancyContext context (treeDepth_arg, occupancyChildren_);
+  return (encodeSymbols (reinterpret_cast<const uint8_t*> (inputByteVector_arg.data ()), inputByteVector_arg.size (),
+                         context, outputByteStream_arg));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned long
+pcl::InterleavedRANSCoder::decodeStreamToOccupancyVector (std::istream& inputByteStream_arg,
+                                                          unsigned int treeDepth_arg,
+                                                          std::vector<char>& outputByteVector_arg)
+{
+  if (treeDepth_arg == 0)
+    return (decodeStreamToCharVector (inputByteStream_arg, outputByteVector_arg));
+
+  OccupancyContext context (treeDepth_arg, occupancyChildren_);
+  return (decodeSymbols (inputByteStream_arg, reinterpret_cast<uint8_t*> (outputByteVector_arg.data ()),
+                         outputByteVector_arg.size (), context));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename ContextT> unsigned long
+pcl::InterleavedRANSCoder::encodeSymbols (const uint8_t* symbols_arg, size_t symbolCount_arg,
+                                          ContextT& context_arg, std::ostream& outputByteStream_arg)
+{
+  if (models_.size () < ContextT::context_count_)
+    models_.resize (ContextT::context_count_);
+  for (unsigned int c = 0; c < ContextT::context_count_; c++)
+    models_[c].reset ();
+
+  // adaptive models evolve in coding order, so record the range of every symbol first
+  symbolRanges_.resize (symbolCount_arg);
+  for (size_t i = 0; i < symbolCount_arg; i++)
+  {
+    AdaptiveModel& model = models_[context_arg.next ()];
+    const uint8_t symbol = symbols_arg[i];
+    symbolRanges_[i] = (model.start_[symbol] << 16) | model.freq_[symbol];
+    model.update (symbol);
+    context_arg.push (symbol);
+  }
+
+  // rANS encodes in reverse, the output bytes are reversed afterwards so the decoder reads forward
+  outputByteVector_.clear ();
+  outputByteVector_.reserve (symbolCount_arg / 2 + 4 * interleave_);
+
+  DWord states[interleave_];
+  for (unsigned int k = 0; k < interleave_; k++)
+    states[k] = state_lower_bound_;
+
+  for (size_t i = symbolCount_arg; i-- > 0;)
+  {
+    DWord& state = states[i % interleave_];
+    const DWord start = symbolRanges_[i] >> 16;
+    const DWord freq = symbolRanges_[i] & 0xFFFF;
+
+    // renormalize
+    const DWord state_max = ((state_lower_bound_ >> scale_bits_) << 8) * freq;
+    while (state >= state_max)
+    {
+      outputByteVector_.push_back (static_cast<uint8_t> (state & 0xFF));
+      state >>= 8;
+    }
+
+    state = ((state / freq) << scale_bits_) + (state % freq) + start;
+  }
+
+  // flush states, the one of the first symbol last so that it is read first
+  for (unsigned int k = interleave_; k-- > 0;)
+  {
+    for (unsigned int b = 0; b < sizeof(DWord); b++)
+    {
+      outputByteVector_.push_back (static_cast<uint8_t> (states[k] & 0xFF));
+      states[k] >>= 8;
+    }
+  }
+  std::reverse (outputByteVector_.begin (), outputByteVector_.end ());
+
+  // write encoded data to stream
+  uint64_t compressedSize = outputByteVector_.size ();
+  outputByteStream_arg.write (reinterpret_cast<const char*> (&compressedSize), sizeof(compressedSize));
+  outputByteStream_arg.write (reinterpret_cast<const char*> (outputByteVector_.data ()), outputByteVector_.size ());
+
+  return (static_cast<unsigned long> (sizeof(compressedSize) + outputByteVector_.size ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename ContextT> unsigned long
+pcl::InterleavedRANSCoder::decodeSymbols (std::istream& inputByteStream_arg, uint8_t* symbols_arg,
+                                          size_t symbolCount_arg, ContextT& context_arg)
+{
+  const DWord slot_mask = (1u << scale_bits_) - 1;
 
+  uint64_t compressedSize = 0;
+  inputByteStream_arg.read (reinterpret_cast<char*> (&compressedSize), sizeof(compressedSize));
+
+  outputByteVector_.resize (static_cast<size_t> (compressedSize));
+  inputByteStream_arg.read (reinterpret_cast<char*> (outputByteVector_.data ()), outputByteVector_.size ());
+
+  if (models_.size () < ContextT::context_count_)
+    models_.resize (ContextT::context_count_);
+  for (unsigned int c = 0; c < ContextT::context_count_; c++)
+    models_[c].reset ();
+
+  const uint8_t* input = outputByteVector_.data ();
+  const uint8_t* input_end = input + outputByteVector_.size ();
+
+  // init states
+  DWord states[interleave_];
+  for (unsigned int k = 0; k < interleave_; k++)
+  {
+    states[k] = 0;
+    for (unsigned int b = 0; b < sizeof(DWord) && input < input_end; b++)
+      states[k] = (states[k] << 8) | *input++;
+  }
+
+  // decoding loop, consecutive symbols use independent states
+  for (size_t i = 0; i < symbolCount_arg; i++)
+  {
+    AdaptiveModel& model = models_[context_arg.next ()];
+    DWord& state = states[i % interleave_];
+
+    // find symbol by table lookup
+    const DWord slot = state & slot_mask;
+    const uint8_t symbol = model.lookup_[slot];
+    state = model.freq_[symbol] * (state >> scale_bits_) + slot - model.start_[symbol];
+
+    // renormalize
+    while (state < state_lower_bound_ && input < input_end)
+      state = (state << 8) | *input++;
+
+    symbols_arg[i] = symbol;
+    model.update (symbol);
+    context_arg.push (symbol);
+  }
+
+  return (static_cast<unsigned long> (sizeof(compressedSize) + outputByteVector_.size ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::InterleavedRANSCoder::AdaptiveModel::reset ()
+{
+  const DWord scale = 1u << scale_bits_;
+
+  for (unsigned int s = 0; s < 256; s++)
+  {
+    counts_[s] = 1;
+    freq_[s] = scale / 256;
+    start_[s] = s * (scale / 256);
+  }
+  total_ = 256;
+
+  for (unsigned int s = 0; s < 256; s++)
+    memset (&lookup_[start_[s]], static_cast<int> (s), freq_[s]);
+
+  interval_ = 16;
+  until_rebuild_ = interval_;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::InterleavedRANSCoder::AdaptiveModel::rebuild ()
+{
+  const DWord scale = 1u << scale_bits_;
+
+  // halve counts to follow changing statistics
+  if (total_ > count_limit_)
+  {
+    total_ = 0;
+    for (unsigned int s = 0; s < 256; s++)
+    {
+      counts_[s] = (counts_[s] + 1) / 2;
+      total_ += counts_[s];
+    }
+  }
+
+  // every symbol keeps a frequency of at least one, the rest of the scale goes to the most frequent symbol
+  DWord freqSum = 0;
+  unsigned int maxSymbol = 0;
+  for (unsigned int s = 0; s < 256; s++)
+  {
+    freq_[s] = 1 + static_cast<DWord> (static_cast<uint64_t> (counts_[s]) * (scale - 256) / total_);
+    freqSum += freq_[s];
+    if (counts_[s] > counts_[maxSymbol])
+      maxSymbol = s;
+  }
+  freq_[maxSymbol] += scale - freqSum;
+
+  // cumulative frequencies and symbol lookup
+  DWord start = 0;
+  for (unsigned int s = 0; s < 256; s++)
+  {
+    start_[s] = start;
+    memset (&lookup_[start], static_cast<int> (s), freq_[s]);
+    start += freq_[s];
+  }
+
+  interval_ = (interval_ < max_interval_ / 2) ? interval_ * 2 : max_interval_;
+  until_rebuild_ = interval_;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+pcl::InterleavedRANSCoder::OccupancyContext::OccupancyContext (unsigned int treeDepth_arg,
+                                                               std::vector<int32_t>& children_arg) :
+  tree_depth_ (treeDepth_arg), branches_ (), done_ (treeDepth_arg == 0), depth_ (0), child_idx_ (0),
+  children_ (children_arg)
+{
+  children_.clear ();
+  neighbors_[0] = neighbors_[1] = neighbors_[2] = -1;
+  branches_.reserve (treeDepth_arg);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned int
+pcl::InterleavedRANSCoder::OccupancyContext::next () const
+{
+  if (done_)
+    return (0);
+
+  // children are leaves
+  unsigned int context = (depth_ + 1 >= tree_depth_) ? 8 : 0;
+
+  // occupied face neighbors preceding the node in depth first order
+  if (neighbors_[0] >= 0)
+    context |= 4;
+  if (neighbors_[1] >= 0)
+    context |= 2;
+  if (neighbors_[2] >= 0)
+    context |= 1;
+
+  return (context);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::InterleavedRANSCoder::OccupancyContext::push (uint8_t pattern_arg)
+{
+  if (done_)
+    return;
+
+  int32_t node = leaf_parent_;
+  if (depth_ + 1 < tree_depth_ && pattern_arg)
+  {
+    node = static_cast<int32_t> (children_.size () / 8);
+    children_.resize (children_.size () + 8, -1);
+  }
+
+  if (!branches_.empty ())
+    children_[8 * branches_.back ().node + child_idx_] = node;
+
+  if (node != leaf_parent_)
+  {
+    Branch branch = {pattern_arg, depth_, node, {neighbors_[0], neighbors_[1], neighbors_[2]}};
+    branches_.push_back (branch);
+  }
+
+  // move on to the next child branch in depth first order
+  while (!branches_.empty ())
+  {
+    Branch& branch = branches_.back ();
+    if (branch.remaining)
+    {
+      // index of the lowest remaining child, via a de Bruijn multiplication of the isolated bit
+      static const unsigned char lowest_bit_index[8] = {0, 1, 2, 4, 7, 3, 6, 5};
+      const unsigned int lowest_bit = branch.remaining & (~branch.remaining + 1);
+      child_idx_ = lowest_bit_index[((lowest_bit * 0x17) & 0xFF) >> 5];
+      branch.remaining = static_cast<uint8_t> (branch.remaining ^ lowest_bit);
+      depth_ = branch.depth + 1;
+
+      // a face neighbor is either a sibling or a child of the parent's neighbor, both coded before
+      const int32_t* siblings = &children_[8 * branch.node];
+      for (unsigned int axis = 0; axis < 3; axis++)
+      {
+        const unsigned int axis_bit = 4 >> axis;
+        if (child_idx_ & axis_bit)
+          neighbors_[axis] = siblings[child_idx_ ^ axis_bit];
+        else if (branch.neighbors[axis] >= 0 && branch.neighbors[axis] != leaf_parent_)
+          neighbors_[axis] = children_[8 * branch.neighbors[axis] + (child_idx_ | axis_bit)];
+        else
+          neighbors_[axis] = -1;
+      }
+      return;
+    }
+    branches_.pop_back ();
+  }
+
+  done_ = true;
+}
+
+#endif
@@ -39,9 +39,17 @@
 #define OCTREE_COMPRESSION_HPP
 
 #include <pcl/compression/entropy_range_coder.h>
+#include <pcl/exceptions.h>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <iterator>
 #include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include <vector>
 #include <cstring>
 #include <iostream>
@@ -57,6 +65,12 @@ namespace pcl
         const PointCloudConstPtr &cloud_arg,
         std::ostream& compressed_tree_data_out_arg)
     {
+      if (nr_blocks_ > 1)
+      {
+        encodeBlocks (cloud_arg, compressed_tree_data_out_arg);
+        return;
+      }
+
       unsigned char recent_tree_depth =
           static_cast<unsigned char> (this->getTreeDepth ());
 
@@ -180,7 +194,11 @@ namespace pcl
     {
 
       // synchronize to frame header
-      syncToHeader(compressed_tree_data_in_arg);
+      if (syncToHeader (compressed_tree_data_in_arg))
+      {
+        decodeBlocks (compressed_tree_data_in_arg, cloud_arg);
+        return;
+      }
 
       // initialize octree
       this->switchBuffers ();
@@ -262,8 +280,18 @@ namespace pcl
       // encode binary octree structure
       binary_tree_data_vector_size = binary_tree_data_vector_.size ();
       compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&binary_tree_data_vector_size), sizeof (binary_tree_data_vector_size));
-      compressed_point_data_len_ += entropy_coder_.encodeCharVectorToStream (binary_tree_data_vector_,
-                                                                             compressed_tree_data_out_arg);
+      if (entropy_coding_ == RANS_CODER)
+      {
+        // XOR encoded trees of prediction frames are coded without structural context
+        const unsigned char tree_depth = static_cast<unsigned char> (i_frame_ ? this->getTreeDepth () : 0);
+        compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&tree_depth), sizeof (tree_depth));
+        compressed_point_data_len_ += sizeof (tree_depth) +
+                                      rans_coder_.encodeOccupancyVectorToStream (binary_tree_data_vector_, tree_depth,
+                                                                                 compressed_tree_data_out_arg);
+      }
+      else
+        compressed_point_data_len_ += entropy_coder_.encodeCharVectorToStream (binary_tree_data_vector_,
+                                                                               compressed_tree_data_out_arg);
 
       if (cloud_with_color_)
       {
@@ -272,8 +300,9 @@ namespace pcl
         point_avg_color_data_vector_size = pointAvgColorDataVector.size ();
         compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&point_avg_color_data_vector_size),
                                             sizeof (point_avg_color_data_vector_size));
-        compressed_color_data_len_ += entropy_coder_.encodeCharVectorToStream (pointAvgColorDataVector,
-                                                                               compressed_tree_data_out_arg);
+        compressed_color_data_len_ += entropy_coding_ == RANS_CODER ?
+            rans_coder_.encodeCharVectorToStream (pointAvgColorDataVector, compressed_tree_data_out_arg) :
+            entropy_coder_.encodeCharVectorToStream (pointAvgColorDataVector, compressed_tree_data_out_arg);
       }
 
       if (!do_voxel_grid_enDecoding_)
@@ -285,15 +314,17 @@ namespace pcl
         // encode amount of points per voxel
         pointCountDataVector_size = point_count_data_vector_.size ();
         compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&pointCountDataVector_size), sizeof (pointCountDataVector_size));
-        compressed_point_data_len_ += entropy_coder_.encodeIntVectorToStream (point_count_data_vector_,
-                                                                          compressed_tree_data_out_arg);
+        compressed_point_data_len_ += entropy_coding_ == RANS_CODER ?
+            rans_coder_.encodeIntVectorToStream (point_count_data_vector_, compressed_tree_data_out_arg) :
+            entropy_coder_.encodeIntVectorToStream (point_count_data_vector_, compressed_tree_data_out_arg);
 
         // encode differential point information
         std::vector<char>& point_diff_data_vector = point_coder_.getDifferentialDataVector ();
         point_diff_data_vector_size = point_diff_data_vector.size ();
         compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&point_diff_data_vector_size), sizeof (point_diff_data_vector_size));
-        compressed_point_data_len_ += entropy_coder_.encodeCharVectorToStream (point_diff_data_vector,
-                                                                               compressed_tree_data_out_arg);
+        compressed_point_data_len_ += entropy_coding_ == RANS_CODER ?
+            rans_coder_.encodeCharVectorToStream (point_diff_data_vector, compressed_tree_data_out_arg) :
+            entropy_coder_.encodeCharVectorToStream (point_diff_data_vector, compressed_tree_data_out_arg);
         if (cloud_with_color_)
         {
           // encode differential color information
@@ -301,8 +332,9 @@ namespace pcl
           point_diff_color_data_vector_size = point_diff_color_data_vector.size ();
           compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&point_diff_color_data_vector_size),
                                            sizeof (point_diff_color_data_vector_size));
-          compressed_color_data_len_ += entropy_coder_.encodeCharVectorToStream (point_diff_color_data_vector,
-                                                                                 compressed_tree_data_out_arg);
+          compressed_color_data_len_ += entropy_coding_ == RANS_CODER ?
+              rans_coder_.encodeCharVectorToStream (point_diff_color_data_vector, compressed_tree_data_out_arg) :
+              entropy_coder_.encodeCharVectorToStream (point_diff_color_data_vector, compressed_tree_data_out_arg);
         }
       }
       // flush output stream
@@ -322,8 +354,17 @@ namespace pcl
       // decode binary octree structure
       compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&binary_tree_data_vector_size), sizeof (binary_tree_data_vector_size));
       binary_tree_data_vector_.resize (static_cast<std::size_t> (binary_tree_data_vector_size));
-      compressed_point_data_len_ += entropy_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg,
-                                                                         binary_tree_data_vector_);
+      if (entropy_coding_ == RANS_CODER)
+      {
+        unsigned char tree_depth;
+        compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&tree_depth), sizeof (tree_depth));
+        compressed_point_data_len_ += sizeof (tree_depth) +
+                                      rans_coder_.decodeStreamToOccupancyVector (compressed_tree_data_in_arg, tree_depth,
+                                                                                 binary_tree_data_vector_);
+      }
+      else
+        compressed_point_data_len_ += entropy_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg,
+                                                                               binary_tree_data_vector_);
 
       if (data_with_color_)
       {
@@ -331,8 +372,9 @@ namespace pcl
         std::vector<char>& point_avg_color_data_vector = color_coder_.getAverageDataVector ();
         compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&point_avg_color_data_vector_size), sizeof (point_avg_color_data_vector_size));
         point_avg_color_data_vector.resize (static_cast<std::size_t> (point_avg_color_data_vector_size));
-        compressed_color_data_len_ += entropy_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg,
-                                                                           point_avg_color_data_vector);
+        compressed_color_data_len_ += entropy_coding_ == RANS_CODER ?
+            rans_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg, point_avg_color_data_vector) :
+            entropy_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg, point_avg_color_data_vector);
       }
 
       if (!do_voxel_grid_enDecoding_)
@@ -344,15 +386,18 @@ namespace pcl
         // decode amount of points per voxel
         compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&point_count_data_vector_size), sizeof (point_count_data_vector_size));
         point_count_data_vector_.resize (static_cast<std::size_t> (point_count_data_vector_size));
-        compressed_point_data_len_ += entropy_coder_.decodeStreamToIntVector (compressed_tree_data_in_arg, point_count_data_vector_);
+        compressed_point_data_len_ += entropy_coding_ == RANS_CODER ?
+            rans_coder_.decodeStreamToIntVector (compressed_tree_data_in_arg, point_count_data_vector_) :
+            entropy_coder_.decodeStreamToIntVector (compressed_tree_data_in_arg, point_count_data_vector_);
         point_count_data_vector_iterator_ = point_count_data_vector_.begin ();
 
         // decode differential point information
         std::vector<char>& pointDiffDataVector = point_coder_.getDifferentialDataVector ();
         compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&point_diff_data_vector_size), sizeof (point_diff_data_vector_size));
         pointDiffDataVector.resize (static_cast<std::size_t> (point_diff_data_vector_size));
-        compressed_point_data_len_ += entropy_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg,
-                                                                           pointDiffDataVector);
+        compressed_point_data_len_ += entropy_coding_ == RANS_CODER ?
+            rans_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg, pointDiffDataVector) :
+            entropy_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg, pointDiffDataVector);
 
         if (data_with_color_)
         {
@@ -360,8 +405,9 @@ namespace pcl
           std::vector<char>& pointDiffColorDataVector = color_coder_.getDifferentialDataVector ();
           compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&point_diff_color_data_vector_size), sizeof (point_diff_color_data_vector_size));
           pointDiffColorDataVector.resize (static_cast<std::size_t> (point_diff_color_data_vector_size));
-          compressed_color_data_len_ += entropy_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg,
-                                                                             pointDiffColorDataVector);
+          compressed_color_data_len_ += entropy_coding_ == RANS_CODER ?
+              rans_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg, pointDiffColorDataVector) :
+              entropy_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg, pointDiffColorDataVector);
         }
       }
     }
@@ -370,8 +416,9 @@ namespace pcl
     template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
     OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::writeFrameHeader (std::ostream& compressed_tree_data_out_arg)
     {
-      // encode header identifier
-      compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (frame_header_identifier_), strlen (frame_header_identifier_));
+      // encode header identifier, which also selects the entropy coder
+      const char* frame_id = entropy_coding_ == RANS_CODER ? rans_frame_header_identifier_ : frame_header_identifier_;
+      compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (frame_id), strlen (frame_id));
       // encode point cloud header id
       compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&frame_ID_), sizeof (frame_ID_));
       // encode frame type (I/P-frame)
@@ -414,17 +461,40 @@ namespace pcl
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
-    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> bool
     OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::syncToHeader ( std::istream& compressed_tree_data_in_arg)
     {
-      // sync to frame header
-      unsigned int header_id_pos = 0;
-      while (header_id_pos < strlen (frame_header_identifier_))
+      const std::string frame_id (frame_header_identifier_);
+      const std::string rans_frame_id (rans_frame_header_identifier_);
+      const std::string block_frame_id (block_frame_header_identifier_);
+      const size_t window_size = std::max (std::max (frame_id.size (), rans_frame_id.size ()), block_frame_id.size ());
+
+      // sync to any frame header, keeping the most recently read characters in a window
+      std::string window;
+      while (true)
       {
         char readChar;
-        compressed_tree_data_in_arg.read (static_cast<char*> (&readChar), sizeof (readChar));
-        if (readChar != frame_header_identifier_[header_id_pos++])
-          header_id_pos = (frame_header_identifier_[0]==readChar)?1:0;
+        if (!compressed_tree_data_in_arg.read (static_cast<char*> (&readChar), sizeof (readChar)))
+          PCL_THROW_EXCEPTION (pcl::IOException, "No frame header found before end of stream");
+        window.push_back (readChar);
+        if (window.size () > window_size)
+          window.erase (0, 1);
+
+        if (window.size () >= frame_id.size () &&
+            window.compare (window.size () - frame_id.size (), frame_id.size (), frame_id) == 0)
+        {
+          entropy_coding_ = RANGE_CODER;
+          return (false);
+        }
+        if (window.size () >= rans_frame_id.size () &&
+            window.compare (window.size () - rans_frame_id.size (), rans_frame_id.size (), rans_frame_id) == 0)
+        {
+          entropy_coding_ = RANS_CODER;
+          return (false);
+        }
+        if (window.size () >= block_frame_id.size () &&
+            window.compare (window.size () - block_frame_id.size (), block_frame_id.size (), block_frame_id) == 0)
+          return (true);
       }
     }
 
@@ -558,6 +628,266 @@ namespace pcl
                                        output_->points.size (), point_color_offset_);
       }
     }
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
+    OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::encodeBlocks (
+        const PointCloudConstPtr &cloud_arg,
+        std::ostream& compressed_tree_data_out_arg)
+    {
+      std::vector<std::vector<int> > block_indices;
+      partitionIntoBlocks (*cloud_arg, nr_blocks_, block_indices);
+      const uint32_t nr_blocks = static_cast<uint32_t> (block_indices.size ());
+
+      // every block index keeps its encoder, so its octree serves as reference of the next frame
+      while (block_coders_.size () < nr_blocks)
+        block_coders_.push_back (Ptr (new OctreePointCloudCompression (selected_profile_, false,
+            point_resolution_, octree_resolution_, do_voxel_grid_enDecoding_, i_frame_rate_,
+            do_color_encoding_, color_bit_resolution_)));
+
+      // encode blocks independently
+      std::vector<std::string> block_data (nr_blocks);
+      runBlocks (nr_blocks, [&] (unsigned int block)
+      {
+        PointCloudPtr block_cloud (new PointCloud);
+        pcl::copyPointCloud (*cloud_arg, block_indices[block], *block_cloud);
+
+        std::ostringstream block_stream;
+        block_coders_[block]->setEntropyCoder (entropy_coding_);
+        block_coders_[block]->encodePointCloud (block_cloud, block_stream);
+        block_data[block] = block_stream.str ();
+      });
+
+      frame_ID_++;
+
+      // write block frame header: identifier, format version, frame id and the size of every block
+      compressed_tree_data_out_arg.write (block_frame_header_identifier_, strlen (block_frame_header_identifier_));
+      compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&octreeBlockFrameVersion_), sizeof (octreeBlockFrameVersion_));
+      compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&frame_ID_), sizeof (frame_ID_));
+      compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&nr_blocks), sizeof (nr_blocks));
+      for (const std::string &data : block_data)
+      {
+        // an empty block was dropped by its encoder and is skipped by its decoder
+        uint64_t block_size = data.size ();
+        compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&block_size), sizeof (block_size));
+      }
+
+      // write block data
+      point_count_ = 0;
+      compressed_point_data_len_ = 0;
+      compressed_color_data_len_ = 0;
+      for (uint32_t block = 0; block < nr_blocks; ++block)
+      {
+        compressed_tree_data_out_arg.write (block_data[block].data (), block_data[block].size ());
+        if (!block_data[block].empty ())
+        {
+          point_count_ += block_coders_[block]->point_count_;
+          compressed_point_data_len_ += block_coders_[block]->compressed_point_data_len_;
+          compressed_color_data_len_ += block_coders_[block]->compressed_color_data_len_;
+        }
+      }
+      compressed_tree_data_out_arg.flush ();
+
+      if (b_show_statistics_ && point_count_ > 0)
+      {
+        float bytes_per_XYZ = static_cast<float> (compressed_point_data_len_) / static_cast<float> (point_count_);
+        float bytes_per_color = static_cast<float> (compressed_color_data_len_) / static_cast<float> (point_count_);
+
+        PCL_INFO ("*** POINTCLOUD BLOCK ENCODING ***\n");
+        PCL_INFO ("Frame ID: %d\n", frame_ID_);
+        PCL_INFO ("Number of blocks: %u\n", nr_blocks);
+        PCL_INFO ("Number of encoded points: %ld\n", point_count_);
+        PCL_INFO ("XYZ bytes per point: %f bytes\n", bytes_per_XYZ);
+        PCL_INFO ("Color bytes per point: %f bytes\n", bytes_per_color);
+        PCL_INFO ("Size of compressed point cloud: %f kBytes\n", static_cast<float> (compressed_point_data_len_ + compressed_color_data_len_) / 1024.0f);
+        PCL_INFO ("Compression ratio: %f\n\n", static_cast<float> (sizeof (int) + 3.0f * sizeof (float)) / static_cast<float> (bytes_per_XYZ + bytes_per_color));
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
+    OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::decodeBlocks (
+        std::istream& compressed_tree_data_in_arg,
+        PointCloudPtr &cloud_arg)
+    {
+      unsigned char version = 0;
+      uint32_t nr_blocks = 0;
+
+      // read block frame header
+      compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&version), sizeof (version));
+      if (version != octreeBlockFrameVersion_)
+      {
+        std::stringstream message;
+        message << "Unsupported block frame version " << static_cast<int> (version)
+                << ", expected " << static_cast<int> (octreeBlockFrameVersion_);
+        PCL_THROW_EXCEPTION (pcl::IOException, message.str ());
+      }
+      compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&frame_ID_), sizeof (frame_ID_));
+      compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&nr_blocks), sizeof (nr_blocks));
+      if (!compressed_tree_data_in_arg)
+        PCL_THROW_EXCEPTION (pcl::IOException, "Truncated block frame header");
+
+      // the header must fit into the rest of the stream; streams that cannot seek are bounded by the chunked reads below
+      uint64_t remaining = std::numeric_limits<uint64_t>::max ();
+      const std::istream::pos_type start = compressed_tree_data_in_arg.tellg ();
+      if (start != std::istream::pos_type (-1))
+      {
+        compressed_tree_data_in_arg.seekg (0, std::ios::end);
+        const std::istream::pos_type end = compressed_tree_data_in_arg.tellg ();
+        compressed_tree_data_in_arg.seekg (start);
+        if (end != std::istream::pos_type (-1) && end >= start)
+          remaining = static_cast<uint64_t> (end - start);
+      }
+      if (!compressed_tree_data_in_arg || nr_blocks > remaining / sizeof (uint64_t))
+        PCL_THROW_EXCEPTION (pcl::IOException, "Invalid number of blocks in block frame header");
+      remaining -= nr_blocks * sizeof (uint64_t);
+
+      // block sizes are read one by one, so a bad count fails on the stream instead of on allocation
+      std::vector<uint64_t> block_sizes;
+      for (uint32_t block = 0; block < nr_blocks; ++block)
+      {
+        uint64_t block_size = 0;
+        if (!compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&block_size), sizeof (block_size)))
+          PCL_THROW_EXCEPTION (pcl::IOException, "Truncated block frame header");
+        if (block_size > remaining)
+          PCL_THROW_EXCEPTION (pcl::IOException, "Block sizes exceed the block frame");
+        remaining -= block_size;
+        block_sizes.push_back (block_size);
+      }
+
+      // read block data in chunks, so memory only grows with data actually present in the stream
+      const uint64_t chunk_size = 1 << 16;
+      std::vector<std::string> block_data (nr_blocks);
+      for (uint32_t block = 0; block < nr_blocks; ++block)
+      {
+        for (uint64_t offset = 0; offset < block_sizes[block]; offset += chunk_size)
+        {
+          const size_t size = static_cast<size_t> (std::min (chunk_size, block_sizes[block] - offset));
+          block_data[block].resize (block_data[block].size () + size);
+          if (!compressed_tree_data_in_arg.read (&block_data[block][block_data[block].size () - size], size))
+            PCL_THROW_EXCEPTION (pcl::IOException, "Truncated block frame");
+        }
+      }
+
+      while (block_coders_.size () < nr_blocks)
+        block_coders_.push_back (Ptr (new OctreePointCloudCompression ()));
+
+      // decode blocks independently
+      std::vector<PointCloudPtr> block_clouds (nr_blocks);
+      runBlocks (nr_blocks, [&] (unsigned int block)
+      {
+        block_clouds[block].reset (new PointCloud);
+        if (block_data[block].empty ())
+          return;
+
+        std::istringstream block_stream (block_data[block]);
+        block_coders_[block]->decodePointCloud (block_stream, block_clouds[block]);
+      });
+
+      // concatenate blocks
+      this->setOutputCloud (cloud_arg);
+      size_t nr_points = 0;
+      for (const PointCloudPtr &block_cloud : block_clouds)
+        nr_points += block_cloud->points.size ();
+
+      output_->points.clear ();
+      output_->points.reserve (nr_points);
+      for (const PointCloudPtr &block_cloud : block_clouds)
+        output_->points.insert (output_->points.end (), block_cloud->points.begin (), block_cloud->points.end ());
+
+      output_->height = 1;
+      output_->width = static_cast<uint32_t> (output_->points.size ());
+      output_->is_dense = false;
+      point_count_ = nr_points;
+
+      if (b_show_statistics_)
+      {
+        PCL_INFO ("*** POINTCLOUD BLOCK DECODING ***\n");
+        PCL_INFO ("Frame ID: %d\n", frame_ID_);
+        PCL_INFO ("Number of blocks: %u\n", nr_blocks);
+        PCL_INFO ("Number of decoded points: %ld\n\n", point_count_);
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
+    OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::partitionIntoBlocks (
+        const PointCloud &cloud_arg, unsigned int nr_blocks_arg,
+        std::vector<std::vector<int> > &block_indices_arg) const
+    {
+      block_indices_arg.clear ();
+
+      std::vector<int> indices;
+      indices.reserve (cloud_arg.points.size ());
+      for (size_t i = 0; i < cloud_arg.points.size (); ++i)
+        if (pcl::isFinite (cloud_arg.points[i]))
+          indices.push_back (static_cast<int> (i));
+
+      if (indices.empty ())
+        return;
+
+      // cut along the longest axis of the bounding box
+      Eigen::Vector4f min_pt, max_pt;
+      pcl::getMinMax3D (cloud_arg, indices, min_pt, max_pt);
+      int axis;
+      (max_pt - min_pt).head<3> ().maxCoeff (&axis);
+
+      const auto coordinate_less = [&] (int a, int b)
+      {
+        return (cloud_arg.points[a].getVector3fMap ()[axis] < cloud_arg.points[b].getVector3fMap ()[axis]);
+      };
+
+      // slabs of equal point count: place every slab boundary with a partial sort of the remaining range
+      const size_t nr_blocks = std::min<size_t> (nr_blocks_arg, indices.size ());
+      std::vector<int>::iterator begin = indices.begin ();
+      for (size_t block = 0; block < nr_blocks; ++block)
+      {
+        std::vector<int>::iterator end = indices.begin () + (block + 1) * indices.size () / nr_blocks;
+        if (block + 1 < nr_blocks)
+          std::nth_element (begin, end, indices.end (), coordinate_less);
+        // the boundary element is the smallest of the remaining range, so the slab before it is complete
+        block_indices_arg.emplace_back (begin, end);
+        begin = end;
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT>
+    template<typename BlockFunctor> void
+    OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::runBlocks (
+        unsigned int nr_blocks_arg, BlockFunctor block_functor_arg) const
+    {
+      std::atomic<unsigned int> next_block (0);
+      std::exception_ptr error;
+      std::mutex error_mutex;
+
+      const auto worker = [&] ()
+      {
+        for (unsigned int block = next_block++; block < nr_blocks_arg; block = next_block++)
+        {
+          try
+          {
+            block_functor_arg (block);
+          }
+          catch (...)
+          {
+            std::lock_guard<std::mutex> lock (error_mutex);
+            if (!error)
+              error = std::current_exception ();
+          }
+        }
+      };
+
+      std::vector<std::thread> workers;
+      const unsigned int nr_threads = std::min (threads_, nr_blocks_arg);
+      for (unsigned int i = 1; i < nr_threads; ++i)
+        workers.emplace_back (worker);
+      worker ();
+      for (std::thread &thread : workers)
+        thread.join ();
+
+      if (error)
+        std::rethrow_exception (error);
+    }
   }
 }
 
@@ -49,12 +49,15 @@
 #include <pcl/common/io.h>
 
 #include <pcl/compression/libpng_wrapper.h>
+#include <pcl/compression/depth_image_coder.h>
 #include <pcl/compression/organized_pointcloud_conversion.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <limits>
 #include <cassert>
+#include <cstdlib>
 
 namespace pcl
 {
@@ -80,61 +83,29 @@ namespace pcl
 
       analyzeOrganizedCloud (cloud_arg, maxDepth, focalLength);
 
-      // encode header identifier
-      compressedDataOut_arg.write (reinterpret_cast<const char*> (frameHeaderIdentifier_), strlen (frameHeaderIdentifier_));
-      // encode point cloud width
-      compressedDataOut_arg.write (reinterpret_cast<const char*> (&cloud_width), sizeof (cloud_width));
-      // encode frame type height
-      compressedDataOut_arg.write (reinterpret_cast<const char*> (&cloud_height), sizeof (cloud_height));
-      // encode frame max depth
-      compressedDataOut_arg.write (reinterpret_cast<const char*> (&maxDepth), sizeof (maxDepth));
-      // encode frame focal length
-      compressedDataOut_arg.write (reinterpret_cast<const char*> (&focalLength), sizeof (focalLength));
-      // encode frame disparity scale
-      compressedDataOut_arg.write (reinterpret_cast<const char*> (&disparityScale), sizeof (disparityScale));
-      // encode frame disparity shift
-      compressedDataOut_arg.write (reinterpret_cast<const char*> (&disparityShift), sizeof (disparityShift));
+      const bool doColor = CompressionPointTraits<PointT>::hasColor && doColorEncoding;
+      const unsigned int channels = doColor ? (convertToMono ? 1 : 3) : 0;
+
+      // delta frames keep the focal length of the reference frame, as disparities computed
+      // from a slightly different estimate would change all over the image
+      const bool deltaFrame = isDeltaFrame (cloud_width, cloud_height, channels);
+      if (deltaFrame)
+        focalLength = encoder_reference_.focalLength;
 
       // disparity and rgb image data
       std::vector<uint16_t> disparityData;
       std::vector<uint8_t> colorData;
 
-      // compressed disparity and rgb image data
-      std::vector<uint8_t> compressedDisparity;
-      std::vector<uint8_t> compressedColor;
-
       uint32_t compressedDisparitySize = 0;
       uint32_t compressedColorSize = 0;
 
       // Convert point cloud to disparity and rgb image
       OrganizedConversion<PointT>::convert (*cloud_arg, focalLength, disparityShift, disparityScale, convertToMono,  disparityData, colorData);
+      if (!doColor)
+        colorData.clear ();
 
-      // Compress disparity information
-      encodeMonoImageToPNG (disparityData, cloud_width, cloud_height, compressedDisparity, pngLevel_arg);
-
-      compressedDisparitySize = static_cast<uint32_t>(compressedDisparity.size());
-      // Encode size of compressed disparity image data
-      compressedDataOut_arg.write (reinterpret_cast<const char*> (&compressedDisparitySize), sizeof (compressedDisparitySize));
-      // Output compressed disparity to ostream
-      compressedDataOut_arg.write (reinterpret_cast<const char*> (&compressedDisparity[0]), compressedDisparity.size () * sizeof(uint8_t));
-
-      // Compress color information
-      if (CompressionPointTraits<PointT>::hasColor && doColorEncoding)
-      {
-        if (convertToMono)
-        {
-          encodeMonoImageToPNG (colorData, cloud_width, cloud_height, compressedColor, 1 /*Z_BEST_SPEED*/);
-        } else
-        {
-          encodeRGBImageToPNG (colorData, cloud_width, cloud_height, compressedColor, 1 /*Z_BEST_SPEED*/);
-        }
-      }
-
-      compressedColorSize = static_cast<uint32_t>(compressedColor.size ());
-      // Encode size of compressed Color image data
-      compressedDataOut_arg.write (reinterpret_cast<const char*> (&compressedColorSize), sizeof (compressedColorSize));
-      // Output compressed disparity to ostream
-      compressedDataOut_arg.write (reinterpret_cast<const char*> (&compressedColor[0]), compressedColor.size () * sizeof(uint8_t));
+      encodeFrame (compressedDataOut_arg, deltaFrame, cloud_width, cloud_height, maxDepth, focalLength, disparityShift, disparityScale,
+                   disparityData, colorData, channels, pngLevel_arg, bShowStatistics_arg, compressedDisparitySize, compressedColorSize);
 
       if (bShowStatistics_arg)
       {
@@ -178,79 +149,47 @@ namespace pcl
          assert (colorImage_arg.size()==cloud_size*3);
        }
 
-       // encode header identifier
-       compressedDataOut_arg.write (reinterpret_cast<const char*> (frameHeaderIdentifier_), strlen (frameHeaderIdentifier_));
-       // encode point cloud width
-       compressedDataOut_arg.write (reinterpret_cast<const char*> (&width_arg), sizeof (width_arg));
-       // encode frame type height
-       compressedDataOut_arg.write (reinterpret_cast<const char*> (&height_arg), sizeof (height_arg));
-       // encode frame max depth
-       compressedDataOut_arg.write (reinterpret_cast<const char*> (&maxDepth), sizeof (maxDepth));
-       // encode frame focal length
-       compressedDataOut_arg.write (reinterpret_cast<const char*> (&focalLength_arg), sizeof (focalLength_arg));
-       // encode frame disparity scale
-       compressedDataOut_arg.write (reinterpret_cast<const char*> (&disparityScale_arg), sizeof (disparityScale_arg));
-       // encode frame disparity shift
-       compressedDataOut_arg.write (reinterpret_cast<const char*> (&disparityShift_arg), sizeof (disparityShift_arg));
-
-       // compressed disparity and rgb image data
-       std::vector<uint8_t> compressedDisparity;
-       std::vector<uint8_t> compressedColor;
-
        uint32_t compressedDisparitySize = 0;
        uint32_t compressedColorSize = 0;
 
        // Remove color information of invalid points
-       uint16_t* depth_ptr = &disparityMap_arg[0];
-       uint8_t* color_ptr = &colorImage_arg[0];
-
-       for (size_t i = 0; i < cloud_size; ++i, ++depth_ptr, color_ptr += sizeof(uint8_t) * 3)
+       if (!colorImage_arg.empty ())
        {
-         if (!(*depth_ptr) || (*depth_ptr==0x7FF))
-           memset(color_ptr, 0, sizeof(uint8_t)*3);
-       }
+         uint16_t* depth_ptr = &disparityMap_arg[0];
+         uint8_t* color_ptr = &colorImage_arg[0];
 
-       // Compress disparity information
-       encodeMonoImageToPNG (disparityMap_arg, width_arg, height_arg, compressedDisparity, pngLevel_arg);
+         for (size_t i = 0; i < cloud_size; ++i, ++depth_ptr, color_ptr += sizeof(uint8_t) * 3)
+         {
+           if (!(*depth_ptr) || (*depth_ptr==0x7FF))
+             memset(color_ptr, 0, sizeof(uint8_t)*3);
+         }
+       }
 
-       compressedDisparitySize = static_cast<uint32_t>(compressedDisparity.size());
-       // Encode size of compressed disparity image data
-       compressedDataOut_arg.write (reinterpret_cast<const char*> (&compressedDisparitySize), sizeof (compressedDisparitySize));
-       // Output compressed disparity to ostream
-       compressedDataOut_arg.write (reinterpret_cast<const char*> (&compressedDisparity[0]), compressedDisparity.size () * sizeof(uint8_t));
+       // Convert color information
+       std::vector<uint8_t> monoImage;
+       const bool doColor = !colorImage_arg.empty () && doColorEncoding;
+       const unsigned int channels = doColor ? (convertToMono ? 1 : 3) : 0;
 
-       // Compress color information
-       if (!colorImage_arg.empty () && doColorEncoding)
+       if (doColor && convertToMono)
        {
-         if (convertToMono)
-         {
-           std::vector<uint8_t> monoImage;
-           size_t size = width_arg*height_arg;
-
-           monoImage.reserve(size);
-
-           // grayscale conversion
-           for (size_t i = 0; i < size; ++i)
-           {
-             uint8_t grayvalue = static_cast<uint8_t>(0.2989 * static_cast<float>(colorImage_arg[i*3+0]) +
-                                                      0.5870 * static_cast<float>(colorImage_arg[i*3+1]) +
-                                                      0.1140 * static_cast<float>(colorImage_arg[i*3+2]));
-             monoImage.push_back(grayvalue);
-           }
-           encodeMonoImageToPNG (monoImage, width_arg, height_arg, compressedColor, 1 /*Z_BEST_SPEED*/);
-
-         } else
+         size_t size = width_arg*height_arg;
+
+         monoImage.reserve(size);
+
+         // grayscale conversion
+         for (size_t i = 0; i < size; ++i)
          {
-           encodeRGBImageToPNG (colorImage_arg, width_arg, height_arg, compressedColor, 1 /*Z_BEST_SPEED*/);
+           uint8_t grayvalue = static_cast<uint8_t>(0.2989 * static_cast<float>(colorImage_arg[i*3+0]) +
+                                                    0.5870 * static_cast<float>(colorImage_arg[i*3+1]) +
+                                                    0.1140 * static_cast<float>(colorImage_arg[i*3+2]));
+           monoImage.push_back(grayvalue);
          }
-
        }
 
-       compressedColorSize = static_cast<uint32_t>(compressedColor.size ());
-       // Encode size of compressed Color image data
-       compressedDataOut_arg.write (reinterpret_cast<const char*> (&compressedColorSize), sizeof (compressedColorSize));
-       // Output compressed disparity to ostream
-       compressedDataOut_arg.write (reinterpret_cast<const char*> (&compressedColor[0]), compressedColor.size () * sizeof(uint8_t));
+       encodeFrame (compressedDataOut_arg, isDeltaFrame (width_arg, height_arg, channels), width_arg, height_arg,
+                    maxDepth, focalLength_arg, disparityShift_arg, disparityScale_arg, disparityMap_arg,
+                    (doColor && !convertToMono) ? colorImage_arg : monoImage, channels, pngLevel_arg,
+                    bShowStatistics_arg, compressedDisparitySize, compressedColorSize);
 
        if (bShowStatistics_arg)
        {
@@ -270,6 +209,244 @@ namespace pcl
        compressedDataOut_arg.flush();
     }
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> bool
+    OrganizedPointCloudCompression<PointT>::isDeltaFrame (uint32_t width_arg,
+                                                          uint32_t height_arg,
+                                                          unsigned int channels_arg) const
+    {
+      return ((keyframe_interval_ > 1) && (frames_since_keyframe_ + 1 < keyframe_interval_) &&
+              (encoder_reference_.width == width_arg) && (encoder_reference_.height == height_arg) &&
+              (encoder_reference_.channels == channels_arg) &&
+              (encoder_reference_.disparity.size () == static_cast<size_t> (width_arg) * height_arg));
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> void
+    OrganizedPointCloudCompression<PointT>::encodeFrame (std::ostream& compressedDataOut_arg,
+                                                         bool deltaFrame_arg,
+                                                         uint32_t width_arg,
+                                                         uint32_t height_arg,
+                                                         float maxDepth_arg,
+                                                         float focalLength_arg,
+                                                         float disparityShift_arg,
+                                                         float disparityScale_arg,
+                                                         std::vector<uint16_t>& disparityData_arg,
+                                                         std::vector<uint8_t>& colorData_arg,
+                                                         unsigned int channels_arg,
+                                                         int pngLevel_arg,
+                                                         bool bShowStatistics_arg,
+                                                         uint32_t& compressedDisparitySize_arg,
+                                                         uint32_t& compressedColorSize_arg)
+    {
+      const char* identifier = deltaFrame_arg ? frameDeltaHeaderIdentifier_ : frameHeaderIdentifier_;
+
+      // encode header identifier
+      compressedDataOut_arg.write (reinterpret_cast<const char*> (identifier), strlen (identifier));
+      // encode point cloud width
+      compressedDataOut_arg.write (reinterpret_cast<const char*> (&width_arg), sizeof (width_arg));
+      // encode frame type height
+      compressedDataOut_arg.write (reinterpret_cast<const char*> (&height_arg), sizeof (height_arg));
+      // encode frame max depth
+      compressedDataOut_arg.write (reinterpret_cast<const char*> (&maxDepth_arg), sizeof (maxDepth_arg));
+      // encode frame focal length
+      compressedDataOut_arg.write (reinterpret_cast<const char*> (&focalLength_arg), sizeof (focalLength_arg));
+      // encode frame disparity scale
+      compressedDataOut_arg.write (reinterpret_cast<const char*> (&disparityScale_arg), sizeof (disparityScale_arg));
+      // encode frame disparity shift
+      compressedDataOut_arg.write (reinterpret_cast<const char*> (&disparityShift_arg), sizeof (disparityShift_arg));
+
+      // compressed disparity and rgb image data
+      std::vector<uint8_t> compressedDisparity;
+      std::vector<uint8_t> compressedColor;
+
+      ReferenceFrame& reference = encoder_reference_;
+
+      if (!deltaFrame_arg)
+      {
+        // Compress disparity information
+        if (predictive_depth_coding_)
+          depth_coder_.encode (disparityData_arg, width_arg, height_arg, compressedDisparity);
+        else
+          encodeMonoImageToPNG (disparityData_arg, width_arg, height_arg, compressedDisparity, pngLevel_arg);
+
+        // Compress color information
+        if (channels_arg == 1)
+          encodeMonoImageToPNG (colorData_arg, width_arg, height_arg, compressedColor, 1 /*Z_BEST_SPEED*/);
+        else if (channels_arg == 3)
+          encodeRGBImageToPNG (colorData_arg, width_arg, height_arg, compressedColor, 1 /*Z_BEST_SPEED*/);
+
+        // Keep the frame as the decoder will reconstruct it
+        reference.width = width_arg;
+        reference.height = height_arg;
+        reference.channels = channels_arg;
+        reference.focalLength = focalLength_arg;
+        reference.color = colorData_arg;
+
+        uint32_t depth_width, depth_height;
+        if (!predictive_depth_coding_ || depth_coder_.getMaxError () == 0 ||
+            !depth_coder_.decode (compressedDisparity, reference.disparity, depth_width, depth_height))
+          reference.disparity = disparityData_arg;
+
+        frames_since_keyframe_ = 0;
+      }
+      else
+      {
+        const uint32_t tile_size = tile_size_;
+        const uint32_t tiles_x = (width_arg + tile_size - 1) / tile_size;
+        const uint32_t tiles_y = (height_arg + tile_size - 1) / tile_size;
+        const int depth_threshold = static_cast<int> (depth_change_threshold_);
+        const int color_threshold = static_cast<int> (color_change_threshold_);
+
+        // Changed tiles either hold the zigzag coded differences to the reference or, where
+        // these are harder to code than the tile itself, the current values. Skipped tiles are zero.
+        std::vector<uint16_t> disparityDelta (disparityData_arg.size (), 0);
+        std::vector<uint8_t> colorDelta (colorData_arg.size (), 0);
+
+        // Masks of the changed tiles and of the tiles holding current values
+        const uint32_t tileMaskBytes = (tiles_x * tiles_y + 7) / 8;
+        std::vector<uint8_t> tileMask (2 * tileMaskBytes, 0);
+
+        bool depthChanged = false;
+        bool colorChanged = false;
+        unsigned int changedTiles = 0;
+        unsigned int replacedTiles = 0;
+
+        for (uint32_t ty = 0; ty < tiles_y; ++ty)
+          for (uint32_t tx = 0; tx < tiles_x; ++tx)
+          {
+            const uint32_t x_begin = tx * tile_size;
+            const uint32_t y_begin = ty * tile_size;
+            const uint32_t x_end = std::min (width_arg, x_begin + tile_size);
+            const uint32_t y_end = std::min (height_arg, y_begin + tile_size);
+
+            // Check whether the tile changed beyond the thresholds
+            bool changed = false;
+            for (uint32_t y = y_begin; y < y_end && !changed; ++y)
+              for (uint32_t x = x_begin; x < x_end && !changed; ++x)
+              {
+                const size_t i = static_cast<size_t> (y) * width_arg + x;
+                const uint16_t current = disparityData_arg[i];
+                const uint16_t previous = reference.disparity[i];
+
+                const bool current_valid = current && (current != 0x7FF);
+                const bool previous_valid = previous && (previous != 0x7FF);
+                changed = (current_valid != previous_valid) ||
+                          (std::abs (static_cast<int> (current) - static_cast<int> (previous)) > depth_threshold);
+
+                for (unsigned int c = 0; c < channels_arg && !changed; ++c)
+                  changed = std::abs (static_cast<int> (colorData_arg[i * channels_arg + c]) -
+                                      static_cast<int> (reference.color[i * channels_arg + c])) > color_threshold;
+              }
+
+            if (!changed)
+              continue;
+
+            // Estimate the cost of coding differences and current values by the sums of
+            // absolute temporal and horizontal differences
+            uint64_t deltaCost = 0;
+            uint64_t valueCost = 0;
+            for (uint32_t y = y_begin; y < y_end; ++y)
+              for (uint32_t x = x_begin; x < x_end; ++x)
+              {
+                const size_t i = static_cast<size_t> (y) * width_arg + x;
+                const size_t left = (x > x_begin) ? i - 1 : (y > y_begin ? i - width_arg : i);
+
+                deltaCost += std::abs (static_cast<int> (disparityData_arg[i]) - static_cast<int> (reference.disparity[i]));
+                valueCost += std::abs (static_cast<int> (disparityData_arg[i]) - static_cast<int> (disparityData_arg[left]));
+                for (unsigned int c = 0; c < channels_arg; ++c)
+                {
+                  const int current = colorData_arg[i * channels_arg + c];
+                  deltaCost += std::abs (current - static_cast<int> (reference.color[i * channels_arg + c]));
+                  valueCost += std::abs (current - static_cast<int> (colorData_arg[left * channels_arg + c]));
+                }
+              }
+            const bool replace = valueCost < deltaCost;
+
+            const uint32_t tile = ty * tiles_x + tx;
+            tileMask[tile / 8] |= static_cast<uint8_t> (1 << (tile % 8));
+            ++changedTiles;
+            if (replace)
+            {
+              tileMask[tileMaskBytes + tile / 8] |= static_cast<uint8_t> (1 << (tile % 8));
+              ++replacedTiles;
+            }
+
+            // Code the tile losslessly and update the reference
+            for (uint32_t y = y_begin; y < y_end; ++y)
+              for (uint32_t x = x_begin; x < x_end; ++x)
+              {
+                const size_t i = static_cast<size_t> (y) * width_arg + x;
+
+                if (replace)
+                  disparityDelta[i] = disparityData_arg[i];
+                else
+                {
+                  const int16_t delta = static_cast<int16_t> (disparityData_arg[i] - reference.disparity[i]);
+                  disparityDelta[i] = static_cast<uint16_t> ((static_cast<unsigned int> (delta) << 1) ^ static_cast<unsigned int> (delta >> 15));
+                }
+                depthChanged |= (disparityDelta[i] != 0);
+                reference.disparity[i] = disparityData_arg[i];
+
+                for (unsigned int c = 0; c < channels_arg; ++c)
+                {
+                  const size_t j = i * channels_arg + c;
+                  if (replace)
+                    colorDelta[j] = colorData_arg[j];
+                  else
+                  {
+                    const int8_t color_delta = static_cast<int8_t> (colorData_arg[j] - reference.color[j]);
+                    colorDelta[j] = static_cast<uint8_t> ((static_cast<unsigned int> (color_delta) << 1) ^ static_cast<unsigned int> (color_delta >> 7));
+                  }
+                  colorChanged |= (colorDelta[j] != 0);
+                  reference.color[j] = colorData_arg[j];
+                }
+              }
+          }
+
+        // Encode tile size and tile masks
+        const uint32_t tileMaskSize = static_cast<uint32_t> (tileMask.size ());
+        compressedDataOut_arg.write (reinterpret_cast<const char*> (&tile_size), sizeof (tile_size));
+        compressedDataOut_arg.write (reinterpret_cast<const char*> (&tileMaskSize), sizeof (tileMaskSize));
+        compressedDataOut_arg.write (reinterpret_cast<const char*> (tileMask.data ()), tileMask.size () * sizeof(uint8_t));
+
+        // Compress the differences losslessly, leaving them out if there are none
+        if (depthChanged)
+        {
+          if (predictive_depth_coding_)
+          {
+            DepthImageCoder delta_coder (depth_coder_);
+            delta_coder.setMaxError (0);
+            delta_coder.encode (disparityDelta, width_arg, height_arg, compressedDisparity);
+          }
+          else
+            encodeMonoImageToPNG (disparityDelta, width_arg, height_arg, compressedDisparity, pngLevel_arg);
+        }
+
+        if (colorChanged && channels_arg == 1)
+          encodeMonoImageToPNG (colorDelta, width_arg, height_arg, compressedColor, 1 /*Z_BEST_SPEED*/);
+        else if (colorChanged && channels_arg == 3)
+          encodeRGBImageToPNG (colorDelta, width_arg, height_arg, compressedColor, 1 /*Z_BEST_SPEED*/);
+
+        ++frames_since_keyframe_;
+
+        if (bShowStatistics_arg)
+          PCL_INFO("Delta frame, changed tiles: %u of %u, coded as current values: %u\n", changedTiles, tiles_x * tiles_y, replacedTiles);
+      }
+
+      compressedDisparitySize_arg = static_cast<uint32_t>(compressedDisparity.size());
+      // Encode size of compressed disparity image data
+      compressedDataOut_arg.write (reinterpret_cast<const char*> (&compressedDisparitySize_arg), sizeof (compressedDisparitySize_arg));
+      // Output compressed disparity to ostream
+      compressedDataOut_arg.write (reinterpret_cast<const char*> (compressedDisparity.data ()), compressedDisparity.size () * sizeof(uint8_t));
+
+      compressedColorSize_arg = static_cast<uint32_t>(compressedColor.size ());
+      // Encode size of compressed Color image data
+      compressedDataOut_arg.write (reinterpret_cast<const char*> (&compressedColorSize_arg), sizeof (compressedColorSize_arg));
+      // Output compressed disparity to ostream
+      compressedDataOut_arg.write (reinterpret_cast<const char*> (compressedColor.data ()), compressedColor.size () * sizeof(uint8_t));
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     template<typename PointT> bool
     OrganizedPointCloudCompression<PointT>::decodePointCloud (std::istream& compressedDataIn_arg,
@@ -299,20 +476,26 @@ namespace pcl
       size_t png_height = 0;
       unsigned int png_channels = 1;
 
-      // sync to frame header
-      unsigned int headerIdPos = 0;
+      // sync to keyframe or delta frame header
+      const size_t keyIdLength = strlen (frameHeaderIdentifier_);
+      const size_t deltaIdLength = strlen (frameDeltaHeaderIdentifier_);
+      unsigned int keyIdPos = 0;
+      unsigned int deltaIdPos = 0;
       bool valid_stream = true;
-      while (valid_stream && (headerIdPos < strlen (frameHeaderIdentifier_)))
+      while (valid_stream && (keyIdPos < keyIdLength) && (deltaIdPos < deltaIdLength))
       {
         char readChar;
         compressedDataIn_arg.read (static_cast<char*> (&readChar), sizeof (readChar));
         if (compressedDataIn_arg.gcount()!= sizeof (readChar))
           valid_stream = false;
-        if (readChar != frameHeaderIdentifier_[headerIdPos++])
-          headerIdPos = (frameHeaderIdentifier_[0] == readChar) ? 1 : 0;
+        if (readChar != frameHeaderIdentifier_[keyIdPos++])
+          keyIdPos = (frameHeaderIdentifier_[0] == readChar) ? 1 : 0;
+        if (readChar != frameDeltaHeaderIdentifier_[deltaIdPos++])
+          deltaIdPos = (frameDeltaHeaderIdentifier_[0] == readChar) ? 1 : 0;
 
         valid_stream &= compressedDataIn_arg.good ();
       }
+      const bool deltaFrame = (deltaIdPos == deltaIdLength);
 
       if (valid_stream) {
 
@@ -325,21 +508,126 @@ namespace pcl
         compressedDataIn_arg.read (reinterpret_cast<char*> (&disparityScale), sizeof (disparityScale));
         compressedDataIn_arg.read (reinterpret_cast<char*> (&disparityShift), sizeof (disparityShift));
 
+        // reading tile size and mask of changed tiles of delta frames
+        uint32_t tileSize = 0;
+        uint32_t tileMaskSize = 0;
+        std::vector<uint8_t> tileMask;
+        if (deltaFrame)
+        {
+          compressedDataIn_arg.read (reinterpret_cast<char*> (&tileSize), sizeof (tileSize));
+          compressedDataIn_arg.read (reinterpret_cast<char*> (&tileMaskSize), sizeof (tileMaskSize));
+
+          const uint64_t nrTiles = tileSize ? static_cast<uint64_t> ((cloud_width + tileSize - 1) / tileSize) *
+                                              ((cloud_height + tileSize - 1) / tileSize) : 0;
+          if (!compressedDataIn_arg.good () || !tileSize || tileMaskSize != 2 * ((nrTiles + 7) / 8))
+          {
+            PCL_ERROR ("[pcl::io::OrganizedPointCloudCompression::decodePointCloud] Invalid delta frame header!\n");
+            return (false);
+          }
+          tileMask.resize (tileMaskSize);
+          compressedDataIn_arg.read (reinterpret_cast<char*> (tileMask.data ()), tileMaskSize * sizeof(uint8_t));
+        }
+
         // reading compressed disparity data
         compressedDataIn_arg.read (reinterpret_cast<char*> (&compressedDisparitySize), sizeof (compressedDisparitySize));
         compressedDisparity.resize (compressedDisparitySize);
-        compressedDataIn_arg.read (reinterpret_cast<char*> (&compressedDisparity[0]), compressedDisparitySize * sizeof(uint8_t));
+        compressedDataIn_arg.read (reinterpret_cast<char*> (compressedDisparity.data ()), compressedDisparitySize * sizeof(uint8_t));
 
         // reading compressed rgb data
         compressedDataIn_arg.read (reinterpret_cast<char*> (&compressedColorSize), sizeof (compressedColorSize));
         compressedColor.resize (compressedColorSize);
-        compressedDataIn_arg.read (reinterpret_cast<char*> (&compressedColor[0]), compressedColorSize * sizeof(uint8_t));
+        compressedDataIn_arg.read (reinterpret_cast<char*> (compressedColor.data ()), compressedColorSize * sizeof(uint8_t));
 
-        // decode PNG compressed disparity data
-        decodePNGToImage (compressedDisparity, disparityData, png_width, png_height, png_channels);
+        // decode predictively coded or PNG compressed disparity data
+        if (DepthImageCoder::isDepthImageStream (compressedDisparity.data (), compressedDisparity.size ()))
+        {
+          uint32_t depth_width, depth_height;
+          if (!depth_coder_.decode (compressedDisparity, disparityData, depth_width, depth_height) ||
+              depth_width != cloud_width || depth_height != cloud_height)
+            return (false);
+        }
+        else
+          decodePNGToImage (compressedDisparity, disparityData, png_width, png_height, png_channels);
 
         // decode PNG compressed rgb data
         decodePNGToImage (compressedColor, colorData, png_width, png_height, png_channels);
+
+        ReferenceFrame& reference = decoder_reference_;
+        const size_t cloud_size = static_cast<size_t> (cloud_width) * cloud_height;
+
+        if (!deltaFrame)
+        {
+          // Keep the frame as reference of the following delta frames
+          reference.width = cloud_width;
+          reference.height = cloud_height;
+          reference.channels = colorData.empty () ? 0 : png_channels;
+          reference.focalLength = focalLength;
+          reference.disparity = disparityData;
+          reference.color = colorData;
+        }
+        else
+        {
+          if (reference.width != cloud_width || reference.height != cloud_height ||
+              reference.disparity.size () != cloud_size)
+          {
+            PCL_ERROR ("[pcl::io::OrganizedPointCloudCompression::decodePointCloud] Delta frame without a matching keyframe!\n");
+            return (false);
+          }
+
+          const uint32_t tiles_x = (cloud_width + tileSize - 1) / tileSize;
+          const uint32_t tiles_y = (cloud_height + tileSize - 1) / tileSize;
+          const uint32_t tileMaskBytes = tileMaskSize / 2;
+          const unsigned int channels = reference.channels;
+          if ((!disparityData.empty () && disparityData.size () != cloud_size) ||
+              (!colorData.empty () && colorData.size () != cloud_size * channels))
+          {
+            PCL_ERROR ("[pcl::io::OrganizedPointCloudCompression::decodePointCloud] Invalid delta frame!\n");
+            return (false);
+          }
+
+          // Update the changed tiles of the reference
+          for (uint32_t ty = 0; ty < tiles_y; ++ty)
+            for (uint32_t tx = 0; tx < tiles_x; ++tx)
+            {
+              const uint32_t tile = ty * tiles_x + tx;
+              if (!(tileMask[tile / 8] & (1 << (tile % 8))))
+                continue;
+              const bool replace = (tileMask[tileMaskBytes + tile / 8] & (1 << (tile % 8))) != 0;
+
+              const uint32_t x_end = std::min (cloud_width, (tx + 1) * tileSize);
+              const uint32_t y_end = std::min (cloud_height, (ty + 1) * tileSize);
+              for (uint32_t y = ty * tileSize; y < y_end; ++y)
+                for (uint32_t x = tx * tileSize; x < x_end; ++x)
+                {
+                  const size_t i = static_cast<size_t> (y) * cloud_width + x;
+                  if (!disparityData.empty ())
+                  {
+                    const unsigned int zigzag = disparityData[i];
+                    reference.disparity[i] = replace ? disparityData[i] :
+                                             static_cast<uint16_t> (reference.disparity[i] + ((zigzag >> 1) ^ (0u - (zigzag & 1))));
+                  }
+                  else if (replace)
+                    reference.disparity[i] = 0;
+
+                  for (unsigned int c = 0; c < channels; ++c)
+                  {
+                    const size_t j = i * channels + c;
+                    if (!colorData.empty ())
+                    {
+                      const unsigned int zigzag = colorData[j];
+                      reference.color[j] = replace ? colorData[j] :
+                                           static_cast<uint8_t> (reference.color[j] + ((zigzag >> 1) ^ (0u - (zigzag & 1))));
+                    }
+                    else if (replace)
+                      reference.color[j] = 0;
+                  }
+                }
+            }
+
+          disparityData = reference.disparity;
+          colorData = reference.color;
+          png_channels = channels ? channels : 1;
+        }
       }
 
       if (disparityShift==0.0f)
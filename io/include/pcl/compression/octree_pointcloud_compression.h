@@ -51,6 +51,7 @@
 #include <cstring>
 #include <iostream>
 #include <iterator>
+#include <thread>
 #include <vector>
 
 using namespace pcl::octree;
@@ -117,7 +118,7 @@ namespace pcl
           compressed_point_data_len_ (), compressed_color_data_len_ (), selected_profile_(compressionProfile_arg),
           point_resolution_(pointResolution_arg), octree_resolution_(octreeResolution_arg),
           color_bit_resolution_(colorBitResolution_arg),
-          object_count_(0)
+          object_count_(0), nr_blocks_ (1), threads_ (1), block_coders_ (), entropy_coding_ (RANGE_CODER)
         {
           initialization();
         }
@@ -144,6 +145,7 @@ namespace pcl
             point_coder_.setPrecision (static_cast<float> (selectedProfile.pointResolution));
             do_color_encoding_ = selectedProfile.doColorEncoding;
             color_coder_.setBitDepth (selectedProfile.colorBitResolution);
+            entropy_coding_ = selectedProfile.entropyCoder;
 
           }
           else 
@@ -204,8 +206,87 @@ namespace pcl
         void
         decodePointCloud (std::istream& compressed_tree_data_in_arg, PointCloudPtr &cloud_arg);
 
+        /** \brief Split every encoded frame into spatial blocks that are coded independently
+          * \note With more than one block, the cloud is cut into slabs of equal point count along the longest
+          * axis of its bounding box and every slab is coded by its own encoder, so blocks can be encoded and
+          * decoded in parallel (see \ref setNumberOfThreads). Each block keeps its own octree between frames,
+          * so prediction frames still apply per block. The blocks are written as one block frame, versioned by
+          * \ref octreeBlockFrameVersion_; decodePointCloud reads both frame formats.
+          * \param nr_blocks_arg: number of blocks per frame, 1 (default) writes the single stream format
+          */
+        inline void
+        setNumberOfBlocks (unsigned int nr_blocks_arg)
+        {
+          nr_blocks_ = nr_blocks_arg > 0 ? nr_blocks_arg : 1;
+        }
+
+        /** \brief Get the number of spatial blocks every encoded frame is split into */
+        inline unsigned int
+        getNumberOfBlocks () const
+        {
+          return (nr_blocks_);
+        }
+
+        /** \brief Set the number of threads coding the blocks of a block frame
+          * \param nr_threads_arg: number of threads, 0 uses the number of hardware threads
+          */
+        inline void
+        setNumberOfThreads (unsigned int nr_threads_arg = 0)
+        {
+          if (nr_threads_arg == 0)
+            nr_threads_arg = std::thread::hardware_concurrency ();
+          threads_ = nr_threads_arg > 0 ? nr_threads_arg : 1;
+        }
+
+        /** \brief Select the entropy coder of encoded frames
+          * \note Frames coded with \ref RANS_CODER are written under their own frame header identifier and cannot
+          * be read by decoders predating it; decodePointCloud follows the coder of every frame it reads.
+          * \param entropy_coding_arg: entropy coder
+          */
+        inline void
+        setEntropyCoder (entropy_Coders_e entropy_coding_arg)
+        {
+          entropy_coding_ = entropy_coding_arg;
+        }
+
+        /** \brief Get the entropy coder of encoded frames, or of the most recently decoded single stream frame */
+        inline entropy_Coders_e
+        getEntropyCoder () const
+        {
+          return (entropy_coding_);
+        }
+
       protected:
 
+        /** \brief Encode point cloud as a frame of independently coded spatial blocks
+          * \param cloud_arg:  point cloud to be compressed
+          * \param compressed_tree_data_out_arg:  binary output stream containing compressed data
+          */
+        void
+        encodeBlocks (const PointCloudConstPtr &cloud_arg, std::ostream& compressed_tree_data_out_arg);
+
+        /** \brief Decode the blocks of a block frame, following its header identifier
+          * \param compressed_tree_data_in_arg: binary input stream
+          * \param cloud_arg: reference to decoded point cloud
+          */
+        void
+        decodeBlocks (std::istream& compressed_tree_data_in_arg, PointCloudPtr &cloud_arg);
+
+        /** \brief Split the finite points of a cloud into slabs of equal point count along the longest axis
+          * \param cloud_arg: point cloud to be split
+          * \param nr_blocks_arg: maximum number of slabs
+          * \param block_indices_arg: point indices of every non-empty slab
+          */
+        void
+        partitionIntoBlocks (const PointCloud &cloud_arg, unsigned int nr_blocks_arg,
+                             std::vector<std::vector<int> > &block_indices_arg) const;
+
+        /** \brief Call block_functor_arg for every block index below nr_blocks_arg on up to threads_ threads
+          * \note An exception thrown for any block is rethrown once all threads finished.
+          */
+        template<typename BlockFunctor> void
+        runBlocks (unsigned int nr_blocks_arg, BlockFunctor block_functor_arg) const;
+
         /** \brief Write frame information to output stream
           * \param compressed_tree_data_out_arg: binary output stream
           */
@@ -220,8 +301,10 @@ namespace pcl
 
         /** \brief Synchronize to frame header
           * \param compressed_tree_data_in_arg: binary input stream
+          * \note Sets the entropy coder to the one of a single stream frame header.
+          * \return true if the header found starts a block frame
           */
-        void
+        bool
         syncToHeader (std::istream& compressed_tree_data_in_arg);
 
         /** \brief Apply entropy encoding to encoded information and output to binary stream
@@ -275,6 +358,9 @@ namespace pcl
         /** \brief Static range coder instance */
         StaticRangeCoder entropy_coder_;
 
+        /** \brief Interleaved rANS coder instance */
+        InterleavedRANSCoder rans_coder_;
+
         bool do_voxel_grid_enDecoding_;
         uint32_t i_frame_rate_;
         uint32_t i_frame_counter_;
@@ -302,11 +388,37 @@ namespace pcl
 
         std::size_t object_count_;
 
+        /** \brief Number of spatial blocks every encoded frame is split into */
+        unsigned int nr_blocks_;
+
+        /** \brief Number of threads coding blocks */
+        unsigned int threads_;
+
+        /** \brief Encoder or decoder of every block, keeping its octree between frames */
+        std::vector<Ptr> block_coders_;
+
+        // block frame header identifier
+        static const char* block_frame_header_identifier_;
+
+        /** \brief Entropy coder of the data vectors */
+        entropy_Coders_e entropy_coding_;
+
+        // frame header identifier of rANS coded frames
+        static const char* rans_frame_header_identifier_;
+
       };
 
     // define frame identifier
     template<typename PointT, typename LeafT, typename BranchT, typename OctreeT>
       const char* OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::frame_header_identifier_ = "<PCL-OCT-COMPRESSED>";
+
+    // define block frame identifier
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT>
+      const char* OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::block_frame_header_identifier_ = "<PCL-OCT-BLOCKS>";
+
+    // define rANS frame identifier
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT>
+      const char* OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::rans_frame_header_identifier_ = "<PCL-OCT-RANS>";
   }
 
 }
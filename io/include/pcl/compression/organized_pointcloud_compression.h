@@ -46,6 +46,7 @@
 #include <pcl/common/common.h>
 #include <pcl/common/io.h>
 
+#include <pcl/compression/depth_image_coder.h>
 #include <pcl/io/openni_camera/openni_shift_to_depth_conversion.h>
 
 #include <vector>
@@ -66,6 +67,12 @@ namespace pcl
 
         /** \brief Empty Constructor. */
         OrganizedPointCloudCompression ()
+          : predictive_depth_coding_ (false)
+          , keyframe_interval_ (1)
+          , tile_size_ (16)
+          , depth_change_threshold_ (0)
+          , color_change_threshold_ (0)
+          , frames_since_keyframe_ (0)
         {
         }
 
@@ -127,6 +134,107 @@ namespace pcl
                                PointCloudPtr &cloud_arg,
                                bool bShowStatistics_arg = true);
 
+        /** \brief Code disparity maps predictively with \ref DepthImageCoder rather than as PNG
+         * \note The PNG level passed to the encoders then only applies to color images. The
+         * maximum error, strips and threads of the coding are set on \ref getDepthImageCoder.
+         * decodePointCloud detects the coding of every frame it reads, but decoders predating
+         * predictive coding cannot read such frames.
+         * \param[in] predictive_depth_coding_arg: true to code disparity maps predictively
+         */
+        inline void
+        setPredictiveDepthCoding (bool predictive_depth_coding_arg)
+        {
+          predictive_depth_coding_ = predictive_depth_coding_arg;
+        }
+
+        /** \brief Get whether disparity maps are coded predictively */
+        inline bool
+        getPredictiveDepthCoding () const
+        {
+          return (predictive_depth_coding_);
+        }
+
+        /** \brief Get the coder of predictively coded disparity maps, which also sets the number of threads decoding them */
+        inline DepthImageCoder&
+        getDepthImageCoder ()
+        {
+          return (depth_coder_);
+        }
+
+        /** \brief Set the number of frames from one keyframe to the next
+         * \note Frames between keyframes are delta frames, which code the change of the disparity
+         * map and color image against the previous frame as the decoder reconstructs it. Tiles
+         * without changes are skipped, changed tiles are coded as differences or, where that is
+         * cheaper, anew. A keyframe is also coded whenever the image size or the color coding
+         * changes. Streams have to be decoded from a keyframe on, in order, by a
+         * single decoder; decoders predating delta frames skip them.
+         * \param[in] keyframe_interval_arg: keyframe interval, 0 or 1 codes every frame as keyframe (default)
+         */
+        inline void
+        setKeyframeInterval (unsigned int keyframe_interval_arg)
+        {
+          keyframe_interval_ = keyframe_interval_arg;
+        }
+
+        /** \brief Get the number of frames from one keyframe to the next */
+        inline unsigned int
+        getKeyframeInterval () const
+        {
+          return (keyframe_interval_);
+        }
+
+        /** \brief Set the edge length of the square tiles delta frames skip if unchanged
+         * \param[in] tile_size_arg: tile size in pixels (default: 16)
+         */
+        inline void
+        setTileSize (unsigned int tile_size_arg)
+        {
+          tile_size_ = tile_size_arg > 0 ? tile_size_arg : 1;
+        }
+
+        /** \brief Get the edge length of the square tiles delta frames skip if unchanged */
+        inline unsigned int
+        getTileSize () const
+        {
+          return (tile_size_);
+        }
+
+        /** \brief Set the largest disparity change a delta frame ignores
+         * \note A tile is skipped, keeping its previous content, if none of its disparities changed
+         * by more than this threshold, no pixel turned valid or invalid and no color changed by
+         * more than the color threshold. Tiles that are coded are coded losslessly, so errors
+         * stay bounded by the thresholds and do not accumulate.
+         * \param[in] depth_change_threshold_arg: disparity threshold, 0 skips unchanged tiles only (default)
+         */
+        inline void
+        setDepthChangeThreshold (unsigned int depth_change_threshold_arg)
+        {
+          depth_change_threshold_ = depth_change_threshold_arg;
+        }
+
+        /** \brief Get the largest disparity change a delta frame ignores */
+        inline unsigned int
+        getDepthChangeThreshold () const
+        {
+          return (depth_change_threshold_);
+        }
+
+        /** \brief Set the largest change of a color channel a delta frame ignores
+         * \param[in] color_change_threshold_arg: color threshold, 0 skips unchanged tiles only (default)
+         */
+        inline void
+        setColorChangeThreshold (unsigned int color_change_threshold_arg)
+        {
+          color_change_threshold_ = color_change_threshold_arg;
+        }
+
+        /** \brief Get the largest change of a color channel a delta frame ignores */
+        inline unsigned int
+        getColorChangeThreshold () const
+        {
+          return (color_change_threshold_);
+        }
+
       protected:
         /** \brief Analyze input point cloud and calculate the maximum depth and focal length
          * \param[in] cloud_arg: input point cloud
@@ -137,16 +245,100 @@ namespace pcl
                                     float& maxDepth_arg,
                                     float& focalLength_arg) const;
 
+        /** \brief Check whether the next frame can be coded as delta frame
+         * \param[in] width_arg: width of the disparity map/color image
+         * \param[in] height_arg: height of the disparity map/color image
+         * \param[in] channels_arg: number of coded color channels, 0 without color
+         */
+        bool isDeltaFrame (uint32_t width_arg,
+                           uint32_t height_arg,
+                           unsigned int channels_arg) const;
+
+        /** \brief Write a keyframe or delta frame and update the reference frame of the encoder
+         * \param[out] compressedDataOut_arg: binary output stream
+         * \param[in] deltaFrame_arg: code a delta frame, as checked by isDeltaFrame
+         * \param[in] width_arg: width of the disparity map/color image
+         * \param[in] height_arg: height of the disparity map/color image
+         * \param[in] maxDepth_arg: maximum depth
+         * \param[in] focalLength_arg: focal length
+         * \param[in] disparityShift_arg: disparity shift
+         * \param[in] disparityScale_arg: disparity scaling
+         * \param[in] disparityData_arg: disparity map
+         * \param[in] colorData_arg: mono or rgb color image, empty without color
+         * \param[in] channels_arg: number of color channels, 0 without color
+         * \param[in] pngLevel_arg: png compression level of disparity maps
+         * \param[in] bShowStatistics_arg: show the tiles of delta frames
+         * \param[out] compressedDisparitySize_arg: size of the compressed disparity map
+         * \param[out] compressedColorSize_arg: size of the compressed color image
+         */
+        void encodeFrame (std::ostream& compressedDataOut_arg,
+                          bool deltaFrame_arg,
+                          uint32_t width_arg,
+                          uint32_t height_arg,
+                          float maxDepth_arg,
+                          float focalLength_arg,
+                          float disparityShift_arg,
+                          float disparityScale_arg,
+                          std::vector<uint16_t>& disparityData_arg,
+                          std::vector<uint8_t>& colorData_arg,
+                          unsigned int channels_arg,
+                          int pngLevel_arg,
+                          bool bShowStatistics_arg,
+                          uint32_t& compressedDisparitySize_arg,
+                          uint32_t& compressedColorSize_arg);
+
+        /** \brief Disparity map and color image delta frames are coded against */
+        struct ReferenceFrame
+        {
+          ReferenceFrame () : width (0), height (0), channels (0), focalLength (0.0f) {}
+
+          uint32_t width;
+          uint32_t height;
+          unsigned int channels;
+          float focalLength;
+          std::vector<uint16_t> disparity;
+          std::vector<uint8_t> color;
+        };
+
       private:
         // frame header identifier
         static const char* frameHeaderIdentifier_;
 
+        // delta frame header identifier
+        static const char* frameDeltaHeaderIdentifier_;
+
         //
         openni_wrapper::ShiftToDepthConverter sd_converter_;
+
+        // code disparity maps with depth_coder_ rather than as PNG
+        bool predictive_depth_coding_;
+
+        // coder of predictively coded disparity maps
+        DepthImageCoder depth_coder_;
+
+        // number of frames from one keyframe to the next
+        unsigned int keyframe_interval_;
+
+        // edge length of the tiles of delta frames
+        unsigned int tile_size_;
+
+        // largest changes delta frames ignore
+        unsigned int depth_change_threshold_;
+        unsigned int color_change_threshold_;
+
+        // number of delta frames encoded since the last keyframe
+        unsigned int frames_since_keyframe_;
+
+        // last frame as reconstructed by the decoder, on the encoder and decoder side
+        ReferenceFrame encoder_reference_;
+        ReferenceFrame decoder_reference_;
     };
 
     // define frame identifier
     template<typename PointT>
     const char* OrganizedPointCloudCompression<PointT>::frameHeaderIdentifier_ = "<PCL-ORG-COMPRESSED>";
+
+    template<typename PointT>
+    const char* OrganizedPointCloudCompression<PointT>::frameDeltaHeaderIdentifier_ = "<PCL-ORG-DELTA>";
   }
 }
@@ -63,9 +63,7 @@ pcl::io::LZFDepth16ImageReader::read (
   }
 
   std::vector<char> uncompressed_data (uncompressed_size);
-  decompress (compressed_data, uncompressed_data);
-
-  if (uncompressed_data.empty ())
+  if (!decompressDepth (compressed_data, uncompressed_data) || uncompressed_data.empty ())
   {
     PCL_ERROR ("[pcl::io::LZFDepth16ImageReader::read] Error uncompressing data stored in %s!\n", filename.c_str ());
     return (false);
@@ -129,9 +127,7 @@ pcl::io::LZFDepth16ImageReader::readOMP (const std::string &filename,
   }
 
   std::vector<char> uncompressed_data (uncompressed_size);
-  decompress (compressed_data, uncompressed_data);
-
-  if (uncompressed_data.empty ())
+  if (!decompressDepth (compressed_data, uncompressed_data, num_threads) || uncompressed_data.empty ())
   {
     PCL_ERROR ("[pcl::io::LZFDepth16ImageReader::read] Error uncompressing data stored in %s!\n", filename.c_str ());
     return (false);
@@ -39,6 +39,7 @@
 
 #include <pcl/pcl_macros.h>
 #include <pcl/point_cloud.h>
+#include <pcl/compression/depth_image_coder.h>
 #include <vector>
 
 namespace pcl
@@ -69,6 +70,7 @@ namespace pcl
       *  * LZF compressed 8-bit Bayer data
       *  * LZF compressed 16-bit YUV422 data
       *  * LZF compressed 16-bit depth data
+      *  * predictively coded 16-bit depth data (see \ref DepthImageCoder)
       *
       * Please note that files found using the above mentioned extensions will be treated
       * as such. Inherit from this class and overwrite the I/O methods if you plan to change 
@@ -220,6 +222,18 @@ namespace pcl
         readParameters (std::istream& is) override;
 
       protected:
+        /** \brief Decompress the depth data of a file, which is either LZF compressed or, for
+          * files of image type "depth16p", coded by \ref DepthImageCoder.
+          * \param[in] input the array to decompress
+          * \param[out] output the decompressed depth image (must be pre-allocated!)
+          * \param[in] num_threads the number of threads decoding predictively coded data, 0 for the number of hardware threads
+          * \return true if operation successful, false otherwise
+          */
+        bool
+        decompressDepth (const std::vector<char> &input,
+                         std::vector<char> &output,
+                         unsigned int num_threads = 1);
+
         /** \brief Z-value depth multiplication factor 
           * (i.e., if raw data is in [mm] and we want [m], we need to multiply with 0.001)
           */
@@ -360,6 +374,7 @@ namespace pcl
       *  * LZF compressed 8-bit Bayer data
       *  * LZF compressed 16-bit YUV422 data
       *  * LZF compressed 16-bit depth data
+      *  * predictively coded 16-bit depth data (see \ref DepthImageCoder)
       *
       * Please note that files found using the above mentioned extensions will be treated
       * as such. Inherit from this class and overwrite the I/O methods if you plan to change 
@@ -464,6 +479,20 @@ namespace pcl
                   uint32_t width, uint32_t height,
                   const std::string &image_type,
                   char *output);
+
+        /** \brief Write the PCL-LZF file header.
+          * \param[in] width the with of the data array
+          * \param[in] height the height of the data array
+          * \param[in] image_type the type of the image, an up to 16 characters string
+          * \param[in] compressed_size the number of bytes of compressed data following the header
+          * \param[in] uncompressed_size the number of bytes of the uncompressed data
+          * \param[out] output the output array the header is written to the front of
+          */
+        void
+        writeHeader (uint32_t width, uint32_t height,
+                     const std::string &image_type,
+                     uint32_t compressed_size, uint32_t uncompressed_size,
+                     char *output);
     };
 
     /** \brief PCL-LZF 16-bit depth image format writer.
@@ -482,6 +511,7 @@ namespace pcl
         /** Empty constructor */
         LZFDepth16ImageWriter () 
           : z_multiplication_factor_ (0.001)      // Set default multiplication factor
+          , predictive_coding_ (false)
         {}
 
         /** Empty destructor */
@@ -515,11 +545,43 @@ namespace pcl
         writeParameters (const CameraParameters &parameters,
                          const std::string &filename) override;
 
+        /** \brief Code depth images predictively with \ref DepthImageCoder rather than with LZF.
+          * \note Predictively coded files are written with the image type "depth16p". They are
+          * usually less than half the size of LZF compressed ones and are read transparently by
+          * \ref LZFDepth16ImageReader, but not by readers predating this format.
+          * \param[in] predictive_coding true to code depth images predictively
+          */
+        inline void
+        setPredictiveCoding (bool predictive_coding)
+        {
+          predictive_coding_ = predictive_coding;
+        }
+
+        /** \brief Get whether depth images are coded predictively. */
+        inline bool
+        getPredictiveCoding () const
+        {
+          return (predictive_coding_);
+        }
+
+        /** \brief Get the coder of predictively coded depth images, e.g. to set its maximum error or number of threads. */
+        inline DepthImageCoder&
+        getDepthImageCoder ()
+        {
+          return (depth_coder_);
+        }
+
       protected:
         /** \brief Z-value depth multiplication factor 
           * (i.e., if raw data is in [mm] and we want [m], we need to multiply with 0.001)
           */
         double z_multiplication_factor_;
+
+        /** \brief Code depth images with depth_coder_ rather than with LZF. */
+        bool predictive_coding_;
+
+        /** \brief Coder of predictively coded depth images. */
+        DepthImageCoder depth_coder_;
     };
 
     /** \brief PCL-LZF 24-bit RGB image format writer.
@@ -0,0 +1,792 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/compression/depth_image_coder.h>
+#include <pcl/console/print.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <mutex>
+
+namespace
+{
+  using pcl::uint8_t;
+  using pcl::uint16_t;
+  using pcl::uint32_t;
+  using pcl::uint64_t;
+
+  // stream layout: signature, version, width, height, maximum error, number of strips,
+  // compressed size of every strip and the strips
+  const char depth_image_signature[] = {'P', 'C', 'L', 'D'};
+  const uint8_t depth_image_version = 1;
+  const size_t depth_image_header_size = sizeof (depth_image_signature) + sizeof (uint8_t) +
+                                         2 * sizeof (uint32_t) + sizeof (uint16_t) + sizeof (uint32_t);
+
+  const int max_value = 0xFFFF;
+
+  // 365 regular contexts followed by the two run interruption contexts
+  const int nr_regular_contexts = 365;
+  const int nr_contexts = nr_regular_contexts + 2;
+
+  // context statistics are halved once a context has seen reset_threshold samples
+  const int reset_threshold = 64;
+  const int min_bias = -128;
+  const int max_bias = 127;
+
+  // order of the run length segments per run index
+  const int run_order[32] = {0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                             4, 4, 5, 5, 6, 6, 7, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+  inline int
+  floorDiv (int num, int den)
+  {
+    return (num >= 0 ? num / den : -((den - 1 - num) / den));
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+  inline int
+  ceilDiv (int num, int den)
+  {
+    return (num >= 0 ? (num + den - 1) / den : -((-num) / den));
+  }
+
+  /** \brief Coding parameters derived from the maximum error */
+  struct CodingParameters
+  {
+    explicit CodingParameters (int max_error)
+      : near (max_error)
+      , delta (2 * max_error + 1)
+    {
+      // JPEG-LS default gradient thresholds of 16-bit samples
+      t1 = std::min (18 + 3 * near, max_value);
+      t2 = std::min (82 + 5 * near, max_value);
+      t3 = std::min (306 + 7 * near, max_value);
+
+      // largest mapped residual, which bounds the escape code
+      max_mapped = 2 * (max_value / delta + 2) + 1;
+      for (qbpp = 1; (max_mapped >> qbpp) > 0; ++qbpp);
+      limit = 2 * (qbpp + std::max (8, qbpp));
+
+      // residuals of depth images are small compared to the sample range, so contexts start at a
+      // small Golomb parameter rather than the JPEG-LS default, which strips would pay for each
+      initial_a = 4;
+    }
+
+    inline int
+    quantizeGradient (int gradient) const
+    {
+      if (gradient <= -t3) return (-4);
+      if (gradient <= -t2) return (-3);
+      if (gradient <= -t1) return (-2);
+      if (gradient < -near) return (-1);
+      if (gradient <= near) return (0);
+      if (gradient < t1) return (1);
+      if (gradient < t2) return (2);
+      if (gradient < t3) return (3);
+      return (4);
+    }
+
+    /** \brief Quantize the residual of depth \a value to its prediction \a prediction
+      * \param[out] reconstructed the depth the decoder will reconstruct
+      * \return the quantized residual in steps of delta
+      */
+    inline int
+    quantizeResidual (int value, int prediction, int &reconstructed) const
+    {
+      const int residual = value - prediction;
+      int step = residual > 0 ? (residual + near) / delta : -((near - residual) / delta);
+
+      // keep invalid depths invalid and valid depths valid
+      if (value == 0)
+      {
+        if (prediction + step * delta > 0)
+          step = floorDiv (-prediction, delta);
+      }
+      else if (prediction + step * delta <= 0)
+        step = ceilDiv (1 - prediction, delta);
+
+      reconstructed = reconstruct (prediction, step);
+      return (step);
+    }
+
+    inline int
+    reconstruct (int prediction, int step) const
+    {
+      return (std::min (std::max (prediction + step * delta, 0), max_value));
+    }
+
+    int near;
+    int delta;
+    int t1, t2, t3;
+    int max_mapped;
+    int qbpp;
+    int limit;
+    int initial_a;
+  };
+
+  /** \brief Adaptive statistics of the contexts of one strip */
+  struct ContextStatistics
+  {
+    explicit ContextStatistics (const CodingParameters &parameters)
+      : run_index (0)
+    {
+      std::fill (a, a + nr_contexts, parameters.initial_a);
+      std::fill (n, n + nr_contexts, 1);
+      std::fill (b, b + nr_regular_contexts, 0);
+      std::fill (c, c + nr_regular_contexts, 0);
+      nn[0] = nn[1] = 0;
+    }
+
+    inline int
+    golombParameter (int context, int a_value) const
+    {
+      int k = 0;
+      while ((n[context] << k) < a_value)
+        ++k;
+      return (k);
+    }
+
+    inline void
+    updateRegular (int context, int residual, int delta)
+    {
+      b[context] += residual * delta;
+      a[context] += std::abs (residual);
+      if (n[context] == reset_threshold)
+      {
+        a[context] >>= 1;
+        b[context] = floorDiv (b[context], 2);
+        n[context] >>= 1;
+      }
+      ++n[context];
+
+      if (b[context] <= -n[context])
+      {
+        b[context] += n[context];
+        if (c[context] > min_bias)
+          --c[context];
+        if (b[context] <= -n[context])
+          b[context] = -n[context] + 1;
+      }
+      else if (b[context] > 0)
+      {
+        b[context] -= n[context];
+        if (c[context] < max_bias)
+          ++c[context];
+        if (b[context] > 0)
+          b[context] = 0;
+      }
+    }
+
+    inline void
+    updateInterruption (int type, int residual, int mapped)
+    {
+      const int context = nr_regular_contexts + type;
+      if (residual < 0)
+        ++nn[type];
+      a[context] += (mapped + 1) >> 1;
+      if (n[context] == reset_threshold)
+      {
+        a[context] >>= 1;
+        n[context] >>= 1;
+        nn[type] >>= 1;
+      }
+      ++n[context];
+    }
+
+    int a[nr_contexts];
+    int n[nr_contexts];
+    int b[nr_regular_contexts];
+    int c[nr_regular_contexts];
+    int nn[2];
+    int run_index;
+  };
+
+  /** \brief Neighborhood of a pixel and the context it selects */
+  struct Neighborhood
+  {
+    inline
+    Neighborhood (const uint16_t *row, const uint16_t *above, uint32_t col, uint32_t width,
+                  const CodingParameters &parameters)
+    {
+      b = above[col];
+      a = col > 0 ? row[col - 1] : b;
+      const int c = col > 0 ? above[col - 1] : b;
+      const int d = col + 1 < width ? above[col + 1] : b;
+
+      context = 81 * parameters.quantizeGradient (d - b) +
+                 9 * parameters.quantizeGradient (b - c) +
+                     parameters.quantizeGradient (c - a);
+      sign = 1;
+      if (context < 0)
+      {
+        context = -context;
+        sign = -1;
+      }
+
+      // median edge detector
+      if (c >= std::max (a, b))
+        prediction = std::min (a, b);
+      else if (c <= std::min (a, b))
+        prediction = std::max (a, b);
+      else
+        prediction = a + b - c;
+    }
+
+    int a, b;
+    int context;
+    int sign;
+    int prediction;
+  };
+
+  /** \brief A pixel continues a run if it is as valid as the run value and close enough to it */
+  inline bool
+  continuesRun (int value, int run_value, int near)
+  {
+    return (std::abs (value - run_value) <= near && ((value == 0) == (run_value == 0)));
+  }
+
+  /** \brief MSB first bit writer */
+  class BitWriter
+  {
+    public:
+      explicit BitWriter (std::vector<uint8_t> &output)
+        : output_ (output)
+        , buffer_ (0)
+        , bits_ (0)
+      {
+      }
+
+      /** \brief Write the \a nr_bits (at most 32) lowest bits of \a value */
+      inline void
+      write (uint32_t value, int nr_bits)
+      {
+        buffer_ = (buffer_ << nr_bits) | (value & ((static_cast<uint64_t> (1) << nr_bits) - 1));
+        bits_ += nr_bits;
+        while (bits_ >= 8)
+        {
+          bits_ -= 8;
+          output_.push_back (static_cast<uint8_t> (buffer_ >> bits_));
+        }
+      }
+
+      inline void
+      writeZeros (int nr_bits)
+      {
+        for (; nr_bits > 32; nr_bits -= 32)
+          write (0, 32);
+        write (0, nr_bits);
+      }
+
+      /** \brief Write the limited length Golomb-Rice code of \a value */
+      inline void
+      writeGolomb (uint32_t value, int k, int limit, int qbpp)
+      {
+        const uint32_t high = value >> k;
+        const uint32_t escape = static_cast<uint32_t> (limit - qbpp - 1);
+        if (high < escape)
+        {
+          writeZeros (static_cast<int> (high));
+          write (1, 1);
+          if (k > 0)
+            write (value, k);
+        }
+        else
+        {
+          writeZeros (static_cast<int> (escape));
+          write (1, 1);
+          write (value - 1, qbpp);
+        }
+      }
+
+      inline void
+      flush ()
+      {
+        if (bits_ > 0)
+          output_.push_back (static_cast<uint8_t> (buffer_ << (8 - bits_)));
+        bits_ = 0;
+      }
+
+    private:
+      std::vector<uint8_t> &output_;
+      uint64_t buffer_;
+      int bits_;
+  };
+
+  /** \brief MSB first bit reader, returning zeros past the end of its data */
+  class BitReader
+  {
+    public:
+      BitReader (const uint8_t *data, size_t size)
+        : data_ (data)
+        , end_ (data + size)
+        , buffer_ (0)
+        , bits_ (0)
+        , overrun_ (false)
+      {
+      }
+
+      /** \brief Read \a nr_bits (at most 32) bits */
+      inline uint32_t
+      read (int nr_bits)
+      {
+        while (bits_ < nr_bits)
+        {
+          uint64_t byte = 0;
+          if (data_ < end_)
+            byte = *data_++;
+          else
+            overrun_ = true;
+          buffer_ = (buffer_ << 8) | byte;
+          bits_ += 8;
+        }
+        bits_ -= nr_bits;
+        return (static_cast<uint32_t> ((buffer_ >> bits_) & ((static_cast<uint64_t> (1) << nr_bits) - 1)));
+      }
+
+      /** \brief Read the limited length Golomb-Rice code of a value */
+      inline uint32_t
+      readGolomb (int k, int limit, int qbpp)
+      {
+        const uint32_t escape = static_cast<uint32_t> (limit - qbpp - 1);
+        uint32_t high = 0;
+        while (read (1) == 0)
+        {
+          if (++high > escape || overrun_)
+          {
+            overrun_ = true;
+            return (0);
+          }
+        }
+
+        if (high < escape)
+          return (k > 0 ? (high << k) | read (k) : high);
+        return (read (qbpp) + 1);
+      }
+
+      /** \brief True if more bits were read than the data holds */
+      inline bool
+      overrun () const
+      {
+        return (overrun_);
+      }
+
+    private:
+      const uint8_t *data_;
+      const uint8_t *end_;
+      uint64_t buffer_;
+      int bits_;
+      bool overrun_;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+  void
+  encodeStrip (const uint16_t *image, uint32_t width, uint32_t first_row, uint32_t end_row,
+               const CodingParameters &parameters, std::vector<uint8_t> &output)
+  {
+    ContextStatistics statistics (parameters);
+    BitWriter writer (output);
+
+    // the reconstructed rows the decoder predicts from; the strip starts below a row of zeros
+    std::vector<uint16_t> zeros (width, 0);
+    std::vector<uint16_t> rows (2 * static_cast<size_t> (width));
+
+    for (uint32_t y = first_row; y < end_row; ++y)
+    {
+      const uint16_t *input = image + static_cast<size_t> (y) * width;
+      uint16_t *row = &rows[(y & 1) * static_cast<size_t> (width)];
+      const uint16_t *above = y == first_row ? &zeros[0] : &rows[((y - 1) & 1) * static_cast<size_t> (width)];
+
+      uint32_t col = 0;
+      while (col < width)
+      {
+        const Neighborhood neighborhood (row, above, col, width, parameters);
+
+        if (neighborhood.context != 0)
+        {
+          // regular mode
+          const int context = neighborhood.context;
+          const int prediction = std::min (std::max (neighborhood.prediction + neighborhood.sign * statistics.c[context], 0), max_value);
+          const int k = statistics.golombParameter (context, statistics.a[context]);
+
+          int reconstructed;
+          const int residual = neighborhood.sign * parameters.quantizeResidual (input[col], prediction, reconstructed);
+          row[col++] = static_cast<uint16_t> (reconstructed);
+
+          uint32_t mapped;
+          if (parameters.near == 0 && k == 0 && 2 * statistics.b[context] <= -statistics.n[context])
+            mapped = residual >= 0 ? 2 * residual + 1 : -2 * (residual + 1);
+          else
+            mapped = residual >= 0 ? 2 * residual : -2 * residual - 1;
+
+          writer.writeGolomb (mapped, k, parameters.limit, parameters.qbpp);
+          statistics.updateRegular (context, residual, parameters.delta);
+          continue;
+        }
+
+        // run mode: count the pixels matching the left neighbor
+        const int run_value = neighborhood.a;
+        uint32_t run_length = 0;
+        while (col < width && continuesRun (input[col], run_value, parameters.near))
+        {
+          row[col++] = static_cast<uint16_t> (run_value);
+          ++run_length;
+        }
+
+        while (run_length >= (1u << run_order[statistics.run_index]))
+        {
+          writer.write (1, 1);
+          run_length -= 1u << run_order[statistics.run_index];
+          if (statistics.run_index < 31)
+            ++statistics.run_index;
+        }
+
+        if (col == width)
+        {
+          // a run reaching the end of the row is not interrupted
+          if (run_length > 0)
+            writer.write (1, 1);
+          continue;
+        }
+
+        writer.write (0, 1);
+        if (run_order[statistics.run_index] > 0)
+          writer.write (run_length, run_order[statistics.run_index]);
+
+        // run interruption pixel
+        const int b = above[col];
+        const int type = std::abs (run_value - b) <= parameters.near ? 1 : 0;
+        const int sign = (type == 0 && run_value > b) ? -1 : 1;
+        const int context = nr_regular_contexts + type;
+        const int k = statistics.golombParameter (context, statistics.a[context] + (type ? statistics.n[context] >> 1 : 0));
+
+        int reconstructed;
+        const int residual = sign * parameters.quantizeResidual (input[col], type ? run_value : b, reconstructed);
+        row[col++] = static_cast<uint16_t> (reconstructed);
+
+        const bool cond = k != 0 || 2 * statistics.nn[type] >= statistics.n[context];
+        const int map = ((residual > 0 && !cond) || (residual < 0 && cond)) ? 1 : 0;
+        const int mapped = 2 * std::abs (residual) - map;
+
+        writer.writeGolomb (mapped, k, parameters.limit - run_order[statistics.run_index] - 1, parameters.qbpp);
+        statistics.updateInterruption (type, residual, mapped);
+        if (statistics.run_index > 0)
+          --statistics.run_index;
+      }
+    }
+
+    writer.flush ();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+  bool
+  decodeStrip (const uint8_t *data, size_t size, uint32_t width, uint32_t first_row, uint32_t end_row,
+               const CodingParameters &parameters, uint16_t *image)
+  {
+    ContextStatistics statistics (parameters);
+    BitReader reader (data, size);
+
+    std::vector<uint16_t> zeros (width, 0);
+
+    for (uint32_t y = first_row; y < end_row; ++y)
+    {
+      uint16_t *row = image + static_cast<size_t> (y) * width;
+      const uint16_t *above = y == first_row ? &zeros[0] : row - width;
+
+      uint32_t col = 0;
+      while (col < width)
+      {
+        const Neighborhood neighborhood (row, above, col, width, parameters);
+
+        if (neighborhood.context != 0)
+        {
+          // regular mode
+          const int context = neighborhood.context;
+          const int prediction = std::min (std::max (neighborhood.prediction + neighborhood.sign * statistics.c[context], 0), max_value);
+          const int k = statistics.golombParameter (context, statistics.a[context]);
+
+          const int mapped = static_cast<int> (reader.readGolomb (k, parameters.limit, parameters.qbpp));
+          if (mapped > parameters.max_mapped)
+            return (false);
+          int residual;
+          if (parameters.near == 0 && k == 0 && 2 * statistics.b[context] <= -statistics.n[context])
+            residual = (mapped & 1) ? (mapped - 1) / 2 : -(mapped / 2) - 1;
+          else
+            residual = (mapped & 1) ? -((mapped + 1) / 2) : mapped / 2;
+
+          row[col++] = static_cast<uint16_t> (parameters.reconstruct (prediction, neighborhood.sign * residual));
+          statistics.updateRegular (context, residual, parameters.delta);
+          continue;
+        }
+
+        // run mode
+        const int run_value = neighborhood.a;
+        bool interrupted = true;
+        while (reader.read (1) == 1)
+        {
+          const uint32_t segment = 1u << run_order[statistics.run_index];
+          const uint32_t run_length = std::min (segment, width - col);
+          std::fill (row + col, row + col + run_length, static_cast<uint16_t> (run_value));
+          col += run_length;
+
+          if (run_length == segment && statistics.run_index < 31)
+            ++statistics.run_index;
+          if (col == width || reader.overrun ())
+          {
+            interrupted = false;
+            break;
+          }
+        }
+
+        if (!interrupted)
+          continue;
+
+        const uint32_t run_length = run_order[statistics.run_index] > 0 ? reader.read (run_order[statistics.run_index]) : 0;
+        if (run_length >= width - col)
+          return (false);
+        std::fill (row + col, row + col + run_length, static_cast<uint16_t> (run_value));
+        col += run_length;
+
+        // run interruption pixel
+        const int b = above[col];
+        const int type = std::abs (run_value - b) <= parameters.near ? 1 : 0;
+        const int sign = (type == 0 && run_value > b) ? -1 : 1;
+        const int context = nr_regular_contexts + type;
+        const int k = statistics.golombParameter (context, statistics.a[context] + (type ? statistics.n[context] >> 1 : 0));
+
+        const int mapped = static_cast<int> (reader.readGolomb (k, parameters.limit - run_order[statistics.run_index] - 1, parameters.qbpp));
+        if (mapped > parameters.max_mapped)
+          return (false);
+        const bool cond = k != 0 || 2 * statistics.nn[type] >= statistics.n[context];
+        const int magnitude = (mapped + (mapped & 1)) / 2;
+        const int residual = (cond == ((mapped & 1) != 0)) ? -magnitude : magnitude;
+
+        row[col++] = static_cast<uint16_t> (parameters.reconstruct (type ? run_value : b, sign * residual));
+        statistics.updateInterruption (type, residual, mapped);
+        if (statistics.run_index > 0)
+          --statistics.run_index;
+      }
+
+      if (reader.overrun ())
+        return (false);
+    }
+
+    return (true);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+  template<typename StripFunctor> void
+  runStrips (unsigned int nr_strips, unsigned int nr_threads, StripFunctor strip_functor)
+  {
+    std::atomic<unsigned int> next_strip (0);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    const auto worker = [&] ()
+    {
+      for (unsigned int strip = next_strip++; strip < nr_strips; strip = next_strip++)
+      {
+        try
+        {
+          strip_functor (strip);
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock (error_mutex);
+          if (!error)
+            error = std::current_exception ();
+        }
+      }
+    };
+
+    std::vector<std::thread> workers;
+    nr_threads = std::min (nr_threads, nr_strips);
+    for (unsigned int i = 1; i < nr_threads; ++i)
+      workers.emplace_back (worker);
+    worker ();
+    for (std::thread &thread : workers)
+      thread.join ();
+
+    if (error)
+      std::rethrow_exception (error);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+  inline uint32_t
+  stripRow (uint32_t strip, uint32_t nr_strips, uint32_t height)
+  {
+    return (static_cast<uint32_t> (static_cast<uint64_t> (strip) * height / nr_strips));
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::DepthImageCoder::encode (const uint16_t* image_arg,
+                                  uint32_t width_arg,
+                                  uint32_t height_arg,
+                                  std::vector<uint8_t>& compressed_arg) const
+{
+  const CodingParameters parameters (max_error_);
+  const uint32_t nr_strips = (width_arg > 0 && height_arg > 0) ? std::min (nr_strips_, height_arg) : 0;
+
+  std::vector<std::vector<uint8_t> > strips (nr_strips);
+  runStrips (nr_strips, threads_, [&] (unsigned int strip)
+  {
+    // reserve a quarter of the raw strip, which most depth images stay below
+    const uint32_t first_row = stripRow (strip, nr_strips, height_arg);
+    const uint32_t end_row = stripRow (strip + 1, nr_strips, height_arg);
+    strips[strip].reserve (static_cast<size_t> (end_row - first_row) * width_arg / 2);
+    encodeStrip (image_arg, width_arg, first_row, end_row, parameters, strips[strip]);
+  });
+
+  size_t compressed_size = depth_image_header_size + nr_strips * sizeof (uint32_t);
+  for (const std::vector<uint8_t> &strip : strips)
+    compressed_size += strip.size ();
+
+  compressed_arg.resize (compressed_size);
+  uint8_t *output = &compressed_arg[0];
+
+  const uint16_t max_error = static_cast<uint16_t> (max_error_);
+  memcpy (output, depth_image_signature, sizeof (depth_image_signature)); output += sizeof (depth_image_signature);
+  memcpy (output, &depth_image_version, sizeof (depth_image_version)); output += sizeof (depth_image_version);
+  memcpy (output, &width_arg, sizeof (width_arg)); output += sizeof (width_arg);
+  memcpy (output, &height_arg, sizeof (height_arg)); output += sizeof (height_arg);
+  memcpy (output, &max_error, sizeof (max_error)); output += sizeof (max_error);
+  memcpy (output, &nr_strips, sizeof (nr_strips)); output += sizeof (nr_strips);
+  for (const std::vector<uint8_t> &strip : strips)
+  {
+    const uint32_t strip_size = static_cast<uint32_t> (strip.size ());
+    memcpy (output, &strip_size, sizeof (strip_size)); output += sizeof (strip_size);
+  }
+  for (const std::vector<uint8_t> &strip : strips)
+  {
+    if (!strip.empty ())
+      memcpy (output, &strip[0], strip.size ());
+    output += strip.size ();
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::DepthImageCoder::decode (const uint8_t* data_arg,
+                                  size_t size_arg,
+                                  std::vector<uint16_t>& image_arg,
+                                  uint32_t& width_arg,
+                                  uint32_t& height_arg) const
+{
+  if (!isDepthImageStream (data_arg, size_arg) || size_arg < depth_image_header_size)
+  {
+    PCL_ERROR ("[pcl::io::DepthImageCoder::decode] Data is not a compressed depth image!\n");
+    return (false);
+  }
+
+  const uint8_t *input = data_arg + sizeof (depth_image_signature);
+  uint8_t version;
+  uint16_t max_error;
+  uint32_t nr_strips;
+  memcpy (&version, input, sizeof (version)); input += sizeof (version);
+  memcpy (&width_arg, input, sizeof (width_arg)); input += sizeof (width_arg);
+  memcpy (&height_arg, input, sizeof (height_arg)); input += sizeof (height_arg);
+  memcpy (&max_error, input, sizeof (max_error)); input += sizeof (max_error);
+  memcpy (&nr_strips, input, sizeof (nr_strips)); input += sizeof (nr_strips);
+
+  if (version != depth_image_version)
+  {
+    PCL_ERROR ("[pcl::io::DepthImageCoder::decode] Unsupported compressed depth image version %u!\n", version);
+    return (false);
+  }
+  const bool empty = width_arg == 0 || height_arg == 0;
+  if (max_error > max_error_limit_ || nr_strips > height_arg || (nr_strips == 0) != empty ||
+      size_arg - depth_image_header_size < static_cast<uint64_t> (nr_strips) * sizeof (uint32_t))
+  {
+    PCL_ERROR ("[pcl::io::DepthImageCoder::decode] Corrupted compressed depth image header!\n");
+    return (false);
+  }
+
+  // locate the strips
+  std::vector<size_t> strip_offsets (nr_strips + 1);
+  strip_offsets[0] = depth_image_header_size + nr_strips * sizeof (uint32_t);
+  for (uint32_t strip = 0; strip < nr_strips; ++strip)
+  {
+    uint32_t strip_size;
+    memcpy (&strip_size, input, sizeof (strip_size)); input += sizeof (strip_size);
+    strip_offsets[strip + 1] = strip_offsets[strip] + strip_size;
+  }
+  if (strip_offsets[nr_strips] > size_arg)
+  {
+    PCL_ERROR ("[pcl::io::DepthImageCoder::decode] Compressed depth image is truncated!\n");
+    return (false);
+  }
+
+  // every bit covers at most one longest run segment, which bounds the image size before allocating it
+  const uint64_t max_pixels = static_cast<uint64_t> (strip_offsets[nr_strips] - strip_offsets[0]) * 8 << run_order[31];
+  if (static_cast<uint64_t> (width_arg) * height_arg > max_pixels)
+  {
+    PCL_ERROR ("[pcl::io::DepthImageCoder::decode] Compressed depth image is too small for its size of %u x %u pixels!\n", width_arg, height_arg);
+    return (false);
+  }
+
+  image_arg.resize (static_cast<size_t> (width_arg) * height_arg);
+
+  const CodingParameters parameters (max_error);
+  std::vector<char> strip_valid (nr_strips, 0);
+  runStrips (nr_strips, threads_, [&] (unsigned int strip)
+  {
+    strip_valid[strip] = decodeStrip (data_arg + strip_offsets[strip], strip_offsets[strip + 1] - strip_offsets[strip],
+                                      width_arg,
+                                      stripRow (strip, nr_strips, height_arg),
+                                      stripRow (strip + 1, nr_strips, height_arg),
+                                      parameters, &image_arg[0]);
+  });
+
+  if (std::find (strip_valid.begin (), strip_valid.end (), 0) != strip_valid.end ())
+  {
+    PCL_ERROR ("[pcl::io::DepthImageCoder::decode] Corrupted compressed depth image data!\n");
+    return (false);
+  }
+  return (true);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::DepthImageCoder::isDepthImageStream (const uint8_t* data_arg, size_t size_arg)
+{
+  return (data_arg && size_arg >= sizeof (depth_image_signature) &&
+          memcmp (data_arg, depth_image_signature, sizeof (depth_image_signature)) == 0);
+}
@@ -126,29 +126,41 @@ pcl::io::LZFImageWriter::compress (const char* input,
   if (compressed_size)
   {
     // Copy the header first
-    const char header[] = "PCLZF";
-    memcpy (&output[0],  &header[0], 5);
-    memcpy (&output[5],  &width, sizeof (uint32_t));
-    memcpy (&output[9],  &height, sizeof (uint32_t));
-    std::string itype = image_type;
-    // Cut or pad the string
-    if (itype.size () > 16)
-    {
-      PCL_WARN ("[pcl::io::LZFImageWriter::compress] Image type should be a string of maximum 16 characters! Cutting %s to %s.\n", image_type.c_str (), image_type.substr (0, 15).c_str ());
-      itype = itype.substr (0, 15);
-    }
-    if (itype.size () < 16)
-      itype.insert (itype.end (), 16 - itype.size (), ' ');
-
-    memcpy (&output[13], &itype[0], 16);
-    memcpy (&output[29], &compressed_size, sizeof (uint32_t));
-    memcpy (&output[33], &uncompressed_size, sizeof (uint32_t));
+    writeHeader (width, height, image_type, compressed_size, uncompressed_size, output);
     compressed_final_size = uint32_t (compressed_size + header_size);
   }
 
   return (compressed_final_size);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::LZFImageWriter::writeHeader (uint32_t width,
+                                      uint32_t height,
+                                      const std::string &image_type,
+                                      uint32_t compressed_size,
+                                      uint32_t uncompressed_size,
+                                      char *output)
+{
+  const char header[] = "PCLZF";
+  memcpy (&output[0],  &header[0], 5);
+  memcpy (&output[5],  &width, sizeof (uint32_t));
+  memcpy (&output[9],  &height, sizeof (uint32_t));
+  std::string itype = image_type;
+  // Cut or pad the string
+  if (itype.size () > 16)
+  {
+    PCL_WARN ("[pcl::io::LZFImageWriter::compress] Image type should be a string of maximum 16 characters! Cutting %s to %s.\n", image_type.c_str (), image_type.substr (0, 15).c_str ());
+    itype = itype.substr (0, 15);
+  }
+  if (itype.size () < 16)
+    itype.insert (itype.end (), 16 - itype.size (), ' ');
+
+  memcpy (&output[13], &itype[0], 16);
+  memcpy (&output[29], &compressed_size, sizeof (uint32_t));
+  memcpy (&output[33], &uncompressed_size, sizeof (uint32_t));
+}
+
 //////////////////////////////////////////////////////////////////////////////
 bool
 pcl::io::LZFDepth16ImageWriter::write (const char* data,
@@ -157,6 +169,19 @@ pcl::io::LZFDepth16ImageWriter::write (const char* data,
 {
   // Prepare the compressed depth buffer
   unsigned int depth_size = width * height * 2;
+  if (predictive_coding_)
+  {
+    std::vector<uint8_t> coded_depth;
+    depth_coder_.encode (reinterpret_cast<const uint16_t*> (data), width, height, coded_depth);
+
+    std::vector<char> compressed_depth (LZF_HEADER_SIZE + coded_depth.size ());
+    writeHeader (width, height, "depth16p", uint32_t (coded_depth.size ()), depth_size, &compressed_depth[0]);
+    memcpy (&compressed_depth[LZF_HEADER_SIZE], &coded_depth[0], coded_depth.size ());
+
+    // Save the actual image
+    return (saveImageBlob (&compressed_depth[0], compressed_depth.size (), filename));
+  }
+
   char* compressed_depth = static_cast<char*> (malloc (size_t (float (depth_size) * 1.5f + float (LZF_HEADER_SIZE))));
 
   size_t compressed_size = compress (data,
@@ -484,6 +509,33 @@ pcl::io::LZFImageReader::decompress (const std::vector<char> &input,
   return (true);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::LZFDepth16ImageReader::decompressDepth (const std::vector<char> &input,
+                                                 std::vector<char> &output,
+                                                 unsigned int num_threads)
+{
+  if (image_type_identifier_.compare (0, 8, "depth16p") != 0)
+    return (decompress (input, output));
+
+  DepthImageCoder depth_coder;
+  depth_coder.setNumberOfThreads (num_threads);
+
+  std::vector<uint16_t> depth;
+  uint32_t width, height;
+  if (!depth_coder.decode (reinterpret_cast<const uint8_t*> (input.data ()), input.size (), depth, width, height))
+    return (false);
+
+  if (width != width_ || height != height_ || depth.size () * sizeof (uint16_t) != output.size ())
+  {
+    PCL_WARN ("[pcl::io::LZFDepth16ImageReader::decompressDepth] Size of decoded depth image (%u x %u) does not match the image size (%u x %u).\n", width, height, width_, height_);
+    return (false);
+  }
+  if (!output.empty ())
+    memcpy (&output[0], &depth[0], output.size ());
+  return (true);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 bool
 pcl::io::LZFImageReader::readParameters (const std::string &filename)
@@ -39,10 +39,26 @@
 #ifndef PCL_OCTREE_2BUF_BASE_HPP
 #define PCL_OCTREE_2BUF_BASE_HPP
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace pcl
 {
   namespace octree
   {
+    namespace detail
+    {
+      /** \brief Mix the bits of a subtree hash (finalizer of the splitmix64 generator). */
+      inline std::uint64_t
+      mixSubtreeHash (std::uint64_t hash_arg)
+      {
+        hash_arg = (hash_arg ^ (hash_arg >> 30)) * 0xbf58476d1ce4e5b9ull;
+        hash_arg = (hash_arg ^ (hash_arg >> 27)) * 0x94d049bb133111ebull;
+        return (hash_arg ^ (hash_arg >> 31));
+      }
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     template<typename LeafContainerT, typename BranchContainerT>
     Octree2BufBase<LeafContainerT, BranchContainerT>::Octree2BufBase () :
@@ -55,6 +71,7 @@ namespace pcl
       octree_depth_ (0),
       dynamic_depth_enabled_(false)
     {
+      subtree_hash_valid_[0] = subtree_hash_valid_[1] = false;
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
@@ -155,6 +172,7 @@ namespace pcl
         branch_count_ = 1;
         
         tree_dirty_flag_ = false;
+        subtree_hash_valid_[0] = subtree_hash_valid_[1] = false;
         depth_mask_ = 0;
         octree_depth_ = 0;
       }
@@ -175,6 +193,7 @@ namespace pcl
 
       // reset flags
       tree_dirty_flag_ = true;
+      subtree_hash_valid_[buffer_selector_] = false;
       leaf_count_ = 0;
       branch_count_ = 1;
 
@@ -249,6 +268,7 @@ namespace pcl
 
       // we will rebuild an octree -> reset leafCount
       leaf_count_ = 0;
+      subtree_hash_valid_[buffer_selector_] = false;
 
       // iterator for binary tree structure vector
       std::vector<char>::const_iterator binary_tree_in_it = binary_tree_in_arg.begin ();
@@ -278,6 +298,7 @@ namespace pcl
 
       // we will rebuild an octree -> reset leafCount
       leaf_count_ = 0;
+      subtree_hash_valid_[buffer_selector_] = false;
 
       // iterator for binary tree structure vector
       std::vector<char>::const_iterator binary_tree_in_it = binary_tree_in_arg.begin ();
@@ -315,6 +336,191 @@ namespace pcl
       tree_dirty_flag_ = false;
     }
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename LeafContainerT, typename BranchContainerT> void
+    Octree2BufBase<LeafContainerT, BranchContainerT>::serializeChangedLeafs (std::vector<LeafContainerT*>& added_leafs_arg,
+                                                                             std::vector<LeafContainerT*>& removed_leafs_arg,
+                                                                             std::vector<OctreeKey>* added_keys_arg,
+                                                                             std::vector<OctreeKey>* removed_keys_arg)
+    {
+      OctreeKey new_key;
+
+      // clear output vectors
+      added_leafs_arg.clear ();
+      removed_leafs_arg.clear ();
+      if (added_keys_arg)
+        added_keys_arg->clear ();
+      if (removed_keys_arg)
+        removed_keys_arg->clear ();
+
+      if (!subtree_hash_valid_[buffer_selector_])
+        updateSubtreeHashes ();
+
+      // the hashes of the previous buffer are kept from the frame in which it was the current one
+      serializeChangedLeafsRecursive (root_node_, new_key, added_leafs_arg, removed_leafs_arg,
+                                      added_keys_arg, removed_keys_arg, subtree_hash_valid_[!buffer_selector_]);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename LeafContainerT, typename BranchContainerT> void
+    Octree2BufBase<LeafContainerT, BranchContainerT>::updateSubtreeHashes (unsigned int nr_threads)
+    {
+      if (depth_mask_ >= 4)
+      {
+        // subtrees below the second tree level are hashed independently of each other
+        std::vector<BranchNode*> level_branches;
+        for (unsigned char child_idx = 0; child_idx < 8; child_idx++)
+        {
+          OctreeNode* child_node = root_node_->getChildPtr (buffer_selector_, child_idx);
+          if (!child_node || child_node->getNodeType () != BRANCH_NODE)
+            continue;
+
+          BranchNode* child_branch = static_cast<BranchNode*> (child_node);
+          for (unsigned char grand_child_idx = 0; grand_child_idx < 8; grand_child_idx++)
+          {
+            OctreeNode* grand_child_node = child_branch->getChildPtr (buffer_selector_, grand_child_idx);
+            if (grand_child_node && grand_child_node->getNodeType () == BRANCH_NODE)
+              level_branches.push_back (static_cast<BranchNode*> (grand_child_node));
+          }
+        }
+
+        const int nr_branches = static_cast<int> (level_branches.size ());
+#ifdef _OPENMP
+#pragma omp parallel for shared(level_branches) schedule(dynamic, 1) num_threads(nr_threads)
+#endif
+        for (int i = 0; i < nr_branches; i++)
+          hashSubtreeRecursive (level_branches[i], depth_mask_ / 4);
+
+        for (unsigned char child_idx = 0; child_idx < 8; child_idx++)
+        {
+          OctreeNode* child_node = root_node_->getChildPtr (buffer_selector_, child_idx);
+          if (child_node && child_node->getNodeType () == BRANCH_NODE)
+            hashSubtreeRecursive (static_cast<BranchNode*> (child_node), depth_mask_ / 2, false);
+        }
+
+        hashSubtreeRecursive (root_node_, depth_mask_, false);
+      }
+      else
+      {
+        hashSubtreeRecursive (root_node_, depth_mask_);
+      }
+
+      subtree_hash_valid_[buffer_selector_] = true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename LeafContainerT, typename BranchContainerT> void
+    Octree2BufBase<LeafContainerT, BranchContainerT>::hashSubtreeRecursive (BranchNode* branch_arg,
+                                                                            unsigned int depth_mask_arg,
+                                                                            bool recursive_arg)
+    {
+      // leaf children only contribute to the occupancy bit pattern
+      const unsigned char bit_pattern = static_cast<unsigned char> (getBranchBitPattern (*branch_arg, buffer_selector_));
+      std::uint64_t hash = detail::mixSubtreeHash (bit_pattern + 0x9e3779b97f4a7c15ull);
+
+      if (depth_mask_arg > 1)
+      {
+        for (unsigned char child_idx = 0; child_idx < 8; child_idx++)
+        {
+          if (!(bit_pattern & (1 << child_idx)))
+            continue;
+
+          OctreeNode* child_node = branch_arg->getChildPtr (buffer_selector_, child_idx);
+          if (child_node->getNodeType () != BRANCH_NODE)
+            continue;
+
+          BranchNode* child_branch = static_cast<BranchNode*> (child_node);
+          if (recursive_arg)
+            hashSubtreeRecursive (child_branch, depth_mask_arg / 2);
+
+          const std::uint64_t child_hash = child_branch->getSubtreeHash (buffer_selector_);
+          hash = detail::mixSubtreeHash (hash ^ (child_hash + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2)));
+        }
+      }
+
+      branch_arg->setSubtreeHash (buffer_selector_, hash);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename LeafContainerT, typename BranchContainerT> void
+    Octree2BufBase<LeafContainerT, BranchContainerT>::serializeChangedLeafsRecursive (BranchNode* branch_arg,
+                                                                                      OctreeKey& key_arg,
+                                                                                      std::vector<LeafContainerT*>& added_leafs_arg,
+                                                                                      std::vector<LeafContainerT*>& removed_leafs_arg,
+                                                                                      std::vector<OctreeKey>* added_keys_arg,
+                                                                                      std::vector<OctreeKey>* removed_keys_arg,
+                                                                                      bool prune_arg)
+    {
+      // equal hashes -> the occupancy of this subtree did not change
+      if (prune_arg && (branch_arg->getSubtreeHash (buffer_selector_) == branch_arg->getSubtreeHash (!buffer_selector_)))
+        return;
+
+      for (unsigned char child_idx = 0; child_idx < 8; child_idx++)
+      {
+        OctreeNode* child_node = branch_arg->getChildPtr (buffer_selector_, child_idx);
+        OctreeNode* prev_child_node = branch_arg->getChildPtr (!buffer_selector_, child_idx);
+
+        if (!child_node && !prev_child_node)
+          continue;
+
+        // add current branch voxel to key
+        key_arg.pushBranch (child_idx);
+
+        // nodes taken over from the previous buffer are shared by both buffers
+        if (prev_child_node && (prev_child_node != child_node))
+          serializeSubtreeLeafsRecursive (prev_child_node, !buffer_selector_, key_arg, removed_leafs_arg, removed_keys_arg);
+
+        if (child_node)
+        {
+          if (child_node->getNodeType () == BRANCH_NODE)
+          {
+            serializeChangedLeafsRecursive (static_cast<BranchNode*> (child_node), key_arg, added_leafs_arg, removed_leafs_arg,
+                                            added_keys_arg, removed_keys_arg, prune_arg);
+          }
+          else if (child_node != prev_child_node)
+          {
+            added_leafs_arg.push_back (static_cast<LeafNode*> (child_node)->getContainerPtr ());
+            if (added_keys_arg)
+              added_keys_arg->push_back (key_arg);
+          }
+        }
+
+        // pop current branch voxel from key
+        key_arg.popBranch ();
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename LeafContainerT, typename BranchContainerT> void
+    Octree2BufBase<LeafContainerT, BranchContainerT>::serializeSubtreeLeafsRecursive (OctreeNode* node_arg,
+                                                                                      unsigned char buffer_selector_arg,
+                                                                                      OctreeKey& key_arg,
+                                                                                      std::vector<LeafContainerT*>& leaf_container_vector_arg,
+                                                                                      std::vector<OctreeKey>* keys_arg)
+    {
+      if (node_arg->getNodeType () == BRANCH_NODE)
+      {
+        BranchNode* branch = static_cast<BranchNode*> (node_arg);
+
+        for (unsigned char child_idx = 0; child_idx < 8; child_idx++)
+        {
+          if (!branch->hasChild (buffer_selector_arg, child_idx))
+            continue;
+
+          key_arg.pushBranch (child_idx);
+          serializeSubtreeLeafsRecursive (branch->getChildPtr (buffer_selector_arg, child_idx), buffer_selector_arg,
+                                          key_arg, leaf_container_vector_arg, keys_arg);
+          key_arg.popBranch ();
+        }
+      }
+      else
+      {
+        leaf_container_vector_arg.push_back (static_cast<LeafNode*> (node_arg)->getContainerPtr ());
+        if (keys_arg)
+          keys_arg->push_back (key_arg);
+      }
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     template<typename LeafContainerT, typename BranchContainerT>
       unsigned int
@@ -325,6 +531,9 @@ namespace pcl
                                                                              BranchNode*& parent_of_leaf_arg,
                                                                              bool branch_reset_arg)
       {
+      // the structure of the current buffer might change
+      subtree_hash_valid_[buffer_selector_] = false;
+
       // branch reset -> this branch has been taken from previous buffer
       if (branch_reset_arg)
       {
@@ -398,6 +607,8 @@ namespace pcl
           if (child_node->getNodeType () == LEAF_NODE)
           {
             child_leaf = static_cast<LeafNode*> (child_node);
+            // drop the data of the previous frame
+            child_leaf->getContainer () = LeafContainerT ();
             branch_arg->setChildPtr(buffer_selector_, child_idx, child_node);
           } else {
             // depth has changed.. child in preceding buffer is a leaf node.
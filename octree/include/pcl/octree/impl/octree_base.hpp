@@ -52,7 +52,9 @@ namespace pcl
       OctreeBase<LeafContainerT, BranchContainerT>::OctreeBase () :
           leaf_count_ (0),
           branch_count_ (1),
-          root_node_ (new BranchNode ()),
+          branch_arena_ (),
+          leaf_arena_ (),
+          root_node_ (branch_arena_.construct ()),
           depth_mask_ (0),
           octree_depth_ (0),
           dynamic_depth_enabled_ (false)
@@ -65,7 +67,7 @@ namespace pcl
       {
         // deallocate tree structure
         deleteTree ();
-        delete (root_node_);
+        branch_arena_.destroy (root_node_);
       }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
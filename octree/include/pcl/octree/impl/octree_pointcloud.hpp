@@ -40,16 +40,122 @@
 #define PCL_OCTREE_POINTCLOUD_HPP_
 
 #include <cassert>
+#include <type_traits>
 
 #include <pcl/common/common.h>
 #include <pcl/octree/impl/octree_base.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace pcl
+{
+  namespace octree
+  {
+    namespace detail
+    {
+      /** \brief Spread the lower 21 bits of a key component so that two zero bits separate neighbouring bits. */
+      inline uint64_t
+      spreadKeyBits (uint32_t key_arg)
+      {
+        uint64_t bits = key_arg & 0x1fffff;
+        bits = (bits | bits << 32) & 0x001f00000000ffffull;
+        bits = (bits | bits << 16) & 0x001f0000ff0000ffull;
+        bits = (bits | bits << 8) & 0x100f00f00f00f00full;
+        bits = (bits | bits << 4) & 0x10c30c30c30c30c3ull;
+        bits = (bits | bits << 2) & 0x1249249249249249ull;
+        return (bits);
+      }
+
+      /** \brief Interleave the bits of an octree key (up to 21 bits per axis). Every group of three bits equals the
+        * child index of the voxel at the corresponding tree depth, hence sorting by code sorts the voxels depth first.
+        */
+      inline uint64_t
+      getMortonCode (const OctreeKey& key_arg)
+      {
+        return ((spreadKeyBits (key_arg.x) << 2) | (spreadKeyBits (key_arg.y) << 1) | spreadKeyBits (key_arg.z));
+      }
+
+      /** \brief Stable LSD radix sort of Morton codes and their point indices. Each pass uses per thread histograms
+        * over contiguous chunks of the input, so the relative order of equal codes is kept.
+        * \param[in,out] codes the codes to sort
+        * \param[in,out] indices the point indices, permuted along with the codes
+        * \param[in] nr_bits the number of significant bits of the codes
+        * \param[in] nr_threads the number of threads to use
+        */
+      inline void
+      radixSortMortonCodes (std::vector<uint64_t>& codes, std::vector<int>& indices,
+                            unsigned int nr_bits, unsigned int nr_threads)
+      {
+        const std::size_t nr_items = codes.size ();
+        const unsigned int radix_bits = 8;
+        const std::size_t radix = std::size_t (1) << radix_bits;
+
+        std::vector<uint64_t> codes_buffer (nr_items);
+        std::vector<int> indices_buffer (nr_items);
+        std::vector<std::size_t> offsets (radix * nr_threads);
+
+        for (unsigned int shift = 0; shift < nr_bits; shift += radix_bits)
+        {
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+          {
+#ifdef _OPENMP
+            const std::size_t thread_id = omp_get_thread_num ();
+            const std::size_t nr_chunks = omp_get_num_threads ();
+#else
+            const std::size_t thread_id = 0;
+            const std::size_t nr_chunks = 1;
+#endif
+            const std::size_t begin = nr_items * thread_id / nr_chunks;
+            const std::size_t end = nr_items * (thread_id + 1) / nr_chunks;
+            std::size_t* histogram = &offsets[radix * thread_id];
+
+            std::fill_n (histogram, radix, 0);
+            for (std::size_t i = begin; i < end; ++i)
+              ++histogram[(codes[i] >> shift) & (radix - 1)];
+
+#ifdef _OPENMP
+#pragma omp barrier
+#pragma omp single
+#endif
+            {
+              // exclusive prefix sum over digits first, chunks second
+              std::size_t sum = 0;
+              for (std::size_t digit = 0; digit < radix; ++digit)
+                for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk)
+                {
+                  const std::size_t count = offsets[radix * chunk + digit];
+                  offsets[radix * chunk + digit] = sum;
+                  sum += count;
+                }
+            }
+
+            for (std::size_t i = begin; i < end; ++i)
+            {
+              const std::size_t target = histogram[(codes[i] >> shift) & (radix - 1)]++;
+              codes_buffer[target] = codes[i];
+              indices_buffer[target] = indices[i];
+            }
+          }
+
+          codes.swap (codes_buffer);
+          indices.swap (indices_buffer);
+        }
+      }
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT, typename OctreeT>
 pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::OctreePointCloud (const double resolution) :
     OctreeT (), input_ (PointCloudConstPtr ()), indices_ (IndicesConstPtr ()),
     epsilon_ (0), resolution_ (resolution), min_x_ (0.0f), max_x_ (resolution), min_y_ (0.0f),
-    max_y_ (resolution), min_z_ (0.0f), max_z_ (resolution), bounding_box_defined_ (false), max_objs_per_leaf_(0)
+    max_y_ (resolution), min_z_ (0.0f), max_z_ (resolution), bounding_box_defined_ (false), max_objs_per_leaf_(0),
+    threads_ (1)
 {
   assert (resolution > 0.0f);
 }
@@ -64,7 +170,35 @@ pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>
 template<typename PointT, typename LeafContainerT, typename BranchContainerT, typename OctreeT> void
 pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::addPointsFromInputCloud ()
 {
-  if (indices_)
+  // bulk insertion builds the tree of an empty single buffer octree with fixed depth from scratch
+  const bool bulk_insertion = std::is_same<OctreeT, OctreeBase<LeafContainerT, BranchContainerT> >::value &&
+                              !this->dynamic_depth_enabled_ && (this->leaf_count_ == 0) && (this->branch_count_ == 1);
+
+  if (bulk_insertion)
+  {
+    std::vector<int> point_indices;
+    point_indices.reserve (indices_ ? indices_->size () : input_->points.size ());
+
+    const int nr_points = static_cast<int> (indices_ ? indices_->size () : input_->points.size ());
+    for (int i = 0; i < nr_points; i++)
+    {
+      const int index = indices_ ? (*indices_)[i] : i;
+      assert( (index >= 0) && (index < static_cast<int> (input_->points.size ())));
+
+      const PointT& point = input_->points[index];
+      if (!isFinite (point))
+        continue;
+
+      // the tree is built afterwards, so only the bounding box needs to grow
+      if (!bounding_box_defined_ || !isPointWithinBoundingBox (point))
+        adoptBoundingBoxToPoint (point, false);
+
+      point_indices.push_back (index);
+    }
+
+    addPointIndicesBulk (point_indices);
+  }
+  else if (indices_)
   {
     for (const int &index : *indices_)
     {
@@ -90,6 +224,105 @@ pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafContainerT, typename BranchContainerT, typename OctreeT> void
+pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafContainerT, typename BranchContainerT, typename OctreeT> void
+pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::addPointIndicesBulk (const std::vector<int>& point_indices_arg)
+{
+  if (point_indices_arg.empty ())
+    return;
+
+  const unsigned int depth = this->octree_depth_;
+
+  // Morton codes hold up to 21 levels, deeper trees are built point by point
+  if (depth > 21)
+  {
+    for (const int &index : point_indices_arg)
+      this->addPointIdx (index);
+    return;
+  }
+
+  const int nr_points = static_cast<int> (point_indices_arg.size ());
+
+  std::vector<uint64_t> codes (nr_points);
+  std::vector<int> indices (point_indices_arg);
+
+#ifdef _OPENMP
+#pragma omp parallel for shared(codes) num_threads(threads_)
+#endif
+  for (int i = 0; i < nr_points; i++)
+  {
+    OctreeKey key;
+    this->genOctreeKeyForDataT (indices[i], key);
+    codes[i] = detail::getMortonCode (key);
+  }
+
+  // stable sort keeps the insertion order of points sharing a voxel
+  detail::radixSortMortonCodes (codes, indices, 3 * depth, threads_);
+
+  // create the nodes depth first, reusing the branches shared with the previous voxel
+  std::vector<BranchNode*> branch_path (depth);
+  std::vector<LeafNode*> leaves;
+  std::vector<int> leaf_offsets;
+  branch_path[0] = this->root_node_;
+
+  for (int i = 0; i < nr_points; i++)
+  {
+    const uint64_t code = codes[i];
+    unsigned int level = 0;
+
+    if (i > 0)
+    {
+      const uint64_t diff = code ^ codes[i - 1];
+      if (!diff)
+        continue;
+
+      // highest tree level at which the child indices differ
+      unsigned int highest_bit = 63;
+      while (!(diff >> highest_bit))
+        highest_bit--;
+      level = depth - 1 - highest_bit / 3;
+    }
+
+    for (; level + 1 < depth; level++)
+    {
+      const unsigned char child_idx = static_cast<unsigned char> ((code >> (3 * (depth - 1 - level))) & 7);
+      branch_path[level + 1] = this->createBranchChild (*branch_path[level], child_idx);
+      this->branch_count_++;
+    }
+
+    leaves.push_back (this->createLeafChild (*branch_path[depth - 1], static_cast<unsigned char> (code & 7)));
+    leaf_offsets.push_back (i);
+    this->leaf_count_++;
+  }
+  leaf_offsets.push_back (nr_points);
+
+  // fill the leaf containers, every leaf is handled by a single thread
+  const int nr_leaves = static_cast<int> (leaves.size ());
+#ifdef _OPENMP
+#pragma omp parallel for shared(leaves, leaf_offsets, indices) schedule(dynamic, 256) num_threads(threads_)
+#endif
+  for (int leaf_idx = 0; leaf_idx < nr_leaves; leaf_idx++)
+  {
+    LeafContainerT& container = leaves[leaf_idx]->getContainer ();
+    for (int i = leaf_offsets[leaf_idx]; i < leaf_offsets[leaf_idx + 1]; i++)
+      this->addPointToLeafContainer (indices[i], container);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT, typename OctreeT> void
 pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::addPointFromCloud (const int point_idx_arg, IndicesPtr indices_arg)
@@ -424,7 +657,7 @@ pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT, typename OctreeT>
 void
-pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::adoptBoundingBoxToPoint (const PointT& point_idx_arg)
+pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::adoptBoundingBoxToPoint (const PointT& point_idx_arg, bool expand_root_arg)
 {
 
   const float minValue = std::numeric_limits<float>::epsilon ();
@@ -455,14 +688,17 @@ pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>
         child_idx = static_cast<unsigned char> (((!bUpperBoundViolationX) << 2) | ((!bUpperBoundViolationY) << 1)
             | ((!bUpperBoundViolationZ)));
 
-        BranchNode* newRootBranch;
+        if (expand_root_arg)
+        {
+          BranchNode* newRootBranch;
 
-        newRootBranch = new BranchNode();
-        this->branch_count_++;
+          newRootBranch = this->createBranch ();
+          this->branch_count_++;
 
-        this->setBranchChildPtr (*newRootBranch, child_idx, this->root_node_);
+          this->setBranchChildPtr (*newRootBranch, child_idx, this->root_node_);
 
-        this->root_node_ = newRootBranch;
+          this->root_node_ = newRootBranch;
+        }
 
         octreeSideLen = static_cast<double> (1 << this->octree_depth_) * resolution_;
 
@@ -717,7 +953,7 @@ pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>
 template<typename PointT, typename LeafContainerT, typename BranchContainerT, typename OctreeT> bool
 pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::genOctreeKeyForDataT (const int& data_arg, OctreeKey & key_arg) const
 {
-  const PointT temp_point = getPointByIndex (data_arg);
+  const PointT& temp_point = getPointByIndex (data_arg);
 
   // generate key for point
   genOctreeKeyforPoint (temp_point, key_arg);
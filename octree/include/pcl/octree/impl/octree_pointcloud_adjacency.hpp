@@ -88,7 +88,24 @@ pcl::octree::OctreePointCloudAdjacency<PointT, LeafContainerT, BranchContainerT>
   }
   this->defineBoundingBox (minX, minY, minZ, maxX, maxY, maxZ);
 
-  OctreePointCloud<PointT, LeafContainerT, BranchContainerT>::addPointsFromInputCloud ();
+  // the bounding box already holds all (transformed) points, so the tree is built in a single pass
+  std::vector<int> point_indices;
+  if (this->indices_)
+  {
+    point_indices.reserve (this->indices_->size ());
+    for (const int &index : *this->indices_)
+      if (pcl::isFinite (input_->points[index]))
+        point_indices.push_back (index);
+  }
+  else
+  {
+    point_indices.reserve (input_->size ());
+    for (size_t i = 0; i < input_->size (); ++i)
+      if (pcl::isFinite (input_->points[i]))
+        point_indices.push_back (static_cast<int> (i));
+  }
+
+  this->addPointIndicesBulk (point_indices);
   
   leaf_vector_.reserve (this->getLeafCount ());
   for (auto leaf_itr = this->leaf_depth_begin () ; leaf_itr != this->leaf_depth_end (); ++leaf_itr)
@@ -41,6 +41,100 @@
 
 #include <cassert>
 
+#include <pcl/common/simd_ops.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace pcl
+{
+  namespace octree
+  {
+    namespace detail
+    {
+      /** \brief Number of leaf points whose distances are computed in one block. */
+      const std::size_t leaf_scan_block_size = 64;
+
+      /** \brief Get the point indices of a leaf, copying them into \a buffer_arg unless the container exposes them. */
+      template <typename ContainerT> inline const std::vector<int>&
+      getLeafPointIndices (const ContainerT& container_arg, std::vector<int>& buffer_arg)
+      {
+        buffer_arg.clear ();
+        container_arg.getPointIndices (buffer_arg);
+        return (buffer_arg);
+      }
+
+      inline const std::vector<int>&
+      getLeafPointIndices (const OctreeContainerPointIndices& container_arg, std::vector<int>&)
+      {
+        return (container_arg.getPointIndicesVector ());
+      }
+
+#if defined (__SSE2__)
+      /** \brief Squared distances of the indexed points to the query, Ops::width points per step.
+        * \return the number of points processed, the remainder is left to the caller
+        */
+      template <typename Ops, typename PointT> inline std::size_t
+      computeSquaredDistances (const PointT& query_arg, const PointT* points_arg, const int* indices_arg,
+                               std::size_t nr_indices_arg, float* sqr_distances_arg)
+      {
+        using Vec = typename Ops::Vec;
+        const Vec qx = Ops::set1 (query_arg.x);
+        const Vec qy = Ops::set1 (query_arg.y);
+        const Vec qz = Ops::set1 (query_arg.z);
+
+        float x[Ops::width], y[Ops::width], z[Ops::width];
+        std::size_t i = 0;
+        for (; i + Ops::width <= nr_indices_arg; i += Ops::width)
+        {
+          for (std::size_t j = 0; j < Ops::width; ++j)
+          {
+            const PointT& point = points_arg[indices_arg[i + j]];
+            x[j] = point.x;
+            y[j] = point.y;
+            z[j] = point.z;
+          }
+          const Vec dx = Ops::sub (Ops::load (x), qx);
+          const Vec dy = Ops::sub (Ops::load (y), qy);
+          const Vec dz = Ops::sub (Ops::load (z), qz);
+          Ops::store (sqr_distances_arg + i, Ops::add (Ops::mul (dx, dx), Ops::add (Ops::mul (dy, dy), Ops::mul (dz, dz))));
+        }
+        return (i);
+      }
+#endif
+
+      /** \brief Squared distances of the indexed points of a cloud to a query point. The terms are summed in the
+        * same order as Eigen's squaredNorm, so the distances equal those of pointSquaredDist.
+        * \param[in] query_arg the query point
+        * \param[in] points_arg the points of the input cloud
+        * \param[in] indices_arg indices of the points to compute the distances for
+        * \param[in] nr_indices_arg number of indices
+        * \param[out] sqr_distances_arg the squared distances, one per index
+        */
+      template <typename PointT> inline void
+      computeSquaredDistances (const PointT& query_arg, const PointT* points_arg, const int* indices_arg,
+                               std::size_t nr_indices_arg, float* sqr_distances_arg)
+      {
+        std::size_t i = 0;
+#if defined (__AVX__)
+        i = computeSquaredDistances<pcl::detail::AVXOps> (query_arg, points_arg, indices_arg, nr_indices_arg, sqr_distances_arg);
+#elif defined (__SSE2__)
+        i = computeSquaredDistances<pcl::detail::SSEOps> (query_arg, points_arg, indices_arg, nr_indices_arg, sqr_distances_arg);
+#endif
+        for (; i < nr_indices_arg; ++i)
+        {
+          const PointT& point = points_arg[indices_arg[i]];
+          const float dx = point.x - query_arg.x;
+          const float dy = point.y - query_arg.y;
+          const float dz = point.z - query_arg.z;
+          sqr_distances_arg[i] = dx * dx + (dy * dy + dz * dz);
+        }
+      }
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> bool
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::voxelSearch (const PointT& point,
@@ -77,7 +171,7 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::v
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> int
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::nearestKSearch (const PointT &p_q, int k,
                                                                              std::vector<int> &k_indices,
-                                                                             std::vector<float> &k_sqr_distances)
+                                                                             std::vector<float> &k_sqr_distances) const
 {
   assert(this->leaf_count_>0);
   assert (isFinite (p_q) && "Invalid (NaN, Inf) point coordinates given to nearestKSearch!");
@@ -88,16 +182,13 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::n
   if (k < 1)
     return 0;
   
-  prioPointQueueEntry point_entry;
   std::vector<prioPointQueueEntry> point_candidates;
+  point_candidates.reserve (k);
 
-  OctreeKey key;
-  key.x = key.y = key.z = 0;
-
-  // initialize smallest point distance in search with high value
-  double smallest_dist = std::numeric_limits<double>::max ();
+  getKNearestNeighbors (p_q, k, point_candidates);
 
-  getKNearestNeighborRecursive (p_q, k, this->root_node_, key, 1, smallest_dist, point_candidates);
+  // the candidates form a max-heap on the distance
+  std::sort_heap (point_candidates.begin (), point_candidates.end ());
 
   unsigned int result_count = static_cast<unsigned int> (point_candidates.size ());
 
@@ -117,12 +208,34 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::n
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> int
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::nearestKSearch (int index, int k,
                                                                              std::vector<int> &k_indices,
-                                                                             std::vector<float> &k_sqr_distances)
+                                                                             std::vector<float> &k_sqr_distances) const
 {
   const PointT search_point = this->getPointByIndex (index);
   return (nearestKSearch (search_point, k, k_indices, k_sqr_distances));
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafContainerT, typename BranchContainerT> void
+pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::nearestKSearch (const PointCloud& cloud,
+                                                                             const std::vector<int>& indices, int k,
+                                                                             std::vector<std::vector<int> >& k_indices,
+                                                                             std::vector<std::vector<float> >& k_sqr_distances) const
+{
+  const int nr_queries = static_cast<int> (indices.empty () ? cloud.size () : indices.size ());
+
+  k_indices.resize (nr_queries);
+  k_sqr_distances.resize (nr_queries);
+
+#ifdef _OPENMP
+#pragma omp parallel for shared(cloud, indices, k_indices, k_sqr_distances) schedule(dynamic, 64) num_threads(this->threads_)
+#endif
+  for (int i = 0; i < nr_queries; i++)
+  {
+    const PointT& query = cloud.points[indices.empty () ? i : indices[i]];
+    nearestKSearch (query, k, k_indices[i], k_sqr_distances[i]);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> void
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::approxNearestSearch (const PointT &p_q,
@@ -164,8 +277,9 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::r
   k_indices.clear ();
   k_sqr_distances.clear ();
 
+  std::vector<int> leaf_indices;
   getNeighborsWithinRadiusRecursive (p_q, radius * radius, this->root_node_, key, 1, k_indices, k_sqr_distances,
-                                     max_nn);
+                                     max_nn, leaf_indices);
 
   return (static_cast<int> (k_indices.size ()));
 }
@@ -182,6 +296,29 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::r
   return (radiusSearch (search_point, radius, k_indices, k_sqr_distances, max_nn));
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafContainerT, typename BranchContainerT> void
+pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::radiusSearch (const PointCloud& cloud,
+                                                                           const std::vector<int>& indices, double radius,
+                                                                           std::vector<std::vector<int> >& k_indices,
+                                                                           std::vector<std::vector<float> >& k_sqr_distances,
+                                                                           unsigned int max_nn) const
+{
+  const int nr_queries = static_cast<int> (indices.empty () ? cloud.size () : indices.size ());
+
+  k_indices.resize (nr_queries);
+  k_sqr_distances.resize (nr_queries);
+
+#ifdef _OPENMP
+#pragma omp parallel for shared(cloud, indices, k_indices, k_sqr_distances) schedule(dynamic, 64) num_threads(this->threads_)
+#endif
+  for (int i = 0; i < nr_queries; i++)
+  {
+    const PointT& query = cloud.points[indices.empty () ? i : indices[i]];
+    radiusSearch (query, radius, k_indices[i], k_sqr_distances[i], max_nn);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> int
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::boxSearch (const Eigen::Vector3f &min_pt,
@@ -201,107 +338,89 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::b
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template<typename PointT, typename LeafContainerT, typename BranchContainerT> double
-pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::getKNearestNeighborRecursive (
-    const PointT & point, unsigned int K, const BranchNode* node, const OctreeKey& key, unsigned int tree_depth,
-    const double squared_search_radius, std::vector<prioPointQueueEntry>& point_candidates) const
+template<typename PointT, typename LeafContainerT, typename BranchContainerT> void
+pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::getKNearestNeighbors (
+    const PointT & point, unsigned int K, std::vector<prioPointQueueEntry>& point_candidates) const
 {
+  // nodes ordered by their distance to the query point, closest first
   std::vector<prioBranchQueueEntry> search_heap;
-  search_heap.resize (8);
+  search_heap.reserve (64);
+  search_heap.push_back (prioBranchQueueEntry (this->root_node_, OctreeKey (), 0.0f, 0));
 
-  OctreeKey new_key;
+  std::vector<int> leaf_indices;
+  float sqr_distances[detail::leaf_scan_block_size];
 
-  double smallest_squared_dist = squared_search_radius;
+  // squared distance of the K-th best candidate found so far
+  float smallest_squared_dist = std::numeric_limits<float>::max ();
 
-  // get spatial voxel information
-  double voxelSquaredDiameter = this->getVoxelSquaredDiameter (tree_depth);
-
-  // iterate over all children
-  for (unsigned char child_idx = 0; child_idx < 8; child_idx++)
+  while (!search_heap.empty ())
   {
-    if (this->branchHasChild (*node, child_idx))
-    {
-      PointT voxel_center;
-
-      search_heap[child_idx].key.x = (key.x << 1) + (!!(child_idx & (1 << 2)));
-      search_heap[child_idx].key.y = (key.y << 1) + (!!(child_idx & (1 << 1)));
-      search_heap[child_idx].key.z = (key.z << 1) + (!!(child_idx & (1 << 0)));
+    std::pop_heap (search_heap.begin (), search_heap.end ());
+    const prioBranchQueueEntry entry = search_heap.back ();
+    search_heap.pop_back ();
 
-      // generate voxel center point for voxel at key
-      this->genVoxelCenterFromOctreeKey (search_heap[child_idx].key, tree_depth, voxel_center);
+    // all remaining nodes are farther away than the current K-th candidate
+    if (point_candidates.size () == K && entry.point_distance >= smallest_squared_dist - this->epsilon_)
+      break;
 
-      // generate new priority queue element
-      search_heap[child_idx].node = this->getBranchChildPtr (*node, child_idx);
-      search_heap[child_idx].point_distance = pointSquaredDist (voxel_center, point);
-    }
-    else
+    if (entry.tree_depth < this->octree_depth_)
     {
-      search_heap[child_idx].point_distance = std::numeric_limits<float>::infinity ();
-    }
-  }
+      const BranchNode* branch = static_cast<const BranchNode*> (entry.node);
+      const unsigned int child_depth = entry.tree_depth + 1;
 
-  std::sort (search_heap.begin (), search_heap.end ());
+      for (unsigned char child_idx = 0; child_idx < 8; child_idx++)
+      {
+        if (!this->branchHasChild (*branch, child_idx))
+          continue;
 
-  // iterate over all children in priority queue
-  // check if the distance to search candidate is smaller than the best point distance (smallest_squared_dist)
-  while ((!search_heap.empty ()) && (search_heap.back ().point_distance <
-         smallest_squared_dist + voxelSquaredDiameter / 4.0 + sqrt (smallest_squared_dist * voxelSquaredDiameter) - this->epsilon_))
-  {
-    const OctreeNode* child_node;
+        OctreeKey child_key;
+        child_key.x = (entry.key.x << 1) + (!!(child_idx & (1 << 2)));
+        child_key.y = (entry.key.y << 1) + (!!(child_idx & (1 << 1)));
+        child_key.z = (entry.key.z << 1) + (!!(child_idx & (1 << 0)));
 
-    // read from priority queue element
-    child_node = search_heap.back ().node;
-    new_key = search_heap.back ().key;
+        const float voxel_squared_dist = pointSquaredDistToVoxel (point, child_key, child_depth);
+        if (point_candidates.size () == K && voxel_squared_dist >= smallest_squared_dist - this->epsilon_)
+          continue;
 
-    if (tree_depth < this->octree_depth_)
-    {
-      // we have not reached maximum tree depth
-      smallest_squared_dist = getKNearestNeighborRecursive (point, K, static_cast<const BranchNode*> (child_node), new_key, tree_depth + 1,
-                                                            smallest_squared_dist, point_candidates);
+        search_heap.push_back (prioBranchQueueEntry (this->getBranchChildPtr (*branch, child_idx), child_key,
+                                                     voxel_squared_dist, child_depth));
+        std::push_heap (search_heap.begin (), search_heap.end ());
+      }
     }
     else
     {
       // we reached leaf node level
-      std::vector<int> decoded_point_vector;
-
-      const LeafNode* child_leaf = static_cast<const LeafNode*> (child_node);
-
-      // decode leaf node into decoded_point_vector
-      (*child_leaf)->getPointIndices (decoded_point_vector);
+      const LeafNode* leaf = static_cast<const LeafNode*> (entry.node);
+      const std::vector<int>& point_indices = detail::getLeafPointIndices (leaf->getContainer (), leaf_indices);
 
-      // Linearly iterate over all decoded (unsorted) points
-      for (const int &point_index : decoded_point_vector)
+      for (std::size_t block = 0; block < point_indices.size (); block += detail::leaf_scan_block_size)
       {
+        const std::size_t block_size = std::min (detail::leaf_scan_block_size, point_indices.size () - block);
+        detail::computeSquaredDistances (point, &this->input_->points[0], &point_indices[block], block_size, sqr_distances);
 
-        const PointT& candidate_point = this->getPointByIndex (point_index);
-
-        // calculate point distance to search point
-        float squared_dist = pointSquaredDist (candidate_point, point);
-
-        // check if a closer match is found
-        if (squared_dist < smallest_squared_dist)
+        for (std::size_t i = 0; i < block_size; i++)
         {
-          prioPointQueueEntry point_entry;
+          // keep the K best candidates in a max-heap
+          if (point_candidates.size () < K)
+          {
+            point_candidates.push_back (prioPointQueueEntry (point_indices[block + i], sqr_distances[i]));
+            std::push_heap (point_candidates.begin (), point_candidates.end ());
+          }
+          else if (sqr_distances[i] < smallest_squared_dist)
+          {
+            std::pop_heap (point_candidates.begin (), point_candidates.end ());
+            point_candidates.back () = prioPointQueueEntry (point_indices[block + i], sqr_distances[i]);
+            std::push_heap (point_candidates.begin (), point_candidates.end ());
+          }
+          else
+            continue;
 
-          point_entry.point_distance_ = squared_dist;
-          point_entry.point_idx_ = point_index;
-          point_candidates.push_back (point_entry);
+          if (point_candidates.size () == K)
+            smallest_squared_dist = point_candidates.front ().point_distance_;
         }
       }
-
-      std::sort (point_candidates.begin (), point_candidates.end ());
-
-      if (point_candidates.size () > K)
-        point_candidates.resize (K);
-
-      if (point_candidates.size () == K)
-        smallest_squared_dist = point_candidates.back ().point_distance_;
     }
-    // pop element from priority queue
-    search_heap.pop_back ();
   }
-
-  return (smallest_squared_dist);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -309,10 +428,9 @@ template<typename PointT, typename LeafContainerT, typename BranchContainerT> vo
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::getNeighborsWithinRadiusRecursive (
     const PointT & point, const double radiusSquared, const BranchNode* node, const OctreeKey& key,
     unsigned int tree_depth, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances,
-    unsigned int max_nn) const
+    unsigned int max_nn, std::vector<int>& leaf_indices) const
 {
-  // get spatial voxel information
-  double voxel_squared_diameter = this->getVoxelSquaredDiameter (tree_depth);
+  float sqr_distances[detail::leaf_scan_block_size];
 
   // iterate over all children
   for (unsigned char child_idx = 0; child_idx < 8; child_idx++)
@@ -324,57 +442,44 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::g
     child_node = this->getBranchChildPtr (*node, child_idx);
 
     OctreeKey new_key;
-    PointT voxel_center;
-    float squared_dist;
 
     // generate new key for current branch voxel
     new_key.x = (key.x << 1) + (!!(child_idx & (1 << 2)));
     new_key.y = (key.y << 1) + (!!(child_idx & (1 << 1)));
     new_key.z = (key.z << 1) + (!!(child_idx & (1 << 0)));
 
-    // generate voxel center point for voxel at key
-    this->genVoxelCenterFromOctreeKey (new_key, tree_depth, voxel_center);
-
-    // calculate distance to search point
-    squared_dist = pointSquaredDist (static_cast<const PointT&> (voxel_center), point);
+    // skip voxels that do not intersect the search sphere
+    if (pointSquaredDistToVoxel (point, new_key, tree_depth) > radiusSquared + this->epsilon_)
+      continue;
 
-    // if distance is smaller than search radius
-    if (squared_dist + this->epsilon_
-        <= voxel_squared_diameter / 4.0 + radiusSquared + sqrt (voxel_squared_diameter * radiusSquared))
+    if (tree_depth < this->octree_depth_)
     {
+      // we have not reached maximum tree depth
+      getNeighborsWithinRadiusRecursive (point, radiusSquared, static_cast<const BranchNode*> (child_node), new_key, tree_depth + 1,
+                                         k_indices, k_sqr_distances, max_nn, leaf_indices);
+      if (max_nn != 0 && k_indices.size () == static_cast<unsigned int> (max_nn))
+        return;
+    }
+    else
+    {
+      // we reached leaf node level
+      const LeafNode* child_leaf = static_cast<const LeafNode*> (child_node);
+      const std::vector<int>& point_indices = detail::getLeafPointIndices (child_leaf->getContainer (), leaf_indices);
 
-      if (tree_depth < this->octree_depth_)
+      for (std::size_t block = 0; block < point_indices.size (); block += detail::leaf_scan_block_size)
       {
-        // we have not reached maximum tree depth
-        getNeighborsWithinRadiusRecursive (point, radiusSquared, static_cast<const BranchNode*> (child_node), new_key, tree_depth + 1,
-                                           k_indices, k_sqr_distances, max_nn);
-        if (max_nn != 0 && k_indices.size () == static_cast<unsigned int> (max_nn))
-          return;
-      }
-      else
-      {
-        // we reached leaf node level
-        const LeafNode* child_leaf = static_cast<const LeafNode*> (child_node);
-        std::vector<int> decoded_point_vector;
-
-        // decode leaf node into decoded_point_vector
-        (*child_leaf)->getPointIndices (decoded_point_vector);
+        const std::size_t block_size = std::min (detail::leaf_scan_block_size, point_indices.size () - block);
+        detail::computeSquaredDistances (point, &this->input_->points[0], &point_indices[block], block_size, sqr_distances);
 
-        // Linearly iterate over all decoded (unsorted) points
-        for (const int &index : decoded_point_vector)
+        for (std::size_t i = 0; i < block_size; i++)
         {
-          const PointT& candidate_point = this->getPointByIndex (index);
-
-          // calculate point distance to search point
-          squared_dist = pointSquaredDist (candidate_point, point);
-
           // check if a match is found
-          if (squared_dist > radiusSquared)
+          if (sqr_distances[i] > radiusSquared)
             continue;
 
           // add point to result vector
-          k_indices.push_back (index);
-          k_sqr_distances.push_back (squared_dist);
+          k_indices.push_back (point_indices[block + i]);
+          k_sqr_distances.push_back (sqr_distances[i]);
 
           if (max_nn != 0 && k_indices.size () == static_cast<unsigned int> (max_nn))
             return;
@@ -480,6 +585,26 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::p
   return (point_a.getVector3fMap () - point_b.getVector3fMap ()).squaredNorm ();
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafContainerT, typename BranchContainerT> float
+pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::pointSquaredDistToVoxel (const PointT & point,
+                                                                                      const OctreeKey & key,
+                                                                                      unsigned int tree_depth) const
+{
+  // calculate voxel size of current tree depth
+  const double voxel_side_len = this->resolution_ * static_cast<double> (1 << (this->octree_depth_ - tree_depth));
+
+  // distance of the point to the voxel box along each axis, zero inside
+  const double min_x = static_cast<double> (key.x) * voxel_side_len + this->min_x_;
+  const double min_y = static_cast<double> (key.y) * voxel_side_len + this->min_y_;
+  const double min_z = static_cast<double> (key.z) * voxel_side_len + this->min_z_;
+  const double dx = std::max (std::max (min_x - point.x, point.x - (min_x + voxel_side_len)), 0.0);
+  const double dy = std::max (std::max (min_y - point.y, point.y - (min_y + voxel_side_len)), 0.0);
+  const double dz = std::max (std::max (min_z - point.z, point.z - (min_z + voxel_side_len)), 0.0);
+
+  return (static_cast<float> (dx * dx + dy * dy + dz * dz));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> void
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::boxSearchRecursive (const Eigen::Vector3f &min_pt,
@@ -38,6 +38,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include <pcl/octree/octree_nodes.h>
@@ -73,6 +74,7 @@ namespace pcl
         operator = (const BufferedBranchNode &source_arg)
         {
           memset (child_node_array_, 0, sizeof(child_node_array_));
+          memcpy (subtree_hash_, source_arg.subtree_hash_, sizeof(subtree_hash_));
 
           for (unsigned char b = 0; b < 2; ++b)
             for (unsigned char i = 0; i < 8; ++i)
@@ -130,6 +132,28 @@ namespace pcl
           return (child_node_array_[buffer_arg][index_arg] != nullptr);
         }
 
+        /** \brief Get the hash of the occupancy structure below this branch node
+         *  \param buffer_arg: buffer selector
+         *  \return subtree hash, zero if the subtree has not been hashed
+         * */
+        inline std::uint64_t
+        getSubtreeHash (unsigned char buffer_arg) const
+        {
+          assert (buffer_arg<2);
+          return subtree_hash_[buffer_arg];
+        }
+
+        /** \brief Set the hash of the occupancy structure below this branch node
+         *  \param buffer_arg: buffer selector
+         *  \param hash_arg: subtree hash
+         * */
+        inline void
+        setSubtreeHash (unsigned char buffer_arg, std::uint64_t hash_arg)
+        {
+          assert (buffer_arg<2);
+          subtree_hash_[buffer_arg] = hash_arg;
+        }
+
         /** \brief Get the type of octree node. Returns LEAVE_NODE type */
         node_type_t getNodeType () const override
         {
@@ -140,6 +164,7 @@ namespace pcl
         inline void reset ()
         {
           memset (&child_node_array_[0][0], 0, sizeof(OctreeNode*) * 8 * 2);
+          subtree_hash_[0] = subtree_hash_[1] = 0;
         }
 
         /** \brief Get const pointer to container */
@@ -202,6 +227,8 @@ namespace pcl
         ContainerT container_;
 
         OctreeNode* child_node_array_[2][8];
+
+        std::uint64_t subtree_hash_[2];
     };
 
     /** \brief @b Octree double buffer class
@@ -321,6 +348,8 @@ namespace pcl
             octree_depth_ (source.octree_depth_),
             dynamic_depth_enabled_(source.dynamic_depth_enabled_)
         {
+          subtree_hash_valid_[0] = source.subtree_hash_valid_[0];
+          subtree_hash_valid_[1] = source.subtree_hash_valid_[1];
         }
 
         /** \brief Copy constructor. */
@@ -336,6 +365,8 @@ namespace pcl
           tree_dirty_flag_ = source.tree_dirty_flag_;
           octree_depth_ = source.octree_depth_;
           dynamic_depth_enabled_ = source.dynamic_depth_enabled_;
+          subtree_hash_valid_[0] = source.subtree_hash_valid_[0];
+          subtree_hash_valid_[1] = source.subtree_hash_valid_[1];
           return (*this);
         }
 
@@ -429,6 +460,7 @@ namespace pcl
           buffer_selector_ = !buffer_selector_;
           treeCleanUpRecursive (root_node_);
           leaf_count_ = 0;
+          subtree_hash_valid_[0] = subtree_hash_valid_[1] = false;
         }
 
         /** \brief Switch buffers and reset current octree structure. */
@@ -465,6 +497,21 @@ namespace pcl
         void
         serializeNewLeafs (std::vector<LeafContainerT*>& leaf_container_vector_arg);
 
+        /** \brief Outputs the leaf nodes that were added to or removed from the current buffer with respect to the previous buffer.
+         *  Branches whose subtree hashes agree in both buffers are skipped without being traversed.
+         *  \note Unlike serializeNewLeafs, unused nodes of the previous buffer are not deleted, so the removed containers
+         *  stay valid until the buffers are switched or the previous buffer is deleted.
+         *  \param added_leafs_arg: vector of pointers to all LeafContainerT objects that do not exist in the previous buffer
+         *  \param removed_leafs_arg: vector of pointers to all LeafContainerT objects that only exist in the previous buffer
+         *  \param added_keys_arg: optional output vector for the keys of the added leaf nodes
+         *  \param removed_keys_arg: optional output vector for the keys of the removed leaf nodes
+         * */
+        void
+        serializeChangedLeafs (std::vector<LeafContainerT*>& added_leafs_arg,
+                               std::vector<LeafContainerT*>& removed_leafs_arg,
+                               std::vector<OctreeKey>* added_keys_arg = nullptr,
+                               std::vector<OctreeKey>* removed_keys_arg = nullptr);
+
         /** \brief Deserialize a binary octree description vector and create a corresponding octree structure. Leaf nodes are initialized with getDataTByKey(..).
          *  \param binary_tree_in_arg: reference to input vector for reading binary tree structure.
          *  \param do_XOR_decoding_arg: select if binary tree structure is based on current octree (false) of based on a XOR comparison between current and previous octree
@@ -546,6 +593,7 @@ namespace pcl
 
             // we changed the octree structure -> dirty
             tree_dirty_flag_ = true;
+            subtree_hash_valid_[buffer_selector_] = false;
           }
         }
 
@@ -736,7 +784,17 @@ namespace pcl
           }
         }
 
+        /** \brief Create a new branch node that is not yet part of the tree
+         *  \return pointer to the new branch node
+         * */
+        BranchNode*
+        createBranch ()
+        {
+          return (new BranchNode ());
+        }
+
         /** \brief Fetch and add a new branch child to a branch class in current buffer
+         *  \note A branch child of the previous buffer at the same index is taken over with an empty current buffer.
          *  \param branch_arg: reference to octree branch class
          *  \param child_idx_arg: index to child node
          *  \return pointer of new branch child to this reference
@@ -744,6 +802,21 @@ namespace pcl
         inline  BranchNode* createBranchChild (BranchNode& branch_arg,
             unsigned char child_idx_arg)
         {
+          subtree_hash_valid_[buffer_selector_] = false;
+
+          OctreeNode* prev_child = branch_arg.getChildPtr (!buffer_selector_, child_idx_arg);
+          if (prev_child && (prev_child->getNodeType () == BRANCH_NODE))
+          {
+            BranchNode* prev_branch_child = static_cast<BranchNode*> (prev_child);
+            for (unsigned char child_idx = 0; child_idx < 8; child_idx++)
+              prev_branch_child->setChildPtr (buffer_selector_, child_idx, nullptr);
+
+            branch_arg.setChildPtr (buffer_selector_, child_idx_arg, prev_child);
+            return prev_branch_child;
+          }
+          if (prev_child)
+            deleteBranchChild (branch_arg, !buffer_selector_, child_idx_arg);
+
           BranchNode* new_branch_child = new BranchNode();
 
           branch_arg.setChildPtr (buffer_selector_, child_idx_arg,
@@ -753,6 +826,7 @@ namespace pcl
         }
 
         /** \brief Fetch and add a new leaf child to a branch class
+         *  \note A leaf child of the previous buffer at the same index is taken over with a reset container.
          *  \param branch_arg: reference to octree branch class
          *  \param child_idx_arg: index to child node
          *  \return pointer of new leaf child to this reference
@@ -760,6 +834,20 @@ namespace pcl
         inline LeafNode*
         createLeafChild (BranchNode& branch_arg, unsigned char child_idx_arg)
         {
+          subtree_hash_valid_[buffer_selector_] = false;
+
+          OctreeNode* prev_child = branch_arg.getChildPtr (!buffer_selector_, child_idx_arg);
+          if (prev_child && (prev_child->getNodeType () == LEAF_NODE))
+          {
+            LeafNode* prev_leaf_child = static_cast<LeafNode*> (prev_child);
+            prev_leaf_child->getContainer () = LeafContainerT ();
+
+            branch_arg.setChildPtr (buffer_selector_, child_idx_arg, prev_child);
+            return prev_leaf_child;
+          }
+          if (prev_child)
+            deleteBranchChild (branch_arg, !buffer_selector_, child_idx_arg);
+
           LeafNode* new_leaf_child = new LeafNode();
 
           branch_arg.setChildPtr(buffer_selector_, child_idx_arg, new_leaf_child);
@@ -881,6 +969,52 @@ namespace pcl
         void
         treeCleanUpRecursive (BranchNode* branch_arg);
 
+        /** \brief Hash the occupancy structure of all branch nodes in the current buffer.
+         *  \param nr_threads: number of threads used for the subtrees below the second tree level
+         **/
+        void
+        updateSubtreeHashes (unsigned int nr_threads = 1);
+
+        /** \brief Recursively hash the occupancy structure below a branch node in the current buffer
+         *  \param branch_arg: current branch node
+         *  \param depth_mask_arg: depth mask of the branch node
+         *  \param recursive_arg: hash the child branches first, otherwise their hashes are expected to be up to date
+         **/
+        void
+        hashSubtreeRecursive (BranchNode* branch_arg, unsigned int depth_mask_arg, bool recursive_arg = true);
+
+        /** \brief Recursively compare the current and the previous buffer below a branch node
+         *  \param branch_arg: current branch node
+         *  \param key_arg: reference to an octree key
+         *  \param added_leafs_arg: output vector for the containers of added leaf nodes
+         *  \param removed_leafs_arg: output vector for the containers of removed leaf nodes
+         *  \param added_keys_arg: optional output vector for the keys of added leaf nodes
+         *  \param removed_keys_arg: optional output vector for the keys of removed leaf nodes
+         *  \param prune_arg: skip branches whose subtree hashes agree in both buffers
+         **/
+        void
+        serializeChangedLeafsRecursive (BranchNode* branch_arg,
+                                        OctreeKey& key_arg,
+                                        std::vector<LeafContainerT*>& added_leafs_arg,
+                                        std::vector<LeafContainerT*>& removed_leafs_arg,
+                                        std::vector<OctreeKey>* added_keys_arg,
+                                        std::vector<OctreeKey>* removed_keys_arg,
+                                        bool prune_arg);
+
+        /** \brief Recursively collect all leaf nodes below an octree node in one of the buffers
+         *  \param node_arg: current octree node
+         *  \param buffer_selector_arg: buffer selector
+         *  \param key_arg: reference to the octree key of the node
+         *  \param leaf_container_vector_arg: output vector for the leaf containers
+         *  \param keys_arg: optional output vector for the leaf keys
+         **/
+        void
+        serializeSubtreeLeafsRecursive (OctreeNode* node_arg,
+                                        unsigned char buffer_selector_arg,
+                                        OctreeKey& key_arg,
+                                        std::vector<LeafContainerT*>& leaf_container_vector_arg,
+                                        std::vector<OctreeKey>* keys_arg);
+
         /** \brief Helper function to calculate the binary logarithm
          * \param n_arg: some value
          * \return binary logarithm (log2) of argument n_arg
@@ -940,6 +1074,9 @@ namespace pcl
         // flags indicating if unused branches and leafs might exist in previous buffer
         bool tree_dirty_flag_;
 
+        /** \brief Flags indicating if the subtree hashes of the branch nodes are up to date, per buffer **/
+        bool subtree_hash_valid_[2];
+
         /** \brief Octree depth */
         unsigned int octree_depth_;
 
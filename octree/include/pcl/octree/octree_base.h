@@ -41,6 +41,7 @@
 #include <vector>
 
 #include <pcl/octree/octree_nodes.h>
+#include <pcl/octree/octree_node_pool.h>
 #include <pcl/octree/octree_container.h>
 #include <pcl/octree/octree_key.h>
 #include <pcl/octree/octree_iterator.h>
@@ -53,6 +54,9 @@ namespace pcl
       * \note The tree depth defines the maximum amount of octree voxels / leaf nodes (should be initially defined).
       * \note All leaf nodes are addressed by integer indices.
       * \note Note: The tree depth equates to the bit length of the voxel indices.
+      * \note Nodes are allocated from node arenas (see OctreeNodeArena). Branch nodes still hold eight child pointers,
+      * as these are exposed by operator[], the iterators and the derived octrees: the arenas save allocation time,
+      * they do not shrink the nodes.
      * \ingroup octree
      * \author Julius Kammerl (julius@kammerl.de)
      */
@@ -82,6 +86,12 @@ namespace pcl
         /** \brief Amount of branch nodes   **/
         std::size_t branch_count_;
 
+        /** \brief Memory of the branch nodes   **/
+        OctreeNodeArena<BranchNode> branch_arena_;
+
+        /** \brief Memory of the leaf nodes   **/
+        OctreeNodeArena<LeafNode> leaf_arena_;
+
         /** \brief Pointer to root branch node of octree   **/
         BranchNode* root_node_;
 
@@ -221,21 +231,31 @@ namespace pcl
         OctreeBase (const OctreeBase& source) :
           leaf_count_ (source.leaf_count_),
           branch_count_ (source.branch_count_),
-          root_node_ (new (BranchNode) (*(source.root_node_))),
+          branch_arena_ (),
+          leaf_arena_ (),
+          root_node_ (branch_arena_.construct ()),
           depth_mask_ (source.depth_mask_),
           octree_depth_ (source.octree_depth_),
           dynamic_depth_enabled_(source.dynamic_depth_enabled_),
           max_key_ (source.max_key_)
         {
+          root_node_->getContainer () = source.root_node_->getContainer ();
+          copyBranchChildren (*source.root_node_, *root_node_);
         }
 
         /** \brief Copy operator. */
         OctreeBase&
         operator = (const OctreeBase &source)
         {
+          if (this == &source)
+            return (*this);
+
+          deleteTree ();
+          root_node_->getContainer () = source.root_node_->getContainer ();
+          copyBranchChildren (*source.root_node_, *root_node_);
+
           leaf_count_ = source.leaf_count_;
           branch_count_ = source.branch_count_;
-          root_node_ = new (BranchNode) (*(source.root_node_));
           depth_mask_ = source.depth_mask_;
           max_key_ = source.max_key_;
           octree_depth_ = source.octree_depth_;
@@ -448,6 +468,7 @@ namespace pcl
         }
 
         /** \brief Assign new child node to branch
+         *  \note The child node has to be created by this octree, as it is released to its node arenas.
          *  \param branch_arg: reference to octree branch class
          *  \param child_idx_arg: index to child node
          *  \param new_child_arg: pointer to new child node
@@ -496,14 +517,14 @@ namespace pcl
                 // free child branch recursively
                 deleteBranch (*static_cast<BranchNode*> (branch_child));
                 // delete branch node
-                delete branch_child;
+                branch_arena_.destroy (static_cast<BranchNode*> (branch_child));
               }
                 break;
 
               case LEAF_NODE:
               {
                 // delete leaf node
-                delete branch_child;
+                leaf_arena_.destroy (static_cast<LeafNode*> (branch_child));
                 break;
               }
               default:
@@ -526,6 +547,15 @@ namespace pcl
             deleteBranchChild (branch_arg, i);
         }
 
+        /** \brief Create a new branch node that is not yet part of the tree
+         *  \return pointer to the new branch node
+         * */
+        BranchNode*
+        createBranch ()
+        {
+          return (branch_arena_.construct ());
+        }
+
         /** \brief Create and add a new branch child to a branch class
          *  \param branch_arg: reference to octree branch class
          *  \param child_idx_arg: index to child node
@@ -534,7 +564,7 @@ namespace pcl
         BranchNode* createBranchChild (BranchNode& branch_arg,
                                        unsigned char child_idx_arg)
         {
-          BranchNode* new_branch_child = new BranchNode();
+          BranchNode* new_branch_child = branch_arena_.construct ();
           branch_arg[child_idx_arg] = static_cast<OctreeNode*> (new_branch_child);
 
           return new_branch_child;
@@ -548,12 +578,39 @@ namespace pcl
         LeafNode*
         createLeafChild (BranchNode& branch_arg, unsigned char child_idx_arg)
         {
-          LeafNode* new_leaf_child = new LeafNode();
+          LeafNode* new_leaf_child = leaf_arena_.construct ();
           branch_arg[child_idx_arg] = static_cast<OctreeNode*> (new_leaf_child);
 
           return new_leaf_child;
         }
 
+        /** \brief Recursively copy the child nodes of a branch of another octree
+         *  \param source_arg: branch to copy the child nodes from
+         *  \param branch_arg: branch of this octree receiving the copies
+         * */
+        void
+        copyBranchChildren (const BranchNode& source_arg, BranchNode& branch_arg)
+        {
+          for (unsigned char i = 0; i < 8; i++)
+          {
+            const OctreeNode* child = source_arg.getChildPtr (i);
+            if (!child)
+              continue;
+
+            if (child->getNodeType () == BRANCH_NODE)
+            {
+              const BranchNode* source_branch = static_cast<const BranchNode*> (child);
+              BranchNode* new_branch_child = createBranchChild (branch_arg, i);
+              new_branch_child->getContainer () = source_branch->getContainer ();
+              copyBranchChildren (*source_branch, *new_branch_child);
+            }
+            else
+            {
+              branch_arg[i] = leaf_arena_.construct (*static_cast<const LeafNode*> (child));
+            }
+          }
+        }
+
         //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         // Recursive octree methods
         //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -308,6 +308,15 @@ namespace pcl
           return leafDataTVector_;
         }
 
+        /** \brief Retrieve const reference to point indices vector. This container stores a vector of point indices.
+         * \return const reference to vector of point indices stored within data vector
+         */
+        const std::vector<int>&
+        getPointIndicesVector () const
+        {
+          return leafDataTVector_;
+        }
+
         /** \brief Get size of container (number of indices)
          * \return number of point indices in container.
          */
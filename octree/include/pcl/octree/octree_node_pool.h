@@ -37,8 +37,13 @@
 
 #pragma once
 
+#include <cstddef>
+#include <new>
+#include <utility>
 #include <vector>
 
+#include <Eigen/Core>
+
 #include <pcl/pcl_macros.h>
 
 namespace pcl
@@ -122,5 +127,118 @@ namespace pcl
         std::vector<NodeT*> nodePool_;
       };
 
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /** \brief @b Octree node arena
+     * \note Nodes are constructed in place within large, aligned memory blocks instead of being allocated one by one.
+     * Destroyed nodes are recycled for later constructions; the memory blocks are only released with the arena, so
+     * every node has to be destroyed before that.
+     * \note The arena only changes where nodes live, not their layout: every node still takes sizeof (NodeT).
+     */
+    template<typename NodeT>
+      class OctreeNodeArena
+      {
+      public:
+        /** \brief Empty constructor. */
+        OctreeNodeArena () :
+            blocks_ (), free_nodes_ (), next_node_ (nullptr), block_end_ (nullptr), next_block_size_ (min_block_size)
+        {
+        }
+
+        OctreeNodeArena (const OctreeNodeArena&) = delete;
+
+        OctreeNodeArena&
+        operator = (const OctreeNodeArena&) = delete;
+
+        /** \brief Destructor, releases the memory blocks. */
+        ~OctreeNodeArena ()
+        {
+          Eigen::aligned_allocator<NodeT> allocator;
+          for (const auto &block : blocks_)
+            allocator.deallocate (block.first, block.second);
+        }
+
+        /** \brief Construct a node in the arena.
+         *  \param args: the arguments forwarded to the node constructor
+         *  \return pointer to the new node
+         */
+        template<typename... ArgsT> NodeT*
+        construct (ArgsT&&... args)
+        {
+          NodeT* memory = allocate ();
+          try
+          {
+            return (new (memory) NodeT (std::forward<ArgsT> (args)...));
+          }
+          catch (...)
+          {
+            free_nodes_.push_back (memory);
+            throw;
+          }
+        }
+
+        /** \brief Destroy a node constructed by this arena and recycle its memory.
+         *  \param node_arg: the node to destroy
+         */
+        void
+        destroy (NodeT* node_arg)
+        {
+          node_arg->~NodeT ();
+          free_nodes_.push_back (node_arg);
+        }
+
+        /** \brief Get the number of nodes the allocated memory blocks can hold. */
+        std::size_t
+        getCapacity () const
+        {
+          std::size_t capacity = 0;
+          for (const auto &block : blocks_)
+            capacity += block.second;
+          return (capacity);
+        }
+
+      protected:
+        /** \brief Get memory for one node, from the recycled nodes or the current block. */
+        NodeT*
+        allocate ()
+        {
+          if (!free_nodes_.empty ())
+          {
+            NodeT* node = free_nodes_.back ();
+            free_nodes_.pop_back ();
+            return (node);
+          }
+
+          if (next_node_ == block_end_)
+          {
+            // blocks grow geometrically, so that small trees stay small
+            NodeT* block = Eigen::aligned_allocator<NodeT> ().allocate (next_block_size_);
+            blocks_.emplace_back (block, next_block_size_);
+            next_node_ = block;
+            block_end_ = block + next_block_size_;
+            if (next_block_size_ < max_block_size)
+              next_block_size_ *= 2;
+          }
+          return (next_node_++);
+        }
+
+        static const std::size_t min_block_size = 64;
+        static const std::size_t max_block_size = 65536;
+
+        /** \brief Memory blocks and their sizes in nodes. */
+        std::vector<std::pair<NodeT*, std::size_t> > blocks_;
+
+        /** \brief Memory of destroyed nodes. */
+        std::vector<NodeT*> free_nodes_;
+
+        /** \brief Next unused node of the current block. */
+        NodeT* next_node_;
+
+        /** \brief End of the current block. */
+        NodeT* block_end_;
+
+        /** \brief Size of the next block in nodes. */
+        std::size_t next_block_size_;
+      };
+
   }
 }
@@ -176,10 +176,19 @@ namespace pcl
           return this->octree_depth_;
         }
 
-        /** \brief Add points from input point cloud to octree. */
+        /** \brief Add points from input point cloud to octree.
+         * \note If the octree is empty and has a fixed depth, all points are inserted in one pass: their keys are
+         * computed in parallel, radix sorted by Morton order and the tree is built from the sorted keys.
+         */
         void
         addPointsFromInputCloud ();
 
+        /** \brief Set the number of threads used to build the octree in \a addPointsFromInputCloud.
+         * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+         */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
         /** \brief Add point at given index from input point cloud to octree. Index will be also added to indices vector.
          * \param[in] point_idx_arg index of point to be added
          * \param[in] indices_arg pointer to indices vector of the dataset (given by \a setInputCloud)
@@ -387,6 +396,26 @@ namespace pcl
         virtual void
         addPointIdx (const int point_idx_arg);
 
+        /** \brief Add points at indices from input pointcloud dataset to an empty octree in a single pass.
+         * \note The bounding box needs to contain all points already. Leaf containers receive their points in the order
+         * given by \a point_indices_arg through \a addPointToLeafContainer.
+         * \param[in] point_indices_arg the indices representing the points in the dataset given by \a setInputCloud to be added
+         */
+        void
+        addPointIndicesBulk (const std::vector<int>& point_indices_arg);
+
+        /** \brief Add point at index from input pointcloud dataset to a leaf container during bulk insertion.
+         * \note Called concurrently for different leaf containers. Derived classes that override \a addPointIdx
+         * to fill their leaf containers differently need to override this method accordingly.
+         * \param[in] point_idx_arg the index representing the point in the dataset given by \a setInputCloud
+         * \param[in] container_arg leaf container of the voxel the point falls into
+         */
+        virtual void
+        addPointToLeafContainer (const int point_idx_arg, LeafContainerT& container_arg)
+        {
+          container_arg.addPointIndex (point_idx_arg);
+        }
+
         /** \brief Add point at index from input pointcloud dataset to octree
          * \param[in] leaf_node to be expanded
          * \param[in] parent_branch parent of leaf node to be expanded
@@ -428,9 +457,11 @@ namespace pcl
 
         /** \brief Grow the bounding box/octree until point fits
          * \param[in] point_idx_arg point that should be within bounding box;
+         * \param[in] expand_root_arg add a root branch for every level the octree grows by. Only an octree that is
+         * still empty and gets built afterwards may skip this.
          */
         void
-        adoptBoundingBoxToPoint (const PointT& point_idx_arg);
+        adoptBoundingBoxToPoint (const PointT& point_idx_arg, bool expand_root_arg = true);
 
         /** \brief Checks if given point is within the bounding box of the octree
          * \param[in] point_idx_arg point to be checked for bounding box violations
@@ -541,6 +572,9 @@ namespace pcl
          *  \note zero indicates a fixed/maximum depth octree structure
          * **/
         std::size_t max_objs_per_leaf_;
+
+        /** \brief The number of threads used for bulk insertion. */
+        unsigned int threads_;
     };
 
   }
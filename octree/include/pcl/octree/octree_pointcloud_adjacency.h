@@ -192,6 +192,28 @@ namespace pcl
         void
         genOctreeKeyforPoint (const PointT& point_arg, OctreeKey& key_arg) const;
 
+        /** \brief Generates octree key for the point at the given index (uses transform if provided).
+          *
+          * \param[in] data_arg Index of the point in the input cloud
+          * \param[out] key_arg Resulting octree key
+          * \return "true" - octree keys are assignable */
+        bool
+        genOctreeKeyForDataT (const int& data_arg, OctreeKey& key_arg) const override
+        {
+          genOctreeKeyforPoint (this->input_->points[data_arg], key_arg);
+          return (true);
+        }
+
+        /** \brief Adds point at index to a leaf container during bulk insertion.
+          *
+          * \param[in] point_idx_arg Index of the point in the input cloud
+          * \param[in] container_arg Leaf container of the voxel the point falls into */
+        void
+        addPointToLeafContainer (const int point_idx_arg, LeafContainerT& container_arg) override
+        {
+          container_arg.addPoint (this->input_->points[point_idx_arg]);
+        }
+
       private:
 
         /** \brief Add point at given index from input point cloud to octree.
@@ -71,6 +71,10 @@ namespace pcl
 
         using Ptr = boost::shared_ptr<OctreePointCloudChangeDetector<PointT, LeafContainerT, BranchContainerT>>;
 
+        using OctreeT = OctreePointCloud<PointT, LeafContainerT, BranchContainerT,
+            Octree2BufBase<LeafContainerT, BranchContainerT> >;
+        using AlignedPointTVector = typename OctreeT::AlignedPointTVector;
+
         /** \brief Constructor.
          *  \param resolution_arg:  octree resolution at lowest octree level
          * */
@@ -105,6 +109,111 @@ namespace pcl
 
           return (indicesVector_arg.size ());
         }
+
+        /** \brief Add points from the input point cloud to the current buffer.
+         * \note Right after switchBuffers () the current buffer is built in bulk from Morton sorted keys, using
+         * setNumberOfThreads () threads. Nodes that already exist in the previous buffer are taken over and their
+         * leaf containers are reset. If the bounding box has to grow while the previous buffer is not empty, the
+         * points are added one by one.
+         */
+        void
+        addPointsFromInputCloud ()
+        {
+          const bool bulk_insertion = (this->leaf_count_ == 0) && (this->branch_count_ == 1);
+          const bool previous_buffer_empty = !this->getBranchBitPattern (*this->root_node_, !this->buffer_selector_);
+
+          std::vector<int> point_indices;
+          bool bounding_box_grows = false;
+          const int nr_points = static_cast<int> (this->indices_ ? this->indices_->size () : this->input_->points.size ());
+          point_indices.reserve (nr_points);
+
+          for (int i = 0; i < nr_points; i++)
+          {
+            const int index = this->indices_ ? (*this->indices_)[i] : i;
+            const PointT& point = this->input_->points[index];
+            if (!isFinite (point))
+              continue;
+
+            if (!this->bounding_box_defined_ || !this->isPointWithinBoundingBox (point))
+            {
+              bounding_box_grows = true;
+              if (bulk_insertion && previous_buffer_empty)
+                this->adoptBoundingBoxToPoint (point, false);
+            }
+
+            point_indices.push_back (index);
+          }
+
+          if (bulk_insertion && (previous_buffer_empty || !bounding_box_grows))
+          {
+            this->addPointIndicesBulk (point_indices);
+          }
+          else
+          {
+            for (const int &index : point_indices)
+              this->addPointIdx (index);
+          }
+        }
+
+        /** \brief Get the point indices from all leaf nodes that were added to or removed from the current buffer.
+         * \note Only subtrees whose hashes differ between both buffers are traversed. The removed indices refer to
+         * the point cloud that was the input when the previous buffer was built in bulk.
+         * \param added_indices_arg: indices of the points in voxels that did not exist in the previous buffer
+         * \param removed_indices_arg: indices of the points in voxels that do not exist anymore in the current buffer
+         * \param min_points_per_leaf_arg: minimum amount of points required within a leaf node to become serialized.
+         * \return number of added and removed point indices
+         */
+        std::size_t
+        getPointIndicesFromChangedVoxels (std::vector<int> &added_indices_arg,
+                                          std::vector<int> &removed_indices_arg,
+                                          const int min_points_per_leaf_arg = 0)
+        {
+          std::vector<LeafContainerT*> added_leafs;
+          std::vector<LeafContainerT*> removed_leafs;
+
+          if (!this->subtree_hash_valid_[this->buffer_selector_])
+            this->updateSubtreeHashes (this->threads_);
+          this->serializeChangedLeafs (added_leafs, removed_leafs);
+
+          for (const auto &leaf_container : added_leafs)
+            if (static_cast<int> (leaf_container->getSize ()) >= min_points_per_leaf_arg)
+              leaf_container->getPointIndices (added_indices_arg);
+
+          for (const auto &leaf_container : removed_leafs)
+            if (static_cast<int> (leaf_container->getSize ()) >= min_points_per_leaf_arg)
+              leaf_container->getPointIndices (removed_indices_arg);
+
+          return (added_indices_arg.size () + removed_indices_arg.size ());
+        }
+
+        /** \brief Get the centers of all voxels that were added to or removed from the current buffer.
+         * \param added_voxel_centers_arg: centers of the voxels that did not exist in the previous buffer
+         * \param removed_voxel_centers_arg: centers of the voxels that do not exist anymore in the current buffer
+         * \return number of added and removed voxels
+         */
+        std::size_t
+        getChangedVoxelCenters (AlignedPointTVector &added_voxel_centers_arg,
+                                AlignedPointTVector &removed_voxel_centers_arg)
+        {
+          std::vector<LeafContainerT*> added_leafs;
+          std::vector<LeafContainerT*> removed_leafs;
+          std::vector<OctreeKey> added_keys;
+          std::vector<OctreeKey> removed_keys;
+
+          if (!this->subtree_hash_valid_[this->buffer_selector_])
+            this->updateSubtreeHashes (this->threads_);
+          this->serializeChangedLeafs (added_leafs, removed_leafs, &added_keys, &removed_keys);
+
+          added_voxel_centers_arg.resize (added_keys.size ());
+          for (std::size_t i = 0; i < added_keys.size (); ++i)
+            this->genLeafNodeCenterFromOctreeKey (added_keys[i], added_voxel_centers_arg[i]);
+
+          removed_voxel_centers_arg.resize (removed_keys.size ());
+          for (std::size_t i = 0; i < removed_keys.size (); ++i)
+            this->genLeafNodeCenterFromOctreeKey (removed_keys[i], removed_voxel_centers_arg[i]);
+
+          return (added_keys.size () + removed_keys.size ());
+        }
     };
   }
 }
@@ -186,6 +186,16 @@ namespace pcl
 
         }
 
+        /** \brief Add point at index to the centroid of a leaf container during bulk insertion.
+          * \param[in] pointIdx_arg index of the point in the input cloud
+          * \param[in] container_arg leaf container of the voxel the point falls into
+          */
+        void
+        addPointToLeafContainer (const int pointIdx_arg, LeafContainerT& container_arg) override
+        {
+          container_arg.addPoint (this->input_->points[pointIdx_arg]);
+        }
+
         /** \brief Get centroid for a single voxel addressed by a PointT point.
           * \param[in] point_arg point addressing a voxel in octree
           * \param[out] voxel_centroid_arg centroid is written to this PointT reference
@@ -116,7 +116,7 @@ namespace pcl
           */
         inline int
         nearestKSearch (const PointCloud &cloud, int index, int k, std::vector<int> &k_indices,
-                        std::vector<float> &k_sqr_distances)
+                        std::vector<float> &k_sqr_distances) const
         {
           return (nearestKSearch (cloud[index], k, k_indices, k_sqr_distances));
         }
@@ -130,7 +130,7 @@ namespace pcl
           */
         int
         nearestKSearch (const PointT &p_q, int k, std::vector<int> &k_indices,
-                        std::vector<float> &k_sqr_distances);
+                        std::vector<float> &k_sqr_distances) const;
 
         /** \brief Search for k-nearest neighbors at query point
           * \param[in] index index representing the query point in the dataset given by \a setInputCloud.
@@ -142,7 +142,20 @@ namespace pcl
          * \return number of neighbors found
          */
         int
-        nearestKSearch (int index, int k, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances);
+        nearestKSearch (int index, int k, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const;
+
+        /** \brief Search for k-nearest neighbors of several query points in parallel.
+          * \note The number of threads is set with \a setNumberOfThreads.
+          * \param[in] cloud the point cloud data holding the query points
+          * \param[in] indices the indices in \a cloud of the query points. If empty, all points of \a cloud are queried.
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points, k_indices[i] corresponds to the neighbors of the query point i
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points, k_sqr_distances[i] corresponds to the neighbors of the query point i
+          */
+        void
+        nearestKSearch (const PointCloud& cloud, const std::vector<int>& indices, int k,
+                        std::vector<std::vector<int> >& k_indices,
+                        std::vector<std::vector<float> >& k_sqr_distances) const;
 
         /** \brief Search for approx. nearest neighbor at the query point.
           * \param[in] cloud the point cloud data
@@ -216,6 +229,20 @@ namespace pcl
         radiusSearch (int index, const double radius, std::vector<int> &k_indices,
                       std::vector<float> &k_sqr_distances, unsigned int max_nn = 0) const;
 
+        /** \brief Search for all neighbors of several query points within a given radius in parallel.
+          * \note The number of threads is set with \a setNumberOfThreads.
+          * \param[in] cloud the point cloud data holding the query points
+          * \param[in] indices the indices in \a cloud of the query points. If empty, all points of \a cloud are queried.
+          * \param[in] radius the radius of the sphere bounding all of the query points' neighbors
+          * \param[out] k_indices the resultant indices of the neighboring points, k_indices[i] corresponds to the neighbors of the query point i
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points, k_sqr_distances[i] corresponds to the neighbors of the query point i
+          * \param[in] max_nn if given, bounds the maximum returned neighbors per query to this value
+          */
+        void
+        radiusSearch (const PointCloud& cloud, const std::vector<int>& indices, double radius,
+                      std::vector<std::vector<int> >& k_indices,
+                      std::vector<std::vector<float> >& k_sqr_distances, unsigned int max_nn = 0) const;
+
         /** \brief Get a PointT vector of centers of all voxels that intersected by a ray (origin, direction).
           * \param[in] origin ray origin
           * \param[in] direction ray direction vector
@@ -263,17 +290,19 @@ namespace pcl
         public:
           /** \brief Empty constructor  */
           prioBranchQueueEntry () :
-              node (), point_distance (0)
+              node (), point_distance (0), tree_depth (0)
           {
           }
 
           /** \brief Constructor for initializing priority queue entry.
            * \param _node pointer to octree node
            * \param _key octree key addressing voxel in octree structure
-           * \param[in] _point_distance distance of query point to voxel center
+           * \param[in] _point_distance distance of query point to voxel
+           * \param[in] _tree_depth depth of the node in the octree
            */
-          prioBranchQueueEntry (OctreeNode* _node, OctreeKey& _key, float _point_distance) :
-              node (_node), point_distance (_point_distance), key (_key)
+          prioBranchQueueEntry (const OctreeNode* _node, const OctreeKey& _key, float _point_distance,
+                                unsigned int _tree_depth = 0) :
+              node (_node), point_distance (_point_distance), key (_key), tree_depth (_tree_depth)
           {
           }
 
@@ -294,6 +323,9 @@ namespace pcl
 
           /** \brief Octree key. */
           OctreeKey key;
+
+          /** \brief Depth of the node in the octree. */
+          unsigned int tree_depth;
         };
 
         //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -315,7 +347,7 @@ namespace pcl
            * \param[in] point_idx an index representing a point in the dataset given by \a setInputCloud
            * \param[in] point_distance distance of query point to voxel center
            */
-          prioPointQueueEntry (unsigned int& point_idx, float point_distance) :
+          prioPointQueueEntry (int point_idx, float point_distance) :
               point_idx_ (point_idx), point_distance_ (point_distance)
           {
           }
@@ -344,6 +376,15 @@ namespace pcl
         float
         pointSquaredDist (const PointT& point_a, const PointT& point_b) const;
 
+        /** \brief Helper function to calculate the squared distance between a point and a voxel
+          * \param[in] point query point
+          * \param[in] key octree key addressing the voxel
+          * \param[in] tree_depth depth/level of the voxel in the octree
+          * \return squared distance between the point and the closest point of the voxel, zero if the point lies inside
+          */
+        float
+        pointSquaredDistToVoxel (const PointT& point, const OctreeKey& key, unsigned int tree_depth) const;
+
         //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         // Recursive search routine methods
         //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -357,28 +398,25 @@ namespace pcl
           * \param[out] k_indices vector of indices found to be neighbors of query point
           * \param[out] k_sqr_distances squared distances of neighbors to query point
           * \param[in] max_nn maximum of neighbors to be found
+          * \param[in] leaf_indices scratch buffer for the point indices of leaf containers
           */
         void
         getNeighborsWithinRadiusRecursive (const PointT& point, const double radiusSquared,
                                            const BranchNode* node, const OctreeKey& key,
                                            unsigned int tree_depth, std::vector<int>& k_indices,
-                                           std::vector<float>& k_sqr_distances, unsigned int max_nn) const;
+                                           std::vector<float>& k_sqr_distances, unsigned int max_nn,
+                                           std::vector<int>& leaf_indices) const;
 
-        /** \brief Recursive search method that explores the octree and finds the K nearest neighbors
+        /** \brief Best-first search method that explores the octree and finds the K nearest neighbors.
+          * \note Nodes are visited in order of their distance to the query point until the closest remaining node
+          * is farther away than the K-th candidate.
           * \param[in] point query point
           * \param[in] K amount of nearest neighbors to be found
-          * \param[in] node current octree node to be explored
-          * \param[in] key octree key addressing a leaf node.
-          * \param[in] tree_depth current depth/level in the octree
-          * \param[in] squared_search_radius squared search radius distance
-          * \param[out] point_candidates priority queue of nearest neigbor point candidates
-          * \return squared search radius based on current point candidate set found
+          * \param[out] point_candidates max-heap of the (up to) K nearest neighbor point candidates
           */
-        double
-        getKNearestNeighborRecursive (const PointT& point, unsigned int K, const BranchNode* node,
-                                      const OctreeKey& key, unsigned int tree_depth,
-                                      const double squared_search_radius,
-                                      std::vector<prioPointQueueEntry>& point_candidates) const;
+        void
+        getKNearestNeighbors (const PointT& point, unsigned int K,
+                              std::vector<prioPointQueueEntry>& point_candidates) const;
 
         /** \brief Recursive search method that explores the octree and finds the approximate nearest neighbor
           * \param[in] point query point
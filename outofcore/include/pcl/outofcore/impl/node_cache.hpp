@@ -0,0 +1,294 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Urban Robotics, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PCL_OUTOFCORE_NODE_CACHE_IMPL_H_
+#define PCL_OUTOFCORE_NODE_CACHE_IMPL_H_
+
+#include <pcl/outofcore/node_cache.h>
+
+namespace pcl
+{
+  namespace outofcore
+  {
+
+    template<typename PointT, typename PayloadT>
+    const size_t OutofcoreNodeCache<PointT, PayloadT>::default_budget_;
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename PayloadT>
+    OutofcoreNodeCache<PointT, PayloadT>::OutofcoreNodeCache (const size_t budget_bytes, const size_t nr_shards)
+      : shards_ ()
+      , budget_ (budget_bytes)
+      , hits_ (0)
+      , misses_ (0)
+      , evictions_ (0)
+    {
+      shards_.resize (nr_shards > 0 ? nr_shards : 1);
+      for (auto &shard : shards_)
+        shard.reset (new Shard);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename PayloadT>
+    template<typename LoadFunctor> typename OutofcoreNodeCache<PointT, PayloadT>::PayloadConstPtr
+    OutofcoreNodeCache<PointT, PayloadT>::get (const std::string &path, const boost::uint64_t lod, const boost::uint64_t nr_points, LoadFunctor load)
+    {
+      if (budget_ == 0)
+      {
+        misses_++;
+        return (makePayload (load ()));
+      }
+
+      const Key key = {path, lod};
+      Shard &shard = shardFor (key);
+
+      std::promise<PayloadConstPtr> promise;
+      {
+        std::unique_lock<std::mutex> lock (shard.mutex);
+
+        auto entry = shard.entries.find (key);
+        if (entry != shard.entries.end ())
+        {
+          if (entry->second.nr_points == nr_points)
+          {
+            shard.lru.splice (shard.lru.begin (), shard.lru, entry->second.lru_it);
+            hits_++;
+            return (entry->second.payload);
+          }
+
+          //the node changed since it was cached
+          shard.bytes -= entry->second.bytes;
+          shard.lru.erase (entry->second.lru_it);
+          shard.entries.erase (entry);
+        }
+
+        //share a read another thread already started
+        auto in_flight = shard.in_flight.find (key);
+        if (in_flight != shard.in_flight.end ())
+        {
+          std::shared_future<PayloadConstPtr> pending = in_flight->second;
+          lock.unlock ();
+
+          PayloadConstPtr payload = pending.get ();
+          if (payload->size () == nr_points)
+          {
+            hits_++;
+            return (payload);
+          }
+
+          misses_++;
+          return (makePayload (load ()));
+        }
+
+        shard.in_flight.emplace (key, promise.get_future ().share ());
+      }
+
+      misses_++;
+
+      PayloadConstPtr payload;
+      try
+      {
+        payload = makePayload (load ());
+      }
+      catch (...)
+      {
+        {
+          std::lock_guard<std::mutex> lock (shard.mutex);
+          shard.in_flight.erase (key);
+        }
+        promise.set_exception (std::current_exception ());
+        throw;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock (shard.mutex);
+        shard.in_flight.erase (key);
+        insert (shard, key, payload, nr_points);
+      }
+      promise.set_value (payload);
+
+      return (payload);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename PayloadT>
+    template<typename LoadFunctor> std::future<void>
+    OutofcoreNodeCache<PointT, PayloadT>::prefetch (const std::string &path, const boost::uint64_t lod, const boost::uint64_t nr_points, LoadFunctor load)
+    {
+      if (budget_ == 0 || contains (path, lod, nr_points))
+      {
+        std::promise<void> done;
+        done.set_value ();
+        return (done.get_future ());
+      }
+
+      return (std::async (std::launch::async, [this, path, lod, nr_points, load] ()
+      {
+        get (path, lod, nr_points, load);
+      }));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename PayloadT> bool
+    OutofcoreNodeCache<PointT, PayloadT>::contains (const std::string &path, const boost::uint64_t lod, const boost::uint64_t nr_points) const
+    {
+      const Key key = {path, lod};
+      const Shard &shard = shardFor (key);
+
+      std::lock_guard<std::mutex> lock (shard.mutex);
+      auto entry = shard.entries.find (key);
+      return (entry != shard.entries.end () && entry->second.nr_points == nr_points);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename PayloadT> void
+    OutofcoreNodeCache<PointT, PayloadT>::erase (const std::string &path, const boost::uint64_t lod)
+    {
+      const Key key = {path, lod};
+      Shard &shard = shardFor (key);
+
+      std::lock_guard<std::mutex> lock (shard.mutex);
+      auto entry = shard.entries.find (key);
+      if (entry == shard.entries.end ())
+        return;
+
+      shard.bytes -= entry->second.bytes;
+      shard.lru.erase (entry->second.lru_it);
+      shard.entries.erase (entry);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename PayloadT> void
+    OutofcoreNodeCache<PointT, PayloadT>::clear ()
+    {
+      for (auto &shard : shards_)
+      {
+        std::lock_guard<std::mutex> lock (shard->mutex);
+        shard->entries.clear ();
+        shard->lru.clear ();
+        shard->bytes = 0;
+      }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename PayloadT> void
+    OutofcoreNodeCache<PointT, PayloadT>::setBudget (const size_t budget_bytes)
+    {
+      budget_ = budget_bytes;
+      for (auto &shard : shards_)
+      {
+        std::lock_guard<std::mutex> lock (shard->mutex);
+        evict (*shard, budget_bytes / shards_.size ());
+      }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename PayloadT> typename OutofcoreNodeCache<PointT, PayloadT>::Stats
+    OutofcoreNodeCache<PointT, PayloadT>::getStats () const
+    {
+      Stats stats;
+      stats.hits = hits_;
+      stats.misses = misses_;
+      stats.evictions = evictions_;
+      stats.bytes = 0;
+      stats.entries = 0;
+
+      for (const auto &shard : shards_)
+      {
+        std::lock_guard<std::mutex> lock (shard->mutex);
+        stats.bytes += shard->bytes;
+        stats.entries += shard->entries.size ();
+      }
+      return (stats);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename PayloadT> void
+    OutofcoreNodeCache<PointT, PayloadT>::resetStats ()
+    {
+      hits_ = 0;
+      misses_ = 0;
+      evictions_ = 0;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename PayloadT> void
+    OutofcoreNodeCache<PointT, PayloadT>::evict (Shard &shard, const size_t limit)
+    {
+      while (shard.bytes > limit && !shard.lru.empty ())
+      {
+        auto entry = shard.entries.find (shard.lru.back ());
+        shard.bytes -= entry->second.bytes;
+        shard.entries.erase (entry);
+        shard.lru.pop_back ();
+        evictions_++;
+      }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename PayloadT> void
+    OutofcoreNodeCache<PointT, PayloadT>::insert (Shard &shard, const Key &key, const PayloadConstPtr &payload, const boost::uint64_t nr_points)
+    {
+      const size_t bytes = payloadBytes (*payload) + sizeof (Entry) + key.path.size ();
+      const size_t limit = budget_ / shards_.size ();
+
+      //a payload larger than the shard's share of the budget is never kept
+      if (bytes > limit)
+        return;
+
+      evict (shard, limit - bytes);
+
+      shard.lru.push_front (key);
+      Entry entry = {payload, nr_points, bytes, shard.lru.begin ()};
+      shard.entries[key] = entry;
+      shard.bytes += bytes;
+    }
+
+  }//namespace outofcore
+}//namespace pcl
+
+#endif //PCL_OUTOFCORE_NODE_CACHE_IMPL_H_
@@ -48,13 +48,24 @@
 
 #include <pcl/filters/random_sample.h>
 #include <pcl/filters/extract_indices.h>
+#include <pcl/common/point_tests.h>
 
 // C++
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
 #include <sstream>
 #include <string>
 #include <exception>
+#include <thread>
 
 namespace pcl
 {
@@ -188,6 +199,12 @@ namespace pcl
     template<typename ContainerT, typename PointT>
     OutofcoreOctreeBase<ContainerT, PointT>::~OutofcoreOctreeBase ()
     {
+      //wait for running prefetches before the nodes go away
+      {
+        std::lock_guard<std::mutex> lock (prefetch_mutex_);
+        prefetch_tasks_.clear ();
+      }
+
       root_node_->flushToDiskRecursive ();
 
       saveToFile ();
@@ -208,6 +225,8 @@ namespace pcl
     OutofcoreOctreeBase<ContainerT, PointT>::addDataToLeaf (const AlignedPointTVector& p)
     {
       std::unique_lock < std::shared_timed_mutex > lock (read_write_mutex_);
+      node_cache_.clear ();
+      search_index_cache_.clear ();
 
       const bool _FORCE_BB_CHECK = true;
       
@@ -231,11 +250,189 @@ namespace pcl
     template<typename ContainerT, typename PointT> boost::uint64_t
     OutofcoreOctreeBase<ContainerT, PointT>::addPointCloud (pcl::PCLPointCloud2::Ptr &input_cloud, const bool skip_bb_check)
     {
+      node_cache_.clear ();
+      search_index_cache_.clear ();
       uint64_t pt_added = this->root_node_->addPointCloud (input_cloud, skip_bb_check) ;
 //      assert (input_cloud->width*input_cloud->height == pt_added);
       return (pt_added);
     }
 
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> boost::uint64_t
+    OutofcoreOctreeBase<ContainerT, PointT>::addPointCloud_parallel (pcl::PCLPointCloud2::Ptr &input_cloud, unsigned int nr_threads)
+    {
+      const boost::uint64_t depth = this->getDepth ();
+      const size_t nr_points = input_cloud->width*input_cloud->height;
+
+      if (nr_points == 0)
+        return (0);
+
+      //the octant path of a leaf has to fit in a 64 bit code
+      if (3 * depth > 63)
+      {
+        PCL_WARN ("[pcl::outofcore::OutofcoreOctreeBase::%s] Tree depth %lu is too deep for octant path codes; inserting serially\n", __FUNCTION__, depth);
+        return (addPointCloud (input_cloud, false));
+      }
+
+      const int x_idx = pcl::getFieldIndex (*input_cloud, "x");
+      const int y_idx = pcl::getFieldIndex (*input_cloud, "y");
+      const int z_idx = pcl::getFieldIndex (*input_cloud, "z");
+      if (x_idx == -1 || y_idx == -1 || z_idx == -1)
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] Input cloud has no x, y and z fields\n", __FUNCTION__);
+        return (0);
+      }
+
+      if (nr_threads == 0)
+        nr_threads = std::max (1u, std::thread::hardware_concurrency ());
+
+      // Lock the tree while writing
+      std::unique_lock < std::shared_timed_mutex > lock (read_write_mutex_);
+      node_cache_.clear ();
+      search_index_cache_.clear ();
+
+      const size_t point_step = input_cloud->point_step;
+      const size_t x_offset = input_cloud->fields[x_idx].offset;
+      const size_t y_offset = input_cloud->fields[y_idx].offset;
+      const size_t z_offset = input_cloud->fields[z_idx].offset;
+
+      Eigen::Vector3d root_min, root_max;
+      root_node_->getBoundingBox (root_min, root_max);
+
+      //1. compute the octant path code of every point, descending through
+      //   the same bounding boxes the nodes are created with; like the serial
+      //   insertion, points outside of the root bounding box are dropped
+      const boost::uint64_t invalid_code = std::numeric_limits<boost::uint64_t>::max ();
+      std::vector<std::pair<boost::uint64_t, int> > codes (nr_points);
+
+      const size_t chunk_size = 65536;
+      std::vector<size_t> outside_points ((nr_points + chunk_size - 1) / chunk_size, 0);
+      runParallel ((nr_points + chunk_size - 1) / chunk_size, nr_threads, [&] (const size_t chunk)
+      {
+        const size_t last = std::min (nr_points, (chunk + 1) * chunk_size);
+        for (size_t i = chunk * chunk_size; i < last; i++)
+        {
+          const boost::uint8_t* point = &input_cloud->data[i * point_step];
+          float xyz[3];
+          memcpy (&xyz[0], point + x_offset, sizeof (float));
+          memcpy (&xyz[1], point + y_offset, sizeof (float));
+          memcpy (&xyz[2], point + z_offset, sizeof (float));
+
+          codes[i].second = static_cast<int> (i);
+          if (!std::isfinite (xyz[0]) || !std::isfinite (xyz[1]) || !std::isfinite (xyz[2]))
+          {
+            codes[i].first = invalid_code;
+            continue;
+          }
+
+          PointT pt;
+          pt.x = xyz[0];
+          pt.y = xyz[1];
+          pt.z = xyz[2];
+          if (!OutofcoreNodeType::pointInBoundingBox (root_min, root_max, pt))
+          {
+            codes[i].first = invalid_code;
+            outside_points[chunk]++;
+            continue;
+          }
+
+          double bb_min[3] = { root_min[0], root_min[1], root_min[2] };
+          double bb_max[3] = { root_max[0], root_max[1], root_max[2] };
+          boost::uint64_t code = 0;
+          for (boost::uint64_t level = 0; level < depth; level++)
+          {
+            size_t octant = 0;
+            for (int k = 0; k < 3; k++)
+            {
+              const double mid = (bb_max[k] + bb_min[k]) / 2.0;
+              const double step = (bb_max[k] - bb_min[k]) / 2.0;
+              const int upper = (xyz[k] >= mid) ? 1 : 0;
+              const double start = bb_min[k];
+
+              octant |= upper << k;
+              bb_min[k] = start + static_cast<double> (upper) * step;
+              bb_max[k] = start + static_cast<double> (upper + 1) * step;
+            }
+            code = (code << 3) | octant;
+          }
+          codes[i].first = code;
+        }
+      });
+
+      const size_t nr_outside = std::accumulate (outside_points.begin (), outside_points.end (), static_cast<size_t> (0));
+      if (nr_outside > 0)
+        PCL_WARN ("[pcl::outofcore::OutofcoreOctreeBase::%s] Dropped %lu points outside of the root bounding box\n", __FUNCTION__, nr_outside);
+
+      //2. bucket the points on the first partition_depth octants of their
+      //   code; every bucket is an independent subtree
+      boost::uint64_t partition_depth = 0;
+      while (partition_depth < depth && (static_cast<size_t> (1) << (3 * partition_depth)) < 4 * static_cast<size_t> (nr_threads))
+        partition_depth++;
+
+      const boost::uint64_t prefix_shift = 3 * (depth - partition_depth);
+      const size_t nr_buckets = static_cast<size_t> (1) << (3 * partition_depth);
+
+      std::vector<size_t> bucket_begin (nr_buckets + 1, 0);
+      for (const auto &entry : codes)
+      {
+        if (entry.first != invalid_code)
+          bucket_begin[(entry.first >> prefix_shift) + 1]++;
+      }
+      std::partial_sum (bucket_begin.begin (), bucket_begin.end (), bucket_begin.begin ());
+
+      std::vector<std::pair<boost::uint64_t, int> > sorted_codes (bucket_begin.back ());
+      {
+        std::vector<size_t> bucket_fill (bucket_begin.begin (), bucket_begin.end () - 1);
+        for (const auto &entry : codes)
+        {
+          if (entry.first != invalid_code)
+            sorted_codes[bucket_fill[entry.first >> prefix_shift]++] = entry;
+        }
+        std::vector<std::pair<boost::uint64_t, int> > ().swap (codes);
+      }
+
+      //3. create the path down to every subtree root; the nodes above the
+      //   partition depth are shared between subtrees
+      std::vector<OutofcoreNodeType*> subtree_roots (nr_buckets, nullptr);
+      for (size_t bucket = 0; bucket < nr_buckets; bucket++)
+      {
+        if (bucket_begin[bucket] == bucket_begin[bucket + 1])
+          continue;
+
+        OutofcoreNodeType* node = root_node_;
+        for (boost::uint64_t level = 0; level < partition_depth; level++)
+        {
+          node->loadUnloadedChildren ();
+
+          const size_t octant = (bucket >> (3 * (partition_depth - level - 1))) & 7;
+          if (!node->children_[octant])
+            node->createChild (octant);
+          node = node->children_[octant];
+        }
+        subtree_roots[bucket] = node;
+      }
+
+      //4. sort and build the subtrees concurrently
+      std::vector<boost::uint64_t> points_added (nr_buckets, 0);
+      runParallel (nr_buckets, nr_threads, [&] (const size_t bucket)
+      {
+        if (!subtree_roots[bucket])
+          return;
+
+        auto first = sorted_codes.begin () + bucket_begin[bucket];
+        auto last = sorted_codes.begin () + bucket_begin[bucket + 1];
+        std::sort (first, last);
+        points_added[bucket] = subtree_roots[bucket]->addSortedPointsToLeaf (input_cloud, first, last);
+      });
+
+      const boost::uint64_t pt_added = std::accumulate (points_added.begin (), points_added.end (), static_cast<boost::uint64_t> (0));
+      incrementPointsInLOD (depth, pt_added);
+
+      PCL_DEBUG ("[pcl::outofcore::OutofcoreOctreeBase::%s] Points added %lu, points in input cloud, %lu\n", __FUNCTION__, pt_added, nr_points);
+      return (pt_added);
+    }
+
     
     ////////////////////////////////////////////////////////////////////////////////
 
@@ -244,6 +441,8 @@ namespace pcl
     {
       // Lock the tree while writing
       std::unique_lock < std::shared_timed_mutex > lock (read_write_mutex_);
+      node_cache_.clear ();
+      search_index_cache_.clear ();
       boost::uint64_t pt_added = root_node_->addDataToLeaf_and_genLOD (point_cloud->points, false);
       return (pt_added);
     }
@@ -255,6 +454,8 @@ namespace pcl
     {
       // Lock the tree while writing
       std::unique_lock < std::shared_timed_mutex > lock (read_write_mutex_);
+      node_cache_.clear ();
+      search_index_cache_.clear ();
       boost::uint64_t pt_added = root_node_->addPointCloud_and_genLOD (input_cloud);
       
       PCL_DEBUG ("[pcl::outofcore::OutofcoreOctreeBase::%s] Points added %lu, points in input cloud, %lu\n",__FUNCTION__, pt_added, input_cloud->width*input_cloud->height );
@@ -271,6 +472,8 @@ namespace pcl
     {
       // Lock the tree while writing
       std::unique_lock < std::shared_timed_mutex > lock (read_write_mutex_);
+      node_cache_.clear ();
+      search_index_cache_.clear ();
       boost::uint64_t pt_added = root_node_->addDataToLeaf_and_genLOD (src, false);
       return (pt_added);
     }
@@ -342,6 +545,179 @@ namespace pcl
       root_node_->queryBBIncludes_subsample (min, max, query_depth, percent, dst);
     }
 
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> void
+    OutofcoreOctreeBase<ContainerT, PointT>::prefetchBBIncludes (const Eigen::Vector3d& min, const Eigen::Vector3d& max, const boost::uint64_t query_depth) const
+    {
+      std::future<void> task = std::async (std::launch::async, [this, min, max, query_depth] ()
+      {
+        std::shared_lock < std::shared_timed_mutex > lock (read_write_mutex_);
+
+        std::vector<BranchNode*> nodes;
+        root_node_->collectQueryNodes (min, max, query_depth, nodes);
+
+        using PayloadConstPtr = typename OutofcoreNodeCache<PointT>::PayloadConstPtr;
+        auto read = [] (BranchNode* node) { return (node->readCachedPayload ()); };
+        auto append = [] (const PayloadConstPtr&) {};
+        BranchNode::template readPayloadsAhead<PayloadConstPtr> (nodes, read, append);
+      });
+
+      std::lock_guard<std::mutex> lock (prefetch_mutex_);
+      prefetch_tasks_.remove_if ([] (const std::future<void>& done)
+      {
+        return (done.wait_for (std::chrono::seconds (0)) == std::future_status::ready);
+      });
+      prefetch_tasks_.push_back (std::move (task));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> int
+    OutofcoreOctreeBase<ContainerT, PointT>::nearestKSearch (const PointT &point, const int k, const boost::uint64_t query_depth, AlignedPointTVector &k_points, std::vector<float> &k_sqr_distances) const
+    {
+      k_points.clear ();
+      k_sqr_distances.clear ();
+      if (k <= 0 || !pcl::isFinite (point))
+        return (0);
+
+      std::shared_lock < std::shared_timed_mutex > lock (read_write_mutex_);
+
+      NodeNeighbors neighbors;
+      searchNeighbors (point, static_cast<size_t> (k), std::numeric_limits<float>::max (), query_depth, neighbors);
+
+      for (const NodeNeighbor &neighbor : neighbors)
+      {
+        k_points.push_back (neighbor.point);
+        k_sqr_distances.push_back (neighbor.sqr_distance);
+      }
+      return (static_cast<int> (k_points.size ()));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> int
+    OutofcoreOctreeBase<ContainerT, PointT>::radiusSearch (const PointT &point, const double radius, const boost::uint64_t query_depth, AlignedPointTVector &k_points, std::vector<float> &k_sqr_distances, const unsigned int max_nn) const
+    {
+      k_points.clear ();
+      k_sqr_distances.clear ();
+      if (radius < 0 || !pcl::isFinite (point))
+        return (0);
+
+      std::shared_lock < std::shared_timed_mutex > lock (read_write_mutex_);
+
+      NodeNeighbors neighbors;
+      searchNeighbors (point, max_nn, static_cast<float> (radius * radius), query_depth, neighbors);
+
+      for (const NodeNeighbor &neighbor : neighbors)
+      {
+        k_points.push_back (neighbor.point);
+        k_sqr_distances.push_back (neighbor.sqr_distance);
+      }
+      return (static_cast<int> (k_points.size ()));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> void
+    OutofcoreOctreeBase<ContainerT, PointT>::searchNeighbors (const PointT &point, const size_t k, const float max_sqr_distance, const boost::uint64_t query_depth, NodeNeighbors &neighbors) const
+    {
+      neighbors.clear ();
+      const Eigen::Vector3d query (point.x, point.y, point.z);
+
+      auto box_sqr_distance = [&query] (const BranchNode* node)
+      {
+        Eigen::Vector3d min, max;
+        node->getBoundingBox (min, max);
+        return ((min - query).cwiseMax (query - max).cwiseMax (0.0).squaredNorm ());
+      };
+
+      //with k set, neighbors is a max-heap whose front is the k-th closest point found so far
+      auto bound = [&neighbors, k, max_sqr_distance] ()
+      {
+        return ((k > 0 && neighbors.size () == k) ? neighbors.front ().sqr_distance : max_sqr_distance);
+      };
+
+      //visit the nodes closest first until the closest remaining one cannot improve the result
+      using Candidate = std::pair<double, BranchNode*>;
+      std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate> > candidates;
+      candidates.emplace (box_sqr_distance (root_node_), root_node_);
+
+      std::vector<int> indices;
+      std::vector<float> sqr_distances;
+      while (!candidates.empty () && candidates.top ().first <= bound ())
+      {
+        BranchNode* node = candidates.top ().second;
+        candidates.pop ();
+
+        if (node->depth_ < query_depth)
+        {
+          node->loadUnloadedChildren ();
+
+          for (BranchNode* child : node->children_)
+          {
+            if (child == nullptr)
+              continue;
+            const double child_sqr_distance = box_sqr_distance (child);
+            if (child_sqr_distance <= bound ())
+              candidates.emplace (child_sqr_distance, child);
+          }
+          continue;
+        }
+
+        if (node->payload_->size () == 0)
+          continue;
+
+        const auto index = readSearchIndex (node);
+        if (k > 0)
+          index->getOctree ().nearestKSearch (point, static_cast<int> (std::min (k, index->size ())), indices, sqr_distances);
+        else
+          index->getOctree ().radiusSearch (point, std::sqrt (static_cast<double> (max_sqr_distance)), indices, sqr_distances);
+
+        for (size_t i = 0; i < indices.size (); i++)
+        {
+          if (sqr_distances[i] > bound ())
+            continue;
+
+          const NodeNeighbor neighbor = {sqr_distances[i], node, indices[i], index->getCloud ().points[indices[i]]};
+          if (k == 0)
+          {
+            neighbors.push_back (neighbor);
+          }
+          else if (neighbors.size () < k)
+          {
+            neighbors.push_back (neighbor);
+            std::push_heap (neighbors.begin (), neighbors.end ());
+          }
+          else
+          {
+            std::pop_heap (neighbors.begin (), neighbors.end ());
+            neighbors.back () = neighbor;
+            std::push_heap (neighbors.begin (), neighbors.end ());
+          }
+        }
+      }
+
+      std::sort (neighbors.begin (), neighbors.end ());
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> typename OutofcoreNodeCache<PointT, OutofcoreNodeSearchIndex<PointT> >::PayloadConstPtr
+    OutofcoreOctreeBase<ContainerT, PointT>::readSearchIndex (BranchNode* node) const
+    {
+      auto build = [node] ()
+      {
+        const typename OutofcoreNodeCache<PointT>::PayloadConstPtr points = node->readCachedPayload ();
+
+        Eigen::Vector3d min, max;
+        node->getBoundingBox (min, max);
+        return (boost::shared_ptr<OutofcoreNodeSearchIndex<PointT> > (new OutofcoreNodeSearchIndex<PointT> (*points, (max - min).maxCoeff ())));
+      };
+
+      return (search_index_cache_.get (node->node_metadata_->getPCDFilename ().string (), node->depth_, node->payload_->size (), build));
+    }
+
     ////////////////////////////////////////////////////////////////////////////////
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBase<ContainerT, PointT>::queryBoundingBox (const Eigen::Vector3d &min, const Eigen::Vector3d &max, const int query_depth, const pcl::PCLPointCloud2::Ptr &dst_blob, double percent)
@@ -566,6 +942,8 @@ namespace pcl
       }
 
       std::unique_lock < std::shared_timed_mutex > lock (read_write_mutex_);
+      node_cache_.clear ();
+      search_index_cache_.clear ();
 
       const int number_of_nodes = 1;
 
@@ -577,6 +955,113 @@ namespace pcl
 
     ////////////////////////////////////////////////////////////////////////////////
 
+    template<typename ContainerT, typename PointT> void
+    OutofcoreOctreeBase<ContainerT, PointT>::buildLOD_parallel (unsigned int nr_threads)
+    {
+      if (root_node_== nullptr)
+      {
+        PCL_ERROR ("Root node is null; aborting buildLOD_parallel.\n");
+        return;
+      }
+
+      if (nr_threads == 0)
+        nr_threads = std::max (1u, std::thread::hardware_concurrency ());
+
+      std::unique_lock < std::shared_timed_mutex > lock (read_write_mutex_);
+      node_cache_.clear ();
+      search_index_cache_.clear ();
+
+      const boost::uint64_t depth = this->getDepth ();
+
+      //gather the nodes of every depth
+      std::vector<std::vector<BranchNode*> > levels (depth + 1);
+      levels[0].push_back (root_node_);
+      for (boost::uint64_t level = 0; level < depth; level++)
+      {
+        for (BranchNode* node : levels[level])
+        {
+          node->loadUnloadedChildren ();
+
+          for (size_t i = 0; i < 8; i++)
+          {
+            if (node->getChildPtr (i) != nullptr)
+              levels[level + 1].push_back (node->getChildPtr (i));
+          }
+        }
+      }
+
+      //fill the branches from the deepest one up, so every level samples
+      //children that are complete; a branch at depth d keeps
+      //sample_percent_^(depth + 1 - d) of the leaf points below it, which is
+      //sample_percent_^2 of its children's points right above the leaves
+      //and sample_percent_ higher up
+      for (boost::uint64_t level = depth; level-- > 0;)
+      {
+        const double child_percent = (level + 1 == depth) ? (sample_percent_ * sample_percent_) : sample_percent_;
+        const std::vector<BranchNode*>& nodes = levels[level];
+        std::vector<boost::uint64_t> lod_points (nodes.size (), 0);
+
+        runParallel (nodes.size (), nr_threads, [&] (const size_t n)
+        {
+          BranchNode* node = nodes[n];
+
+          //clear this node in case we are updating the LOD
+          node->clearData ();
+
+          std::mt19937 rng;
+          {
+            std::lock_guard<std::mutex> rng_lock (BranchNode::rng_mutex_);
+            rng.seed (BranchNode::rng_ ());
+          }
+
+          pcl::PCLPointCloud2::Ptr lod_cloud (new pcl::PCLPointCloud2 ());
+          for (size_t i = 0; i < 8; i++)
+          {
+            BranchNode* child = node->getChildPtr (i);
+            pcl::PCLPointCloud2::Ptr child_cloud;
+            if (child == nullptr || !boost::filesystem::exists (child->getPCDFilename ()) || child->read (child_cloud) != 0)
+              continue;
+
+            const size_t child_size = child_cloud->width*child_cloud->height;
+            if (child_size == 0)
+              continue;
+
+            size_t sample_size = static_cast<size_t> (static_cast<double> (child_size) * child_percent);
+            if (sample_size == 0)
+              sample_size = 1;
+
+            //uniform sample without replacement: partial Fisher-Yates shuffle of the indices
+            std::vector<int> indices (child_size);
+            std::iota (indices.begin (), indices.end (), 0);
+            for (size_t k = 0; k < sample_size; k++)
+            {
+              std::uniform_int_distribution<size_t> pick (k, child_size - 1);
+              std::swap (indices[k], indices[pick (rng)]);
+            }
+            indices.resize (sample_size);
+            std::sort (indices.begin (), indices.end ());
+
+            pcl::PCLPointCloud2 child_sample;
+            pcl::copyPointCloud (*child_cloud, indices, child_sample);
+            if (lod_cloud->width*lod_cloud->height == 0)
+              *lod_cloud = child_sample;
+            else
+              pcl::concatenate (*lod_cloud, child_sample, *lod_cloud);
+          }
+
+          if (lod_cloud->width*lod_cloud->height > 0)
+          {
+            node->payload_->insertRange (lod_cloud);
+            lod_points[n] = lod_cloud->width*lod_cloud->height;
+          }
+        });
+
+        this->incrementPointsInLOD (level, std::accumulate (lod_points.begin (), lod_points.end (), static_cast<boost::uint64_t> (0)));
+      }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBase<ContainerT, PointT>::printBoundingBox (OutofcoreOctreeBaseNode<ContainerT, PointT>& node) const
     {
@@ -680,6 +1165,47 @@ namespace pcl
     }
     ////////////////////////////////////////////////////////////////////////////////
 
+    template<typename ContainerT, typename PointT>
+    template<typename TaskT> void
+    OutofcoreOctreeBase<ContainerT, PointT>::runParallel (const size_t count, const unsigned int nr_threads, TaskT task)
+    {
+      std::atomic<size_t> next (0);
+      std::exception_ptr error;
+      std::mutex error_mutex;
+
+      auto worker = [&] ()
+      {
+        for (size_t i = next++; i < count; i = next++)
+        {
+          try
+          {
+            task (i);
+          }
+          catch (...)
+          {
+            std::lock_guard<std::mutex> lock (error_mutex);
+            if (!error)
+              error = std::current_exception ();
+            next = count;
+          }
+        }
+      };
+
+      std::vector<std::thread> threads;
+      const size_t nr_workers = std::min<size_t> (std::max (1u, nr_threads), count);
+      for (size_t t = 1; t < nr_workers; t++)
+        threads.emplace_back (worker);
+      worker ();
+
+      for (std::thread &thread : threads)
+        thread.join ();
+
+      if (error)
+        std::rethrow_exception (error);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBase<ContainerT, PointT>::incrementPointsInLOD (boost::uint64_t depth, boost::uint64_t new_point_count)
     {
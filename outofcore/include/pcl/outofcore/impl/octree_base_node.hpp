@@ -42,7 +42,11 @@
 #define PCL_OUTOFCORE_OCTREE_BASE_NODE_IMPL_H_
 
 // C++
+#include <algorithm>
+#include <deque>
+#include <future>
 #include <iostream>
+#include <iterator>
 #include <fstream>
 #include <random>
 #include <sstream>
@@ -81,9 +85,15 @@ namespace pcl
     template<typename ContainerT, typename PointT>
     std::mt19937 OutofcoreOctreeBaseNode<ContainerT, PointT>::rng_;
 
+    template<typename ContainerT, typename PointT>
+    std::mutex OutofcoreOctreeBaseNode<ContainerT, PointT>::children_mutex_;
+
     template<typename ContainerT, typename PointT>
     const double OutofcoreOctreeBaseNode<ContainerT, PointT>::sample_percent_ = .125;
 
+    template<typename ContainerT, typename PointT>
+    const size_t OutofcoreOctreeBaseNode<ContainerT, PointT>::read_ahead_nodes_ = 4;
+
     template<typename ContainerT, typename PointT>
     const std::string OutofcoreOctreeBaseNode<ContainerT, PointT>::pcd_extension = ".pcd";
 
@@ -327,6 +337,17 @@ namespace pcl
     }
     ////////////////////////////////////////////////////////////////////////////////
 
+    template<typename ContainerT, typename PointT> bool
+    OutofcoreOctreeBaseNode<ContainerT, PointT>::loadUnloadedChildren ()
+    {
+      std::lock_guard<std::mutex> lock (children_mutex_);
+      if (!this->hasUnloadedChildren ())
+        return (false);
+      loadChildren (false);
+      return (true);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBaseNode<ContainerT, PointT>::recFreeChildren ()
     {
@@ -361,8 +382,7 @@ namespace pcl
       if (this->depth_ == this->root_node_->m_tree_->getDepth ())
         return (addDataAtMaxDepth( p, skip_bb_check));
 
-      if (hasUnloadedChildren ())
-        loadChildren (false);
+      loadUnloadedChildren ();
 
       std::vector < std::vector<const PointT*> > c;
       c.resize (8);
@@ -446,10 +466,7 @@ namespace pcl
         return (buff.size ());
       }
 
-      if (this->hasUnloadedChildren ())
-      {
-        loadChildren (false);
-      }
+      loadUnloadedChildren ();
 
       std::vector < std::vector<const PointT*> > c;
       c.resize (8);
@@ -506,8 +523,7 @@ namespace pcl
         return (addDataAtMaxDepth (input_cloud, true));
       
       if( num_children_ < 8 )
-        if(hasUnloadedChildren ())
-          loadChildren (false);
+        loadUnloadedChildren ();
 
       if( !skip_bb_check )
       {
@@ -663,6 +679,53 @@ namespace pcl
       return (0);
     }
 
+    ////////////////////////////////////////////////////////////////////////////////
+    template<typename ContainerT, typename PointT> boost::uint64_t
+    OutofcoreOctreeBaseNode<ContainerT, PointT>::addSortedPointsToLeaf (const pcl::PCLPointCloud2::Ptr &input_cloud,
+                                                                        std::vector<std::pair<boost::uint64_t, int> >::const_iterator begin,
+                                                                        std::vector<std::pair<boost::uint64_t, int> >::const_iterator end)
+    {
+      if (begin == end)
+        return (0);
+
+      const boost::uint64_t tree_depth = this->root_node_->m_tree_->getDepth ();
+
+      //all points of this leaf are copied and written at once
+      if (this->depth_ == tree_depth)
+      {
+        std::vector<int> indices;
+        indices.reserve (end - begin);
+        for (auto it = begin; it != end; ++it)
+          indices.push_back (it->second);
+
+        pcl::PCLPointCloud2::Ptr leaf_cloud (new pcl::PCLPointCloud2 ());
+        pcl::copyPointCloud (*input_cloud, indices, *leaf_cloud);
+        payload_->insertRange (leaf_cloud);
+
+        return (indices.size ());
+      }
+
+      loadUnloadedChildren ();
+
+      //the octant of this node's children is the next 3 bits of the code
+      const boost::uint64_t shift = 3 * (tree_depth - this->depth_ - 1);
+      auto octantOf = [shift] (const std::pair<boost::uint64_t, int>& entry) { return (static_cast<size_t> ((entry.first >> shift) & 7)); };
+
+      boost::uint64_t points_added = 0;
+      while (begin != end)
+      {
+        const size_t octant = octantOf (*begin);
+        auto child_end = std::partition_point (begin, end, [&octantOf, octant] (const std::pair<boost::uint64_t, int>& entry) { return (octantOf (entry) == octant); });
+
+        if (!children_[octant])
+          createChild (octant);
+
+        points_added += children_[octant]->addSortedPointsToLeaf (input_cloud, begin, child_end);
+        begin = child_end;
+      }
+      return (points_added);
+    }
+
 
     ////////////////////////////////////////////////////////////////////////////////
     template<typename ContainerT, typename PointT> void
@@ -716,10 +779,7 @@ namespace pcl
       
       if (num_children_ < 8 )
       {
-        if ( hasUnloadedChildren () )
-        {
-          loadChildren (false);
-        }
+        loadUnloadedChildren ();
       }
 
       //------------------------------------------------------------
@@ -815,8 +875,7 @@ namespace pcl
       }
       
       // Create child nodes of the current node but not grand children+
-      if (this->hasUnloadedChildren ())
-        loadChildren (false /*no recursive loading*/);
+      loadUnloadedChildren ();
 
       // Randomly sample data
       AlignedPointTVector insertBuff;
@@ -1167,10 +1226,7 @@ namespace pcl
         file_names.push_back (this->node_metadata_->getMetadataFilename ().string ());
       }
 
-      if (hasUnloadedChildren ())
-      {
-        loadChildren (false);
-      }
+      loadUnloadedChildren ();
 
       if (this->getNumChildren () > 0)
       {
@@ -1291,10 +1347,7 @@ namespace pcl
       if (coverage <= 10000)
         return;
 
-      if (hasUnloadedChildren ())
-      {
-        loadChildren (false);
-      }
+      loadUnloadedChildren ();
 
       if (this->getNumChildren () > 0)
       {
@@ -1341,23 +1394,14 @@ namespace pcl
       {
         if (this->depth_ < query_depth)
         {
-          if (this->getNumChildren () > 0)
-          {
-            for (size_t i = 0; i < 8; i++)
-            {
-              if (children_[i])
-                children_[i]->queryBBIntersects (my_min, my_max, query_depth, file_names);
-            }
-          }
-          else if (hasUnloadedChildren ())
-          {
-            loadChildren (false);
+          //children_ is only written while holding children_mutex_, so it is
+          //safe to read once every child on disk has been loaded here
+          this->loadUnloadedChildren ();
 
-            for (size_t i = 0; i < 8; i++)
-            {
-              if (children_[i])
-                children_[i]->queryBBIntersects (my_min, my_max, query_depth, file_names);
-            }
+          for (size_t i = 0; i < 8; i++)
+          {
+            if (children_[i])
+              children_[i]->queryBBIntersects (my_min, my_max, query_depth, file_names);
           }
           return;
         }
@@ -1371,259 +1415,240 @@ namespace pcl
     ////////////////////////////////////////////////////////////////////////////////
 
     template<typename ContainerT, typename PointT> void
-    OutofcoreOctreeBaseNode<ContainerT, PointT>::queryBBIncludes (const Eigen::Vector3d& min_bb, const Eigen::Vector3d& max_bb, size_t query_depth, const pcl::PCLPointCloud2::Ptr& dst_blob)
+    OutofcoreOctreeBaseNode<ContainerT, PointT>::collectQueryNodes (const Eigen::Vector3d& min_bb, const Eigen::Vector3d& max_bb, boost::uint64_t query_depth, std::vector<OutofcoreOctreeBaseNode*>& nodes)
     {
-      uint64_t startingSize = dst_blob->width*dst_blob->height;
-      PCL_DEBUG ("[pcl::outofcore::OutofcoreOctreeBaseNode::%s] Starting points in destination blob: %ul\n", __FUNCTION__, startingSize );
-
-      // If the queried bounding box has any intersection with this node's bounding box
+      //if the queried bounding box has any intersection with this node's bounding box
       if (intersectsWithBoundingBox (min_bb, max_bb))
       {
-        // If we aren't at the max desired depth
+        //if we aren't at the max desired depth
         if (this->depth_ < query_depth)
         {
-          //if this node doesn't have any children, we are at the max depth for this query
-          if ((num_children_ == 0) && (hasUnloadedChildren ()))
-            loadChildren (false);
+          this->loadUnloadedChildren ();
 
-          //if this node has children
-          if (num_children_ > 0)
+          //recursively collect the children; a node without children above the query depth contributes no points
+          for (size_t i = 0; i < 8; i++)
           {
-            //recursively store any points that fall into the queried bounding box into v and return
-            for (size_t i = 0; i < 8; i++)
-            {
-              if (children_[i])
-                children_[i]->queryBBIncludes (min_bb, max_bb, query_depth, dst_blob);
-            }
-            PCL_DEBUG ( "[pcl::outofcore::OutofcoreOctreeBaseNode::%s] Points in dst_blob: %ul\n", __FUNCTION__, dst_blob->width*dst_blob->height );
-            return;
+            if (children_[i])
+              children_[i]->collectQueryNodes (min_bb, max_bb, query_depth, nodes);
           }
+          return;
         }
-        else //otherwise if we are at the max depth
-        {
-          //get all the points from the payload and return (easy with PCLPointCloud2)
-          pcl::PCLPointCloud2::Ptr tmp_blob (new pcl::PCLPointCloud2 ());
-          pcl::PCLPointCloud2::Ptr tmp_dst_blob (new pcl::PCLPointCloud2 ());
-          //load all the data in this node from disk
-          payload_->readRange (0, payload_->size (), tmp_blob);
 
-          if( tmp_blob->width*tmp_blob->height == 0 )
-            return;
+        nodes.push_back (this);
+      }
+    }
 
-          //if this node's bounding box falls completely within the queried bounding box, keep all the points
-          if (inBoundingBox (min_bb, max_bb))
-          {
-            //concatenate all of what was just read into the main dst_blob
-            //(is it safe to do in place?)
-            
-            //if there is already something in the destination blob (remember this method is recursive)
-            if( dst_blob->width*dst_blob->height != 0 )
-            {
-              PCL_DEBUG ("[pcl::outofocre::OutofcoreOctreeBaseNode::%s] Size of cloud before: %lu\n", __FUNCTION__, dst_blob->width*dst_blob->height );
-              PCL_DEBUG ("[pcl::outofcore::OutofcoreOctreeBaseNode::%s] Concatenating point cloud\n", __FUNCTION__);
-              int res = pcl::concatenate (*dst_blob, *tmp_blob, *dst_blob);
-              (void)res;
-              assert (res == 1);
+    ////////////////////////////////////////////////////////////////////////////////
 
-              PCL_DEBUG ("[pcl::outofocre::OutofcoreOctreeBaseNode::%s] Size of cloud after: %lu\n", __FUNCTION__, dst_blob->width*dst_blob->height );
-            }
-            //otherwise, just copy the tmp_blob into the dst_blob
-            else 
-            {
-              PCL_DEBUG ( "[pcl::outofcore::OutofcoreOctreeBaseNode] Copying point cloud into the destination blob\n");
-              pcl::copyPointCloud (*tmp_blob, *dst_blob);
-              assert (tmp_blob->width*tmp_blob->height == dst_blob->width*dst_blob->height);
-            }
-            PCL_DEBUG ( "[pcl::outofcore::OutofcoreOctreeBaseNode::%s] Points in dst_blob: %ul\n", __FUNCTION__, dst_blob->width*dst_blob->height );
-            return;
-          }
-          //otherwise queried bounding box only partially intersects this
-          //node's bounding box, so we have to check all the points in
-          //this box for intersection with queried bounding box
+    template<typename ContainerT, typename PointT>
+    template<typename ResultT, typename ReadFunctor, typename AppendFunctor> void
+    OutofcoreOctreeBaseNode<ContainerT, PointT>::readPayloadsAhead (const std::vector<OutofcoreOctreeBaseNode*>& nodes, ReadFunctor read, AppendFunctor append)
+    {
+      std::deque<std::future<ResultT> > pending;
+      size_t next = 0;
 
-//          PCL_DEBUG ("[pcl::outofcore::OutofcoreOctreeBaseNode::%s] Partial extraction of points in bounding box. Desired: %.2lf %.2lf %2lf, %.2lf %.2lf %.2lf; This node BB: %.2lf %.2lf %.2lf, %.2lf %.2lf %.2lf\n", __FUNCTION__, min_bb[0], min_bb[1], min_bb[2], max_bb[0], max_bb[1], max_bb[2], min_[0], min_[1], min_[2], max_[0], max_[1], max_[2] );
-          //put the ros message into a pointxyz point cloud (just to get the indices by using getPointsInBox)
-          typename pcl::PointCloud<PointT>::Ptr tmp_cloud ( new pcl::PointCloud<PointT> () );
-          pcl::fromPCLPointCloud2 ( *tmp_blob, *tmp_cloud );
-          assert (tmp_blob->width*tmp_blob->height == tmp_cloud->width*tmp_cloud->height );
+      for (size_t i = 0; i < nodes.size (); i++)
+      {
+        //keep the next read_ahead_nodes_ payloads loading while node i is appended
+        for (; (next < nodes.size ()) && (next <= i + read_ahead_nodes_); next++)
+        {
+          OutofcoreOctreeBaseNode* node = nodes[next];
+          pending.push_back (std::async (std::launch::async, [node, &read] () { return (read (node)); }));
+        }
 
-          Eigen::Vector4f min_pt ( static_cast<float> ( min_bb[0] ), static_cast<float> ( min_bb[1] ), static_cast<float> ( min_bb[2] ), 1.0f);
-          Eigen::Vector4f max_pt ( static_cast<float> ( max_bb[0] ), static_cast<float> ( max_bb[1] ) , static_cast<float>( max_bb[2] ), 1.0f );
+        ResultT result = pending.front ().get ();
+        pending.pop_front ();
+        append (result);
+      }
+    }
 
-          std::vector<int> indices;
+    ////////////////////////////////////////////////////////////////////////////////
 
-          pcl::getPointsInBox ( *tmp_cloud, min_pt, max_pt, indices );
-          PCL_DEBUG ( "[pcl::outofcore::OutofcoreOctreeBaseNode::%s] Points in box: %d\n", __FUNCTION__, indices.size () );
-          PCL_DEBUG ( "[pcl::outofcore::OutofcoreOctreeBaseNode::%s] Points remaining: %d\n", __FUNCTION__, tmp_cloud->width*tmp_cloud->height - indices.size () );
+    template<typename ContainerT, typename PointT> typename OutofcoreNodeCache<PointT>::PayloadConstPtr
+    OutofcoreOctreeBaseNode<ContainerT, PointT>::readCachedPayload ()
+    {
+      using PayloadConstPtr = typename OutofcoreNodeCache<PointT>::PayloadConstPtr;
 
-            if ( !indices.empty () )
-          {
-            if( dst_blob->width*dst_blob->height > 0 )
-            {
-              //need a new tmp destination with extracted points within BB
-              pcl::PCLPointCloud2::Ptr tmp_blob_within_bb (new pcl::PCLPointCloud2 ());
-
-              //copy just the points marked in indices
-              pcl::copyPointCloud ( *tmp_blob, indices, *tmp_blob_within_bb );
-              assert ( tmp_blob_within_bb->width*tmp_blob_within_bb->height == indices.size () );
-              assert ( tmp_blob->fields.size () == tmp_blob_within_bb->fields.size () );
-              //concatenate those points into the returned dst_blob
-              PCL_DEBUG ("[pcl::outofcore::OutofcoreOctreeBaseNode::%s] Concatenating point cloud in place\n", __FUNCTION__);
-              boost::uint64_t orig_points_in_destination = dst_blob->width*dst_blob->height;
-              (void)orig_points_in_destination;
-              int res = pcl::concatenate (*dst_blob, *tmp_blob_within_bb, *dst_blob);
-              (void)res;
-              assert (res == 1);
-              assert (dst_blob->width*dst_blob->height == indices.size () + orig_points_in_destination);
+      const boost::uint64_t nr_points = payload_->size ();
+      auto load = [this, nr_points] ()
+      {
+        AlignedPointTVector points;
+        if (nr_points > 0)
+          payload_->readRange (0, nr_points, points);
+        return (points);
+      };
 
-            }
-            else
-            {
-              pcl::copyPointCloud ( *tmp_blob, indices, *dst_blob );
-              assert ( dst_blob->width*dst_blob->height == indices.size () );
-            }
-          }
-        }
-      }
+      //empty nodes and nodes outside of a tree are not worth an entry
+      OutofcoreOctreeBase<ContainerT, PointT>* tree = root_node_->m_tree_;
+      if (nr_points == 0 || tree == nullptr)
+        return (PayloadConstPtr (new AlignedPointTVector (load ())));
 
-      PCL_DEBUG ("[pcl::outofcore::OutofcoreOctreeBaseNode::%s] Points added by function call: %ul\n", __FUNCTION__, dst_blob->width*dst_blob->height - startingSize );
+      return (tree->node_cache_.get (node_metadata_->getPCDFilename ().string (), depth_, nr_points, load));
     }
+    ////////////////////////////////////////////////////////////////////////////////
 
     template<typename ContainerT, typename PointT> void
-    OutofcoreOctreeBaseNode<ContainerT, PointT>::queryBBIncludes (const Eigen::Vector3d& min_bb, const Eigen::Vector3d& max_bb, size_t query_depth, AlignedPointTVector& v)
+    OutofcoreOctreeBaseNode<ContainerT, PointT>::queryBBIncludes (const Eigen::Vector3d& min_bb, const Eigen::Vector3d& max_bb, size_t query_depth, const pcl::PCLPointCloud2::Ptr& dst_blob)
     {
+      uint64_t startingSize = dst_blob->width*dst_blob->height;
+      PCL_DEBUG ("[pcl::outofcore::OutofcoreOctreeBaseNode::%s] Starting points in destination blob: %ul\n", __FUNCTION__, startingSize );
 
-      //if the queried bounding box has any intersection with this node's bounding box
-      if (intersectsWithBoundingBox (min_bb, max_bb))
+      std::vector<OutofcoreOctreeBaseNode*> nodes;
+      collectQueryNodes (min_bb, max_bb, query_depth, nodes);
+
+      auto read = [&min_bb, &max_bb] (OutofcoreOctreeBaseNode* node)
       {
-        //if we aren't at the max desired depth
-        if (this->depth_ < query_depth)
+        //load all the data in this node from disk
+        pcl::PCLPointCloud2::Ptr tmp_blob (new pcl::PCLPointCloud2 ());
+        node->payload_->readRange (0, node->payload_->size (), tmp_blob);
+
+        //if this node's bounding box falls completely within the queried bounding box, keep all the points
+        if (tmp_blob->width*tmp_blob->height == 0 || node->inBoundingBox (min_bb, max_bb))
+          return (tmp_blob);
+
+        //otherwise queried bounding box only partially intersects this
+        //node's bounding box, so we have to check all the points in
+        //this box for intersection with queried bounding box
+
+        //put the ros message into a pointxyz point cloud (just to get the indices by using getPointsInBox)
+        typename pcl::PointCloud<PointT>::Ptr tmp_cloud ( new pcl::PointCloud<PointT> () );
+        pcl::fromPCLPointCloud2 ( *tmp_blob, *tmp_cloud );
+        assert (tmp_blob->width*tmp_blob->height == tmp_cloud->width*tmp_cloud->height );
+
+        Eigen::Vector4f min_pt ( static_cast<float> ( min_bb[0] ), static_cast<float> ( min_bb[1] ), static_cast<float> ( min_bb[2] ), 1.0f);
+        Eigen::Vector4f max_pt ( static_cast<float> ( max_bb[0] ), static_cast<float> ( max_bb[1] ) , static_cast<float>( max_bb[2] ), 1.0f );
+
+        std::vector<int> indices;
+        pcl::getPointsInBox ( *tmp_cloud, min_pt, max_pt, indices );
+
+        //copy just the points marked in indices
+        pcl::PCLPointCloud2::Ptr tmp_blob_within_bb (new pcl::PCLPointCloud2 ());
+        if ( !indices.empty () )
         {
-          //if this node doesn't have any children, we are at the max depth for this query
-          if (this->hasUnloadedChildren ())
-          {
-            this->loadChildren (false);
-          }
+          pcl::copyPointCloud ( *tmp_blob, indices, *tmp_blob_within_bb );
+          assert ( tmp_blob_within_bb->width*tmp_blob_within_bb->height == indices.size () );
+        }
+        return (tmp_blob_within_bb);
+      };
 
-          //if this node has children
-          if (getNumChildren () > 0)
-          {
-            if(hasUnloadedChildren ())
-              loadChildren (false);
+      auto append = [&dst_blob] (const pcl::PCLPointCloud2::Ptr& tmp_blob)
+      {
+        if (tmp_blob->width*tmp_blob->height == 0)
+          return;
 
-            //recursively store any points that fall into the queried bounding box into v and return
-            for (size_t i = 0; i < 8; i++)
-            {
-              if (children_[i])
-                children_[i]->queryBBIncludes (min_bb, max_bb, query_depth, v);
-            }
-            return;
-          }
+        //if there is already something in the destination blob, concatenate what was just read into it
+        if (dst_blob->width*dst_blob->height != 0)
+        {
+          boost::uint64_t orig_points_in_destination = dst_blob->width*dst_blob->height;
+          (void)orig_points_in_destination;
+          int res = pcl::concatenate (*dst_blob, *tmp_blob, *dst_blob);
+          (void)res;
+          assert (res == 1);
+          assert (dst_blob->width*dst_blob->height == tmp_blob->width*tmp_blob->height + orig_points_in_destination);
         }
-        //otherwise if we are at the max depth
+        //otherwise, just copy the tmp_blob into the dst_blob
         else
         {
-          //if this node's bounding box falls completely within the queried bounding box
-          if (inBoundingBox (min_bb, max_bb))
-          {
-            //get all the points from the payload and return
-            AlignedPointTVector payload_cache;
-            payload_->readRange (0, payload_->size (), payload_cache);
-            v.insert (v.end (), payload_cache.begin (), payload_cache.end ());
-            return;
-          }
-          //otherwise queried bounding box only partially intersects this
-          //node's bounding box, so we have to check all the points in
-          //this box for intersection with queried bounding box
-          //read _all_ the points in from the disk container
-          AlignedPointTVector payload_cache;
-          payload_->readRange (0, payload_->size (), payload_cache);
-
-          uint64_t len = payload_->size ();
-          //iterate through each of them
-          for (uint64_t i = 0; i < len; i++)
-          {
-            const PointT& p = payload_cache[i];
-            //if it falls within this bounding box
-            if (pointInBoundingBox (min_bb, max_bb, p))
-            {
-              //store it in the list
-              v.push_back (p);
-            }
-            else
-            {
-              PCL_DEBUG ("[pcl::outofcore::queryBBIncludes] Point %.2lf %.2lf %.2lf not in bounding box %.2lf %.2lf %.2lf", p.x, p.y, p.z, min_bb[0], min_bb[1], min_bb[2], max_bb[0], max_bb[1], max_bb[2]);
-            }
-          }
+          pcl::copyPointCloud (*tmp_blob, *dst_blob);
+          assert (tmp_blob->width*tmp_blob->height == dst_blob->width*dst_blob->height);
         }
-      }
+      };
+
+      readPayloadsAhead<pcl::PCLPointCloud2::Ptr> (nodes, read, append);
+
+      PCL_DEBUG ("[pcl::outofcore::OutofcoreOctreeBaseNode::%s] Points added by function call: %ul\n", __FUNCTION__, dst_blob->width*dst_blob->height - startingSize );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> void
+    OutofcoreOctreeBaseNode<ContainerT, PointT>::queryBBIncludes (const Eigen::Vector3d& min_bb, const Eigen::Vector3d& max_bb, size_t query_depth, AlignedPointTVector& v)
+    {
+      std::vector<OutofcoreOctreeBaseNode*> nodes;
+      collectQueryNodes (min_bb, max_bb, query_depth, nodes);
+
+      using PayloadConstPtr = typename OutofcoreNodeCache<PointT>::PayloadConstPtr;
+
+      auto read = [&min_bb, &max_bb] (OutofcoreOctreeBaseNode* node)
+      {
+        //get all the points from the payload
+        PayloadConstPtr payload_cache = node->readCachedPayload ();
+
+        //if the queried bounding box only partially intersects this node's
+        //bounding box, keep the points that fall within the queried one
+        if (!node->inBoundingBox (min_bb, max_bb))
+        {
+          AlignedPointTVector* inside = new AlignedPointTVector;
+          auto within = [&min_bb, &max_bb] (const PointT& p) { return (OutofcoreOctreeBaseNode::pointInBoundingBox (min_bb, max_bb, p)); };
+          std::copy_if (payload_cache->begin (), payload_cache->end (), std::back_inserter (*inside), within);
+          payload_cache.reset (inside);
+        }
+        return (payload_cache);
+      };
+
+      auto append = [&v] (const PayloadConstPtr& payload_cache)
+      {
+        v.insert (v.end (), payload_cache->begin (), payload_cache->end ());
+      };
+
+      readPayloadsAhead<PayloadConstPtr> (nodes, read, append);
     }
     
     ////////////////////////////////////////////////////////////////////////////////
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBaseNode<ContainerT, PointT>::queryBBIncludes_subsample (const Eigen::Vector3d& min_bb, const Eigen::Vector3d& max_bb, boost::uint64_t query_depth, const pcl::PCLPointCloud2::Ptr& dst_blob, double percent)
     {
-      if (intersectsWithBoundingBox (min_bb, max_bb))
-        {
-          if (this->depth_ < query_depth)
-          {
-            if (this->hasUnloadedChildren ())
-              this->loadChildren (false);
+      std::vector<OutofcoreOctreeBaseNode*> nodes;
+      collectQueryNodes (min_bb, max_bb, query_depth, nodes);
 
-            if (this->getNumChildren () > 0)
-            {
-              for (size_t i=0; i<8; i++)
-              {
-                //recursively traverse (depth first)
-                if (children_[i]!=nullptr)
-                  children_[i]->queryBBIncludes_subsample (min_bb, max_bb, query_depth, dst_blob, percent);
-              }
-              return;
-            }
-          }
-          //otherwise, at max depth --> read from disk, subsample, concatenate
-          else
-          {
-            
-            if (inBoundingBox (min_bb, max_bb))
-            {
-              pcl::PCLPointCloud2::Ptr tmp_blob;
-              this->payload_->read (tmp_blob);
-              uint64_t num_pts = tmp_blob->width*tmp_blob->height;
-                
-              double sample_points = static_cast<double>(num_pts) * percent;
-              if (num_pts > 0)
-              {
-                //always sample at least one point
-                sample_points = sample_points > 1 ? sample_points : 1;
-              }
-              else
-              {
-                return;
-              }
-              
-              
-              pcl::RandomSample<pcl::PCLPointCloud2> random_sampler;
-              random_sampler.setInputCloud (tmp_blob);
-              
-              pcl::PCLPointCloud2::Ptr downsampled_points (new pcl::PCLPointCloud2 ());
-              
-              //set sample size as percent * number of points read
-              random_sampler.setSample (static_cast<unsigned int> (sample_points));
+      auto read = [&min_bb, &max_bb, percent] (OutofcoreOctreeBaseNode* node)
+      {
+        pcl::PCLPointCloud2::Ptr downsampled_points (new pcl::PCLPointCloud2 ());
 
-              pcl::ExtractIndices<pcl::PCLPointCloud2> extractor;
-              extractor.setInputCloud (tmp_blob);
-              
-              pcl::IndicesPtr downsampled_cloud_indices (new std::vector<int> ());
-              random_sampler.filter (*downsampled_cloud_indices);
-              extractor.setIndices (downsampled_cloud_indices);
-              extractor.filter (*downsampled_points);
-              
-              //concatenate the result into the destination cloud
-              pcl::concatenate (*dst_blob, *downsampled_points, *dst_blob);
-            }
-          }
+        //only nodes falling completely within the queried bounding box are sampled
+        if (!node->inBoundingBox (min_bb, max_bb))
+          return (downsampled_points);
+
+        pcl::PCLPointCloud2::Ptr tmp_blob;
+        if (node->payload_->read (tmp_blob) != 0)
+          return (downsampled_points);
+        uint64_t num_pts = tmp_blob->width*tmp_blob->height;
+
+        double sample_points = static_cast<double>(num_pts) * percent;
+        if (num_pts > 0)
+        {
+          //always sample at least one point
+          sample_points = sample_points > 1 ? sample_points : 1;
+        }
+        else
+        {
+          return (downsampled_points);
         }
+
+        pcl::RandomSample<pcl::PCLPointCloud2> random_sampler;
+        random_sampler.setInputCloud (tmp_blob);
+
+        //set sample size as percent * number of points read
+        random_sampler.setSample (static_cast<unsigned int> (sample_points));
+
+        pcl::ExtractIndices<pcl::PCLPointCloud2> extractor;
+        extractor.setInputCloud (tmp_blob);
+
+        pcl::IndicesPtr downsampled_cloud_indices (new std::vector<int> ());
+        random_sampler.filter (*downsampled_cloud_indices);
+        extractor.setIndices (downsampled_cloud_indices);
+        extractor.filter (*downsampled_points);
+        return (downsampled_points);
+      };
+
+      auto append = [&dst_blob] (const pcl::PCLPointCloud2::Ptr& downsampled_points)
+      {
+        //concatenate the result into the destination cloud
+        if (downsampled_points->width*downsampled_points->height > 0)
+          pcl::concatenate (*dst_blob, *downsampled_points, *dst_blob);
+      };
+
+      readPayloadsAhead<pcl::PCLPointCloud2::Ptr> (nodes, read, append);
     }
     
     
@@ -1631,67 +1656,59 @@ namespace pcl
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBaseNode<ContainerT, PointT>::queryBBIncludes_subsample (const Eigen::Vector3d& min_bb, const Eigen::Vector3d& max_bb, boost::uint64_t query_depth, const double percent, AlignedPointTVector& dst)
     {
-      //check if the queried bounding box has any intersection with this node's bounding box
-      if (intersectsWithBoundingBox (min_bb, max_bb))
+      std::vector<OutofcoreOctreeBaseNode*> nodes;
+      collectQueryNodes (min_bb, max_bb, query_depth, nodes);
+
+      auto read = [&min_bb, &max_bb, percent] (OutofcoreOctreeBaseNode* node)
       {
-        //if we are not at the max depth for queried nodes
-        if (this->depth_ < query_depth)
-        {
-          //check if we don't have children
-          if ((num_children_ == 0) && (hasUnloadedChildren ()))
-          {
-            loadChildren (false);
-          }
-          //if we do have children
-          if (num_children_ > 0)
-          {
-            //recursively add their valid points within the queried bounding box to the list v
-            for (size_t i = 0; i < 8; i++)
-            {
-              if (children_[i])
-                children_[i]->queryBBIncludes_subsample (min_bb, max_bb, query_depth, percent, dst);
-            }
-            return;
-          }
-        }
-        //otherwise we are at the max depth, so we add all our points or some of our points
-        else
+        const typename OutofcoreNodeCache<PointT>::PayloadConstPtr points = node->readCachedPayload ();
+        std::mt19937 rng (std::random_device {} ());
+
+        //if this node's bounding box falls completely within the queried bounding box
+        //add a random sample of all the points, drawn like readRangeSubSample does
+        AlignedPointTVector payload_cache;
+        if (node->inBoundingBox (min_bb, max_bb))
         {
-          //if this node's bounding box falls completely within the queried bounding box
-          if (inBoundingBox (min_bb, max_bb))
+          const size_t numpick = static_cast<size_t> (percent * static_cast<double> (points->size ()));
+          if (numpick == 0)
           {
-            //add a random sample of all the points
-            AlignedPointTVector payload_cache;
-            payload_->readRangeSubSample (0, payload_->size (), percent, payload_cache);
-            dst.insert (dst.end (), payload_cache.begin (), payload_cache.end ());
-            return;
+            std::bernoulli_distribution coin (percent);
+            for (const PointT& p : *points)
+              if (coin (rng))
+                payload_cache.push_back (p);
+            return (payload_cache);
           }
-          //otherwise the queried bounding box only partially intersects with this node's bounding box
-          //brute force selection of all valid points
-          AlignedPointTVector payload_cache_within_region;
-          {
-            AlignedPointTVector payload_cache;
-            payload_->readRange (0, payload_->size (), payload_cache);
-            for (size_t i = 0; i < payload_->size (); i++)
-            {
-              const PointT& p = payload_cache[i];
-              if (pointInBoundingBox (min_bb, max_bb, p))
-              {
-                payload_cache_within_region.push_back (p);
-              }
-            }
-          }//force the payload cache to deconstruct here
 
-          //use STL random_shuffle and push back a random selection of the points onto our list
-          std::shuffle (payload_cache_within_region.begin (), payload_cache_within_region.end (), std::mt19937(std::random_device()()));
-          size_t numpick = static_cast<size_t> (percent * static_cast<double> (payload_cache_within_region.size ()));;
+          std::uniform_int_distribution<size_t> die (0, points->size () - 1);
+          std::vector<size_t> offsets (numpick);
+          for (size_t &offset : offsets)
+            offset = die (rng);
+          std::sort (offsets.begin (), offsets.end ());
 
-          for (size_t i = 0; i < numpick; i++)
-          {
-            dst.push_back (payload_cache_within_region[i]);
-          }
+          payload_cache.reserve (numpick);
+          for (const size_t &offset : offsets)
+            payload_cache.push_back ((*points)[offset]);
+          return (payload_cache);
         }
-      }
+
+        //otherwise the queried bounding box only partially intersects with this node's bounding box
+        //brute force selection of all valid points
+        auto within = [&min_bb, &max_bb] (const PointT& p) { return (OutofcoreOctreeBaseNode::pointInBoundingBox (min_bb, max_bb, p)); };
+        std::copy_if (points->begin (), points->end (), std::back_inserter (payload_cache), within);
+
+        //use STL random_shuffle and keep a random selection of the points
+        std::shuffle (payload_cache.begin (), payload_cache.end (), rng);
+        size_t numpick = static_cast<size_t> (percent * static_cast<double> (payload_cache.size ()));
+        payload_cache.resize (numpick);
+        return (payload_cache);
+      };
+
+      auto append = [&dst] (const AlignedPointTVector& payload_cache)
+      {
+        dst.insert (dst.end (), payload_cache.begin (), payload_cache.end ());
+      };
+
+      readPayloadsAhead<AlignedPointTVector> (nodes, read, append);
     }
     ////////////////////////////////////////////////////////////////////////////////
 
@@ -1751,9 +1768,9 @@ namespace pcl
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBaseNode<ContainerT, PointT>::copyAllCurrentAndChildPointsRec (std::list<PointT>& v)
     {
-      if ((num_children_ == 0) && (hasUnloadedChildren ()))
+      if (num_children_ == 0)
       {
-        loadChildren (false);
+        loadUnloadedChildren ();
       }
 
       for (size_t i = 0; i < num_children_; i++)
@@ -1774,9 +1791,9 @@ namespace pcl
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBaseNode<ContainerT, PointT>::copyAllCurrentAndChildPointsRec_sub (std::list<PointT>& v, const double percent)
     {
-      if ((num_children_ == 0) && (hasUnloadedChildren ()))
+      if (num_children_ == 0)
       {
-        loadChildren (false);
+        loadUnloadedChildren ();
       }
 
       for (size_t i = 0; i < 8; i++)
@@ -1946,10 +1963,7 @@ namespace pcl
       boost::filesystem::path xyzfile = node_metadata_->getDirectoryPathname () / fname;
       payload_->convertToXYZ (xyzfile);
 
-      if (hasUnloadedChildren ())
-      {
-        loadChildren (false);
-      }
+      loadUnloadedChildren ();
 
       for (size_t i = 0; i < 8; i++)
       {
@@ -1997,12 +2011,12 @@ namespace pcl
         if (!std::isfinite (local_pt.x) || !std::isfinite (local_pt.y) || !std::isfinite (local_pt.z))
           continue;
 
+        //points outside of the node are dropped rather than forced into the nearest octant
         if(!this->pointInBoundingBox (local_pt))
         {
-          PCL_ERROR ("pcl::outofcore::OutofcoreOctreeBaseNode::%s] Point %2.lf %.2lf %.2lf not in bounding box", __FUNCTION__, local_pt.x, local_pt.y, local_pt.z);
+          PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBaseNode::%s] Point %.2lf %.2lf %.2lf not in bounding box\n", __FUNCTION__, local_pt.x, local_pt.y, local_pt.z);
+          continue;
         }
-        
-        assert (this->pointInBoundingBox (local_pt) == true);
 
         //compute the box we are in
         size_t box = 0;
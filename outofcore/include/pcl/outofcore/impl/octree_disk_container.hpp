@@ -41,6 +41,7 @@
 #define PCL_OUTOFCORE_OCTREE_DISK_CONTAINER_IMPL_H_
 
 // C++
+#include <algorithm>
 #include <sstream>
 #include <cassert>
 #include <ctime>
@@ -193,6 +194,24 @@ namespace pcl
     }
     ////////////////////////////////////////////////////////////////////////////////
 
+    template<typename PointT> void
+    OutofcoreOctreeDiskContainer<PointT>::readFileBlock (AlignedPointTVector& points) const
+    {
+      points.clear ();
+
+      if (!boost::filesystem::exists (disk_storage_filename_))
+        return;
+
+      pcl::PointCloud<PointT> cloud;
+      pcl::PCDReader reader;
+      int res = reader.read (disk_storage_filename_, cloud);
+      (void)res;
+      assert (res == 0);
+
+      points.swap (cloud.points);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
     template<typename PointT> PointT
     OutofcoreOctreeDiskContainer<PointT>::operator[] (uint64_t idx) const
     {
@@ -248,16 +267,26 @@ namespace pcl
         PCL_THROW_EXCEPTION (PCLException, "[pcl::outofcore::OutofcoreOctreeDiskContainer] Outofcore Octree Exception: Read indices exceed range");
       }
 
-      pcl::PCDReader reader;
-      typename pcl::PointCloud<PointT>::Ptr cloud (new pcl::PointCloud<PointT> ());
-      
-      int res = reader.read (disk_storage_filename_, *cloud);
-      (void)res;
-      assert (res == 0);
-      
-      for (size_t i=0; i < cloud->points.size (); i++)
-        dst.push_back (cloud->points[i]);
-      
+      dst.reserve (dst.size () + count);
+
+      //copy the part of the range stored on disk
+      if (start < filelen_)
+      {
+        AlignedPointTVector file_points;
+        readFileBlock (file_points);
+
+        const uint64_t file_end = std::min<uint64_t> (start + count, file_points.size ());
+        if (start < file_end)
+          dst.insert (dst.end (), file_points.begin () + start, file_points.begin () + file_end);
+      }
+
+      //and the part still waiting in the write buffer
+      if ((start + count) > filelen_)
+      {
+        const uint64_t buff_start = (start > filelen_) ? (start - filelen_) : 0;
+        const uint64_t buff_end = start + count - filelen_;
+        dst.insert (dst.end (), writebuff_.begin () + buff_start, writebuff_.begin () + buff_end);
+      }
     }
     ////////////////////////////////////////////////////////////////////////////////
 
@@ -313,7 +342,7 @@ namespace pcl
 
       if (filecount > 0)
       {
-        //pregen and then sort the offsets to reduce the amount of seek
+        //pregen the offsets; they are generated in increasing order
         std::vector < uint64_t > offsets;
         {
           std::lock_guard<std::mutex> lock (rng_mutex_);
@@ -328,27 +357,16 @@ namespace pcl
             }
           }
         }
-        std::sort (offsets.begin (), offsets.end ());
 
-        FILE* f = fopen (disk_storage_filename_.c_str (), "rbe");
-        assert (f != NULL);
-        PointT p;
-        char* loc = reinterpret_cast<char*> (&p);
-        
-        uint64_t filesamp = offsets.size ();
-        for (uint64_t i = 0; i < filesamp; i++)
+        if (!offsets.empty ())
         {
-          int seekret = _fseeki64 (f, offsets[i] * static_cast<uint64_t> (sizeof(PointT)), SEEK_SET);
-          (void)seekret;
-          assert (seekret == 0);
-          size_t readlen = fread (loc, sizeof(PointT), 1, f);
-          (void)readlen;
-          assert (readlen == 1);
-
-          dst.push_back (p);
-        }
+          AlignedPointTVector file_points;
+          readFileBlock (file_points);
 
-        fclose (f);
+          dst.reserve (dst.size () + offsets.size ());
+          for (const uint64_t offset : offsets)
+            dst.push_back (file_points[offset]);
+        }
       }
     }
     ////////////////////////////////////////////////////////////////////////////////
@@ -413,7 +431,7 @@ namespace pcl
 
       if (filesamp > 0)
       {
-        //pregen and then sort the offsets to reduce the amount of seek
+        //pregen and then sort the offsets so the copy walks the block front to back
         std::vector < uint64_t > offsets;
         {
           std::lock_guard<std::mutex> lock (rng_mutex_);
@@ -429,24 +447,12 @@ namespace pcl
         }
         std::sort (offsets.begin (), offsets.end ());
 
-        FILE* f = fopen (disk_storage_filename_.c_str (), "rbe");
-        assert (f != NULL);
-        PointT p;
-        char* loc = reinterpret_cast<char*> (&p);
+        AlignedPointTVector file_points;
+        readFileBlock (file_points);
+
+        dst.reserve (dst.size () + filesamp);
         for (uint64_t i = 0; i < filesamp; i++)
-        {
-          int seekret = _fseeki64 (f, offsets[i] * static_cast<uint64_t> (sizeof(PointT)), SEEK_SET);
-          (void)seekret;
-          assert (seekret == 0);
-          size_t readlen = fread (loc, sizeof(PointT), 1, f);
-          (void)readlen;
-          assert (readlen == 1);
-
-          dst.push_back (p);
-        }
-        int res = fclose (f);
-        (void)res;
-        assert (res == 0);
+          dst.push_back (file_points[offsets[i]]);
       }
     }
     ////////////////////////////////////////////////////////////////////////////////
@@ -503,6 +509,10 @@ namespace pcl
       int res = writer.writeBinaryCompressed (disk_storage_filename_, *tmp_cloud);
       (void)res;
       assert (res == 0);
+
+      //the write cache is now part of the file
+      filelen_ = tmp_cloud->points.size ();
+      writebuff_.clear ();
     }
   
     ////////////////////////////////////////////////////////////////////////////////
@@ -534,7 +544,7 @@ namespace pcl
         assert (previous_num_pts == res_pts);
         
         writer.writeBinaryCompressed (disk_storage_filename_, *tmp_cloud);
-            
+        filelen_ = tmp_cloud->width*tmp_cloud->height;
       }
       else //otherwise create the point cloud which will be saved to the pcd file for the first time
       {
@@ -542,7 +552,8 @@ namespace pcl
         int res = writer.writeBinaryCompressed (disk_storage_filename_, *input_cloud);
         (void)res;
         assert (res == 0);
-      }            
+        filelen_ = input_cloud->width*input_cloud->height;
+      }
 
     }
 
@@ -665,6 +676,10 @@ namespace pcl
       int res = writer.writeBinaryCompressed (disk_storage_filename_, *tmp_cloud);
       (void)res;
       assert (res == 0);
+
+      //the write cache is now part of the file
+      filelen_ = tmp_cloud->points.size ();
+      writebuff_.clear ();
     }
     ////////////////////////////////////////////////////////////////////////////////
 
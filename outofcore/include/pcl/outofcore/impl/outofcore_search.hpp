@@ -0,0 +1,194 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Urban Robotics, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PCL_OUTOFCORE_SEARCH_IMPL_H_
+#define PCL_OUTOFCORE_SEARCH_IMPL_H_
+
+#include <pcl/outofcore/outofcore_search.h>
+#include <pcl/common/point_tests.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace pcl
+{
+  namespace outofcore
+  {
+
+    template<typename PointT, typename ContainerT>
+    OutofcoreSearch<PointT, ContainerT>::OutofcoreSearch (const OctreePtr &octree, const boost::uint64_t query_depth)
+      : pcl::search::Search<PointT> ("OutofcoreSearch", true)
+      , octree_ (octree)
+      , query_depth_ (query_depth)
+      , node_offsets_ ()
+      , nodes_ ()
+      , offsets_ ()
+      , nr_points_ (0)
+    {
+      updateIndices ();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename ContainerT> void
+    OutofcoreSearch<PointT, ContainerT>::updateIndices ()
+    {
+      std::shared_lock < std::shared_timed_mutex > lock (octree_->read_write_mutex_);
+
+      Eigen::Vector3d min, max;
+      octree_->root_node_->getBoundingBox (min, max);
+
+      std::vector<NodeT*> nodes;
+      octree_->root_node_->collectQueryNodes (min, max, query_depth_, nodes);
+
+      node_offsets_.clear ();
+      nodes_.clear ();
+      offsets_.clear ();
+      nr_points_ = 0;
+
+      for (NodeT* node : nodes)
+      {
+        const boost::uint64_t node_points = node->payload_->size ();
+        if (node_points == 0)
+          continue;
+
+        if (nr_points_ + node_points > static_cast<boost::uint64_t> (std::numeric_limits<int>::max ()))
+        {
+          PCL_ERROR ("[pcl::outofcore::OutofcoreSearch::%s] More points at depth %lu than int indices can address; searching the first %lu only\n", __FUNCTION__, query_depth_, nr_points_);
+          break;
+        }
+
+        node_offsets_[node] = static_cast<int> (nr_points_);
+        nodes_.push_back (node);
+        offsets_.push_back (static_cast<int> (nr_points_));
+        nr_points_ += node_points;
+      }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename ContainerT> int
+    OutofcoreSearch<PointT, ContainerT>::nearestKSearch (const PointT &point, int k, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+    {
+      k_indices.clear ();
+      k_sqr_distances.clear ();
+      if (k <= 0 || !pcl::isFinite (point))
+        return (0);
+
+      std::shared_lock < std::shared_timed_mutex > lock (octree_->read_write_mutex_);
+
+      typename OctreeT::NodeNeighbors neighbors;
+      octree_->searchNeighbors (point, static_cast<size_t> (k), std::numeric_limits<float>::max (), query_depth_, neighbors);
+      return (toIndices (neighbors, k_indices, k_sqr_distances));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename ContainerT> int
+    OutofcoreSearch<PointT, ContainerT>::radiusSearch (const PointT &point, double radius, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances, unsigned int max_nn) const
+    {
+      k_indices.clear ();
+      k_sqr_distances.clear ();
+      if (radius < 0 || !pcl::isFinite (point))
+        return (0);
+
+      std::shared_lock < std::shared_timed_mutex > lock (octree_->read_write_mutex_);
+
+      typename OctreeT::NodeNeighbors neighbors;
+      octree_->searchNeighbors (point, max_nn, static_cast<float> (radius * radius), query_depth_, neighbors);
+      return (toIndices (neighbors, k_indices, k_sqr_distances));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename ContainerT> void
+    OutofcoreSearch<PointT, ContainerT>::getPoints (const std::vector<int> &indices, PointCloud &cloud) const
+    {
+      std::shared_lock < std::shared_timed_mutex > lock (octree_->read_write_mutex_);
+
+      cloud.points.clear ();
+      cloud.points.reserve (indices.size ());
+
+      //consecutive indices usually fall in the same node, so keep its payload at hand
+      typename OutofcoreNodeCache<PointT>::PayloadConstPtr payload;
+      size_t current = nodes_.size ();
+      for (const int &index : indices)
+      {
+        if (index < 0 || static_cast<size_t> (index) >= nr_points_)
+        {
+          PCL_ERROR ("[pcl::outofcore::OutofcoreSearch::%s] Index %d out of range\n", __FUNCTION__, index);
+          continue;
+        }
+
+        const size_t node = std::upper_bound (offsets_.begin (), offsets_.end (), index) - offsets_.begin () - 1;
+        if (node != current)
+        {
+          payload = nodes_[node]->readCachedPayload ();
+          current = node;
+        }
+        cloud.points.push_back ((*payload)[index - offsets_[node]]);
+      }
+
+      cloud.width = static_cast<uint32_t> (cloud.points.size ());
+      cloud.height = 1;
+      cloud.is_dense = false;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT, typename ContainerT> int
+    OutofcoreSearch<PointT, ContainerT>::toIndices (const typename OctreeT::NodeNeighbors &neighbors, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+    {
+      k_indices.reserve (neighbors.size ());
+      k_sqr_distances.reserve (neighbors.size ());
+
+      for (const auto &neighbor : neighbors)
+      {
+        //nodes created after the last updateIndices have no indices yet
+        auto offset = node_offsets_.find (neighbor.node);
+        if (offset == node_offsets_.end ())
+          continue;
+
+        k_indices.push_back (offset->second + neighbor.index);
+        k_sqr_distances.push_back (neighbor.sqr_distance);
+      }
+      return (static_cast<int> (k_indices.size ()));
+    }
+
+  }//namespace outofcore
+}//namespace pcl
+
+#endif //PCL_OUTOFCORE_SEARCH_IMPL_H_
@@ -0,0 +1,319 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Urban Robotics, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+// C++
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <pcl/outofcore/boost.h>
+#include <pcl/octree/octree_search.h>
+#include <pcl/point_cloud.h>
+#include <Eigen/StdVector>
+
+namespace pcl
+{
+  namespace outofcore
+  {
+    /** \class OutofcoreNodeCache
+     *  \brief Thread safe, byte budgeted LRU cache of node payloads.
+     *
+     *  Entries are keyed by the node's payload path and its LOD (the node
+     *  depth) and are spread over a fixed number of shards, each guarded by
+     *  its own mutex and holding an equal share of the byte budget. Payloads
+     *  are the node's points by default; any \c PayloadT providing size ()
+     *  (the number of points it was built from) and getByteSize () can be
+     *  cached instead, such as \ref OutofcoreNodeSearchIndex. Every
+     *  entry remembers the number of points the node held when it was read,
+     *  so a payload that has since grown or shrunk is re-read rather than
+     *  served stale. Concurrent requests for the same missing node share a
+     *  single read.
+     *
+     *  \ingroup outofcore
+     */
+    template<typename PointT, typename PayloadT = std::vector<PointT, Eigen::aligned_allocator<PointT> > >
+    class OutofcoreNodeCache
+    {
+      public:
+        using AlignedPointTVector = std::vector<PointT, Eigen::aligned_allocator<PointT> >;
+        using PayloadPtr = boost::shared_ptr<PayloadT>;
+        using PayloadConstPtr = boost::shared_ptr<const PayloadT>;
+
+        /** \brief Snapshot of the cache counters */
+        struct Stats
+        {
+          /** \brief Requests served without a new read, including those that waited on one in flight */
+          boost::uint64_t hits;
+          /** \brief Requests that had to read the payload */
+          boost::uint64_t misses;
+          /** \brief Entries dropped to stay within the byte budget */
+          boost::uint64_t evictions;
+          /** \brief Bytes currently held */
+          boost::uint64_t bytes;
+          /** \brief Entries currently held */
+          boost::uint64_t entries;
+        };
+
+        /** \brief Creates an empty cache
+         * \param[in] budget_bytes Total number of payload bytes to keep; 0 disables caching
+         * \param[in] nr_shards Number of independently locked shards the budget is split over
+         */
+        OutofcoreNodeCache (const size_t budget_bytes = default_budget_, const size_t nr_shards = 8);
+
+        /** \brief Returns the payload of the node at \c path and \c lod, reading it with \c load on a miss
+         *
+         * \c load is called without any cache lock held and must return
+         * the payload, either by value or as a \ref PayloadPtr.
+         *
+         * \param[in] path Payload path of the node
+         * \param[in] lod Depth of the node in the tree
+         * \param[in] nr_points Number of points the node currently holds; entries of a different size are re-read
+         * \param[in] load Functor reading the payload from its container
+         */
+        template<typename LoadFunctor> PayloadConstPtr
+        get (const std::string &path, const boost::uint64_t lod, const boost::uint64_t nr_points, LoadFunctor load);
+
+        /** \brief Reads the payload in the background unless it is already cached or being read
+         *
+         * The returned future completes once the payload is in the cache.
+         * Like any future returned by std::async, destroying it waits for
+         * the read, so keep it for as long as the prefetch should run
+         * asynchronously.
+         */
+        template<typename LoadFunctor> std::future<void>
+        prefetch (const std::string &path, const boost::uint64_t lod, const boost::uint64_t nr_points, LoadFunctor load);
+
+        /** \brief Returns true if a payload of \c nr_points points is cached for \c path and \c lod */
+        bool
+        contains (const std::string &path, const boost::uint64_t lod, const boost::uint64_t nr_points) const;
+
+        /** \brief Drops the entry for \c path and \c lod, if any */
+        void
+        erase (const std::string &path, const boost::uint64_t lod);
+
+        /** \brief Drops all entries; the counters are kept */
+        void
+        clear ();
+
+        /** \brief Sets the total byte budget, evicting entries as needed; 0 disables caching */
+        void
+        setBudget (const size_t budget_bytes);
+
+        /** \brief Returns the total byte budget */
+        size_t
+        getBudget () const
+        {
+          return (budget_);
+        }
+
+        /** \brief Returns the current counters */
+        Stats
+        getStats () const;
+
+        /** \brief Zeroes the hit, miss and eviction counters */
+        void
+        resetStats ();
+
+        /** \brief Default budget of 128 MiB */
+        static const size_t default_budget_ = static_cast<size_t> (128) << 20;
+
+      private:
+        struct Key
+        {
+          std::string path;
+          boost::uint64_t lod;
+
+          bool
+          operator== (const Key &other) const
+          {
+            return (lod == other.lod && path == other.path);
+          }
+        };
+
+        struct KeyHash
+        {
+          size_t
+          operator() (const Key &key) const
+          {
+            return (std::hash<std::string> () (key.path) ^ (static_cast<size_t> (key.lod) * 0x9e3779b97f4a7c15ull));
+          }
+        };
+
+        using KeyList = std::list<Key>;
+
+        struct Entry
+        {
+          PayloadConstPtr payload;
+          boost::uint64_t nr_points;
+          size_t bytes;
+          typename KeyList::iterator lru_it;
+        };
+
+        struct Shard
+        {
+          mutable std::mutex mutex;
+          std::unordered_map<Key, Entry, KeyHash> entries;
+          std::unordered_map<Key, std::shared_future<PayloadConstPtr>, KeyHash> in_flight;
+          //most recently used at the front
+          KeyList lru;
+          size_t bytes = 0;
+        };
+
+        static PayloadConstPtr
+        makePayload (PayloadT &&payload)
+        {
+          return (PayloadConstPtr (new PayloadT (std::move (payload))));
+        }
+
+        static PayloadConstPtr
+        makePayload (const PayloadPtr &payload)
+        {
+          return (payload);
+        }
+
+        static size_t
+        payloadBytes (const AlignedPointTVector &points)
+        {
+          return (points.capacity () * sizeof (PointT));
+        }
+
+        template<typename IndexT> static size_t
+        payloadBytes (const IndexT &index)
+        {
+          return (index.getByteSize ());
+        }
+
+        Shard&
+        shardFor (const Key &key) const
+        {
+          return (*shards_[KeyHash () (key) % shards_.size ()]);
+        }
+
+        /** \brief Drops least recently used entries of \c shard until it holds at most \c limit bytes; caller holds the shard lock */
+        void
+        evict (Shard &shard, const size_t limit);
+
+        /** \brief Stores \c payload in \c shard if it fits its share of the budget; caller holds the shard lock */
+        void
+        insert (Shard &shard, const Key &key, const PayloadConstPtr &payload, const boost::uint64_t nr_points);
+
+        std::vector<std::unique_ptr<Shard> > shards_;
+        std::atomic<size_t> budget_;
+
+        std::atomic<boost::uint64_t> hits_;
+        std::atomic<boost::uint64_t> misses_;
+        std::atomic<boost::uint64_t> evictions_;
+    };
+
+    /** \class OutofcoreNodeSearchIndex
+     *  \brief In-memory search structure over the points of one node, kept in an \ref OutofcoreNodeCache
+     *
+     *  Point \c i of the index is point \c i of the node's payload. The
+     *  octree resolution is chosen from the node's side length so that
+     *  leaves hold about \ref points_per_leaf_ points.
+     *
+     *  \ingroup outofcore
+     */
+    template<typename PointT>
+    class OutofcoreNodeSearchIndex
+    {
+      public:
+        using AlignedPointTVector = std::vector<PointT, Eigen::aligned_allocator<PointT> >;
+        using PointCloud = pcl::PointCloud<PointT>;
+        using Octree = pcl::octree::OctreePointCloudSearch<PointT>;
+
+        /** \brief Builds the index over \c points of a node whose bounding box has sides of length \c side_length */
+        OutofcoreNodeSearchIndex (const AlignedPointTVector &points, const double side_length)
+          : cloud_ (new PointCloud)
+          , octree_ (side_length / std::max (1.0, std::cbrt (static_cast<double> (points.size ()) / points_per_leaf_)))
+        {
+          cloud_->points.assign (points.begin (), points.end ());
+          cloud_->width = static_cast<uint32_t> (points.size ());
+          cloud_->height = 1;
+          octree_.setInputCloud (cloud_);
+          octree_.addPointsFromInputCloud ();
+        }
+
+        /** \brief Returns the number of indexed points */
+        size_t
+        size () const
+        {
+          return (cloud_->points.size ());
+        }
+
+        /** \brief Returns an estimate of the memory held by the points and the octree */
+        size_t
+        getByteSize () const
+        {
+          return (cloud_->points.capacity () * sizeof (PointT) + size () * sizeof (int) +
+                  (octree_.getLeafCount () + octree_.getBranchCount ()) * branch_bytes_);
+        }
+
+        /** \brief Returns the indexed points */
+        const PointCloud&
+        getCloud () const
+        {
+          return (*cloud_);
+        }
+
+        /** \brief Returns the octree searching the indexed points */
+        const Octree&
+        getOctree () const
+        {
+          return (octree_);
+        }
+
+        /** \brief Average number of points per octree leaf the resolution aims for */
+        static constexpr double points_per_leaf_ = 8.0;
+
+      private:
+        /** \brief Approximate size of one octree node, including its leaf container */
+        static const size_t branch_bytes_ = 96;
+
+        typename PointCloud::Ptr cloud_;
+        Octree octree_;
+    };
+  }//namespace outofcore
+}//namespace pcl
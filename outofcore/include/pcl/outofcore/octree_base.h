@@ -46,6 +46,7 @@
 #include <pcl/outofcore/octree_base_node.h>
 #include <pcl/outofcore/octree_disk_container.h>
 #include <pcl/outofcore/octree_ram_container.h>
+#include <pcl/outofcore/node_cache.h>
 
 //outofcore iterators
 #include <pcl/outofcore/outofcore_iterator_base.h>
@@ -63,6 +64,8 @@
 
 #include <pcl/PCLPointCloud2.h>
 
+#include <future>
+#include <list>
 #include <shared_mutex>
 
 namespace pcl
@@ -146,11 +149,15 @@ namespace pcl
      *  \author Stephen Fox, Urban Robotics Code Sprint (foxstephend@gmail.com)
      *
      */
+    template<typename PointT, typename ContainerT>
+    class OutofcoreSearch;
+
     template<typename ContainerT = OutofcoreOctreeDiskContainer<pcl::PointXYZ>, typename PointT = pcl::PointXYZ>
     class OutofcoreOctreeBase
     {
       friend class OutofcoreOctreeBaseNode<ContainerT, PointT>;
       friend class pcl::outofcore::OutofcoreIteratorBase<PointT, ContainerT>;
+      friend class pcl::outofcore::OutofcoreSearch<PointT, ContainerT>;
 
       public:
 
@@ -262,6 +269,23 @@ namespace pcl
         boost::uint64_t
         addPointCloud (pcl::PCLPointCloud2::Ptr &input_cloud, const bool skip_bb_check = false);
 
+        /** \brief Copies the points of input_cloud into the leaf nodes of the out-of-core octree using several threads.
+         *
+         * Every point is assigned the octant path (Morton code) of its
+         * leaf. The points are bucketed on the prefix of that code into
+         * independent subtrees, which are sorted and built concurrently;
+         * every leaf receives its points from input_cloud in a single
+         * write. Besides input_cloud, 16 bytes per point are kept in
+         * memory. LODs are not generated; call \ref buildLOD_parallel once
+         * all clouds are inserted.
+         *
+         * \param[in] input_cloud The cloud of points to be inserted into the out-of-core octree; it must have x, y and z fields and the same fields as any other cloud in the tree.
+         * \param[in] nr_threads Number of threads to use; 0 uses the hardware concurrency.
+         * \return Number of points successfully copied from the point cloud to the octree; points with non-finite coordinates are dropped
+         */
+        boost::uint64_t
+        addPointCloud_parallel (pcl::PCLPointCloud2::Ptr &input_cloud, unsigned int nr_threads = 0);
+
         /** \brief Recursively add points to the tree. 
          *
          * Recursively add points to the tree. 1/8 of the remaining
@@ -358,6 +382,76 @@ namespace pcl
         void
         queryBBIncludes_subsample (const Eigen::Vector3d &min, const Eigen::Vector3d &max, uint64_t query_depth, const double percent, AlignedPointTVector &dst) const;
 
+        /** \brief Starts reading the nodes a later queryBBIncludes with the same arguments would read into the node cache, and returns immediately.
+         *
+         * \param[in] min The minimum corner of the bounding box to prefetch
+         * \param[in] max The maximum corner of the bounding box to prefetch
+         * \param[in] query_depth The depth from which point data will be taken
+         */
+        void
+        prefetchBBIncludes (const Eigen::Vector3d &min, const Eigen::Vector3d &max, const boost::uint64_t query_depth) const;
+
+        /** \brief Returns the cache of node payloads shared by the AlignedPointTVector queries */
+        OutofcoreNodeCache<PointT>&
+        getNodeCache () const
+        {
+          return (node_cache_);
+        }
+
+        /** \brief Sets the number of bytes of node payloads kept in memory between queries; 0 disables the node cache */
+        void
+        setNodeCacheBudget (const size_t budget_bytes)
+        {
+          node_cache_.setBudget (budget_bytes);
+        }
+
+        //--------------------------------------------------------------------------------
+        //Neighbor search
+        //--------------------------------------------------------------------------------
+
+        /** \brief Search for the k nearest neighbors of \c point among the points stored at \c query_depth.
+         *
+         * Nodes are visited closest first and only those that may still
+         * hold one of the k nearest points are read. Each visited node is
+         * searched through an in-memory index kept in the search index cache.
+         *
+         * \param[in] point The query point
+         * \param[in] k The number of neighbors to search for
+         * \param[in] query_depth The depth from which point data will be taken
+         * \param[out] k_points The neighbors, closest first
+         * \param[out] k_sqr_distances The squared distances to the neighbors
+         * \return The number of neighbors found
+         */
+        int
+        nearestKSearch (const PointT &point, const int k, const boost::uint64_t query_depth, AlignedPointTVector &k_points, std::vector<float> &k_sqr_distances) const;
+
+        /** \brief Search for all the points stored at \c query_depth within \c radius of \c point.
+         *
+         * \param[in] point The query point
+         * \param[in] radius The radius of the sphere bounding the neighbors
+         * \param[in] query_depth The depth from which point data will be taken
+         * \param[out] k_points The neighbors, closest first
+         * \param[out] k_sqr_distances The squared distances to the neighbors
+         * \param[in] max_nn If given, keeps only the \c max_nn closest neighbors
+         * \return The number of neighbors found
+         */
+        int
+        radiusSearch (const PointT &point, const double radius, const boost::uint64_t query_depth, AlignedPointTVector &k_points, std::vector<float> &k_sqr_distances, const unsigned int max_nn = 0) const;
+
+        /** \brief Returns the cache of per-node search indices used by the neighbor searches */
+        OutofcoreNodeCache<PointT, OutofcoreNodeSearchIndex<PointT> >&
+        getSearchIndexCache () const
+        {
+          return (search_index_cache_);
+        }
+
+        /** \brief Sets the number of bytes of per-node search indices kept in memory between searches; 0 disables the cache */
+        void
+        setSearchIndexCacheBudget (const size_t budget_bytes)
+        {
+          search_index_cache_.setBudget (budget_bytes);
+        }
+
         //--------------------------------------------------------------------------------
         //PCLPointCloud2 methods
         //--------------------------------------------------------------------------------
@@ -480,6 +574,20 @@ namespace pcl
         void
         buildLOD ();
 
+        /** \brief Generate the multi-resolution LODs bottom-up using several threads.
+         *
+         * The nodes of one depth are processed concurrently, from the
+         * deepest branches up to the root. Each branch stores a uniform
+         * random sample of its children's points, so the node at depth d
+         * holds the same fraction, sample_percent^(tree depth + 1 - d), of
+         * the leaf points below it as with \ref buildLOD. Every node is
+         * written once.
+         *
+         * \param[in] nr_threads Number of threads to use; 0 uses the hardware concurrency.
+         */
+        void
+        buildLOD_parallel (unsigned int nr_threads = 0);
+
         /** \brief Prints size of BBox to stdout
          */ 
         void
@@ -599,6 +707,42 @@ namespace pcl
         void
         buildLODRecursive (const std::vector<BranchNode*>& current_branch);
 
+        /** \brief Calls \c task for every index in [0, count) from \c nr_threads threads pulling indices from a shared counter.
+         *  The first exception thrown by a task is rethrown once all threads joined.
+         */
+        template<typename TaskT> static void
+        runParallel (const size_t count, const unsigned int nr_threads, TaskT task);
+
+        /** \brief A point found by a neighbor search: point \c index of the payload of \c node */
+        struct NodeNeighbor
+        {
+          float sqr_distance;
+          BranchNode* node;
+          int index;
+          PointT point;
+
+          bool
+          operator< (const NodeNeighbor &other) const
+          {
+            return (sqr_distance < other.sqr_distance);
+          }
+        };
+        using NodeNeighbors = std::vector<NodeNeighbor, Eigen::aligned_allocator<NodeNeighbor> >;
+
+        /** \brief Best-first search over the nodes at \c query_depth shared by the neighbor searches.
+         *
+         * Keeps the \c k closest points (all points if \c k is 0) within
+         * squared distance \c max_sqr_distance of \c point; the caller holds
+         * the shared lock.
+         * \param[out] neighbors The points found, closest first
+         */
+        void
+        searchNeighbors (const PointT &point, const size_t k, const float max_sqr_distance, const boost::uint64_t query_depth, NodeNeighbors &neighbors) const;
+
+        /** \brief Returns the search index over the payload of \c node, building it on a cache miss */
+        typename OutofcoreNodeCache<PointT, OutofcoreNodeSearchIndex<PointT> >::PayloadConstPtr
+        readSearchIndex (BranchNode* node) const;
+
         /** \brief Increment current depths (LOD for branch nodes) point count; called by addDataAtMaxDepth in OutofcoreOctreeBaseNode
          */
         inline void
@@ -636,6 +780,16 @@ namespace pcl
         /** \brief shared mutex for controlling read/write access to disk */
         mutable std::shared_timed_mutex read_write_mutex_;
 
+        /** \brief Node payloads read by queries; cleared by every write to the tree */
+        mutable OutofcoreNodeCache<PointT> node_cache_;
+
+        /** \brief Per-node search indices built by the neighbor searches; cleared by every write to the tree */
+        mutable OutofcoreNodeCache<PointT, OutofcoreNodeSearchIndex<PointT> > search_index_cache_;
+
+        /** \brief Prefetches still running, waited for on destruction */
+        mutable std::list<std::future<void> > prefetch_tasks_;
+        mutable std::mutex prefetch_mutex_;
+
         OutofcoreOctreeBaseMetadata::Ptr metadata_;
         
         /** \brief defined as ".octree" to append to treepath files
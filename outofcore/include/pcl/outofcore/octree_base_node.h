@@ -49,6 +49,7 @@
 #include <pcl/outofcore/boost.h>
 #include <pcl/outofcore/octree_base.h>
 #include <pcl/outofcore/octree_disk_container.h>
+#include <pcl/outofcore/node_cache.h>
 #include <pcl/outofcore/outofcore_node_data.h>
 
 #include <pcl/octree/octree_nodes.h>
@@ -64,6 +65,9 @@ namespace pcl
     template<typename ContainerT, typename PointT>
     class OutofcoreOctreeBase;
 
+    template<typename PointT, typename ContainerT>
+    class OutofcoreSearch;
+
     /** \brief Non-class function which creates a single child leaf; used with \ref queryBBIntersects_noload to avoid loading the data from disk */
     template<typename ContainerT, typename PointT> OutofcoreOctreeBaseNode<ContainerT, PointT>*
     makenode_norec (const boost::filesystem::path &path, OutofcoreOctreeBaseNode<ContainerT, PointT>* super);
@@ -95,6 +99,7 @@ namespace pcl
     class OutofcoreOctreeBaseNode : public pcl::octree::OctreeNode
     {
       friend class OutofcoreOctreeBase<ContainerT, PointT> ;
+      friend class OutofcoreSearch<PointT, ContainerT> ;
 
       //these methods can be rewritten with the iterators. 
       friend OutofcoreOctreeBaseNode<ContainerT, PointT>*
@@ -119,6 +124,8 @@ namespace pcl
         const static std::string node_index_extension;
         const static std::string node_container_extension;
         const static double sample_percent_;
+        /** \brief Number of node payloads the bounding box queries read in the background ahead of the node being appended */
+        const static size_t read_ahead_nodes_;
 
         /** \brief Empty constructor; sets pointers for children and for bounding boxes to 0
          */
@@ -400,6 +407,25 @@ namespace pcl
          */
         boost::uint64_t
         addDataAtMaxDepth (const pcl::PCLPointCloud2::Ptr input_cloud, const bool skip_bb_check = true);
+
+        /** \brief Add the points of \c input_cloud listed in [\c begin, \c end) to the leaves below this node.
+         *
+         *  The range holds (octant path code, point index) pairs sorted
+         *  by code, where the code concatenates the 3 bit child indices
+         *  from the root down to the max depth of the tree; every child
+         *  is thus handed a contiguous sub-range and every leaf gets its
+         *  points in one write. The LOD point count is not updated; this
+         *  is left to the caller so subtrees can be built concurrently.
+         *
+         *  \param[in] input_cloud the cloud the point indices refer to
+         *  \param[in] begin first (code, index) pair for this node
+         *  \param[in] end one past the last (code, index) pair for this node
+         *  \return number of points added
+         */
+        boost::uint64_t
+        addSortedPointsToLeaf (const pcl::PCLPointCloud2::Ptr &input_cloud,
+                               std::vector<std::pair<boost::uint64_t, int> >::const_iterator begin,
+                               std::vector<std::pair<boost::uint64_t, int> >::const_iterator end);
         
         /** \brief Tests whether the input bounding box intersects with the current node's bounding box 
          *  \param[in] min_bb The minimum corner of the input bounding box
@@ -447,6 +473,29 @@ namespace pcl
         inline bool
         pointInBoundingBox (const PointT &p) const;
 
+        /** \brief Collects, in depth first order, the nodes at \b query_depth whose
+         *  bounding box intersects the queried one, loading children from disk on the way down
+         *  \param[in] min_bb The minimum corner of the queried bounding box
+         *  \param[in] max_bb The maximum corner of the queried bounding box
+         *  \param[in] query_depth The depth of the nodes to collect
+         *  \param[out] nodes The nodes whose payloads answer the query
+         */
+        void
+        collectQueryNodes (const Eigen::Vector3d &min_bb, const Eigen::Vector3d &max_bb, boost::uint64_t query_depth, std::vector<OutofcoreOctreeBaseNode*> &nodes);
+
+        /** \brief Reads the payloads of \c nodes with up to \ref read_ahead_nodes_ reads
+         *  in flight, handing each result to \c append in the order of \c nodes
+         *  \param[in] nodes The nodes to read
+         *  \param[in] read Functor reading (and filtering) the payload of one node; called from worker threads
+         *  \param[in] append Functor consuming the result of \c read; called from the calling thread
+         */
+        template<typename ResultT, typename ReadFunctor, typename AppendFunctor> static void
+        readPayloadsAhead (const std::vector<OutofcoreOctreeBaseNode*> &nodes, ReadFunctor read, AppendFunctor append);
+
+        /** \brief Returns all points of this node, served from the tree's node cache when possible */
+        typename OutofcoreNodeCache<PointT>::PayloadConstPtr
+        readCachedPayload ();
+
         /** \brief Creates child node \c idx
          *  \param[in] idx Index (0-7) of the child node
          */
@@ -503,6 +552,13 @@ namespace pcl
         virtual void
         loadChildren (bool recursive);
 
+        /** \brief Load the children that are on disk but not in memory yet, holding children_mutex_. Every lazy
+         *  load goes through here, so concurrent queries never load the same children twice.
+         *  \return true if children were loaded
+         */
+        bool
+        loadUnloadedChildren ();
+
         /** \brief Gets a vector of occupied voxel centers
          * \param[out] voxel_centers
          * \param[in] query_depth
@@ -564,6 +620,9 @@ namespace pcl
          * pseudo-random number generator */
         static std::mt19937 rng_;
 
+        /** \brief Serializes loading children from disk (see loadUnloadedChildren), as queries only hold the tree's shared lock */
+        static std::mutex children_mutex_;
+
         /** \brief Extension for this class to find the pcd files on disk */
         const static std::string pcd_extension;
 
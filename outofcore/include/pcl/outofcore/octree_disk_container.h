@@ -40,6 +40,7 @@
 #pragma once
 
 // C++
+#include <fstream>
 #include <mutex>
 #include <vector>
 #include <string>
@@ -129,11 +130,13 @@ namespace pcl
 
         /** \brief Reads \b count points into memory from the disk container
          *
-         * Reads \b count points into memory from the disk container, reading at most 2 million elements at a time
+         * Reads \b count points into memory from the disk container. The
+         * file is read in one block; indices past the points on disk are
+         * served from the write buffer.
          *
          * \param[in] start index of first point to read from disk
          * \param[in] count offset of last point to read from disk
-         * \param[out] dst std::vector as destination for points read from disk into memory
+         * \param[out] dst std::vector as destination for points read from disk into memory; points are appended
          */
         void
         readRange (const uint64_t start, const uint64_t count, AlignedPointTVector &dst) override;
@@ -225,37 +228,16 @@ namespace pcl
         {
           if (boost::filesystem::exists (disk_storage_filename_))
           {
-            FILE* fxyz = fopen (path.string ().c_str (), "we");
-
-            FILE* f = fopen (disk_storage_filename_.c_str (), "rbe");
-            assert (f != NULL);
-
-            uint64_t num = size ();
-            PointT p;
-            char* loc = reinterpret_cast<char*> ( &p );
-
-            for (uint64_t i = 0; i < num; i++)
-            {
-              int seekret = _fseeki64 (f, i * sizeof (PointT), SEEK_SET);
-              (void)seekret;
-              assert (seekret == 0);
-              size_t readlen = fread (loc, sizeof (PointT), 1, f);
-              (void)readlen;
-              assert (readlen == 1);
-
-              //of << p.x << "\t" << p.y << "\t" << p.z << "\n";
-              std::stringstream ss;
-              ss << std::fixed;
-              ss.precision (16);
-              ss << p.x << "\t" << p.y << "\t" << p.z << "\n";
-
-              fwrite (ss.str ().c_str (), 1, ss.str ().size (), fxyz);
-            }
-            int res = fclose (f);
-            (void)res;
-            assert (res == 0);
-            res = fclose (fxyz);
-            assert (res == 0);
+            AlignedPointTVector points;
+            readFileBlock (points);
+            points.insert (points.end (), writebuff_.begin (), writebuff_.end ());
+
+            std::ofstream fxyz (path.string ().c_str ());
+            fxyz << std::fixed;
+            fxyz.precision (16);
+
+            for (const PointT &p : points)
+              fxyz << p.x << "\t" << p.y << "\t" << p.z << "\n";
           }
         }
 
@@ -281,6 +263,17 @@ namespace pcl
 
         void
         flushWritebuff (const bool force_cache_dealloc);
+
+        /** \brief Reads all points stored in the PCD file in a single block.
+         *
+         * The payload is stored binary compressed, so it is mapped and
+         * decompressed once by the PCD reader; range reads and subsampling
+         * then index into memory instead of seeking the file per point.
+         *
+         * \param[out] points the points stored on disk, not including \c writebuff_
+         */
+        void
+        readFileBlock (AlignedPointTVector &points) const;
     
         /** \brief Name of the storage file on disk (i.e., the PCD file) */
         std::string disk_storage_filename_;
@@ -48,3 +48,4 @@
 
 #include <pcl/outofcore/impl/octree_disk_container.hpp>
 #include <pcl/outofcore/impl/octree_ram_container.hpp>
+#include <pcl/outofcore/impl/node_cache.hpp>
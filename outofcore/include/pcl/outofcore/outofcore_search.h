@@ -0,0 +1,144 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Urban Robotics, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <pcl/outofcore/octree_base.h>
+#include <pcl/search/search.h>
+
+namespace pcl
+{
+  namespace outofcore
+  {
+    /** \class OutofcoreSearch
+     *  \brief Neighbor search over the points an \ref OutofcoreOctreeBase stores at one depth,
+     *  reading only the nodes a query needs.
+     *
+     *  The adapter numbers the points at \c query_depth node by node, in the
+     *  order queryBBIncludes returns them, and search results index into
+     *  that numbering. getPoints returns the points behind a set of
+     *  indices; a cloud holding all of them in this order, such as the
+     *  result of queryBBIncludes over the whole tree, can serve as the
+     *  search surface of a feature estimator. The input cloud of the
+     *  adapter only provides the query points of the index based searches.
+     *  Call updateIndices after the tree has been modified.
+     *
+     *  \ingroup outofcore
+     */
+    template<typename PointT = pcl::PointXYZ, typename ContainerT = OutofcoreOctreeDiskContainer<PointT> >
+    class OutofcoreSearch : public pcl::search::Search<PointT>
+    {
+      public:
+        using OctreeT = OutofcoreOctreeBase<ContainerT, PointT>;
+        using OctreePtr = boost::shared_ptr<OctreeT>;
+        using PointCloud = typename pcl::search::Search<PointT>::PointCloud;
+
+        using Ptr = boost::shared_ptr<OutofcoreSearch<PointT, ContainerT> >;
+        using ConstPtr = boost::shared_ptr<const OutofcoreSearch<PointT, ContainerT> >;
+
+        using pcl::search::Search<PointT>::nearestKSearch;
+        using pcl::search::Search<PointT>::radiusSearch;
+
+        /** \brief Creates the adapter and numbers the points of \c octree at \c query_depth
+         * \param[in] octree The tree to search
+         * \param[in] query_depth The depth from which point data will be taken
+         */
+        OutofcoreSearch (const OctreePtr &octree, const boost::uint64_t query_depth);
+
+        ~OutofcoreSearch ()
+        {
+        }
+
+        /** \brief Search for the k nearest neighbors of \c point
+         * \param[in] point The query point
+         * \param[in] k The number of neighbors to search for
+         * \param[out] k_indices The indices of the neighbors, closest first
+         * \param[out] k_sqr_distances The squared distances to the neighbors
+         * \return The number of neighbors found
+         */
+        int
+        nearestKSearch (const PointT &point, int k, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const override;
+
+        /** \brief Search for all the neighbors of \c point within \c radius
+         * \param[in] point The query point
+         * \param[in] radius The radius of the sphere bounding the neighbors
+         * \param[out] k_indices The indices of the neighbors, closest first
+         * \param[out] k_sqr_distances The squared distances to the neighbors
+         * \param[in] max_nn If given, bounds the number of returned neighbors to this value
+         * \return The number of neighbors found
+         */
+        int
+        radiusSearch (const PointT &point, double radius, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances, unsigned int max_nn = 0) const override;
+
+        /** \brief Renumbers the points at the query depth; call after adding points to the tree */
+        void
+        updateIndices ();
+
+        /** \brief Returns the number of points at the query depth */
+        size_t
+        size () const
+        {
+          return (nr_points_);
+        }
+
+        /** \brief Copies the points with the given indices into \c cloud, in the order of \c indices */
+        void
+        getPoints (const std::vector<int> &indices, PointCloud &cloud) const;
+
+      protected:
+        using NodeT = typename OctreeT::BranchNode;
+
+        /** \brief Converts the neighbors found in the tree to indices */
+        int
+        toIndices (const typename OctreeT::NodeNeighbors &neighbors, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const;
+
+        OctreePtr octree_;
+        boost::uint64_t query_depth_;
+
+        /** \brief Index of the first point of every node at the query depth */
+        std::unordered_map<const NodeT*, int> node_offsets_;
+        /** \brief The nodes at the query depth and their first indices, in increasing order */
+        std::vector<NodeT*> nodes_;
+        std::vector<int> offsets_;
+        size_t nr_points_;
+    };
+  }//namespace outofcore
+}//namespace pcl
+
+#include <pcl/outofcore/impl/outofcore_search.hpp>
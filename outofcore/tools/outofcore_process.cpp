@@ -95,7 +95,8 @@ getCloudFromFile (boost::filesystem::path pcd_path)
 
 int
 outofcoreProcess (std::vector<boost::filesystem::path> pcd_paths, boost::filesystem::path root_dir, 
-                  int depth, double resolution, int build_octree_with, bool gen_lod, bool overwrite, bool multiresolution)
+                  int depth, double resolution, int build_octree_with, bool gen_lod, bool overwrite, bool multiresolution,
+                  int threads)
 {
   // Bounding box min/max pts
   PointT min_pt, max_pt;
@@ -186,7 +187,11 @@ outofcoreProcess (std::vector<boost::filesystem::path> pcd_paths, boost::filesys
 
     boost::uint64_t pts = 0;
     
-    if (gen_lod && !multiresolution)
+    if (threads >= 0)
+    {
+      pts = outofcore_octree->addPointCloud_parallel (cloud, static_cast<unsigned int> (threads));
+    }
+    else if (gen_lod && !multiresolution)
     {
       print_info ("  Generating LODs\n");
       pts = outofcore_octree->addPointCloud_and_genLOD (cloud);
@@ -213,7 +218,14 @@ outofcoreProcess (std::vector<boost::filesystem::path> pcd_paths, boost::filesys
   print_info ("  Depth: %i\n", outofcore_octree->getDepth ());
   print_info ("  Resolution: [%f, %f]\n", x, y);
 
-  if(multiresolution)
+  if (threads >= 0 && gen_lod)
+  {
+    print_info ("Generating LOD with %d threads...\n", threads);
+    if (multiresolution)
+      outofcore_octree->setSamplePercent (0.25);
+    outofcore_octree->buildLOD_parallel (static_cast<unsigned int> (threads));
+  }
+  else if(multiresolution)
   {
     print_info ("Generating LOD...\n");
     outofcore_octree->setSamplePercent (0.25);
@@ -239,6 +251,7 @@ printHelp (int, char **argv)
   print_info ("\t -gen_lod                      \t Generate octree LODs\n");
   print_info ("\t -overwrite                    \t Overwrite existing octree\n");
   print_info ("\t -multiresolution              \t Generate multiresolutoin LOD\n");
+  print_info ("\t -threads <n>                  \t Build subtrees and LODs in parallel (0 = all cores)\n");
   print_info ("\t -h                            \t Display help\n");
   print_info ("\n");
 }
@@ -275,6 +288,7 @@ main (int argc, char* argv[])
   bool multiresolution = false;
   bool overwrite = false;
   int build_octree_with = OCTREE_DEPTH;
+  int threads = -1;
 
   // If both depth and resolution specified
   if (find_switch (argc, argv, "-depth") && find_switch (argc, argv, "-resolution"))
@@ -292,6 +306,7 @@ main (int argc, char* argv[])
   parse_argument (argc, argv, "-resolution", resolution);
   gen_lod = find_switch (argc, argv, "-gen_lod");
   overwrite = find_switch (argc, argv, "-overwrite");
+  parse_argument (argc, argv, "-threads", threads);
 
   if (gen_lod && find_switch (argc, argv, "-multiresolution"))
   {
@@ -329,5 +344,5 @@ main (int argc, char* argv[])
   if (root_dir.extension () == ".pcd")
     root_dir = root_dir.parent_path () / (root_dir.stem().string() + "_tree").c_str();
 
-  return outofcoreProcess (pcd_paths, root_dir, depth, resolution, build_octree_with, gen_lod, overwrite, multiresolution);
+  return outofcoreProcess (pcd_paths, root_dir, depth, resolution, build_octree_with, gen_lod, overwrite, multiresolution, threads);
 }
@@ -77,6 +77,7 @@ namespace pcl
       using IterativeClosestPoint<PointSource, PointTarget>::inlier_threshold_;
       using IterativeClosestPoint<PointSource, PointTarget>::min_number_correspondences_;
       using IterativeClosestPoint<PointSource, PointTarget>::update_visualizer_;
+      using IterativeClosestPoint<PointSource, PointTarget>::target_cache_entry_;
 
       using PointCloudSource = pcl::PointCloud<PointSource>;
       using PointCloudSourcePtr = typename PointCloudSource::Ptr;
@@ -95,6 +96,7 @@ namespace pcl
       
       using InputKdTree = typename Registration<PointSource, PointTarget>::KdTree;
       using InputKdTreePtr = typename Registration<PointSource, PointTarget>::KdTreePtr;
+      using TargetCachePtr = typename Registration<PointSource, PointTarget>::TargetCachePtr;
 
       using Ptr = boost::shared_ptr< GeneralizedIterativeClosestPoint<PointSource, PointTarget> >;
       using ConstPtr = boost::shared_ptr< const GeneralizedIterativeClosestPoint<PointSource, PointTarget> >;
@@ -167,6 +169,28 @@ namespace pcl
         target_covariances_.reset ();
       }
 
+      /** \brief Share the target search structures and covariances with other registration instances through a cache.
+        * Resets the target covariances, which are then taken from the cache entry.
+        * \param[in] cache the cache to use
+        */
+      inline void
+      setTargetCache (const TargetCachePtr &cache) override
+      {
+        pcl::IterativeClosestPoint<PointSource, PointTarget>::setTargetCache (cache);
+        target_covariances_.reset ();
+      }
+
+      /** \brief Set the version of the target cloud. Resets the target covariances, which have to be
+        * recomputed for a target modified in place.
+        * \param[in] version the version of the target cloud
+        */
+      inline void
+      setTargetVersion (std::uint64_t version) override
+      {
+        pcl::IterativeClosestPoint<PointSource, PointTarget>::setTargetVersion (version);
+        target_covariances_.reset ();
+      }
+
       /** \brief Provide a pointer to the covariances of the input target (if computed externally!). 
         * If not set, GeneralizedIterativeClosestPoint will compute the covariances itself.
         * Make sure to set the covariances AFTER setting the input source point cloud (setting the input source point cloud will reset the covariances).
@@ -80,6 +80,9 @@ namespace pcl
       using Ptr = boost::shared_ptr <FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scalar> >;
       using ConstPtr = boost::shared_ptr <const FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scalar> >;
 
+      using KdTree = pcl::search::KdTree<PointTarget>;
+      using KdTreePtr = typename KdTree::Ptr;
+
       using KdTreeReciprocal = pcl::search::KdTree<PointSource>;
       using KdTreeReciprocalPtr = typename KdTreeReciprocal::Ptr;
 
@@ -295,6 +298,7 @@ namespace pcl
       using Registration <PointSource, PointTarget, Scalar>::reg_name_;
       using Registration <PointSource, PointTarget, Scalar>::target_;
       using Registration <PointSource, PointTarget, Scalar>::tree_;
+      using Registration <PointSource, PointTarget, Scalar>::target_cache_entry_;
       using Registration <PointSource, PointTarget, Scalar>::correspondences_;
       using Registration <PointSource, PointTarget, Scalar>::target_cloud_updated_;
       using Registration <PointSource, PointTarget, Scalar>::final_transformation_;
@@ -352,10 +352,15 @@ pcl::GeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeTransfor
   // Set the mahalanobis matrices to identity
   mahalanobis_.resize (N, Eigen::Matrix3d::Identity ());
   // Compute target cloud covariance matrices
+  // Covariances of a cached target are computed once and shared with other instances
+  if (((!target_covariances_) || (target_covariances_->empty ())) && target_cache_entry_)
+    target_covariances_ = target_cache_entry_->getCovariances (k_correspondences_, gicp_epsilon_);
   if ((!target_covariances_) || (target_covariances_->empty ()))
   {
     target_covariances_.reset (new MatricesVector);  
     computeCovariances<PointTarget> (target_, tree_, *target_covariances_);
+    if (target_cache_entry_ && target_covariances_->size () == target_->size ())
+      target_covariances_ = target_cache_entry_->setCovariances (k_correspondences_, gicp_epsilon_, target_covariances_);
   }
   // Compute input cloud covariance matrices
   if ((!input_covariances_) || (input_covariances_->empty ()))
@@ -272,7 +272,21 @@ pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scal
     use_normals_ = true;
 
   // set up tree structures
-  if (target_cloud_updated_)
+  if (target_cache_entry_)
+  {
+    // The tree shared through a target cache covers the whole target and is never rebuilt; a subset
+    // of the target is searched in a tree of its own
+    const KdTreePtr shared_tree = target_cache_entry_->getSearchMethod ();
+    if (target_indices_->size () == target_->size ())
+      tree_ = shared_tree;
+    else if (target_cloud_updated_ || tree_ == shared_tree)
+    {
+      tree_.reset (new KdTree);
+      tree_->setInputCloud (target_, target_indices_);
+    }
+    target_cloud_updated_ = false;
+  }
+  else if (target_cloud_updated_)
   {
     tree_->setInputCloud (target_, target_indices_);
     target_cloud_updated_ = false;
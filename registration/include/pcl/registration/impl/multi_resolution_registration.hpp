@@ -0,0 +1,152 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2019-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PCL_REGISTRATION_IMPL_MULTI_RESOLUTION_REGISTRATION_HPP_
+#define PCL_REGISTRATION_IMPL_MULTI_RESOLUTION_REGISTRATION_HPP_
+
+#include <pcl/common/time.h>
+#include <pcl/common/transforms.h>
+#include <pcl/filters/voxel_grid.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename Scalar>
+pcl::registration::MultiResolutionRegistration<PointSource, PointTarget, Scalar>::MultiResolutionRegistration () :
+  final_transformation_ (Matrix4::Identity ()),
+  converged_ (false)
+{}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename Scalar>
+template <typename PointT> typename pcl::PointCloud<PointT>::ConstPtr
+pcl::registration::MultiResolutionRegistration<PointSource, PointTarget, Scalar>::downsample (
+    const typename pcl::PointCloud<PointT>::ConstPtr &cloud, float leaf_size)
+{
+  if (leaf_size <= 0.0f)
+    return (cloud);
+
+  typename pcl::PointCloud<PointT>::Ptr downsampled (new pcl::PointCloud<PointT>);
+  pcl::VoxelGrid<PointT> grid;
+  grid.setLeafSize (leaf_size, leaf_size, leaf_size);
+  grid.setInputCloud (cloud);
+  grid.filter (*downsampled);
+  return (downsampled);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename Scalar> bool
+pcl::registration::MultiResolutionRegistration<PointSource, PointTarget, Scalar>::align (
+    PointCloudSource &output, const Matrix4 &guess)
+{
+  converged_ = false;
+  level_results_.clear ();
+  final_transformation_ = guess;
+
+  if (!registration_)
+  {
+    PCL_ERROR ("[pcl::registration::MultiResolutionRegistration::align] No registration method given!\n");
+    return (false);
+  }
+  if (!input_ || !target_)
+  {
+    PCL_ERROR ("[pcl::registration::MultiResolutionRegistration::align] No input source or target dataset was given!\n");
+    return (false);
+  }
+  if (levels_.empty ())
+  {
+    PCL_ERROR ("[pcl::registration::MultiResolutionRegistration::align] No pyramid levels given!\n");
+    return (false);
+  }
+
+  source_pyramid_.resize (levels_.size ());
+  source_trees_.resize (levels_.size ());
+  target_pyramid_.resize (levels_.size ());
+  target_trees_.resize (levels_.size ());
+  level_results_.resize (levels_.size ());
+
+  PointCloudSource level_output;
+  for (size_t level = 0; level < levels_.size (); ++level)
+  {
+    const Level &parameters = levels_[level];
+    LevelResult &result = level_results_[level];
+    pcl::StopWatch timer;
+
+    // Pyramid levels and their search trees are only built once per input cloud
+    if (!target_pyramid_[level])
+    {
+      target_pyramid_[level] = downsample<PointTarget> (target_, parameters.leaf_size);
+      target_trees_[level].reset (new KdTree);
+      target_trees_[level]->setInputCloud (target_pyramid_[level]);
+    }
+    if (!source_pyramid_[level])
+    {
+      source_pyramid_[level] = downsample<PointSource> (input_, parameters.leaf_size);
+      source_trees_[level].reset (new KdTreeReciprocal);
+      source_trees_[level]->setInputCloud (source_pyramid_[level]);
+    }
+    result.source_size = source_pyramid_[level]->size ();
+    result.target_size = target_pyramid_[level]->size ();
+    result.setup_time = timer.getTime ();
+
+    // Hand the cached trees to the registration method, which must not rebuild them
+    registration_->setInputSource (source_pyramid_[level]);
+    registration_->setInputTarget (target_pyramid_[level]);
+    registration_->setSearchMethodTarget (target_trees_[level], true);
+    registration_->setSearchMethodSource (source_trees_[level], true);
+    registration_->setMaxCorrespondenceDistance (parameters.max_correspondence_distance);
+    registration_->setMaximumIterations (parameters.max_iterations);
+    registration_->setTransformationEpsilon (parameters.transformation_epsilon);
+    registration_->setEuclideanFitnessEpsilon (parameters.euclidean_fitness_epsilon);
+
+    timer.reset ();
+    registration_->align (level_output, final_transformation_);
+    result.registration_time = timer.getTime ();
+
+    // Every level starts from the best estimate so far, even if the previous level did not converge
+    result.converged = registration_->hasConverged ();
+    result.transformation = registration_->getFinalTransformation ();
+    final_transformation_ = result.transformation;
+
+    PCL_DEBUG ("[pcl::registration::MultiResolutionRegistration::align] Level %zu (%zu source / %zu target points): setup %g ms, registration %g ms, %s.\n",
+               level, result.source_size, result.target_size, result.setup_time, result.registration_time,
+               result.converged ? "converged" : "not converged");
+  }
+
+  converged_ = level_results_.back ().converged;
+  pcl::transformPointCloud (*input_, output, final_transformation_);
+  return (converged_);
+}
+
+#endif /*PCL_REGISTRATION_IMPL_MULTI_RESOLUTION_REGISTRATION_HPP_*/
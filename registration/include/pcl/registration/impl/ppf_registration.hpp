@@ -48,6 +48,11 @@
 #include <pcl/common/transforms.h>
 
 #include <pcl/features/pfh.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointSource, typename PointTarget> void
 pcl::PPFRegistration<PointSource, PointTarget>::setInputTarget (const PointCloudTargetConstPtr &cloud)
@@ -58,6 +63,20 @@ pcl::PPFRegistration<PointSource, PointTarget>::setInputTarget (const PointCloud
   scene_search_tree_->setInputCloud (target_);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget> void
+pcl::PPFRegistration<PointSource, PointTarget>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointSource, typename PointTarget> void
 pcl::PPFRegistration<PointSource, PointTarget>::computeTransformation (PointCloudSource &output, const Eigen::Matrix4f& guess)
@@ -73,109 +92,128 @@ pcl::PPFRegistration<PointSource, PointTarget>::computeTransformation (PointClou
     PCL_ERROR("[pcl::PPFRegistration::computeTransformation] setting initial transform (guess) not implemented!\n");
   }
 
-  PoseWithVotesList voted_poses;
-  std::vector <std::vector <unsigned int> > accumulator_array;
-  accumulator_array.resize (input_->points.size ());
-
-  size_t aux_size = static_cast<size_t> (std::floor (2 * M_PI / search_method_->getAngleDiscretizationStep ()));
-  for (size_t i = 0; i < input_->points.size (); ++i)
-  {
-    std::vector<unsigned int> aux (aux_size);
-    accumulator_array[i] = aux;
-  }
-  PCL_INFO ("Accumulator array size: %u x %u.\n", accumulator_array.size (), accumulator_array.back ().size ());
+  const size_t aux_size = static_cast<size_t> (std::floor (2 * M_PI / search_method_->getAngleDiscretizationStep ()));
+  const size_t accumulator_size = input_->points.size () * aux_size;
+  const float angle_offset = std::floor (static_cast<float> (M_PI) / search_method_->getAngleDiscretizationStep ());
+  PCL_INFO ("Accumulator array size: %u x %u.\n", input_->points.size (), aux_size);
 
   // Consider every <scene_reference_point_sampling_rate>-th point as the reference point => fix s_r
-  float f1, f2, f3, f4;
-  for (size_t scene_reference_index = 0; scene_reference_index < target_->points.size (); scene_reference_index += scene_reference_point_sampling_rate_)
-  {
-    Eigen::Vector3f scene_reference_point = target_->points[scene_reference_index].getVector3fMap (),
-        scene_reference_normal = target_->points[scene_reference_index].getNormalVector3fMap ();
+  const int nr_reference_points = static_cast<int> ((target_->points.size () + scene_reference_point_sampling_rate_ - 1) / scene_reference_point_sampling_rate_);
 
-    float rotation_angle_sg = std::acos (scene_reference_normal.dot (Eigen::Vector3f::UnitX ()));
-    bool parallel_to_x_sg = (scene_reference_normal.y() == 0.0f && scene_reference_normal.z() == 0.0f);
-    Eigen::Vector3f rotation_axis_sg = (parallel_to_x_sg)?(Eigen::Vector3f::UnitY ()):(scene_reference_normal.cross (Eigen::Vector3f::UnitX ()). normalized());
-    Eigen::AngleAxisf rotation_sg (rotation_angle_sg, rotation_axis_sg);
-    Eigen::Affine3f transform_sg (Eigen::Translation3f ( rotation_sg * ((-1) * scene_reference_point)) * rotation_sg);
+  // Every reference point votes into a private accumulator and fills its own slot of the voted poses
+  std::vector<Eigen::Affine3f, Eigen::aligned_allocator<Eigen::Affine3f> > reference_poses (nr_reference_points);
+  std::vector<unsigned int> reference_votes (nr_reference_points, 0);
 
-    // For every other point in the scene => now have pair (s_r, s_i) fixed
+#ifdef _OPENMP
+#pragma omp parallel num_threads (threads_)
+#endif
+  {
+    // Flat (model reference point x discretized alpha) accumulator, reset through the list of touched cells
+    std::vector<unsigned int> accumulator_array (accumulator_size, 0);
+    std::vector<size_t> touched_cells;
     std::vector<int> indices;
     std::vector<float> distances;
-    scene_search_tree_->radiusSearch (target_->points[scene_reference_index],
-                                     search_method_->getModelDiameter () /2,
-                                     indices,
-                                     distances);
-    for(const size_t &scene_point_index : indices)
-//    for(size_t i = 0; i < target_->points.size (); ++i)
+    float f1, f2, f3, f4;
+
+#ifdef _OPENMP
+#pragma omp for schedule (dynamic)
+#endif
+    for (int reference_i = 0; reference_i < nr_reference_points; ++reference_i)
     {
-      //size_t scene_point_index = i;
-      if (scene_reference_index != scene_point_index)
+      const size_t scene_reference_index = static_cast<size_t> (reference_i) * scene_reference_point_sampling_rate_;
+      Eigen::Vector3f scene_reference_point = target_->points[scene_reference_index].getVector3fMap (),
+          scene_reference_normal = target_->points[scene_reference_index].getNormalVector3fMap ();
+
+      float rotation_angle_sg = std::acos (scene_reference_normal.dot (Eigen::Vector3f::UnitX ()));
+      bool parallel_to_x_sg = (scene_reference_normal.y() == 0.0f && scene_reference_normal.z() == 0.0f);
+      Eigen::Vector3f rotation_axis_sg = (parallel_to_x_sg)?(Eigen::Vector3f::UnitY ()):(scene_reference_normal.cross (Eigen::Vector3f::UnitX ()). normalized());
+      Eigen::AngleAxisf rotation_sg (rotation_angle_sg, rotation_axis_sg);
+      Eigen::Affine3f transform_sg (Eigen::Translation3f ( rotation_sg * ((-1) * scene_reference_point)) * rotation_sg);
+
+      // For every other point in the scene => now have pair (s_r, s_i) fixed
+      scene_search_tree_->radiusSearch (target_->points[scene_reference_index],
+                                       search_method_->getModelDiameter () /2,
+                                       indices,
+                                       distances);
+      for (const int &scene_point_index : indices)
       {
-        if (/*pcl::computePPFPairFeature*/pcl::computePairFeatures (target_->points[scene_reference_index].getVector4fMap (),
-                                        target_->points[scene_reference_index].getNormalVector4fMap (),
-                                        target_->points[scene_point_index].getVector4fMap (),
-                                        target_->points[scene_point_index].getNormalVector4fMap (),
-                                        f1, f2, f3, f4))
+        if (scene_reference_index == static_cast<size_t> (scene_point_index))
+          continue;
+
+        if (!pcl::computePairFeatures (target_->points[scene_reference_index].getVector4fMap (),
+                                       target_->points[scene_reference_index].getNormalVector4fMap (),
+                                       target_->points[scene_point_index].getVector4fMap (),
+                                       target_->points[scene_point_index].getNormalVector4fMap (),
+                                       f1, f2, f3, f4))
         {
-          std::vector<std::pair<size_t, size_t> > nearest_indices;
-          search_method_->nearestNeighborSearch (f1, f2, f3, f4, nearest_indices);
+          PCL_ERROR ("[pcl::PPFRegistration::computeTransformation] Computing pair feature vector between points %u and %u went wrong.\n", scene_reference_index, scene_point_index);
+          continue;
+        }
+
+        const PPFHashMapSearch::IndexPairRange nearest_indices = search_method_->nearestNeighborRange (f1, f2, f3, f4);
+        if (nearest_indices.first == nearest_indices.second)
+          continue;
 
-          // Compute alpha_s angle
-          Eigen::Vector3f scene_point = target_->points[scene_point_index].getVector3fMap ();
+        // Compute alpha_s angle
+        Eigen::Vector3f scene_point = target_->points[scene_point_index].getVector3fMap ();
 
-          Eigen::Vector3f scene_point_transformed = transform_sg * scene_point;
-          float alpha_s = std::atan2 ( -scene_point_transformed(2), scene_point_transformed(1));
-          if (std::sin (alpha_s) * scene_point_transformed(2) < 0.0f)
-            alpha_s *= (-1);
+        Eigen::Vector3f scene_point_transformed = transform_sg * scene_point;
+        float alpha_s = std::atan2 ( -scene_point_transformed(2), scene_point_transformed(1));
+        if (std::sin (alpha_s) * scene_point_transformed(2) < 0.0f)
           alpha_s *= (-1);
+        alpha_s *= (-1);
 
-          // Go through point pairs in the model with the same discretized feature
-          for (const auto &nearest_index : nearest_indices)
-          {
-            size_t model_reference_index = nearest_index.first;
-            size_t model_point_index = nearest_index.second;
-            // Calculate angle alpha = alpha_m - alpha_s
-            float alpha = search_method_->alpha_m_[model_reference_index][model_point_index] - alpha_s;
-            unsigned int alpha_discretized = static_cast<unsigned int> (std::floor (alpha) + std::floor (M_PI / search_method_->getAngleDiscretizationStep ()));
-            accumulator_array[model_reference_index][alpha_discretized] ++;
-          }
+        // Go through point pairs in the model with the same discretized feature
+        for (const PPFHashMapSearch::IndexPair *nearest_index = nearest_indices.first; nearest_index != nearest_indices.second; ++nearest_index)
+        {
+          const size_t model_reference_index = nearest_index->first;
+          const size_t model_point_index = nearest_index->second;
+          // Calculate angle alpha = alpha_m - alpha_s
+          float alpha = search_method_->alpha_m_[model_reference_index][model_point_index] - alpha_s;
+          unsigned int alpha_discretized = static_cast<unsigned int> (std::floor (alpha) + angle_offset);
+          const size_t cell = model_reference_index * aux_size + alpha_discretized;
+          if (accumulator_array[cell]++ == 0)
+            touched_cells.push_back (cell);
         }
-        else PCL_ERROR ("[pcl::PPFRegistration::computeTransformation] Computing pair feature vector between points %u and %u went wrong.\n", scene_reference_index, scene_point_index);
       }
-    }
 
-    size_t max_votes_i = 0, max_votes_j = 0;
-    unsigned int max_votes = 0;
-
-    for (size_t i = 0; i < accumulator_array.size (); ++i)
-      for (size_t j = 0; j < accumulator_array.back ().size (); ++j)
+      // Find the strongest cell; ties go to the lowest cell, as in a full row-major scan
+      size_t max_votes_cell = 0;
+      unsigned int max_votes = 0;
+      for (const size_t &cell : touched_cells)
       {
-        if (accumulator_array[i][j] > max_votes)
+        if (accumulator_array[cell] > max_votes || (accumulator_array[cell] == max_votes && cell < max_votes_cell))
         {
-          max_votes = accumulator_array[i][j];
-          max_votes_i = i;
-          max_votes_j = j;
+          max_votes = accumulator_array[cell];
+          max_votes_cell = cell;
         }
         // Reset accumulator_array for the next set of iterations with a new scene reference point
-        accumulator_array[i][j] = 0;
+        accumulator_array[cell] = 0;
       }
-
-    Eigen::Vector3f model_reference_point = input_->points[max_votes_i].getVector3fMap (),
-        model_reference_normal = input_->points[max_votes_i].getNormalVector3fMap ();
-    float rotation_angle_mg = std::acos (model_reference_normal.dot (Eigen::Vector3f::UnitX ()));
-    bool parallel_to_x_mg = (model_reference_normal.y() == 0.0f && model_reference_normal.z() == 0.0f);
-    Eigen::Vector3f rotation_axis_mg = (parallel_to_x_mg)?(Eigen::Vector3f::UnitY ()):(model_reference_normal.cross (Eigen::Vector3f::UnitX ()). normalized());
-    Eigen::AngleAxisf rotation_mg (rotation_angle_mg, rotation_axis_mg);
-    Eigen::Affine3f transform_mg (Eigen::Translation3f ( rotation_mg * ((-1) * model_reference_point)) * rotation_mg);
-    Eigen::Affine3f max_transform = 
-      transform_sg.inverse () * 
-      Eigen::AngleAxisf ((static_cast<float> (max_votes_j) - std::floor (static_cast<float> (M_PI) / search_method_->getAngleDiscretizationStep ())) * search_method_->getAngleDiscretizationStep (), Eigen::Vector3f::UnitX ()) * 
-      transform_mg;
-
-    voted_poses.push_back (PoseWithVotes (max_transform, max_votes));
+      touched_cells.clear ();
+      const size_t max_votes_i = max_votes_cell / aux_size, max_votes_j = max_votes_cell % aux_size;
+
+      Eigen::Vector3f model_reference_point = input_->points[max_votes_i].getVector3fMap (),
+          model_reference_normal = input_->points[max_votes_i].getNormalVector3fMap ();
+      float rotation_angle_mg = std::acos (model_reference_normal.dot (Eigen::Vector3f::UnitX ()));
+      bool parallel_to_x_mg = (model_reference_normal.y() == 0.0f && model_reference_normal.z() == 0.0f);
+      Eigen::Vector3f rotation_axis_mg = (parallel_to_x_mg)?(Eigen::Vector3f::UnitY ()):(model_reference_normal.cross (Eigen::Vector3f::UnitX ()). normalized());
+      Eigen::AngleAxisf rotation_mg (rotation_angle_mg, rotation_axis_mg);
+      Eigen::Affine3f transform_mg (Eigen::Translation3f ( rotation_mg * ((-1) * model_reference_point)) * rotation_mg);
+      reference_poses[reference_i] =
+        transform_sg.inverse () *
+        Eigen::AngleAxisf ((static_cast<float> (max_votes_j) - angle_offset) * search_method_->getAngleDiscretizationStep (), Eigen::Vector3f::UnitX ()) *
+        transform_mg;
+      reference_votes[reference_i] = max_votes;
+    }
   }
   PCL_DEBUG ("Done with the Hough Transform ...\n");
 
+  PoseWithVotesList voted_poses;
+  voted_poses.reserve (nr_reference_points);
+  for (int reference_i = 0; reference_i < nr_reference_points; ++reference_i)
+    voted_poses.push_back (PoseWithVotes (reference_poses[reference_i], reference_votes[reference_i]));
+
   // Cluster poses for filtering out outliers and obtaining more precise results
   PoseWithVotesList results;
   clusterPoses (voted_poses, results);
@@ -194,55 +232,63 @@ pcl::PPFRegistration<PointSource, PointTarget>::clusterPoses (typename pcl::PPFR
 {
   PCL_INFO ("Clustering poses ...\n");
   // Start off by sorting the poses by the number of votes
-  sort(poses.begin (), poses.end (), poseWithVotesCompareFunction);
-
-  std::vector<PoseWithVotesList> clusters;
+  std::stable_sort (poses.begin (), poses.end (), poseWithVotesCompareFunction);
+
+  // Clusters are kept in flat arrays: the representative (first) pose, stored as translation and quaternion,
+  // and running sums for the average pose
+  std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> > cluster_translations;
+  std::vector<Eigen::Quaternionf, Eigen::aligned_allocator<Eigen::Quaternionf> > cluster_rotations;
+  std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> > translation_sums;
+  std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > rotation_sums;
+  std::vector<unsigned int> cluster_sizes;
   std::vector<std::pair<size_t, unsigned int> > cluster_votes;
-  for (size_t poses_i = 0; poses_i < poses.size(); ++ poses_i)
+
+  // Two rotations differ by less than the threshold angle iff |q1 . q2| > cos (threshold / 2)
+  const float min_rotation_dot = std::cos (clustering_rotation_diff_threshold_ / 2.0f);
+  const float max_position_diff_sqr = clustering_position_diff_threshold_ * clustering_position_diff_threshold_;
+
+  for (const PoseWithVotes &pose : poses)
   {
-    bool found_cluster = false;
-    for (size_t clusters_i = 0; clusters_i < clusters.size(); ++ clusters_i)
-    {
-      if (posesWithinErrorBounds (poses[poses_i].pose, clusters[clusters_i].front ().pose))
-      {
-        found_cluster = true;
-        clusters[clusters_i].push_back (poses[poses_i]);
-        cluster_votes[clusters_i].second += poses[poses_i].votes;
+    const Eigen::Vector3f translation = pose.pose.translation ();
+    const Eigen::Quaternionf rotation (pose.pose.rotation ());
+
+    size_t cluster_i = 0;
+    for (; cluster_i < cluster_sizes.size (); ++cluster_i)
+      if ((translation - cluster_translations[cluster_i]).squaredNorm () < max_position_diff_sqr &&
+          std::abs (rotation.dot (cluster_rotations[cluster_i])) > min_rotation_dot)
         break;
-      }
-    }
 
-    if (!found_cluster)
+    if (cluster_i == cluster_sizes.size ())
     {
       // Create a new cluster with the current pose
-      PoseWithVotesList new_cluster;
-      new_cluster.push_back (poses[poses_i]);
-      clusters.push_back (new_cluster);
-      cluster_votes.push_back (std::pair<size_t, unsigned int> (clusters.size () - 1, poses[poses_i].votes));
+      cluster_translations.push_back (translation);
+      cluster_rotations.push_back (rotation);
+      translation_sums.push_back (Eigen::Vector3f::Zero ());
+      rotation_sums.push_back (Eigen::Vector4f::Zero ());
+      cluster_sizes.push_back (0);
+      cluster_votes.push_back (std::pair<size_t, unsigned int> (cluster_i, 0));
     }
- }
+
+    translation_sums[cluster_i] += translation;
+    /// averaging rotations by just averaging the quaternions in 4D space - reference "On Averaging Rotations" by CLAUS GRAMKOW
+    rotation_sums[cluster_i] += rotation.coeffs ();
+    ++cluster_sizes[cluster_i];
+    cluster_votes[cluster_i].second += pose.votes;
+  }
 
   // Sort clusters by total number of votes
-  std::sort (cluster_votes.begin (), cluster_votes.end (), clusterVotesCompareFunction);
+  std::stable_sort (cluster_votes.begin (), cluster_votes.end (), clusterVotesCompareFunction);
   // Compute pose average and put them in result vector
   /// @todo some kind of threshold for determining whether a cluster has enough votes or not...
   /// now just taking the first three clusters
   result.clear ();
-  size_t max_clusters = (clusters.size () < 3) ? clusters.size () : 3;
+  size_t max_clusters = (cluster_sizes.size () < 3) ? cluster_sizes.size () : 3;
   for (size_t cluster_i = 0; cluster_i < max_clusters; ++ cluster_i)
   {
-    PCL_INFO ("Winning cluster has #votes: %d and #poses voted: %d.\n", cluster_votes[cluster_i].second, clusters[cluster_votes[cluster_i].first].size ());
-    Eigen::Vector3f translation_average (0.0, 0.0, 0.0);
-    Eigen::Vector4f rotation_average (0.0, 0.0, 0.0, 0.0);
-    for (typename PoseWithVotesList::iterator v_it = clusters[cluster_votes[cluster_i].first].begin (); v_it != clusters[cluster_votes[cluster_i].first].end (); ++ v_it)
-    {
-      translation_average += v_it->pose.translation ();
-      /// averaging rotations by just averaging the quaternions in 4D space - reference "On Averaging Rotations" by CLAUS GRAMKOW
-      rotation_average += Eigen::Quaternionf (v_it->pose.rotation ()).coeffs ();
-    }
-
-    translation_average /= static_cast<float> (clusters[cluster_votes[cluster_i].first].size ());
-    rotation_average /= static_cast<float> (clusters[cluster_votes[cluster_i].first].size ());
+    const size_t cluster = cluster_votes[cluster_i].first;
+    PCL_INFO ("Winning cluster has #votes: %d and #poses voted: %d.\n", cluster_votes[cluster_i].second, cluster_sizes[cluster]);
+    const Eigen::Vector3f translation_average = translation_sums[cluster] / static_cast<float> (cluster_sizes[cluster]);
+    const Eigen::Vector4f rotation_average = rotation_sums[cluster] / static_cast<float> (cluster_sizes[cluster]);
 
     Eigen::Affine3f transform_average;
     transform_average.translation ().matrix () = translation_average;
@@ -62,7 +62,17 @@ pcl::Registration<PointSource, PointTarget, Scalar>::initCompute ()
   }
 
   // Only update target kd-tree if a new target cloud was set
-  if (target_cloud_updated_ && !force_no_recompute_)
+  if (target_cache_)
+  {
+    // The shared tree is built once per target cloud and version by the cache
+    if (target_cloud_updated_ || !target_cache_entry_)
+    {
+      target_cache_entry_ = target_cache_->get (target_, target_version_);
+      tree_ = target_cache_entry_->getSearchMethod ();
+      target_cloud_updated_ = false;
+    }
+  }
+  else if (target_cloud_updated_ && !force_no_recompute_)
   {
     tree_->setInputCloud (target_);
     target_cloud_updated_ = false;
@@ -72,7 +82,7 @@ pcl::Registration<PointSource, PointTarget, Scalar>::initCompute ()
   // Update the correspondence estimation
   if (correspondence_estimation_)
   {
-    correspondence_estimation_->setSearchMethodTarget (tree_, force_no_recompute_);
+    correspondence_estimation_->setSearchMethodTarget (tree_, force_no_recompute_ || target_cache_);
     correspondence_estimation_->setSearchMethodSource (tree_reciprocal_, force_no_recompute_reciprocal_);
   }
   
@@ -185,7 +195,7 @@ pcl::Registration<PointSource, PointTarget, Scalar>::align (PointCloudSource &ou
     output.points[i] = input_->points[(*indices_)[i]];
 
   // Set the internal point representation of choice unless otherwise noted
-  if (point_representation_ && !force_no_recompute_) 
+  if (point_representation_ && !force_no_recompute_ && !target_cache_) 
     tree_->setPointRepresentation (point_representation_);
 
   // Perform the actual transformation computation
@@ -41,6 +41,10 @@
 #ifndef PCL_REGISTRATION_SAMPLE_CONSENSUS_PREREJECTIVE_HPP_
 #define PCL_REGISTRATION_SAMPLE_CONSENSUS_PREREJECTIVE_HPP_
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointSource, typename PointTarget, typename FeatureT> void 
 pcl::SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::setSourceFeatures (const FeatureCloudConstPtr &features)
@@ -66,10 +70,24 @@ pcl::SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::setTargetF
   feature_tree_->setInputCloud (target_features_);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename FeatureT> void
+pcl::SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointSource, typename PointTarget, typename FeatureT> void 
 pcl::SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::selectSamples (
-    const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices)
+    const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices, RandomEngine &rng) const
 {
   if (nr_samples > static_cast<int> (cloud.points.size ()))
   {
@@ -86,7 +104,7 @@ pcl::SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::selectSamp
   for (int i = 0; i < nr_samples; i++)
   {
     // Select a random number
-    sample_indices[i] = getRandomIndex (static_cast<int> (cloud.points.size ()) - i);
+    sample_indices[i] = getRandomIndex (static_cast<int> (cloud.points.size ()) - i, rng);
       
     // Run trough list of numbers, starting at the lowest, to avoid duplicates
     for (int j = 0; j < i; j++)
@@ -115,7 +133,8 @@ template <typename PointSource, typename PointTarget, typename FeatureT> void
 pcl::SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::findSimilarFeatures (
         const std::vector<int> &sample_indices,
         std::vector<std::vector<int> >& similar_features,
-        std::vector<int> &corresponding_indices)
+        std::vector<int> &corresponding_indices,
+        RandomEngine &rng) const
 {
   // Allocate results
   corresponding_indices.resize (sample_indices.size ());
@@ -135,7 +154,7 @@ pcl::SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::findSimila
     if (k_correspondences_ == 1)
       corresponding_indices[i] = similar_features[idx][0];
     else
-      corresponding_indices[i] = similar_features[idx][getRandomIndex (k_correspondences_)];
+      corresponding_indices[i] = similar_features[idx][getRandomIndex (k_correspondences_, rng)];
   }
 }
 
@@ -210,6 +229,10 @@ pcl::SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::computeTra
   float lowest_error = std::numeric_limits<float>::max ();
   converged_ = false;
   
+  // A hypothesis with more outliers than this can never reach the required inlier fraction
+  const int nr_points = static_cast<int> (input_->size ());
+  const int max_outliers = nr_points - static_cast<int> (std::floor (inlier_fraction_ * static_cast<float> (nr_points)));
+
   // Temporaries
   std::vector<int> inliers;
   float inlier_fraction;
@@ -231,52 +254,94 @@ pcl::SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::computeTra
   
   // Feature correspondence cache
   std::vector<std::vector<int> > similar_features (input_->size ());
-  
+
+  // Never spawn more threads than there are hypotheses
+#ifdef _OPENMP
+  const int nr_threads = std::max (1, std::min (static_cast<int> (threads_), max_iterations_));
+#else
+  const int nr_threads = 1;
+#endif
+
+  // The cache is filled lazily when running on a single thread, but has to be complete before the hypothesis
+  // threads start reading it concurrently
+  if (nr_threads > 1)
+  {
+#ifdef _OPENMP
+#pragma omp parallel for shared (similar_features) num_threads (nr_threads) schedule (dynamic, 64)
+#endif
+    for (int idx = 0; idx < nr_points; ++idx)
+    {
+      std::vector<float> nn_distances (k_correspondences_);
+      feature_tree_->nearestKSearch (*input_features_, idx, k_correspondences_, similar_features[idx], nn_distances);
+    }
+  }
+
+  // Best hypothesis found in each block of iterations
+  std::vector<float> block_errors (nr_threads, std::numeric_limits<float>::max ());
+  std::vector<Matrix4, Eigen::aligned_allocator<Matrix4> > block_transformations (nr_threads, Matrix4::Identity ());
+  std::vector<std::vector<int> > block_inliers (nr_threads);
+
   // Start
-  for (int i = 0; i < max_iterations_; ++i)
+#ifdef _OPENMP
+#pragma omp parallel for num_threads (nr_threads) schedule (static, 1) reduction (+:num_rejections)
+#endif
+  for (int block = 0; block < nr_threads; ++block)
   {
+    // Each block of iterations owns an independent random number stream
+    std::seed_seq seed { random_seed_, static_cast<unsigned int> (block) };
+    RandomEngine rng (seed);
+    const int iterations_begin = static_cast<int> (static_cast<long> (max_iterations_) * block / nr_threads);
+    const int iterations_end = static_cast<int> (static_cast<long> (max_iterations_) * (block + 1) / nr_threads);
+
     // Temporary containers
     std::vector<int> sample_indices;
     std::vector<int> corresponding_indices;
-    
-    // Draw nr_samples_ random samples
-    selectSamples (*input_, nr_samples_, sample_indices);
-    
-    // Find corresponding features in the target cloud
-    findSimilarFeatures (sample_indices, similar_features, corresponding_indices);
-    
-    // Apply prerejection
-    if (!correspondence_rejector_poly_->thresholdPolygon (sample_indices, corresponding_indices))
+    std::vector<int> hypothesis_inliers;
+    float hypothesis_error;
+    Matrix4 transformation;
+
+    for (int i = iterations_begin; i < iterations_end; ++i)
     {
-      ++num_rejections;
-      continue;
-    }
+      // Draw nr_samples_ random samples
+      selectSamples (*input_, nr_samples_, sample_indices, rng);
 
-    // Estimate the transform from the correspondences, write to transformation_
-    transformation_estimation_->estimateRigidTransformation (*input_, sample_indices, *target_, corresponding_indices, transformation_);
-    
-    // Take a backup of previous result
-    const Matrix4 final_transformation_prev = final_transformation_;
-    
-    // Set final result to current transformation
-    final_transformation_ = transformation_;
-    
-    // Transform the input and compute the error (uses input_ and final_transformation_)
-    getFitness (inliers, error);
-    
-    // Restore previous result
-    final_transformation_ = final_transformation_prev;
+      // Find corresponding features in the target cloud
+      findSimilarFeatures (sample_indices, similar_features, corresponding_indices, rng);
 
-    // If the new fit is better, update results
-    inlier_fraction = static_cast<float> (inliers.size ()) / static_cast<float> (input_->size ());
+      // Apply prerejection
+      if (!correspondence_rejector_poly_->thresholdPolygon (sample_indices, corresponding_indices))
+      {
+        ++num_rejections;
+        continue;
+      }
 
-    // Update result if pose hypothesis is better
-    if (inlier_fraction >= inlier_fraction_ && error < lowest_error)
+      // Estimate the transform from the correspondences
+      transformation_estimation_->estimateRigidTransformation (*input_, sample_indices, *target_, corresponding_indices, transformation);
+
+      // Transform the input and compute the error, giving up as soon as the inlier fraction can not be reached
+      if (!getFitness (transformation, max_outliers, hypothesis_inliers, hypothesis_error))
+        continue;
+
+      // Update result if pose hypothesis is better
+      const float hypothesis_inlier_fraction = static_cast<float> (hypothesis_inliers.size ()) / static_cast<float> (nr_points);
+      if (hypothesis_inlier_fraction >= inlier_fraction_ && hypothesis_error < block_errors[block])
+      {
+        block_errors[block] = hypothesis_error;
+        block_transformations[block] = transformation;
+        block_inliers[block].swap (hypothesis_inliers);
+      }
+    }
+  }
+
+  // Merge the per-block results in a fixed order, so that the outcome only depends on seed and thread count
+  for (int block = 0; block < nr_threads; ++block)
+  {
+    if (block_errors[block] < lowest_error)
     {
-      inliers_ = inliers;
-      lowest_error = error;
+      inliers_.swap (block_inliers[block]);
+      lowest_error = block_errors[block];
       converged_ = true;
-      final_transformation_ = transformation_;
+      final_transformation_ = transformation_ = block_transformations[block];
     }
   }
 
@@ -293,35 +358,66 @@ pcl::SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::computeTra
 template <typename PointSource, typename PointTarget, typename FeatureT> void 
 pcl::SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::getFitness (std::vector<int>& inliers, float& fitness_score)
 {
+  getFitness (final_transformation_, static_cast<int> (input_->size ()), inliers, fitness_score);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename FeatureT> bool
+pcl::SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::getFitness (
+    const Matrix4 &transformation, int max_outliers, std::vector<int>& inliers, float& fitness_score) const
+{
+  // Number of source points transformed at once
+  const int block_size = 256;
+
   // Initialize variables
   inliers.clear ();
   inliers.reserve (input_->size ());
   fitness_score = 0.0f;
+  int nr_outliers = 0;
   
   // Use squared distance for comparison with NN search results
   const float max_range = corr_dist_threshold_ * corr_dist_threshold_;
 
-  // Transform the input dataset using the final transformation
-  PointCloudSource input_transformed;
-  input_transformed.resize (input_->size ());
-  transformPointCloud (*input_, input_transformed, final_transformation_);
-  
-  // For each point in the source dataset
-  for (size_t i = 0; i < input_transformed.points.size (); ++i)
+  const Eigen::Matrix3f rotation = transformation.template topLeftCorner<3, 3> ().template cast<float> ();
+  const Eigen::Vector3f translation = transformation.template block<3, 1> (0, 3).template cast<float> ();
+
+  std::vector<int> nn_indices (1);
+  std::vector<float> nn_dists (1);
+  Eigen::Matrix3Xf block (3, block_size);
+  const int nr_points = static_cast<int> (input_->size ());
+
+  // For each block of points in the source dataset
+  for (int block_begin = 0; block_begin < nr_points; block_begin += block_size)
   {
-    // Find its nearest neighbor in the target
-    std::vector<int> nn_indices (1);
-    std::vector<float> nn_dists (1);
-    tree_->nearestKSearch (input_transformed.points[i], 1, nn_indices, nn_dists);
-    
-    // Check if point is an inlier
-    if (nn_dists[0] < max_range)
+    const int block_end = std::min (block_begin + block_size, nr_points);
+    const int nr_block_points = block_end - block_begin;
+
+    // Transform the whole block with a single matrix product
+    for (int i = 0; i < nr_block_points; ++i)
+      block.col (i) = (*input_)[block_begin + i].getVector3fMap ();
+    block.leftCols (nr_block_points) = (rotation * block.leftCols (nr_block_points)).colwise () + translation;
+
+    for (int i = 0; i < nr_block_points; ++i)
     {
-      // Update inliers
-      inliers.push_back (static_cast<int> (i));
-      
-      // Update fitness score
-      fitness_score += nn_dists[0];
+      // Find its nearest neighbor in the target
+      PointSource point_transformed = (*input_)[block_begin + i];
+      point_transformed.getVector3fMap () = block.col (i);
+      tree_->nearestKSearch (point_transformed, 1, nn_indices, nn_dists);
+
+      // Check if point is an inlier
+      if (nn_dists[0] < max_range)
+      {
+        // Update inliers
+        inliers.push_back (block_begin + i);
+
+        // Update fitness score
+        fitness_score += nn_dists[0];
+      }
+      else if (++nr_outliers > max_outliers)
+      {
+        fitness_score = std::numeric_limits<float>::max ();
+        return (false);
+      }
     }
   }
 
@@ -330,6 +426,8 @@ pcl::SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::getFitness
     fitness_score /= static_cast<float> (inliers.size ());
   else
     fitness_score = std::numeric_limits<float>::max ();
+
+  return (true);
 }
 
 #endif
@@ -0,0 +1,189 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2019-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PCL_REGISTRATION_IMPL_TARGET_CACHE_HPP_
+#define PCL_REGISTRATION_IMPL_TARGET_CACHE_HPP_
+
+#include <pcl/features/normal_3d.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT>
+pcl::registration::TargetCache<PointT>::Entry::Entry (const PointCloudConstPtr &cloud, std::uint64_t version) :
+  cloud_ (cloud),
+  version_ (version),
+  tree_ (new KdTree)
+{
+  tree_->setInputCloud (cloud_);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> typename pcl::registration::TargetCache<PointT>::NormalCloudConstPtr
+pcl::registration::TargetCache<PointT>::Entry::getNormals (int k)
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  NormalCloudConstPtr &normals = normals_[k];
+  if (!normals)
+  {
+    NormalCloud::Ptr estimated (new NormalCloud);
+    pcl::NormalEstimation<PointT, pcl::Normal> normal_estimation;
+    normal_estimation.setInputCloud (cloud_);
+    normal_estimation.setSearchMethod (tree_);
+    normal_estimation.setKSearch (k);
+    normal_estimation.compute (*estimated);
+    normals = estimated;
+  }
+  return (normals);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> typename pcl::registration::TargetCache<PointT>::MatricesVectorPtr
+pcl::registration::TargetCache<PointT>::Entry::getCovariances (int k, double epsilon) const
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  auto it = covariances_.find (std::make_pair (k, epsilon));
+  return (it == covariances_.end () ? MatricesVectorPtr () : it->second);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> typename pcl::registration::TargetCache<PointT>::MatricesVectorPtr
+pcl::registration::TargetCache<PointT>::Entry::setCovariances (int k, double epsilon, const MatricesVectorPtr &covariances)
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  MatricesVectorPtr &stored = covariances_[std::make_pair (k, epsilon)];
+  if (!stored)
+    stored = covariances;
+  return (stored);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> typename pcl::registration::TargetCache<PointT>::EntryPtr
+pcl::registration::TargetCache<PointT>::find (const PointCloud *cloud, std::uint64_t version)
+{
+  for (auto it = entries_.begin (); it != entries_.end (); ++it)
+  {
+    if ((*it)->getCloud ().get () == cloud && (*it)->getVersion () == version)
+    {
+      entries_.splice (entries_.begin (), entries_, it);
+      return (entries_.front ());
+    }
+  }
+  return (EntryPtr ());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::registration::TargetCache<PointT>::evict ()
+{
+  while (entries_.size () > max_entries_)
+    entries_.pop_back ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> typename pcl::registration::TargetCache<PointT>::EntryPtr
+pcl::registration::TargetCache<PointT>::get (const PointCloudConstPtr &cloud, std::uint64_t version)
+{
+  {
+    std::lock_guard<std::mutex> lock (mutex_);
+    EntryPtr entry = find (cloud.get (), version);
+    if (entry)
+    {
+      ++hits_;
+      return (entry);
+    }
+  }
+
+  // Build the tree without holding the lock, so that queries on other entries are not blocked
+  EntryPtr built (new Entry (cloud, version));
+
+  std::lock_guard<std::mutex> lock (mutex_);
+  // Another thread may have built the same entry in the meantime
+  EntryPtr entry = find (cloud.get (), version);
+  if (entry)
+  {
+    ++hits_;
+    return (entry);
+  }
+  ++misses_;
+  entries_.push_front (built);
+  evict ();
+  return (built);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::registration::TargetCache<PointT>::contains (const PointCloudConstPtr &cloud, std::uint64_t version) const
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  for (const EntryPtr &entry : entries_)
+    if (entry->getCloud () == cloud && entry->getVersion () == version)
+      return (true);
+  return (false);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::registration::TargetCache<PointT>::erase (const PointCloudConstPtr &cloud)
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  entries_.remove_if ([&cloud] (const EntryPtr &entry) { return (entry->getCloud () == cloud); });
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::registration::TargetCache<PointT>::clear ()
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  entries_.clear ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> size_t
+pcl::registration::TargetCache<PointT>::size () const
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  return (entries_.size ());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::registration::TargetCache<PointT>::setMaxEntries (size_t max_entries)
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  max_entries_ = max_entries;
+  evict ();
+}
+
+#endif /*PCL_REGISTRATION_IMPL_TARGET_CACHE_HPP_*/
@@ -41,6 +41,10 @@
 #define PCL_REGISTRATION_TRANSFORMATION_ESTIMATION_POINT_TO_PLANE_LLS_HPP_
 #include <pcl/cloud_iterator.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointSource, typename PointTarget, typename Scalar> inline void
 pcl::registration::TransformationEstimationPointToPlaneLLS<PointSource, PointTarget, Scalar>::
@@ -148,98 +152,48 @@ estimateRigidTransformation (ConstCloudIterator<PointSource>& source_it, ConstCl
   using Vector6d = Eigen::Matrix<double, 6, 1>;
   using Matrix6d = Eigen::Matrix<double, 6, 6>;
 
-  Matrix6d ATA;
-  Vector6d ATb;
-  ATA.setZero ();
-  ATb.setZero ();
+  // Gather the correspondences so that they can be accumulated block-wise (and in parallel)
+  std::vector<const PointSource*> sources;
+  std::vector<const PointTarget*> targets;
+  sources.reserve (source_it.size ());
+  targets.reserve (source_it.size ());
+  for (; source_it.isValid () && target_it.isValid (); ++source_it, ++target_it)
+  {
+    sources.push_back (&(*source_it));
+    targets.push_back (&(*target_it));
+  }
 
   // Approximate as a linear least squares problem
-  while (source_it.isValid () && target_it.isValid ())
+  auto fill_row = [&sources, &targets] (std::size_t i, Vector6d &row, double &d) -> bool
   {
-    if (!std::isfinite (source_it->x) ||
-        !std::isfinite (source_it->y) ||
-        !std::isfinite (source_it->z) ||
-        !std::isfinite (target_it->x) ||
-        !std::isfinite (target_it->y) ||
-        !std::isfinite (target_it->z) ||
-        !std::isfinite (target_it->normal_x) ||
-        !std::isfinite (target_it->normal_y) ||
-        !std::isfinite (target_it->normal_z))
-    {
-      ++target_it;
-      ++source_it;    
-      continue;
-    }
-
-    const float & sx = source_it->x;
-    const float & sy = source_it->y;
-    const float & sz = source_it->z;
-    const float & dx = target_it->x;
-    const float & dy = target_it->y;
-    const float & dz = target_it->z;
-    const float & nx = target_it->normal[0];
-    const float & ny = target_it->normal[1];
-    const float & nz = target_it->normal[2];
-
-    double a = nz*sy - ny*sz;
-    double b = nx*sz - nz*sx; 
-    double c = ny*sx - nx*sy;
-   
-    //    0  1  2  3  4  5
-    //    6  7  8  9 10 11
-    //   12 13 14 15 16 17
-    //   18 19 20 21 22 23
-    //   24 25 26 27 28 29
-    //   30 31 32 33 34 35
-   
-    ATA.coeffRef (0) += a * a;
-    ATA.coeffRef (1) += a * b;
-    ATA.coeffRef (2) += a * c;
-    ATA.coeffRef (3) += a * nx;
-    ATA.coeffRef (4) += a * ny;
-    ATA.coeffRef (5) += a * nz;
-    ATA.coeffRef (7) += b * b;
-    ATA.coeffRef (8) += b * c;
-    ATA.coeffRef (9) += b * nx;
-    ATA.coeffRef (10) += b * ny;
-    ATA.coeffRef (11) += b * nz;
-    ATA.coeffRef (14) += c * c;
-    ATA.coeffRef (15) += c * nx;
-    ATA.coeffRef (16) += c * ny;
-    ATA.coeffRef (17) += c * nz;
-    ATA.coeffRef (21) += nx * nx;
-    ATA.coeffRef (22) += nx * ny;
-    ATA.coeffRef (23) += nx * nz;
-    ATA.coeffRef (28) += ny * ny;
-    ATA.coeffRef (29) += ny * nz;
-    ATA.coeffRef (35) += nz * nz;
-
-    double d = nx*dx + ny*dy + nz*dz - nx*sx - ny*sy - nz*sz;
-    ATb.coeffRef (0) += a * d;
-    ATb.coeffRef (1) += b * d;
-    ATb.coeffRef (2) += c * d;
-    ATb.coeffRef (3) += nx * d;
-    ATb.coeffRef (4) += ny * d;
-    ATb.coeffRef (5) += nz * d;
-
-    ++target_it;
-    ++source_it;    
-  }
-  ATA.coeffRef (6) = ATA.coeff (1);
-  ATA.coeffRef (12) = ATA.coeff (2);
-  ATA.coeffRef (13) = ATA.coeff (8);
-  ATA.coeffRef (18) = ATA.coeff (3);
-  ATA.coeffRef (19) = ATA.coeff (9);
-  ATA.coeffRef (20) = ATA.coeff (15);
-  ATA.coeffRef (24) = ATA.coeff (4);
-  ATA.coeffRef (25) = ATA.coeff (10);
-  ATA.coeffRef (26) = ATA.coeff (16);
-  ATA.coeffRef (27) = ATA.coeff (22);
-  ATA.coeffRef (30) = ATA.coeff (5);
-  ATA.coeffRef (31) = ATA.coeff (11);
-  ATA.coeffRef (32) = ATA.coeff (17);
-  ATA.coeffRef (33) = ATA.coeff (23);
-  ATA.coeffRef (34) = ATA.coeff (29);
+    const PointSource &src = *sources[i];
+    const PointTarget &tgt = *targets[i];
+    if (!std::isfinite (src.x) ||
+        !std::isfinite (src.y) ||
+        !std::isfinite (src.z) ||
+        !std::isfinite (tgt.x) ||
+        !std::isfinite (tgt.y) ||
+        !std::isfinite (tgt.z) ||
+        !std::isfinite (tgt.normal_x) ||
+        !std::isfinite (tgt.normal_y) ||
+        !std::isfinite (tgt.normal_z))
+      return (false);
+
+    const float & sx = src.x;
+    const float & sy = src.y;
+    const float & sz = src.z;
+    const float & nx = tgt.normal[0];
+    const float & ny = tgt.normal[1];
+    const float & nz = tgt.normal[2];
+
+    row << nz*sy - ny*sz, nx*sz - nz*sx, ny*sx - nx*sy, nx, ny, nz;
+    d = nx*tgt.x + ny*tgt.y + nz*tgt.z - nx*sx - ny*sy - nz*sz;
+    return (true);
+  };
+
+  Matrix6d ATA;
+  Vector6d ATb;
+  accumulateNormalEquations (sources.size (), fill_row, robust_kernel_, robust_kernel_scale_, threads_, ATA, ATb);
 
   // Solve A*x = b
   Vector6d x = static_cast<Vector6d> (ATA.inverse () * ATb);
@@ -247,4 +201,20 @@ estimateRigidTransformation (ConstCloudIterator<PointSource>& source_it, ConstCl
   // Construct the transformation matrix from x
   constructTransformationMatrix (x (0), x (1), x (2), x (3), x (4), x (5), transformation_matrix);
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename Scalar> void
+pcl::registration::TransformationEstimationPointToPlaneLLS<PointSource, PointTarget, Scalar>::
+setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 #endif /* PCL_REGISTRATION_TRANSFORMATION_ESTIMATION_POINT_TO_PLANE_LLS_HPP_ */
@@ -39,6 +39,10 @@
 
 #include <pcl/cloud_iterator.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointSource, typename PointTarget, typename Scalar> inline void
 pcl::registration::TransformationEstimationSymmetricPointToPlaneLLS<PointSource, PointTarget, Scalar>::
@@ -135,26 +139,35 @@ template <typename PointSource, typename PointTarget, typename Scalar> inline vo
 pcl::registration::TransformationEstimationSymmetricPointToPlaneLLS<PointSource, PointTarget, Scalar>::
 estimateRigidTransformation (ConstCloudIterator<PointSource>& source_it, ConstCloudIterator<PointTarget>& target_it, Matrix4 &transformation_matrix) const
 {
-  using Matrix6 = Eigen::Matrix<Scalar, 6, 6>;
+  using Vector6d = Eigen::Matrix<double, 6, 1>;
+  using Matrix6d = Eigen::Matrix<double, 6, 6>;
   using Vector3 = Eigen::Matrix<Scalar, 3, 1>;
 
-  Matrix6 ATA;
-  Vector6 ATb;
-  ATA.setZero ();
-  ATb.setZero ();
-  auto M = ATA.template selfadjointView<Eigen::Upper> ();
-
-  // Approximate as a linear least squares problem
+  // Gather the correspondences so that they can be accumulated block-wise (and in parallel)
+  std::vector<const PointSource*> sources;
+  std::vector<const PointTarget*> targets;
   source_it.reset ();
   target_it.reset ();
+  sources.reserve (source_it.size ());
+  targets.reserve (source_it.size ());
   for (; source_it.isValid () && target_it.isValid (); ++source_it, ++target_it)
   {
-    const Vector3 p (source_it->x, source_it->y, source_it->z);
-    const Vector3 q (target_it->x, target_it->y, target_it->z);
-    const Vector3 n1 (source_it->getNormalVector3fMap());
-    const Vector3 n2 (target_it->getNormalVector3fMap());
+    sources.push_back (&(*source_it));
+    targets.push_back (&(*target_it));
+  }
+
+  // Approximate as a linear least squares problem
+  const bool enforce_same_direction_normals = enforce_same_direction_normals_;
+  auto fill_row = [&sources, &targets, enforce_same_direction_normals] (std::size_t i, Vector6d &row, double &d) -> bool
+  {
+    const PointSource &src = *sources[i];
+    const PointTarget &tgt = *targets[i];
+    const Vector3 p (src.x, src.y, src.z);
+    const Vector3 q (tgt.x, tgt.y, tgt.z);
+    const Vector3 n1 (src.getNormalVector3fMap().template cast<Scalar> ());
+    const Vector3 n2 (tgt.getNormalVector3fMap().template cast<Scalar> ());
     Vector3 n;
-    if (enforce_same_direction_normals_)
+    if (enforce_same_direction_normals)
     {
         if (n1.dot (n2) >= 0.)
             n = n1 + n2;
@@ -170,18 +183,20 @@ estimateRigidTransformation (ConstCloudIterator<PointSource>& source_it, ConstCl
         !q.array().isFinite().all() ||
         !n.array().isFinite().all())
     {
-      continue;
+      return (false);
     }
 
-    Vector6 v;
-    v << (p + q).cross (n), n;
-    M.rankUpdate (v);
-   
-    ATb += v * (q - p).dot (n);
-  }
+    row << ((p + q).cross (n)).template cast<double> (), n.template cast<double> ();
+    d = static_cast<double> ((q - p).dot (n));
+    return (true);
+  };
+
+  Matrix6d ATA;
+  Vector6d ATb;
+  accumulateNormalEquations (sources.size (), fill_row, robust_kernel_, robust_kernel_scale_, threads_, ATA, ATb);
 
   // Solve A*x = b
-  const Vector6 x = M.ldlt ().solve (ATb);
+  const Vector6 x = ATA.ldlt ().solve (ATb).template cast<Scalar> ();
   
   // Construct the transformation matrix from x
   constructTransformationMatrix (x, transformation_matrix);
@@ -202,3 +217,18 @@ getEnforceSameDirectionNormals ()
 {
     return enforce_same_direction_normals_;
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename Scalar> void
+pcl::registration::TransformationEstimationSymmetricPointToPlaneLLS<PointSource, PointTarget, Scalar>::
+setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
@@ -0,0 +1,194 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2019-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <pcl/pcl_macros.h>
+
+#include <Eigen/Core>
+#include <Eigen/StdVector>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace pcl
+{
+  namespace registration
+  {
+    /** \brief Robust kernels used to reweight the residuals of the linear least squares
+      * transformation estimators (iteratively reweighted least squares).
+      * \ingroup registration
+      */
+    enum RobustKernelType
+    {
+      ROBUST_KERNEL_NONE,
+      ROBUST_KERNEL_HUBER,
+      ROBUST_KERNEL_CAUCHY,
+      ROBUST_KERNEL_TUKEY
+    };
+
+    /** \brief Compute the IRLS weight of a residual for the given robust kernel.
+      * \param[in] kernel the robust kernel type
+      * \param[in] residual the (signed) residual
+      * \param[in] scale the kernel scale (inlier threshold), must be positive
+      * \return the weight in [0, 1]
+      * \ingroup registration
+      */
+    inline double
+    computeRobustWeight (RobustKernelType kernel, double residual, double scale)
+    {
+      const double r = std::abs (residual);
+      switch (kernel)
+      {
+        case ROBUST_KERNEL_HUBER:
+          return (r <= scale ? 1.0 : scale / r);
+        case ROBUST_KERNEL_CAUCHY:
+        {
+          const double u = r / scale;
+          return (1.0 / (1.0 + u * u));
+        }
+        case ROBUST_KERNEL_TUKEY:
+        {
+          if (r >= scale)
+            return (0.0);
+          const double u = r / scale;
+          const double t = 1.0 - u * u;
+          return (t * t);
+        }
+        default:
+          return (1.0);
+      }
+    }
+
+    /** \brief Accumulate the normal equations (A^T W A) x = A^T W b of a 6 DOF linear least squares problem.
+      *
+      * The rows are produced by \a fill_row, called as <tt>bool fill_row (std::size_t i, Eigen::Matrix<double, 6, 1> &a, double &b)</tt>;
+      * rows for which it returns false are skipped. Rows are gathered in fixed size blocks and each block is folded in
+      * with a single symmetric rank-k update and matrix-vector product, so that the accumulation runs through Eigen's
+      * vectorized kernels instead of scalar per-element updates. Blocks are split into contiguous ranges that are
+      * accumulated in parallel and summed in a fixed order, hence the result only depends on \a nr_threads.
+      * The IRLS weights of the robust \a kernel are computed from b in the same pass.
+      *
+      * \param[in] nr_rows the number of rows (correspondences)
+      * \param[in] fill_row the row generator
+      * \param[in] kernel the robust kernel used to weight the rows
+      * \param[in] kernel_scale the scale of the robust kernel
+      * \param[in] nr_threads the number of threads to use (ignored without OpenMP)
+      * \param[out] ATA the full (symmetric) 6x6 matrix A^T W A
+      * \param[out] ATb the 6x1 vector A^T W b
+      * \return the number of rows with a non-zero weight
+      * \ingroup registration
+      */
+    template <typename RowFunctor> std::size_t
+    accumulateNormalEquations (std::size_t nr_rows,
+                               const RowFunctor &fill_row,
+                               RobustKernelType kernel,
+                               double kernel_scale,
+                               unsigned int nr_threads,
+                               Eigen::Matrix<double, 6, 6> &ATA,
+                               Eigen::Matrix<double, 6, 1> &ATb)
+    {
+      using Matrix6d = Eigen::Matrix<double, 6, 6>;
+      using Vector6d = Eigen::Matrix<double, 6, 1>;
+      const std::ptrdiff_t block_size = 256;
+      const std::ptrdiff_t nr_blocks = (static_cast<std::ptrdiff_t> (nr_rows) + block_size - 1) / block_size;
+
+#ifdef _OPENMP
+      const int nr_ranges = static_cast<int> (std::max<std::ptrdiff_t> (1, std::min<std::ptrdiff_t> (nr_threads, nr_blocks)));
+#else
+      const int nr_ranges = 1;
+      (void) nr_threads;
+#endif
+      std::vector<Matrix6d, Eigen::aligned_allocator<Matrix6d> > partial_ATA (nr_ranges, Matrix6d::Zero ());
+      std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > partial_ATb (nr_ranges, Vector6d::Zero ());
+      std::vector<std::size_t> partial_count (nr_ranges, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nr_ranges)
+#endif
+      for (int range = 0; range < nr_ranges; ++range)
+      {
+        Eigen::Matrix<double, 6, Eigen::Dynamic> A (6, block_size);
+        Eigen::VectorXd b (block_size);
+        Vector6d row;
+        double rhs;
+
+        const std::ptrdiff_t first_block = nr_blocks * range / nr_ranges;
+        const std::ptrdiff_t last_block = nr_blocks * (range + 1) / nr_ranges;
+        for (std::ptrdiff_t block = first_block; block < last_block; ++block)
+        {
+          const std::size_t begin = block * block_size;
+          const std::size_t end = std::min<std::size_t> (begin + block_size, nr_rows);
+          std::ptrdiff_t count = 0;
+          for (std::size_t i = begin; i < end; ++i)
+          {
+            if (!fill_row (i, row, rhs))
+              continue;
+            double w = 1.0;
+            if (kernel != ROBUST_KERNEL_NONE)
+            {
+              w = computeRobustWeight (kernel, rhs, kernel_scale);
+              if (!(w > 0.0))
+                continue;
+              w = std::sqrt (w);
+            }
+            A.col (count) = w * row;
+            b (count) = w * rhs;
+            ++count;
+          }
+          if (count == 0)
+            continue;
+          partial_ATA[range].template selfadjointView<Eigen::Upper> ().rankUpdate (A.leftCols (count));
+          partial_ATb[range].noalias () += A.leftCols (count) * b.head (count);
+          partial_count[range] += count;
+        }
+      }
+
+      Matrix6d upper = Matrix6d::Zero ();
+      ATb.setZero ();
+      std::size_t nr_valid = 0;
+      for (int range = 0; range < nr_ranges; ++range)
+      {
+        upper += partial_ATA[range];
+        ATb += partial_ATb[range];
+        nr_valid += partial_count[range];
+      }
+      ATA = upper.template selfadjointView<Eigen::Upper> ();
+      return (nr_valid);
+    }
+  }
+}
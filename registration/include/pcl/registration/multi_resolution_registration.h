@@ -0,0 +1,286 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2019-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <pcl/point_cloud.h>
+#include <pcl/search/kdtree.h>
+#include <pcl/registration/registration.h>
+
+#include <vector>
+
+namespace pcl
+{
+  namespace registration
+  {
+    /** \brief Coarse-to-fine driver for any @ref Registration method.
+      *
+      * The source and target clouds are downsampled once into a pyramid of voxel grids, and the search trees
+      * of every pyramid level are built once and cached, so that repeated calls to \ref align with the same
+      * target (e.g. scan-to-map tracking) do not rebuild anything on the target side. The wrapped registration
+      * method is then run level by level, each level starting from the transformation estimated by the
+      * previous one, with its own correspondence distance and convergence criteria.
+      *
+      * \code
+      * IterativeClosestPoint<PointXYZ, PointXYZ>::Ptr icp (new IterativeClosestPoint<PointXYZ, PointXYZ>);
+      *
+      * MultiResolutionRegistration<PointXYZ, PointXYZ> mr;
+      * mr.setRegistration (icp);
+      * mr.addLevel (1.0f, 3.0, 30);    // 1m voxels, 3m correspondences, 30 iterations
+      * mr.addLevel (0.5f, 1.5, 30);
+      * mr.addLevel (0.2f, 0.6, 50);
+      * mr.setInputSource (source);
+      * mr.setInputTarget (target);
+      * mr.align (aligned);
+      * \endcode
+      *
+      * \note Levels are processed in the order they were added. All point fields are averaged by the
+      * voxel grid, hence normals of downsampled levels are not unit length.
+      * \ingroup registration
+      */
+    template <typename PointSource, typename PointTarget, typename Scalar = float>
+    class MultiResolutionRegistration
+    {
+      public:
+        using Ptr = boost::shared_ptr<MultiResolutionRegistration<PointSource, PointTarget, Scalar> >;
+        using ConstPtr = boost::shared_ptr<const MultiResolutionRegistration<PointSource, PointTarget, Scalar> >;
+
+        using RegistrationT = pcl::Registration<PointSource, PointTarget, Scalar>;
+        using RegistrationPtr = typename RegistrationT::Ptr;
+        using Matrix4 = typename RegistrationT::Matrix4;
+
+        using PointCloudSource = pcl::PointCloud<PointSource>;
+        using PointCloudSourcePtr = typename PointCloudSource::Ptr;
+        using PointCloudSourceConstPtr = typename PointCloudSource::ConstPtr;
+
+        using PointCloudTarget = pcl::PointCloud<PointTarget>;
+        using PointCloudTargetPtr = typename PointCloudTarget::Ptr;
+        using PointCloudTargetConstPtr = typename PointCloudTarget::ConstPtr;
+
+        using KdTree = pcl::search::KdTree<PointTarget>;
+        using KdTreePtr = typename KdTree::Ptr;
+        using KdTreeReciprocal = pcl::search::KdTree<PointSource>;
+        using KdTreeReciprocalPtr = typename KdTreeReciprocal::Ptr;
+
+        /** \brief Parameters of one pyramid level */
+        struct Level
+        {
+          /** \brief Voxel grid leaf size of the level; 0 uses the full resolution clouds */
+          float leaf_size;
+          /** \brief Maximum correspondence distance used on the level */
+          double max_correspondence_distance;
+          /** \brief Maximum number of iterations on the level */
+          int max_iterations;
+          /** \brief Transformation epsilon on the level, see Registration::setTransformationEpsilon */
+          double transformation_epsilon;
+          /** \brief Euclidean fitness epsilon on the level, see Registration::setEuclideanFitnessEpsilon */
+          double euclidean_fitness_epsilon;
+        };
+
+        /** \brief Outcome of the registration on one pyramid level */
+        struct LevelResult
+        {
+          /** \brief Number of source points on the level */
+          size_t source_size;
+          /** \brief Number of target points on the level */
+          size_t target_size;
+          /** \brief Time spent building the level's pyramid clouds and search trees, in milliseconds */
+          double setup_time;
+          /** \brief Time spent in the registration method on the level, in milliseconds */
+          double registration_time;
+          /** \brief Whether the registration method converged on the level */
+          bool converged;
+          /** \brief Transformation estimated on the level */
+          Matrix4 transformation;
+
+          PCL_MAKE_ALIGNED_OPERATOR_NEW
+        };
+
+        /** \brief Empty constructor. */
+        MultiResolutionRegistration ();
+
+        /** \brief Set the registration method run on every level. Its search trees are managed by this class. */
+        inline void
+        setRegistration (const RegistrationPtr &registration) { registration_ = registration; }
+
+        /** \brief Get the registration method run on every level. */
+        inline RegistrationPtr
+        getRegistration () const { return (registration_); }
+
+        /** \brief Append a pyramid level. Levels should go from coarse to fine.
+          * \param[in] level the parameters of the level
+          */
+        inline void
+        addLevel (const Level &level)
+        {
+          levels_.push_back (level);
+          resetPyramids ();
+        }
+
+        /** \brief Append a pyramid level. Levels should go from coarse to fine.
+          * \param[in] leaf_size voxel grid leaf size of the level (0 for full resolution)
+          * \param[in] max_correspondence_distance maximum correspondence distance on the level
+          * \param[in] max_iterations maximum number of iterations on the level
+          * \param[in] transformation_epsilon transformation epsilon on the level
+          * \param[in] euclidean_fitness_epsilon Euclidean fitness epsilon on the level
+          */
+        inline void
+        addLevel (float leaf_size, double max_correspondence_distance, int max_iterations,
+                  double transformation_epsilon = 0.0,
+                  double euclidean_fitness_epsilon = -std::numeric_limits<double>::max ())
+        {
+          Level level;
+          level.leaf_size = leaf_size;
+          level.max_correspondence_distance = max_correspondence_distance;
+          level.max_iterations = max_iterations;
+          level.transformation_epsilon = transformation_epsilon;
+          level.euclidean_fitness_epsilon = euclidean_fitness_epsilon;
+          addLevel (level);
+        }
+
+        /** \brief Remove all pyramid levels. */
+        inline void
+        clearLevels ()
+        {
+          levels_.clear ();
+          resetPyramids ();
+        }
+
+        /** \brief Get the pyramid levels. */
+        inline const std::vector<Level>&
+        getLevels () const { return (levels_); }
+
+        /** \brief Provide the source cloud; its pyramid is rebuilt on the next call to \ref align.
+          * \param[in] cloud the input point cloud source
+          */
+        inline void
+        setInputSource (const PointCloudSourceConstPtr &cloud)
+        {
+          input_ = cloud;
+          source_pyramid_.clear ();
+          source_trees_.clear ();
+        }
+
+        /** \brief Provide the target cloud; its pyramid is rebuilt on the next call to \ref align.
+          * \param[in] cloud the input point cloud target
+          */
+        inline void
+        setInputTarget (const PointCloudTargetConstPtr &cloud)
+        {
+          target_ = cloud;
+          target_pyramid_.clear ();
+          target_trees_.clear ();
+        }
+
+        /** \brief Get the source cloud of a pyramid level (empty before the first call to \ref align). */
+        inline PointCloudSourceConstPtr
+        getSourceLevel (size_t level) const
+        {
+          return (level < source_pyramid_.size () ? source_pyramid_[level] : PointCloudSourceConstPtr ());
+        }
+
+        /** \brief Get the target cloud of a pyramid level (empty before the first call to \ref align). */
+        inline PointCloudTargetConstPtr
+        getTargetLevel (size_t level) const
+        {
+          return (level < target_pyramid_.size () ? target_pyramid_[level] : PointCloudTargetConstPtr ());
+        }
+
+        /** \brief Run the registration method on every level, from the first to the last one.
+          * \param[out] output the full resolution source, transformed with the final transformation
+          * \param[in] guess the initial guess of the transformation
+          * \return true if the registration converged on the last level
+          */
+        bool
+        align (PointCloudSource &output, const Matrix4 &guess = Matrix4::Identity ());
+
+        /** \brief Get the final transformation estimated by the last call to \ref align. */
+        inline Matrix4
+        getFinalTransformation () const { return (final_transformation_); }
+
+        /** \brief Return the state of convergence after the last call to \ref align. */
+        inline bool
+        hasConverged () const { return (converged_); }
+
+        /** \brief Get the per-level outcome and timing of the last call to \ref align. */
+        inline const std::vector<LevelResult, Eigen::aligned_allocator<LevelResult> >&
+        getLevelResults () const { return (level_results_); }
+
+      protected:
+        /** \brief Drop both pyramids, e.g. after the levels changed. */
+        inline void
+        resetPyramids ()
+        {
+          source_pyramid_.clear ();
+          source_trees_.clear ();
+          target_pyramid_.clear ();
+          target_trees_.clear ();
+        }
+
+        /** \brief Downsample a cloud to the given leaf size, or share it for a non-positive leaf size. */
+        template <typename PointT> static typename pcl::PointCloud<PointT>::ConstPtr
+        downsample (const typename pcl::PointCloud<PointT>::ConstPtr &cloud, float leaf_size);
+
+        /** \brief The registration method run on every level. */
+        RegistrationPtr registration_;
+
+        /** \brief The pyramid levels. */
+        std::vector<Level> levels_;
+
+        /** \brief The full resolution source and target clouds. */
+        PointCloudSourceConstPtr input_;
+        PointCloudTargetConstPtr target_;
+
+        /** \brief The source and target clouds of every level. */
+        std::vector<PointCloudSourceConstPtr> source_pyramid_;
+        std::vector<PointCloudTargetConstPtr> target_pyramid_;
+
+        /** \brief The cached search trees of every level. */
+        std::vector<KdTreeReciprocalPtr> source_trees_;
+        std::vector<KdTreePtr> target_trees_;
+
+        /** \brief The outcome of the last call to \ref align. */
+        std::vector<LevelResult, Eigen::aligned_allocator<LevelResult> > level_results_;
+        Matrix4 final_transformation_;
+        bool converged_;
+
+      public:
+        PCL_MAKE_ALIGNED_OPERATOR_NEW
+    };
+  }
+}
+
+#include <pcl/registration/impl/multi_resolution_registration.hpp>
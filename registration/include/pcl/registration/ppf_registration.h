@@ -48,6 +48,13 @@
 
 namespace pcl
 {
+  /** \brief Discretized lookup table for the point pair features of a model cloud.
+    *
+    * The model pairs are stored in a flat, read-only layout: all (reference, point) index pairs are sorted by their
+    * discretized feature and kept in one contiguous array, so that every bin maps to a contiguous value range
+    * (compressed sparse row). An open addressing table over the distinct bins resolves a query feature to its
+    * range without any pointer chasing.
+    */
   class PCL_EXPORTS PPFHashMapSearch
   {
     public:
@@ -81,6 +88,10 @@ namespace pcl
       using FeatureHashMapTypePtr = boost::shared_ptr<FeatureHashMapType>;
       using Ptr = boost::shared_ptr<PPFHashMapSearch>;
 
+      /** \brief Contiguous range of model (reference, point) index pairs sharing the same discretized feature */
+      using IndexPair = std::pair<unsigned int, unsigned int>;
+      using IndexPairRange = std::pair<const IndexPair*, const IndexPair*>;
+
 
       /** \brief Constructor for the PPFHashMapSearch class which sets the two step parameters for the enclosed data structure
        * \param angle_discretization_step the step value between each bin of the hash map for the angular values
@@ -88,14 +99,21 @@ namespace pcl
        */
       PPFHashMapSearch (float angle_discretization_step = 12.0f / 180.0f * static_cast<float> (M_PI),
                         float distance_discretization_step = 0.01f)
-        : feature_hash_map_ (new FeatureHashMapType)
-        , internals_initialized_ (false)
+        : internals_initialized_ (false)
         , angle_discretization_step_ (angle_discretization_step)
         , distance_discretization_step_ (distance_discretization_step)
         , max_dist_ (-1.0f)
+        , threads_ (1)
       {
       }
 
+      /** \brief Set the number of threads used to discretize the model features.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        * \note Only used if compiled with OpenMP.
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 1);
+
       /** \brief Method that sets the feature cloud to be inserted in the hash map
        * \param feature_cloud a const smart pointer to the PPFSignature feature cloud
        */
@@ -114,6 +132,17 @@ namespace pcl
       nearestNeighborSearch (float &f1, float &f2, float &f3, float &f4,
                              std::vector<std::pair<size_t, size_t> > &indices);
 
+      /** \brief Allocation free variant of nearestNeighborSearch, returning the range of model pairs that fall into
+       * the same bin as the query feature. The range stays valid until the next call to setInputFeatureCloud.
+       * \param[in] f1 The 1st value describing the query PPFSignature feature
+       * \param[in] f2 The 2nd value describing the query PPFSignature feature
+       * \param[in] f3 The 3rd value describing the query PPFSignature feature
+       * \param[in] f4 The 4th value describing the query PPFSignature feature
+       * \return the (possibly empty) range of model (reference, point) index pairs
+       */
+      IndexPairRange
+      nearestNeighborRange (float f1, float f2, float f3, float f4) const;
+
       /** \brief Convenience method for returning a copy of the class instance as a boost::shared_ptr */
       Ptr
       makeShared() { return Ptr (new PPFHashMapSearch (*this)); }
@@ -132,11 +161,39 @@ namespace pcl
 
       std::vector <std::vector <float> > alpha_m_;
     private:
-      FeatureHashMapTypePtr feature_hash_map_;
+      /** \brief Discretize a feature into the key of its bin */
+      inline HashKeyStruct
+      discretize (float f1, float f2, float f3, float f4) const
+      {
+        return (HashKeyStruct (static_cast<int> (std::floor (f1 / angle_discretization_step_)),
+                               static_cast<int> (std::floor (f2 / angle_discretization_step_)),
+                               static_cast<int> (std::floor (f3 / angle_discretization_step_)),
+                               static_cast<int> (std::floor (f4 / distance_discretization_step_))));
+      }
+
+      /** \brief Find the slot of a key in \a bin_keys_, or -1 if the bin is empty */
+      int
+      findBin (const HashKeyStruct &key) const;
+
+      /** \brief Distinct discretized features, sorted */
+      std::vector<HashKeyStruct> bin_keys_;
+
+      /** \brief Offsets of the value range of every bin in \a bin_values_, with one extra end offset */
+      std::vector<unsigned int> bin_offsets_;
+
+      /** \brief Model (reference, point) index pairs, grouped by bin */
+      std::vector<IndexPair> bin_values_;
+
+      /** \brief Open addressing table (power of two size, linear probing) mapping key hashes to bin slots, -1 if free */
+      std::vector<int> bin_table_;
+
       bool internals_initialized_;
 
       float angle_discretization_step_, distance_discretization_step_;
       float max_dist_;
+
+      /** \brief The number of threads used to discretize the model features */
+      unsigned int threads_;
   };
 
   /** \brief Class that registers two point clouds based on their sets of PPFSignatures.
@@ -192,9 +249,22 @@ namespace pcl
       :  Registration<PointSource, PointTarget> (),
          scene_reference_point_sampling_rate_ (5),
          clustering_position_diff_threshold_ (0.01f),
-         clustering_rotation_diff_threshold_ (20.0f / 180.0f * static_cast<float> (M_PI))
+         clustering_rotation_diff_threshold_ (20.0f / 180.0f * static_cast<float> (M_PI)),
+         threads_ (1)
       {}
 
+      /** \brief Set the number of threads used for voting. Every scene reference point votes into its own
+       * accumulator, so the result does not depend on the number of threads.
+       * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+       * \note Only used if compiled with OpenMP.
+       */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 1);
+
+      /** \brief Returns the number of threads used for voting */
+      inline unsigned int
+      getNumberOfThreads () const { return threads_; }
+
       /** \brief Method for setting the position difference clustering parameter
        * \param clustering_position_diff_threshold distance threshold below which two poses are
        * considered close enough to be in the same cluster (for the clustering phase of the algorithm)
@@ -269,6 +339,9 @@ namespace pcl
       /** \brief use a kd-tree with range searches of range max_dist to skip an O(N) pass through the point cloud */
       typename pcl::KdTreeFLANN<PointTarget>::Ptr scene_search_tree_;
 
+      /** \brief The number of threads used for voting */
+      unsigned int threads_;
+
       /** \brief static method used for the std::sort function to order two PoseWithVotes
        * instances by their number of votes*/
       static bool
@@ -49,6 +49,7 @@
 #include <pcl/registration/transformation_estimation.h>
 #include <pcl/registration/correspondence_estimation.h>
 #include <pcl/registration/correspondence_rejection.h>
+#include <pcl/registration/target_cache.h>
 
 namespace pcl
 {
@@ -95,6 +96,10 @@ namespace pcl
       using CorrespondenceEstimationPtr = typename CorrespondenceEstimation::Ptr;
       using CorrespondenceEstimationConstPtr = typename CorrespondenceEstimation::ConstPtr;
 
+      using TargetCache = pcl::registration::TargetCache<PointTarget>;
+      using TargetCachePtr = typename TargetCache::Ptr;
+      using TargetCacheEntryPtr = typename TargetCache::EntryPtr;
+
       /** \brief The callback signature to the function updating intermediate source point cloud position
         * during it's registration to the target point cloud.
         * \param[in] cloud_src - the point cloud which will be updated to match target
@@ -132,6 +137,9 @@ namespace pcl
         , source_cloud_updated_ (true)
         , force_no_recompute_ (false)
         , force_no_recompute_reciprocal_ (false)
+        , target_cache_ ()
+        , target_version_ (0)
+        , target_cache_entry_ ()
         , point_representation_ ()
       {
       }
@@ -264,6 +272,47 @@ namespace pcl
         return (tree_reciprocal_);
       }
 
+      /** \brief Share the target search structures with other registration instances through a cache.
+        * When a cache is set, the target tree is taken from the cache entry of the target cloud and its
+        * version instead of being built by this instance. Pass a null pointer to detach from the cache.
+        * \param[in] cache the cache to use
+        */
+      virtual void
+      setTargetCache (const TargetCachePtr &cache)
+      {
+        // Never modify the shared tree after detaching from the cache
+        if (target_cache_ && !cache)
+          tree_.reset (new KdTree);
+        target_cache_ = cache;
+        target_cache_entry_.reset ();
+        target_cloud_updated_ = true;
+      }
+
+      /** \brief Get the cache of target search structures. */
+      inline TargetCachePtr
+      getTargetCache () const
+      {
+        return (target_cache_);
+      }
+
+      /** \brief Set the version of the target cloud, used as part of the cache key. Bump it whenever
+        * the target cloud is modified in place.
+        * \param[in] version the version of the target cloud
+        */
+      virtual void
+      setTargetVersion (std::uint64_t version)
+      {
+        target_version_ = version;
+        target_cloud_updated_ = true;
+      }
+
+      /** \brief Get the version of the target cloud. */
+      inline std::uint64_t
+      getTargetVersion () const
+      {
+        return (target_version_);
+      }
+
       /** \brief Get the final transformation matrix estimated by the registration method. */
       inline Matrix4
       getFinalTransformation () { return (final_transformation_); }
@@ -580,6 +629,15 @@ namespace pcl
        * will never be recomputed*/
       bool force_no_recompute_reciprocal_;
 
+      /** \brief The cache of target search structures shared with other registration instances, if any. */
+      TargetCachePtr target_cache_;
+
+      /** \brief The version of the target cloud, part of the cache key. */
+      std::uint64_t target_version_;
+
+      /** \brief The cache entry of the current target cloud, valid after initCompute () if a cache is set. */
+      TargetCacheEntryPtr target_cache_entry_;
+
       /** \brief Callback function to update intermediate source point cloud position during it's registration
         * to the target point cloud.
         */
@@ -45,6 +45,8 @@
 #include <pcl/registration/transformation_validation.h>
 #include <pcl/registration/correspondence_rejection_poly.h>
 
+#include <random>
+
 namespace pcl
 {
   /** \brief Pose estimation and alignment class using a prerejective RANSAC routine.
@@ -63,6 +65,11 @@ namespace pcl
    * using \ref setSimilarityThreshold() in [0,1[, where a value of 0 means disabled,
    * and 1 is maximally rejective.
    * 
+   * The hypothesis loop can be distributed over several threads using \ref setNumberOfThreads().
+   * Each thread draws its samples from an independent random number stream derived from
+   * \ref setRandomSeed(), and works on a fixed block of iterations, so that the result is
+   * reproducible for a given seed and number of threads.
+   * 
    * If you use this in academic work, please cite:
    * 
    * A. G. Buch, D. Kraft, J.-K. Kämäräinen, H. G. Petersen and N. Krüger.
@@ -122,6 +129,9 @@ namespace pcl
         , feature_tree_ (new pcl::KdTreeFLANN<FeatureT>)
         , correspondence_rejector_poly_ (new CorrespondenceRejectorPoly)
         , inlier_fraction_ (0.0f)
+        , threads_ (1)
+        , random_seed_ (12345u)
+        , rng_ (random_seed_)
       {
         reg_name_ = "SampleConsensusPrerejective";
         correspondence_rejector_poly_->setSimilarityThreshold (0.6f);
@@ -230,6 +240,38 @@ namespace pcl
         return inlier_fraction_;
       }
       
+      /** \brief Set the number of threads used to generate and verify pose hypotheses.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        * \note Only used if compiled with OpenMP.
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 1);
+
+      /** \brief Get the number of threads used to generate and verify pose hypotheses. */
+      inline unsigned int
+      getNumberOfThreads () const
+      {
+        return (threads_);
+      }
+
+      /** \brief Set the seed of the random number generators used for sampling. Every thread uses its own
+        * random number stream derived from this seed.
+        * \param[in] seed the random seed
+        */
+      inline void
+      setRandomSeed (unsigned int seed)
+      {
+        random_seed_ = seed;
+        rng_.seed (seed);
+      }
+
+      /** \brief Get the seed of the random number generators used for sampling. */
+      inline unsigned int
+      getRandomSeed () const
+      {
+        return (random_seed_);
+      }
+
       /** \brief Get the inlier indices of the source point cloud under the final transformation
        * @return inlier indices
        */
@@ -240,13 +282,27 @@ namespace pcl
       }
 
     protected:
+      /** \brief The random number engine used by each hypothesis generation thread. */
+      using RandomEngine = std::mt19937;
+
       /** \brief Choose a random index between 0 and n-1
         * \param n the number of possible indices to choose from
         */
       inline int 
-      getRandomIndex (int n) const
+      getRandomIndex (int n)
       {
-        return (static_cast<int> (n * (rand () / (RAND_MAX + 1.0))));
+        return (getRandomIndex (n, rng_));
+      };
+
+      /** \brief Choose a random index between 0 and n-1
+        * \param[in] n the number of possible indices to choose from
+        * \param[in,out] rng the random number engine to draw from
+        */
+      inline int
+      getRandomIndex (int n, RandomEngine &rng) const
+      {
+        return (static_cast<int> (n * (static_cast<double> (rng () - RandomEngine::min ()) /
+                                       (static_cast<double> (RandomEngine::max () - RandomEngine::min ()) + 1.0))));
       };
       
       /** \brief Select \a nr_samples sample points from cloud while making sure that their pairwise distances are 
@@ -256,7 +312,20 @@ namespace pcl
         * \param sample_indices the resulting sample indices
         */
       void 
-      selectSamples (const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices);
+      selectSamples (const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices)
+      {
+        selectSamples (cloud, nr_samples, sample_indices, rng_);
+      }
+
+      /** \brief Select \a nr_samples sample points from cloud, drawing from the given random number engine.
+        * \param[in] cloud the input point cloud
+        * \param[in] nr_samples the number of samples to select
+        * \param[out] sample_indices the resulting sample indices
+        * \param[in,out] rng the random number engine to draw from
+        */
+      void
+      selectSamples (const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices,
+                     RandomEngine &rng) const;
 
       /** \brief For each of the sample points, find a list of points in the target cloud whose features are similar to 
         * the sample points' features. From these, select one randomly which will be considered that sample point's 
@@ -268,7 +337,25 @@ namespace pcl
       void 
       findSimilarFeatures (const std::vector<int> &sample_indices,
               std::vector<std::vector<int> >& similar_features,
-              std::vector<int> &corresponding_indices);
+              std::vector<int> &corresponding_indices)
+      {
+        findSimilarFeatures (sample_indices, similar_features, corresponding_indices, rng_);
+      }
+
+      /** \brief For each of the sample points, select one of its similar target features at random, drawing from
+        * the given random number engine.
+        * \param[in] sample_indices the indices of each sample point
+        * \param[in,out] similar_features correspondence cache, which is used to read/write already computed correspondences
+        * \param[out] corresponding_indices the resulting indices of each sample's corresponding point in the target cloud
+        * \param[in,out] rng the random number engine to draw from
+        * \note The cache is only read if all entries of \a sample_indices have been computed already, which makes
+        * this method safe to call concurrently on a precomputed cache.
+        */
+      void
+      findSimilarFeatures (const std::vector<int> &sample_indices,
+              std::vector<std::vector<int> >& similar_features,
+              std::vector<int> &corresponding_indices,
+              RandomEngine &rng) const;
 
       /** \brief Rigid transformation computation method.
         * \param output the transformed input point cloud dataset using the rigid transformation found
@@ -288,6 +375,19 @@ namespace pcl
       void 
       getFitness (std::vector<int>& inliers, float& fitness_score);
 
+      /** \brief Obtain the fitness of an arbitrary transformation. The source points are transformed and
+        * verified in blocks, and verification stops as soon as more than \a max_outliers points fall outside
+        * \b corr_dist_threshold_, since the hypothesis can then no longer reach the required inlier fraction.
+        * \param[in] transformation the transformation to evaluate
+        * \param[in] max_outliers the maximum number of outliers before the evaluation is aborted
+        * \param[out] inliers indices of source point cloud inliers
+        * \param[out] fitness_score output fitness score as MSE of the inliers
+        * \return false if the evaluation was aborted early, true otherwise
+        */
+      bool
+      getFitness (const Matrix4 &transformation, int max_outliers,
+                  std::vector<int>& inliers, float& fitness_score) const;
+
       /** \brief The source point cloud's feature descriptors. */
       FeatureCloudConstPtr input_features_;
 
@@ -311,6 +411,15 @@ namespace pcl
       
       /** \brief Inlier points of final transformation as indices into source */
       std::vector<int> inliers_;
+
+      /** \brief The number of threads used to generate and verify pose hypotheses. */
+      unsigned int threads_;
+
+      /** \brief The seed of the random number generators used for sampling. */
+      unsigned int random_seed_;
+
+      /** \brief The random number engine used by the single-threaded sampling helpers. */
+      RandomEngine rng_;
   };
 }
 
@@ -0,0 +1,228 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2019-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/search/kdtree.h>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+
+namespace pcl
+{
+  namespace registration
+  {
+    /** \brief Cache of the search structures built on registration target clouds.
+      *
+      * Entries are keyed by the identity of the target cloud (its address) and a user supplied version, which
+      * should be bumped whenever the cloud is modified in place. Each entry owns a built search tree, and
+      * lazily collects per-point data derived from the target: surface normals, and the point covariances
+      * used by GeneralizedIterativeClosestPoint. A cache can be attached to any number of @ref Registration
+      * instances (see Registration::setTargetCache), also from different threads; all methods are thread-safe
+      * and the shared search trees are only used for read-only queries.
+      *
+      * \code
+      * TargetCache<PointXYZ>::Ptr cache (new TargetCache<PointXYZ>);
+      * icp_a.setTargetCache (cache);
+      * icp_b.setTargetCache (cache);
+      * icp_a.setInputTarget (map);
+      * icp_b.setInputTarget (map);   // reuses the tree built for icp_a
+      * \endcode
+      *
+      * \note Once attached to a cache, a registration instance never modifies the shared tree; a point
+      * representation set through Registration::setPointRepresentation is therefore ignored.
+      * \ingroup registration
+      */
+    template <typename PointT>
+    class TargetCache
+    {
+      public:
+        using Ptr = boost::shared_ptr<TargetCache<PointT> >;
+        using ConstPtr = boost::shared_ptr<const TargetCache<PointT> >;
+
+        using PointCloud = pcl::PointCloud<PointT>;
+        using PointCloudConstPtr = typename PointCloud::ConstPtr;
+
+        using KdTree = pcl::search::KdTree<PointT>;
+        using KdTreePtr = typename KdTree::Ptr;
+
+        using NormalCloud = pcl::PointCloud<pcl::Normal>;
+        using NormalCloudConstPtr = NormalCloud::ConstPtr;
+
+        using MatricesVector = std::vector<Eigen::Matrix3d, Eigen::aligned_allocator<Eigen::Matrix3d> >;
+        using MatricesVectorPtr = boost::shared_ptr<MatricesVector>;
+
+        /** \brief Search structures and derived data of one version of a target cloud. */
+        class Entry
+        {
+          public:
+            using Ptr = boost::shared_ptr<Entry>;
+
+            /** \brief Build the search tree of a target cloud. */
+            Entry (const PointCloudConstPtr &cloud, std::uint64_t version);
+
+            /** \brief Get the target cloud. */
+            inline PointCloudConstPtr
+            getCloud () const { return (cloud_); }
+
+            /** \brief Get the version of the target cloud. */
+            inline std::uint64_t
+            getVersion () const { return (version_); }
+
+            /** \brief Get the search tree built on the target cloud. */
+            inline KdTreePtr
+            getSearchMethod () const { return (tree_); }
+
+            /** \brief Get the surface normals of the target cloud, estimated from \a k nearest neighbors. They are
+              * computed on first request and shared afterwards.
+              * \param[in] k the number of neighbors used for normal estimation
+              */
+            NormalCloudConstPtr
+            getNormals (int k);
+
+            /** \brief Get previously stored point covariances, or a null pointer if none were stored yet.
+              * \param[in] k the number of neighbors the covariances were computed from
+              * \param[in] epsilon the regularization of the smallest eigenvalue
+              */
+            MatricesVectorPtr
+            getCovariances (int k, double epsilon) const;
+
+            /** \brief Store point covariances, unless another thread stored them first.
+              * \param[in] k the number of neighbors the covariances were computed from
+              * \param[in] epsilon the regularization of the smallest eigenvalue
+              * \param[in] covariances the covariances, which must not be modified afterwards
+              * \return the covariances held by the entry
+              */
+            MatricesVectorPtr
+            setCovariances (int k, double epsilon, const MatricesVectorPtr &covariances);
+
+          private:
+            PointCloudConstPtr cloud_;
+            std::uint64_t version_;
+            KdTreePtr tree_;
+
+            /** \brief Guards the lazily computed data below. */
+            mutable std::mutex mutex_;
+            std::map<int, NormalCloudConstPtr> normals_;
+            std::map<std::pair<int, double>, MatricesVectorPtr> covariances_;
+        };
+        using EntryPtr = typename Entry::Ptr;
+
+        /** \brief Constructor.
+          * \param[in] max_entries the maximum number of cached target clouds; the least recently used one is evicted
+          */
+        TargetCache (size_t max_entries = 4)
+          : max_entries_ (max_entries)
+          , hits_ (0)
+          , misses_ (0)
+        {}
+
+        /** \brief Get the entry of a target cloud, building its search tree if it is not cached yet.
+          * \param[in] cloud the target cloud
+          * \param[in] version the version of the target cloud
+          */
+        EntryPtr
+        get (const PointCloudConstPtr &cloud, std::uint64_t version = 0);
+
+        /** \brief Check whether a version of a target cloud is cached. */
+        bool
+        contains (const PointCloudConstPtr &cloud, std::uint64_t version = 0) const;
+
+        /** \brief Remove all versions of a target cloud from the cache. */
+        void
+        erase (const PointCloudConstPtr &cloud);
+
+        /** \brief Remove all entries. */
+        void
+        clear ();
+
+        /** \brief Get the number of cached entries. */
+        size_t
+        size () const;
+
+        /** \brief Set the maximum number of cached target clouds. */
+        void
+        setMaxEntries (size_t max_entries);
+
+        /** \brief Get the maximum number of cached target clouds. */
+        inline size_t
+        getMaxEntries () const
+        {
+          std::lock_guard<std::mutex> lock (mutex_);
+          return (max_entries_);
+        }
+
+        /** \brief Get the number of calls to \ref get that found a cached entry. */
+        inline size_t
+        getHits () const
+        {
+          std::lock_guard<std::mutex> lock (mutex_);
+          return (hits_);
+        }
+
+        /** \brief Get the number of calls to \ref get that had to build a new entry. */
+        inline size_t
+        getMisses () const
+        {
+          std::lock_guard<std::mutex> lock (mutex_);
+          return (misses_);
+        }
+
+      private:
+        /** \brief Find an entry and mark it as most recently used; the mutex must be held. */
+        EntryPtr
+        find (const PointCloud *cloud, std::uint64_t version);
+
+        /** \brief Drop least recently used entries beyond the capacity; the mutex must be held. */
+        void
+        evict ();
+
+        size_t max_entries_;
+        size_t hits_, misses_;
+
+        /** \brief Entries, most recently used first. */
+        std::list<EntryPtr> entries_;
+
+        mutable std::mutex mutex_;
+    };
+  }
+}
+
+#include <pcl/registration/impl/target_cache.hpp>
@@ -42,6 +42,7 @@
 
 #include <pcl/registration/transformation_estimation.h>
 #include <pcl/registration/warp_point_rigid.h>
+#include <pcl/registration/lls_accumulation.h>
 #include <pcl/cloud_iterator.h>
 
 namespace pcl
@@ -68,7 +69,11 @@ namespace pcl
 
         using Matrix4 = typename TransformationEstimation<PointSource, PointTarget, Scalar>::Matrix4;
         
-        TransformationEstimationPointToPlaneLLS () {};
+        TransformationEstimationPointToPlaneLLS ()
+          : threads_ (1)
+          , robust_kernel_ (ROBUST_KERNEL_NONE)
+          , robust_kernel_scale_ (1.0)
+        {};
         ~TransformationEstimationPointToPlaneLLS () {};
 
         /** \brief Estimate a rigid rotation transformation between a source and a target point cloud using SVD.
@@ -123,6 +128,35 @@ namespace pcl
             const pcl::Correspondences &correspondences,
             Matrix4 &transformation_matrix) const override;
 
+        /** \brief Set the number of threads used to accumulate the normal equations. A single thread is used by default.
+          * \param[in] nr_threads the number of hardware threads to use (0 uses all available processors)
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads);
+
+        /** \brief Get the number of threads used to accumulate the normal equations. */
+        inline unsigned int
+        getNumberOfThreads () const { return (threads_); }
+
+        /** \brief Set the robust kernel used to reweight the point-to-plane residuals.
+          * \param[in] kernel the robust kernel type (ROBUST_KERNEL_NONE disables the reweighting)
+          * \param[in] scale the kernel scale, i.e. the residual (in meters) beyond which a correspondence gets downweighted
+          */
+        inline void
+        setRobustKernel (RobustKernelType kernel, double scale = 1.0)
+        {
+          robust_kernel_ = kernel;
+          robust_kernel_scale_ = scale;
+        }
+
+        /** \brief Get the robust kernel type. */
+        inline RobustKernelType
+        getRobustKernel () const { return (robust_kernel_); }
+
+        /** \brief Get the robust kernel scale. */
+        inline double
+        getRobustKernelScale () const { return (robust_kernel_scale_); }
+
       protected:
         
         /** \brief Estimate a rigid rotation transformation between a source and a target
@@ -149,6 +183,14 @@ namespace pcl
                                        const double & tx,    const double & ty,   const double & tz,
                                        Matrix4 &transformation_matrix) const;
 
+        /** \brief The number of threads the scheduler should use, 1 by default. */
+        unsigned int threads_;
+
+        /** \brief The robust kernel used to weight the residuals. */
+        RobustKernelType robust_kernel_;
+
+        /** \brief The scale of the robust kernel. */
+        double robust_kernel_scale_;
     };
   }
 }
@@ -39,6 +39,7 @@
 
 #include <pcl/registration/transformation_estimation.h>
 #include <pcl/registration/warp_point_rigid.h>
+#include <pcl/registration/lls_accumulation.h>
 #include <pcl/cloud_iterator.h>
 
 namespace pcl
@@ -52,6 +53,9 @@ namespace pcl
       *   "Linear Least-Squares Optimization for Point-to-Plane ICP Surface Registration", Kok-Lim Low, 2004
       *   "A Symmetric Objective Function for ICP", Szymon Rusinkiewicz, 2019
       *
+      * As in TransformationEstimationPointToPlaneLLS, the normal equations can be accumulated in parallel and
+      * the residuals reweighted with a robust kernel.
+      *
       * \note The class is templated on the source and target point types as well as on the output scalar of the
       * transformation matrix (i.e., float or double). Default: float.
       * \author Matthew Cong
@@ -67,7 +71,12 @@ namespace pcl
         using Matrix4 = typename TransformationEstimation<PointSource, PointTarget, Scalar>::Matrix4;
         using Vector6 = Eigen::Matrix<Scalar, 6, 1>;
         
-        TransformationEstimationSymmetricPointToPlaneLLS () : enforce_same_direction_normals_ (true) {};
+        TransformationEstimationSymmetricPointToPlaneLLS ()
+          : enforce_same_direction_normals_ (true)
+          , threads_ (1)
+          , robust_kernel_ (ROBUST_KERNEL_NONE)
+          , robust_kernel_scale_ (1.0)
+        {};
         ~TransformationEstimationSymmetricPointToPlaneLLS () {};
 
         /** \brief Estimate a rigid rotation transformation between a source and a target point cloud using SVD.
@@ -132,6 +141,35 @@ namespace pcl
         inline bool
         getEnforceSameDirectionNormals ();
 
+        /** \brief Set the number of threads used to accumulate the normal equations. A single thread is used by default.
+          * \param[in] nr_threads the number of hardware threads to use (0 uses all available processors)
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads);
+
+        /** \brief Get the number of threads used to accumulate the normal equations. */
+        inline unsigned int
+        getNumberOfThreads () const { return (threads_); }
+
+        /** \brief Set the robust kernel used to reweight the symmetric point-to-plane residuals.
+          * \param[in] kernel the robust kernel type (ROBUST_KERNEL_NONE disables the reweighting)
+          * \param[in] scale the kernel scale, i.e. the residual beyond which a correspondence gets downweighted
+          */
+        inline void
+        setRobustKernel (RobustKernelType kernel, double scale = 1.0)
+        {
+          robust_kernel_ = kernel;
+          robust_kernel_scale_ = scale;
+        }
+
+        /** \brief Get the robust kernel type. */
+        inline RobustKernelType
+        getRobustKernel () const { return (robust_kernel_); }
+
+        /** \brief Get the robust kernel scale. */
+        inline double
+        getRobustKernelScale () const { return (robust_kernel_scale_); }
+
       protected:
         
         /** \brief Estimate a rigid rotation transformation between a source and a target
@@ -155,6 +193,14 @@ namespace pcl
       /** \brief Whether or not to negate source and/or target normals such that they point in the same direction */
         bool enforce_same_direction_normals_;
 
+        /** \brief The number of threads the scheduler should use, 1 by default. */
+        unsigned int threads_;
+
+        /** \brief The robust kernel used to weight the residuals. */
+        RobustKernelType robust_kernel_;
+
+        /** \brief The scale of the robust kernel. */
+        double robust_kernel_scale_;
     };
   }
 }
@@ -46,37 +46,139 @@
 //PCL_INSTANTIATE_PRODUCT(PPFRegistration, (PCL_XYZ_POINT_TYPES)(PCL_NORMAL_POINT_TYPES));
 //#endif    // PCL_NO_PRECOMPILE
 
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PPFHashMapSearch::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
 void
 pcl::PPFHashMapSearch::setInputFeatureCloud (PointCloud<PPFSignature>::ConstPtr feature_cloud)
 {
-  // Discretize the feature cloud and insert it in the hash map
-  feature_hash_map_->clear ();
-  unsigned int n = static_cast<unsigned int> (std::sqrt (static_cast<float> (feature_cloud->points.size ())));
-  int d1, d2, d3, d4;
-  max_dist_ = -1.0;
+  struct BinEntry
+  {
+    HashKeyStruct key;
+    IndexPair pair;
+
+    bool
+    operator< (const BinEntry &other) const
+    {
+      return (key < other.key || (key == other.key && pair < other.pair));
+    }
+  };
+
+  const int n = static_cast<int> (std::sqrt (static_cast<float> (feature_cloud->points.size ())));
+  std::vector<BinEntry> entries (static_cast<size_t> (n) * n);
   alpha_m_.resize (n);
-  for (size_t i = 0; i < n; ++i)
+
+  // Discretize the feature cloud, one model reference point per task
+#ifdef _OPENMP
+#pragma omp parallel for shared (entries, feature_cloud) num_threads (threads_) schedule (dynamic, 16)
+#endif
+  for (int i = 0; i < n; ++i)
   {
     std::vector <float> alpha_m_row (n);
-    for (size_t j = 0; j < n; ++j)
+    for (int j = 0; j < n; ++j)
+    {
+      const size_t idx = static_cast<size_t> (i) * n + j;
+      const PPFSignature &feature = feature_cloud->points[idx];
+      entries[idx].key = discretize (feature.f1, feature.f2, feature.f3, feature.f4);
+      entries[idx].pair = IndexPair (i, j);
+      alpha_m_row[j] = feature.alpha_m;
+    }
+    alpha_m_[i].swap (alpha_m_row);
+  }
+
+  max_dist_ = -1.0;
+  for (size_t idx = 0; idx < entries.size (); ++idx)
+    if (max_dist_ < feature_cloud->points[idx].f4)
+      max_dist_ = feature_cloud->points[idx].f4;
+
+  // Group the pairs by bin into one contiguous array
+  std::sort (entries.begin (), entries.end ());
+
+  bin_keys_.clear ();
+  bin_offsets_.clear ();
+  bin_values_.resize (entries.size ());
+  for (size_t idx = 0; idx < entries.size (); ++idx)
+  {
+    if (idx == 0 || !(entries[idx].key == entries[idx - 1].key))
     {
-      d1 = static_cast<int> (std::floor (feature_cloud->points[i*n+j].f1 / angle_discretization_step_));
-      d2 = static_cast<int> (std::floor (feature_cloud->points[i*n+j].f2 / angle_discretization_step_));
-      d3 = static_cast<int> (std::floor (feature_cloud->points[i*n+j].f3 / angle_discretization_step_));
-      d4 = static_cast<int> (std::floor (feature_cloud->points[i*n+j].f4 / distance_discretization_step_));
-      feature_hash_map_->insert (std::pair<HashKeyStruct, std::pair<size_t, size_t> > (HashKeyStruct (d1, d2, d3, d4), std::pair<size_t, size_t> (i, j)));
-      alpha_m_row [j] = feature_cloud->points[i*n + j].alpha_m;
-
-      if (max_dist_ < feature_cloud->points[i*n + j].f4)
-        max_dist_ = feature_cloud->points[i*n + j].f4;
+      bin_keys_.push_back (entries[idx].key);
+      bin_offsets_.push_back (static_cast<unsigned int> (idx));
     }
-    alpha_m_[i] = alpha_m_row;
+    bin_values_[idx] = entries[idx].pair;
+  }
+  bin_offsets_.push_back (static_cast<unsigned int> (entries.size ()));
+
+  // Index the distinct bins in an open addressing table with a load factor of at most 0.5
+  size_t table_size = 1;
+  while (table_size < 2 * bin_keys_.size ())
+    table_size <<= 1;
+  bin_table_.assign (table_size, -1);
+  const size_t mask = table_size - 1;
+  for (size_t bin = 0; bin < bin_keys_.size (); ++bin)
+  {
+    size_t slot = HashKeyStruct () (bin_keys_[bin]) * 0x9E3779B1u & mask;
+    while (bin_table_[slot] != -1)
+      slot = (slot + 1) & mask;
+    bin_table_[slot] = static_cast<int> (bin);
   }
 
   internals_initialized_ = true;
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PPFHashMapSearch::findBin (const HashKeyStruct &key) const
+{
+  const size_t mask = bin_table_.size () - 1;
+  size_t slot = HashKeyStruct () (key) * 0x9E3779B1u & mask;
+  while (bin_table_[slot] != -1)
+  {
+    if (bin_keys_[bin_table_[slot]] == key)
+      return (bin_table_[slot]);
+    slot = (slot + 1) & mask;
+  }
+  return (-1);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+pcl::PPFHashMapSearch::IndexPairRange
+pcl::PPFHashMapSearch::nearestNeighborRange (float f1, float f2, float f3, float f4) const
+{
+  if (!internals_initialized_)
+  {
+    PCL_ERROR("[pcl::PPFRegistration::nearestNeighborRange]: input feature cloud has not been set - skipping search!\n");
+    return (IndexPairRange (nullptr, nullptr));
+  }
+
+  const int bin = findBin (discretize (f1, f2, f3, f4));
+  if (bin < 0)
+    return (IndexPairRange (nullptr, nullptr));
+
+  const IndexPair *values = bin_values_.data ();
+  return (IndexPairRange (values + bin_offsets_[bin], values + bin_offsets_[bin + 1]));
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 void
 pcl::PPFHashMapSearch::nearestNeighborSearch (float &f1, float &f2, float &f3, float &f4,
@@ -88,15 +190,8 @@ pcl::PPFHashMapSearch::nearestNeighborSearch (float &f1, float &f2, float &f3, f
     return;
   }
 
-  int d1 = static_cast<int> (std::floor (f1 / angle_discretization_step_)),
-      d2 = static_cast<int> (std::floor (f2 / angle_discretization_step_)),
-      d3 = static_cast<int> (std::floor (f3 / angle_discretization_step_)),
-      d4 = static_cast<int> (std::floor (f4 / distance_discretization_step_));
-
   indices.clear ();
-  HashKeyStruct key = HashKeyStruct (d1, d2, d3, d4);
-  auto map_iterator_pair = feature_hash_map_->equal_range (key);
-  for (; map_iterator_pair.first != map_iterator_pair.second; ++ map_iterator_pair.first)
-    indices.emplace_back(map_iterator_pair.first->second.first,
-                                                  map_iterator_pair.first->second.second);
+  const IndexPairRange range = nearestNeighborRange (f1, f2, f3, f4);
+  for (const IndexPair *it = range.first; it != range.second; ++it)
+    indices.emplace_back (it->first, it->second);
 }
@@ -57,9 +57,6 @@ pcl::LeastMedianSquares<PointT>::computeModel (int debug_verbosity_level)
   iterations_ = 0;
   double d_best_penalty = std::numeric_limits<double>::max();
 
-  std::vector<int> best_model;
-  std::vector<int> selection;
-  Eigen::VectorXf model_coefficients;
   std::vector<double> distances;
 
   int n_inliers_count = 0;
@@ -67,66 +64,89 @@ pcl::LeastMedianSquares<PointT>::computeModel (int debug_verbosity_level)
   unsigned skipped_count = 0;
   // suppress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
   const unsigned max_skip = max_iterations_ * 10;
+
+  // Hypotheses are drawn in batches, scored in parallel and then processed in order, exactly as a
+  // sequential loop would (the batch only holds one hypothesis when running single threaded)
+  const int batch_size = getHypothesisBatchSize ();
+  std::vector<std::vector<int> > selections;
+  std::vector<Eigen::VectorXf> coefficients (batch_size);
+  std::vector<double> penalties (batch_size);
+  std::vector<char> valid (batch_size);
+  const size_t nr_indices = sac_model_->getIndices ()->size ();
   
   // Iterate
-  while (iterations_ < max_iterations_ && skipped_count < max_skip)
+  bool done = false;
+  while (!done && iterations_ < max_iterations_ && skipped_count < max_skip)
   {
     // Get X samples which satisfy the model criteria
-    sac_model_->getSamples (iterations_, selection);
-
-    if (selection.empty ()) break;
-
-    // Search for inliers in the point cloud for the current plane model M
-    if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
-    {
-      //iterations_++;
-      ++skipped_count;
-      continue;
-    }
-
-    double d_cur_penalty = 0;
-    // d_cur_penalty = sum (min (dist, threshold))
+    const int nr_samples = drawSamples (batch_size, selections);
 
-    // Iterate through the 3d points and calculate the distances from them to the model
-    sac_model_->getDistancesToModel (model_coefficients, distances);
-    
-    // No distances? The model must not respect the user given constraints
-    if (distances.empty ())
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) num_threads(batch_size) firstprivate(distances) if (nr_samples > 1)
+#endif
+    for (int b = 0; b < nr_samples; ++b)
     {
-      //iterations_++;
-      ++skipped_count;
-      continue;
+      valid[b] = false;
+
+      // Search for inliers in the point cloud for the current plane model M
+      if (!sac_model_->computeModelCoefficients (selections[b], coefficients[b]))
+        continue;
+
+      // Iterate through the 3d points and calculate the distances from them to the model
+      sac_model_->getDistancesToModel (coefficients[b], distances);
+
+      // No distances? The model must not respect the user given constraints
+      if (distances.empty ())
+        continue;
+
+      // d_cur_penalty = median (distances)
+      size_t mid = nr_indices / 2;
+      if (mid >= distances.size ())
+        continue;
+
+      // Only the middle element(s) are needed, a full sort is not
+      std::nth_element (distances.begin (), distances.begin () + mid, distances.end ());
+      const double d_mid = distances[mid];
+
+      // Do we have a "middle" point or should we "estimate" one ?
+      if (nr_indices % 2 == 0)
+      {
+        const double d_mid_1 = *std::max_element (distances.begin (), distances.begin () + mid);
+        penalties[b] = (sqrt (d_mid_1) + sqrt (d_mid)) / 2;
+      }
+      else
+        penalties[b] = sqrt (d_mid);
+      valid[b] = true;
     }
 
-    std::sort (distances.begin (), distances.end ());
-    // d_cur_penalty = median (distances)
-    size_t mid = sac_model_->getIndices ()->size () / 2;
-    if (mid >= distances.size ())
+    for (int b = 0; b < nr_samples && !done; ++b)
     {
-      //iterations_++;
-      ++skipped_count;
-      continue;
-    }
-
-    // Do we have a "middle" point or should we "estimate" one ?
-    if (sac_model_->getIndices ()->size () % 2 == 0)
-      d_cur_penalty = (sqrt (distances[mid-1]) + sqrt (distances[mid])) / 2;
-    else
-      d_cur_penalty = sqrt (distances[mid]);
-
-    // Better match ?
-    if (d_cur_penalty < d_best_penalty)
-    {
-      d_best_penalty = d_cur_penalty;
-
-      // Save the current model/coefficients selection as being the best so far
-      model_              = selection;
-      model_coefficients_ = model_coefficients;
+      if (!valid[b])
+      {
+        //iterations_++;
+        ++skipped_count;
+        done = skipped_count >= max_skip;
+        continue;
+      }
+
+      // Better match ?
+      if (penalties[b] < d_best_penalty)
+      {
+        d_best_penalty = penalties[b];
+
+        // Save the current model/coefficients selection as being the best so far
+        model_              = selections[b];
+        model_coefficients_ = coefficients[b];
+      }
+
+      ++iterations_;
+      if (debug_verbosity_level > 1)
+        PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, max_iterations_, d_best_penalty);
+      done = !(iterations_ < max_iterations_);
     }
 
-    ++iterations_;
-    if (debug_verbosity_level > 1)
-      PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, max_iterations_, d_best_penalty);
+    if (nr_samples < batch_size)
+      break;
   }
 
   if (model_.empty ())
@@ -58,74 +58,120 @@ pcl::MEstimatorSampleConsensus<PointT>::computeModel (int debug_verbosity_level)
   double d_best_penalty = std::numeric_limits<double>::max();
   double k = 1.0;
 
-  std::vector<int> best_model;
-  std::vector<int> selection;
-  Eigen::VectorXf model_coefficients;
   std::vector<double> distances;
 
   int n_inliers_count = 0;
   unsigned skipped_count = 0;
   // suppress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
   const unsigned max_skip = max_iterations_ * 10;
+
+  // Hypotheses are drawn in batches, scored in parallel and then processed in order, exactly as a
+  // sequential loop would (the batch only holds one hypothesis when running single threaded)
+  const int batch_size = getHypothesisBatchSize ();
+  std::vector<std::vector<int> > selections;
+  std::vector<Eigen::VectorXf> coefficients (batch_size);
+  std::vector<double> penalties (batch_size);
+  std::vector<int> inlier_counts (batch_size);
+  std::vector<char> valid (batch_size), has_distances (batch_size), passed (batch_size);
+  std::vector<std::size_t> offsets (batch_size), nr_tested (batch_size), nr_consistent (batch_size);
+
+  initPreemptiveTest ();
   
   // Iterate
-  while (iterations_ < k && skipped_count < max_skip)
+  bool done = false;
+  while (!done && iterations_ < k && skipped_count < max_skip)
   {
     // Get X samples which satisfy the model criteria
-    sac_model_->getSamples (iterations_, selection);
-
-    if (selection.empty ()) break;
-
-    // Search for inliers in the point cloud for the current plane model M
-    if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
-    {
-      //iterations_++;
-      ++ skipped_count;
-      continue;
-     }
-
-    double d_cur_penalty = 0;
-    // Iterate through the 3d points and calculate the distances from them to the model
-    sac_model_->getDistancesToModel (model_coefficients, distances);
-    
-    if (distances.empty () && k > 1.0)
-      continue;
-
-    for (const double &distance : distances)
-      d_cur_penalty += (std::min) (distance, threshold_);
-
-    // Better match ?
-    if (d_cur_penalty < d_best_penalty)
+    const int nr_samples = drawSamples (batch_size, selections);
+
+    // Pre-verify the hypotheses once a first model is known, the random points are drawn in order as well
+    const bool preemptive = isPreemptiveTestActive () && d_best_penalty < std::numeric_limits<double>::max ();
+    if (preemptive)
+      for (int b = 0; b < nr_samples; ++b)
+        offsets[b] = drawPreemptiveOffset ();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) num_threads(batch_size) firstprivate(distances) if (nr_samples > 1)
+#endif
+    for (int b = 0; b < nr_samples; ++b)
     {
-      d_best_penalty = d_cur_penalty;
+      // Search for inliers in the point cloud for the current plane model M
+      valid[b] = sac_model_->computeModelCoefficients (selections[b], coefficients[b]);
+      if (!valid[b])
+        continue;
 
-      // Save the current model/coefficients selection as being the best so far
-      model_              = selection;
-      model_coefficients_ = model_coefficients;
+      passed[b] = !preemptive || preemptiveTestPasses (coefficients[b], offsets[b], nr_tested[b], nr_consistent[b]);
+      if (!passed[b])
+        continue;
 
-      n_inliers_count = 0;
-      // Need to compute the number of inliers for this model to adapt k
+      // Iterate through the 3d points and calculate the distances from them to the model
+      sac_model_->getDistancesToModel (coefficients[b], distances);
+      has_distances[b] = !distances.empty ();
+
+      double d_cur_penalty = 0;
+      int n_cur_inliers_count = 0;
       for (const double &distance : distances)
+      {
+        d_cur_penalty += (std::min) (distance, threshold_);
         if (distance <= threshold_)
-          ++n_inliers_count;
-
-      // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
-      double w = static_cast<double> (n_inliers_count) / static_cast<double> (sac_model_->getIndices ()->size ());
-      double p_no_outliers = 1.0 - pow (w, static_cast<double> (selection.size ()));
-      p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
-      p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
-      k = std::log (1.0 - probability_) / std::log (p_no_outliers);
+          ++n_cur_inliers_count;
+      }
+      penalties[b] = d_cur_penalty;
+      inlier_counts[b] = n_cur_inliers_count;
     }
 
-    ++iterations_;
-    if (debug_verbosity_level > 1)
-      PCL_DEBUG ("[pcl::MEstimatorSampleConsensus::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, static_cast<int> (std::ceil (k)), d_best_penalty);
-    if (iterations_ > max_iterations_)
+    for (int b = 0; b < nr_samples && !done; ++b)
     {
-      if (debug_verbosity_level > 0)
-        PCL_DEBUG ("[pcl::MEstimatorSampleConsensus::computeModel] MSAC reached the maximum number of trials.\n");
-      break;
+      if (!valid[b])
+      {
+        //iterations_++;
+        ++ skipped_count;
+        done = skipped_count >= max_skip;
+        continue;
+      }
+
+      if (preemptive)
+        updatePreemptiveTest (passed[b], nr_tested[b], nr_consistent[b]);
+
+      if (passed[b] && !has_distances[b] && k > 1.0)
+        continue;
+
+      // Better match ?
+      if (passed[b] && penalties[b] < d_best_penalty)
+      {
+        d_best_penalty = penalties[b];
+
+        // Save the current model/coefficients selection as being the best so far
+        model_              = selections[b];
+        model_coefficients_ = coefficients[b];
+
+        // Need the number of inliers for this model to adapt k
+        n_inliers_count = inlier_counts[b];
+
+        // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
+        double w = static_cast<double> (n_inliers_count) / static_cast<double> (sac_model_->getIndices ()->size ());
+        setPreemptiveInlierRatio (w);
+        double p_no_outliers = 1.0 - pow (w, static_cast<double> (selections[b].size ())) * getPreemptiveAcceptanceProbability (w);
+        p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
+        p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
+        k = std::log (1.0 - probability_) / std::log (p_no_outliers);
+      }
+
+      ++iterations_;
+      if (debug_verbosity_level > 1)
+        PCL_DEBUG ("[pcl::MEstimatorSampleConsensus::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, static_cast<int> (std::ceil (k)), d_best_penalty);
+      if (iterations_ > max_iterations_)
+      {
+        if (debug_verbosity_level > 0)
+          PCL_DEBUG ("[pcl::MEstimatorSampleConsensus::computeModel] MSAC reached the maximum number of trials.\n");
+        done = true;
+      }
+      else
+        done = !(iterations_ < k);
     }
+
+    if (nr_samples < batch_size)
+      break;
   }
 
   if (model_.empty ())
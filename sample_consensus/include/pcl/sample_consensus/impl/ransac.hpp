@@ -58,66 +58,97 @@ pcl::RandomSampleConsensus<PointT>::computeModel (int)
   int n_best_inliers_count = -INT_MAX;
   double k = 1.0;
 
-  std::vector<int> selection;
-  Eigen::VectorXf model_coefficients;
-
   double log_probability  = std::log (1.0 - probability_);
   double one_over_indices = 1.0 / static_cast<double> (sac_model_->getIndices ()->size ());
 
-  int n_inliers_count = 0;
   unsigned skipped_count = 0;
   // suppress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
   const unsigned max_skip = max_iterations_ * 10;
-  
+
+  // Hypotheses are drawn in batches, scored in parallel and then processed in order, exactly as a
+  // sequential loop would (the batch only holds one hypothesis when running single threaded)
+  const int batch_size = getHypothesisBatchSize ();
+  std::vector<std::vector<int> > selections;
+  std::vector<Eigen::VectorXf> coefficients (batch_size);
+  std::vector<int> inlier_counts (batch_size);
+  std::vector<char> valid (batch_size), passed (batch_size);
+  std::vector<std::size_t> offsets (batch_size), nr_tested (batch_size), nr_consistent (batch_size);
+
+  initPreemptiveTest ();
+
   // Iterate
-  while (iterations_ < k && skipped_count < max_skip)
+  bool done = false;
+  while (!done && iterations_ < k && skipped_count < max_skip)
   {
     // Get X samples which satisfy the model criteria
-    sac_model_->getSamples (iterations_, selection);
+    const int nr_samples = drawSamples (batch_size, selections);
 
-    if (selection.empty ()) 
-    {
-      PCL_ERROR ("[pcl::RandomSampleConsensus::computeModel] No samples could be selected!\n");
-      break;
-    }
+    // Pre-verify the hypotheses once a first model is known, the random points are drawn in order as well
+    const bool preemptive = isPreemptiveTestActive () && n_best_inliers_count > -INT_MAX;
+    if (preemptive)
+      for (int b = 0; b < nr_samples; ++b)
+        offsets[b] = drawPreemptiveOffset ();
 
     // Search for inliers in the point cloud for the current plane model M
-    if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) num_threads(batch_size) if (nr_samples > 1)
+#endif
+    for (int b = 0; b < nr_samples; ++b)
     {
-      //++iterations_;
-      ++skipped_count;
-      continue;
+      valid[b] = sac_model_->computeModelCoefficients (selections[b], coefficients[b]);
+      passed[b] = !valid[b] || !preemptive ||
+                  preemptiveTestPasses (coefficients[b], offsets[b], nr_tested[b], nr_consistent[b]);
+      // Select the inliers that are within threshold_ from the model
+      inlier_counts[b] = valid[b] && passed[b] ? sac_model_->countWithinDistance (coefficients[b], threshold_) : -1;
     }
 
-    // Select the inliers that are within threshold_ from the model
-    //sac_model_->selectWithinDistance (model_coefficients, threshold_, inliers);
-    //if (inliers.empty () && k > 1.0)
-    //  continue;
-
-    n_inliers_count = sac_model_->countWithinDistance (model_coefficients, threshold_);
-
-    // Better match ?
-    if (n_inliers_count > n_best_inliers_count)
+    for (int b = 0; b < nr_samples && !done; ++b)
     {
-      n_best_inliers_count = n_inliers_count;
-
-      // Save the current model/inlier/coefficients selection as being the best so far
-      model_              = selection;
-      model_coefficients_ = model_coefficients;
-
-      // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
-      double w = static_cast<double> (n_best_inliers_count) * one_over_indices;
-      double p_no_outliers = 1.0 - pow (w, static_cast<double> (selection.size ()));
-      p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
-      p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
-      k = log_probability / std::log (p_no_outliers);
+      if (!valid[b])
+      {
+        //++iterations_;
+        ++skipped_count;
+        done = skipped_count >= max_skip;
+        continue;
+      }
+
+      if (preemptive)
+        updatePreemptiveTest (passed[b], nr_tested[b], nr_consistent[b]);
+
+      const int n_inliers_count = inlier_counts[b];
+
+      // Better match ?
+      if (n_inliers_count > n_best_inliers_count)
+      {
+        n_best_inliers_count = n_inliers_count;
+
+        // Save the current model/inlier/coefficients selection as being the best so far
+        model_              = selections[b];
+        model_coefficients_ = coefficients[b];
+
+        // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
+        double w = static_cast<double> (n_best_inliers_count) * one_over_indices;
+        setPreemptiveInlierRatio (w);
+        double p_no_outliers = 1.0 - pow (w, static_cast<double> (selections[b].size ())) * getPreemptiveAcceptanceProbability (w);
+        p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
+        p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
+        k = log_probability / std::log (p_no_outliers);
+      }
+
+      ++iterations_;
+      PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Trial %d out of %f: %d inliers (best is: %d so far).\n", iterations_, k, n_inliers_count, n_best_inliers_count);
+      if (iterations_ > max_iterations_)
+      {
+        PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] RANSAC reached the maximum number of trials.\n");
+        done = true;
+      }
+      else
+        done = !(iterations_ < k);
     }
 
-    ++iterations_;
-    PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Trial %d out of %f: %d inliers (best is: %d so far).\n", iterations_, k, n_inliers_count, n_best_inliers_count);
-    if (iterations_ > max_iterations_)
+    if (!done && nr_samples < batch_size)
     {
-      PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] RANSAC reached the maximum number of trials.\n");
+      PCL_ERROR ("[pcl::RandomSampleConsensus::computeModel] No samples could be selected!\n");
       break;
     }
   }
@@ -317,6 +317,21 @@ pcl::SampleConsensusModelCircle2D<PointT>::doSamplesVerifyModel (
   return (true);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SampleConsensusModelCircle2D<PointT>::doPointVerifyModel (
+      int index, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  // Calculate the distance from the point to the circle as the difference between
+  // dist(point,circle_origin) and circle_radius
+  return (std::abs (std::sqrt (
+                      ( input_->points[index].x - model_coefficients[0] ) *
+                      ( input_->points[index].x - model_coefficients[0] ) +
+                      ( input_->points[index].y - model_coefficients[1] ) *
+                      ( input_->points[index].y - model_coefficients[1] )
+                     ) - model_coefficients[2]) <= threshold);
+}
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> bool 
 pcl::SampleConsensusModelCircle2D<PointT>::isModelValid (const Eigen::VectorXf &model_coefficients) const
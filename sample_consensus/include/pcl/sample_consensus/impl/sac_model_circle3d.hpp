@@ -430,6 +430,30 @@ pcl::SampleConsensusModelCircle3D<PointT>::doSamplesVerifyModel (
   return (true);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SampleConsensusModelCircle3D<PointT>::doPointVerifyModel (
+      int index, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  // P : Sample Point
+  Eigen::Vector3d P (input_->points[index].x, input_->points[index].y, input_->points[index].z);
+  // C : Circle Center
+  Eigen::Vector3d C (model_coefficients[0], model_coefficients[1], model_coefficients[2]);
+  // N : Circle (Plane) Normal
+  Eigen::Vector3d N (model_coefficients[4], model_coefficients[5], model_coefficients[6]);
+  // r : Radius
+  double r = model_coefficients[3];
+  Eigen::Vector3d helper_vectorPC = P - C;
+  // Project the point on the circle plane
+  double lambda = (-(helper_vectorPC.dot (N))) / N.dot (N);
+  Eigen::Vector3d P_proj = P + lambda * N;
+  Eigen::Vector3d helper_vectorP_projC = P_proj - C;
+
+  // K : Point on Circle
+  Eigen::Vector3d K = C + r * helper_vectorP_projC.normalized ();
+  return ((P - K).norm () <= threshold);
+}
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> bool
 pcl::SampleConsensusModelCircle3D<PointT>::isModelValid (const Eigen::VectorXf &model_coefficients) const
@@ -480,6 +480,28 @@ pcl::SampleConsensusModelCone<PointT, PointNT>::doSamplesVerifyModel (
   return (true);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> bool
+pcl::SampleConsensusModelCone<PointT, PointNT>::doPointVerifyModel (
+      int index, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  Eigen::Vector4f apex (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0);
+  Eigen::Vector4f axis_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
+  Eigen::Vector4f pt (input_->points[index].x, input_->points[index].y, input_->points[index].z, 0);
+
+  // Calculate the point's projection on the cone axis
+  float k = (pt.dot (axis_dir) - apex.dot (axis_dir)) / axis_dir.dot (axis_dir);
+  Eigen::Vector4f pt_proj = apex + k * axis_dir;
+
+  // Calculate the actual radius of the cone at the level of the projected point
+  Eigen::Vector4f height = apex - pt_proj;
+  double actual_cone_radius = tan (model_coefficients[6]) * height.norm ();
+
+  // Approximate the distance from the point to the cone as the difference between
+  // dist(point,cone_axis) and actual cone radius
+  return (std::abs (static_cast<double>(pointToAxisDistance (pt, model_coefficients) - actual_cone_radius)) <= threshold);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename PointNT> double
 pcl::SampleConsensusModelCone<PointT, PointNT>::pointToAxisDistance (
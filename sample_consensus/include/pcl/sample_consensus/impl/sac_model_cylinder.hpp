@@ -230,6 +230,46 @@ pcl::SampleConsensusModelCylinder<PointT, PointNT>::countWithinDistance (
   if (!isModelValid (model_coefficients))
     return (0);
 
+#if defined (__AVX__)
+  return (countWithinDistanceAVX (model_coefficients, threshold));
+#elif defined (__SSE2__)
+  return (countWithinDistanceSSE (model_coefficients, threshold));
+#else
+  return (countWithinDistanceStandard (model_coefficients, threshold));
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> inline bool
+pcl::SampleConsensusModelCylinder<PointT, PointNT>::isWithinDistance (
+      std::size_t i, const Eigen::VectorXf &model_coefficients,
+      const Eigen::Vector4f &line_pt, const Eigen::Vector4f &line_dir,
+      float ptdotdir, float dirdotdir, double threshold) const
+{
+  // Approximate the distance from the point to the cylinder as the difference between
+  // dist(point,cylinder_axis) and cylinder radius
+  Eigen::Vector4f pt (input_->points[(*indices_)[i]].x, input_->points[(*indices_)[i]].y, input_->points[(*indices_)[i]].z, 0);
+  Eigen::Vector4f n  (normals_->points[(*indices_)[i]].normal[0], normals_->points[(*indices_)[i]].normal[1], normals_->points[(*indices_)[i]].normal[2], 0);
+  double d_euclid = std::abs (pointToLineDistance (pt, model_coefficients) - model_coefficients[6]);
+
+  // Calculate the point's projection on the cylinder axis
+  float k = (pt.dot (line_dir) - ptdotdir) * dirdotdir;
+  Eigen::Vector4f pt_proj = line_pt + k * line_dir;
+  Eigen::Vector4f dir = pt - pt_proj;
+  dir.normalize ();
+
+  // Calculate the angular distance between the point normal and the (dir=pt_proj->pt) vector
+  double d_normal = std::abs (getAngle3D (n, dir));
+  d_normal = (std::min) (d_normal, M_PI - d_normal);
+
+  return (std::abs (normal_distance_weight_ * d_normal + (1 - normal_distance_weight_) * d_euclid) < threshold);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> int
+pcl::SampleConsensusModelCylinder<PointT, PointNT>::countWithinDistanceStandard (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
   int nr_p = 0;
 
   Eigen::Vector4f line_pt  (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0);
@@ -237,29 +277,132 @@ pcl::SampleConsensusModelCylinder<PointT, PointNT>::countWithinDistance (
   float ptdotdir = line_pt.dot (line_dir);
   float dirdotdir = 1.0f / line_dir.dot (line_dir);
   // Iterate through the 3d points and calculate the distances from them to the sphere
-  for (size_t i = 0; i < indices_->size (); ++i)
+  for (; i < indices_->size (); ++i)
+    if (isWithinDistance (i, model_coefficients, line_pt, line_dir, ptdotdir, dirdotdir, threshold))
+      nr_p++;
+  return (nr_p);
+}
+
+#define AT(POS) (input_->points[(*indices_)[(POS)]])
+
+// The SIMD implementations only compute the distance to the cylinder surface. As long as the normal distance
+// weight lies in [0, 1], w * d_normal + (1 - w) * d_euclid >= (1 - w) * d_euclid, so a point is rejected if a
+// lower bound of the latter (accounting for the single precision rounding) already reaches the threshold.
+// All remaining candidates go through the exact test.
+
+#if defined (__SSE2__)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> int
+pcl::SampleConsensusModelCylinder<PointT, PointNT>::countWithinDistanceSSE (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  if (!(normal_distance_weight_ >= 0.0 && normal_distance_weight_ <= 1.0))
+    return (countWithinDistanceStandard (model_coefficients, threshold, i));
+
+  Eigen::Vector4f line_pt  (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0);
+  Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
+  float ptdotdir = line_pt.dot (line_dir);
+  float dirdotdir = 1.0f / line_dir.dot (line_dir);
+
+  const __m128 pt_x = _mm_set1_ps (line_pt[0]);
+  const __m128 pt_y = _mm_set1_ps (line_pt[1]);
+  const __m128 pt_z = _mm_set1_ps (line_pt[2]);
+  const __m128 dir_x = _mm_set1_ps (line_dir[0]);
+  const __m128 dir_y = _mm_set1_ps (line_dir[1]);
+  const __m128 dir_z = _mm_set1_ps (line_dir[2]);
+  const __m128 inv_sqr_length = _mm_set1_ps (dirdotdir);
+  const __m128 radius = _mm_set1_ps (model_coefficients[6]);
+  const __m128 scale = _mm_set1_ps (std::max (0.0f, static_cast<float> (1.0 - normal_distance_weight_) - 1e-6f));
+  const __m128 threshold_vec = _mm_set1_ps (static_cast<float> (threshold * (1.0 + 1e-6)));
+  const __m128 abs_help = _mm_set1_ps (-0.0f);
+  const __m128 zero = _mm_setzero_ps ();
+  const __m128 eps = _mm_set1_ps (1e-6f);
+
+  int nr_p = 0;
+  for (; (i + 4) <= indices_->size (); i += 4)
   {
-    // Approximate the distance from the point to the cylinder as the difference between
-    // dist(point,cylinder_axis) and cylinder radius
-    Eigen::Vector4f pt (input_->points[(*indices_)[i]].x, input_->points[(*indices_)[i]].y, input_->points[(*indices_)[i]].z, 0);
-    Eigen::Vector4f n  (normals_->points[(*indices_)[i]].normal[0], normals_->points[(*indices_)[i]].normal[1], normals_->points[(*indices_)[i]].normal[2], 0);
-    double d_euclid = std::abs (pointToLineDistance (pt, model_coefficients) - model_coefficients[6]);
+    // Pack the four points into SoA registers, relative to the point on the axis
+    const __m128 dx = _mm_sub_ps (pt_x, _mm_set_ps (AT(i + 3).x, AT(i + 2).x, AT(i + 1).x, AT(i).x));
+    const __m128 dy = _mm_sub_ps (pt_y, _mm_set_ps (AT(i + 3).y, AT(i + 2).y, AT(i + 1).y, AT(i).y));
+    const __m128 dz = _mm_sub_ps (pt_z, _mm_set_ps (AT(i + 3).z, AT(i + 2).z, AT(i + 1).z, AT(i).z));
+    // Distance to the axis: ||line_dir x (line_pt - pt)|| / ||line_dir||
+    const __m128 cx = _mm_sub_ps (_mm_mul_ps (dir_y, dz), _mm_mul_ps (dir_z, dy));
+    const __m128 cy = _mm_sub_ps (_mm_mul_ps (dir_z, dx), _mm_mul_ps (dir_x, dz));
+    const __m128 cz = _mm_sub_ps (_mm_mul_ps (dir_x, dy), _mm_mul_ps (dir_y, dx));
+    const __m128 dist = _mm_sqrt_ps (_mm_mul_ps (_mm_add_ps (_mm_add_ps (_mm_mul_ps (cx, cx), _mm_mul_ps (cy, cy)), _mm_mul_ps (cz, cz)), inv_sqr_length));
+
+    // Distance to the surface, minus a bound on its rounding error
+    const __m128 magnitude = _mm_add_ps (_mm_add_ps (_mm_andnot_ps (abs_help, dx), _mm_andnot_ps (abs_help, dy)),
+                                         _mm_add_ps (_mm_andnot_ps (abs_help, dz), radius));
+    const __m128 d_euclid_min = _mm_max_ps (zero, _mm_sub_ps (_mm_andnot_ps (abs_help, _mm_sub_ps (dist, radius)), _mm_mul_ps (eps, magnitude)));
+    const __m128 reject = _mm_cmpge_ps (_mm_mul_ps (scale, d_euclid_min), threshold_vec);
+
+    int candidates = ~_mm_movemask_ps (reject) & 0xF;
+    for (int j = 0; candidates != 0; ++j, candidates >>= 1)
+      if ((candidates & 1) && isWithinDistance (i + j, model_coefficients, line_pt, line_dir, ptdotdir, dirdotdir, threshold))
+        nr_p++;
+  }
+  return (nr_p + countWithinDistanceStandard (model_coefficients, threshold, i));
+}
+#endif
 
-    // Calculate the point's projection on the cylinder axis
-    float k = (pt.dot (line_dir) - ptdotdir) * dirdotdir;
-    Eigen::Vector4f pt_proj = line_pt + k * line_dir;
-    Eigen::Vector4f dir = pt - pt_proj;
-    dir.normalize ();
+#if defined (__AVX__)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> int
+pcl::SampleConsensusModelCylinder<PointT, PointNT>::countWithinDistanceAVX (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  if (!(normal_distance_weight_ >= 0.0 && normal_distance_weight_ <= 1.0))
+    return (countWithinDistanceStandard (model_coefficients, threshold, i));
 
-    // Calculate the angular distance between the point normal and the (dir=pt_proj->pt) vector
-    double d_normal = std::abs (getAngle3D (n, dir));
-    d_normal = (std::min) (d_normal, M_PI - d_normal);
+  Eigen::Vector4f line_pt  (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0);
+  Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
+  float ptdotdir = line_pt.dot (line_dir);
+  float dirdotdir = 1.0f / line_dir.dot (line_dir);
 
-    if (std::abs (normal_distance_weight_ * d_normal + (1 - normal_distance_weight_) * d_euclid) < threshold)
-      nr_p++;
+  const __m256 pt_x = _mm256_set1_ps (line_pt[0]);
+  const __m256 pt_y = _mm256_set1_ps (line_pt[1]);
+  const __m256 pt_z = _mm256_set1_ps (line_pt[2]);
+  const __m256 dir_x = _mm256_set1_ps (line_dir[0]);
+  const __m256 dir_y = _mm256_set1_ps (line_dir[1]);
+  const __m256 dir_z = _mm256_set1_ps (line_dir[2]);
+  const __m256 inv_sqr_length = _mm256_set1_ps (dirdotdir);
+  const __m256 radius = _mm256_set1_ps (model_coefficients[6]);
+  const __m256 scale = _mm256_set1_ps (std::max (0.0f, static_cast<float> (1.0 - normal_distance_weight_) - 1e-6f));
+  const __m256 threshold_vec = _mm256_set1_ps (static_cast<float> (threshold * (1.0 + 1e-6)));
+  const __m256 abs_help = _mm256_set1_ps (-0.0f);
+  const __m256 zero = _mm256_setzero_ps ();
+  const __m256 eps = _mm256_set1_ps (1e-6f);
+
+  int nr_p = 0;
+  for (; (i + 8) <= indices_->size (); i += 8)
+  {
+    // Pack the eight points into SoA registers, relative to the point on the axis
+    const __m256 dx = _mm256_sub_ps (pt_x, _mm256_set_ps (AT(i + 7).x, AT(i + 6).x, AT(i + 5).x, AT(i + 4).x, AT(i + 3).x, AT(i + 2).x, AT(i + 1).x, AT(i).x));
+    const __m256 dy = _mm256_sub_ps (pt_y, _mm256_set_ps (AT(i + 7).y, AT(i + 6).y, AT(i + 5).y, AT(i + 4).y, AT(i + 3).y, AT(i + 2).y, AT(i + 1).y, AT(i).y));
+    const __m256 dz = _mm256_sub_ps (pt_z, _mm256_set_ps (AT(i + 7).z, AT(i + 6).z, AT(i + 5).z, AT(i + 4).z, AT(i + 3).z, AT(i + 2).z, AT(i + 1).z, AT(i).z));
+    // Distance to the axis: ||line_dir x (line_pt - pt)|| / ||line_dir||
+    const __m256 cx = _mm256_sub_ps (_mm256_mul_ps (dir_y, dz), _mm256_mul_ps (dir_z, dy));
+    const __m256 cy = _mm256_sub_ps (_mm256_mul_ps (dir_z, dx), _mm256_mul_ps (dir_x, dz));
+    const __m256 cz = _mm256_sub_ps (_mm256_mul_ps (dir_x, dy), _mm256_mul_ps (dir_y, dx));
+    const __m256 dist = _mm256_sqrt_ps (_mm256_mul_ps (_mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (cx, cx), _mm256_mul_ps (cy, cy)), _mm256_mul_ps (cz, cz)), inv_sqr_length));
+
+    // Distance to the surface, minus a bound on its rounding error
+    const __m256 magnitude = _mm256_add_ps (_mm256_add_ps (_mm256_andnot_ps (abs_help, dx), _mm256_andnot_ps (abs_help, dy)),
+                                            _mm256_add_ps (_mm256_andnot_ps (abs_help, dz), radius));
+    const __m256 d_euclid_min = _mm256_max_ps (zero, _mm256_sub_ps (_mm256_andnot_ps (abs_help, _mm256_sub_ps (dist, radius)), _mm256_mul_ps (eps, magnitude)));
+    const __m256 reject = _mm256_cmp_ps (_mm256_mul_ps (scale, d_euclid_min), threshold_vec, _CMP_GE_OQ);
+
+    int candidates = ~_mm256_movemask_ps (reject) & 0xFF;
+    for (int j = 0; candidates != 0; ++j, candidates >>= 1)
+      if ((candidates & 1) && isWithinDistance (i + j, model_coefficients, line_pt, line_dir, ptdotdir, dirdotdir, threshold))
+        nr_p++;
   }
-  return (nr_p);
+  return (nr_p + countWithinDistanceStandard (model_coefficients, threshold, i));
 }
+#endif
+
+#undef AT
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename PointNT> void
@@ -409,6 +552,17 @@ pcl::SampleConsensusModelCylinder<PointT, PointNT>::doSamplesVerifyModel (
   return (true);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> bool
+pcl::SampleConsensusModelCylinder<PointT, PointNT>::doPointVerifyModel (
+      int index, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  // Approximate the distance from the point to the cylinder as the difference between
+  // dist(point,cylinder_axis) and cylinder radius
+  Eigen::Vector4f pt (input_->points[index].x, input_->points[index].y, input_->points[index].z, 0);
+  return (std::abs (pointToLineDistance (pt, model_coefficients) - model_coefficients[6]) <= threshold);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename PointNT> double
 pcl::SampleConsensusModelCylinder<PointT, PointNT>::pointToLineDistance (
@@ -130,7 +130,8 @@ pcl::SampleConsensusModelLine<PointT>::selectWithinDistance (
   if (!isModelValid (model_coefficients))
     return;
 
-  double sqr_threshold = threshold * threshold;
+  // Compare in single precision, as countWithinDistance () does
+  const float sqr_threshold = static_cast<float> (threshold * threshold);
 
   int nr_p = 0;
   inliers.resize (indices_->size ());
@@ -146,7 +147,7 @@ pcl::SampleConsensusModelLine<PointT>::selectWithinDistance (
   {
     // Calculate the distance from the point to the line
     // D = ||(P2-P1) x (P1-P0)|| / ||P2-P1|| = norm (cross (p2-p1, p2-p0)) / norm(p2-p1)
-    double sqr_distance = (line_pt - input_->points[(*indices_)[i]].getVector4fMap ()).cross3 (line_dir).squaredNorm ();
+    const float sqr_distance = (line_pt - input_->points[(*indices_)[i]].getVector4fMap ()).cross3 (line_dir).squaredNorm ();
 
     if (sqr_distance < sqr_threshold)
     {
@@ -169,7 +170,22 @@ pcl::SampleConsensusModelLine<PointT>::countWithinDistance (
   if (!isModelValid (model_coefficients))
     return (0);
 
-  double sqr_threshold = threshold * threshold;
+#if defined (__AVX__)
+  return (countWithinDistanceAVX (model_coefficients, threshold));
+#elif defined (__SSE2__)
+  return (countWithinDistanceSSE (model_coefficients, threshold));
+#else
+  return (countWithinDistanceStandard (model_coefficients, threshold));
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelLine<PointT>::countWithinDistanceStandard (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  // Compare in single precision, as the SIMD kernels do
+  const float sqr_threshold = static_cast<float> (threshold * threshold);
 
   int nr_p = 0;
 
@@ -179,11 +195,11 @@ pcl::SampleConsensusModelLine<PointT>::countWithinDistance (
   line_dir.normalize ();
 
   // Iterate through the 3d points and calculate the distances from them to the line
-  for (size_t i = 0; i < indices_->size (); ++i)
+  for (; i < indices_->size (); ++i)
   {
     // Calculate the distance from the point to the line
     // D = ||(P2-P1) x (P1-P0)|| / ||P2-P1|| = norm (cross (p2-p1, p2-p0)) / norm(p2-p1)
-    double sqr_distance = (line_pt - input_->points[(*indices_)[i]].getVector4fMap ()).cross3 (line_dir).squaredNorm ();
+    float sqr_distance = (line_pt - input_->points[(*indices_)[i]].getVector4fMap ()).cross3 (line_dir).squaredNorm ();
 
     if (sqr_distance < sqr_threshold)
       nr_p++;
@@ -191,6 +207,90 @@ pcl::SampleConsensusModelLine<PointT>::countWithinDistance (
   return (nr_p);
 }
 
+#define AT(POS) (input_->points[(*indices_)[(POS)]])
+
+#if defined (__SSE2__)
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelLine<PointT>::countWithinDistanceSSE (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  Eigen::Vector3f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5]);
+  line_dir.normalize ();
+
+  const __m128 pt_x = _mm_set1_ps (model_coefficients[0]);
+  const __m128 pt_y = _mm_set1_ps (model_coefficients[1]);
+  const __m128 pt_z = _mm_set1_ps (model_coefficients[2]);
+  const __m128 dir_x = _mm_set1_ps (line_dir[0]);
+  const __m128 dir_y = _mm_set1_ps (line_dir[1]);
+  const __m128 dir_z = _mm_set1_ps (line_dir[2]);
+  const __m128 sqr_threshold_vec = _mm_set1_ps (static_cast<float> (threshold * threshold));
+
+  // The comparison masks are all ones (-1) for inliers, so subtracting them counts the inliers per lane
+  __m128i res = _mm_setzero_si128 ();
+  for (; (i + 4) <= indices_->size (); i += 4)
+  {
+    // Pack the four points into SoA registers, relative to the line point
+    const __m128 dx = _mm_sub_ps (pt_x, _mm_set_ps (AT(i + 3).x, AT(i + 2).x, AT(i + 1).x, AT(i).x));
+    const __m128 dy = _mm_sub_ps (pt_y, _mm_set_ps (AT(i + 3).y, AT(i + 2).y, AT(i + 1).y, AT(i).y));
+    const __m128 dz = _mm_sub_ps (pt_z, _mm_set_ps (AT(i + 3).z, AT(i + 2).z, AT(i + 1).z, AT(i).z));
+    // Squared norm of (line_pt - pt) x line_dir
+    const __m128 cx = _mm_sub_ps (_mm_mul_ps (dy, dir_z), _mm_mul_ps (dz, dir_y));
+    const __m128 cy = _mm_sub_ps (_mm_mul_ps (dz, dir_x), _mm_mul_ps (dx, dir_z));
+    const __m128 cz = _mm_sub_ps (_mm_mul_ps (dx, dir_y), _mm_mul_ps (dy, dir_x));
+    const __m128 sqr_distance = _mm_add_ps (_mm_add_ps (_mm_mul_ps (cx, cx), _mm_mul_ps (cy, cy)), _mm_mul_ps (cz, cz));
+    res = _mm_sub_epi32 (res, _mm_castps_si128 (_mm_cmplt_ps (sqr_distance, sqr_threshold_vec)));
+  }
+  int res_lanes[4];
+  _mm_storeu_si128 (reinterpret_cast<__m128i*> (res_lanes), res);
+  const int nr_p = res_lanes[0] + res_lanes[1] + res_lanes[2] + res_lanes[3];
+  return (nr_p + countWithinDistanceStandard (model_coefficients, threshold, i));
+}
+#endif
+
+#if defined (__AVX__)
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelLine<PointT>::countWithinDistanceAVX (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  Eigen::Vector3f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5]);
+  line_dir.normalize ();
+
+  const __m256 pt_x = _mm256_set1_ps (model_coefficients[0]);
+  const __m256 pt_y = _mm256_set1_ps (model_coefficients[1]);
+  const __m256 pt_z = _mm256_set1_ps (model_coefficients[2]);
+  const __m256 dir_x = _mm256_set1_ps (line_dir[0]);
+  const __m256 dir_y = _mm256_set1_ps (line_dir[1]);
+  const __m256 dir_z = _mm256_set1_ps (line_dir[2]);
+  const __m256 sqr_threshold_vec = _mm256_set1_ps (static_cast<float> (threshold * threshold));
+
+  // The comparison masks are all ones (-1) for inliers, so subtracting both halves counts the inliers per lane
+  __m128i res = _mm_setzero_si128 ();
+  for (; (i + 8) <= indices_->size (); i += 8)
+  {
+    // Pack the eight points into SoA registers, relative to the line point
+    const __m256 dx = _mm256_sub_ps (pt_x, _mm256_set_ps (AT(i + 7).x, AT(i + 6).x, AT(i + 5).x, AT(i + 4).x, AT(i + 3).x, AT(i + 2).x, AT(i + 1).x, AT(i).x));
+    const __m256 dy = _mm256_sub_ps (pt_y, _mm256_set_ps (AT(i + 7).y, AT(i + 6).y, AT(i + 5).y, AT(i + 4).y, AT(i + 3).y, AT(i + 2).y, AT(i + 1).y, AT(i).y));
+    const __m256 dz = _mm256_sub_ps (pt_z, _mm256_set_ps (AT(i + 7).z, AT(i + 6).z, AT(i + 5).z, AT(i + 4).z, AT(i + 3).z, AT(i + 2).z, AT(i + 1).z, AT(i).z));
+    // Squared norm of (line_pt - pt) x line_dir
+    const __m256 cx = _mm256_sub_ps (_mm256_mul_ps (dy, dir_z), _mm256_mul_ps (dz, dir_y));
+    const __m256 cy = _mm256_sub_ps (_mm256_mul_ps (dz, dir_x), _mm256_mul_ps (dx, dir_z));
+    const __m256 cz = _mm256_sub_ps (_mm256_mul_ps (dx, dir_y), _mm256_mul_ps (dy, dir_x));
+    const __m256 sqr_distance = _mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (cx, cx), _mm256_mul_ps (cy, cy)), _mm256_mul_ps (cz, cz));
+    const __m256 mask = _mm256_cmp_ps (sqr_distance, sqr_threshold_vec, _CMP_LT_OQ);
+    res = _mm_sub_epi32 (res, _mm_castps_si128 (_mm256_castps256_ps128 (mask)));
+    res = _mm_sub_epi32 (res, _mm_castps_si128 (_mm256_extractf128_ps (mask, 1)));
+  }
+  int res_lanes[4];
+  _mm_storeu_si128 (reinterpret_cast<__m128i*> (res_lanes), res);
+  const int nr_p = res_lanes[0] + res_lanes[1] + res_lanes[2] + res_lanes[3];
+  return (nr_p + countWithinDistanceStandard (model_coefficients, threshold, i));
+}
+#endif
+
+#undef AT
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SampleConsensusModelLine<PointT>::optimizeModelCoefficients (
@@ -319,19 +419,34 @@ pcl::SampleConsensusModelLine<PointT>::doSamplesVerifyModel (
   Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
   line_dir.normalize ();
 
-  double sqr_threshold = threshold * threshold;
+  // Compare in single precision, as countWithinDistance () does
+  const float sqr_threshold = static_cast<float> (threshold * threshold);
   // Iterate through the 3d points and calculate the distances from them to the line
   for (const int &index : indices)
   {
     // Calculate the distance from the point to the line
     // D = ||(P2-P1) x (P1-P0)|| / ||P2-P1|| = norm (cross (p2-p1, p2-p0)) / norm(p2-p1)
-    if ((line_pt - input_->points[index].getVector4fMap ()).cross3 (line_dir).squaredNorm () > sqr_threshold)
+    if (!((line_pt - input_->points[index].getVector4fMap ()).cross3 (line_dir).squaredNorm () < sqr_threshold))
       return (false);
   }
 
   return (true);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SampleConsensusModelLine<PointT>::doPointVerifyModel (
+      int index, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  // Obtain the line point and direction
+  Eigen::Vector4f line_pt  (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0);
+  Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
+  line_dir.normalize ();
+
+  // D = ||(P2-P1) x (P1-P0)|| / ||P2-P1|| = norm (cross (p2-p1, p2-p0)) / norm(p2-p1)
+  return ((line_pt - input_->points[index].getVector4fMap ()).cross3 (line_dir).squaredNorm () < static_cast<float> (threshold * threshold));
+}
+
 #define PCL_INSTANTIATE_SampleConsensusModelLine(T) template class PCL_EXPORTS pcl::SampleConsensusModelLine<T>;
 
 #endif    // PCL_SAMPLE_CONSENSUS_IMPL_SAC_MODEL_LINE_H_
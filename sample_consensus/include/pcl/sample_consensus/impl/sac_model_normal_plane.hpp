@@ -116,6 +116,43 @@ pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::countWithinDistance (
   if (!isModelValid (model_coefficients))
     return (0);
 
+#if defined (__AVX__)
+  return (countWithinDistanceAVX (model_coefficients, threshold));
+#elif defined (__SSE2__)
+  return (countWithinDistanceSSE (model_coefficients, threshold));
+#else
+  return (countWithinDistanceStandard (model_coefficients, threshold));
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> inline bool
+pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::isWithinDistance (
+      int index, const Eigen::Vector4f &coeff, float d, double threshold) const
+{
+  const PointT  &pt = input_->points[index];
+  const PointNT &nt = normals_->points[index];
+  // Calculate the distance from the point to the plane normal as the dot product
+  // D = (P-A).N/|N|
+  Eigen::Vector4f p (pt.x, pt.y, pt.z, 0);
+  Eigen::Vector4f n (nt.normal_x, nt.normal_y, nt.normal_z, 0);
+  double d_euclid = std::abs (coeff.dot (p) + d);
+
+  // Calculate the angular distance between the point normal and the plane normal
+  double d_normal = std::abs (getAngle3D (n, coeff));
+  d_normal = (std::min) (d_normal, M_PI - d_normal);
+
+  // Weight with the point curvature. On flat surfaces, curvature -> 0, which means the normal will have a higher influence
+  double weight = normal_distance_weight_ * (1.0 - nt.curvature);
+
+  return (std::abs (weight * d_normal + (1.0 - weight) * d_euclid) < threshold);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> int
+pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::countWithinDistanceStandard (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
   // Obtain the plane normal
   Eigen::Vector4f coeff = model_coefficients;
   coeff[3] = 0;
@@ -123,28 +160,121 @@ pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::countWithinDistance (
   int nr_p = 0;
 
   // Iterate through the 3d points and calculate the distances from them to the plane
-  for (size_t i = 0; i < indices_->size (); ++i)
+  for (; i < indices_->size (); ++i)
+    if (isWithinDistance ((*indices_)[i], coeff, model_coefficients[3], threshold))
+      nr_p++;
+  return (nr_p);
+}
+
+#define AT(POS) (input_->points[(*indices_)[(POS)]])
+#define NT(POS) (normals_->points[(*indices_)[(POS)]])
+
+// The SIMD implementations only compute the Euclidean part of the distance. As long as the point weight lies
+// in [0, 1], weight * d_normal + (1 - weight) * d_euclid >= (1 - weight) * d_euclid, so a point is rejected
+// if a lower bound of the latter (accounting for the single precision rounding) already reaches the threshold.
+// All remaining candidates go through the exact test.
+
+#if defined (__SSE2__)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> int
+pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::countWithinDistanceSSE (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  Eigen::Vector4f coeff = model_coefficients;
+  coeff[3] = 0;
+
+  const __m128 a_vec = _mm_set1_ps (model_coefficients[0]);
+  const __m128 b_vec = _mm_set1_ps (model_coefficients[1]);
+  const __m128 c_vec = _mm_set1_ps (model_coefficients[2]);
+  const __m128 d_vec = _mm_set1_ps (model_coefficients[3]);
+  const __m128 weight_vec = _mm_set1_ps (static_cast<float> (normal_distance_weight_));
+  const __m128 threshold_vec = _mm_set1_ps (static_cast<float> (threshold * (1.0 + 1e-6)));
+  const __m128 abs_help = _mm_set1_ps (-0.0f);
+  const __m128 zero = _mm_setzero_ps ();
+  const __m128 one = _mm_set1_ps (1.0f);
+  const __m128 eps = _mm_set1_ps (1e-6f);
+
+  int nr_p = 0;
+  for (; (i + 4) <= indices_->size (); i += 4)
   {
-    const PointT  &pt = input_->points[(*indices_)[i]];
-    const PointNT &nt = normals_->points[(*indices_)[i]];
-    // Calculate the distance from the point to the plane normal as the dot product
-    // D = (P-A).N/|N|
-    Eigen::Vector4f p (pt.x, pt.y, pt.z, 0);
-    Eigen::Vector4f n (nt.normal_x, nt.normal_y, nt.normal_z, 0);
-    double d_euclid = std::abs (coeff.dot (p) + model_coefficients[3]);
+    // Pack the four points into SoA registers
+    const __m128 ax = _mm_mul_ps (a_vec, _mm_set_ps (AT(i + 3).x, AT(i + 2).x, AT(i + 1).x, AT(i).x));
+    const __m128 by = _mm_mul_ps (b_vec, _mm_set_ps (AT(i + 3).y, AT(i + 2).y, AT(i + 1).y, AT(i).y));
+    const __m128 cz = _mm_mul_ps (c_vec, _mm_set_ps (AT(i + 3).z, AT(i + 2).z, AT(i + 1).z, AT(i).z));
+    const __m128 curvature = _mm_set_ps (NT(i + 3).curvature, NT(i + 2).curvature, NT(i + 1).curvature, NT(i).curvature);
 
-    // Calculate the angular distance between the point normal and the plane normal
-    double d_normal = std::abs (getAngle3D (n, coeff));
-    d_normal = (std::min) (d_normal, M_PI - d_normal);
+    // Euclidean distance, minus a bound on its rounding error
+    const __m128 d_euclid = _mm_andnot_ps (abs_help, _mm_add_ps (_mm_add_ps (ax, by), _mm_add_ps (cz, d_vec)));
+    const __m128 magnitude = _mm_add_ps (_mm_add_ps (_mm_andnot_ps (abs_help, ax), _mm_andnot_ps (abs_help, by)),
+                                         _mm_add_ps (_mm_andnot_ps (abs_help, cz), _mm_andnot_ps (abs_help, d_vec)));
+    const __m128 d_euclid_min = _mm_max_ps (zero, _mm_sub_ps (d_euclid, _mm_mul_ps (eps, magnitude)));
 
-    // Weight with the point curvature. On flat surfaces, curvature -> 0, which means the normal will have a higher influence
-    double weight = normal_distance_weight_ * (1.0 - nt.curvature);
+    const __m128 weight = _mm_mul_ps (weight_vec, _mm_sub_ps (one, curvature));
+    const __m128 weight_valid = _mm_and_ps (_mm_cmpge_ps (weight, zero), _mm_cmple_ps (weight, one));
+    const __m128 lower_bound = _mm_mul_ps (_mm_max_ps (zero, _mm_sub_ps (_mm_sub_ps (one, weight), eps)), d_euclid_min);
+    const __m128 reject = _mm_and_ps (weight_valid, _mm_cmpge_ps (lower_bound, threshold_vec));
 
-    if (std::abs (weight * d_normal + (1.0 - weight) * d_euclid) < threshold)
-      nr_p++;
+    int candidates = ~_mm_movemask_ps (reject) & 0xF;
+    for (int j = 0; candidates != 0; ++j, candidates >>= 1)
+      if ((candidates & 1) && isWithinDistance ((*indices_)[i + j], coeff, model_coefficients[3], threshold))
+        nr_p++;
   }
-  return (nr_p);
+  return (nr_p + countWithinDistanceStandard (model_coefficients, threshold, i));
+}
+#endif
+
+#if defined (__AVX__)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> int
+pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::countWithinDistanceAVX (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  Eigen::Vector4f coeff = model_coefficients;
+  coeff[3] = 0;
+
+  const __m256 a_vec = _mm256_set1_ps (model_coefficients[0]);
+  const __m256 b_vec = _mm256_set1_ps (model_coefficients[1]);
+  const __m256 c_vec = _mm256_set1_ps (model_coefficients[2]);
+  const __m256 d_vec = _mm256_set1_ps (model_coefficients[3]);
+  const __m256 weight_vec = _mm256_set1_ps (static_cast<float> (normal_distance_weight_));
+  const __m256 threshold_vec = _mm256_set1_ps (static_cast<float> (threshold * (1.0 + 1e-6)));
+  const __m256 abs_help = _mm256_set1_ps (-0.0f);
+  const __m256 zero = _mm256_setzero_ps ();
+  const __m256 one = _mm256_set1_ps (1.0f);
+  const __m256 eps = _mm256_set1_ps (1e-6f);
+
+  int nr_p = 0;
+  for (; (i + 8) <= indices_->size (); i += 8)
+  {
+    // Pack the eight points into SoA registers
+    const __m256 ax = _mm256_mul_ps (a_vec, _mm256_set_ps (AT(i + 7).x, AT(i + 6).x, AT(i + 5).x, AT(i + 4).x, AT(i + 3).x, AT(i + 2).x, AT(i + 1).x, AT(i).x));
+    const __m256 by = _mm256_mul_ps (b_vec, _mm256_set_ps (AT(i + 7).y, AT(i + 6).y, AT(i + 5).y, AT(i + 4).y, AT(i + 3).y, AT(i + 2).y, AT(i + 1).y, AT(i).y));
+    const __m256 cz = _mm256_mul_ps (c_vec, _mm256_set_ps (AT(i + 7).z, AT(i + 6).z, AT(i + 5).z, AT(i + 4).z, AT(i + 3).z, AT(i + 2).z, AT(i + 1).z, AT(i).z));
+    const __m256 curvature = _mm256_set_ps (NT(i + 7).curvature, NT(i + 6).curvature, NT(i + 5).curvature, NT(i + 4).curvature,
+                                            NT(i + 3).curvature, NT(i + 2).curvature, NT(i + 1).curvature, NT(i).curvature);
+
+    // Euclidean distance, minus a bound on its rounding error
+    const __m256 d_euclid = _mm256_andnot_ps (abs_help, _mm256_add_ps (_mm256_add_ps (ax, by), _mm256_add_ps (cz, d_vec)));
+    const __m256 magnitude = _mm256_add_ps (_mm256_add_ps (_mm256_andnot_ps (abs_help, ax), _mm256_andnot_ps (abs_help, by)),
+                                            _mm256_add_ps (_mm256_andnot_ps (abs_help, cz), _mm256_andnot_ps (abs_help, d_vec)));
+    const __m256 d_euclid_min = _mm256_max_ps (zero, _mm256_sub_ps (d_euclid, _mm256_mul_ps (eps, magnitude)));
+
+    const __m256 weight = _mm256_mul_ps (weight_vec, _mm256_sub_ps (one, curvature));
+    const __m256 weight_valid = _mm256_and_ps (_mm256_cmp_ps (weight, zero, _CMP_GE_OQ), _mm256_cmp_ps (weight, one, _CMP_LE_OQ));
+    const __m256 lower_bound = _mm256_mul_ps (_mm256_max_ps (zero, _mm256_sub_ps (_mm256_sub_ps (one, weight), eps)), d_euclid_min);
+    const __m256 reject = _mm256_and_ps (weight_valid, _mm256_cmp_ps (lower_bound, threshold_vec, _CMP_GE_OQ));
+
+    int candidates = ~_mm256_movemask_ps (reject) & 0xFF;
+    for (int j = 0; candidates != 0; ++j, candidates >>= 1)
+      if ((candidates & 1) && isWithinDistance ((*indices_)[i + j], coeff, model_coefficients[3], threshold))
+        nr_p++;
+  }
+  return (nr_p + countWithinDistanceStandard (model_coefficients, threshold, i));
 }
+#endif
+
+#undef NT
+#undef AT
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename PointNT> void
@@ -192,6 +322,47 @@ pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::getDistancesToModel (
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> bool
+pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::doSamplesVerifyModel (
+      const std::set<int> &indices, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  if (!normals_)
+  {
+    PCL_ERROR ("[pcl::SampleConsensusModelNormalPlane::doSamplesVerifyModel] No input dataset containing normals was given!\n");
+    return (false);
+  }
+
+  // Needs a valid set of model coefficients
+  if (model_coefficients.size () != model_size_)
+  {
+    PCL_ERROR ("[pcl::SampleConsensusModelNormalPlane::doSamplesVerifyModel] Invalid number of model coefficients given (%lu)!\n", model_coefficients.size ());
+    return (false);
+  }
+
+  // Obtain the plane normal
+  Eigen::Vector4f coeff = model_coefficients;
+  coeff[3] = 0;
+
+  for (const int &index : indices)
+    if (!isWithinDistance (index, coeff, model_coefficients[3], threshold))
+      return (false);
+
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> bool
+pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::doPointVerifyModel (
+      int index, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  if (!normals_)
+    return (false);
+
+  const Eigen::Vector4f coeff (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0.0f);
+  return (isWithinDistance (index, coeff, model_coefficients[3], threshold));
+}
+
 #define PCL_INSTANTIATE_SampleConsensusModelNormalPlane(PointT, PointNT) template class PCL_EXPORTS pcl::SampleConsensusModelNormalPlane<PointT, PointNT>;
 
 #endif    // PCL_SAMPLE_CONSENSUS_IMPL_SAC_MODEL_NORMAL_PLANE_H_
@@ -121,20 +121,16 @@ pcl::SampleConsensusModelPlane<PointT>::getDistancesToModel (
 
   distances.resize (indices_->size ());
 
+  // Same single precision evaluation as countWithinDistance ()
+  const float a = model_coefficients[0], b = model_coefficients[1], c = model_coefficients[2], d = model_coefficients[3];
+
   // Iterate through the 3d points and calculate the distances from them to the plane
   for (size_t i = 0; i < indices_->size (); ++i)
   {
     // Calculate the distance from the point to the plane normal as the dot product
     // D = (P-A).N/|N|
-    /*distances[i] = std::abs (model_coefficients[0] * input_->points[(*indices_)[i]].x +
-                         model_coefficients[1] * input_->points[(*indices_)[i]].y +
-                         model_coefficients[2] * input_->points[(*indices_)[i]].z +
-                         model_coefficients[3]);*/
-    Eigen::Vector4f pt (input_->points[(*indices_)[i]].x,
-                        input_->points[(*indices_)[i]].y,
-                        input_->points[(*indices_)[i]].z,
-                        1);
-    distances[i] = std::abs (model_coefficients.dot (pt));
+    const PointT &pt = input_->points[(*indices_)[i]];
+    distances[i] = std::abs ((a * pt.x + b * pt.y) + (c * pt.z + d));
   }
 }
 
@@ -150,6 +146,10 @@ pcl::SampleConsensusModelPlane<PointT>::selectWithinDistance (
     return;
   }
 
+  // Same single precision evaluation as countWithinDistance ()
+  const float a = model_coefficients[0], b = model_coefficients[1], c = model_coefficients[2], d = model_coefficients[3];
+  const float threshold_f = static_cast<float> (threshold);
+
   int nr_p = 0;
   inliers.resize (indices_->size ());
   error_sqr_dists_.resize (indices_->size ());
@@ -159,14 +159,10 @@ pcl::SampleConsensusModelPlane<PointT>::selectWithinDistance (
   {
     // Calculate the distance from the point to the plane normal as the dot product
     // D = (P-A).N/|N|
-    Eigen::Vector4f pt (input_->points[(*indices_)[i]].x,
-                        input_->points[(*indices_)[i]].y,
-                        input_->points[(*indices_)[i]].z,
-                        1);
-    
-    float distance = std::abs (model_coefficients.dot (pt));
-    
-    if (distance < threshold)
+    const PointT &pt = input_->points[(*indices_)[i]];
+    const float distance = std::abs ((a * pt.x + b * pt.y) + (c * pt.z + d));
+
+    if (distance < threshold_f)
     {
       // Returns the indices of the points whose distances are smaller than the threshold
       inliers[nr_p] = (*indices_)[i];
@@ -190,23 +186,126 @@ pcl::SampleConsensusModelPlane<PointT>::countWithinDistance (
     return (0);
   }
 
+#if defined (__AVX__)
+  return (countWithinDistanceAVX (model_coefficients, threshold));
+#elif defined (__SSE2__)
+  return (countWithinDistanceSSE (model_coefficients, threshold));
+#else
+  return (countWithinDistanceStandard (model_coefficients, threshold));
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelPlane<PointT>::countWithinDistanceStandard (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  // Evaluate in single precision and in the same order as the SIMD kernels, so that every path
+  // classifies a point identically
+  const float a = model_coefficients[0], b = model_coefficients[1], c = model_coefficients[2], d = model_coefficients[3];
+  const float threshold_f = static_cast<float> (threshold);
   int nr_p = 0;
 
   // Iterate through the 3d points and calculate the distances from them to the plane
-  for (size_t i = 0; i < indices_->size (); ++i)
+  for (; i < indices_->size (); ++i)
   {
     // Calculate the distance from the point to the plane normal as the dot product
     // D = (P-A).N/|N|
-    Eigen::Vector4f pt (input_->points[(*indices_)[i]].x,
-                        input_->points[(*indices_)[i]].y,
-                        input_->points[(*indices_)[i]].z,
-                        1);
-    if (std::abs (model_coefficients.dot (pt)) < threshold)
+    const PointT &pt = input_->points[(*indices_)[i]];
+    const float dist = (a * pt.x + b * pt.y) + (c * pt.z + d);
+    if (std::abs (dist) < threshold_f)
       nr_p++;
   }
   return (nr_p);
 }
 
+#define AT(POS) (input_->points[(*indices_)[(POS)]])
+
+#if defined (__SSE2__)
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> inline __m128
+pcl::SampleConsensusModelPlane<PointT>::dist4 (
+      std::size_t i, const __m128 &a_vec, const __m128 &b_vec, const __m128 &c_vec, const __m128 &d_vec) const
+{
+  // Pack the coordinates of the four points into SoA registers
+  const __m128 x = _mm_set_ps (AT(i + 3).x, AT(i + 2).x, AT(i + 1).x, AT(i).x);
+  const __m128 y = _mm_set_ps (AT(i + 3).y, AT(i + 2).y, AT(i + 1).y, AT(i).y);
+  const __m128 z = _mm_set_ps (AT(i + 3).z, AT(i + 2).z, AT(i + 1).z, AT(i).z);
+  const __m128 dist = _mm_add_ps (_mm_add_ps (_mm_mul_ps (a_vec, x), _mm_mul_ps (b_vec, y)),
+                                  _mm_add_ps (_mm_mul_ps (c_vec, z), d_vec));
+  // Clear the sign bit
+  return (_mm_andnot_ps (_mm_set1_ps (-0.0f), dist));
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelPlane<PointT>::countWithinDistanceSSE (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  const __m128 a_vec = _mm_set1_ps (model_coefficients[0]);
+  const __m128 b_vec = _mm_set1_ps (model_coefficients[1]);
+  const __m128 c_vec = _mm_set1_ps (model_coefficients[2]);
+  const __m128 d_vec = _mm_set1_ps (model_coefficients[3]);
+  const __m128 threshold_vec = _mm_set1_ps (static_cast<float> (threshold));
+
+  // The comparison masks are all ones (-1) for inliers, so subtracting them counts the inliers per lane
+  __m128i res = _mm_setzero_si128 ();
+  for (; (i + 4) <= indices_->size (); i += 4)
+  {
+    const __m128 mask = _mm_cmplt_ps (dist4 (i, a_vec, b_vec, c_vec, d_vec), threshold_vec);
+    res = _mm_sub_epi32 (res, _mm_castps_si128 (mask));
+  }
+  int res_lanes[4];
+  _mm_storeu_si128 (reinterpret_cast<__m128i*> (res_lanes), res);
+  const int nr_p = res_lanes[0] + res_lanes[1] + res_lanes[2] + res_lanes[3];
+  return (nr_p + countWithinDistanceStandard (model_coefficients, threshold, i));
+}
+#endif
+
+#if defined (__AVX__)
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> inline __m256
+pcl::SampleConsensusModelPlane<PointT>::dist8 (
+      std::size_t i, const __m256 &a_vec, const __m256 &b_vec, const __m256 &c_vec, const __m256 &d_vec) const
+{
+  // Pack the coordinates of the eight points into SoA registers
+  const __m256 x = _mm256_set_ps (AT(i + 7).x, AT(i + 6).x, AT(i + 5).x, AT(i + 4).x, AT(i + 3).x, AT(i + 2).x, AT(i + 1).x, AT(i).x);
+  const __m256 y = _mm256_set_ps (AT(i + 7).y, AT(i + 6).y, AT(i + 5).y, AT(i + 4).y, AT(i + 3).y, AT(i + 2).y, AT(i + 1).y, AT(i).y);
+  const __m256 z = _mm256_set_ps (AT(i + 7).z, AT(i + 6).z, AT(i + 5).z, AT(i + 4).z, AT(i + 3).z, AT(i + 2).z, AT(i + 1).z, AT(i).z);
+  const __m256 dist = _mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (a_vec, x), _mm256_mul_ps (b_vec, y)),
+                                     _mm256_add_ps (_mm256_mul_ps (c_vec, z), d_vec));
+  // Clear the sign bit
+  return (_mm256_andnot_ps (_mm256_set1_ps (-0.0f), dist));
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelPlane<PointT>::countWithinDistanceAVX (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  const __m256 a_vec = _mm256_set1_ps (model_coefficients[0]);
+  const __m256 b_vec = _mm256_set1_ps (model_coefficients[1]);
+  const __m256 c_vec = _mm256_set1_ps (model_coefficients[2]);
+  const __m256 d_vec = _mm256_set1_ps (model_coefficients[3]);
+  const __m256 threshold_vec = _mm256_set1_ps (static_cast<float> (threshold));
+
+  // The comparison masks are all ones (-1) for inliers, so subtracting both halves counts the inliers per lane
+  __m128i res = _mm_setzero_si128 ();
+  for (; (i + 8) <= indices_->size (); i += 8)
+  {
+    const __m256 mask = _mm256_cmp_ps (dist8 (i, a_vec, b_vec, c_vec, d_vec), threshold_vec, _CMP_LT_OQ);
+    res = _mm_sub_epi32 (res, _mm_castps_si128 (_mm256_castps256_ps128 (mask)));
+    res = _mm_sub_epi32 (res, _mm_castps_si128 (_mm256_extractf128_ps (mask, 1)));
+  }
+  int res_lanes[4];
+  _mm_storeu_si128 (reinterpret_cast<__m128i*> (res_lanes), res);
+  const int nr_p = res_lanes[0] + res_lanes[1] + res_lanes[2] + res_lanes[3];
+  return (nr_p + countWithinDistanceStandard (model_coefficients, threshold, i));
+}
+#endif
+
+#undef AT
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SampleConsensusModelPlane<PointT>::optimizeModelCoefficients (
@@ -353,18 +452,24 @@ pcl::SampleConsensusModelPlane<PointT>::doSamplesVerifyModel (
   }
 
   for (const int &index : indices)
-  {
-    Eigen::Vector4f pt (input_->points[index].x,
-                        input_->points[index].y,
-                        input_->points[index].z,
-                        1);
-    if (std::abs (model_coefficients.dot (pt)) > threshold)
+    if (!doPointVerifyModel (index, model_coefficients, threshold))
       return (false);
-  }
 
   return (true);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SampleConsensusModelPlane<PointT>::doPointVerifyModel (
+      int index, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  // Same single precision evaluation as countWithinDistance ()
+  const PointT &pt = input_->points[index];
+  const float distance = std::abs ((model_coefficients[0] * pt.x + model_coefficients[1] * pt.y) +
+                                   (model_coefficients[2] * pt.z + model_coefficients[3]));
+  return (distance < static_cast<float> (threshold));
+}
+
 #define PCL_INSTANTIATE_SampleConsensusModelPlane(T) template class PCL_EXPORTS pcl::SampleConsensusModelPlane<T>;
 
 #endif    // PCL_SAMPLE_CONSENSUS_IMPL_SAC_MODEL_PLANE_H_
@@ -234,6 +234,72 @@ pcl::SampleConsensusModelRegistration<PointT>::countWithinDistance (
   return (nr_p);
 } 
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SampleConsensusModelRegistration<PointT>::doSamplesVerifyModel (
+    const std::set<int> &indices, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  if (!target_ || model_coefficients.size () != model_size_)
+    return (false);
+
+  double thresh = threshold * threshold;
+
+  Eigen::Matrix4f transform;
+  transform.row (0).matrix () = model_coefficients.segment<4>(0);
+  transform.row (1).matrix () = model_coefficients.segment<4>(4);
+  transform.row (2).matrix () = model_coefficients.segment<4>(8);
+  transform.row (3).matrix () = model_coefficients.segment<4>(12);
+
+  for (const int &index : indices)
+  {
+    std::map<int, int>::const_iterator it = correspondences_.find (index);
+    if (it == correspondences_.end ())
+      return (false);
+
+    Eigen::Vector4f pt_src (input_->points[index].x,
+                            input_->points[index].y,
+                            input_->points[index].z, 1);
+    Eigen::Vector4f pt_tgt (target_->points[it->second].x,
+                            target_->points[it->second].y,
+                            target_->points[it->second].z, 1);
+
+    Eigen::Vector4f p_tr (transform * pt_src);
+    // Calculate the distance from the transformed point to its correspondence
+    if ((p_tr - pt_tgt).squaredNorm () >= thresh)
+      return (false);
+  }
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SampleConsensusModelRegistration<PointT>::doPointVerifyModel (
+      int index, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  if (!target_)
+    return (false);
+
+  std::map<int, int>::const_iterator it = correspondences_.find (index);
+  if (it == correspondences_.end ())
+    return (false);
+
+  Eigen::Matrix4f transform;
+  transform.row (0).matrix () = model_coefficients.segment<4>(0);
+  transform.row (1).matrix () = model_coefficients.segment<4>(4);
+  transform.row (2).matrix () = model_coefficients.segment<4>(8);
+  transform.row (3).matrix () = model_coefficients.segment<4>(12);
+
+  Eigen::Vector4f pt_src (input_->points[index].x,
+                          input_->points[index].y,
+                          input_->points[index].z, 1);
+  Eigen::Vector4f pt_tgt (target_->points[it->second].x,
+                          target_->points[it->second].y,
+                          target_->points[it->second].z, 1);
+
+  // Calculate the distance from the transformed point to its correspondence
+  return ((transform * pt_src - pt_tgt).squaredNorm () < threshold * threshold);
+}
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SampleConsensusModelRegistration<PointT>::optimizeModelCoefficients (const std::vector<int> &inliers, const Eigen::VectorXf &model_coefficients, Eigen::VectorXf &optimized_coefficients) const
@@ -226,5 +226,85 @@ pcl::SampleConsensusModelRegistration2D<PointT>::countWithinDistance (
   return (nr_p);
 } 
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SampleConsensusModelRegistration2D<PointT>::doSamplesVerifyModel (
+    const std::set<int> &indices, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  if (!target_ || model_coefficients.size () != model_size_)
+    return (false);
+
+  double thresh = threshold * threshold;
+
+  Eigen::Matrix4f transform;
+  transform.row (0).matrix () = model_coefficients.segment<4>(0);
+  transform.row (1).matrix () = model_coefficients.segment<4>(4);
+  transform.row (2).matrix () = model_coefficients.segment<4>(8);
+  transform.row (3).matrix () = model_coefficients.segment<4>(12);
+
+  for (const int &index : indices)
+  {
+    std::map<int, int>::const_iterator it = correspondences_.find (index);
+    if (it == correspondences_.end ())
+      return (false);
+
+    Eigen::Vector4f pt_src (input_->points[index].x,
+                            input_->points[index].y,
+                            input_->points[index].z, 1);
+
+    Eigen::Vector4f p_tr (transform * pt_src);
+
+    // Project the point on the image plane
+    Eigen::Vector3f p_tr3 (p_tr[0], p_tr[1], p_tr[2]);
+    Eigen::Vector3f uv (projection_matrix_ * p_tr3);
+
+    if (uv[2] < 0)
+      return (false);
+
+    uv /= uv[2];
+
+    // Calculate the distance from the transformed point to its correspondence
+    if ((uv[0] - target_->points[it->second].u) * (uv[0] - target_->points[it->second].u) +
+        (uv[1] - target_->points[it->second].v) * (uv[1] - target_->points[it->second].v) >= thresh)
+      return (false);
+  }
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SampleConsensusModelRegistration2D<PointT>::doPointVerifyModel (
+      int index, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  if (!target_)
+    return (false);
+
+  std::map<int, int>::const_iterator it = correspondences_.find (index);
+  if (it == correspondences_.end ())
+    return (false);
+
+  Eigen::Matrix4f transform;
+  transform.row (0).matrix () = model_coefficients.segment<4>(0);
+  transform.row (1).matrix () = model_coefficients.segment<4>(4);
+  transform.row (2).matrix () = model_coefficients.segment<4>(8);
+  transform.row (3).matrix () = model_coefficients.segment<4>(12);
+
+  Eigen::Vector4f pt_src (input_->points[index].x,
+                          input_->points[index].y,
+                          input_->points[index].z, 1);
+  Eigen::Vector4f p_tr (transform * pt_src);
+
+  // Project the point on the image plane
+  Eigen::Vector3f p_tr3 (p_tr[0], p_tr[1], p_tr[2]);
+  Eigen::Vector3f uv (projection_matrix_ * p_tr3);
+  if (uv[2] < 0)
+    return (false);
+  uv /= uv[2];
+
+  // Calculate the distance from the projected point to its correspondence
+  return ((uv[0] - target_->points[it->second].u) * (uv[0] - target_->points[it->second].u) +
+          (uv[1] - target_->points[it->second].v) * (uv[1] - target_->points[it->second].v) < threshold * threshold);
+}
+
 #endif    // PCL_SAMPLE_CONSENSUS_IMPL_SAC_MODEL_REGISTRATION_2D_HPP_
 
@@ -158,6 +158,9 @@ pcl::SampleConsensusModelSphere<PointT>::selectWithinDistance (
     return;
   }
 
+  // Compare in single precision, as countWithinDistance () does
+  const float threshold_f = static_cast<float> (threshold);
+
   int nr_p = 0;
   inliers.resize (indices_->size ());
   error_sqr_dists_.resize (indices_->size ());
@@ -165,7 +168,7 @@ pcl::SampleConsensusModelSphere<PointT>::selectWithinDistance (
   // Iterate through the 3d points and calculate the distances from them to the sphere
   for (size_t i = 0; i < indices_->size (); ++i)
   {
-    double distance = std::abs (std::sqrt (
+    const float distance = std::abs (std::sqrt (
                           ( input_->points[(*indices_)[i]].x - model_coefficients[0] ) *
                           ( input_->points[(*indices_)[i]].x - model_coefficients[0] ) +
 
@@ -177,7 +180,7 @@ pcl::SampleConsensusModelSphere<PointT>::selectWithinDistance (
                           ) - model_coefficients[3]);
     // Calculate the distance from the point to the sphere as the difference between
     // dist(point,sphere_origin) and sphere_radius
-    if (distance < threshold)
+    if (distance < threshold_f)
     {
       // Returns the indices of the points whose distances are smaller than the threshold
       inliers[nr_p] = (*indices_)[i];
@@ -198,10 +201,26 @@ pcl::SampleConsensusModelSphere<PointT>::countWithinDistance (
   if (!isModelValid (model_coefficients))
     return (0);
 
+#if defined (__AVX__)
+  return (countWithinDistanceAVX (model_coefficients, threshold));
+#elif defined (__SSE2__)
+  return (countWithinDistanceSSE (model_coefficients, threshold));
+#else
+  return (countWithinDistanceStandard (model_coefficients, threshold));
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelSphere<PointT>::countWithinDistanceStandard (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  // Compare in single precision, as the SIMD kernels do
+  const float threshold_f = static_cast<float> (threshold);
   int nr_p = 0;
 
   // Iterate through the 3d points and calculate the distances from them to the sphere
-  for (size_t i = 0; i < indices_->size (); ++i)
+  for (; i < indices_->size (); ++i)
   {
     // Calculate the distance from the point to the sphere as the difference between
     // dist(point,sphere_origin) and sphere_radius
@@ -214,12 +233,81 @@ pcl::SampleConsensusModelSphere<PointT>::countWithinDistance (
 
                         ( input_->points[(*indices_)[i]].z - model_coefficients[2] ) *
                         ( input_->points[(*indices_)[i]].z - model_coefficients[2] )
-                        ) - model_coefficients[3]) < threshold)
+                        ) - model_coefficients[3]) < threshold_f)
       nr_p++;
   }
   return (nr_p);
 }
 
+#define AT(POS) (input_->points[(*indices_)[(POS)]])
+
+#if defined (__SSE2__)
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelSphere<PointT>::countWithinDistanceSSE (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  const __m128 center_x = _mm_set1_ps (model_coefficients[0]);
+  const __m128 center_y = _mm_set1_ps (model_coefficients[1]);
+  const __m128 center_z = _mm_set1_ps (model_coefficients[2]);
+  const __m128 radius = _mm_set1_ps (model_coefficients[3]);
+  const __m128 threshold_vec = _mm_set1_ps (static_cast<float> (threshold));
+  const __m128 abs_help = _mm_set1_ps (-0.0f);
+
+  // The comparison masks are all ones (-1) for inliers, so subtracting them counts the inliers per lane
+  __m128i res = _mm_setzero_si128 ();
+  for (; (i + 4) <= indices_->size (); i += 4)
+  {
+    // Pack the four points into SoA registers, relative to the sphere center
+    const __m128 dx = _mm_sub_ps (_mm_set_ps (AT(i + 3).x, AT(i + 2).x, AT(i + 1).x, AT(i).x), center_x);
+    const __m128 dy = _mm_sub_ps (_mm_set_ps (AT(i + 3).y, AT(i + 2).y, AT(i + 1).y, AT(i).y), center_y);
+    const __m128 dz = _mm_sub_ps (_mm_set_ps (AT(i + 3).z, AT(i + 2).z, AT(i + 1).z, AT(i).z), center_z);
+    const __m128 dist = _mm_sqrt_ps (_mm_add_ps (_mm_add_ps (_mm_mul_ps (dx, dx), _mm_mul_ps (dy, dy)), _mm_mul_ps (dz, dz)));
+    const __m128 mask = _mm_cmplt_ps (_mm_andnot_ps (abs_help, _mm_sub_ps (dist, radius)), threshold_vec);
+    res = _mm_sub_epi32 (res, _mm_castps_si128 (mask));
+  }
+  int res_lanes[4];
+  _mm_storeu_si128 (reinterpret_cast<__m128i*> (res_lanes), res);
+  const int nr_p = res_lanes[0] + res_lanes[1] + res_lanes[2] + res_lanes[3];
+  return (nr_p + countWithinDistanceStandard (model_coefficients, threshold, i));
+}
+#endif
+
+#if defined (__AVX__)
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelSphere<PointT>::countWithinDistanceAVX (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  const __m256 center_x = _mm256_set1_ps (model_coefficients[0]);
+  const __m256 center_y = _mm256_set1_ps (model_coefficients[1]);
+  const __m256 center_z = _mm256_set1_ps (model_coefficients[2]);
+  const __m256 radius = _mm256_set1_ps (model_coefficients[3]);
+  const __m256 threshold_vec = _mm256_set1_ps (static_cast<float> (threshold));
+  const __m256 abs_help = _mm256_set1_ps (-0.0f);
+
+  // The comparison masks are all ones (-1) for inliers, so subtracting both halves counts the inliers per lane
+  __m128i res = _mm_setzero_si128 ();
+  for (; (i + 8) <= indices_->size (); i += 8)
+  {
+    // Pack the eight points into SoA registers, relative to the sphere center
+    const __m256 dx = _mm256_sub_ps (_mm256_set_ps (AT(i + 7).x, AT(i + 6).x, AT(i + 5).x, AT(i + 4).x, AT(i + 3).x, AT(i + 2).x, AT(i + 1).x, AT(i).x), center_x);
+    const __m256 dy = _mm256_sub_ps (_mm256_set_ps (AT(i + 7).y, AT(i + 6).y, AT(i + 5).y, AT(i + 4).y, AT(i + 3).y, AT(i + 2).y, AT(i + 1).y, AT(i).y), center_y);
+    const __m256 dz = _mm256_sub_ps (_mm256_set_ps (AT(i + 7).z, AT(i + 6).z, AT(i + 5).z, AT(i + 4).z, AT(i + 3).z, AT(i + 2).z, AT(i + 1).z, AT(i).z), center_z);
+    const __m256 dist = _mm256_sqrt_ps (_mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (dx, dx), _mm256_mul_ps (dy, dy)), _mm256_mul_ps (dz, dz)));
+    const __m256 mask = _mm256_cmp_ps (_mm256_andnot_ps (abs_help, _mm256_sub_ps (dist, radius)), threshold_vec, _CMP_LT_OQ);
+    res = _mm_sub_epi32 (res, _mm_castps_si128 (_mm256_castps256_ps128 (mask)));
+    res = _mm_sub_epi32 (res, _mm_castps_si128 (_mm256_extractf128_ps (mask, 1)));
+  }
+  int res_lanes[4];
+  _mm_storeu_si128 (reinterpret_cast<__m128i*> (res_lanes), res);
+  const int nr_p = res_lanes[0] + res_lanes[1] + res_lanes[2] + res_lanes[3];
+  return (nr_p + countWithinDistanceStandard (model_coefficients, threshold, i));
+}
+#endif
+
+#undef AT
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SampleConsensusModelSphere<PointT>::optimizeModelCoefficients (
@@ -287,21 +375,29 @@ pcl::SampleConsensusModelSphere<PointT>::doSamplesVerifyModel (
   }
 
   for (const int &index : indices)
-    // Calculate the distance from the point to the sphere as the difference between
-    //dist(point,sphere_origin) and sphere_radius
-    if (std::abs (sqrt (
-                    ( input_->points[index].x - model_coefficients[0] ) *
-                    ( input_->points[index].x - model_coefficients[0] ) +
-                    ( input_->points[index].y - model_coefficients[1] ) *
-                    ( input_->points[index].y - model_coefficients[1] ) +
-                    ( input_->points[index].z - model_coefficients[2] ) *
-                    ( input_->points[index].z - model_coefficients[2] )
-                   ) - model_coefficients[3]) > threshold)
+    if (!doPointVerifyModel (index, model_coefficients, threshold))
       return (false);
 
   return (true);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SampleConsensusModelSphere<PointT>::doPointVerifyModel (
+      int index, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  // Calculate the distance from the point to the sphere as the difference between
+  // dist(point,sphere_origin) and sphere_radius
+  return (std::abs (std::sqrt (
+                      ( input_->points[index].x - model_coefficients[0] ) *
+                      ( input_->points[index].x - model_coefficients[0] ) +
+                      ( input_->points[index].y - model_coefficients[1] ) *
+                      ( input_->points[index].y - model_coefficients[1] ) +
+                      ( input_->points[index].z - model_coefficients[2] ) *
+                      ( input_->points[index].z - model_coefficients[2] )
+                     ) - model_coefficients[3]) < static_cast<float> (threshold));
+}
+
 #define PCL_INSTANTIATE_SampleConsensusModelSphere(T) template class PCL_EXPORTS pcl::SampleConsensusModelSphere<T>;
 
 #endif    // PCL_SAMPLE_CONSENSUS_IMPL_SAC_MODEL_SPHERE_H_
@@ -68,6 +68,8 @@ namespace pcl
       using SampleConsensus<PointT>::model_;
       using SampleConsensus<PointT>::model_coefficients_;
       using SampleConsensus<PointT>::inliers_;
+      using SampleConsensus<PointT>::getHypothesisBatchSize;
+      using SampleConsensus<PointT>::drawSamples;
 
       /** \brief LMedS (Least Median of Squares) main constructor
         * \param[in] model a Sample Consensus model
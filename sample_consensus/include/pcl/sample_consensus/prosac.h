@@ -68,6 +68,7 @@ namespace pcl
       using SampleConsensus<PointT>::model_coefficients_;
       using SampleConsensus<PointT>::inliers_;
       using SampleConsensus<PointT>::probability_;
+      using SampleConsensus<PointT>::getHypothesisBatchSize;
 
       /** \brief PROSAC (Progressive SAmple Consensus) main constructor
         * \param[in] model a Sample Consensus model
@@ -68,6 +68,15 @@ namespace pcl
       using SampleConsensus<PointT>::model_coefficients_;
       using SampleConsensus<PointT>::inliers_;
       using SampleConsensus<PointT>::probability_;
+      using SampleConsensus<PointT>::getHypothesisBatchSize;
+      using SampleConsensus<PointT>::drawSamples;
+      using SampleConsensus<PointT>::initPreemptiveTest;
+      using SampleConsensus<PointT>::isPreemptiveTestActive;
+      using SampleConsensus<PointT>::drawPreemptiveOffset;
+      using SampleConsensus<PointT>::preemptiveTestPasses;
+      using SampleConsensus<PointT>::updatePreemptiveTest;
+      using SampleConsensus<PointT>::setPreemptiveInlierRatio;
+      using SampleConsensus<PointT>::getPreemptiveAcceptanceProbability;
 
       /** \brief RANSAC (RAndom SAmple Consensus) main constructor
         * \param[in] model a Sample Consensus model
@@ -43,12 +43,28 @@
 #include <pcl/sample_consensus/boost.h>
 #include <pcl/sample_consensus/sac_model.h>
 
+#include <algorithm>
+#include <cmath>
 #include <ctime>
 #include <memory>
 #include <set>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace pcl
 {
+  /** \brief Randomized pre-verification applied to a model hypothesis before it is scored against all the data.
+    * \ingroup sample_consensus
+    */
+  enum SacPreemptiveTest
+  {
+    SAC_PREEMPTIVE_NONE = 0,  ///< every hypothesis is scored against all the data
+    SAC_PREEMPTIVE_TDD  = 1,  ///< T(d,d) test: reject unless d random points are all inliers (Matas and Chum, 2002)
+    SAC_PREEMPTIVE_SPRT = 2   ///< Wald's sequential probability ratio test (Chum and Matas, "Optimal Randomized RANSAC", 2008)
+  };
+
   /** \brief SampleConsensus represents the base class. All sample consensus methods must inherit from this class.
     * \author Radu Bogdan Rusu
     * \ingroup sample_consensus
@@ -76,6 +92,14 @@ namespace pcl
         , iterations_ (0)
         , threshold_ (std::numeric_limits<double>::max ())
         , max_iterations_ (1000)
+        , threads_ (1)
+        , preemptive_test_ (SAC_PREEMPTIVE_NONE)
+        , preemptive_test_size_ (1)
+        , sprt_epsilon_ (0.1)
+        , sprt_delta_ (0.01)
+        , sprt_A_ (0.0)
+        , sprt_rejected_tested_ (0)
+        , sprt_rejected_consistent_ (0)
         , rng_ (new boost::uniform_01<boost::mt19937> (rng_alg_))
       {
          // Create a random number generator object
@@ -98,6 +122,14 @@ namespace pcl
         , iterations_ (0)
         , threshold_ (threshold)
         , max_iterations_ (1000)
+        , threads_ (1)
+        , preemptive_test_ (SAC_PREEMPTIVE_NONE)
+        , preemptive_test_size_ (1)
+        , sprt_epsilon_ (0.1)
+        , sprt_delta_ (0.01)
+        , sprt_A_ (0.0)
+        , sprt_rejected_tested_ (0)
+        , sprt_rejected_consistent_ (0)
         , rng_ (new boost::uniform_01<boost::mt19937> (rng_alg_))
       {
          // Create a random number generator object
@@ -157,6 +189,55 @@ namespace pcl
       inline double 
       getProbability () const { return (probability_); }
 
+      /** \brief Set the number of threads used to evaluate model hypotheses.
+        * Hypotheses are still drawn sequentially from the model, so for a given number of threads
+        * the result is deterministic. Only honored by the estimators that support it (RANSAC, MSAC,
+        * LMedS and PROSAC), and only if PCL was compiled with OpenMP.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        if (nr_threads == 0)
+#ifdef _OPENMP
+          threads_ = omp_get_num_procs ();
+#else
+          threads_ = 1;
+#endif
+        else
+          threads_ = nr_threads;
+      }
+
+      /** \brief Get the number of threads used to evaluate model hypotheses. */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
+      /** \brief Set the randomized pre-verification used to discard bad hypotheses early.
+        * With SAC_PREEMPTIVE_TDD or SAC_PREEMPTIVE_SPRT, a hypothesis is first checked against randomly
+        * chosen points and only scored against all the data if it passes. This greatly reduces the
+        * verification cost when the inlier ratio is low. The number of iterations is adapted to the
+        * probability of rejecting a good hypothesis. Only honored by RANSAC and MSAC. The test relies on
+        * SampleConsensusModel::doPointVerifyModel. Random points are drawn from the estimator's own
+        * generator, so results stay deterministic for a given number of threads.
+        * \param[in] test the pre-verification test to use (default: SAC_PREEMPTIVE_NONE)
+        */
+      inline void
+      setPreemptiveTest (SacPreemptiveTest test) { preemptive_test_ = test; }
+
+      /** \brief Get the randomized pre-verification used to discard bad hypotheses early. */
+      inline SacPreemptiveTest
+      getPreemptiveTest () const { return (preemptive_test_); }
+
+      /** \brief Set the number of random points d that must all be inliers for a hypothesis to pass the T(d,d) test.
+        * \param[in] nr_points the number of points tested (default: 1)
+        */
+      inline void
+      setPreemptiveTestSize (unsigned int nr_points) { preemptive_test_size_ = (std::max) (1u, nr_points); }
+
+      /** \brief Get the number of random points tested by the T(d,d) test. */
+      inline unsigned int
+      getPreemptiveTestSize () const { return (preemptive_test_size_); }
+
       /** \brief Compute the actual model. Pure virtual. */
       virtual bool 
       computeModel (int debug_verbosity_level = 0) = 0;
@@ -323,6 +404,30 @@ namespace pcl
       /** \brief Maximum number of iterations before giving up. */
       int max_iterations_;
 
+      /** \brief The number of threads used to evaluate model hypotheses. */
+      unsigned int threads_;
+
+      /** \brief The randomized pre-verification used to discard bad hypotheses early. */
+      SacPreemptiveTest preemptive_test_;
+
+      /** \brief The number of points tested by the T(d,d) test. */
+      unsigned int preemptive_test_size_;
+
+      /** \brief A random permutation of the model indices, in which order the pre-verification visits the points. */
+      std::vector<int> preemptive_order_;
+
+      /** \brief SPRT: probability that a point is consistent with a good model (the best inlier ratio so far). */
+      double sprt_epsilon_;
+
+      /** \brief SPRT: probability that a point is consistent with a bad model. */
+      double sprt_delta_;
+
+      /** \brief SPRT: decision threshold on the likelihood ratio. */
+      double sprt_A_;
+
+      /** \brief SPRT: number of points tested / found consistent for the hypotheses rejected so far, used to estimate delta. */
+      std::size_t sprt_rejected_tested_, sprt_rejected_consistent_;
+
       /** \brief Boost-based random number generator algorithm. */
       boost::mt19937 rng_alg_;
 
@@ -335,5 +440,190 @@ namespace pcl
       {
         return ((*rng_) ());
       }
+
+      /** \brief Get the number of hypotheses that are evaluated together, i.e. in parallel. */
+      inline int
+      getHypothesisBatchSize () const
+      {
+#ifdef _OPENMP
+        return (threads_ > 1 ? static_cast<int> (threads_) : 1);
+#else
+        return (1);
+#endif
+      }
+
+      /** \brief Draw up to \a nr_samples consecutive samples from the model.
+        * Sampling advances the random number generator of the model and is therefore always done sequentially,
+        * in the same order as a one-at-a-time loop would.
+        * \param[in] nr_samples the number of samples to draw
+        * \param[out] selections the drawn samples
+        * \return the number of samples drawn, less than \a nr_samples if the model could not provide a sample
+        */
+      inline int
+      drawSamples (int nr_samples, std::vector<std::vector<int> > &selections)
+      {
+        selections.resize (nr_samples);
+        for (int i = 0; i < nr_samples; ++i)
+        {
+          // getSamples () sets iterations_ to INT_MAX - 1 if the model can never provide a sample
+          sac_model_->getSamples (iterations_, selections[i]);
+          if (selections[i].empty ())
+            return (i);
+        }
+        return (nr_samples);
+      }
+
+      /** \brief Reset the pre-verification state. Called at the start of computeModel (). */
+      inline void
+      initPreemptiveTest ()
+      {
+        preemptive_order_.clear ();
+        if (preemptive_test_ == SAC_PREEMPTIVE_NONE)
+          return;
+
+        preemptive_order_ = *sac_model_->getIndices ();
+        for (std::size_t i = preemptive_order_.size (); i > 1; --i)
+          std::swap (preemptive_order_[i - 1], preemptive_order_[static_cast<std::size_t> (static_cast<double> (i) * rnd ())]);
+
+        sprt_epsilon_ = 0.1;
+        sprt_delta_ = 0.01;
+        sprt_rejected_tested_ = sprt_rejected_consistent_ = 0;
+        updateSPRTThreshold ();
+      }
+
+      /** \brief Check whether hypotheses should be pre-verified. Estimators only do so once a first model was found,
+        * as the number of iterations is not known before.
+        */
+      inline bool
+      isPreemptiveTestActive () const
+      {
+        return (preemptive_test_ != SAC_PREEMPTIVE_NONE && !preemptive_order_.empty ());
+      }
+
+      /** \brief Draw the position in the random point order from which a hypothesis is pre-verified. */
+      inline std::size_t
+      drawPreemptiveOffset ()
+      {
+        return (static_cast<std::size_t> (static_cast<double> (preemptive_order_.size ()) * rnd ()) % preemptive_order_.size ());
+      }
+
+      /** \brief Pre-verify a model hypothesis. Safe to call concurrently for different hypotheses.
+        * \param[in] model_coefficients the hypothesis
+        * \param[in] offset the position in the random point order to start from, see drawPreemptiveOffset ()
+        * \param[out] nr_tested the number of points tested
+        * \param[out] nr_consistent the number of tested points that were inliers
+        * \return false if the hypothesis should be discarded without being scored
+        */
+      bool
+      preemptiveTestPasses (const Eigen::VectorXf &model_coefficients, std::size_t offset,
+                            std::size_t &nr_tested, std::size_t &nr_consistent) const
+      {
+        const std::size_t nr_points = preemptive_order_.size ();
+        nr_tested = nr_consistent = 0;
+        if (preemptive_test_ == SAC_PREEMPTIVE_TDD)
+        {
+          const std::size_t nr_test_points = (std::min) (static_cast<std::size_t> (preemptive_test_size_), nr_points);
+          while (nr_tested < nr_test_points)
+          {
+            const int index = preemptive_order_[(offset + nr_tested) % nr_points];
+            ++nr_tested;
+            if (!sac_model_->doPointVerifyModel (index, model_coefficients, threshold_))
+              return (false);
+            ++nr_consistent;
+          }
+          return (true);
+        }
+
+        // SPRT is meaningless if bad models are as likely to explain a point as good ones
+        if (sprt_delta_ >= sprt_epsilon_)
+          return (true);
+
+        // The test is truncated once the hypothesis survived four times the expected number of evaluations
+        // needed to reject a bad model; surviving hypotheses are scored exactly anyway
+        const double log_consistent = std::log (sprt_delta_ / sprt_epsilon_);
+        const double log_inconsistent = std::log ((1.0 - sprt_delta_) / (1.0 - sprt_epsilon_));
+        const double log_A = std::log (sprt_A_);
+        const double C = (1.0 - sprt_delta_) * log_inconsistent + sprt_delta_ * log_consistent;
+        const std::size_t max_tested = (std::min) (nr_points, static_cast<std::size_t> (4.0 * log_A / C) + 16);
+
+        double log_lambda = 0.0;
+        while (nr_tested < max_tested)
+        {
+          const int index = preemptive_order_[(offset + nr_tested) % nr_points];
+          ++nr_tested;
+          if (sac_model_->doPointVerifyModel (index, model_coefficients, threshold_))
+          {
+            ++nr_consistent;
+            log_lambda += log_consistent;
+          }
+          else
+            log_lambda += log_inconsistent;
+          if (log_lambda > log_A)
+            return (false);
+        }
+        return (true);
+      }
+
+      /** \brief Account for the pre-verification outcome of a hypothesis, in the order the hypotheses were drawn. */
+      inline void
+      updatePreemptiveTest (bool passed, std::size_t nr_tested, std::size_t nr_consistent)
+      {
+        if (preemptive_test_ != SAC_PREEMPTIVE_SPRT || passed)
+          return;
+        // Rejected hypotheses are (almost always) bad ones, use them to estimate delta
+        sprt_rejected_tested_ += nr_tested;
+        sprt_rejected_consistent_ += nr_consistent;
+        if (sprt_rejected_tested_ < 100)
+          return;
+        const double delta = (std::max) (1e-4, static_cast<double> (sprt_rejected_consistent_) / static_cast<double> (sprt_rejected_tested_));
+        if (std::abs (delta - sprt_delta_) > 0.05 * sprt_delta_)
+        {
+          sprt_delta_ = delta;
+          updateSPRTThreshold ();
+        }
+      }
+
+      /** \brief Update the pre-verification with the inlier ratio of a new best model. */
+      inline void
+      setPreemptiveInlierRatio (double inlier_ratio)
+      {
+        if (preemptive_test_ != SAC_PREEMPTIVE_SPRT)
+          return;
+        sprt_epsilon_ = (std::min) (1.0 - 1e-6, (std::max) (1e-6, inlier_ratio));
+        updateSPRTThreshold ();
+      }
+
+      /** \brief Get the probability that a hypothesis computed from an all-inlier sample passes the pre-verification.
+        * \param[in] inlier_ratio the inlier ratio of the data
+        */
+      inline double
+      getPreemptiveAcceptanceProbability (double inlier_ratio) const
+      {
+        switch (preemptive_test_)
+        {
+          case SAC_PREEMPTIVE_TDD:
+            return (std::pow (inlier_ratio, static_cast<double> (preemptive_test_size_)));
+          case SAC_PREEMPTIVE_SPRT:
+            return (sprt_delta_ < sprt_epsilon_ ? 1.0 - 1.0 / sprt_A_ : 1.0);
+          default:
+            return (1.0);
+        }
+      }
+
+      /** \brief Recompute the SPRT decision threshold A from the current epsilon and delta. The cost of computing a
+        * model is assumed to be 200 point evaluations, with one model per sample.
+        */
+      inline void
+      updateSPRTThreshold ()
+      {
+        if (sprt_delta_ >= sprt_epsilon_)
+          return;
+        const double C = (1.0 - sprt_delta_) * std::log ((1.0 - sprt_delta_) / (1.0 - sprt_epsilon_)) +
+                         sprt_delta_ * std::log (sprt_delta_ / sprt_epsilon_);
+        const double A0 = 200.0 / C + 1.0;
+        sprt_A_ = A0;
+        for (int i = 0; i < 10; ++i)
+          sprt_A_ = A0 + std::log (sprt_A_);
+      }
    };
 }
@@ -40,6 +40,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cfloat>
 #include <ctime>
 #include <climits>
@@ -148,6 +149,7 @@ namespace pcl
           indices_->clear ();
         }
         shuffled_indices_ = *indices_;
+        samples_mask_.clear ();
 
         // Create a random number generator object
         rng_gen_.reset (new boost::variate_generator<boost::mt19937&, boost::uniform_int<> > (rng_alg_, *rng_dist_)); 
@@ -284,6 +286,26 @@ namespace pcl
                             const Eigen::VectorXf &model_coefficients,
                             const double threshold) const = 0;
 
+      /** \brief Verify whether a single point verifies a given set of model coefficients.
+        *
+        * Used by the pre-verification tests of SampleConsensus, which check points one at a time. The
+        * default implementation wraps the index into a set for doSamplesVerifyModel; models override it
+        * to test the point directly. The coefficients are expected to be valid for the model.
+        *
+        * \param[in] index the data index that needs to be tested against the model
+        * \param[in] model_coefficients the set of model coefficients
+        * \param[in] threshold a maximum admissible distance threshold for
+        * determining the inliers from the outliers
+        */
+      virtual bool
+      doPointVerifyModel (int index,
+                          const Eigen::VectorXf &model_coefficients,
+                          const double threshold) const
+      {
+        const std::set<int> indices = {index};
+        return (doSamplesVerifyModel (indices, model_coefficients, threshold));
+      }
+
       /** \brief Provide a pointer to the input dataset
         * \param[in] cloud the const boost shared pointer to a PointCloud message
         */
@@ -301,6 +323,7 @@ namespace pcl
             (*indices_)[i] = static_cast<int> (i);
         }
         shuffled_indices_ = *indices_;
+        samples_mask_.clear ();
        }
 
       /** \brief Get a pointer to the input point cloud dataset. */
@@ -315,6 +338,7 @@ namespace pcl
       { 
         indices_ = indices; 
         shuffled_indices_ = *indices_;
+        samples_mask_.clear ();
        }
 
       /** \brief Provide the vector of indices that represents the input data.
@@ -325,6 +349,7 @@ namespace pcl
       { 
         indices_.reset (new std::vector<int> (indices));
         shuffled_indices_ = indices;
+        samples_mask_.clear ();
        }
 
       /** \brief Get a pointer to the vector of indices used. */
@@ -475,6 +500,21 @@ namespace pcl
         samples_radius_search_->radiusSearch (input_->at(shuffled_indices_[0]),
                                               samples_radius_, indices, sqr_dists );
 
+        // The search may span more points than the indices, keep the neighbors among the indices only,
+        // without the first sample itself
+        if (samples_mask_.size () != input_->points.size ())
+        {
+          samples_mask_.assign (input_->points.size (), false);
+          for (const int &index : shuffled_indices_)
+            samples_mask_[index] = true;
+        }
+        const int first_sample = shuffled_indices_[0];
+        indices.erase (std::remove_if (indices.begin (), indices.end (), [this, first_sample] (int index)
+                                       {
+                                         return (index == first_sample || !samples_mask_[index]);
+                                       }),
+                       indices.end ());
+
         if (indices.size () < sample_size - 1)
         {
           // radius search failed, make an invalid model
@@ -543,6 +583,9 @@ namespace pcl
       /** Data containing a shuffled version of the indices. This is used and modified when drawing samples. */
       std::vector<int> shuffled_indices_;
 
+      /** \brief Membership of the input points in the indices, built on demand when drawing radius samples. */
+      std::vector<bool> samples_mask_;
+
       /** \brief Boost-based random number generator algorithm. */
       boost::mt19937 rng_alg_;
 
@@ -262,6 +262,16 @@ namespace pcl
                             const Eigen::VectorXf &model_coefficients,
                             const double threshold) const override;
 
+      /** \brief Verify whether a single point verifies the given cone model coefficients.
+        * \param[in] index the data index that needs to be tested against the cone model
+        * \param[in] model_coefficients the cone model coefficients
+        * \param[in] threshold a maximum admissible distance threshold for determining the inliers from the outliers
+        */
+      bool
+      doPointVerifyModel (int index,
+                          const Eigen::VectorXf &model_coefficients,
+                          const double threshold) const override;
+
       /** \brief Return a unique id for this model (SACMODEL_CONE). */
       inline pcl::SacModel 
       getModelType () const override { return (SACMODEL_CONE); }
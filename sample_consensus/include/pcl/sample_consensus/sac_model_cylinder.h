@@ -45,6 +45,13 @@
 #include <pcl/common/common.h>
 #include <pcl/common/distances.h>
 
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined (__AVX__)
+#include <immintrin.h>
+#endif
+
 namespace pcl
 {
   /** \brief @b SampleConsensusModelCylinder defines a model for 3D cylinder segmentation.
@@ -199,6 +206,40 @@ namespace pcl
       countWithinDistance (const Eigen::VectorXf &model_coefficients,
                            const double threshold) const override;
 
+      /** \brief Count the inliers with plain scalar code, starting at position \a i of the indices.
+        * Used for the tail of the SIMD implementations; not intended for normal use, see countWithinDistance
+        * which picks the fastest implementation available.
+        * \param[in] model_coefficients the (valid) coefficients of the cylinder model
+        * \param[in] threshold maximum admissible distance threshold for determining the inliers from the outliers
+        * \param[in] i the position in the indices to start from
+        */
+      int
+      countWithinDistanceStandard (const Eigen::VectorXf &model_coefficients,
+                                   const double threshold,
+                                   std::size_t i = 0) const;
+
+#if defined (__SSE2__)
+      /** \brief Count the inliers using SSE2, four points at a time; see countWithinDistanceStandard.
+        * Points whose distance to the cylinder surface alone already exceeds the threshold are rejected in SIMD,
+        * the exact (angular) test is only evaluated for the remaining candidates, so the result is the same.
+        */
+      int
+      countWithinDistanceSSE (const Eigen::VectorXf &model_coefficients,
+                              const double threshold,
+                              std::size_t i = 0) const;
+#endif
+
+#if defined (__AVX__)
+      /** \brief Count the inliers using AVX, eight points at a time; see countWithinDistanceStandard.
+        * Points whose distance to the cylinder surface alone already exceeds the threshold are rejected in SIMD,
+        * the exact (angular) test is only evaluated for the remaining candidates, so the result is the same.
+        */
+      int
+      countWithinDistanceAVX (const Eigen::VectorXf &model_coefficients,
+                              const double threshold,
+                              std::size_t i = 0) const;
+#endif
+
       /** \brief Recompute the cylinder coefficients using the given inlier set and return them to the user.
         * @note: these are the coefficients of the cylinder model after refinement (e.g. after SVD)
         * \param[in] inliers the data inliers found as supporting the model
@@ -233,6 +274,16 @@ namespace pcl
                             const Eigen::VectorXf &model_coefficients,
                             const double threshold) const override;
 
+      /** \brief Verify whether a single point verifies the given cylinder model coefficients.
+        * \param[in] index the data index that needs to be tested against the cylinder model
+        * \param[in] model_coefficients the cylinder model coefficients
+        * \param[in] threshold a maximum admissible distance threshold for determining the inliers from the outliers
+        */
+      bool
+      doPointVerifyModel (int index,
+                          const Eigen::VectorXf &model_coefficients,
+                          const double threshold) const override;
+
       /** \brief Return a unique id for this model (SACMODEL_CYLINDER). */
       inline pcl::SacModel 
       getModelType () const override { return (SACMODEL_CYLINDER); }
@@ -290,6 +341,20 @@ namespace pcl
       isSampleGood (const std::vector<int> &samples) const override;
 
     private:
+      /** \brief Exact inlier test of the point at position \a i of the indices.
+        * \param[in] i the position in the indices
+        * \param[in] model_coefficients the cylinder model coefficients
+        * \param[in] line_pt the point on the cylinder axis
+        * \param[in] line_dir the direction of the cylinder axis
+        * \param[in] ptdotdir the dot product of \a line_pt and \a line_dir
+        * \param[in] dirdotdir the inverse squared norm of \a line_dir
+        * \param[in] threshold maximum admissible distance threshold for determining the inliers from the outliers
+        */
+      inline bool
+      isWithinDistance (std::size_t i, const Eigen::VectorXf &model_coefficients,
+                        const Eigen::Vector4f &line_pt, const Eigen::Vector4f &line_dir,
+                        float ptdotdir, float dirdotdir, double threshold) const;
+
       /** \brief The axis along which we need to search for a cylinder direction. */
       Eigen::Vector3f axis_;
     
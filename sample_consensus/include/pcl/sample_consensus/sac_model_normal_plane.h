@@ -146,6 +146,40 @@ namespace pcl
       countWithinDistance (const Eigen::VectorXf &model_coefficients,
                            const double threshold) const override;
 
+      /** \brief Count the inliers with plain scalar code, starting at position \a i of the indices.
+        * Used for the tail of the SIMD implementations; not intended for normal use, see countWithinDistance
+        * which picks the fastest implementation available.
+        * \param[in] model_coefficients the (valid) coefficients of the plane model
+        * \param[in] threshold maximum admissible distance threshold for determining the inliers from the outliers
+        * \param[in] i the position in the indices to start from
+        */
+      int
+      countWithinDistanceStandard (const Eigen::VectorXf &model_coefficients,
+                                   const double threshold,
+                                   std::size_t i = 0) const;
+
+#if defined (__SSE2__)
+      /** \brief Count the inliers using SSE2, four points at a time; see countWithinDistanceStandard.
+        * Points whose Euclidean distance alone already exceeds the threshold are rejected in SIMD, the exact
+        * (angular) test is only evaluated for the remaining candidates, so the result is the same.
+        */
+      int
+      countWithinDistanceSSE (const Eigen::VectorXf &model_coefficients,
+                              const double threshold,
+                              std::size_t i = 0) const;
+#endif
+
+#if defined (__AVX__)
+      /** \brief Count the inliers using AVX, eight points at a time; see countWithinDistanceStandard.
+        * Points whose Euclidean distance alone already exceeds the threshold are rejected in SIMD, the exact
+        * (angular) test is only evaluated for the remaining candidates, so the result is the same.
+        */
+      int
+      countWithinDistanceAVX (const Eigen::VectorXf &model_coefficients,
+                              const double threshold,
+                              std::size_t i = 0) const;
+#endif
+
       /** \brief Compute all distances from the cloud data to a given plane model.
         * \param[in] model_coefficients the coefficients of a plane model that we need to compute distances to
         * \param[out] distances the resultant estimated distances
@@ -154,6 +188,28 @@ namespace pcl
       getDistancesToModel (const Eigen::VectorXf &model_coefficients,
                            std::vector<double> &distances) const override;
 
+      /** \brief Verify whether a subset of indices verifies the given plane model coefficients, with the same
+        * normal-weighted distance as countWithinDistance.
+        * \param[in] indices the data indices that need to be tested against the plane model
+        * \param[in] model_coefficients plane model coefficients
+        * \param[in] threshold a maximum admissible distance threshold for determining the inliers from the outliers
+        */
+      bool
+      doSamplesVerifyModel (const std::set<int> &indices,
+                            const Eigen::VectorXf &model_coefficients,
+                            const double threshold) const override;
+
+      /** \brief Verify whether a single point verifies the given plane model coefficients, with the same
+        * normal-weighted distance as countWithinDistance.
+        * \param[in] index the data index that needs to be tested against the plane model
+        * \param[in] model_coefficients the (valid) plane model coefficients
+        * \param[in] threshold a maximum admissible distance threshold for determining the inliers from the outliers
+        */
+      bool
+      doPointVerifyModel (int index,
+                          const Eigen::VectorXf &model_coefficients,
+                          const double threshold) const override;
+
       /** \brief Return a unique id for this model (SACMODEL_NORMAL_PLANE). */
       inline pcl::SacModel 
       getModelType () const override { return (SACMODEL_NORMAL_PLANE); }
@@ -163,6 +219,16 @@ namespace pcl
     protected:
       using SampleConsensusModel<PointT>::sample_size_;
       using SampleConsensusModel<PointT>::model_size_;
+
+    private:
+      /** \brief Exact inlier test of a point.
+        * \param[in] index the index of the point in the input
+        * \param[in] coeff the plane normal (a, b, c, 0)
+        * \param[in] d the plane offset
+        * \param[in] threshold maximum admissible distance threshold for determining the inliers from the outliers
+        */
+      inline bool
+      isWithinDistance (int index, const Eigen::Vector4f &coeff, float d, double threshold) const;
   };
 }
 
@@ -43,6 +43,13 @@
 #include <pcl/sample_consensus/sac_model.h>
 #include <pcl/sample_consensus/model_types.h>
 
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined (__AVX__)
+#include <immintrin.h>
+#endif
+
 namespace pcl
 {
 
@@ -215,6 +222,34 @@ namespace pcl
       countWithinDistance (const Eigen::VectorXf &model_coefficients,
                            const double threshold) const override;
 
+      /** \brief Count the inliers with plain scalar code, starting at position \a i of the indices.
+        * Used for the tail of the SIMD implementations; not intended for normal use, see countWithinDistance
+        * which picks the fastest implementation available.
+        * \param[in] model_coefficients the (valid) coefficients of the plane model
+        * \param[in] threshold maximum admissible distance threshold for determining the inliers from the outliers
+        * \param[in] i the position in the indices to start from
+        */
+      int
+      countWithinDistanceStandard (const Eigen::VectorXf &model_coefficients,
+                                   const double threshold,
+                                   std::size_t i = 0) const;
+
+#if defined (__SSE2__)
+      /** \brief Count the inliers using SSE2, four points at a time; see countWithinDistanceStandard. */
+      int
+      countWithinDistanceSSE (const Eigen::VectorXf &model_coefficients,
+                              const double threshold,
+                              std::size_t i = 0) const;
+#endif
+
+#if defined (__AVX__)
+      /** \brief Count the inliers using AVX, eight points at a time; see countWithinDistanceStandard. */
+      int
+      countWithinDistanceAVX (const Eigen::VectorXf &model_coefficients,
+                              const double threshold,
+                              std::size_t i = 0) const;
+#endif
+
       /** \brief Recompute the plane coefficients using the given inlier set and return them to the user.
         * @note: these are the coefficients of the plane model after refinement (e.g. after SVD)
         * \param[in] inliers the data inliers found as supporting the model
@@ -248,6 +283,16 @@ namespace pcl
                             const Eigen::VectorXf &model_coefficients,
                             const double threshold) const override;
 
+      /** \brief Verify whether a single point verifies the given plane model coefficients.
+        * \param[in] index the data index that needs to be tested against the plane model
+        * \param[in] model_coefficients the plane model coefficients
+        * \param[in] threshold a maximum admissible distance threshold for determining the inliers from the outliers
+        */
+      bool
+      doPointVerifyModel (int index,
+                          const Eigen::VectorXf &model_coefficients,
+                          const double threshold) const override;
+
       /** \brief Return a unique id for this model (SACMODEL_PLANE). */
       inline pcl::SacModel 
       getModelType () const override { return (SACMODEL_PLANE); }
@@ -263,6 +308,18 @@ namespace pcl
         */
       bool
       isSampleGood (const std::vector<int> &samples) const override;
+
+#if defined (__SSE2__)
+      /** \brief Absolute distances of the four points at positions [i, i+4) of the indices to the plane (a, b, c, d). */
+      inline __m128
+      dist4 (std::size_t i, const __m128 &a_vec, const __m128 &b_vec, const __m128 &c_vec, const __m128 &d_vec) const;
+#endif
+
+#if defined (__AVX__)
+      /** \brief Absolute distances of the eight points at positions [i, i+8) of the indices to the plane (a, b, c, d). */
+      inline __m256
+      dist8 (std::size_t i, const __m256 &a_vec, const __m256 &b_vec, const __m256 &c_vec, const __m256 &d_vec) const;
+#endif
   };
 }
 
@@ -202,13 +202,26 @@ namespace pcl
       {
       };
 
+      /** \brief Verify whether a subset of indices verifies the given transformation, i.e. whether each point is
+        * transformed within \a threshold of its correspondence.
+        * \param[in] indices the data indices that need to be tested against the transformation
+        * \param[in] model_coefficients the 4x4 transformation matrix
+        * \param[in] threshold a maximum admissible distance threshold for determining the inliers from the outliers
+        */
       bool
-      doSamplesVerifyModel (const std::set<int> &,
-                            const Eigen::VectorXf &,
-                            const double) const override
-      {
-        return (false);
-      }
+      doSamplesVerifyModel (const std::set<int> &indices,
+                            const Eigen::VectorXf &model_coefficients,
+                            const double threshold) const override;
+
+      /** \brief Verify whether a single point is transformed within \a threshold of its correspondence.
+        * \param[in] index the data index that needs to be tested against the transformation
+        * \param[in] model_coefficients the 4x4 transformation matrix
+        * \param[in] threshold a maximum admissible distance threshold for determining the inliers from the outliers
+        */
+      bool
+      doPointVerifyModel (int index,
+                          const Eigen::VectorXf &model_coefficients,
+                          const double threshold) const override;
 
       /** \brief Return a unique id for this model (SACMODEL_REGISTRATION). */
       inline pcl::SacModel
@@ -134,6 +134,27 @@ namespace pcl
       countWithinDistance (const Eigen::VectorXf &model_coefficients,
                            const double threshold) const;
 
+      /** \brief Verify whether a subset of indices verifies the given transformation, i.e. whether each point is
+        * projected within \a threshold of its correspondence.
+        * \param[in] indices the data indices that need to be tested against the transformation
+        * \param[in] model_coefficients the 4x4 transformation matrix
+        * \param[in] threshold a maximum admissible distance threshold for determining the inliers from the outliers
+        */
+      bool
+      doSamplesVerifyModel (const std::set<int> &indices,
+                            const Eigen::VectorXf &model_coefficients,
+                            const double threshold) const;
+
+      /** \brief Verify whether a single point is projected within \a threshold of its correspondence.
+        * \param[in] index the data index that needs to be tested against the transformation
+        * \param[in] model_coefficients the 4x4 transformation matrix
+        * \param[in] threshold a maximum admissible distance threshold for determining the inliers from the outliers
+        */
+      bool
+      doPointVerifyModel (int index,
+                          const Eigen::VectorXf &model_coefficients,
+                          const double threshold) const;
+
       /** \brief Set the camera projection matrix. 
         * \param[in] projection_matrix the camera projection matrix 
         */
@@ -43,6 +43,13 @@
 #include <pcl/sample_consensus/sac_model.h>
 #include <pcl/sample_consensus/model_types.h>
 
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined (__AVX__)
+#include <immintrin.h>
+#endif
+
 namespace pcl
 {
   /** \brief SampleConsensusModelSphere defines a model for 3D sphere segmentation.
@@ -161,6 +168,34 @@ namespace pcl
       countWithinDistance (const Eigen::VectorXf &model_coefficients,
                            const double threshold) const override;
 
+      /** \brief Count the inliers with plain scalar code, starting at position \a i of the indices.
+        * Used for the tail of the SIMD implementations; not intended for normal use, see countWithinDistance
+        * which picks the fastest implementation available.
+        * \param[in] model_coefficients the (valid) coefficients of the sphere model
+        * \param[in] threshold maximum admissible distance threshold for determining the inliers from the outliers
+        * \param[in] i the position in the indices to start from
+        */
+      int
+      countWithinDistanceStandard (const Eigen::VectorXf &model_coefficients,
+                                   const double threshold,
+                                   std::size_t i = 0) const;
+
+#if defined (__SSE2__)
+      /** \brief Count the inliers using SSE2, four points at a time; see countWithinDistanceStandard. */
+      int
+      countWithinDistanceSSE (const Eigen::VectorXf &model_coefficients,
+                              const double threshold,
+                              std::size_t i = 0) const;
+#endif
+
+#if defined (__AVX__)
+      /** \brief Count the inliers using AVX, eight points at a time; see countWithinDistanceStandard. */
+      int
+      countWithinDistanceAVX (const Eigen::VectorXf &model_coefficients,
+                              const double threshold,
+                              std::size_t i = 0) const;
+#endif
+
       /** \brief Recompute the sphere coefficients using the given inlier set and return them to the user.
         * @note: these are the coefficients of the sphere model after refinement (e.g. after SVD)
         * \param[in] inliers the data inliers found as supporting the model
@@ -195,6 +230,16 @@ namespace pcl
                             const Eigen::VectorXf &model_coefficients,
                             const double threshold) const override;
 
+      /** \brief Verify whether a single point verifies the given sphere model coefficients.
+        * \param[in] index the data index that needs to be tested against the sphere model
+        * \param[in] model_coefficients the sphere model coefficients
+        * \param[in] threshold a maximum admissible distance threshold for determining the inliers from the outliers
+        */
+      bool
+      doPointVerifyModel (int index,
+                          const Eigen::VectorXf &model_coefficients,
+                          const double threshold) const override;
+
       /** \brief Return a unique id for this model (SACMODEL_SPHERE). */
       inline pcl::SacModel getModelType () const override { return (SACMODEL_SPHERE); }
 
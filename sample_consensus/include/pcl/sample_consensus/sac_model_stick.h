@@ -180,6 +180,16 @@ namespace pcl
                             const Eigen::VectorXf &model_coefficients,
                             const double threshold) const override;
 
+      /** \brief Verify whether a single point verifies the given stick model coefficients.
+        * \param[in] index the data index that needs to be tested against the stick model
+        * \param[in] model_coefficients the stick model coefficients
+        * \param[in] threshold a maximum admissible distance threshold for determining the inliers from the outliers
+        */
+      bool
+      doPointVerifyModel (int index,
+                          const Eigen::VectorXf &model_coefficients,
+                          const double threshold) const override;
+
       /** \brief Return a unique id for this model (SACMODEL_STICK). */
       inline pcl::SacModel 
       getModelType () const override { return (SACMODEL_STICK); }
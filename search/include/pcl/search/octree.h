@@ -177,6 +177,21 @@ namespace pcl
           return (tree_->nearestKSearch (index, k, k_indices, k_sqr_distances));
         }
 
+        /** \brief Search for the k-nearest neighbors for the given query points, in parallel.
+          * \param[in] cloud the point cloud data
+          * \param[in] indices a vector of point cloud indices to query for nearest neighbors
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points, k_indices[i] corresponds to the neighbors of the query point i
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points, k_sqr_distances[i] corresponds to the neighbors of the query point i
+          */
+        inline void
+        nearestKSearch (const PointCloud& cloud, const std::vector<int>& indices, int k,
+                        std::vector< std::vector<int> >& k_indices,
+                        std::vector< std::vector<float> >& k_sqr_distances) const override
+        {
+          tree_->nearestKSearch (cloud, indices, k, k_indices, k_sqr_distances);
+        }
+
         /** \brief search for all neighbors of query point that are within a given radius.
          * \param cloud the point cloud data
          * \param index the index in \a cloud representing the query point
@@ -240,6 +255,35 @@ namespace pcl
           return (static_cast<int> (k_indices.size ()));
         }
 
+        /** \brief Search for all the nearest neighbors of the query points in a given radius, in parallel.
+          * \param[in] cloud the point cloud data
+          * \param[in] indices the indices in \a cloud. If indices is empty, neighbors will be searched for all points.
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[out] k_indices the resultant indices of the neighboring points, k_indices[i] corresponds to the neighbors of the query point i
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points, k_sqr_distances[i] corresponds to the neighbors of the query point i
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value
+          */
+        inline void
+        radiusSearch (const PointCloud& cloud, const std::vector<int>& indices, double radius,
+                      std::vector< std::vector<int> >& k_indices,
+                      std::vector< std::vector<float> > &k_sqr_distances,
+                      unsigned int max_nn = 0) const override
+        {
+          tree_->radiusSearch (cloud, indices, radius, k_indices, k_sqr_distances, max_nn);
+          if (sorted_results_)
+            for (size_t i = 0; i < k_indices.size (); ++i)
+              this->sortResults (k_indices[i], k_sqr_distances[i]);
+        }
+
+        /** \brief Set the number of threads used for building the octree and for batch queries.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        inline void
+        setNumberOfThreads (unsigned int nr_threads = 0)
+        {
+          tree_->setNumberOfThreads (nr_threads);
+        }
+
 
         /** \brief Search for approximate nearest neighbor at the query point.
           * \param[in] cloud the point cloud data
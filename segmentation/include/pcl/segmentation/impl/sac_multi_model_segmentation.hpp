@@ -0,0 +1,197 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2019-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PCL_SEGMENTATION_IMPL_SAC_MULTI_MODEL_SEGMENTATION_H_
+#define PCL_SEGMENTATION_IMPL_SAC_MULTI_MODEL_SEGMENTATION_H_
+
+#include <pcl/segmentation/sac_multi_model_segmentation.h>
+#include <pcl/segmentation/impl/sac_segmentation.hpp>
+#include <pcl/search/octree.h>
+
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SACMultiModelSegmentation<PointT>::segment (std::vector<PointIndices> &inliers,
+                                                 std::vector<ModelCoefficients> &model_coefficients)
+{
+  inliers.clear ();
+  model_coefficients.clear ();
+  remaining_->clear ();
+
+  if (!initCompute ())
+    return;
+
+  // Draw localized samples from an octree over the input if no search object was given
+  const bool own_search = samples_radius_ > 0. && !samples_radius_search_;
+  if (own_search)
+  {
+    samples_radius_search_.reset (new pcl::search::Octree<PointT> (samples_radius_));
+    samples_radius_search_->setInputCloud (input_);
+  }
+
+  // Create the models and sample consensus methods once, they are reused for all the extracted models
+  const std::size_t nr_workers = (std::max) (1u, threads_);
+  std::vector<Worker> workers (nr_workers);
+  for (std::size_t w = 0; w < nr_workers; ++w)
+  {
+    if (!initSACModel (model_type_))
+    {
+      PCL_ERROR ("[pcl::%s::segment] Error initializing the SAC model!\n", getClassName ().c_str ());
+      if (own_search)
+        samples_radius_search_.reset ();
+      deinitCompute ();
+      return;
+    }
+    initSAC (method_type_);
+    workers[w].model = model_;
+    workers[w].sac = sac_;
+    workers[w].indices = w == 0 ? remaining_ : boost::shared_ptr<std::vector<int> > (new std::vector<int>);
+  }
+
+  *remaining_ = *indices_;
+  std::vector<char> claimed (input_->points.size (), 0);
+  std::vector<Candidate> candidates (nr_workers);
+  std::vector<char> found (nr_workers);
+  const std::size_t min_remaining = (std::max) (static_cast<std::size_t> (min_inliers_),
+                                                static_cast<std::size_t> (model_->getSampleSize ()));
+
+  while (inliers.size () < max_models_ && remaining_->size () >= min_remaining)
+  {
+    // Every worker starts from a different rotation of the remaining indices, so that they draw different samples
+    const std::size_t nr_remaining = remaining_->size ();
+    for (std::size_t w = 0; w < nr_workers; ++w)
+    {
+      if (w > 0)
+      {
+        workers[w].indices->resize (nr_remaining);
+        std::rotate_copy (remaining_->begin (), remaining_->begin () + w * nr_remaining / nr_workers, remaining_->end (),
+                          workers[w].indices->begin ());
+      }
+      workers[w].model->setIndices (workers[w].indices);
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) num_threads(static_cast<int> (nr_workers)) if (nr_workers > 1)
+#endif
+    for (int w = 0; w < static_cast<int> (nr_workers); ++w)
+      found[w] = findCandidate (workers[w], candidates[w]);
+
+    // Accept the largest candidates first, as long as most of their inliers are still unclaimed
+    std::vector<std::size_t> order;
+    for (std::size_t w = 0; w < nr_workers; ++w)
+      if (found[w])
+        order.push_back (w);
+    std::stable_sort (order.begin (), order.end (), [&candidates] (std::size_t a, std::size_t b)
+    {
+      return (candidates[a].inliers.size () > candidates[b].inliers.size ());
+    });
+
+    std::size_t nr_accepted = 0;
+    for (const std::size_t w : order)
+    {
+      if (inliers.size () >= max_models_)
+        break;
+
+      const Candidate &candidate = candidates[w];
+      PointIndices model_inliers;
+      model_inliers.header = input_->header;
+      model_inliers.indices.reserve (candidate.inliers.size ());
+      for (const int &index : candidate.inliers)
+        if (!claimed[index])
+          model_inliers.indices.push_back (index);
+      if (model_inliers.indices.size () < min_inliers_ || 2 * model_inliers.indices.size () < candidate.inliers.size ())
+        continue;
+
+      for (const int &index : model_inliers.indices)
+        claimed[index] = 1;
+      std::sort (model_inliers.indices.begin (), model_inliers.indices.end ());
+
+      ModelCoefficients coefficients;
+      coefficients.header = input_->header;
+      coefficients.values.assign (candidate.coefficients.data (), candidate.coefficients.data () + candidate.coefficients.size ());
+
+      inliers.push_back (model_inliers);
+      model_coefficients.push_back (coefficients);
+      ++nr_accepted;
+    }
+
+    if (nr_accepted == 0)
+      break;
+
+    // Remove the inliers of the accepted models from the shared index set, in place
+    remaining_->erase (std::remove_if (remaining_->begin (), remaining_->end (),
+                                       [&claimed] (int index) { return (claimed[index] != 0); }),
+                       remaining_->end ());
+    PCL_DEBUG ("[pcl::%s::segment] Extracted %lu models so far, %lu points remaining.\n",
+               getClassName ().c_str (), inliers.size (), remaining_->size ());
+  }
+
+  // Leave the model of the first worker as the current one
+  model_ = workers[0].model;
+  sac_ = workers[0].sac;
+  model_->setIndices (remaining_);
+
+  if (own_search)
+    samples_radius_search_.reset ();
+  deinitCompute ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SACMultiModelSegmentation<PointT>::findCandidate (Worker &worker, Candidate &candidate) const
+{
+  if (!worker.sac->computeModel (0))
+    return (false);
+
+  worker.sac->getModelCoefficients (candidate.coefficients);
+  worker.sac->getInliers (candidate.inliers);
+
+  // If the user needs optimized coefficients
+  if (optimize_coefficients_)
+  {
+    Eigen::VectorXf coeff_refined;
+    worker.model->optimizeModelCoefficients (candidate.inliers, candidate.coefficients, coeff_refined);
+    candidate.coefficients = coeff_refined;
+    // Refine inliers
+    worker.model->selectWithinDistance (coeff_refined, threshold_, candidate.inliers);
+  }
+  return (!candidate.inliers.empty ());
+}
+
+#define PCL_INSTANTIATE_SACMultiModelSegmentation(T) template class PCL_EXPORTS pcl::SACMultiModelSegmentation<T>;
+
+#endif        // PCL_SEGMENTATION_IMPL_SAC_MULTI_MODEL_SEGMENTATION_H_
@@ -329,6 +329,11 @@ pcl::SACSegmentation<PointT>::initSAC (const int method_type)
     PCL_DEBUG ("[pcl::%s::initSAC] Setting the maximum number of iterations to %d\n", getClassName ().c_str (), max_iterations_);
     sac_->setMaxIterations (max_iterations_);
   }
+  if (sac_->getPreemptiveTest () != preemptive_test_)
+  {
+    PCL_DEBUG ("[pcl::%s::initSAC] Setting the preemptive test to %d\n", getClassName ().c_str (), preemptive_test_);
+    sac_->setPreemptiveTest (preemptive_test_);
+  }
   if (samples_radius_ > 0.)
   {
     PCL_DEBUG ("[pcl::%s::initSAC] Setting the maximum sample radius to %f\n", getClassName ().c_str (), samples_radius_);
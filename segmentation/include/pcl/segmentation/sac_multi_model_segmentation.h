@@ -0,0 +1,199 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2019-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <pcl/segmentation/sac_segmentation.h>
+
+#include <vector>
+
+namespace pcl
+{
+  /** \brief @b SACMultiModelSegmentation extracts several models of the same type from a point cloud in one pass.
+    *
+    * It replaces the usual loop of SACSegmentation::segment () and ExtractIndices: instead of copying the remaining
+    * points and rebuilding the sample consensus model for every extracted model, a single set of remaining indices
+    * is shared with the model and the inliers of each model are removed from it in place. The model, the sample
+    * consensus method and the search structure used for localized sampling are created once and reused.
+    *
+    * All the parameters of SACSegmentation apply to every extracted model. If a maximum sample distance is set
+    * (setSamplesMaxDist ()) without a search object, an octree with that resolution is built over the input to draw
+    * localized samples, in the spirit of "Efficient RANSAC for Point-Cloud Shape Detection" (Schnabel et al., 2007).
+    * The neighbors it returns are restricted to the remaining points, so samples are never drawn from points
+    * outside the indices or from the inliers of models extracted before.
+    *
+    * With more than one thread, several independent model searches run concurrently on the remaining points in
+    * every round. The candidates are then accepted greedily, largest first, as long as most of their inliers were
+    * not claimed by a previously accepted candidate.
+    *
+    * \note Models that require surface normals are not supported, see SACSegmentationFromNormals.
+    * \ingroup segmentation
+    */
+  template <typename PointT>
+  class SACMultiModelSegmentation : public SACSegmentation<PointT>
+  {
+    using SACSegmentation<PointT>::initCompute;
+    using SACSegmentation<PointT>::deinitCompute;
+
+    public:
+      using PCLBase<PointT>::input_;
+      using PCLBase<PointT>::indices_;
+      using SACSegmentation<PointT>::segment;
+
+      using SampleConsensusPtr = typename SACSegmentation<PointT>::SampleConsensusPtr;
+      using SampleConsensusModelPtr = typename SACSegmentation<PointT>::SampleConsensusModelPtr;
+
+      /** \brief Empty constructor.
+        * \param[in] random if true set the random seed to the current time, else set to 12345 (default: false)
+        */
+      SACMultiModelSegmentation (bool random = false)
+        : SACSegmentation<PointT> (random)
+        , max_models_ (10)
+        , min_inliers_ (100)
+        , threads_ (1)
+        , remaining_ (new std::vector<int>)
+      {
+      }
+
+      /** \brief Set the maximum number of models to extract.
+        * \param[in] max_models the maximum number of models (default: 10)
+        */
+      inline void
+      setMaxModels (unsigned int max_models) { max_models_ = max_models; }
+
+      /** \brief Get the maximum number of models to extract. */
+      inline unsigned int
+      getMaxModels () const { return (max_models_); }
+
+      /** \brief Set the minimum number of inliers a model needs to be extracted. The extraction stops at the first
+        * model with less inliers.
+        * \param[in] min_inliers the minimum number of inliers (default: 100)
+        */
+      inline void
+      setMinInliers (unsigned int min_inliers) { min_inliers_ = min_inliers; }
+
+      /** \brief Get the minimum number of inliers a model needs to be extracted. */
+      inline unsigned int
+      getMinInliers () const { return (min_inliers_); }
+
+      /** \brief Set the number of models searched concurrently in every round.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        if (nr_threads == 0)
+#ifdef _OPENMP
+          threads_ = omp_get_num_procs ();
+#else
+          threads_ = 1;
+#endif
+        else
+          threads_ = nr_threads;
+      }
+
+      /** \brief Get the number of models searched concurrently in every round. */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
+      /** \brief Extract all the models in the PointCloud given by <setInputCloud (), setIndices ()>.
+        * \param[out] inliers the point indices that support each model found, in extraction order
+        * \param[out] model_coefficients the coefficients of each model found
+        */
+      void
+      segment (std::vector<PointIndices> &inliers, std::vector<ModelCoefficients> &model_coefficients);
+
+      /** \brief Get the indices of the points that were not assigned to any model by the last call to segment (). */
+      inline const std::vector<int>&
+      getRemainingIndices () const { return (*remaining_); }
+
+    protected:
+      using SACSegmentation<PointT>::model_;
+      using SACSegmentation<PointT>::sac_;
+      using SACSegmentation<PointT>::model_type_;
+      using SACSegmentation<PointT>::method_type_;
+      using SACSegmentation<PointT>::threshold_;
+      using SACSegmentation<PointT>::optimize_coefficients_;
+      using SACSegmentation<PointT>::samples_radius_;
+      using SACSegmentation<PointT>::samples_radius_search_;
+      using SACSegmentation<PointT>::initSACModel;
+      using SACSegmentation<PointT>::initSAC;
+
+      /** \brief A model search running on (a rotation of) the remaining indices. */
+      struct Worker
+      {
+        SampleConsensusModelPtr model;
+        SampleConsensusPtr sac;
+        boost::shared_ptr<std::vector<int> > indices;
+      };
+
+      /** \brief A model found in the current round. */
+      struct Candidate
+      {
+        std::size_t worker;
+        Eigen::VectorXf coefficients;
+        std::vector<int> inliers;
+      };
+
+      /** \brief Fit the model of a worker and collect its inliers among the remaining points.
+        * \param[in] worker the worker to run
+        * \param[out] candidate the model found
+        * \return false if no model was found
+        */
+      bool
+      findCandidate (Worker &worker, Candidate &candidate) const;
+
+      /** \brief Maximum number of models to extract. */
+      unsigned int max_models_;
+
+      /** \brief Minimum number of inliers of an extracted model. */
+      unsigned int min_inliers_;
+
+      /** \brief Number of models searched concurrently. */
+      unsigned int threads_;
+
+      /** \brief The indices not assigned to any model yet, shared with the model of the first worker. */
+      boost::shared_ptr<std::vector<int> > remaining_;
+
+      /** \brief Class get name method. */
+      std::string
+      getClassName () const override { return ("SACMultiModelSegmentation"); }
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/segmentation/impl/sac_multi_model_segmentation.hpp>
+#endif
@@ -63,8 +63,9 @@ namespace pcl
   template <typename PointT>
   class SACSegmentation : public PCLBase<PointT>
   {
-    using PCLBase<PointT>::initCompute;
-    using PCLBase<PointT>::deinitCompute;
+    protected:
+      using PCLBase<PointT>::initCompute;
+      using PCLBase<PointT>::deinitCompute;
 
      public:
       using PCLBase<PointT>::input_;
@@ -96,6 +97,7 @@ namespace pcl
         , axis_ (Eigen::Vector3f::Zero ())
         , max_iterations_ (50)
         , probability_ (0.99)
+        , preemptive_test_ (SAC_PREEMPTIVE_NONE)
         , random_ (random)
       {
       }
@@ -161,6 +163,16 @@ namespace pcl
       inline double 
       getProbability () const { return (probability_); }
 
+      /** \brief Set the randomized pre-verification used to discard bad hypotheses early (RANSAC and MSAC only).
+        * \param[in] test the pre-verification test (check \a SacPreemptiveTest in sac.h)
+        */
+      inline void
+      setPreemptiveTest (SacPreemptiveTest test) { preemptive_test_ = test; }
+
+      /** \brief Get the randomized pre-verification used to discard bad hypotheses early. */
+      inline SacPreemptiveTest
+      getPreemptiveTest () const { return (preemptive_test_); }
+
       /** \brief Set to true if a coefficient refinement is required.
         * \param[in] optimize true for enabling model coefficient refinement, false otherwise
         */
@@ -294,6 +306,9 @@ namespace pcl
       /** \brief Desired probability of choosing at least one sample free from outliers (user given parameter). */
       double probability_;
 
+      /** \brief Randomized pre-verification of the hypotheses (user given parameter). */
+      SacPreemptiveTest preemptive_test_;
+
       /** \brief Set to true if we need a random seed. */
       bool random_;
 
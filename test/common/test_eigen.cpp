@@ -783,6 +783,51 @@ TEST (PCL, eigen33f)
   EXPECT_LE (float(r_fail_count) / float(iterations), 0.01);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, eigen33Batch)
+{
+  // an odd count, so the SIMD blocks as well as the scalar tail are exercised
+  const std::size_t nr_matrices = 100003;
+  std::vector<Eigen::Matrix3f, Eigen::aligned_allocator<Eigen::Matrix3f> > matrices (nr_matrices);
+  std::vector<float> c00 (nr_matrices), c01 (nr_matrices), c02 (nr_matrices);
+  std::vector<float> c11 (nr_matrices), c12 (nr_matrices), c22 (nr_matrices);
+  for (std::size_t i = 0; i < nr_matrices; ++i)
+  {
+    generateSymPosMatrix3x3 (matrices[i]);
+    c00[i] = matrices[i] (0, 0); c01[i] = matrices[i] (0, 1); c02[i] = matrices[i] (0, 2);
+    c11[i] = matrices[i] (1, 1); c12[i] = matrices[i] (1, 2); c22[i] = matrices[i] (2, 2);
+  }
+
+  std::vector<float> eigenvalues (nr_matrices), nx (nr_matrices), ny (nr_matrices), nz (nr_matrices);
+  eigen33Batch (nr_matrices, &c00[0], &c01[0], &c02[0], &c11[0], &c12[0], &c22[0],
+                &eigenvalues[0], &nx[0], &ny[0], &nz[0]);
+
+  const float epsilon = 1e-3f;
+  unsigned fail_count = 0;
+  for (std::size_t i = 0; i < nr_matrices; ++i)
+  {
+    float eigenvalue;
+    Eigen::Vector3f eigenvector;
+    eigen33 (matrices[i], eigenvalue, eigenvector);
+
+    // the eigenvector of a repeated eigenvalue is not unique, so compare the residuals of both solutions
+    const Eigen::Vector3f batch_vector (nx[i], ny[i], nz[i]);
+    const float residual = (matrices[i] * batch_vector - eigenvalues[i] * batch_vector).norm ();
+    const float scalar_residual = (matrices[i] * eigenvector - eigenvalue * eigenvector).norm ();
+    if (std::abs (eigenvalues[i] - eigenvalue) > epsilon || residual > scalar_residual + epsilon ||
+        std::abs (batch_vector.norm () - 1.0f) > epsilon)
+      ++fail_count;
+  }
+  // same failure budget as the scalar eigen33f test
+  EXPECT_LE (float (fail_count) / float (nr_matrices), 0.01);
+
+  // the zero matrix yields a zero eigenvalue, as in eigen33
+  const float zero = 0.0f;
+  float eigenvalue, x, y, z;
+  eigen33Batch (1, &zero, &zero, &zero, &zero, &zero, &zero, &eigenvalue, &x, &y, &z);
+  EXPECT_EQ (eigenvalue, 0.0f);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, transformLine)
 {
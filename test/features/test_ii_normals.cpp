@@ -490,6 +490,81 @@ TEST (PCL, IINormalEstimationSimple3DGradient)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, IINormalEstimationThreads)
+{
+  // A curved surface with a depth step and some invalid points
+  PointCloud<PointXYZ>::Ptr curved (new PointCloud<PointXYZ> (160, 120));
+  for (size_t v = 0; v < curved->height; ++v)
+  {
+    for (size_t u = 0; u < curved->width; ++u)
+    {
+      const float z = 1.5f + 0.3f * std::sin (0.05f * u) + 0.2f * std::cos (0.07f * v) + (u > 100 && v > 50 ? 0.5f : 0.0f);
+      (*curved) (u, v).x = (static_cast<float> (u) - 80.0f) * z / 525.0f;
+      (*curved) (u, v).y = (static_cast<float> (v) - 60.0f) * z / 525.0f;
+      (*curved) (u, v).z = ((u * 7 + v * 13) % 97 == 0) ? std::numeric_limits<float>::quiet_NaN () : z;
+    }
+  }
+  boost::shared_ptr<std::vector<int> > indices (new std::vector<int>);
+  for (int i = 0; i < static_cast<int> (curved->size ()); i += 7)
+    indices->push_back (i);
+
+  using Method = IntegralImageNormalEstimation<PointXYZ, Normal>::NormalEstimationMethod;
+  const Method methods[] = {ne.COVARIANCE_MATRIX, ne.AVERAGE_3D_GRADIENT, ne.AVERAGE_DEPTH_CHANGE, ne.SIMPLE_3D_GRADIENT};
+  for (const Method method : methods)
+  {
+    for (const bool mirror : {false, true})
+    {
+      if (mirror && method == ne.SIMPLE_3D_GRADIENT)
+        continue;
+
+      PointCloud<Normal> output[3];
+      for (int run = 0; run < 3; ++run)
+      {
+        IntegralImageNormalEstimation<PointXYZ, Normal> estimation;
+        estimation.setNormalEstimationMethod (method);
+        estimation.setBorderPolicy (mirror ? estimation.BORDER_POLICY_MIRROR : estimation.BORDER_POLICY_IGNORE);
+        estimation.setMaxDepthChangeFactor (0.02f);
+        estimation.setNormalSmoothingSize (5.0f);
+        estimation.setNumberOfThreads (run == 0 ? 1 : 4);
+        estimation.setInputCloud (curved);
+        if (run == 2)
+          estimation.setIndices (indices);
+        estimation.compute (output[run]);
+      }
+
+      // Multi-threaded results are identical to the single-threaded ones
+      ASSERT_EQ (output[0].size (), output[1].size ());
+      for (size_t i = 0; i < output[0].size (); ++i)
+      {
+        for (int d = 0; d < 3; ++d)
+        {
+          EXPECT_EQ (std::isfinite (output[0][i].normal[d]), std::isfinite (output[1][i].normal[d]));
+          if (std::isfinite (output[0][i].normal[d]))
+          {
+            EXPECT_EQ (output[0][i].normal[d], output[1][i].normal[d]);
+          }
+        }
+      }
+
+      // Computing only some of the points gives the same normals as computing all of them
+      ASSERT_EQ (output[2].size (), indices->size ());
+      for (size_t i = 0; i < indices->size (); ++i)
+      {
+        const Normal &full = output[0][(*indices)[i]];
+        for (int d = 0; d < 3; ++d)
+        {
+          EXPECT_EQ (std::isfinite (full.normal[d]), std::isfinite (output[2][i].normal[d]));
+          if (std::isfinite (full.normal[d]))
+          {
+            EXPECT_NEAR (full.normal[d], output[2][i].normal[d], 1e-4);
+          }
+        }
+      }
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, IINormalEstimationSimple3DGradientUnorganized)
 {
@@ -213,6 +213,63 @@ TEST (PCL, NormalEstimationOpenMP)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, NormalEstimationBlocks)
+{
+  // 100 query points: one full block of eigen problems plus a partial one, and a non-finite query point
+  PointCloud<PointXYZ>::Ptr cloudptr = cloud.makeShared ();
+  cloudptr->points[10].x = std::numeric_limits<float>::quiet_NaN ();
+  cloudptr->is_dense = false;
+  pcl::IndicesPtr indicesptr (new pcl::Indices (indices.begin (), indices.begin () + 100));
+  KdTreePtr local_tree (new search::KdTree<PointXYZ> (false));
+  local_tree->setInputCloud (cloudptr);
+
+  NormalEstimation<PointXYZ, Normal> n;
+  n.setInputCloud (cloudptr);
+  n.setIndices (indicesptr);
+  n.setSearchMethod (local_tree);
+  n.setKSearch (10);
+  PointCloud<Normal> normals;
+  n.compute (normals);
+  EXPECT_FALSE (normals.is_dense);
+
+  NormalEstimationOMP<PointXYZ, Normal> n_omp (4);
+  n_omp.setInputCloud (cloudptr);
+  n_omp.setIndices (indicesptr);
+  n_omp.setSearchMethod (local_tree);
+  n_omp.setKSearch (10);
+  PointCloud<Normal> normals_omp;
+  n_omp.compute (normals_omp);
+  EXPECT_FALSE (normals_omp.is_dense);
+
+  std::vector<int> nn_indices;
+  std::vector<float> nn_dists;
+  for (size_t idx = 0; idx < indicesptr->size (); ++idx)
+  {
+    if (idx == 10)
+    {
+      EXPECT_FALSE (std::isfinite (normals.points[idx].normal[0]));
+      EXPECT_FALSE (std::isfinite (normals_omp.points[idx].normal[0]));
+      continue;
+    }
+
+    // the blocked estimation has to agree with solving each neighborhood on its own
+    local_tree->nearestKSearch (cloudptr->points[idx], 10, nn_indices, nn_dists);
+    float nx, ny, nz, curvature;
+    n.computePointNormal (*cloudptr, nn_indices, nx, ny, nz, curvature);
+    flipNormalTowardsViewpoint (cloudptr->points[idx], 0, 0, 0, nx, ny, nz);
+    EXPECT_NEAR (normals.points[idx].normal[0], nx, 1e-4);
+    EXPECT_NEAR (normals.points[idx].normal[1], ny, 1e-4);
+    EXPECT_NEAR (normals.points[idx].normal[2], nz, 1e-4);
+    EXPECT_NEAR (normals.points[idx].curvature, curvature, 1e-4);
+
+    EXPECT_EQ (normals_omp.points[idx].normal[0], normals.points[idx].normal[0]);
+    EXPECT_EQ (normals_omp.points[idx].normal[1], normals.points[idx].normal[1]);
+    EXPECT_EQ (normals_omp.points[idx].normal[2], normals.points[idx].normal[2]);
+    EXPECT_EQ (normals_omp.points[idx].curvature, normals.points[idx].curvature);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
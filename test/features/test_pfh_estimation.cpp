@@ -45,6 +45,9 @@
 #include <gtest/gtest.h>
 #include <pcl/point_cloud.h>
 #include <pcl/features/pfh.h>
+#include <pcl/features/pfh_omp.h>
+#include <pcl/features/pfhrgb.h>
+#include <pcl/features/pfhrgb_omp.h>
 #include <pcl/features/fpfh.h>
 #include <pcl/features/fpfh_omp.h>
 #include <pcl/features/vfh.h>
@@ -259,6 +262,144 @@ TEST (PCL, PFHEstimation)
   (cloud, cloud, test_indices, 125);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PFHEstimationOMP)
+{
+  using pcl::PFHSignature125;
+
+  pcl::PFHEstimation<PointT, PointT, PFHSignature125> pfh;
+  pfh.setInputCloud (cloud);
+  pfh.setInputNormals (cloud);
+  pfh.setSearchMethod (tree);
+  pfh.setKSearch (10);
+
+  PointCloud<PFHSignature125> reference;
+  pfh.compute (reference);
+
+  // The pair feature memo only skips recomputation, it never changes the result
+  for (const bool use_cache : {false, true})
+  {
+    for (const unsigned int nr_threads : {1u, 4u})
+    {
+      pcl::PFHEstimationOMP<PointT, PointT, PFHSignature125> pfh_omp (nr_threads);
+      pfh_omp.setInputCloud (cloud);
+      pfh_omp.setInputNormals (cloud);
+      pfh_omp.setSearchMethod (tree);
+      pfh_omp.setKSearch (10);
+      pfh_omp.setUseInternalCache (use_cache);
+      pfh_omp.setMaximumCacheSize (50);
+
+      PointCloud<PFHSignature125> output;
+      pfh_omp.compute (output);
+      ASSERT_EQ (output.size (), reference.size ());
+      for (size_t i = 0; i < output.size (); ++i)
+        for (int j = 0; j < 125; ++j)
+          ASSERT_EQ (output.points[i].histogram[j], reference.points[i].histogram[j]);
+    }
+  }
+
+  pcl::IndicesPtr test_indices (new pcl::Indices (0));
+  for (size_t i = 0; i < cloud->size (); i+=3)
+    test_indices->push_back (static_cast<int> (i));
+
+  testIndicesAndSearchSurface<pcl::PFHEstimationOMP, PointT, PointT, PFHSignature125>
+  (cloud, cloud, test_indices, 125);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PFHRGBEstimationOMP)
+{
+  using pcl::PFHRGBSignature250;
+  using PointRGBT = pcl::PointXYZRGBNormal;
+
+  // Give the points deterministic colors, including zero channels
+  PointCloud<PointRGBT>::Ptr cloud_rgb (new PointCloud<PointRGBT> ());
+  pcl::copyPointCloud (*cloud, *cloud_rgb);
+  for (size_t i = 0; i < cloud_rgb->size (); ++i)
+  {
+    cloud_rgb->points[i].r = static_cast<uint8_t> ((i * 37) % 256);
+    cloud_rgb->points[i].g = static_cast<uint8_t> ((i * 91) % 256);
+    cloud_rgb->points[i].b = static_cast<uint8_t> ((i * 13) % 256);
+  }
+  pcl::search::KdTree<PointRGBT>::Ptr tree_rgb (new pcl::search::KdTree<PointRGBT> (false));
+
+  pcl::PFHRGBEstimation<PointRGBT, PointRGBT, PFHRGBSignature250> pfhrgb;
+  pfhrgb.setInputCloud (cloud_rgb);
+  pfhrgb.setInputNormals (cloud_rgb);
+  pfhrgb.setSearchMethod (tree_rgb);
+  pfhrgb.setKSearch (10);
+
+  PointCloud<PFHRGBSignature250> reference;
+  pfhrgb.compute (reference);
+
+  // The pair feature memo only skips recomputation, it never changes the result
+  for (const bool use_cache : {false, true})
+  {
+    pfhrgb.setUseInternalCache (use_cache);
+    pfhrgb.setMaximumCacheSize (50);
+    PointCloud<PFHRGBSignature250> serial;
+    pfhrgb.compute (serial);
+    ASSERT_EQ (serial.size (), reference.size ());
+    for (size_t i = 0; i < serial.size (); ++i)
+      for (int j = 0; j < 250; ++j)
+        ASSERT_EQ (serial.points[i].histogram[j], reference.points[i].histogram[j]);
+
+    for (const unsigned int nr_threads : {1u, 4u})
+    {
+      pcl::PFHRGBEstimationOMP<PointRGBT, PointRGBT, PFHRGBSignature250> pfhrgb_omp (nr_threads);
+      pfhrgb_omp.setInputCloud (cloud_rgb);
+      pfhrgb_omp.setInputNormals (cloud_rgb);
+      pfhrgb_omp.setSearchMethod (tree_rgb);
+      pfhrgb_omp.setKSearch (10);
+      pfhrgb_omp.setUseInternalCache (use_cache);
+      pfhrgb_omp.setMaximumCacheSize (50);
+
+      PointCloud<PFHRGBSignature250> output;
+      pfhrgb_omp.compute (output);
+      ASSERT_EQ (output.size (), reference.size ());
+      for (size_t i = 0; i < output.size (); ++i)
+        for (int j = 0; j < 250; ++j)
+          ASSERT_EQ (output.points[i].histogram[j], reference.points[i].histogram[j]);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PairFeatureCache)
+{
+  pcl::PairFeatureCache cache (100);
+  Eigen::Vector4f features;
+  EXPECT_FALSE (cache.find (0, 1, features));
+
+  cache.insert (0, 1, Eigen::Vector4f (1.0f, 2.0f, 3.0f, 4.0f));
+  EXPECT_EQ (cache.size (), 1u);
+  ASSERT_TRUE (cache.find (0, 1, features));
+  EXPECT_EQ (features, Eigen::Vector4f (1.0f, 2.0f, 3.0f, 4.0f));
+  // Pairs are ordered
+  EXPECT_FALSE (cache.find (1, 0, features));
+
+  // The table never holds more than its bound, and whatever it holds is correct
+  for (int i = 0; i < 1000; ++i)
+    cache.insert (i, i + 1, Eigen::Vector4f::Constant (static_cast<float> (i)));
+  EXPECT_LE (cache.size (), 100u);
+  for (int i = 0; i < 1000; ++i)
+  {
+    if (cache.find (i, i + 1, features))
+    {
+      EXPECT_EQ (features, Eigen::Vector4f::Constant (static_cast<float> (i)));
+    }
+  }
+
+  cache.clear ();
+  EXPECT_EQ (cache.size (), 0u);
+  EXPECT_FALSE (cache.find (999, 1000, features));
+
+  // A zero bound disables memoization
+  cache.setMaximumSize (0);
+  cache.insert (0, 1, features);
+  EXPECT_EQ (cache.size (), 0u);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 using pcl::FPFHEstimation;
@@ -448,6 +589,59 @@ TYPED_TEST (FPFHTest, Estimation)
   (cloud, cloud, test_indices, 33);
 }
 
+// Repeated estimation on overlapping query sets has to give the same result with the SPFH cache
+TYPED_TEST (FPFHTest, SPFHCache)
+{
+  TypeParam& fpfh = this->fpfh;
+  fpfh.setInputCloud (cloud);
+  fpfh.setInputNormals (cloud);
+  fpfh.setSearchMethod (tree);
+  fpfh.setKSearch (10);
+
+  PointCloud<FPFHSignature33> full_output;
+  fpfh.compute (full_output);
+  EXPECT_EQ (fpfh.getSPFHCacheSize (), 0u);
+
+  // Two overlapping windows of query points
+  pcl::IndicesPtr window0 (new pcl::Indices), window1 (new pcl::Indices);
+  for (int i = 0; i < static_cast<int> (cloud->size ()) / 2; ++i)
+    window0->push_back (i);
+  for (int i = static_cast<int> (cloud->size ()) / 4; i < static_cast<int> (cloud->size ()); ++i)
+    window1->push_back (i);
+
+  fpfh.setUseSPFHCache (true);
+  PointCloud<FPFHSignature33> output0, output1;
+  fpfh.setIndices (window0);
+  fpfh.compute (output0);
+  const size_t cache_size0 = fpfh.getSPFHCacheSize ();
+  EXPECT_GT (cache_size0, 0u);
+  fpfh.setIndices (window1);
+  fpfh.compute (output1);
+  const size_t cache_size1 = fpfh.getSPFHCacheSize ();
+  EXPECT_GT (cache_size1, cache_size0);
+  EXPECT_LE (cache_size1, cloud->size ());
+
+  // Nothing new is needed for a window that was already seen
+  fpfh.setIndices (window0);
+  fpfh.compute (output0);
+  EXPECT_EQ (fpfh.getSPFHCacheSize (), cache_size1);
+
+  for (size_t i = 0; i < output0.size (); ++i)
+    for (int j = 0; j < 33; ++j)
+      ASSERT_EQ (output0.points[i].histogram[j], full_output.points[(*window0)[i]].histogram[j]);
+  for (size_t i = 0; i < output1.size (); ++i)
+    for (int j = 0; j < 33; ++j)
+      ASSERT_EQ (output1.points[i].histogram[j], full_output.points[(*window1)[i]].histogram[j]);
+
+  // A different neighborhood size invalidates the cache
+  fpfh.setKSearch (12);
+  fpfh.compute (output0);
+  EXPECT_LT (fpfh.getSPFHCacheSize (), cache_size1);
+
+  fpfh.setUseSPFHCache (false);
+  EXPECT_EQ (fpfh.getSPFHCacheSize (), 0u);
+}
+
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, VFHEstimation)
@@ -687,6 +687,147 @@ TYPED_TEST (SHOTShapeAndColorTest, Estimation)
   testSHOTLocalReferenceFrame<TypeParam, PointXYZRGBA, Normal, SHOT1344> (cloudWithColors.makeShared (), normals, test_indices);
 }
 
+///////////////////////////////////////////////////////////////////////////////////
+/* The double precision spatial interpolation of a single neighbor, as SHOTEstimationBase
+ * performed it before computeSHOTVolumeVotes, accumulated in a histogram of the 32 volumes. */
+void
+shotVolumeVotesReference (double x, double y, double z, double distance,
+                          double radius1_4, double radius1_2, double radius3_4,
+                          std::vector<double> &volumes)
+{
+  unsigned char bit4 = ((y > 0) || ((y == 0.0) && (x < 0))) ? 1 : 0;
+  unsigned char bit3 = static_cast<unsigned char> (((x > 0) || ((x == 0.0) && (y > 0))) ? !bit4 : bit4);
+  int desc_index = ((bit4<<3) + (bit3<<2)) << 1;
+  if ((x * y > 0) || (x == 0.0))
+    desc_index += (std::abs (x) >= std::abs (y)) ? 0 : 4;
+  else
+    desc_index += (std::abs (x) > std::abs (y)) ? 4 : 0;
+  desc_index += z > 0 ? 1 : 0;
+  desc_index += (distance > radius1_2) ? 2 : 0;
+
+  double weight = 0;
+  if (distance > radius1_2)
+  {
+    double radius_distance = (distance - radius3_4) / radius1_2;
+    if (distance > radius3_4)
+      weight += 1 - radius_distance;
+    else
+    {
+      weight += 1 + radius_distance;
+      volumes[desc_index - 2] -= radius_distance;
+    }
+  }
+  else
+  {
+    double radius_distance = (distance - radius1_4) / radius1_2;
+    if (distance < radius1_4)
+      weight += 1 + radius_distance;
+    else
+    {
+      weight += 1 - radius_distance;
+      volumes[desc_index + 2] += radius_distance;
+    }
+  }
+
+  double inclination = std::acos (std::min (std::max (z / distance, -1.0), 1.0));
+  if (inclination > M_PI / 2 || (std::abs (inclination - M_PI / 2) < 1e-30 && z <= 0))
+  {
+    double inclination_distance = (inclination - 3 * M_PI / 4) / (M_PI / 2);
+    if (inclination > 3 * M_PI / 4)
+      weight += 1 - inclination_distance;
+    else
+    {
+      weight += 1 + inclination_distance;
+      volumes[desc_index + 1] -= inclination_distance;
+    }
+  }
+  else
+  {
+    double inclination_distance = (inclination - M_PI / 4) / (M_PI / 2);
+    if (inclination < M_PI / 4)
+      weight += 1 + inclination_distance;
+    else
+    {
+      weight += 1 - inclination_distance;
+      volumes[desc_index - 1] += inclination_distance;
+    }
+  }
+
+  if (y != 0.0 || x != 0.0)
+  {
+    double azimuth = std::atan2 (y, x);
+    double azimuth_distance = (azimuth - (-7 * M_PI / 8 + M_PI / 4 * (desc_index >> 2))) / (M_PI / 4);
+    azimuth_distance = std::max (-0.5, std::min (azimuth_distance, 0.5));
+    if (azimuth_distance > 0)
+    {
+      weight += 1 - azimuth_distance;
+      volumes[(desc_index + 4) % 32] += azimuth_distance;
+    }
+    else
+    {
+      weight += 1 + azimuth_distance;
+      volumes[(desc_index - 4 + 32) % 32] -= azimuth_distance;
+    }
+  }
+
+  volumes[desc_index] += weight;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, SHOTVolumeVotes)
+{
+  const float radius = 0.04f;
+  const float radius1_4 = radius / 4, radius1_2 = radius / 2, radius3_4 = radius * 3 / 4;
+
+  // Random neighbors, plus neighbors on the axes, the diagonals and the shell boundaries
+  std::vector<Eigen::Vector3f> neighbors;
+  srand (12345);
+  for (int i = 0; i < 1000; ++i)
+  {
+    Eigen::Vector3f p = Eigen::Vector3f::Random ();
+    neighbors.push_back (p.normalized () * radius * static_cast<float> (rand ()) / static_cast<float> (RAND_MAX));
+  }
+  for (float a : {-1.0f, 0.0f, 1.0f})
+    for (float b : {-1.0f, 0.0f, 1.0f})
+      for (float c : {-1.0f, 0.0f, 1.0f})
+        for (float r : {radius1_4, radius1_2, radius3_4, radius * 0.9f})
+          if (a != 0 || b != 0 || c != 0)
+            neighbors.push_back (Eigen::Vector3f (a, b, c).normalized () * r);
+
+  detail::SHOTVolumeVotes votes;
+  for (size_t begin = 0; begin < neighbors.size (); begin += votes.size)
+  {
+    votes.size = std::min (detail::SHOTVolumeVotes::block_size, neighbors.size () - begin);
+    for (size_t i = 0; i < votes.size; ++i)
+    {
+      votes.x[i] = neighbors[begin + i][0];
+      votes.y[i] = neighbors[begin + i][1];
+      votes.z[i] = neighbors[begin + i][2];
+      votes.distance[i] = neighbors[begin + i].norm ();
+    }
+    detail::computeSHOTVolumeVotes (radius1_4, radius1_2, radius3_4, votes);
+
+    for (size_t i = 0; i < votes.size; ++i)
+    {
+      std::vector<double> expected (32, 0.0), result (32, 0.0);
+      shotVolumeVotesReference (votes.x[i], votes.y[i], votes.z[i], votes.distance[i],
+                                radius1_4, radius1_2, radius3_4, expected);
+      ASSERT_GE (votes.volume[i], 0);
+      ASSERT_LT (votes.volume[i], 32);
+      result[votes.volume[i]] += votes.volume_weight[i];
+      for (int d = 0; d < 3; ++d)
+      {
+        ASSERT_GE (votes.neighbor_volume[d][i], 0);
+        ASSERT_LT (votes.neighbor_volume[d][i], 32);
+        EXPECT_GE (votes.neighbor_weight[d][i], 0.0f);
+        result[votes.neighbor_volume[d][i]] += votes.neighbor_weight[d][i];
+      }
+      for (int v = 0; v < 32; ++v)
+        EXPECT_NEAR (result[v], expected[v], 1e-5) << "neighbor " << begin + i << ", volume " << v;
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL,3DSCEstimation)
 {
@@ -0,0 +1,241 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/compression/depth_image_coder.h>
+#include <pcl/io/lzf_image_io.h>
+#include <pcl/point_types.h>
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace pcl;
+using namespace pcl::io;
+
+// Synthetic depth image in mm: a slanted plane with a box in front of it, sensor noise and invalid borders
+std::vector<uint16_t>
+createDepthImage (uint32_t width, uint32_t height)
+{
+  std::vector<uint16_t> image (width * height);
+  for (uint32_t v = 0; v < height; ++v)
+  {
+    for (uint32_t u = 0; u < width; ++u)
+    {
+      uint16_t depth = static_cast<uint16_t> (2000 + 3 * u + 2 * v + rand () % 5);
+      if (u > width / 3 && u < width / 2 && v > height / 4 && v < height / 2)
+        depth = static_cast<uint16_t> (900 + rand () % 3);
+      if (u < 8 || v >= height - 4 || rand () % 50 == 0)
+        depth = 0;
+      image[v * width + u] = depth;
+    }
+  }
+  // extreme depths
+  image[width + 10] = 65535;
+  image[width + 11] = 1;
+  return (image);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, DepthImageCoderLossless)
+{
+  const uint32_t width = 160, height = 120;
+  const std::vector<uint16_t> image = createDepthImage (width, height);
+
+  for (unsigned int nr_strips : {1u, 7u, 1000u})
+  {
+    for (unsigned int nr_threads : {1u, 3u})
+    {
+      DepthImageCoder coder (0, nr_strips);
+      coder.setNumberOfThreads (nr_threads);
+
+      std::vector<uint8_t> compressed;
+      coder.encode (image, width, height, compressed);
+      EXPECT_TRUE (DepthImageCoder::isDepthImageStream (compressed.data (), compressed.size ()));
+      EXPECT_LT (compressed.size (), image.size () * sizeof (uint16_t) / 2);
+
+      std::vector<uint16_t> decoded;
+      uint32_t decoded_width = 0, decoded_height = 0;
+      ASSERT_TRUE (coder.decode (compressed, decoded, decoded_width, decoded_height));
+      EXPECT_EQ (width, decoded_width);
+      EXPECT_EQ (height, decoded_height);
+      EXPECT_EQ (image, decoded);
+    }
+  }
+
+  // random data and degenerate image sizes
+  std::vector<uint16_t> noise (37 * 3);
+  for (uint16_t &depth : noise)
+    depth = static_cast<uint16_t> (rand () & 0xFFFF);
+
+  DepthImageCoder coder;
+  std::vector<uint8_t> compressed;
+  std::vector<uint16_t> decoded;
+  uint32_t decoded_width, decoded_height;
+  for (uint32_t rows : {0u, 1u, 3u})
+  {
+    const std::vector<uint16_t> input (noise.begin (), noise.begin () + 37 * rows);
+    coder.encode (input, 37, rows, compressed);
+    ASSERT_TRUE (coder.decode (compressed, decoded, decoded_width, decoded_height));
+    EXPECT_EQ (rows, decoded_height);
+    EXPECT_EQ (input, decoded);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, DepthImageCoderNearLossless)
+{
+  const uint32_t width = 160, height = 120;
+  const std::vector<uint16_t> image = createDepthImage (width, height);
+
+  DepthImageCoder lossless_coder;
+  std::vector<uint8_t> lossless;
+  lossless_coder.encode (image, width, height, lossless);
+
+  for (unsigned int max_error : {1u, 4u, 255u})
+  {
+    DepthImageCoder coder (max_error, 4);
+    std::vector<uint8_t> compressed;
+    coder.encode (image, width, height, compressed);
+    EXPECT_LT (compressed.size (), lossless.size ());
+
+    // the maximum error is read from the stream
+    DepthImageCoder decoder;
+    std::vector<uint16_t> decoded;
+    uint32_t decoded_width, decoded_height;
+    ASSERT_TRUE (decoder.decode (compressed, decoded, decoded_width, decoded_height));
+    ASSERT_EQ (image.size (), decoded.size ());
+
+    for (size_t i = 0; i < image.size (); ++i)
+    {
+      // invalid depths stay invalid, valid depths stay valid
+      ASSERT_EQ (image[i] == 0, decoded[i] == 0);
+      const int error = std::abs (static_cast<int> (image[i]) - static_cast<int> (decoded[i]));
+      if (image[i] > max_error)
+        ASSERT_LE (error, static_cast<int> (max_error));
+      else
+        ASSERT_LE (error, 2 * static_cast<int> (max_error));
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, DepthImageCoderCorruptedData)
+{
+  const uint32_t width = 64, height = 48;
+  const std::vector<uint16_t> image = createDepthImage (width, height);
+
+  DepthImageCoder coder (0, 4);
+  std::vector<uint8_t> compressed;
+  coder.encode (image, width, height, compressed);
+
+  std::vector<uint16_t> decoded;
+  uint32_t decoded_width, decoded_height;
+
+  std::vector<uint8_t> truncated (compressed.begin (), compressed.end () - 1);
+  EXPECT_FALSE (coder.decode (truncated, decoded, decoded_width, decoded_height));
+
+  std::vector<uint8_t> header_only (compressed.begin (), compressed.begin () + 12);
+  EXPECT_FALSE (coder.decode (header_only, decoded, decoded_width, decoded_height));
+
+  std::vector<uint8_t> wrong_signature (compressed);
+  wrong_signature[0] = 'X';
+  EXPECT_FALSE (DepthImageCoder::isDepthImageStream (wrong_signature.data (), wrong_signature.size ()));
+  EXPECT_FALSE (coder.decode (wrong_signature, decoded, decoded_width, decoded_height));
+
+  // flipped bits must not crash the decoder
+  for (size_t i = 19 + 4 * sizeof (uint32_t); i < compressed.size (); i += 7)
+  {
+    std::vector<uint8_t> corrupted (compressed);
+    corrupted[i] ^= 0x5A;
+    coder.decode (corrupted, decoded, decoded_width, decoded_height);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, LZFDepth16PredictiveCoding)
+{
+  const uint32_t width = 160, height = 120;
+  const std::vector<uint16_t> image = createDepthImage (width, height);
+
+  CameraParameters parameters;
+  parameters.focal_length_x = parameters.focal_length_y = 525.0;
+  parameters.principal_point_x = width / 2.0;
+  parameters.principal_point_y = height / 2.0;
+
+  LZFDepth16ImageWriter lzf_writer;
+  ASSERT_TRUE (lzf_writer.write (reinterpret_cast<const char*> (&image[0]), width, height, "test_depth_lzf.pclzf"));
+
+  LZFDepth16ImageWriter predictive_writer;
+  predictive_writer.setPredictiveCoding (true);
+  ASSERT_TRUE (predictive_writer.write (reinterpret_cast<const char*> (&image[0]), width, height, "test_depth_predictive.pclzf"));
+
+  PointCloud<PointXYZ> lzf_cloud, predictive_cloud;
+  LZFDepth16ImageReader reader;
+  reader.setParameters (parameters);
+  ASSERT_TRUE (reader.read ("test_depth_lzf.pclzf", lzf_cloud));
+  ASSERT_TRUE (reader.readOMP ("test_depth_predictive.pclzf", predictive_cloud, 2));
+  EXPECT_EQ (0, reader.getImageType ().compare (0, 8, "depth16p"));
+
+  ASSERT_EQ (lzf_cloud.size (), predictive_cloud.size ());
+  EXPECT_EQ (width, predictive_cloud.width);
+  EXPECT_EQ (height, predictive_cloud.height);
+  EXPECT_FALSE (predictive_cloud.is_dense);
+  for (size_t i = 0; i < lzf_cloud.size (); ++i)
+  {
+    if (image[i] == 0)
+    {
+      EXPECT_FALSE (std::isfinite (predictive_cloud.points[i].z));
+      continue;
+    }
+    EXPECT_EQ (lzf_cloud.points[i].x, predictive_cloud.points[i].x);
+    EXPECT_EQ (lzf_cloud.points[i].y, predictive_cloud.points[i].y);
+    EXPECT_EQ (lzf_cloud.points[i].z, predictive_cloud.points[i].z);
+  }
+
+  remove ("test_depth_lzf.pclzf");
+  remove ("test_depth_predictive.pclzf");
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
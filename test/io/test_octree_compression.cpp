@@ -41,7 +41,10 @@
 #include <pcl/compression/octree_pointcloud_compression.h>
 #include <pcl/compression/compression_profiles.h>
 
+#include <cmath>
+#include <cstring>
 #include <string>
+#include <limits>
 #include <exception>
 
 using namespace std;
@@ -156,6 +159,189 @@ TEST (PCL, OctreeDeCompressionRandomPointXYZ)
   } // compression profiles
 } // TEST
 
+TEST (PCL, OctreeDeCompressionBlocks)
+{
+  srand (1234);
+
+  pcl::io::OctreePointCloudCompression<pcl::PointXYZRGBA> block_encoder (pcl::io::MED_RES_ONLINE_COMPRESSION_WITH_COLOR, false);
+  pcl::io::OctreePointCloudCompression<pcl::PointXYZRGBA> stream_encoder (pcl::io::MED_RES_ONLINE_COMPRESSION_WITH_COLOR, false);
+  pcl::io::OctreePointCloudCompression<pcl::PointXYZRGBA> decoder;
+  block_encoder.setNumberOfBlocks (4);
+  block_encoder.setNumberOfThreads (4);
+  decoder.setNumberOfThreads (2);
+
+  // a moving cloud, so frames alternate between intra and prediction coded blocks
+  pcl::PointCloud<pcl::PointXYZRGBA>::Ptr cloud (new pcl::PointCloud<pcl::PointXYZRGBA> ());
+  for (int point = 0; point < 5000; point++)
+  {
+    pcl::PointXYZRGBA new_point;
+    new_point.x = static_cast<float> (4.0 * rand () / RAND_MAX);
+    new_point.y = static_cast<float> (2.0 * rand () / RAND_MAX);
+    new_point.z = static_cast<float> (1.0 * rand () / RAND_MAX);
+    new_point.rgba = rand ();
+    cloud->push_back (new_point);
+  }
+
+  for (int frame = 0; frame < 4; frame++)
+  {
+    for (auto &point : cloud->points)
+      point.x += 0.001f;
+
+    pcl::PointCloud<pcl::PointXYZRGBA>::Ptr cloud_out (new pcl::PointCloud<pcl::PointXYZRGBA> ());
+    std::stringstream compressed_data;
+    // interleave single stream frames, which the same decoder reads as well
+    stream_encoder.encodePointCloud (cloud, compressed_data);
+    decoder.decodePointCloud (compressed_data, cloud_out);
+    EXPECT_EQ (cloud->size (), cloud_out->size ());
+
+    block_encoder.encodePointCloud (cloud, compressed_data);
+    decoder.decodePointCloud (compressed_data, cloud_out);
+    ASSERT_EQ (cloud->size (), cloud_out->size ());
+    EXPECT_EQ (cloud_out->width, cloud_out->size ());
+    EXPECT_EQ (1u, cloud_out->height);
+
+    // every decoded point lies within the coding precision of an input point
+    pcl::octree::OctreePointCloudSearch<pcl::PointXYZRGBA> search (0.1);
+    search.setInputCloud (cloud);
+    search.addPointsFromInputCloud ();
+    for (const auto &point : cloud_out->points)
+    {
+      std::vector<int> k_indices;
+      std::vector<float> k_sqr_distances;
+      ASSERT_EQ (1, search.nearestKSearch (point, 1, k_indices, k_sqr_distances));
+      EXPECT_LT (k_sqr_distances[0], 0.01f * 0.01f);
+    }
+  }
+
+  // more blocks than points
+  pcl::PointCloud<pcl::PointXYZRGBA>::Ptr tiny_cloud (new pcl::PointCloud<pcl::PointXYZRGBA> ());
+  tiny_cloud->push_back (cloud->points[0]);
+  tiny_cloud->push_back (cloud->points[1]);
+  block_encoder.setNumberOfBlocks (8);
+  {
+    pcl::PointCloud<pcl::PointXYZRGBA>::Ptr cloud_out (new pcl::PointCloud<pcl::PointXYZRGBA> ());
+    std::stringstream compressed_data;
+    block_encoder.encodePointCloud (tiny_cloud, compressed_data);
+    decoder.decodePointCloud (compressed_data, cloud_out);
+    EXPECT_EQ (2u, cloud_out->size ());
+  }
+
+  // frames of an unknown block frame version are rejected
+  {
+    std::stringstream compressed_data;
+    block_encoder.encodePointCloud (tiny_cloud, compressed_data);
+    std::string data = compressed_data.str ();
+    data[std::strlen ("<PCL-OCT-BLOCKS>")] = static_cast<char> (pcl::io::octreeBlockFrameVersion_ + 1);
+    std::stringstream corrupted_data (data);
+    pcl::PointCloud<pcl::PointXYZRGBA>::Ptr cloud_out (new pcl::PointCloud<pcl::PointXYZRGBA> ());
+    EXPECT_THROW (decoder.decodePointCloud (corrupted_data, cloud_out), pcl::IOException);
+  }
+
+  // corrupted block counts and sizes are rejected before allocating, truncated frames and streams are rejected
+  {
+    std::stringstream compressed_data;
+    block_encoder.encodePointCloud (tiny_cloud, compressed_data);
+    const std::string data = compressed_data.str ();
+    const size_t nr_blocks_offset = std::strlen ("<PCL-OCT-BLOCKS>") + 1 + sizeof (uint32_t);
+    pcl::PointCloud<pcl::PointXYZRGBA>::Ptr cloud_out (new pcl::PointCloud<pcl::PointXYZRGBA> ());
+
+    std::string corrupted (data);
+    const uint32_t nr_blocks = std::numeric_limits<uint32_t>::max ();
+    std::memcpy (&corrupted[nr_blocks_offset], &nr_blocks, sizeof (nr_blocks));
+    std::stringstream corrupted_count (corrupted);
+    EXPECT_THROW (decoder.decodePointCloud (corrupted_count, cloud_out), pcl::IOException);
+
+    corrupted = data;
+    const uint64_t block_size = std::numeric_limits<uint64_t>::max () / 2;
+    std::memcpy (&corrupted[nr_blocks_offset + sizeof (uint32_t)], &block_size, sizeof (block_size));
+    std::stringstream corrupted_size (corrupted);
+    EXPECT_THROW (decoder.decodePointCloud (corrupted_size, cloud_out), pcl::IOException);
+
+    for (size_t length : {nr_blocks_offset - 2, nr_blocks_offset + 6, data.size () - 1})
+    {
+      std::stringstream truncated_data (data.substr (0, length));
+      EXPECT_THROW (decoder.decodePointCloud (truncated_data, cloud_out), pcl::IOException);
+    }
+
+    std::stringstream empty_data;
+    EXPECT_THROW (decoder.decodePointCloud (empty_data, cloud_out), pcl::IOException);
+  }
+}
+
+TEST (PCL, OctreeDeCompressionRANS)
+{
+  srand (1234);
+
+  pcl::io::OctreePointCloudCompression<pcl::PointXYZRGBA> range_encoder (pcl::io::MED_RES_ONLINE_COMPRESSION_WITH_COLOR, false);
+  pcl::io::OctreePointCloudCompression<pcl::PointXYZRGBA> rans_encoder (pcl::io::MED_RES_ONLINE_COMPRESSION_WITH_COLOR_RANS, false);
+  pcl::io::OctreePointCloudCompression<pcl::PointXYZRGBA> range_decoder;
+  pcl::io::OctreePointCloudCompression<pcl::PointXYZRGBA> rans_decoder;
+  EXPECT_EQ (pcl::io::RANGE_CODER, range_encoder.getEntropyCoder ());
+  EXPECT_EQ (pcl::io::RANS_CODER, rans_encoder.getEntropyCoder ());
+
+  // a moving surface, so frames alternate between intra and prediction coding
+  pcl::PointCloud<pcl::PointXYZRGBA>::Ptr cloud (new pcl::PointCloud<pcl::PointXYZRGBA> ());
+  for (int point = 0; point < 20000; point++)
+  {
+    pcl::PointXYZRGBA new_point;
+    new_point.x = static_cast<float> (2.0 * rand () / RAND_MAX);
+    new_point.y = static_cast<float> (2.0 * rand () / RAND_MAX);
+    new_point.z = 0.2f * std::sin (3.0f * new_point.x) * std::cos (2.0f * new_point.y);
+    new_point.r = static_cast<uint8_t> (100.0f * new_point.x);
+    new_point.g = static_cast<uint8_t> (100.0f * new_point.y);
+    new_point.b = 128;
+    new_point.a = 255;
+    cloud->push_back (new_point);
+  }
+
+  size_t range_bytes = 0;
+  size_t rans_bytes = 0;
+  for (int frame = 0; frame < 4; frame++)
+  {
+    for (auto &point : cloud->points)
+      point.x += 0.001f;
+
+    // decoders follow the entropy coder of the frames they read
+    pcl::PointCloud<pcl::PointXYZRGBA>::Ptr range_cloud_out (new pcl::PointCloud<pcl::PointXYZRGBA> ());
+    std::stringstream range_data;
+    range_encoder.encodePointCloud (cloud, range_data);
+    range_bytes += range_data.str ().size ();
+    range_decoder.decodePointCloud (range_data, range_cloud_out);
+    EXPECT_EQ (pcl::io::RANGE_CODER, range_decoder.getEntropyCoder ());
+
+    pcl::PointCloud<pcl::PointXYZRGBA>::Ptr rans_cloud_out (new pcl::PointCloud<pcl::PointXYZRGBA> ());
+    std::stringstream rans_data;
+    rans_encoder.encodePointCloud (cloud, rans_data);
+    rans_bytes += rans_data.str ().size ();
+    rans_decoder.decodePointCloud (rans_data, rans_cloud_out);
+    EXPECT_EQ (pcl::io::RANS_CODER, rans_decoder.getEntropyCoder ());
+
+    // entropy coding is lossless, so both coders decode the same points
+    ASSERT_EQ (cloud->size (), rans_cloud_out->size ());
+    ASSERT_EQ (range_cloud_out->size (), rans_cloud_out->size ());
+    for (size_t i = 0; i < rans_cloud_out->size (); i++)
+    {
+      EXPECT_EQ (range_cloud_out->points[i].x, rans_cloud_out->points[i].x);
+      EXPECT_EQ (range_cloud_out->points[i].y, rans_cloud_out->points[i].y);
+      EXPECT_EQ (range_cloud_out->points[i].z, rans_cloud_out->points[i].z);
+      EXPECT_EQ (range_cloud_out->points[i].rgba, rans_cloud_out->points[i].rgba);
+    }
+  }
+  EXPECT_LT (rans_bytes, range_bytes);
+
+  // block frames code their blocks with the coder of the encoder
+  rans_encoder.setNumberOfBlocks (2);
+  {
+    pcl::io::OctreePointCloudCompression<pcl::PointXYZRGBA> decoder;
+    pcl::PointCloud<pcl::PointXYZRGBA>::Ptr cloud_out (new pcl::PointCloud<pcl::PointXYZRGBA> ());
+    std::stringstream compressed_data;
+    rans_encoder.encodePointCloud (cloud, compressed_data);
+    EXPECT_NE (std::string::npos, compressed_data.str ().find ("<PCL-OCT-RANS>"));
+    decoder.decodePointCloud (compressed_data, cloud_out);
+    EXPECT_EQ (cloud->size (), cloud_out->size ());
+  }
+}
+
 TEST(PCL, OctreeDeCompressionFile)
 {
   pcl::PointCloud<pcl::PointXYZRGB>::Ptr input_cloud_ptr (new pcl::PointCloud<pcl::PointXYZRGB>);
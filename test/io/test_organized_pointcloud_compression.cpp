@@ -0,0 +1,481 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/compression/organized_pointcloud_compression.h>
+#include <pcl/compression/depth_image_coder.h>
+#include <pcl/compression/libpng_wrapper.h>
+#include <pcl/point_types.h>
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace pcl;
+using namespace pcl::io;
+
+using Cloud = PointCloud<PointXYZRGBA>;
+
+// Disparity maps are coded with a focal length and scale of 1 and no shift, so every decoded depth is 1 / disparity
+const float focal_length = 1.0f;
+const float disparity_shift = 0.0f;
+const float disparity_scale = 1.0f;
+
+const char* keyframe_identifier = "<PCL-ORG-COMPRESSED>";
+const char* delta_identifier = "<PCL-ORG-DELTA>";
+
+// Textured slanted plane with an invalid border and a box moving to the right from frame to frame
+void
+createFrame (int frame, uint32_t width, uint32_t height, std::vector<uint16_t> &disparity, std::vector<uint8_t> &color)
+{
+  disparity.assign (width * height, 0);
+  color.assign (width * height * 3, 0);
+  for (uint32_t v = 0; v < height; ++v)
+  {
+    for (uint32_t u = 0; u < width; ++u)
+    {
+      const size_t i = v * width + u;
+      disparity[i] = static_cast<uint16_t> (500 + (u * 7 + v * 13) % 50);
+      color[3 * i + 0] = static_cast<uint8_t> (u * 3);
+      color[3 * i + 1] = static_cast<uint8_t> (v * 5);
+      color[3 * i + 2] = static_cast<uint8_t> (u * v);
+      if (u >= 4 * static_cast<uint32_t> (frame) + 20 && u < 4 * static_cast<uint32_t> (frame) + 36 && v >= 8 && v < 24)
+      {
+        disparity[i] = 900;
+        color[3 * i + 0] = 255;
+      }
+      if (u < 2)
+        disparity[i] = 0;
+    }
+  }
+}
+
+// Recover the disparity map and color image of a decoded cloud
+void
+recoverFrame (const Cloud &cloud, std::vector<uint16_t> &disparity, std::vector<uint8_t> &color)
+{
+  disparity.assign (cloud.size (), 0);
+  color.assign (cloud.size () * 3, 0);
+  for (size_t i = 0; i < cloud.size (); ++i)
+  {
+    if (std::isfinite (cloud[i].z))
+      disparity[i] = static_cast<uint16_t> (std::lround (focal_length / (cloud[i].z * disparity_scale)));
+    color[3 * i + 0] = cloud[i].r;
+    color[3 * i + 1] = cloud[i].g;
+    color[3 * i + 2] = cloud[i].b;
+  }
+}
+
+// Compare two decoded clouds bit by bit
+bool
+equalClouds (const Cloud &cloud_a, const Cloud &cloud_b)
+{
+  if (cloud_a.width != cloud_b.width || cloud_a.height != cloud_b.height || cloud_a.size () != cloud_b.size ())
+    return (false);
+  for (size_t i = 0; i < cloud_a.size (); ++i)
+    if (std::memcmp (cloud_a[i].data, cloud_b[i].data, sizeof (cloud_a[i].data)) != 0 || cloud_a[i].rgba != cloud_b[i].rgba)
+      return (false);
+  return (true);
+}
+
+bool
+isDeltaFrame (const std::string &data)
+{
+  return (data.compare (0, strlen (delta_identifier), delta_identifier) == 0);
+}
+
+// Read the masks of changed and replaced tiles from a delta frame
+void
+readTileMasks (const std::string &data, std::vector<uint8_t> &changed, std::vector<uint8_t> &replaced)
+{
+  size_t offset = strlen (delta_identifier) + 2 * sizeof (uint32_t) + 4 * sizeof (float) + sizeof (uint32_t);
+  uint32_t mask_size;
+  std::memcpy (&mask_size, &data[offset], sizeof (mask_size));
+  offset += sizeof (mask_size);
+  changed.assign (data.begin () + offset, data.begin () + offset + mask_size / 2);
+  replaced.assign (data.begin () + offset + mask_size / 2, data.begin () + offset + mask_size);
+}
+
+bool
+tileBit (const std::vector<uint8_t> &mask, uint32_t tile)
+{
+  return ((mask[tile / 8] & (1 << (tile % 8))) != 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, OrganizedCompressionDeltaFramesLossless)
+{
+  const uint32_t width = 64, height = 48;
+
+  for (bool predictive : {false, true})
+  {
+    for (bool mono : {false, true})
+    {
+      OrganizedPointCloudCompression<PointXYZRGBA> encoder, decoder, keyframe_encoder, keyframe_decoder;
+      encoder.setPredictiveDepthCoding (predictive);
+      encoder.setKeyframeInterval (4);
+      keyframe_encoder.setPredictiveDepthCoding (predictive);
+
+      for (int frame = 0; frame < 8; ++frame)
+      {
+        std::vector<uint16_t> disparity, keyframe_disparity;
+        std::vector<uint8_t> color, keyframe_color;
+        createFrame (frame, width, height, disparity, color);
+        const std::vector<uint16_t> input_disparity = disparity;
+        keyframe_disparity = disparity;
+        keyframe_color = color;
+
+        std::stringstream compressed_data, keyframe_data;
+        encoder.encodeRawDisparityMapWithColorImage (disparity, color, width, height, compressed_data, true, mono, false,
+                                                     -1, focal_length, disparity_shift, disparity_scale);
+        keyframe_encoder.encodeRawDisparityMapWithColorImage (keyframe_disparity, keyframe_color, width, height, keyframe_data,
+                                                              true, mono, false, -1, focal_length, disparity_shift, disparity_scale);
+        EXPECT_EQ (frame % 4 != 0, isDeltaFrame (compressed_data.str ()));
+        if (frame % 4 != 0)
+          EXPECT_LT (compressed_data.str ().size (), keyframe_data.str ().size ());
+
+        Cloud::Ptr cloud_out (new Cloud), keyframe_cloud_out (new Cloud);
+        ASSERT_TRUE (decoder.decodePointCloud (compressed_data, cloud_out, false));
+        ASSERT_TRUE (keyframe_decoder.decodePointCloud (keyframe_data, keyframe_cloud_out, false));
+        EXPECT_TRUE (equalClouds (*keyframe_cloud_out, *cloud_out)) << "frame " << frame;
+
+        std::vector<uint16_t> decoded_disparity;
+        std::vector<uint8_t> decoded_color;
+        recoverFrame (*cloud_out, decoded_disparity, decoded_color);
+        EXPECT_EQ (input_disparity, decoded_disparity) << "frame " << frame;
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, OrganizedCompressionDeltaFrameTiles)
+{
+  const uint32_t width = 64, height = 48, tile_size = 16;
+  const uint32_t tiles_x = width / tile_size;
+
+  OrganizedPointCloudCompression<PointXYZRGBA> encoder, decoder;
+  encoder.setKeyframeInterval (10);
+  encoder.setTileSize (tile_size);
+
+  std::vector<uint16_t> disparity;
+  std::vector<uint8_t> color;
+  createFrame (0, width, height, disparity, color);
+  std::vector<uint16_t> next_disparity = disparity;
+  const std::vector<uint8_t> next_color = color;
+
+  // the texture of tile (1, 2) moves slightly, tile (2, 2) turns into a flat surface
+  for (uint32_t v = 2 * tile_size; v < 3 * tile_size; ++v)
+  {
+    for (uint32_t u = tile_size; u < 2 * tile_size; ++u)
+      next_disparity[v * width + u] += 1;
+    for (uint32_t u = 2 * tile_size; u < 3 * tile_size; ++u)
+      next_disparity[v * width + u] = 800;
+  }
+
+  std::stringstream compressed_data;
+  std::vector<uint8_t> input_color = color;
+  encoder.encodeRawDisparityMapWithColorImage (disparity, input_color, width, height, compressed_data, true, false, false,
+                                               -1, focal_length, disparity_shift, disparity_scale);
+  Cloud::Ptr cloud_out (new Cloud);
+  ASSERT_TRUE (decoder.decodePointCloud (compressed_data, cloud_out, false));
+
+  std::stringstream delta_data;
+  std::vector<uint16_t> input_disparity = next_disparity;
+  input_color = next_color;
+  encoder.encodeRawDisparityMapWithColorImage (input_disparity, input_color, width, height, delta_data, true, false, false,
+                                               -1, focal_length, disparity_shift, disparity_scale);
+  ASSERT_TRUE (isDeltaFrame (delta_data.str ()));
+
+  std::vector<uint8_t> changed, replaced;
+  readTileMasks (delta_data.str (), changed, replaced);
+  for (uint32_t tile = 0; tile < tiles_x * (height / tile_size); ++tile)
+  {
+    if (tile == 2 * tiles_x + 1)
+    {
+      EXPECT_TRUE (tileBit (changed, tile));
+      EXPECT_FALSE (tileBit (replaced, tile));
+    }
+    else if (tile == 2 * tiles_x + 2)
+    {
+      EXPECT_TRUE (tileBit (changed, tile));
+      EXPECT_TRUE (tileBit (replaced, tile));
+    }
+    else
+    {
+      EXPECT_FALSE (tileBit (changed, tile)) << "tile " << tile;
+      EXPECT_FALSE (tileBit (replaced, tile)) << "tile " << tile;
+    }
+  }
+
+  ASSERT_TRUE (decoder.decodePointCloud (delta_data, cloud_out, false));
+  std::vector<uint16_t> decoded_disparity;
+  std::vector<uint8_t> decoded_color;
+  recoverFrame (*cloud_out, decoded_disparity, decoded_color);
+  EXPECT_EQ (next_disparity, decoded_disparity);
+
+  // an unchanged frame skips every tile
+  std::stringstream unchanged_data;
+  input_disparity = next_disparity;
+  input_color = next_color;
+  encoder.encodeRawDisparityMapWithColorImage (input_disparity, input_color, width, height, unchanged_data, true, false, false,
+                                               -1, focal_length, disparity_shift, disparity_scale);
+  ASSERT_TRUE (isDeltaFrame (unchanged_data.str ()));
+  readTileMasks (unchanged_data.str (), changed, replaced);
+  for (uint8_t mask_byte : changed)
+    EXPECT_EQ (0, mask_byte);
+  ASSERT_TRUE (decoder.decodePointCloud (unchanged_data, cloud_out, false));
+  recoverFrame (*cloud_out, decoded_disparity, decoded_color);
+  EXPECT_EQ (next_disparity, decoded_disparity);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, OrganizedCompressionDeltaFrameThresholds)
+{
+  const uint32_t width = 64, height = 48;
+  const int depth_threshold = 3, color_threshold = 2;
+
+  OrganizedPointCloudCompression<PointXYZRGBA> encoder, decoder;
+  encoder.setKeyframeInterval (20);
+  encoder.setDepthChangeThreshold (depth_threshold);
+  encoder.setColorChangeThreshold (color_threshold);
+
+  // disparities and, in the right half, colors drift by one step per frame, so skipped tiles would accumulate errors
+  for (int frame = 0; frame < 16; ++frame)
+  {
+    std::vector<uint16_t> disparity;
+    std::vector<uint8_t> color;
+    createFrame (0, width, height, disparity, color);
+    for (size_t i = 0; i < disparity.size (); ++i)
+    {
+      if (disparity[i])
+        disparity[i] = static_cast<uint16_t> (disparity[i] + frame);
+      if (i % width >= width / 2)
+        color[3 * i + 2] = static_cast<uint8_t> (color[3 * i + 2] + frame);
+    }
+    // a pixel turning invalid is never skipped
+    if (frame == 5)
+      disparity[10 * width + 40] = 0;
+    for (size_t i = 0; i < disparity.size (); ++i)
+      if (!disparity[i])
+        color[3 * i + 0] = color[3 * i + 1] = color[3 * i + 2] = 0;
+
+    const std::vector<uint16_t> input_disparity = disparity;
+    const std::vector<uint8_t> input_color = color;
+    std::stringstream compressed_data;
+    encoder.encodeRawDisparityMapWithColorImage (disparity, color, width, height, compressed_data, true, false, false,
+                                                 -1, focal_length, disparity_shift, disparity_scale);
+    EXPECT_EQ (frame != 0, isDeltaFrame (compressed_data.str ()));
+
+    Cloud::Ptr cloud_out (new Cloud);
+    ASSERT_TRUE (decoder.decodePointCloud (compressed_data, cloud_out, false));
+    std::vector<uint16_t> decoded_disparity;
+    std::vector<uint8_t> decoded_color;
+    recoverFrame (*cloud_out, decoded_disparity, decoded_color);
+
+    int max_depth_error = 0, max_color_error = 0;
+    for (size_t i = 0; i < input_disparity.size (); ++i)
+    {
+      ASSERT_EQ (input_disparity[i] == 0, decoded_disparity[i] == 0) << "frame " << frame << " pixel " << i;
+      max_depth_error = std::max (max_depth_error, std::abs (input_disparity[i] - decoded_disparity[i]));
+      for (int c = 0; c < 3; ++c)
+        max_color_error = std::max (max_color_error, std::abs (input_color[3 * i + c] - decoded_color[3 * i + c]));
+    }
+    EXPECT_LE (max_depth_error, depth_threshold) << "frame " << frame;
+    EXPECT_LE (max_color_error, color_threshold) << "frame " << frame;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, OrganizedCompressionForcedKeyframes)
+{
+  OrganizedPointCloudCompression<PointXYZRGBA> encoder, decoder;
+  encoder.setKeyframeInterval (10);
+
+  // image size, color coding and expected frame type
+  struct Frame { uint32_t width; uint32_t height; bool color; bool mono; bool delta; };
+  const Frame frames[] = {{64, 48, true, false, false},
+                          {64, 48, true, false, true},
+                          {32, 48, true, false, false},
+                          {32, 48, true, false, true},
+                          {32, 48, false, false, false},
+                          {32, 48, false, false, true},
+                          {32, 48, true, true, false},
+                          {32, 48, true, true, true},
+                          {32, 48, true, false, false}};
+
+  int index = 0;
+  for (const Frame &frame : frames)
+  {
+    std::vector<uint16_t> disparity;
+    std::vector<uint8_t> color;
+    createFrame (index++, frame.width, frame.height, disparity, color);
+    const std::vector<uint16_t> input_disparity = disparity;
+
+    std::stringstream compressed_data;
+    encoder.encodeRawDisparityMapWithColorImage (disparity, color, frame.width, frame.height, compressed_data, frame.color,
+                                                 frame.mono, false, -1, focal_length, disparity_shift, disparity_scale);
+    EXPECT_EQ (frame.delta, isDeltaFrame (compressed_data.str ())) << "frame " << index;
+
+    Cloud::Ptr cloud_out (new Cloud);
+    ASSERT_TRUE (decoder.decodePointCloud (compressed_data, cloud_out, false));
+    EXPECT_EQ (frame.width, cloud_out->width);
+    EXPECT_EQ (frame.height, cloud_out->height);
+    std::vector<uint16_t> decoded_disparity;
+    std::vector<uint8_t> decoded_color;
+    recoverFrame (*cloud_out, decoded_disparity, decoded_color);
+    EXPECT_EQ (input_disparity, decoded_disparity) << "frame " << index;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, OrganizedCompressionDeltaFrameWithoutKeyframe)
+{
+  const uint32_t width = 64, height = 48;
+
+  OrganizedPointCloudCompression<PointXYZRGBA> encoder;
+  encoder.setKeyframeInterval (3);
+
+  std::stringstream compressed_data;
+  for (int frame = 0; frame < 4; ++frame)
+  {
+    std::vector<uint16_t> disparity;
+    std::vector<uint8_t> color;
+    createFrame (frame, width, height, disparity, color);
+    encoder.encodeRawDisparityMapWithColorImage (disparity, color, width, height, compressed_data, true, false, false,
+                                                 -1, focal_length, disparity_shift, disparity_scale);
+  }
+
+  // a decoder joining after the first keyframe rejects the delta frames and resumes at the next keyframe
+  const std::string data = compressed_data.str ();
+  std::stringstream joined_data (data.substr (data.find (delta_identifier)));
+  OrganizedPointCloudCompression<PointXYZRGBA> decoder;
+  Cloud::Ptr cloud_out (new Cloud);
+  EXPECT_FALSE (decoder.decodePointCloud (joined_data, cloud_out, false));
+  EXPECT_FALSE (decoder.decodePointCloud (joined_data, cloud_out, false));
+  ASSERT_TRUE (decoder.decodePointCloud (joined_data, cloud_out, false));
+
+  std::vector<uint16_t> disparity, decoded_disparity;
+  std::vector<uint8_t> color, decoded_color;
+  createFrame (3, width, height, disparity, color);
+  recoverFrame (*cloud_out, decoded_disparity, decoded_color);
+  EXPECT_EQ (disparity, decoded_disparity);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, OrganizedCompressionKeyframeFormat)
+{
+  const uint32_t width = 64, height = 48;
+  const float max_depth = -1.0f;
+
+  for (bool predictive : {false, true})
+  {
+    for (int color_mode = 0; color_mode < 3; ++color_mode)
+    {
+      const bool do_color = color_mode > 0;
+      const bool mono = color_mode == 2;
+
+      std::vector<uint16_t> disparity;
+      std::vector<uint8_t> color;
+      createFrame (0, width, height, disparity, color);
+      for (size_t i = 0; i < disparity.size (); ++i)
+        if (!disparity[i])
+          color[3 * i + 0] = color[3 * i + 1] = color[3 * i + 2] = 0;
+
+      // frame layout of encoders without delta frames
+      std::vector<uint8_t> compressed_disparity, compressed_color;
+      if (predictive)
+        DepthImageCoder ().encode (disparity, width, height, compressed_disparity);
+      else
+        encodeMonoImageToPNG (disparity, width, height, compressed_disparity, -1);
+      if (mono)
+      {
+        std::vector<uint8_t> mono_image;
+        for (size_t i = 0; i < disparity.size (); ++i)
+          mono_image.push_back (static_cast<uint8_t> (0.2989 * static_cast<float> (color[i * 3 + 0]) +
+                                                      0.5870 * static_cast<float> (color[i * 3 + 1]) +
+                                                      0.1140 * static_cast<float> (color[i * 3 + 2])));
+        encodeMonoImageToPNG (mono_image, width, height, compressed_color, 1);
+      }
+      else if (do_color)
+        encodeRGBImageToPNG (color, width, height, compressed_color, 1);
+
+      std::ostringstream expected;
+      const uint32_t compressed_disparity_size = static_cast<uint32_t> (compressed_disparity.size ());
+      const uint32_t compressed_color_size = static_cast<uint32_t> (compressed_color.size ());
+      expected.write (keyframe_identifier, strlen (keyframe_identifier));
+      expected.write (reinterpret_cast<const char*> (&width), sizeof (width));
+      expected.write (reinterpret_cast<const char*> (&height), sizeof (height));
+      expected.write (reinterpret_cast<const char*> (&max_depth), sizeof (max_depth));
+      expected.write (reinterpret_cast<const char*> (&focal_length), sizeof (focal_length));
+      expected.write (reinterpret_cast<const char*> (&disparity_scale), sizeof (disparity_scale));
+      expected.write (reinterpret_cast<const char*> (&disparity_shift), sizeof (disparity_shift));
+      expected.write (reinterpret_cast<const char*> (&compressed_disparity_size), sizeof (compressed_disparity_size));
+      expected.write (reinterpret_cast<const char*> (compressed_disparity.data ()), compressed_disparity.size ());
+      expected.write (reinterpret_cast<const char*> (&compressed_color_size), sizeof (compressed_color_size));
+      expected.write (reinterpret_cast<const char*> (compressed_color.data ()), compressed_color.size ());
+
+      // keyframes are written the same way with and without delta frames
+      for (unsigned int keyframe_interval : {1u, 5u})
+      {
+        OrganizedPointCloudCompression<PointXYZRGBA> encoder;
+        encoder.setPredictiveDepthCoding (predictive);
+        encoder.setKeyframeInterval (keyframe_interval);
+
+        std::vector<uint16_t> input_disparity;
+        std::vector<uint8_t> input_color;
+        createFrame (0, width, height, input_disparity, input_color);
+        std::stringstream compressed_data;
+        encoder.encodeRawDisparityMapWithColorImage (input_disparity, input_color, width, height, compressed_data, do_color,
+                                                     mono, false, -1, focal_length, disparity_shift, disparity_scale);
+        EXPECT_EQ (expected.str (), compressed_data.str ())
+          << "predictive " << predictive << " color mode " << color_mode << " keyframe interval " << keyframe_interval;
+      }
+    }
+  }
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
@@ -166,6 +166,97 @@ TEST (PCL, Static_Range_Coder_Test)
 
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// append the occupancy bytes of a random octree branch and its sub branches in depth first order
+void
+appendRandomOccupancy (unsigned int depth, unsigned int treeDepth, std::vector<char>& occupancy)
+{
+  // mostly single children, keeping the tree small
+  unsigned char pattern = static_cast<unsigned char> (1 << (rand () & 7));
+  if (rand () % 4 == 0)
+    pattern = static_cast<unsigned char> (pattern | (rand () & 0xFF));
+
+  occupancy.push_back (static_cast<char> (pattern));
+  if (depth + 1 < treeDepth)
+  {
+    for (unsigned int child = 0; child < 8; child++)
+      if (pattern & (1 << child))
+        appendRandomOccupancy (depth + 1, treeDepth, occupancy);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, Interleaved_RANS_Coder_Test)
+{
+  std::stringstream sstream;
+  std::vector<char> inputCharData;
+  std::vector<char> outputCharData;
+
+  std::vector<unsigned int> inputIntData;
+  std::vector<unsigned int> outputIntData;
+
+  unsigned long writeByteLen;
+  unsigned long readByteLen;
+
+  // vector size, not a multiple of the number of interleaved states
+  const unsigned int vectorSize = 10001;
+
+  inputCharData.resize (vectorSize);
+  outputCharData.resize (vectorSize);
+
+  inputIntData.resize (vectorSize);
+  outputIntData.resize (vectorSize);
+
+  // fill vectors with random data
+  for (size_t i=0; i<vectorSize; i++)
+  {
+    inputCharData[i] = static_cast<char> (rand () & 0xFF);
+    inputIntData[i] = static_cast<unsigned int> (rand ());
+  }
+
+  pcl::InterleavedRANSCoder ransCoder;
+
+  // char vector
+  writeByteLen = ransCoder.encodeCharVectorToStream (inputCharData, sstream);
+  readByteLen = ransCoder.decodeStreamToCharVector (sstream, outputCharData);
+
+  EXPECT_EQ (writeByteLen, readByteLen);
+  EXPECT_EQ (writeByteLen, sstream.str ().length ());
+  EXPECT_EQ (inputCharData, outputCharData);
+
+  // integer vector
+  writeByteLen = ransCoder.encodeIntVectorToStream (inputIntData, sstream);
+  readByteLen = ransCoder.decodeStreamToIntVector (sstream, outputIntData);
+
+  EXPECT_EQ (writeByteLen, readByteLen);
+  EXPECT_EQ (inputIntData, outputIntData);
+
+  // empty vector
+  inputCharData.clear ();
+  outputCharData.clear ();
+  writeByteLen = ransCoder.encodeCharVectorToStream (inputCharData, sstream);
+  readByteLen = ransCoder.decodeStreamToCharVector (sstream, outputCharData);
+
+  EXPECT_EQ (writeByteLen, readByteLen);
+  EXPECT_TRUE (outputCharData.empty ());
+
+  // octree occupancy, coded in context of the tree structure and without it
+  for (unsigned int treeDepth = 1; treeDepth <= 10; treeDepth++)
+  {
+    inputCharData.clear ();
+    appendRandomOccupancy (0, treeDepth, inputCharData);
+    outputCharData.resize (inputCharData.size ());
+
+    for (unsigned int codedDepth = 0; codedDepth <= treeDepth; codedDepth += treeDepth)
+    {
+      writeByteLen = ransCoder.encodeOccupancyVectorToStream (inputCharData, codedDepth, sstream);
+      readByteLen = ransCoder.decodeStreamToOccupancyVector (sstream, codedDepth, outputCharData);
+
+      EXPECT_EQ (writeByteLen, readByteLen);
+      EXPECT_EQ (inputCharData, outputCharData);
+    }
+  }
+}
 
 
 /* ---[ */
@@ -38,6 +38,8 @@
  */
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <set>
 #include <vector>
 
 #include <cstdio>
@@ -241,6 +243,54 @@ TEST (PCL, Octree_Test)
   ASSERT_EQ (octreeA.getLeafCount (), leaf_count);
 }
 
+TEST (PCL, Octree_Copy_Test)
+{
+  OctreeBase<int> octreeA;
+  octreeA.setTreeDepth (8);
+
+  // create and remove leaves repeatedly, so that node memory gets recycled
+  for (unsigned int run = 0; run < 3; run++)
+  {
+    for (unsigned int i = 0; i < 256; i++)
+      *octreeA.createLeaf (i, (i * 7) % 256, (i * 13) % 256) = static_cast<int> (i);
+    for (unsigned int i = 0; i < 256; i += 2)
+      octreeA.removeLeaf (i, (i * 7) % 256, (i * 13) % 256);
+    ASSERT_EQ (128u, octreeA.getLeafCount ());
+    if (run < 2)
+      octreeA.deleteTree ();
+  }
+
+  OctreeBase<int> octreeB (octreeA);
+  OctreeBase<int> octreeC;
+  octreeC.setTreeDepth (8);
+  *octreeC.createLeaf (1, 2, 3) = -1;
+  octreeC = octreeA;
+
+  ASSERT_EQ (octreeA.getLeafCount (), octreeB.getLeafCount ());
+  ASSERT_EQ (octreeA.getBranchCount (), octreeB.getBranchCount ());
+  ASSERT_EQ (octreeA.getLeafCount (), octreeC.getLeafCount ());
+  ASSERT_EQ (octreeA.getBranchCount (), octreeC.getBranchCount ());
+  ASSERT_FALSE (octreeC.existLeaf (1, 2, 3));
+
+  for (unsigned int i = 0; i < 256; i++)
+  {
+    const bool exists = (i % 2 == 1);
+    ASSERT_EQ (exists, octreeB.existLeaf (i, (i * 7) % 256, (i * 13) % 256));
+    ASSERT_EQ (exists, octreeC.existLeaf (i, (i * 7) % 256, (i * 13) % 256));
+    if (exists)
+    {
+      ASSERT_EQ (static_cast<int> (i), *octreeB.findLeaf (i, (i * 7) % 256, (i * 13) % 256));
+      ASSERT_EQ (static_cast<int> (i), *octreeC.findLeaf (i, (i * 7) % 256, (i * 13) % 256));
+    }
+  }
+
+  // the copies are independent of the original
+  octreeA.deleteTree ();
+  ASSERT_EQ (128u, octreeB.getLeafCount ());
+  *octreeB.findLeaf (1, 7, 13) = 42;
+  ASSERT_EQ (1, *octreeC.findLeaf (1, 7, 13));
+}
+
 TEST (PCL, Octree_Dynamic_Depth_Test)
 {
   constexpr int test_runs = 100;
@@ -1026,6 +1076,126 @@ TEST (PCL, Octree_Pointcloud_Change_Detector_Test)
   }
 }
 
+TEST (PCL, Octree_Pointcloud_Change_Detector_Changed_Voxels_Test)
+{
+  const double resolution = 0.05;
+  const unsigned int frames = 6;
+
+  srand (static_cast<unsigned int> (time (nullptr)));
+
+  // voxel index of a point within the bounding box [0, 8)^3
+  auto getVoxelIdx = [resolution] (const PointXYZ& point)
+  {
+    return (static_cast<unsigned int> (point.x / resolution) * 1024 * 1024 +
+            static_cast<unsigned int> (point.y / resolution) * 1024 +
+            static_cast<unsigned int> (point.z / resolution));
+  };
+
+  OctreePointCloudChangeDetector<PointXYZ> octree (resolution);
+  octree.defineBoundingBox (0.0, 0.0, 0.0, 8.0, 8.0, 8.0);
+
+  // reference octree built point by point
+  OctreePointCloudChangeDetector<PointXYZ> octreeRef (resolution);
+  octreeRef.defineBoundingBox (0.0, 0.0, 0.0, 8.0, 8.0, 8.0);
+
+  PointCloud<PointXYZ>::Ptr cloudPrev;
+
+  for (unsigned int frame = 0; frame < frames; frame++)
+  {
+    PointCloud<PointXYZ>::Ptr cloudIn (new PointCloud<PointXYZ> ());
+
+    if (cloudPrev && (frame == 3))
+    {
+      // static scene
+      *cloudIn = *cloudPrev;
+    }
+    else
+    {
+      cloudIn->points.resize (3000);
+      for (size_t i = 0; i < cloudIn->points.size (); i++)
+      {
+        // most points are kept from the previous frame, the others move to random positions
+        if (cloudPrev && (i < cloudPrev->points.size ()) && (rand () % 10 != 0))
+          cloudIn->points[i] = cloudPrev->points[i];
+        else
+          cloudIn->points[i] = PointXYZ (static_cast<float> (4.0 * rand () / RAND_MAX),
+                                         static_cast<float> (8.0 * rand () / RAND_MAX),
+                                         static_cast<float> (6.0 * rand () / RAND_MAX));
+      }
+      cloudIn->width = static_cast<uint32_t> (cloudIn->points.size ());
+      cloudIn->height = 1;
+    }
+
+    octree.switchBuffers ();
+    octree.setInputCloud (cloudIn);
+    octree.addPointsFromInputCloud ();
+
+    octreeRef.switchBuffers ();
+    octreeRef.setInputCloud (cloudIn);
+    for (size_t i = 0; i < cloudIn->points.size (); i++)
+      octreeRef.addPointFromCloud (static_cast<int> (i), IndicesPtr ());
+
+    ASSERT_EQ (octreeRef.getLeafCount (), octree.getLeafCount ());
+
+    // brute force voxel sets of both frames
+    std::set<unsigned int> voxelsCurr;
+    std::set<unsigned int> voxelsPrev;
+    for (const auto &point : cloudIn->points)
+      voxelsCurr.insert (getVoxelIdx (point));
+    if (cloudPrev)
+      for (const auto &point : cloudPrev->points)
+        voxelsPrev.insert (getVoxelIdx (point));
+
+    OctreePointCloudChangeDetector<PointXYZ>::AlignedPointTVector addedCenters;
+    OctreePointCloudChangeDetector<PointXYZ>::AlignedPointTVector removedCenters;
+    octree.getChangedVoxelCenters (addedCenters, removedCenters);
+
+    std::set<unsigned int> addedVoxels;
+    std::set<unsigned int> removedVoxels;
+    for (const auto &center : addedCenters)
+      addedVoxels.insert (getVoxelIdx (center));
+    for (const auto &center : removedCenters)
+      removedVoxels.insert (getVoxelIdx (center));
+
+    ASSERT_EQ (addedCenters.size (), addedVoxels.size ());
+    ASSERT_EQ (removedCenters.size (), removedVoxels.size ());
+
+    for (const unsigned int voxel : voxelsCurr)
+      ASSERT_EQ (voxelsPrev.count (voxel) == 0, addedVoxels.count (voxel) == 1);
+    for (const unsigned int voxel : voxelsPrev)
+      ASSERT_EQ (voxelsCurr.count (voxel) == 0, removedVoxels.count (voxel) == 1);
+
+    if (frame == 3)
+    {
+      ASSERT_TRUE (addedVoxels.empty ());
+      ASSERT_TRUE (removedVoxels.empty ());
+    }
+
+    // added indices match the new voxels of point by point insertion, removed indices refer to the previous cloud
+    std::vector<int> addedIndices;
+    std::vector<int> removedIndices;
+    octree.getPointIndicesFromChangedVoxels (addedIndices, removedIndices);
+
+    std::vector<int> newIndicesRef;
+    octreeRef.getPointIndicesFromNewVoxels (newIndicesRef);
+
+    std::sort (addedIndices.begin (), addedIndices.end ());
+    std::sort (newIndicesRef.begin (), newIndicesRef.end ());
+    ASSERT_EQ (newIndicesRef, addedIndices);
+
+    std::vector<int> removedIndicesRef;
+    if (cloudPrev)
+      for (size_t i = 0; i < cloudPrev->points.size (); i++)
+        if (removedVoxels.count (getVoxelIdx (cloudPrev->points[i])))
+          removedIndicesRef.push_back (static_cast<int> (i));
+
+    std::sort (removedIndices.begin (), removedIndices.end ());
+    ASSERT_EQ (removedIndicesRef, removedIndices);
+
+    cloudPrev = cloudIn;
+  }
+}
+
 TEST (PCL, Octree_Pointcloud_Voxel_Centroid_Test)
 {
 
@@ -1099,6 +1269,139 @@ TEST (PCL, Octree_Pointcloud_Voxel_Centroid_Test)
 
 }
 
+TEST (PCL, Octree_Pointcloud_Bulk_Insertion_Test)
+{
+  const unsigned int test_runs = 10;
+
+  srand (static_cast<unsigned int> (time (nullptr)));
+
+  for (unsigned int test_id = 0; test_id < test_runs; test_id++)
+  {
+    PointCloud<PointXYZ>::Ptr cloudIn (new PointCloud<PointXYZ> ());
+
+    cloudIn->width = 1000 + rand () % 1000;
+    cloudIn->height = 1;
+    cloudIn->points.resize (cloudIn->width * cloudIn->height);
+
+    // generate clustered point data with a few invalid points
+    for (auto &point : cloudIn->points)
+    {
+      if (rand () % 50 == 0)
+        point = PointXYZ (std::numeric_limits<float>::quiet_NaN (), 0.0f, 0.0f);
+      else
+        point = PointXYZ (static_cast<float> (10.0 * rand () / RAND_MAX) - 5.0f,
+                          static_cast<float> (5.0 * rand () / RAND_MAX),
+                          static_cast<float> (2.0 * rand () / RAND_MAX) + 10.0f);
+    }
+
+    const double resolution = 0.1 + 0.5 * rand () / RAND_MAX;
+
+    // bulk insertion grows the bounding box like point by point insertion does
+    OctreePointCloudPointVector<PointXYZ> octreeGrowing (resolution);
+    octreeGrowing.setInputCloud (cloudIn);
+    octreeGrowing.addPointsFromInputCloud ();
+
+    OctreePointCloudPointVector<PointXYZ> octreeGrowingRef (resolution);
+    octreeGrowingRef.setInputCloud (cloudIn);
+    for (size_t i = 0; i < cloudIn->points.size (); i++)
+      if (isFinite (cloudIn->points[i]))
+        octreeGrowingRef.addPointFromCloud (static_cast<int> (i), IndicesPtr ());
+
+    double min_x, min_y, min_z, max_x, max_y, max_z;
+    double bulk_min_x, bulk_min_y, bulk_min_z, bulk_max_x, bulk_max_y, bulk_max_z;
+    octreeGrowingRef.getBoundingBox (min_x, min_y, min_z, max_x, max_y, max_z);
+    octreeGrowing.getBoundingBox (bulk_min_x, bulk_min_y, bulk_min_z, bulk_max_x, bulk_max_y, bulk_max_z);
+    EXPECT_EQ (min_x, bulk_min_x);
+    EXPECT_EQ (min_y, bulk_min_y);
+    EXPECT_EQ (min_z, bulk_min_z);
+    EXPECT_EQ (max_x, bulk_max_x);
+    EXPECT_EQ (max_y, bulk_max_y);
+    EXPECT_EQ (max_z, bulk_max_z);
+    EXPECT_EQ (octreeGrowingRef.getTreeDepth (), octreeGrowing.getTreeDepth ());
+
+    for (const auto &point : cloudIn->points)
+    {
+      if (isFinite (point))
+      {
+        EXPECT_TRUE (octreeGrowing.isVoxelOccupiedAtPoint (point));
+      }
+    }
+
+    // on a predefined bounding box, both insertion methods build the same tree
+    OctreePointCloudPointVector<PointXYZ> octreeBulk (resolution);
+    octreeBulk.setNumberOfThreads (2);
+    octreeBulk.defineBoundingBox (-5.0, 0.0, 10.0, 5.0, 5.0, 12.0);
+    octreeBulk.setInputCloud (cloudIn);
+    octreeBulk.addPointsFromInputCloud ();
+
+    OctreePointCloudSearch<PointXYZ> octree (resolution);
+    octree.defineBoundingBox (-5.0, 0.0, 10.0, 5.0, 5.0, 12.0);
+    octree.setInputCloud (cloudIn);
+    for (size_t i = 0; i < cloudIn->points.size (); i++)
+      if (isFinite (cloudIn->points[i]))
+        octree.addPointFromCloud (static_cast<int> (i), IndicesPtr ());
+
+    ASSERT_EQ (octree.getLeafCount (), octreeBulk.getLeafCount ());
+    ASSERT_EQ (octree.getBranchCount (), octreeBulk.getBranchCount ());
+    ASSERT_EQ (octree.getTreeDepth (), octreeBulk.getTreeDepth ());
+
+    // leaves are visited in the same order and hold the same indices in insertion order
+    auto it = octree.leaf_depth_begin ();
+    auto it_bulk = octreeBulk.leaf_depth_begin ();
+    for (; it != octree.leaf_depth_end (); ++it, ++it_bulk)
+    {
+      ASSERT_TRUE (it_bulk != octreeBulk.leaf_depth_end ());
+      EXPECT_EQ (it.getCurrentOctreeKey (), it_bulk.getCurrentOctreeKey ());
+
+      std::vector<int> indices, bulk_indices;
+      it.getLeafContainer ().getPointIndices (indices);
+      it_bulk.getLeafContainer ().getPointIndices (bulk_indices);
+      EXPECT_EQ (indices, bulk_indices);
+    }
+    EXPECT_TRUE (it_bulk == octreeBulk.leaf_depth_end ());
+
+    // voxel centroids
+    OctreePointCloudVoxelCentroid<PointXYZ> centroidsBulk (resolution);
+    centroidsBulk.defineBoundingBox (-5.0, 0.0, 10.0, 5.0, 5.0, 12.0);
+    centroidsBulk.setInputCloud (cloudIn);
+    centroidsBulk.addPointsFromInputCloud ();
+
+    OctreePointCloudVoxelCentroid<PointXYZ> centroids (resolution);
+    centroids.defineBoundingBox (-5.0, 0.0, 10.0, 5.0, 5.0, 12.0);
+    centroids.setInputCloud (cloudIn);
+    for (size_t i = 0; i < cloudIn->points.size (); i++)
+      if (isFinite (cloudIn->points[i]))
+        centroids.addPointFromCloud (static_cast<int> (i), IndicesPtr ());
+
+    pcl::PointCloud<PointXYZ>::VectorType voxelCentroids, bulkVoxelCentroids;
+    centroids.getVoxelCentroids (voxelCentroids);
+    centroidsBulk.getVoxelCentroids (bulkVoxelCentroids);
+    ASSERT_EQ (voxelCentroids.size (), bulkVoxelCentroids.size ());
+    for (size_t i = 0; i < voxelCentroids.size (); i++)
+    {
+      EXPECT_EQ (voxelCentroids[i].x, bulkVoxelCentroids[i].x);
+      EXPECT_EQ (voxelCentroids[i].y, bulkVoxelCentroids[i].y);
+      EXPECT_EQ (voxelCentroids[i].z, bulkVoxelCentroids[i].z);
+    }
+
+    // voxel densities
+    OctreePointCloudDensity<PointXYZ> densityBulk (resolution);
+    densityBulk.defineBoundingBox (-5.0, 0.0, 10.0, 5.0, 5.0, 12.0);
+    densityBulk.setInputCloud (cloudIn);
+    densityBulk.addPointsFromInputCloud ();
+
+    for (const auto &point : cloudIn->points)
+    {
+      if (isFinite (point))
+      {
+        std::vector<int> indices;
+        octree.voxelSearch (point, indices);
+        EXPECT_EQ (indices.size (), densityBulk.getVoxelDensityAtPoint (point));
+      }
+    }
+  }
+}
+
 // helper class for priority queue
 class prioPointQueueEntry
 {
@@ -1224,6 +1527,96 @@ TEST (PCL, Octree_Pointcloud_Nearest_K_Neighbour_Search)
   }
 }
 
+TEST (PCL, Octree_Pointcloud_Batch_Search)
+{
+  const unsigned int test_runs = 5;
+
+  srand (static_cast<unsigned int> (time (nullptr)));
+
+  for (unsigned int test_id = 0; test_id < test_runs; test_id++)
+  {
+    PointCloud<PointXYZ>::Ptr cloudIn (new PointCloud<PointXYZ> ());
+    PointCloud<PointXYZ> queries;
+
+    cloudIn->width = 1000 + rand () % 2000;
+    cloudIn->height = 1;
+    cloudIn->points.resize (cloudIn->width * cloudIn->height);
+    for (auto &point : cloudIn->points)
+      point = PointXYZ (static_cast<float> (10.0 * rand () / RAND_MAX),
+                        static_cast<float> (10.0 * rand () / RAND_MAX),
+                        static_cast<float> (5.0 * rand () / RAND_MAX));
+
+    queries.resize (100);
+    for (auto &point : queries.points)
+      point = PointXYZ (static_cast<float> (12.0 * rand () / RAND_MAX) - 1.0f,
+                        static_cast<float> (12.0 * rand () / RAND_MAX) - 1.0f,
+                        static_cast<float> (7.0 * rand () / RAND_MAX) - 1.0f);
+
+    const int K = 1 + rand () % 20;
+    const double radius = 0.1 + 1.5 * rand () / RAND_MAX;
+
+    OctreePointCloudSearch<PointXYZ> octree (0.1 + 0.5 * rand () / RAND_MAX);
+    octree.setNumberOfThreads (2);
+    octree.setInputCloud (cloudIn);
+    octree.addPointsFromInputCloud ();
+
+    std::vector<std::vector<int> > k_indices, r_indices;
+    std::vector<std::vector<float> > k_sqr_distances, r_sqr_distances;
+    octree.nearestKSearch (queries, std::vector<int> (), K, k_indices, k_sqr_distances);
+    octree.radiusSearch (queries, std::vector<int> (), radius, r_indices, r_sqr_distances);
+
+    ASSERT_EQ (queries.size (), k_indices.size ());
+    ASSERT_EQ (queries.size (), r_indices.size ());
+
+    for (size_t i = 0; i < queries.size (); i++)
+    {
+      const PointXYZ& query = queries.points[i];
+
+      // brute force reference, sorted by distance
+      std::vector<std::pair<float, int> > reference;
+      for (size_t j = 0; j < cloudIn->points.size (); j++)
+      {
+        const PointXYZ& point = cloudIn->points[j];
+        const float dx = point.x - query.x;
+        const float dy = point.y - query.y;
+        const float dz = point.z - query.z;
+        reference.push_back (std::make_pair (dx * dx + dy * dy + dz * dz, static_cast<int> (j)));
+      }
+      std::sort (reference.begin (), reference.end ());
+
+      // k nearest neighbors come sorted by distance
+      ASSERT_EQ (static_cast<size_t> (K), k_indices[i].size ());
+      for (int k = 0; k < K; k++)
+      {
+        const PointXYZ& neighbor = cloudIn->points[k_indices[i][k]];
+        const float dx = neighbor.x - query.x;
+        const float dy = neighbor.y - query.y;
+        const float dz = neighbor.z - query.z;
+        EXPECT_NEAR (reference[k].first, k_sqr_distances[i][k], 1e-5);
+        EXPECT_NEAR (dx * dx + dy * dy + dz * dz, k_sqr_distances[i][k], 1e-5);
+      }
+
+      // radius neighbors in any order
+      std::vector<int> expected_indices;
+      for (const auto &candidate : reference)
+        if (candidate.first <= radius * radius)
+          expected_indices.push_back (candidate.second);
+      std::vector<int> found_indices (r_indices[i]);
+      std::sort (expected_indices.begin (), expected_indices.end ());
+      std::sort (found_indices.begin (), found_indices.end ());
+      EXPECT_EQ (expected_indices, found_indices);
+
+      // single queries give the same results
+      std::vector<int> indices;
+      std::vector<float> sqr_distances;
+      octree.nearestKSearch (query, K, indices, sqr_distances);
+      EXPECT_EQ (k_indices[i], indices);
+      octree.radiusSearch (query, radius, indices, sqr_distances);
+      EXPECT_EQ (r_indices[i], indices);
+    }
+  }
+}
+
 TEST (PCL, Octree_Pointcloud_Box_Search)
 {
   constexpr unsigned int test_runs = 30;
@@ -44,10 +44,16 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include <cstdio>
 #include <iostream>
+#include <limits>
 #include <random>
+#include <thread>
+#include <tuple>
 using namespace std;
 
 #include <pcl/common/time.h>
@@ -58,6 +64,8 @@ using namespace std;
 
 #include <pcl/outofcore/outofcore.h>
 #include <pcl/outofcore/outofcore_impl.h>
+#include <pcl/outofcore/outofcore_search.h>
+#include <pcl/search/brute_force.h>
 
 #include <pcl/PCLPointCloud2.h>
 
@@ -767,6 +775,123 @@ TEST_F (OutofcoreTest, PointCloud2_Insertion)
   EXPECT_EQ (octreeB.addPointCloud (input_cloud, false), points_in_input_cloud) << "Insertion failure. Number of points successfully added does not match size of input cloud\n";
 }
 
+TEST_F (OutofcoreTest, PointCloud2_ParallelInsertion)
+{
+  cleanUpFilesystem ();
+
+  const Eigen::Vector3d min (-11, -11, -11);
+  const Eigen::Vector3d max (11, 11, 11);
+  const boost::uint64_t depth = 3;
+
+  std::mt19937 rng (rngseed);
+  std::uniform_real_distribution<float> dist (-10.f, 10.f);
+
+  pcl::PointCloud<pcl::PointXYZ> point_cloud;
+  for (size_t i = 0; i < numPts; i++)
+    point_cloud.points.emplace_back (dist (rng), dist (rng), dist (rng));
+  point_cloud.points[7].x = std::numeric_limits<float>::quiet_NaN ();
+  point_cloud.width = static_cast<uint32_t> (point_cloud.points.size ());
+  point_cloud.height = 1;
+
+  pcl::PCLPointCloud2::Ptr input_cloud (new pcl::PCLPointCloud2 ());
+  pcl::toPCLPointCloud2<pcl::PointXYZ> (point_cloud, *input_cloud);
+
+  octree_disk octreeA (depth, min, max, filename_otreeA, "ECEF");
+  octree_disk octreeB (depth, min, max, filename_otreeB, "ECEF");
+
+  // The parallel build drops the non-finite point, like the serial one
+  EXPECT_EQ (numPts - 1, octreeA.addPointCloud (input_cloud, false));
+  EXPECT_EQ (numPts - 1, octreeB.addPointCloud_parallel (input_cloud, 3));
+  EXPECT_EQ (numPts - 1, octreeB.getNumPointsAtDepth (depth));
+
+  // Both trees occupy the same leaves...
+  AlignedPointTVector voxels_a, voxels_b;
+  octreeA.getOccupiedVoxelCenters (voxels_a);
+  octreeB.getOccupiedVoxelCenters (voxels_b);
+  ASSERT_EQ (voxels_a.size (), voxels_b.size ());
+  for (size_t i = 0; i < voxels_a.size (); i++)
+    EXPECT_TRUE (compPt (voxels_a[i], voxels_b[i]));
+
+  // ...and store the same points
+  auto lessPt = [] (const PointT &p1, const PointT &p2) { return (std::tie (p1.x, p1.y, p1.z) < std::tie (p2.x, p2.y, p2.z)); };
+  AlignedPointTVector points_a, points_b;
+  octreeA.queryBBIncludes (min, max, depth, points_a);
+  octreeB.queryBBIncludes (min, max, depth, points_b);
+  ASSERT_EQ (numPts - 1, points_a.size ());
+  ASSERT_EQ (numPts - 1, points_b.size ());
+  std::sort (points_a.begin (), points_a.end (), lessPt);
+  std::sort (points_b.begin (), points_b.end (), lessPt);
+  for (size_t i = 0; i < points_a.size (); i++)
+    EXPECT_TRUE (compPt (points_a[i], points_b[i]));
+
+  // Every LOD holds a subsample of the leaf points, shrinking towards the root
+  octreeB.buildLOD_parallel (3);
+  boost::uint64_t previous_lod_points = numPts;
+  for (boost::uint64_t d = depth; d-- > 0;)
+  {
+    const boost::uint64_t lod_points = octreeB.getNumPointsAtDepth (d);
+    EXPECT_GT (lod_points, 0);
+    EXPECT_LT (lod_points, previous_lod_points);
+    previous_lod_points = lod_points;
+
+    AlignedPointTVector lod;
+    octreeB.queryBBIncludes (min, max, d, lod);
+    ASSERT_EQ (lod_points, lod.size ());
+    for (const PointT &p : lod)
+      EXPECT_TRUE (std::binary_search (points_b.begin (), points_b.end (), p, lessPt));
+  }
+
+  cleanUpFilesystem ();
+}
+
+TEST_F (OutofcoreTest, PointCloud2_ParallelInsertionOutsideBoundingBox)
+{
+  cleanUpFilesystem ();
+
+  const Eigen::Vector3d min (-11, -11, -11);
+  const Eigen::Vector3d max (11, 11, 11);
+  const boost::uint64_t depth = 3;
+
+  std::mt19937 rng (rngseed);
+  std::uniform_real_distribution<float> dist (-10.f, 10.f);
+
+  pcl::PointCloud<pcl::PointXYZ> point_cloud;
+  for (size_t i = 0; i < numPts; i++)
+    point_cloud.points.emplace_back (dist (rng), dist (rng), dist (rng));
+
+  // Points far outside of the root bounding box, on every side
+  const size_t nr_outside = 6;
+  point_cloud.points[3] = pcl::PointXYZ (100.f, 0.f, 0.f);
+  point_cloud.points[11] = pcl::PointXYZ (-100.f, 0.f, 0.f);
+  point_cloud.points[17] = pcl::PointXYZ (0.f, 100.f, 0.f);
+  point_cloud.points[29] = pcl::PointXYZ (0.f, -100.f, 0.f);
+  point_cloud.points[31] = pcl::PointXYZ (0.f, 0.f, 100.f);
+  point_cloud.points[37] = pcl::PointXYZ (5.f, 5.f, -100.f);
+  point_cloud.width = static_cast<uint32_t> (point_cloud.points.size ());
+  point_cloud.height = 1;
+
+  pcl::PCLPointCloud2::Ptr input_cloud (new pcl::PCLPointCloud2 ());
+  pcl::toPCLPointCloud2<pcl::PointXYZ> (point_cloud, *input_cloud);
+
+  octree_disk octreeA (depth, min, max, filename_otreeA, "ECEF");
+  octree_disk octreeB (depth, min, max, filename_otreeB, "ECEF");
+
+  // Both insertions drop the points outside of the tree
+  const boost::uint64_t serial_added = octreeA.addPointCloud (input_cloud, false);
+  const boost::uint64_t parallel_added = octreeB.addPointCloud_parallel (input_cloud, 3);
+  EXPECT_EQ (numPts - nr_outside, serial_added);
+  EXPECT_EQ (serial_added, parallel_added);
+  EXPECT_EQ (octreeA.getNumPointsAtDepth (depth), octreeB.getNumPointsAtDepth (depth));
+
+  AlignedPointTVector points_a, points_b;
+  octreeA.queryBBIncludes (min, max, depth, points_a);
+  octreeB.queryBBIncludes (min, max, depth, points_b);
+  EXPECT_EQ (serial_added, points_a.size ());
+  EXPECT_EQ (parallel_added, points_b.size ());
+
+  cleanUpFilesystem ();
+}
+
 TEST_F (OutofcoreTest, PointCloud2_MultiplePointCloud)
 {
 
@@ -943,6 +1068,257 @@ TEST_F (OutofcoreTest, PointCloud2_Query)
   cleanUpFilesystem ();
 }
 
+TEST_F (OutofcoreTest, DiskContainer_BlockReads)
+{
+  cleanUpFilesystem ();
+
+  const boost::filesystem::path container_dir = outofcore_path.parent_path ();
+  boost::filesystem::create_directory (container_dir);
+
+  AlignedPointTVector some_points;
+  for (unsigned int i = 0; i < 1000; i++)
+    some_points.push_back (PointT (static_cast<float> (i), static_cast<float> (i % 7), static_cast<float> (i % 13)));
+
+  boost::filesystem::path container_file;
+  {
+    OutofcoreOctreeDiskContainer<PointT> container (container_dir);
+    container.insertRange (some_points.data (), some_points.size () / 2);
+    container.insertRange (some_points.data () + some_points.size () / 2, some_points.size () / 2);
+    ASSERT_EQ (some_points.size (), container.size ());
+    container_file = container.path ();
+  }
+
+  // Reload the container from its PCD file
+  OutofcoreOctreeDiskContainer<PointT> container (container_file);
+  ASSERT_EQ (some_points.size (), container.size ());
+
+  // Range reads honor start and count and append to the destination
+  AlignedPointTVector range;
+  container.readRange (100, 250, range);
+  container.readRange (990, 10, range);
+  ASSERT_EQ (260u, range.size ());
+  for (size_t i = 0; i < 250; i++)
+    EXPECT_TRUE (compPt (some_points[100 + i], range[i]));
+  for (size_t i = 0; i < 10; i++)
+    EXPECT_TRUE (compPt (some_points[990 + i], range[250 + i]));
+
+  // Uniform subsampling draws percent * count points from the range, in file order
+  AlignedPointTVector sample;
+  container.readRangeSubSample (0, container.size (), 0.25, sample);
+  ASSERT_EQ (250u, sample.size ());
+  for (size_t i = 0; i < sample.size (); i++)
+  {
+    EXPECT_TRUE (compPt (some_points[static_cast<size_t> (sample[i].x)], sample[i]));
+    if (i > 0)
+    {
+      EXPECT_LE (sample[i-1].x, sample[i].x);
+    }
+  }
+
+  // Bernoulli subsampling selects unique points, in file order
+  container.readRangeSubSample_bernoulli (0, container.size (), 0.5, sample);
+  EXPECT_GT (sample.size (), 0);
+  EXPECT_LT (sample.size (), some_points.size ());
+  for (size_t i = 1; i < sample.size (); i++)
+    EXPECT_LT (sample[i-1].x, sample[i].x);
+
+  cleanUpFilesystem ();
+}
+
+TEST_F (OutofcoreTest, NodeCache_ConcurrentQueries)
+{
+  cleanUpFilesystem ();
+
+  // Concurrent misses on one node share a single read
+  OutofcoreNodeCache<PointT> cache (1 << 20, 4);
+  std::atomic<int> loads (0);
+  auto load = [&loads] ()
+  {
+    loads++;
+    std::this_thread::sleep_for (std::chrono::milliseconds (50));
+    return (AlignedPointTVector (100, PointT (1, 2, 3)));
+  };
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; i++)
+    readers.emplace_back ([&cache, &load] () { EXPECT_EQ (100, cache.get ("node", 1, 100, load)->size ()); });
+  for (auto &reader : readers)
+    reader.join ();
+  EXPECT_EQ (1, loads);
+  EXPECT_EQ (1, cache.getStats ().misses);
+  EXPECT_EQ (3, cache.getStats ().hits);
+
+  // A node whose point count changed is read again
+  EXPECT_TRUE (cache.contains ("node", 1, 100));
+  EXPECT_FALSE (cache.contains ("node", 1, 101));
+  cache.get ("node", 1, 101, load);
+  EXPECT_EQ (2, loads);
+
+  // The byte budget is split over the shards and enforced by eviction
+  cache.setBudget (4 * (200 * sizeof (PointT)));
+  for (int i = 0; i < 64; i++)
+    cache.get ("node" + std::to_string (i), 2, 100, [] () { return (AlignedPointTVector (100)); });
+  EXPECT_LE (cache.getStats ().bytes, cache.getBudget ());
+  EXPECT_GT (cache.getStats ().evictions, 0);
+
+  // Queries served from the cache return what the disk returns
+  const Eigen::Vector3d min (-11, -11, -11);
+  const Eigen::Vector3d max (11, 11, 11);
+  const boost::uint64_t depth = 2;
+
+  std::mt19937 rng (rngseed);
+  std::uniform_real_distribution<float> dist (-10.f, 10.f);
+  AlignedPointTVector some_points;
+  for (size_t i = 0; i < numPts; i++)
+    some_points.emplace_back (dist (rng), dist (rng), dist (rng));
+
+  octree_disk octreeA (depth, min, max, filename_otreeA, "ECEF");
+  octreeA.addDataToLeaf (some_points);
+
+  const Eigen::Vector3d qmin (-10, -3, -10);
+  const Eigen::Vector3d qmax (4, 10, 2);
+  auto lessPt = [] (const PointT &p1, const PointT &p2) { return (std::tie (p1.x, p1.y, p1.z) < std::tie (p2.x, p2.y, p2.z)); };
+
+  octreeA.setNodeCacheBudget (0);
+  AlignedPointTVector expected;
+  octreeA.queryBBIncludes (qmin, qmax, depth, expected);
+  std::sort (expected.begin (), expected.end (), lessPt);
+  ASSERT_GT (expected.size (), 0);
+  ASSERT_LT (expected.size (), some_points.size ());
+
+  octreeA.setNodeCacheBudget (OutofcoreNodeCache<PointT>::default_budget_);
+  octreeA.getNodeCache ().resetStats ();
+  AlignedPointTVector result;
+  octreeA.queryBBIncludes (qmin, qmax, depth, result);
+  const boost::uint64_t nodes_read = octreeA.getNodeCache ().getStats ().misses;
+  EXPECT_GT (nodes_read, 0);
+  EXPECT_EQ (0, octreeA.getNodeCache ().getStats ().hits);
+
+  std::vector<std::thread> queries;
+  for (int i = 0; i < 4; i++)
+  {
+    queries.emplace_back ([&] ()
+    {
+      AlignedPointTVector points;
+      octreeA.queryBBIncludes (qmin, qmax, depth, points);
+      std::sort (points.begin (), points.end (), lessPt);
+      ASSERT_EQ (expected.size (), points.size ());
+      for (size_t j = 0; j < points.size (); j++)
+        EXPECT_TRUE (compPt (expected[j], points[j]));
+
+      AlignedPointTVector sample;
+      octreeA.queryBBIncludes_subsample (qmin, qmax, depth, 0.5, sample);
+      EXPECT_LE (sample.size (), expected.size ());
+    });
+  }
+  for (auto &query : queries)
+    query.join ();
+  EXPECT_EQ (nodes_read, octreeA.getNodeCache ().getStats ().misses);
+  EXPECT_EQ (8 * nodes_read, octreeA.getNodeCache ().getStats ().hits);
+
+  // Writes invalidate the cache; prefetched nodes are picked up by the next query
+  octreeA.addDataToLeaf (some_points);
+  EXPECT_EQ (0, octreeA.getNodeCache ().getStats ().entries);
+  octreeA.prefetchBBIncludes (qmin, qmax, depth);
+  result.clear ();
+  octreeA.queryBBIncludes (qmin, qmax, depth, result);
+  EXPECT_EQ (2 * expected.size (), result.size ());
+  EXPECT_EQ (2 * nodes_read, octreeA.getNodeCache ().getStats ().misses);
+
+  cleanUpFilesystem ();
+}
+
+TEST_F (OutofcoreTest, NeighborSearch)
+{
+  cleanUpFilesystem ();
+
+  const Eigen::Vector3d min (-11, -11, -11);
+  const Eigen::Vector3d max (11, 11, 11);
+  const boost::uint64_t depth = 3;
+
+  std::mt19937 rng (rngseed);
+  std::uniform_real_distribution<float> dist (-10.f, 10.f);
+  AlignedPointTVector some_points;
+  for (size_t i = 0; i < numPts; i++)
+    some_points.emplace_back (dist (rng), dist (rng), dist (rng));
+
+  octree_disk::Ptr octreeA (new octree_disk (depth, min, max, filename_otreeA, "ECEF"));
+  octreeA->addDataToLeaf (some_points);
+
+  // The adapter numbers the points in the order a query over the whole tree returns them
+  OutofcoreSearch<PointT> search (octreeA, depth);
+  pcl::PointCloud<PointT>::Ptr surface (new pcl::PointCloud<PointT>);
+  octreeA->queryBBIncludes (min, max, depth, surface->points);
+  surface->width = static_cast<uint32_t> (surface->points.size ());
+  surface->height = 1;
+  ASSERT_EQ (numPts, search.size ());
+  ASSERT_EQ (numPts, surface->size ());
+
+  pcl::search::BruteForce<PointT> brute_force (true);
+  brute_force.setInputCloud (surface);
+
+  std::vector<int> indices, expected_indices;
+  std::vector<float> sqr_distances, expected_sqr_distances;
+  for (int i = 0; i < 50; i++)
+  {
+    const PointT query (dist (rng), dist (rng), dist (rng));
+
+    search.nearestKSearch (query, 8, indices, sqr_distances);
+    brute_force.nearestKSearch (query, 8, expected_indices, expected_sqr_distances);
+    ASSERT_EQ (expected_indices.size (), indices.size ());
+    for (size_t j = 0; j < indices.size (); j++)
+    {
+      EXPECT_EQ (expected_indices[j], indices[j]);
+      EXPECT_NEAR (expected_sqr_distances[j], sqr_distances[j], 1e-4);
+    }
+
+    search.radiusSearch (query, 1.5, indices, sqr_distances);
+    brute_force.radiusSearch (query, 1.5, expected_indices, expected_sqr_distances);
+    std::sort (indices.begin (), indices.end ());
+    std::sort (expected_indices.begin (), expected_indices.end ());
+    EXPECT_EQ (expected_indices, indices);
+
+    // max_nn keeps the closest neighbors
+    if (expected_indices.size () > 3)
+    {
+      EXPECT_EQ (3, search.radiusSearch (query, 1.5, indices, sqr_distances, 3));
+      for (size_t j = 1; j < sqr_distances.size (); j++)
+        EXPECT_LE (sqr_distances[j-1], sqr_distances[j]);
+    }
+  }
+
+  // The tree level search returns the same points
+  const PointT query (0.5f, -0.5f, 2.f);
+  AlignedPointTVector k_points;
+  octreeA->nearestKSearch (query, 4, depth, k_points, sqr_distances);
+  search.nearestKSearch (query, 4, indices, expected_sqr_distances);
+  ASSERT_EQ (4, k_points.size ());
+  pcl::PointCloud<PointT> neighbors;
+  search.getPoints (indices, neighbors);
+  ASSERT_EQ (4, neighbors.size ());
+  for (size_t j = 0; j < 4; j++)
+  {
+    EXPECT_TRUE (compPt (k_points[j], neighbors[j]));
+    EXPECT_TRUE (compPt (surface->points[indices[j]], neighbors[j]));
+  }
+
+  // Index based searches take their query point from the input cloud
+  search.setInputCloud (surface);
+  search.nearestKSearch (*surface, 5, 1, indices, sqr_distances);
+  ASSERT_EQ (1, indices.size ());
+  EXPECT_EQ (5, indices[0]);
+  EXPECT_EQ (0.0f, sqr_distances[0]);
+
+  // Repeated searches run from the cached node indices
+  const boost::uint64_t built = octreeA->getSearchIndexCache ().getStats ().misses;
+  EXPECT_GT (built, 0);
+  EXPECT_LE (built, 512);
+  search.nearestKSearch (query, 4, indices, sqr_distances);
+  EXPECT_EQ (built, octreeA->getSearchIndexCache ().getStats ().misses);
+
+  cleanUpFilesystem ();
+}
+
 /* [--- */
 int
 main (int argc, char** argv)
@@ -40,6 +40,7 @@
 #include <pcl/point_types.h>
 #include <pcl/io/pcd_io.h>
 #include <pcl/registration/ia_fpcs.h>
+#include <pcl/registration/target_cache.h>
 
 #include "test_fpcs_ia_data.h"
 
@@ -88,6 +89,49 @@ TEST (PCL, FPCSInitialAlignment)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, FPCSInitialAlignmentTargetCache)
+{
+  PointCloud<PointXYZ>::Ptr cloud_source_ptr = cloud_source.makeShared ();
+  PointCloud<PointXYZ>::Ptr cloud_target_ptr = cloud_target.makeShared ();
+
+  // Search a subset of the target with one instance and the whole target with another
+  IndicesPtr target_indices (new std::vector<int>);
+  for (int i = 0; i < static_cast<int> (cloud_target.size ()); i += 2)
+    target_indices->push_back (i);
+
+  TargetCache<PointXYZ>::Ptr cache (new TargetCache<PointXYZ>);
+  FPCSInitialAlignment <PointXYZ, PointXYZ> fpcs_subset, fpcs_full;
+  for (FPCSInitialAlignment <PointXYZ, PointXYZ> *fpcs_ia : {&fpcs_subset, &fpcs_full})
+  {
+    fpcs_ia->setTargetCache (cache);
+    fpcs_ia->setInputSource (cloud_source_ptr);
+    fpcs_ia->setInputTarget (cloud_target_ptr);
+    fpcs_ia->setNumberOfThreads (nr_threads);
+    fpcs_ia->setApproxOverlap (approx_overlap);
+    fpcs_ia->setDelta (delta, true);
+    fpcs_ia->setNumberOfSamples (nr_samples);
+    fpcs_ia->setMaximumIterations (10);
+  }
+  fpcs_subset.setTargetIndices (target_indices);
+
+  PointCloud <PointXYZ> source_aligned;
+  fpcs_subset.align (source_aligned);
+  fpcs_full.align (source_aligned);
+
+  // The shared tree still covers the whole target, the subset is searched in a tree of its own
+  search::KdTree<PointXYZ>::Ptr shared_tree = cache->get (cloud_target_ptr)->getSearchMethod ();
+  EXPECT_TRUE (shared_tree->getIndices () == nullptr);
+  EXPECT_EQ (fpcs_full.getSearchMethodTarget (), shared_tree);
+  EXPECT_NE (fpcs_subset.getSearchMethodTarget (), shared_tree);
+  EXPECT_EQ (fpcs_subset.getSearchMethodTarget ()->getIndices (), target_indices);
+
+  // Aligning again keeps the private tree of the subset
+  fpcs_subset.align (source_aligned);
+  EXPECT_NE (fpcs_subset.getSearchMethodTarget (), shared_tree);
+  EXPECT_TRUE (shared_tree->getIndices () == nullptr);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 int
 main (int argc, char** argv)
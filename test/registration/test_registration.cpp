@@ -45,6 +45,8 @@
 #include <pcl/registration/registration.h>
 #include <pcl/registration/icp.h>
 #include <pcl/registration/joint_icp.h>
+#include <pcl/registration/multi_resolution_registration.h>
+#include <pcl/registration/target_cache.h>
 #include <pcl/registration/icp_nl.h>
 #include <pcl/registration/gicp.h>
 #include <pcl/registration/gicp6d.h>
@@ -206,6 +208,114 @@ sampleRandomTransform (Eigen::Affine3f &trans, float max_angle, float max_trans)
     trans = Eigen::Translation3f(translation) * rotation;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, MultiResolutionRegistration)
+{
+  IterativeClosestPoint<PointXYZ, PointXYZ>::Ptr icp (new IterativeClosestPoint<PointXYZ, PointXYZ>);
+
+  registration::MultiResolutionRegistration<PointXYZ, PointXYZ> reg;
+  reg.setRegistration (icp);
+  reg.addLevel (0.02f, 0.1, 20, 1e-8);
+  reg.addLevel (0.01f, 0.05, 20, 1e-8);
+  reg.addLevel (0.0f, 0.05, 50, 1e-8);
+  ASSERT_EQ (reg.getLevels ().size (), 3u);
+
+  PointCloud<PointXYZ>::ConstPtr source (cloud_source.makeShared ());
+  reg.setInputSource (source);
+  reg.setInputTarget (cloud_target.makeShared ());
+
+  // Register
+  EXPECT_TRUE (reg.align (cloud_reg));
+  EXPECT_TRUE (reg.hasConverged ());
+  EXPECT_EQ (int (cloud_reg.points.size ()), int (cloud_source.points.size ()));
+
+  // Levels go from coarse to fine, the last one uses the full resolution clouds
+  ASSERT_EQ (reg.getLevelResults ().size (), 3u);
+  EXPECT_LT (reg.getLevelResults ()[0].source_size, reg.getLevelResults ()[1].source_size);
+  EXPECT_LT (reg.getLevelResults ()[1].target_size, reg.getLevelResults ()[2].target_size);
+  EXPECT_EQ (reg.getLevelResults ()[2].source_size, cloud_source.points.size ());
+  EXPECT_EQ (reg.getSourceLevel (2), source);
+
+  // The multi resolution result must agree with plain ICP at full resolution
+  IterativeClosestPoint<PointXYZ, PointXYZ> single;
+  single.setInputSource (source);
+  single.setInputTarget (cloud_target.makeShared ());
+  single.setMaximumIterations (50);
+  single.setTransformationEpsilon (1e-8);
+  single.setMaxCorrespondenceDistance (0.05);
+  PointCloud<PointXYZ> cloud_single;
+  single.align (cloud_single);
+  EXPECT_LT ((reg.getFinalTransformation ().block<3, 1> (0, 3) - single.getFinalTransformation ().block<3, 1> (0, 3)).norm (), 1e-2);
+
+  // Aligning again with the same target reuses the cached pyramid
+  PointCloud<PointXYZ>::ConstPtr target_level = reg.getTargetLevel (0);
+  reg.setInputSource (source);
+  reg.align (cloud_reg);
+  EXPECT_EQ (target_level, reg.getTargetLevel (0));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, TargetCache)
+{
+  PointCloud<PointXYZ>::ConstPtr source (cloud_source.makeShared ());
+  PointCloud<PointXYZ>::ConstPtr target (cloud_target.makeShared ());
+
+  registration::TargetCache<PointXYZ>::Ptr cache (new registration::TargetCache<PointXYZ> (2));
+
+  // Two registration instances sharing the target search tree
+  IterativeClosestPoint<PointXYZ, PointXYZ> reg_a, reg_b, reg_plain;
+  reg_a.setTargetCache (cache);
+  reg_b.setTargetCache (cache);
+  for (IterativeClosestPoint<PointXYZ, PointXYZ> *reg : {&reg_a, &reg_b, &reg_plain})
+  {
+    reg->setInputSource (source);
+    reg->setInputTarget (target);
+    reg->setMaximumIterations (50);
+    reg->setTransformationEpsilon (1e-8);
+    reg->setMaxCorrespondenceDistance (0.05);
+  }
+
+  PointCloud<PointXYZ> cloud_a, cloud_b, cloud_plain;
+  reg_a.align (cloud_a);
+  reg_b.align (cloud_b);
+  reg_plain.align (cloud_plain);
+
+  EXPECT_EQ (cache->size (), 1u);
+  EXPECT_EQ (cache->getMisses (), 1u);
+  EXPECT_EQ (cache->getHits (), 1u);
+  EXPECT_EQ (reg_a.getSearchMethodTarget (), reg_b.getSearchMethodTarget ());
+  EXPECT_TRUE (cache->contains (target));
+  EXPECT_FALSE (cache->contains (target, 1));
+
+  // Sharing the tree must not change the result
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 4; ++j)
+    {
+      EXPECT_FLOAT_EQ (reg_a.getFinalTransformation () (i, j), reg_plain.getFinalTransformation () (i, j));
+      EXPECT_FLOAT_EQ (reg_b.getFinalTransformation () (i, j), reg_plain.getFinalTransformation () (i, j));
+    }
+
+  // A new version of the same cloud gets a new entry
+  reg_a.setTargetVersion (1);
+  reg_a.align (cloud_a);
+  EXPECT_EQ (cache->size (), 2u);
+  EXPECT_NE (reg_a.getSearchMethodTarget (), reg_b.getSearchMethodTarget ());
+
+  // Normals are computed once per neighborhood size
+  registration::TargetCache<PointXYZ>::EntryPtr entry = cache->get (target, 1);
+  PointCloud<Normal>::ConstPtr normals = entry->getNormals (10);
+  ASSERT_TRUE (normals != nullptr);
+  EXPECT_EQ (normals->size (), target->size ());
+  EXPECT_EQ (normals, entry->getNormals (10));
+
+  // Least recently used entries are evicted
+  cache->setMaxEntries (1);
+  EXPECT_EQ (cache->size (), 1u);
+  EXPECT_TRUE (cache->contains (target, 1));
+  cache->erase (target);
+  EXPECT_EQ (cache->size (), 0u);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, IterativeClosestPointWithRejectors)
 {
@@ -533,6 +643,44 @@ TEST (PCL, GeneralizedIterativeClosestPoint)
   EXPECT_LT (reg.getFitnessScore (), 0.0001);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, GeneralizedIterativeClosestPointTargetVersion)
+{
+  using PointT = PointXYZ;
+  PointCloud<PointT>::Ptr src (new PointCloud<PointT>);
+  copyPointCloud (cloud_source, *src);
+  PointCloud<PointT>::Ptr tgt (new PointCloud<PointT>);
+  copyPointCloud (cloud_target, *tgt);
+  PointCloud<PointT> output;
+
+  registration::TargetCache<PointT>::Ptr cache (new registration::TargetCache<PointT>);
+  GeneralizedIterativeClosestPoint<PointT, PointT> reg;
+  reg.setTargetCache (cache);
+  reg.setInputSource (src);
+  reg.setInputTarget (tgt);
+  reg.setMaximumIterations (50);
+  reg.setTransformationEpsilon (1e-8);
+  reg.align (output);
+
+  // Rotate the target in place, which changes its covariances, and signal it through the version
+  Eigen::Affine3f rotation (Eigen::AngleAxisf (0.1f, Eigen::Vector3f::UnitZ ()));
+  pcl::transformPointCloud (*tgt, *tgt, rotation);
+  reg.setTargetVersion (1);
+  reg.align (output);
+
+  // The result must match an instance that only ever saw the modified target
+  GeneralizedIterativeClosestPoint<PointT, PointT> reg_fresh;
+  reg_fresh.setInputSource (src);
+  reg_fresh.setInputTarget (tgt);
+  reg_fresh.setMaximumIterations (50);
+  reg_fresh.setTransformationEpsilon (1e-8);
+  reg_fresh.align (output);
+
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 4; ++j)
+      EXPECT_FLOAT_EQ (reg.getFinalTransformation () (i, j), reg_fresh.getFinalTransformation () (i, j));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, GeneralizedIterativeClosestPoint6D)
 {
@@ -672,6 +820,60 @@ TEST (PCL, PyramidFeatureHistogram)
   EXPECT_NEAR (similarity_value3, 0.87623238563537598, 1e-3);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PPFHashMapSearch)
+{
+  // 6 x 6 model pairs spread over a handful of bins
+  const size_t n = 6;
+  const float angle_step = 0.5f, distance_step = 0.1f;
+  PointCloud<PPFSignature>::Ptr features (new PointCloud<PPFSignature> ());
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < n; ++j)
+    {
+      PPFSignature f;
+      f.f1 = angle_step * static_cast<float> ((i + j) % 3) + 0.1f;
+      f.f2 = -angle_step * static_cast<float> (i % 2) + 0.1f;
+      f.f3 = angle_step * static_cast<float> (j % 2) + 0.1f;
+      f.f4 = distance_step * static_cast<float> (i * j % 4) + 0.01f;
+      f.alpha_m = static_cast<float> (i * n + j);
+      features->push_back (f);
+    }
+
+  PPFHashMapSearch search (angle_step, distance_step);
+  search.setNumberOfThreads (2);
+  search.setInputFeatureCloud (features);
+  EXPECT_NEAR (search.getModelDiameter (), distance_step * 3.0f + 0.01f, 1e-6);
+  ASSERT_EQ (search.alpha_m_.size (), n);
+  EXPECT_EQ (search.alpha_m_[2][3], static_cast<float> (2 * n + 3));
+
+  // Every pair must be found in its own bin, together with exactly the pairs sharing that bin
+  for (size_t idx = 0; idx < features->size (); ++idx)
+  {
+    PPFSignature q = features->points[idx];
+    std::vector<std::pair<size_t, size_t> > found;
+    search.nearestNeighborSearch (q.f1, q.f2, q.f3, q.f4, found);
+
+    std::vector<std::pair<size_t, size_t> > expected;
+    for (size_t other = 0; other < features->size (); ++other)
+    {
+      const PPFSignature &f = features->points[other];
+      if (std::floor (f.f1 / angle_step) == std::floor (q.f1 / angle_step) &&
+          std::floor (f.f2 / angle_step) == std::floor (q.f2 / angle_step) &&
+          std::floor (f.f3 / angle_step) == std::floor (q.f3 / angle_step) &&
+          std::floor (f.f4 / distance_step) == std::floor (q.f4 / distance_step))
+        expected.emplace_back (other / n, other % n);
+    }
+    EXPECT_EQ (found, expected);
+
+    PPFHashMapSearch::IndexPairRange range = search.nearestNeighborRange (q.f1, q.f2, q.f3, q.f4);
+    EXPECT_EQ (static_cast<size_t> (range.second - range.first), expected.size ());
+  }
+
+  // Features outside the model bins give an empty range
+  PPFHashMapSearch::IndexPairRange range = search.nearestNeighborRange (10.0f, 10.0f, 10.0f, 10.0f);
+  EXPECT_EQ (range.first, range.second);
+}
+
 // Suat G: disabled, since the transformation does not look correct.
 // ToDo: update transformation from the ground truth.
 #if 0
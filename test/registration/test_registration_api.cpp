@@ -709,6 +709,77 @@ TEST (PCL, TransformationEstimationSymmetricPointToPlaneLLS)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, TransformationEstimationPointToPlaneLLSRobust)
+{
+  // Create a test cloud
+  pcl::PointCloud<pcl::PointNormal>::Ptr src (new pcl::PointCloud<pcl::PointNormal>);
+  src->height = 1;
+  src->is_dense = true;
+  for (float x = -5.0f; x <= 5.0f; x += 0.25f)
+    for (float y = -5.0f; y <= 5.0f; y += 0.25f)
+    {
+      pcl::PointNormal p;
+      p.x = x;
+      p.y = y;
+      p.z = 0.1f * powf (x, 2.0f) + 0.2f * p.x * p.y - 0.3f * y + 1.0f;
+      Eigen::Vector3f n (-0.2f * p.x - 0.2f, 0.6f * p.y - 0.2f, 1.0f);
+      p.getNormalVector3fMap () = n.normalized ();
+      src->points.push_back (p);
+    }
+  src->width = static_cast<uint32_t> (src->points.size ());
+
+  Eigen::Matrix4f ground_truth_tform = Eigen::Matrix4f::Identity ();
+  ground_truth_tform.row (0) <<  0.9938f,  0.0988f,  0.0517f,  0.1000f;
+  ground_truth_tform.row (1) << -0.0997f,  0.9949f,  0.0149f, -0.2000f;
+  ground_truth_tform.row (2) << -0.0500f, -0.0200f,  0.9986f,  0.3000f;
+  ground_truth_tform.row (3) <<  0.0000f,  0.0000f,  0.0000f,  1.0000f;
+
+  pcl::PointCloud<pcl::PointNormal>::Ptr tgt (new pcl::PointCloud<pcl::PointNormal>);
+  pcl::transformPointCloudWithNormals (*src, *tgt, ground_truth_tform);
+
+  // Move every tenth target point far away along its normal
+  for (size_t i = 0; i < tgt->points.size (); i += 10)
+    tgt->points[i].getVector3fMap () += 5.0f * tgt->points[i].getNormalVector3fMap ();
+
+  // Multi-threaded accumulation must match the single-threaded one
+  pcl::registration::TransformationEstimationPointToPlaneLLS<pcl::PointNormal, pcl::PointNormal> single, multi;
+  EXPECT_EQ (1u, single.getNumberOfThreads ());
+  multi.setNumberOfThreads (4);
+  Eigen::Matrix4f single_transform, multi_transform;
+  single.estimateRigidTransformation (*src, *tgt, single_transform);
+  multi.estimateRigidTransformation (*src, *tgt, multi_transform);
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 4; ++j)
+      EXPECT_NEAR (single_transform (i, j), multi_transform (i, j), 1e-5);
+
+  // A few IRLS iterations with a Tukey kernel discard the outliers entirely
+  pcl::registration::TransformationEstimationPointToPlaneLLS<pcl::PointNormal, pcl::PointNormal> point_to_plane;
+  pcl::registration::TransformationEstimationSymmetricPointToPlaneLLS<pcl::PointNormal, pcl::PointNormal> symmetric;
+  point_to_plane.setRobustKernel (pcl::registration::ROBUST_KERNEL_TUKEY, 1.0);
+  symmetric.setRobustKernel (pcl::registration::ROBUST_KERNEL_TUKEY, 1.0);
+  point_to_plane.setNumberOfThreads (2);
+  symmetric.setNumberOfThreads (2);
+
+  pcl::registration::TransformationEstimation<pcl::PointNormal, pcl::PointNormal>* estimators[] = { &point_to_plane, &symmetric };
+  for (const auto estimator : estimators)
+  {
+    Eigen::Matrix4f estimated_transform = Eigen::Matrix4f::Identity ();
+    pcl::PointCloud<pcl::PointNormal> aligned (*src);
+    for (int iter = 0; iter < 10; ++iter)
+    {
+      Eigen::Matrix4f delta;
+      estimator->estimateRigidTransformation (aligned, *tgt, delta);
+      estimated_transform = delta * estimated_transform;
+      pcl::transformPointCloudWithNormals (*src, aligned, estimated_transform);
+    }
+
+    for (int i = 0; i < 4; ++i)
+      for (int j = 0; j < 4; ++j)
+        EXPECT_NEAR (estimated_transform (i, j), ground_truth_tform (i, j), 1e-2);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -235,6 +235,76 @@ TEST (PCL, SampleConsensusPrerejective)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, SampleConsensusPrerejectiveMultiThreaded)
+{
+  // Transform the source cloud by a large amount
+  Eigen::Vector3f initial_offset (100, 0, 0);
+  float angle = static_cast<float> (M_PI) / 2.0f;
+  Eigen::Quaternionf initial_rotation (std::cos (angle / 2), 0, 0, sin (angle / 2));
+  PointCloud<PointXYZ> cloud_source_transformed;
+  transformPointCloud (cloud_source, cloud_source_transformed, initial_offset, initial_rotation);
+
+  PointCloud<PointXYZ>::Ptr cloud_source_ptr = cloud_source_transformed.makeShared ();
+  PointCloud<PointXYZ>::Ptr cloud_target_ptr = cloud_target.makeShared ();
+
+  // Estimate the normals and the FPFH features for both clouds
+  search::KdTree<PointXYZ>::Ptr tree (new search::KdTree<PointXYZ>);
+  NormalEstimation<PointXYZ, Normal> norm_est;
+  norm_est.setSearchMethod (tree);
+  norm_est.setRadiusSearch (0.005);
+  PointCloud<Normal> normals;
+
+  FPFHEstimation<PointXYZ, Normal, FPFHSignature33> fpfh_est;
+  fpfh_est.setSearchMethod (tree);
+  fpfh_est.setRadiusSearch (0.05);
+  PointCloud<FPFHSignature33> features_source, features_target;
+
+  norm_est.setInputCloud (cloud_source_ptr);
+  norm_est.compute (normals);
+  fpfh_est.setInputCloud (cloud_source_ptr);
+  fpfh_est.setInputNormals (normals.makeShared ());
+  fpfh_est.compute (features_source);
+
+  norm_est.setInputCloud (cloud_target_ptr);
+  norm_est.compute (normals);
+  fpfh_est.setInputCloud (cloud_target_ptr);
+  fpfh_est.setInputNormals (normals.makeShared ());
+  fpfh_est.compute (features_target);
+
+  SampleConsensusPrerejective<PointXYZ, PointXYZ, FPFHSignature33> reg;
+  reg.setMaxCorrespondenceDistance (0.1);
+  reg.setMaximumIterations (5000);
+  reg.setSimilarityThreshold (0.6f);
+  reg.setCorrespondenceRandomness (2);
+  reg.setInlierFraction (0.5f);
+  reg.setNumberOfThreads (4);
+  reg.setRandomSeed (42);
+  EXPECT_EQ (reg.getNumberOfThreads (), 4u);
+  EXPECT_EQ (reg.getRandomSeed (), 42u);
+
+  reg.setInputSource (cloud_source_ptr);
+  reg.setInputTarget (cloud_target_ptr);
+  reg.setSourceFeatures (features_source.makeShared ());
+  reg.setTargetFeatures (features_target.makeShared ());
+
+  // Register
+  reg.align (cloud_reg);
+  EXPECT_TRUE (reg.hasConverged ());
+  EXPECT_EQ (static_cast<int> (cloud_reg.points.size ()), static_cast<int> (cloud_source.points.size ()));
+  float inlier_fraction = static_cast<float> (reg.getInliers ().size ()) / static_cast<float> (cloud_source.points.size ());
+  EXPECT_GT (inlier_fraction, 0.95f);
+
+  // Same seed and thread count must give the same result
+  const Eigen::Matrix4f transformation = reg.getFinalTransformation ();
+  const std::vector<int> inliers = reg.getInliers ();
+  reg.align (cloud_reg);
+  EXPECT_EQ (inliers, reg.getInliers ());
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 4; ++j)
+      EXPECT_EQ (transformation (i, j), reg.getFinalTransformation () (i, j));
+}
+
 int
 main (int argc, char** argv)
 {
@@ -223,6 +223,165 @@ TEST (SampleConsensusModelPlane, RMSAC)
   verifyPlaneSac (model, sac, 600, 1.0f, 1.0f, 0.01f);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, RANSACPreemptive)
+{
+  for (const SacPreemptiveTest test : {SAC_PREEMPTIVE_TDD, SAC_PREEMPTIVE_SPRT})
+  {
+    srand (0);
+
+    // Create a shared plane model pointer directly
+    SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud_));
+
+    // Create the RANSAC object
+    RandomSampleConsensus<PointXYZ> sac (model, 0.03);
+    sac.setPreemptiveTest (test);
+    ASSERT_EQ (test, sac.getPreemptiveTest ());
+
+    verifyPlaneSac (model, sac);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, MSACPreemptive)
+{
+  for (const SacPreemptiveTest test : {SAC_PREEMPTIVE_TDD, SAC_PREEMPTIVE_SPRT})
+  {
+    srand (0);
+
+    // Create a shared plane model pointer directly
+    SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud_));
+
+    // Create the MSAC object
+    MEstimatorSampleConsensus<PointXYZ> sac (model, 0.03);
+    sac.setPreemptiveTest (test);
+    sac.setPreemptiveTestSize (2);
+    ASSERT_EQ (2u, sac.getPreemptiveTestSize ());
+
+    verifyPlaneSac (model, sac);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, PointVerifyModel)
+{
+  SampleConsensusModelPlane<PointXYZ> model (cloud_);
+
+  Eigen::VectorXf coeff (4);
+  coeff << plane_coeffs_[0], plane_coeffs_[1], plane_coeffs_[2], 1.0f;
+  coeff /= coeff.head<3> ().norm ();
+
+  // The single point check used by the pre-verification tests agrees with the set based one
+  for (const double threshold : {0.001, 0.03})
+    for (const int index : indices_)
+    {
+      const std::set<int> subset = {index};
+      EXPECT_EQ (model.doSamplesVerifyModel (subset, coeff, threshold), model.doPointVerifyModel (index, coeff, threshold));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, SinglePrecisionThreshold)
+{
+  SampleConsensusModelPlane<PointXYZ> model (cloud_);
+
+  Eigen::VectorXf coeff (4);
+  coeff << plane_coeffs_[0], plane_coeffs_[1], plane_coeffs_[2], 1.0f;
+  coeff /= coeff.head<3> ().norm ();
+
+  std::vector<double> distances;
+  model.getDistancesToModel (coeff, distances);
+  ASSERT_EQ (indices_.size (), distances.size ());
+
+  // Thresholds just above the distance of a point round down to it in single precision: every method must
+  // then classify that point the same way
+  for (std::size_t i = 0; i < distances.size (); i += distances.size () / 7)
+  {
+    const double threshold = distances[i] * (1.0 + 1e-12);
+
+    std::vector<int> inliers;
+    model.selectWithinDistance (coeff, threshold, inliers);
+    const int nr_inliers = static_cast<int> (inliers.size ());
+    EXPECT_EQ (model.countWithinDistance (coeff, threshold), nr_inliers);
+    EXPECT_EQ (model.countWithinDistanceStandard (coeff, threshold), nr_inliers);
+    EXPECT_EQ (nr_inliers, std::count_if (distances.begin (), distances.end (),
+                                          [threshold] (double d) { return (static_cast<float> (d) < static_cast<float> (threshold)); }));
+    EXPECT_FALSE (model.doPointVerifyModel (indices_[i], coeff, threshold));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, SIMD_countWithinDistance)
+{
+  SampleConsensusModelPlane<PointXYZ> model (cloud_);
+  SampleConsensusModelNormalPlane<PointXYZ, Normal> normal_model (cloud_);
+  normal_model.setInputNormals (normals_);
+  normal_model.setNormalDistanceWeight (0.1);
+
+  Eigen::VectorXf coeff (4);
+  coeff << plane_coeffs_[0], plane_coeffs_[1], plane_coeffs_[2], 1.0f;
+  coeff /= coeff.head<3> ().norm ();
+
+  for (const double threshold : {0.001, 0.01, 0.03, 0.1})
+  {
+    const int expected = model.countWithinDistanceStandard (coeff, threshold);
+    const int expected_normal = normal_model.countWithinDistanceStandard (coeff, threshold);
+    EXPECT_LT (0, expected);
+#if defined (__SSE2__)
+    EXPECT_EQ (expected, model.countWithinDistanceSSE (coeff, threshold));
+    EXPECT_EQ (expected_normal, normal_model.countWithinDistanceSSE (coeff, threshold));
+#endif
+#if defined (__AVX__)
+    EXPECT_EQ (expected, model.countWithinDistanceAVX (coeff, threshold));
+    EXPECT_EQ (expected_normal, normal_model.countWithinDistanceAVX (coeff, threshold));
+#endif
+    EXPECT_EQ (expected, model.countWithinDistance (coeff, threshold));
+    EXPECT_EQ (expected_normal, normal_model.countWithinDistance (coeff, threshold));
+  }
+
+  // Thresholds just above the single precision distance of a point must be rounded the same way by all paths
+  for (std::size_t i = 0; i < cloud_->points.size (); i += cloud_->points.size () / 7)
+  {
+    const PointXYZ &pt = cloud_->points[i];
+    const float dist = std::abs ((coeff[0] * pt.x + coeff[1] * pt.y) + (coeff[2] * pt.z + coeff[3]));
+    const double threshold = static_cast<double> (dist) * (1.0 + 1e-12);
+    const int expected = model.countWithinDistanceStandard (coeff, threshold);
+#if defined (__SSE2__)
+    EXPECT_EQ (expected, model.countWithinDistanceSSE (coeff, threshold));
+#endif
+#if defined (__AVX__)
+    EXPECT_EQ (expected, model.countWithinDistanceAVX (coeff, threshold));
+#endif
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, RANSACMultiThreaded)
+{
+  // The same hypotheses are drawn regardless of the number of threads, so the
+  // selected model must not depend on it
+  std::vector<int> inliers_single, inliers_multi;
+  Eigen::VectorXf coeff_single, coeff_multi;
+  for (const unsigned int threads : {1u, 4u})
+  {
+    srand (0);
+    SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud_));
+    RandomSampleConsensus<PointXYZ> sac (model, 0.03);
+    sac.setNumberOfThreads (threads);
+    ASSERT_TRUE (sac.computeModel ());
+    sac.getInliers (threads == 1 ? inliers_single : inliers_multi);
+    sac.getModelCoefficients (threads == 1 ? coeff_single : coeff_multi);
+  }
+  EXPECT_EQ (inliers_single, inliers_multi);
+  EXPECT_EQ (coeff_single, coeff_multi);
+
+  srand (0);
+  SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud_));
+  MEstimatorSampleConsensus<PointXYZ> sac (model, 0.03);
+  sac.setNumberOfThreads (4);
+  verifyPlaneSac (model, sac);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SampleConsensusModelNormalPlane, RANSAC)
 {
@@ -239,6 +398,86 @@ TEST (SampleConsensusModelNormalPlane, RANSAC)
   verifyPlaneSac (model, sac);
 }
 
+// Exposes the pre-verification of hypotheses
+class PreemptiveRandomSampleConsensus : public RandomSampleConsensus<PointXYZ>
+{
+  public:
+    using RandomSampleConsensus<PointXYZ>::RandomSampleConsensus;
+    using SampleConsensus<PointXYZ>::initPreemptiveTest;
+    using SampleConsensus<PointXYZ>::preemptiveTestPasses;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelNormalPlane, PointVerifyModel)
+{
+  SampleConsensusModelNormalPlane<PointXYZ, Normal> model (cloud_);
+  model.setInputNormals (normals_);
+  model.setNormalDistanceWeight (0.1);
+
+  Eigen::VectorXf coeff (4);
+  coeff << plane_coeffs_[0], plane_coeffs_[1], plane_coeffs_[2], 1.0f;
+  coeff /= coeff.head<3> ().norm ();
+
+  // The pre-verification tests use the same normal-weighted distance as the scoring
+  for (const double threshold : {0.01, 0.03, 0.1})
+  {
+    std::vector<int> inliers;
+    model.selectWithinDistance (coeff, threshold, inliers);
+    const std::set<int> inlier_set (inliers.begin (), inliers.end ());
+
+    int nr_verified = 0;
+    for (const int index : indices_)
+    {
+      const bool verified = model.doPointVerifyModel (index, coeff, threshold);
+      EXPECT_EQ (inlier_set.count (index) == 1, verified);
+      EXPECT_EQ (verified, model.doSamplesVerifyModel (std::set<int> {index}, coeff, threshold));
+      nr_verified += verified;
+    }
+    EXPECT_EQ (model.countWithinDistance (coeff, threshold), nr_verified);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelNormalPlane, PreemptiveTest)
+{
+  // Points on the plane z = 0 whose normals lie in the plane: the plane fits them, its normals do not
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal>);
+  for (int i = 0; i < 20; ++i)
+    for (int j = 0; j < 20; ++j)
+    {
+      cloud->push_back (PointXYZ (0.1f * static_cast<float> (i), 0.1f * static_cast<float> (j), 0.0f));
+      normals->push_back (Normal (1.0f, 0.0f, 0.0f));
+    }
+
+  SampleConsensusModelNormalPlanePtr model (new SampleConsensusModelNormalPlane<PointXYZ, Normal> (cloud));
+  model->setInputNormals (normals);
+  model->setNormalDistanceWeight (0.5);
+
+  Eigen::VectorXf plane (4), normal_plane (4);
+  plane << 0.0f, 0.0f, 1.0f, 0.0f;
+  normal_plane << 1.0f, 0.0f, 0.0f, -1.0f;
+  ASSERT_EQ (0, model->countWithinDistance (plane, 0.03));
+
+  for (const SacPreemptiveTest test : {SAC_PREEMPTIVE_TDD, SAC_PREEMPTIVE_SPRT})
+  {
+    PreemptiveRandomSampleConsensus sac (model, 0.03);
+    sac.setPreemptiveTest (test);
+    sac.setPreemptiveTestSize (5);
+    sac.initPreemptiveTest ();
+
+    // The Euclidean fit alone would pass the plane, the normal-weighted distance rejects it
+    std::size_t nr_tested, nr_consistent;
+    EXPECT_FALSE (sac.preemptiveTestPasses (plane, 0, nr_tested, nr_consistent));
+    EXPECT_EQ (0u, nr_consistent);
+
+    // The plane x = 1 through a column of the points, along their normals, is pre-verified for these points
+    const int index = 10 * 20 + 3;
+    EXPECT_TRUE (model->doPointVerifyModel (index, normal_plane, 0.03));
+    EXPECT_FALSE (model->doPointVerifyModel (index, plane, 0.03));
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SampleConsensusModelNormalParallelPlane, RANSAC)
 {
@@ -42,6 +42,7 @@
 #include <pcl/point_cloud.h>
 #include <pcl/io/pcd_io.h>
 #include <pcl/search/search.h>
+#include <pcl/search/octree.h>
 #include <pcl/features/normal_3d.h>
 
 #include <pcl/segmentation/extract_polygonal_prism_data.h>
@@ -49,6 +50,8 @@
 #include <pcl/segmentation/region_growing.h>
 #include <pcl/segmentation/region_growing_rgb.h>
 #include <pcl/segmentation/min_cut_segmentation.h>
+#include <pcl/segmentation/sac_multi_model_segmentation.h>
+#include <pcl/sample_consensus/sac_model_plane.h>
 
 using namespace pcl;
 using namespace pcl::io;
@@ -385,6 +388,135 @@ TEST (ExtractPolygonalPrism, Segmentation)
   EXPECT_EQ (static_cast<int> (output.indices.size ()), 0);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+// Three orthogonal planes of 3600, 2500 and 1600 points, followed by 100 scattered points
+PointCloud<PointXYZ>::Ptr
+createPlanesCloud ()
+{
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+  const int plane_sizes[] = {60, 50, 40};
+  for (int p = 0; p < 3; ++p)
+    for (int i = 0; i < plane_sizes[p]; ++i)
+      for (int j = 0; j < plane_sizes[p]; ++j)
+      {
+        const float u = 0.02f * static_cast<float> (i), v = 0.02f * static_cast<float> (j);
+        if (p == 0)
+          cloud->push_back (PointXYZ (u, v, 0.0f));
+        else if (p == 1)
+          cloud->push_back (PointXYZ (u, 2.0f, v + 0.1f));
+        else
+          cloud->push_back (PointXYZ (-1.0f, u + 0.1f, v + 0.1f));
+      }
+  for (int i = 0; i < 100; ++i)
+    cloud->push_back (PointXYZ (0.5f + 0.001f * static_cast<float> (i), 1.0f, 0.5f + 0.003f * static_cast<float> (i % 7)));
+  return (cloud);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SACMultiModelSegmentation, Planes)
+{
+  PointCloud<PointXYZ>::Ptr cloud = createPlanesCloud ();
+
+  for (const unsigned int threads : {1u, 4u})
+  {
+    SACMultiModelSegmentation<PointXYZ> seg;
+    seg.setInputCloud (cloud);
+    seg.setModelType (SACMODEL_PLANE);
+    seg.setMethodType (SAC_RANSAC);
+    seg.setDistanceThreshold (0.01);
+    seg.setMaxIterations (1000);
+    seg.setMinInliers (200);
+    seg.setNumberOfThreads (threads);
+
+    std::vector<PointIndices> inliers;
+    std::vector<ModelCoefficients> coefficients;
+    seg.segment (inliers, coefficients);
+
+    ASSERT_EQ (3u, inliers.size ());
+    ASSERT_EQ (3u, coefficients.size ());
+    std::vector<size_t> sizes;
+    for (size_t m = 0; m < inliers.size (); ++m)
+    {
+      EXPECT_EQ (4u, coefficients[m].values.size ());
+      sizes.push_back (inliers[m].indices.size ());
+    }
+    std::sort (sizes.rbegin (), sizes.rend ());
+    EXPECT_EQ (3600u, sizes[0]);
+    EXPECT_EQ (2500u, sizes[1]);
+    EXPECT_EQ (1600u, sizes[2]);
+    EXPECT_EQ (100u, seg.getRemainingIndices ().size ());
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SACMultiModelSegmentation, PlanesLocalSamples)
+{
+  PointCloud<PointXYZ>::Ptr cloud = createPlanesCloud ();
+
+  // leave out the third plane
+  std::vector<int> indices;
+  for (int i = 0; i < static_cast<int> (cloud->size ()); ++i)
+    if (i < 3600 + 2500 || i >= 3600 + 2500 + 1600)
+      indices.push_back (i);
+  std::vector<char> in_indices (cloud->size (), 0);
+  for (const int &index : indices)
+    in_indices[index] = 1;
+
+  for (const unsigned int threads : {1u, 4u})
+  {
+    SACMultiModelSegmentation<PointXYZ> seg;
+    seg.setInputCloud (cloud);
+    seg.setIndices (boost::shared_ptr<std::vector<int> > (new std::vector<int> (indices)));
+    seg.setModelType (SACMODEL_PLANE);
+    seg.setMethodType (SAC_RANSAC);
+    seg.setDistanceThreshold (0.01);
+    seg.setMaxIterations (1000);
+    seg.setMinInliers (200);
+    seg.setSamplesMaxDist (0.1, SACMultiModelSegmentation<PointXYZ>::SearchPtr ());
+    seg.setNumberOfThreads (threads);
+
+    std::vector<PointIndices> inliers;
+    std::vector<ModelCoefficients> coefficients;
+    seg.segment (inliers, coefficients);
+
+    ASSERT_EQ (2u, inliers.size ());
+    std::vector<char> claimed (cloud->size (), 0);
+    std::vector<size_t> sizes;
+    for (const PointIndices &model_inliers : inliers)
+    {
+      for (const int &index : model_inliers.indices)
+      {
+        EXPECT_TRUE (in_indices[index]) << "index " << index;
+        EXPECT_FALSE (claimed[index]) << "index " << index;
+        claimed[index] = 1;
+      }
+      sizes.push_back (model_inliers.indices.size ());
+    }
+    std::sort (sizes.rbegin (), sizes.rend ());
+    EXPECT_EQ (3600u, sizes[0]);
+    EXPECT_EQ (2500u, sizes[1]);
+    EXPECT_EQ (100u, seg.getRemainingIndices ().size ());
+  }
+
+  // localized samples are drawn among the indices only, even if the search spans the whole cloud
+  std::vector<int> even_indices;
+  for (int i = 0; i < 3600; i += 2)
+    even_indices.push_back (i);
+  SampleConsensusModelPlane<PointXYZ> model (cloud, even_indices);
+  SampleConsensusModelPlane<PointXYZ>::SearchPtr search (new search::Octree<PointXYZ> (0.1));
+  search->setInputCloud (cloud);
+  model.setSamplesMaxDist (0.1, search);
+  int iterations = 0;
+  std::vector<int> samples;
+  for (int i = 0; i < 1000; ++i)
+  {
+    model.getSamples (iterations, samples);
+    ASSERT_EQ (3u, samples.size ());
+    for (const int &sample : samples)
+      ASSERT_EQ (0, sample % 2) << "sample " << sample;
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -0,0 +1,253 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/point_types.h>
+#include <pcl/io/pcd_io.h>
+#include <pcl/octree/octree_pointcloud.h>
+#include <pcl/compression/entropy_range_coder.h>
+#include <pcl/compression/octree_pointcloud_compression.h>
+#include <pcl/console/print.h>
+#include <pcl/console/parse.h>
+#include <pcl/console/time.h>
+
+#include <algorithm>
+#include <sstream>
+
+using namespace pcl;
+using namespace pcl::io;
+using namespace pcl::console;
+
+double default_resolution = 0.01;
+int    default_repetitions = 10;
+int    default_frames = 10;
+
+using PointT = PointXYZRGBA;
+
+void
+printHelp (int, char **argv)
+{
+  print_error ("Syntax is: %s input.pcd <options>\n", argv[0]);
+  print_info ("  Compares the compression ratio and throughput of the entropy coders of pcl::io::OctreePointCloudCompression.\n");
+  print_info ("  where options are:\n");
+  print_info ("                     -res X    = octree resolution of the occupancy stream the entropy coders are compared on (default: ");
+  print_value ("%g", default_resolution); print_info (")\n");
+  print_info ("                     -reps X   = number of times every entropy coder codes the occupancy stream (default: ");
+  print_value ("%d", default_repetitions); print_info (")\n");
+  print_info ("                     -frames X = number of frames every compression profile encodes and decodes (default: ");
+  print_value ("%d", default_frames); print_info (")\n");
+}
+
+bool
+loadCloud (const std::string &filename, PointCloud<PointT> &cloud)
+{
+  TicToc tt;
+  print_highlight ("Loading "); print_value ("%s ", filename.c_str ());
+
+  tt.tic ();
+  if (loadPCDFile (filename, cloud) < 0)
+    return (false);
+  print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", cloud.width * cloud.height); print_info (" points]\n");
+
+  return (true);
+}
+
+void
+printResult (const char *name, size_t raw_bytes, size_t compressed_bytes, double encode_ms, double decode_ms, bool lossless)
+{
+  const double raw_mb = static_cast<double> (raw_bytes) / (1024.0 * 1024.0);
+  print_info ("  %-24s", name);
+  print_value ("%10lu", compressed_bytes); print_info (" bytes, ratio ");
+  print_value ("%6.3f", static_cast<double> (raw_bytes) / static_cast<double> (std::max<size_t> (compressed_bytes, 1)));
+  print_info (", encode "); print_value ("%8.2f", raw_mb / (encode_ms / 1000.0)); print_info (" MB/s");
+  print_info (", decode "); print_value ("%8.2f", raw_mb / (decode_ms / 1000.0)); print_info (" MB/s");
+  if (!lossless)
+    print_error (" (decoded data differs)");
+  print_info ("\n");
+}
+
+template<typename EncodeFunctor, typename DecodeFunctor> void
+benchmarkCoder (const char *name, const std::vector<char> &occupancy, int repetitions,
+                EncodeFunctor encode, DecodeFunctor decode)
+{
+  size_t compressed_bytes = 0;
+  double encode_ms = 0, decode_ms = 0;
+  bool lossless = true;
+
+  std::vector<char> decoded (occupancy.size ());
+  for (int i = 0; i < repetitions; i++)
+  {
+    std::stringstream stream;
+    TicToc tt;
+
+    tt.tic ();
+    compressed_bytes = encode (occupancy, stream);
+    encode_ms += tt.toc ();
+
+    tt.tic ();
+    decode (stream, decoded);
+    decode_ms += tt.toc ();
+
+    lossless &= (decoded == occupancy);
+  }
+
+  printResult (name, occupancy.size () * repetitions, compressed_bytes * repetitions, encode_ms, decode_ms, lossless);
+}
+
+void
+compareEntropyCoders (const PointCloud<PointT>::ConstPtr &cloud, double resolution, int repetitions)
+{
+  octree::OctreePointCloud<PointT> tree (resolution);
+  tree.setInputCloud (cloud);
+  tree.addPointsFromInputCloud ();
+
+  std::vector<char> occupancy;
+  tree.serializeTree (occupancy);
+  const unsigned int depth = tree.getTreeDepth ();
+
+  print_highlight ("Entropy coding the octree occupancy stream: ");
+  print_value ("%lu", occupancy.size ()); print_info (" bytes, depth "); print_value ("%u\n", depth);
+
+  AdaptiveRangeCoder adaptive_coder;
+  benchmarkCoder ("AdaptiveRangeCoder", occupancy, repetitions,
+                  [&] (const std::vector<char> &in, std::ostream &out) { return (adaptive_coder.encodeCharVectorToStream (in, out)); },
+                  [&] (std::istream &in, std::vector<char> &out) { adaptive_coder.decodeStreamToCharVector (in, out); });
+
+  StaticRangeCoder static_coder;
+  benchmarkCoder ("StaticRangeCoder", occupancy, repetitions,
+                  [&] (const std::vector<char> &in, std::ostream &out) { return (static_coder.encodeCharVectorToStream (in, out)); },
+                  [&] (std::istream &in, std::vector<char> &out) { static_coder.decodeStreamToCharVector (in, out); });
+
+  InterleavedRANSCoder rans_coder;
+  benchmarkCoder ("InterleavedRANSCoder", occupancy, repetitions,
+                  [&] (const std::vector<char> &in, std::ostream &out) { return (rans_coder.encodeCharVectorToStream (in, out)); },
+                  [&] (std::istream &in, std::vector<char> &out) { rans_coder.decodeStreamToCharVector (in, out); });
+  benchmarkCoder ("InterleavedRANSCoder ctx", occupancy, repetitions,
+                  [&] (const std::vector<char> &in, std::ostream &out) { return (rans_coder.encodeOccupancyVectorToStream (in, depth, out)); },
+                  [&] (std::istream &in, std::vector<char> &out) { rans_coder.decodeStreamToOccupancyVector (in, depth, out); });
+}
+
+void
+compareProfile (const PointCloud<PointT>::ConstPtr &cloud, const char *name, compression_Profiles_e profile,
+                entropy_Coders_e coder, int frames)
+{
+  OctreePointCloudCompression<PointT> encoder (profile, false);
+  OctreePointCloudCompression<PointT> decoder;
+  encoder.setEntropyCoder (coder);
+
+  size_t compressed_bytes = 0;
+  double encode_ms = 0, decode_ms = 0;
+  bool complete = true;
+
+  for (int frame = 0; frame < frames; frame++)
+  {
+    std::stringstream stream;
+    PointCloud<PointT>::Ptr cloud_out (new PointCloud<PointT>);
+    TicToc tt;
+
+    tt.tic ();
+    encoder.encodePointCloud (cloud, stream);
+    encode_ms += tt.toc ();
+    compressed_bytes += stream.str ().size ();
+
+    tt.tic ();
+    decoder.decodePointCloud (stream, cloud_out);
+    decode_ms += tt.toc ();
+
+    complete &= (cloud_out->size () > 0);
+  }
+
+  // raw size as reported by the compression statistics, xyz and color of every point
+  const size_t raw_bytes = cloud->size () * frames * (3 * sizeof (float) + sizeof (int));
+  printResult (name, raw_bytes, compressed_bytes, encode_ms, decode_ms, complete);
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  print_info ("Benchmark the entropy coders of the octree point cloud compression. For more information, use: %s -h\n", argv[0]);
+
+  if (argc < 2)
+  {
+    printHelp (argc, argv);
+    return (-1);
+  }
+
+  // Parse the command line arguments for .pcd files
+  std::vector<int> p_file_indices;
+  p_file_indices = parse_file_extension_argument (argc, argv, ".pcd");
+  if (p_file_indices.size () != 1)
+  {
+    print_error ("Need one input PCD file to continue.\n");
+    return (-1);
+  }
+
+  // Command line parsing
+  double resolution = default_resolution;
+  int repetitions = default_repetitions;
+  int frames = default_frames;
+  parse_argument (argc, argv, "-res", resolution);
+  parse_argument (argc, argv, "-reps", repetitions);
+  parse_argument (argc, argv, "-frames", frames);
+  repetitions = std::max (repetitions, 1);
+  frames = std::max (frames, 1);
+
+  PointCloud<PointT>::Ptr cloud (new PointCloud<PointT>);
+  if (!loadCloud (argv[p_file_indices[0]], *cloud))
+    return (-1);
+
+  // Compare the entropy coders on the octree structure
+  compareEntropyCoders (cloud, resolution, repetitions);
+
+  // Compare complete point cloud compression with either entropy coder
+  struct
+  {
+    const char *name;
+    compression_Profiles_e profile;
+  } profiles[] = {
+    {"low resolution", LOW_RES_ONLINE_COMPRESSION_WITH_COLOR},
+    {"medium resolution", MED_RES_ONLINE_COMPRESSION_WITH_COLOR},
+    {"high resolution", HIGH_RES_ONLINE_COMPRESSION_WITH_COLOR}};
+
+  for (const auto &profile : profiles)
+  {
+    print_highlight ("Compressing "); print_value ("%d", frames); print_info (" frames, %s profile:\n", profile.name);
+    compareProfile (cloud, "StaticRangeCoder", profile.profile, RANGE_CODER, frames);
+    compareProfile (cloud, "InterleavedRANSCoder", profile.profile, RANS_CODER, frames);
+  }
+
+  return (0);
+}
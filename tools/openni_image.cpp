@@ -63,6 +63,8 @@ using namespace pcl::console;
 bool global_visualize = true, is_done = false, save_data = false, toggle_one_frame_capture = false, visualize = true;
 std::mutex io_mutex;
 int nr_frames_total = 0;
+// maximum error of predictively coded depth images, -1 for LZF compression
+int depth_max_error = -1;
 
 #if defined(__linux__) 
 #include <unistd.h>
@@ -300,6 +302,11 @@ class Writer
       ss2 << "frame_" + time_string + "_depth.pclzf";
       io::LZFDepth16ImageWriter ld;
       //io::LZFShift11ImageWriter ld;
+      if (depth_max_error >= 0)
+      {
+        ld.setPredictiveCoding (true);
+        ld.getDepthImageCoder ().setMaxError (depth_max_error);
+      }
       ld.write (reinterpret_cast<const char*> (&frame->depth_image->getDepthMetaData ().Data ()[0]), frame->depth_image->getWidth (), frame->depth_image->getHeight (), ss2.str ());
       
       // Save depth data
@@ -632,6 +639,7 @@ usage (char ** argv)
   std::cout << argv[0] << " -l : list all available devices\n";
   std::cout << argv[0] << " -buf X         : use a buffer size of X frames (default: " << buff_size << ")\n";
   std::cout << argv[0] << " -visualize 0/1 : turn the visualization off/on (WARNING: when visualization is disabled, data writing is enabled by default!)\n";
+  std::cout << argv[0] << " -depthcoding X : code depth images predictively with a maximum error of X (0: lossless) instead of LZF\n";
   std::cout << argv[0] << " -l <device-id> : list all available modes for specified device\n";
 
   std::cout << "                 device_id may be #1, #2, ... for the first, second etc device in the list"
@@ -756,6 +764,7 @@ main (int argc, char ** argv)
   int depthformat = openni_wrapper::OpenNIDevice::OpenNI_12_bit_depth;
   console::parse_argument (argc, argv, "-depthformat", depthformat);
   console::parse_argument (argc, argv, "-visualize", global_visualize);
+  console::parse_argument (argc, argv, "-depthcoding", depth_max_error);
 
   OpenNIGrabber ni_grabber (device_id, depth_mode, image_mode);
   // Set the depth output format